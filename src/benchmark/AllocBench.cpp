@@ -5,6 +5,10 @@
 
 #define BENCH_ALLOCS_SINGLE 0
 #define BENCH_ALLOCS_MULTI 1
+#define BENCH_ALLOCS_THREADED 1
+#define BENCH_ALLOCS_FRAGMENTED 1
+#define BENCH_ALLOCS_SIZECLASS 1
+#define BENCH_ALLOCS_TRACKING 1
 
 #if BENCH_ALLOCS_SINGLE
 
@@ -353,4 +357,273 @@ BENCHMARK(FreeListAllocatorBenchMulti)
 
 #endif
 
+#if BENCH_ALLOCS_THREADED
+
+// Every thread allocates and frees batches of blocks from the same pool, thread caching keeps most operations off the shared free list
+template<u32 ThreadCacheSize>
+auto PoolAllocatorBenchThreaded(benchmark::State& state) -> void
+{
+	constexpr usize BatchSize = 64;
+	static Onca::Alloc::Mallocator mallocator;
+	static Onca::Alloc::PoolAllocator<32, 4096> alloc{ &mallocator, ThreadCacheSize };
+
+	Onca::MemRef<u8> refs[BatchSize];
+	for (auto _ : state)
+	{
+		for (usize i = 0; i < BatchSize; ++i)
+		{
+			refs[i] = alloc.Allocate<u8>(32);
+		}
+		for (usize i = 0; i < BatchSize; ++i)
+		{
+			alloc.Deallocate(Move(refs[i]));
+		}
+	}
+	alloc.FlushThreadCache();
+	state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+BENCHMARK_TEMPLATE(PoolAllocatorBenchThreaded, 0)
+	->ThreadRange(1, 16)
+	->UseRealTime();
+BENCHMARK_TEMPLATE(PoolAllocatorBenchThreaded, 64)
+	->ThreadRange(1, 16)
+	->UseRealTime();
+
+auto MallocBenchThreaded(benchmark::State& state) -> void
+{
+	constexpr usize BatchSize = 64;
+	void* ptrs[BatchSize];
+	for (auto _ : state)
+	{
+		for (usize i = 0; i < BatchSize; ++i)
+		{
+			ptrs[i] = malloc(32);
+		}
+		for (usize i = 0; i < BatchSize; ++i)
+		{
+			free(ptrs[i]);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * BatchSize);
+}
+BENCHMARK(MallocBenchThreaded)
+	->ThreadRange(1, 16)
+	->UseRealTime();
+
+#endif
+
+#if BENCH_ALLOCS_FRAGMENTED
+
+// Fills the allocator with single blocks, frees a random half of them and then keeps allocating and freeing runs of up to 'range(0)' blocks.
+// This leaves the bitmap heavily fragmented, so most of the time goes into searching for a free run.
+auto BitmapAllocatorBenchFragmented(benchmark::State& state) -> void
+{
+	constexpr usize NumBlocks = 16 * 1024;
+	constexpr usize NumLive = 1024;
+
+	Onca::Alloc::Mallocator mallocator;
+	Onca::Alloc::BitmapAllocator<32, NumBlocks> alloc{ &mallocator };
+
+	Onca::DynArray<Onca::MemRef<u8>> fill;
+	fill.Reserve(NumBlocks);
+	for (usize i = 0; i < NumBlocks; ++i)
+		fill.Add(alloc.Allocate<u8>(32));
+
+	u64 rng = 0x9E3779B97F4A7C15;
+	auto next = [&rng]() -> u64
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 7;
+		rng ^= rng << 17;
+		return rng;
+	};
+
+	for (Onca::MemRef<u8>& mem : fill)
+	{
+		if (next() & 1)
+			alloc.Deallocate(Move(mem));
+	}
+
+	const usize maxRun = usize(state.range(0));
+	Onca::MemRef<u8> live[NumLive];
+	usize liveIdx = 0;
+	for (auto _ : state)
+	{
+		Onca::MemRef<u8>& slot = live[liveIdx];
+		if (slot.IsValid())
+			alloc.Deallocate(Move(slot));
+		slot = alloc.Allocate<u8>(32 * (1 + next() % maxRun));
+		liveIdx = (liveIdx + 1) % NumLive;
+	}
+
+	for (Onca::MemRef<u8>& mem : live)
+	{
+		if (mem.IsValid())
+			alloc.Deallocate(Move(mem));
+	}
+	for (Onca::MemRef<u8>& mem : fill)
+	{
+		if (mem.IsValid())
+			alloc.Deallocate(Move(mem));
+	}
+}
+BENCHMARK(BitmapAllocatorBenchFragmented)
+	->RangeMultiplier(4)
+	->Range(1, 256);
+
+#endif
+
+#if BENCH_ALLOCS_SIZECLASS
+
+// Size distribution skewed towards small objects, as seen in typical container and string workloads:
+// 50% 8-64 bytes, 30% 64-256 bytes, 15% 256 bytes-2 KiB, 4% 2-16 KiB and 1% 16-64 KiB
+auto NextMixedSize(u64& rng) -> usize
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 7;
+	rng ^= rng << 17;
+
+	const u64 bucket = rng % 100;
+	const u64 val = rng >> 8;
+	if (bucket < 50)
+		return 8 + val % 56;
+	if (bucket < 80)
+		return 64 + val % 192;
+	if (bucket < 95)
+		return 256 + val % (2048 - 256);
+	if (bucket < 99)
+		return 2048 + val % (16384 - 2048);
+	return 16384 + val % (65536 - 16384);
+}
+
+// Keeps a set of 'range(0)' live allocations, replacing a random one every iteration
+template<typename Alloc>
+auto MixedSizeBench(benchmark::State& state, Alloc& alloc) -> void
+{
+	Onca::Alloc::Mallocator mallocator;
+	Onca::DynArray<Onca::MemRef<u8>> live{ usize(state.range(0)), mallocator };
+	live.Resize(usize(state.range(0)));
+
+	u64 rng = 0x9E3779B97F4A7C15 + u64(state.thread_index());
+	for (Onca::MemRef<u8>& mem : live)
+		mem = alloc.template Allocate<u8>(NextMixedSize(rng));
+
+	for (auto _ : state)
+	{
+		Onca::MemRef<u8>& slot = live[usize(rng % live.Size())];
+		alloc.Deallocate(Move(slot));
+		slot = alloc.template Allocate<u8>(NextMixedSize(rng));
+		benchmark::DoNotOptimize(slot.Ptr());
+	}
+
+	for (Onca::MemRef<u8>& mem : live)
+		alloc.Deallocate(Move(mem));
+	state.SetItemsProcessed(state.iterations());
+}
+
+auto GetSlabBenchAlloc() -> Onca::Alloc::SlabAllocator&
+{
+	static Onca::Alloc::Mallocator mallocator;
+	static Onca::Alloc::SlabAllocator alloc{ &mallocator };
+	return alloc;
+}
+
+auto SlabAllocatorBenchMixed(benchmark::State& state) -> void
+{
+	MixedSizeBench(state, GetSlabBenchAlloc());
+}
+BENCHMARK(SlabAllocatorBenchMixed)
+	->Arg(1024)
+	->Arg(64 * 1024)
+	->ThreadRange(1, 8)
+	->UseRealTime();
+
+auto MallocatorBenchMixed(benchmark::State& state) -> void
+{
+	static Onca::Alloc::Mallocator mallocator;
+	MixedSizeBench(state, mallocator);
+}
+BENCHMARK(MallocatorBenchMixed)
+	->Arg(1024)
+	->Arg(64 * 1024)
+	->ThreadRange(1, 8)
+	->UseRealTime();
+
+auto MallocBenchMixed(benchmark::State& state) -> void
+{
+	const usize numLive = usize(state.range(0));
+	Onca::Alloc::Mallocator mallocator;
+	Onca::DynArray<void*> live{ numLive, mallocator };
+	live.Resize(numLive);
+
+	u64 rng = 0x9E3779B97F4A7C15 + u64(state.thread_index());
+	for (void*& ptr : live)
+		ptr = malloc(NextMixedSize(rng));
+
+	for (auto _ : state)
+	{
+		void*& slot = live[usize(rng % numLive)];
+		free(slot);
+		slot = malloc(NextMixedSize(rng));
+		benchmark::DoNotOptimize(slot);
+	}
+
+	for (void* ptr : live)
+		free(ptr);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(MallocBenchMixed)
+	->Arg(1024)
+	->Arg(64 * 1024)
+	->ThreadRange(1, 8)
+	->UseRealTime();
+
+#endif
+
+#if BENCH_ALLOCS_TRACKING
+
+// range(0): 0 = tracker stopped, 1 = tracker running, 2 = tracker running with stack hashes
+auto TrackedMallocatorBench(benchmark::State& state) -> void
+{
+	Onca::Alloc::Mallocator mallocator;
+	if (state.range(0))
+		g_AllocTracker.Start({ .stackDepth = state.range(0) == 2 ? 16u : 0u });
+
+	for (auto _ : state)
+	{
+		auto mem = mallocator.Allocate<u8>(64);
+		benchmark::DoNotOptimize(mem.Ptr());
+		mallocator.Deallocate(Move(mem));
+	}
+
+	if (state.range(0))
+		g_AllocTracker.Stop();
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(TrackedMallocatorBench)
+	->DenseRange(0, 2);
+
+auto TrackingAllocatorBench(benchmark::State& state) -> void
+{
+	Onca::Alloc::Mallocator mallocator;
+	Onca::Alloc::TrackingAllocator tracking{ &mallocator, "Bench" };
+	if (state.range(0))
+		g_AllocTracker.Start();
+
+	for (auto _ : state)
+	{
+		auto mem = tracking.Allocate<u8>(64);
+		benchmark::DoNotOptimize(mem.Ptr());
+		tracking.Deallocate(Move(mem));
+	}
+
+	if (state.range(0))
+		g_AllocTracker.Stop();
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(TrackingAllocatorBench)
+	->DenseRange(0, 1);
+
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include "Config.h"
+
+#if BENCH_BITSET
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_BITSET_BULK 1
+#define BENCH_BITSET_ITERATE 1
+#define BENCH_BITSET_RANK_SELECT 1
+#define BENCH_BITSET_ROARING 1
+
+namespace
+{
+	// Fill a bitset with pseudo-random bits, with roughly 1 in 'density' bits set
+	auto RandomBitSet(usize numBits, u32 density, u32 seed, Alloc::IAllocator& alloc) -> BitSet
+	{
+		BitSet bits{ numBits, alloc };
+		u32 rng = seed;
+		for (usize i = 0; i < numBits; ++i)
+		{
+			rng ^= rng << 13;
+			rng ^= rng >> 17;
+			rng ^= rng << 5;
+			if (rng % density == 0)
+				bits.Set(i);
+		}
+		return bits;
+	}
+}
+
+#if BENCH_BITSET_BULK
+
+// Binary operator, allocating a new bitset for every operation
+auto BitSetAndAlloc(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet a = RandomBitSet(usize(state.range(0)), 2, 1, mallocator);
+	const BitSet b = RandomBitSet(usize(state.range(0)), 2, 2, mallocator);
+
+	for (auto _ : state)
+	{
+		BitSet res = a & b;
+		benchmark::DoNotOptimize(res.Count());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) / 4);
+}
+BENCHMARK(BitSetAndAlloc)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// In-place operator, no allocations
+auto BitSetAndInPlace(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	BitSet a = RandomBitSet(usize(state.range(0)), 2, 1, mallocator);
+	const BitSet b = RandomBitSet(usize(state.range(0)), 2, 2, mallocator);
+
+	for (auto _ : state)
+	{
+		a &= b;
+		benchmark::DoNotOptimize(a.Data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) / 4);
+}
+BENCHMARK(BitSetAndInPlace)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// Fused operation and count, without writing the result
+auto BitSetAndNotCount(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet a = RandomBitSet(usize(state.range(0)), 2, 1, mallocator);
+	const BitSet b = RandomBitSet(usize(state.range(0)), 2, 2, mallocator);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(a.AndNotCount(b));
+	state.SetBytesProcessed(state.iterations() * state.range(0) / 4);
+}
+BENCHMARK(BitSetAndNotCount)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// The same as AndNotCount, but creating the intermediate bitset
+auto BitSetAndNotCountAlloc(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet a = RandomBitSet(usize(state.range(0)), 2, 1, mallocator);
+	const BitSet b = RandomBitSet(usize(state.range(0)), 2, 2, mallocator);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize((a & ~b).Count());
+	state.SetBytesProcessed(state.iterations() * state.range(0) / 4);
+}
+BENCHMARK(BitSetAndNotCountAlloc)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+#endif
+
+#if BENCH_BITSET_ITERATE
+
+auto BitSetIterateIndex(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet bits = RandomBitSet(1 << 20, u32(state.range(0)), 1, mallocator);
+
+	for (auto _ : state)
+	{
+		usize sum = 0;
+		for (usize i = 0; i < bits.NumBits(); ++i)
+		{
+			if (bits[i])
+				sum += i;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * bits.Count());
+}
+BENCHMARK(BitSetIterateIndex)->RangeMultiplier(8)->Range(2, 1024);
+
+auto BitSetIterateFindNext(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet bits = RandomBitSet(1 << 20, u32(state.range(0)), 1, mallocator);
+
+	for (auto _ : state)
+	{
+		usize sum = 0;
+		for (usize i = bits.FindFirst(); i != BitSet::NPos; i = bits.FindNext(i))
+			sum += i;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * bits.Count());
+}
+BENCHMARK(BitSetIterateFindNext)->RangeMultiplier(8)->Range(2, 1024);
+
+auto BitSetIterateForEach(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet bits = RandomBitSet(1 << 20, u32(state.range(0)), 1, mallocator);
+
+	for (auto _ : state)
+	{
+		usize sum = 0;
+		bits.ForEachSetBit([&sum](usize idx) { sum += idx; });
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * bits.Count());
+}
+BENCHMARK(BitSetIterateForEach)->RangeMultiplier(8)->Range(2, 1024);
+
+#endif
+
+#if BENCH_BITSET_RANK_SELECT
+
+auto BitSetRankIndex(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet bits = RandomBitSet(usize(state.range(0)), 3, 1, mallocator);
+	const RankSelectIndex index{ bits, mallocator };
+
+	usize idx = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(index.Rank(idx));
+		idx = (idx + 7919) % bits.NumBits();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BitSetRankIndex)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// Rank without an index, counting all elements before the bit
+auto BitSetRankLinear(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet bits = RandomBitSet(usize(state.range(0)), 3, 1, mallocator);
+
+	usize idx = 0;
+	for (auto _ : state)
+	{
+		usize rank = 0;
+		const usize numElems = idx / BitSet::BitsPerElem;
+		for (usize i = 0; i < numElems; ++i)
+			rank += Intrin::PopCnt(bits.Data()[i]);
+		benchmark::DoNotOptimize(rank);
+		idx = (idx + 7919) % bits.NumBits();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BitSetRankLinear)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+auto BitSetSelectIndex(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const BitSet bits = RandomBitSet(usize(state.range(0)), 3, 1, mallocator);
+	const RankSelectIndex index{ bits, mallocator };
+
+	usize n = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(index.Select(n));
+		n = (n + 7919) % index.Count();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BitSetSelectIndex)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+#endif
+
+#if BENCH_BITSET_ROARING
+
+// Sparse sets with 'range(0)' values spread over 2^26 possible values
+auto SparseBitSetAndCount(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	constexpr usize numBits = 1 << 26;
+	const u32 density = u32(numBits / usize(state.range(0)));
+	const BitSet a = RandomBitSet(numBits, density, 1, mallocator);
+	const BitSet b = RandomBitSet(numBits, density, 2, mallocator);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(a.AndCount(b));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["Bytes"] = f64(a.DataSize() * sizeof(usize));
+}
+BENCHMARK(SparseBitSetAndCount)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+auto SparseRoaringAndCount(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	constexpr usize numBits = 1 << 26;
+	const u32 density = u32(numBits / usize(state.range(0)));
+
+	RoaringBitSet a{ mallocator };
+	RoaringBitSet b{ mallocator };
+	RandomBitSet(numBits, density, 1, mallocator).ForEachSetBit([&a](usize idx) { a.Add(u32(idx)); });
+	RandomBitSet(numBits, density, 2, mallocator).ForEachSetBit([&b](usize idx) { b.Add(u32(idx)); });
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(a.AndCount(b));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["Bytes"] = f64(a.DataSize());
+}
+BENCHMARK(SparseRoaringAndCount)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+auto SparseRoaringAnd(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	constexpr usize numBits = 1 << 26;
+	const u32 density = u32(numBits / usize(state.range(0)));
+
+	RoaringBitSet a{ mallocator };
+	RoaringBitSet b{ mallocator };
+	RandomBitSet(numBits, density, 1, mallocator).ForEachSetBit([&a](usize idx) { a.Add(u32(idx)); });
+	RandomBitSet(numBits, density, 2, mallocator).ForEachSetBit([&b](usize idx) { b.Add(u32(idx)); });
+
+	for (auto _ : state)
+	{
+		RoaringBitSet res = a;
+		res &= b;
+		benchmark::DoNotOptimize(res.Count());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SparseRoaringAnd)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+auto SparseRoaringContains(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	constexpr usize numBits = 1 << 26;
+	const u32 density = u32(numBits / usize(state.range(0)));
+
+	RoaringBitSet set{ mallocator };
+	RandomBitSet(numBits, density, 1, mallocator).ForEachSetBit([&set](usize idx) { set.Add(u32(idx)); });
+
+	u32 val = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(set.Contains(val));
+		val = (val + 7919) & (numBits - 1);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SparseRoaringContains)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+#endif
+
+#endif
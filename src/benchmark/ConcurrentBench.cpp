@@ -0,0 +1,282 @@
+#include "Config.h"
+
+#if BENCH_CONCURRENT
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_CONCURRENT_QUEUE 1
+#define BENCH_CONCURRENT_SPSC 1
+#define BENCH_CONCURRENT_MPSC 1
+#define BENCH_CONCURRENT_HASHMAP 1
+
+constexpr usize QueueCapacity = 4096;
+
+#if BENCH_CONCURRENT_QUEUE
+// Every thread pushes an element and pops an element, so all threads contend on both ends of the queue
+auto GuardedDequeBench(benchmark::State& state) -> void
+{
+	static Threading::Guarded<Deque<u64>> queue;
+
+	u64 val = u64(state.thread_index());
+	for (auto _ : state)
+	{
+		{
+			auto guard = queue.Lock();
+			guard->Push(val);
+		}
+		{
+			auto guard = queue.Lock();
+			if (!guard->IsEmpty())
+			{
+				val = guard->Front();
+				guard->PopFront();
+			}
+		}
+		benchmark::DoNotOptimize(val);
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(GuardedDequeBench)
+	->ThreadRange(1, 16)
+	->UseRealTime();
+
+auto MpmcQueueBench(benchmark::State& state) -> void
+{
+	static MpmcQueue<u64> queue{ QueueCapacity };
+
+	u64 val = u64(state.thread_index());
+	for (auto _ : state)
+	{
+		// Every thread pops as much as it pushes, so the queue can only be full when more threads than its capacity are running
+		while (!queue.TryPush(val));
+		if (Optional<u64> popped = queue.TryPop())
+			val = *popped;
+		benchmark::DoNotOptimize(val);
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(MpmcQueueBench)
+	->ThreadRange(1, 16)
+	->UseRealTime();
+#endif
+
+#if BENCH_CONCURRENT_SPSC
+// Thread 0 produces and thread 1 consumes, all threads run the same number of iterations, so every pushed element is popped
+auto GuardedDequeSpscBench(benchmark::State& state) -> void
+{
+	static Threading::Guarded<Deque<u64>> queue;
+
+	const bool producer = state.thread_index() == 0;
+	u64 val = 0;
+	for (auto _ : state)
+	{
+		if (producer)
+		{
+			auto guard = queue.Lock();
+			guard->Push(val++);
+		}
+		else
+		{
+			while (true)
+			{
+				auto guard = queue.Lock();
+				if (!guard->IsEmpty())
+				{
+					val = guard->Front();
+					guard->PopFront();
+					break;
+				}
+			}
+		}
+		benchmark::DoNotOptimize(val);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(GuardedDequeSpscBench)
+	->Threads(2)
+	->UseRealTime();
+
+auto SpscRingBench(benchmark::State& state) -> void
+{
+	static SpscRing<u64, QueueCapacity> ring;
+
+	const bool producer = state.thread_index() == 0;
+	u64 val = 0;
+	for (auto _ : state)
+	{
+		if (producer)
+		{
+			while (!ring.TryPush(val));
+			++val;
+		}
+		else
+		{
+			Optional<u64> popped;
+			while (!(popped = ring.TryPop()));
+			val = *popped;
+		}
+		benchmark::DoNotOptimize(val);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SpscRingBench)
+	->Threads(2)
+	->UseRealTime();
+#endif
+
+#if BENCH_CONCURRENT_MPSC
+// Thread 0 consumes the elements of all other threads, producers only reuse an element once the consumer released it
+constexpr usize NumMpscElems = 1024;
+
+struct MpscBenchElem
+{
+	MpscBenchElem() : node(offsetof(MpscBenchElem, node)), inUse(false) {}
+
+	IntrusiveListNode<MpscBenchElem> node;
+	Atomic<bool>                     inUse;
+};
+
+auto GuardedDequeMpscBench(benchmark::State& state) -> void
+{
+	static Threading::Guarded<Deque<u64>> queue;
+
+	const usize numProducers = usize(state.threads()) - 1;
+	u64 val = 0;
+	for (auto _ : state)
+	{
+		if (state.thread_index() != 0)
+		{
+			auto guard = queue.Lock();
+			guard->Push(val++);
+		}
+		else
+		{
+			for (usize numPopped = 0; numPopped < numProducers;)
+			{
+				auto guard = queue.Lock();
+				while (!guard->IsEmpty() && numPopped < numProducers)
+				{
+					val = guard->Front();
+					guard->PopFront();
+					++numPopped;
+				}
+			}
+		}
+		benchmark::DoNotOptimize(val);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(GuardedDequeMpscBench)
+	->ThreadRange(2, 16)
+	->UseRealTime();
+
+auto MpscQueueBench(benchmark::State& state) -> void
+{
+	static MpscQueue<MpscBenchElem> queue;
+
+	const usize numProducers = usize(state.threads()) - 1;
+	MpscBenchElem elems[NumMpscElems];
+	usize elemIdx = 0;
+	for (auto _ : state)
+	{
+		if (state.thread_index() != 0)
+		{
+			MpscBenchElem& elem = elems[elemIdx];
+			while (elem.inUse.Load(MemOrder::Acquire));
+			elem.inUse.Store(true, MemOrder::Relaxed);
+			queue.Push(elem.node);
+			elemIdx = (elemIdx + 1) % NumMpscElems;
+		}
+		else
+		{
+			for (usize numPopped = 0; numPopped < numProducers;)
+			{
+				if (MpscBenchElem* pElem = queue.TryPop())
+				{
+					pElem->inUse.Store(false, MemOrder::Release);
+					++numPopped;
+				}
+			}
+		}
+	}
+
+	// Keep the elements alive until the consumer released all of them
+	for (MpscBenchElem& elem : elems)
+	{
+		while (elem.inUse.Load(MemOrder::Acquire));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(MpscQueueBench)
+	->ThreadRange(2, 16)
+	->UseRealTime();
+#endif
+
+#if BENCH_CONCURRENT_HASHMAP
+// Mixed workload with 80% lookups, 10% inserts and 10% erases over a fixed key range
+constexpr u32 NumHashMapKeys = 64 * 1024;
+
+template<typename F0, typename F1, typename F2>
+void RunMixedHashMapOps(benchmark::State& state, F0 find, F1 insert, F2 erase)
+{
+	u64 rng = 0x9E3779B97F4A7C15 + u64(state.thread_index());
+	for (auto _ : state)
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 7;
+		rng ^= rng << 17;
+
+		const u32 key = u32(rng >> 16) % NumHashMapKeys;
+		const u32 op = u32(rng >> 48) % 10;
+		if (op < 8)
+			find(key);
+		else if (op == 8)
+			insert(key);
+		else
+			erase(key);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+auto GuardedHashMapBench(benchmark::State& state) -> void
+{
+	static Threading::Guarded<HashMap<u32, u32>> map = []
+	{
+		HashMap<u32, u32> tmp;
+		for (u32 i = 0; i < NumHashMapKeys; i += 2)
+			tmp.Insert(i, i);
+		return Threading::Guarded<HashMap<u32, u32>>{ Move(tmp) };
+	}();
+
+	RunMixedHashMapOps(state,
+		[](u32 key) { benchmark::DoNotOptimize(map.Lock()->Contains(key)); },
+		[](u32 key) { map.Lock()->TryInsert(key, key); },
+		[](u32 key) { map.Lock()->Erase(key); });
+}
+BENCHMARK(GuardedHashMapBench)
+	->ThreadRange(1, 16)
+	->UseRealTime();
+
+auto ConcurrentHashMapBench(benchmark::State& state) -> void
+{
+	static ConcurrentHashMap<u32, u32> map;
+	static bool prefilled = []
+	{
+		for (u32 i = 0; i < NumHashMapKeys; i += 2)
+			map.Insert(i, i);
+		return true;
+	}();
+	UNUSED(prefilled);
+
+	RunMixedHashMapOps(state,
+		[](u32 key) { benchmark::DoNotOptimize(map.Contains(key)); },
+		[](u32 key) { map.TryInsert(key, key); },
+		[](u32 key) { map.Erase(key); });
+}
+BENCHMARK(ConcurrentHashMapBench)
+	->ThreadRange(1, 16)
+	->UseRealTime();
+#endif
+
+#endif
@@ -22,4 +22,17 @@
 #endif
 
 #define BENCH_ALLOCS 1
-#define BENCH_DYNARRAY 0
\ No newline at end of file
+#define BENCH_DYNARRAY 0
+#define BENCH_FILESYSTEM 0
+#define BENCH_REFCOUNTED 0
+#define BENCH_INPUT 0
+#define BENCH_NUMA 0
+#define BENCH_CONTAINERS 0
+#define BENCH_CONCURRENT 0
+#define BENCH_SLOTMAP 0
+#define BENCH_BITSET 0
+#define BENCH_DEQUE 0
+#define BENCH_SERIALIZE 0
+#define BENCH_FLATMAP 0
+#define BENCH_TIMER 0
+#define BENCH_PERSISTENT 0
\ No newline at end of file
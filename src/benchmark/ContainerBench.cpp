@@ -0,0 +1,88 @@
+#include "Config.h"
+
+#if BENCH_CONTAINERS
+#include "core/Core.h"
+
+using namespace Onca;
+
+// Reports the size of the container headers, containers store their allocator once and reference their memory with compact MemRefs
+auto ContainerFootprint(benchmark::State& state) -> void
+{
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sizeof(DynArray<u32>));
+
+	state.counters["DynArray"] = f64(sizeof(DynArray<u32>));
+	state.counters["String"] = f64(sizeof(String));
+	state.counters["Deque"] = f64(sizeof(Deque<u32>));
+	state.counters["HashMap"] = f64(sizeof(HashMap<u32, u32>));
+	state.counters["MemRef"] = f64(sizeof(MemRef<u8>));
+	state.counters["CompactMemRef"] = f64(sizeof(CompactMemRef<u8>));
+}
+BENCHMARK(ContainerFootprint)->Iterations(1);
+
+// Copying an array of strings copies one header per element, so smaller headers mean less memory to touch
+auto StringArrayCopy(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<String> src{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		src.Add(Format("string {}"_s, i));
+
+	for (auto _ : state)
+	{
+		DynArray<String> copy{ src };
+		benchmark::DoNotOptimize(copy.Data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["HeaderBytes"] = f64(sizeof(String) * usize(state.range(0)));
+}
+BENCHMARK(StringArrayCopy)->RangeMultiplier(8)->Range(64, 32768);
+
+// Growing an array of arrays relocates all inner headers on every reallocation
+auto NestedDynArrayGrow(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		DynArray<DynArray<u32>> arr{ mallocator };
+		for (i64 i = 0; i < state.range(0); ++i)
+			arr.Add(DynArray<u32>{ mallocator });
+		benchmark::DoNotOptimize(arr.Data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(NestedDynArrayGrow)->RangeMultiplier(8)->Range(64, 32768);
+
+// Every node in the HashMap links to the next with a compact MemRef
+auto HashMapCopy(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HashMap<u32, u32> src{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		src.Insert(u32(i), u32(i * 3));
+
+	for (auto _ : state)
+	{
+		HashMap<u32, u32> copy{ src };
+		benchmark::DoNotOptimize(copy.Size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapCopy)->RangeMultiplier(8)->Range(64, 32768);
+
+auto StdStringVectorCopy(benchmark::State& state) -> void
+{
+	std::vector<std::string> src;
+	for (i64 i = 0; i < state.range(0); ++i)
+		src.push_back("string " + std::to_string(i));
+
+	for (auto _ : state)
+	{
+		std::vector<std::string> copy{ src };
+		benchmark::DoNotOptimize(copy.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(StdStringVectorCopy)->RangeMultiplier(8)->Range(64, 32768);
+
+#endif
@@ -0,0 +1,229 @@
+#include "Config.h"
+
+#if BENCH_DEQUE
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_DEQUE_PUSH 1
+#define BENCH_DEQUE_QUEUE 1
+#define BENCH_DEQUE_ITERATE 1
+#define BENCH_DEQUE_WORK_STEALING 1
+
+// Deque with the block size that was used by default before blocks were sized by their byte size
+template<typename T>
+using SmallBlockDeque = Deque<T, 8>;
+
+#if BENCH_DEQUE_PUSH
+
+template<typename D>
+auto DequePushBack(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		D deque{ mallocator };
+		for (i64 i = 0; i < state.range(0); ++i)
+			deque.Push(u64(i));
+		benchmark::DoNotOptimize(deque.Back());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(DequePushBack, SmallBlockDeque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+BENCHMARK_TEMPLATE(DequePushBack, Deque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+
+auto DequeBulkPushBack(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<u64> src{ usize(state.range(0)), 0, mallocator };
+	for (auto _ : state)
+	{
+		Deque<u64> deque{ mallocator };
+		deque.Push(src.Data(), src.Size());
+		benchmark::DoNotOptimize(deque.Back());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(DequeBulkPushBack)->RangeMultiplier(8)->Range(64, 262144);
+
+template<typename D>
+auto DequePushFront(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		D deque{ mallocator };
+		for (i64 i = 0; i < state.range(0); ++i)
+			deque.PushFront(u64(i));
+		benchmark::DoNotOptimize(deque.Front());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(DequePushFront, SmallBlockDeque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+BENCHMARK_TEMPLATE(DequePushFront, Deque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+
+#endif
+
+#if BENCH_DEQUE_QUEUE
+
+// FIFO usage with 'range(0)' elements in flight, blocks freed at the front are reused at the back
+template<typename D>
+auto DequeQueue(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	D deque{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		deque.Push(u64(i));
+
+	u64 val = 0;
+	for (auto _ : state)
+	{
+		deque.Push(val);
+		val = deque.Front();
+		deque.PopFront();
+	}
+	benchmark::DoNotOptimize(val);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(DequeQueue, SmallBlockDeque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+BENCHMARK_TEMPLATE(DequeQueue, Deque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+
+// FIFO usage, pushing and popping 256 elements at a time
+auto DequeBulkQueue(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	Deque<u64> deque{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		deque.Push(u64(i));
+
+	u64 batch[256] = {};
+	for (auto _ : state)
+	{
+		deque.Push(batch, 256);
+		batch[0] = deque.Front();
+		deque.PopFront(256);
+	}
+	state.SetItemsProcessed(state.iterations() * 256);
+}
+BENCHMARK(DequeBulkQueue)->RangeMultiplier(8)->Range(64, 262144);
+
+#endif
+
+#if BENCH_DEQUE_ITERATE
+
+template<typename D>
+auto DequeIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	D deque{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		deque.Push(u64(i));
+
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (u64 val : deque)
+			sum += val;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(DequeIterate, SmallBlockDeque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+BENCHMARK_TEMPLATE(DequeIterate, Deque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+
+template<typename D>
+auto DequeRandomAccess(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	D deque{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		deque.Push(u64(i));
+
+	usize idx = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(deque[idx]);
+		idx = (idx + 7919) % deque.Size();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(DequeRandomAccess, SmallBlockDeque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+BENCHMARK_TEMPLATE(DequeRandomAccess, Deque<u64>)->RangeMultiplier(8)->Range(64, 262144);
+
+#endif
+
+#if BENCH_DEQUE_WORK_STEALING
+
+// Thread 0 owns the deque and pushes and pops its own work, all other threads steal
+auto WorkStealingDequeBench(benchmark::State& state) -> void
+{
+	static WorkStealingDeque<u64>* pDeque = nullptr;
+	if (state.thread_index() == 0)
+		pDeque = new WorkStealingDeque<u64>{ 1024 };
+
+	u64 numTaken = 0;
+	for (auto _ : state)
+	{
+		if (state.thread_index() == 0)
+		{
+			pDeque->Push(numTaken);
+			pDeque->Push(numTaken);
+			if (pDeque->Pop())
+				++numTaken;
+		}
+		else
+		{
+			if (pDeque->Steal())
+				++numTaken;
+		}
+	}
+	state.SetItemsProcessed(i64(numTaken));
+
+	if (state.thread_index() == 0)
+	{
+		delete pDeque;
+		pDeque = nullptr;
+	}
+}
+BENCHMARK(WorkStealingDequeBench)
+	->ThreadRange(1, 8)
+	->UseRealTime();
+
+// The same work distribution, with a mutex protected deque
+auto GuardedWorkDequeBench(benchmark::State& state) -> void
+{
+	static Threading::Guarded<Deque<u64>> deque;
+
+	u64 numTaken = 0;
+	for (auto _ : state)
+	{
+		if (state.thread_index() == 0)
+		{
+			auto guard = deque.Lock();
+			guard->Push(numTaken);
+			guard->Push(numTaken);
+			guard->Pop();
+			++numTaken;
+		}
+		else
+		{
+			auto guard = deque.Lock();
+			if (!guard->IsEmpty())
+			{
+				guard->PopFront();
+				++numTaken;
+			}
+		}
+	}
+	state.SetItemsProcessed(i64(numTaken));
+
+	if (state.thread_index() == 0)
+		deque.Lock()->Clear();
+}
+BENCHMARK(GuardedWorkDequeBench)
+	->ThreadRange(1, 8)
+	->UseRealTime();
+
+#endif
+
+#endif
@@ -483,6 +483,82 @@ auto DynArrayAddReserved(benchmark::State& state) -> void
 BENCHMARK(DynArrayAddReserved)
 	->DenseRange(256, 1024, 256);
 
+// The DynArray grows in place at the end of the arena, so elements are never moved
+auto DynArrayAddVirtualArena(benchmark::State& state) -> void
+{
+	Onca::Alloc::VirtualArena arena{ 1_GiB };
+	for (auto _ : state)
+	{
+		{
+			Onca::DynArray<u32> dynArr{ arena };
+			for (usize i = 0, count = state.range(0); i < count; ++i)
+				dynArr.Add(42);
+		}
+		arena.Reset();
+	}
+}
+BENCHMARK(DynArrayAddVirtualArena)
+	->DenseRange(256, 1024, 256)
+	->Arg(1 << 20);
+
+// Push back 100M elements without reserving, growth uses realloc, as u32 is trivially relocatable
+auto StdVectorPushBack100M(benchmark::State& state) -> void
+{
+	for (auto _ : state)
+	{
+		std::vector<u32> vec;
+		for (usize i = 0; i < 100'000'000; ++i)
+			vec.push_back(u32(i));
+		benchmark::DoNotOptimize(vec.data());
+	}
+}
+BENCHMARK(StdVectorPushBack100M)
+	->Unit(benchmark::kMillisecond);
+
+auto DynArrayPushBack100M(benchmark::State& state) -> void
+{
+	Core::Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		Core::DynArray<u32> dynArr{ mallocator };
+		for (usize i = 0; i < 100'000'000; ++i)
+			dynArr.Add(u32(i));
+		benchmark::DoNotOptimize(dynArr.Data());
+	}
+}
+BENCHMARK(DynArrayPushBack100M)
+	->Unit(benchmark::kMillisecond);
+
+// Elements that own memory, which std::vector needs to move one by one, but are trivially relocatable for the DynArray
+auto StdVectorPushBackNested(benchmark::State& state) -> void
+{
+	for (auto _ : state)
+	{
+		std::vector<std::vector<u32>> vec;
+		for (usize i = 0, count = state.range(0); i < count; ++i)
+			vec.emplace_back(4, u32(i));
+		benchmark::DoNotOptimize(vec.data());
+	}
+}
+BENCHMARK(StdVectorPushBackNested)
+	->Arg(1 << 20)
+	->Unit(benchmark::kMillisecond);
+
+auto DynArrayPushBackNested(benchmark::State& state) -> void
+{
+	Core::Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		Core::DynArray<Core::DynArray<u32>> dynArr{ mallocator };
+		for (usize i = 0, count = state.range(0); i < count; ++i)
+			dynArr.Add(Core::DynArray<u32>{ 4, u32(i), mallocator });
+		benchmark::DoNotOptimize(dynArr.Data());
+	}
+}
+BENCHMARK(DynArrayPushBackNested)
+	->Arg(1 << 20)
+	->Unit(benchmark::kMillisecond);
+
 auto DynArrayAddDynArray(benchmark::State& state) -> void
 {
 	Core::Alloc::Mallocator mallocator;
@@ -0,0 +1,296 @@
+#include "Config.h"
+
+#if BENCH_FILESYSTEM
+#include "core/Core.h"
+
+#define BENCH_FILESYSTEM_WALK 1
+#define BENCH_FILESYSTEM_STREAM 1
+#define BENCH_FILESYSTEM_READ_ALL 1
+
+using namespace Onca;
+using namespace Onca::FileSystem;
+
+// Synthetic tree: 1000 directories with 1000 empty files each (1M files)
+constexpr usize SyntheticDirCount = 1000;
+constexpr usize SyntheticFilesPerDir = 1000;
+
+auto GetBenchAlloc() -> Alloc::Mallocator&
+{
+	static Alloc::Mallocator mallocator;
+	return mallocator;
+}
+
+auto GetSyntheticTree() -> const Path&
+{
+	static Path root = [] {
+		SetGlobalAlloc(GetBenchAlloc());
+
+		Path path = GetCurrentWorkingDirectory() / "bench_synthetic_tree"_path;
+		if (IsDirectory(path))
+			return path;
+
+		CreateDirectory(path);
+		for (usize i = 0; i < SyntheticDirCount; ++i)
+		{
+			Path dir = path / Path{ Format("dir{}"_s, i) };
+			CreateDirectory(dir);
+			for (usize j = 0; j < SyntheticFilesPerDir; ++j)
+				UNUSED(File::Create(dir / Path{ Format("file{}.bin"_s, j) }, FileCreateKind::CreateNew));
+		}
+		return path;
+	}();
+	return root;
+}
+
+#if BENCH_FILESYSTEM_WALK
+
+auto EnumerateFileSystemBench(benchmark::State& state) -> void
+{
+	const Path& root = GetSyntheticTree();
+	for (auto _ : state)
+	{
+		usize count = 0;
+		auto lambda = [&count](const Entry&) { ++count; };
+		Delegate<void(const Entry&)> del{ lambda };
+		EnumerateFileSystem(del, root, true);
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK(EnumerateFileSystemBench)
+	->Unit(benchmark::kMillisecond);
+
+auto DirectoryWalkerNextBench(benchmark::State& state) -> void
+{
+	const Path& root = GetSyntheticTree();
+	for (auto _ : state)
+	{
+		usize count = 0;
+		DirectoryWalker walker{ root };
+		EntryBatch batch;
+		while (walker.Next(batch))
+			count += batch.Size();
+		benchmark::DoNotOptimize(count);
+	}
+}
+BENCHMARK(DirectoryWalkerNextBench)
+	->Unit(benchmark::kMillisecond);
+
+auto DirectoryWalkerParallelBench(benchmark::State& state) -> void
+{
+	const Path& root = GetSyntheticTree();
+	for (auto _ : state)
+	{
+		Atomic<usize> count{ 0 };
+		auto lambda = [&count](const EntryBatch& batch) { count.FetchAdd(batch.Size(), MemOrder::Relaxed); };
+		EntryBatchCallback callback{ lambda };
+		WalkDirectory(callback, root, { .numThreads = u16(state.range(0)) });
+		benchmark::DoNotOptimize(count.Load());
+	}
+}
+BENCHMARK(DirectoryWalkerParallelBench)
+	->RangeMultiplier(2)
+	->Range(1, 16)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+#endif
+
+#if BENCH_FILESYSTEM_STREAM
+
+// Small records, similar to log lines
+constexpr usize StreamRecordSize = 64;
+constexpr usize StreamRecordCount = 100'000;
+
+auto GetStreamRecord() -> const ByteBuffer&
+{
+	static ByteBuffer record = [] {
+		SetGlobalAlloc(GetBenchAlloc());
+		ByteBuffer buffer;
+		buffer.Resize(StreamRecordSize, u8('x'));
+		return buffer;
+	}();
+	return record;
+}
+
+auto GetStreamPath() -> Path
+{
+	return GetCurrentWorkingDirectory() / "bench_stream.bin"_path;
+}
+
+auto FileWriteRecordsBench(benchmark::State& state) -> void
+{
+	const ByteBuffer& record = GetStreamRecord();
+	for (auto _ : state)
+	{
+		File file = File::Create(GetStreamPath(), FileCreateKind::CreateAlways).MoveValue();
+		for (usize i = 0; i < StreamRecordCount; ++i)
+			file.Write(record);
+	}
+	state.SetBytesProcessed(state.iterations() * StreamRecordCount * StreamRecordSize);
+}
+BENCHMARK(FileWriteRecordsBench)
+	->Unit(benchmark::kMillisecond);
+
+auto BufferedWriteRecordsBench(benchmark::State& state) -> void
+{
+	const ByteBuffer& record = GetStreamRecord();
+	const bool doubleBuffer = state.range(1) != 0;
+	const FileFlags flags = doubleBuffer ? FileFlag::AllowAsync : FileFlag::None;
+	for (auto _ : state)
+	{
+		File file = File::Create(GetStreamPath(), FileCreateKind::CreateAlways, AccessMode::ReadWrite, ShareMode::None, FileAttribute::None, flags).MoveValue();
+		BufferedFileWriter writer{ Move(file), { .bufferSize = u32(state.range(0)), .doubleBuffer = doubleBuffer } };
+		for (usize i = 0; i < StreamRecordCount; ++i)
+			writer.Write(record);
+		writer.Flush();
+	}
+	state.SetBytesProcessed(state.iterations() * StreamRecordCount * StreamRecordSize);
+}
+BENCHMARK(BufferedWriteRecordsBench)
+	->ArgsProduct({ { 4 << 10, 64 << 10, 1 << 20 }, { 0, 1 } })
+	->Unit(benchmark::kMillisecond);
+
+auto BufferedWriteVRecordsBench(benchmark::State& state) -> void
+{
+	const ByteBuffer& record = GetStreamRecord();
+	// Header + payload, like a log prefix and message
+	const WriteRegion regions[2] = { { record.Data(), 16 }, { record.Data() + 16, StreamRecordSize - 16 } };
+	for (auto _ : state)
+	{
+		BufferedFileWriter writer{ File::Create(GetStreamPath(), FileCreateKind::CreateAlways).MoveValue() };
+		for (usize i = 0; i < StreamRecordCount; ++i)
+			writer.WriteV(regions, 2);
+		writer.Flush();
+	}
+	state.SetBytesProcessed(state.iterations() * StreamRecordCount * StreamRecordSize);
+}
+BENCHMARK(BufferedWriteVRecordsBench)
+	->Unit(benchmark::kMillisecond);
+
+auto BufferedReadRecordsBench(benchmark::State& state) -> void
+{
+	{
+		BufferedFileWriter writer{ File::Create(GetStreamPath(), FileCreateKind::CreateAlways).MoveValue() };
+		for (usize i = 0; i < StreamRecordCount; ++i)
+			writer.Write(GetStreamRecord());
+	}
+
+	const bool doubleBuffer = state.range(1) != 0;
+	const FileFlags flags = doubleBuffer ? FileFlag::AllowAsync : FileFlag::Sequential;
+	u8 record[StreamRecordSize];
+	for (auto _ : state)
+	{
+		BufferedFileReader reader{ File::Open(GetStreamPath(), false, AccessMode::Read, ShareMode::None, flags).MoveValue(), { .bufferSize = u32(state.range(0)), .doubleBuffer = doubleBuffer } };
+		usize count = 0;
+		while (reader.Read(record, StreamRecordSize).Value() == StreamRecordSize)
+			++count;
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * StreamRecordCount * StreamRecordSize);
+}
+BENCHMARK(BufferedReadRecordsBench)
+	->ArgsProduct({ { 4 << 10, 64 << 10, 1 << 20 }, { 0, 1 } })
+	->Unit(benchmark::kMillisecond);
+
+#endif
+
+#if BENCH_FILESYSTEM_READ_ALL
+
+// Whole file reads of 1KiB, 1MiB and 8GiB files
+auto GetReadAllPath(u64 size) -> Path
+{
+	const Path path = GetCurrentWorkingDirectory() / Path{ Format("bench_read_{}.bin"_s, size) };
+	if (IsFile(path))
+		return path;
+
+	SetGlobalAlloc(GetBenchAlloc());
+	BufferedFileWriter writer{ File::Create(path, FileCreateKind::CreateNew).MoveValue(), { .bufferSize = u32(1_MiB) } };
+	ByteBuffer chunk;
+	chunk.Resize(usize(Math::Min(size, 64_MiB)), u8('x'));
+	for (u64 written = 0; written < size; written += chunk.Size())
+		writer.Write(chunk.Data(), usize(Math::Min(u64(chunk.Size()), size - written)));
+	return path;
+}
+
+auto FileReadBench(benchmark::State& state) -> void
+{
+	const Path path = GetReadAllPath(u64(state.range(0)));
+	u64 bytesRead = 0;
+	for (auto _ : state)
+	{
+		File file = File::Open(path, false, AccessMode::Read, ShareMode::Read).MoveValue();
+		ByteBuffer buffer = file.Read().MoveValue();
+		bytesRead += buffer.Size();
+		benchmark::DoNotOptimize(buffer.Data());
+	}
+	state.SetBytesProcessed(bytesRead);
+}
+BENCHMARK(FileReadBench)
+	->Arg(1 << 10)
+	->Arg(1 << 20)
+	->Arg(i64(8) << 30)
+	->Unit(benchmark::kMillisecond);
+
+auto ReadAllBench(benchmark::State& state) -> void
+{
+	const Path path = GetReadAllPath(u64(state.range(0)));
+	u64 bytesRead = 0;
+	for (auto _ : state)
+	{
+		ByteBuffer buffer = ReadAll(path).MoveValue();
+		bytesRead += buffer.Size();
+		benchmark::DoNotOptimize(buffer.Data());
+	}
+	state.SetBytesProcessed(bytesRead);
+}
+BENCHMARK(ReadAllBench)
+	->Arg(1 << 10)
+	->Arg(1 << 20)
+	->Arg(i64(8) << 30)
+	->Unit(benchmark::kMillisecond);
+
+auto ReadAllLinearBench(benchmark::State& state) -> void
+{
+	const Path path = GetReadAllPath(u64(state.range(0)));
+	Alloc::LinearAllocator<2 << 20, 64> alloc{ &GetBenchAlloc() };
+	u64 bytesRead = 0;
+	for (auto _ : state)
+	{
+		{
+			ByteBuffer buffer = ReadAll(path, alloc).MoveValue();
+			bytesRead += buffer.Size();
+			benchmark::DoNotOptimize(buffer.Data());
+		}
+		alloc.Reset();
+	}
+	state.SetBytesProcessed(bytesRead);
+}
+BENCHMARK(ReadAllLinearBench)
+	->Arg(1 << 10)
+	->Arg(1 << 20)
+	->Unit(benchmark::kMillisecond);
+
+auto ReadIntoBench(benchmark::State& state) -> void
+{
+	const u64 size = u64(state.range(0));
+	const Path path = GetReadAllPath(size);
+	MemRef<u8> mem = GetBenchAlloc().Allocate<u8>(usize(size), 4096);
+	u64 bytesRead = 0;
+	for (auto _ : state)
+	{
+		File file = File::Open(path, false, AccessMode::Read, ShareMode::Read, FileFlag::AllowAsync).MoveValue();
+		bytesRead += file.ReadInto(mem.Ptr(), size).Value();
+		benchmark::DoNotOptimize(mem.Ptr());
+	}
+	GetBenchAlloc().Deallocate(Move(mem));
+	state.SetBytesProcessed(bytesRead);
+}
+BENCHMARK(ReadIntoBench)
+	->Arg(1 << 10)
+	->Arg(1 << 20)
+	->Arg(i64(8) << 30)
+	->Unit(benchmark::kMillisecond);
+
+#endif
+
+#endif
@@ -0,0 +1,241 @@
+#include "Config.h"
+
+#if BENCH_FLATMAP
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_FLATMAP_BUILD 1
+#define BENCH_FLATMAP_LOOKUP 1
+#define BENCH_FLATMAP_ITERATE 1
+
+namespace
+{
+	// SortedMap is a thin wrapper around a RedBlackTree of pairs, ordered by key, so the tree is benchmarked directly
+	struct PairKeyComparator
+	{
+		auto operator()(const Pair<u32, u64>& p0, const Pair<u32, u64>& p1) const noexcept -> i8
+		{
+			return p0.first < p1.first ? -1 : p0.first > p1.first ? 1 : 0;
+		}
+	};
+	using TreeMap = RedBlackTree<Pair<u32, u64>, PairKeyComparator>;
+
+	// Random sparse keys, so neither the hash map nor the searches get an advantage from dense keys
+	auto RandomKeys(u32 count, Alloc::IAllocator& alloc) -> DynArray<u32>
+	{
+		DynArray<u32> keys{ alloc };
+		keys.Reserve(count);
+
+		u32 rng = 0x12345678;
+		for (u32 i = 0; i < count; ++i)
+		{
+			rng ^= rng << 13;
+			rng ^= rng >> 17;
+			rng ^= rng << 5;
+			keys.Add(rng);
+		}
+		return keys;
+	}
+
+	auto RandomPairs(u32 count, Alloc::IAllocator& alloc) -> DynArray<Pair<u32, u64>>
+	{
+		DynArray<u32> keys = RandomKeys(count, alloc);
+		DynArray<Pair<u32, u64>> pairs{ alloc };
+		pairs.Reserve(count);
+		for (u32 key : keys)
+			pairs.Add(Pair<u32, u64>{ key, u64(key) * 3 });
+		return pairs;
+	}
+}
+
+#if BENCH_FLATMAP_BUILD
+
+auto FlatMapBulkBuild(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<Pair<u32, u64>> pairs = RandomPairs(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		FlatMap<u32, u64> map{ DynArray<Pair<u32, u64>>{ pairs } };
+		benchmark::DoNotOptimize(map.Size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FlatMapBulkBuild)->RangeMultiplier(8)->Range(8, 100000);
+
+auto FlatMapInsert(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<Pair<u32, u64>> pairs = RandomPairs(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		FlatMap<u32, u64> map{ mallocator };
+		for (const Pair<u32, u64>& pair : pairs)
+			benchmark::DoNotOptimize(map.Insert(pair.first, pair.second).second);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FlatMapInsert)->RangeMultiplier(8)->Range(8, 32768);
+
+auto SortedMapInsert(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<Pair<u32, u64>> pairs = RandomPairs(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		TreeMap map{ mallocator };
+		for (const Pair<u32, u64>& pair : pairs)
+			benchmark::DoNotOptimize(map.Insert(pair).second);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SortedMapInsert)->RangeMultiplier(8)->Range(8, 100000);
+
+auto HashMapInsert(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<Pair<u32, u64>> pairs = RandomPairs(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		HashMap<u32, u64> map{ mallocator };
+		for (const Pair<u32, u64>& pair : pairs)
+			benchmark::DoNotOptimize(map.Insert(pair.first, pair.second).second);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapInsert)->RangeMultiplier(8)->Range(8, 100000);
+
+#endif
+
+#if BENCH_FLATMAP_LOOKUP
+
+auto FlatMapLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const FlatMap<u32, u64> map{ RandomPairs(u32(state.range(0)), mallocator) };
+	const DynArray<u32> keys = RandomKeys(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 key : keys)
+			benchmark::DoNotOptimize(map.Find(key).Value());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FlatMapLookup)->RangeMultiplier(8)->Range(8, 100000);
+
+auto FlatMapEytzingerLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const FlatMap<u32, u64> map{ RandomPairs(u32(state.range(0)), mallocator) };
+	const EytzingerIndex<u32> index{ map.Keys().Data(), map.Size(), mallocator };
+	const DynArray<u32> keys = RandomKeys(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 key : keys)
+			benchmark::DoNotOptimize(map.ValueAt(index.Find(key)));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FlatMapEytzingerLookup)->RangeMultiplier(8)->Range(8, 100000);
+
+auto InplaceFlatMapLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const InplaceFlatMap<u32, u64, 64> map{ RandomPairs(u32(state.range(0)), mallocator) };
+	const DynArray<u32> keys = RandomKeys(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 key : keys)
+			benchmark::DoNotOptimize(map.Find(key).Value());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(InplaceFlatMapLookup)->RangeMultiplier(8)->Range(8, 64);
+
+auto SortedMapLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<Pair<u32, u64>> pairs = RandomPairs(u32(state.range(0)), mallocator);
+	TreeMap map{ pairs.Begin(), pairs.End(), mallocator };
+	const DynArray<u32> keys = RandomKeys(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 key : keys)
+			benchmark::DoNotOptimize(map.Find(Pair<u32, u64>{ key, 0 }));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SortedMapLookup)->RangeMultiplier(8)->Range(8, 100000);
+
+auto HashMapLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HashMap<u32, u64> map{ mallocator };
+	for (const Pair<u32, u64>& pair : RandomPairs(u32(state.range(0)), mallocator))
+		map.Insert(pair.first, pair.second);
+	const DynArray<u32> keys = RandomKeys(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 key : keys)
+			benchmark::DoNotOptimize(map.Find(key));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapLookup)->RangeMultiplier(8)->Range(8, 100000);
+
+#endif
+
+#if BENCH_FLATMAP_ITERATE
+
+auto FlatMapIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const FlatMap<u32, u64> map{ RandomPairs(u32(state.range(0)), mallocator) };
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (auto [key, value] : map)
+			sum += key + value;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FlatMapIterate)->RangeMultiplier(8)->Range(8, 100000);
+
+auto SortedMapIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<Pair<u32, u64>> pairs = RandomPairs(u32(state.range(0)), mallocator);
+	TreeMap map{ pairs.Begin(), pairs.End(), mallocator };
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (TreeMap::Iterator it = map.Begin(), end = map.End(); it != end; ++it)
+			sum += it->first + it->second;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SortedMapIterate)->RangeMultiplier(8)->Range(8, 100000);
+
+auto HashMapIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HashMap<u32, u64> map{ mallocator };
+	for (const Pair<u32, u64>& pair : RandomPairs(u32(state.range(0)), mallocator))
+		map.Insert(pair.first, pair.second);
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (const auto& pair : map)
+			sum += pair.first + pair.second;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapIterate)->RangeMultiplier(8)->Range(8, 100000);
+
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+#include "Config.h"
+
+#if BENCH_INPUT
+#include "core/Core.h"
+#include "core/input/BuiltinModifiers.h"
+#include "core/input/BuiltinTriggers.h"
+
+using namespace Onca;
+
+// Forwards to a mallocator, counting the allocations made through it
+class CountingAllocator final : public Alloc::IAllocator
+{
+public:
+	auto GetNumAllocs() const noexcept -> u64 { return m_numAllocs.Load(MemOrder::Relaxed); }
+
+protected:
+	auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override
+	{
+		m_numAllocs.FetchAdd(1, MemOrder::Relaxed);
+		return m_mallocator.Allocate<u8>(size, align, isBacking);
+	}
+
+	void DeallocateRaw(MemRef<u8>&& mem) noexcept override
+	{
+		UNUSED(mem);
+	}
+
+private:
+	Alloc::Mallocator m_mallocator;
+	Atomic<u64>       m_numAllocs{ 0 };
+};
+
+auto GetInputBenchAlloc() -> CountingAllocator&
+{
+	static CountingAllocator alloc;
+	SetGlobalAlloc(alloc);
+	return alloc;
+}
+
+// Number of global allocations made by a full input tick, temporaries of the tick live in the input manager's frame allocator
+auto InputManagerTickBench(benchmark::State& state) -> void
+{
+	CountingAllocator& alloc = GetInputBenchAlloc();
+	Input::InputManager manager;
+	const Chrono::DeltaTime dt{ 1.f / 60.f };
+
+	const u64 startAllocs = alloc.GetNumAllocs();
+	for (auto _ : state)
+	{
+		manager.Tick(dt);
+		manager.PreTick();
+	}
+	state.counters["GlobalAllocs"] = benchmark::Counter(f64(alloc.GetNumAllocs() - startAllocs), benchmark::Counter::kAvgIterations);
+
+	manager.Shutdown();
+}
+BENCHMARK(InputManagerTickBench);
+
+// Temporaries like the ones created during a tick, i.e. a device list and a set of encountered keys, allocated globally or from frame memory
+template<bool UseFrameAlloc>
+auto TickTemporariesBench(benchmark::State& state) -> void
+{
+	CountingAllocator& alloc = GetInputBenchAlloc();
+	Alloc::FrameAllocator frameAlloc{ &alloc, 16_KiB };
+
+	const u64 startAllocs = alloc.GetNumAllocs();
+	for (auto _ : state)
+	{
+		frameAlloc.NextFrame();
+		Alloc::IAllocator& tempAlloc = UseFrameAlloc ? static_cast<Alloc::IAllocator&>(frameAlloc) : alloc;
+		ScopedGlobalAlloc scope{ tempAlloc };
+
+		DynArray<u64> devs;
+		devs.Resize(usize(state.range(0)));
+		benchmark::DoNotOptimize(devs.Data());
+
+		HashSet<u32> encounteredKeys;
+		for (u32 i = 0; i < u32(state.range(0)) * 4; ++i)
+			encounteredKeys.Insert(i * 7);
+		benchmark::DoNotOptimize(encounteredKeys);
+	}
+	state.counters["GlobalAllocs"] = benchmark::Counter(f64(alloc.GetNumAllocs() - startAllocs), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_TEMPLATE(TickTemporariesBench, false)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(TickTemporariesBench, true)->Arg(8)->Arg(32);
+
+// Global allocations made by rebuilding the mappings of a user, which happens when mapping contexts or control schemes change
+// Every binding has a trigger and a modifier, which are stored inline in the built mappings
+auto RebuildMappingsBench(benchmark::State& state) -> void
+{
+	CountingAllocator& alloc = GetInputBenchAlloc();
+
+	Rc<Input::MappingContext> context = Rc<Input::MappingContext>::Create();
+	for (i64 i = 0; i < state.range(0); ++i)
+	{
+		Input::ActionMapping mapping;
+		mapping.SetAction(Rc<Input::InputAction>::Create(Format("Action{}"_s, i), Input::ValueType::Digital));
+
+		Input::ControlBinding binding;
+		binding.SetBinding(Unique<Input::KeyBinding>::Create(Input::Key{ Format("Keyboard/Key{}"_s, i) }));
+		binding.AddTrigger(Unique<Input::PressedTrigger>::Create());
+		binding.AddModifier(Unique<Input::NegateModifier>::Create());
+		mapping.AddControlBinding(Move(binding));
+		context->AddInputMapping(mapping);
+	}
+
+	Input::User user;
+	user.AddMappingContext(context);
+
+	const u64 startAllocs = alloc.GetNumAllocs();
+	for (auto _ : state)
+	{
+		user.SetNeedToRebuildMappings(true);
+		user.RebuildMappings();
+		benchmark::DoNotOptimize(user.GetMappings().Data());
+	}
+	state.counters["GlobalAllocs"] = benchmark::Counter(f64(alloc.GetNumAllocs() - startAllocs), benchmark::Counter::kAvgIterations);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RebuildMappingsBench)->Arg(16)->Arg(128);
+
+#endif
@@ -0,0 +1,71 @@
+#include "Config.h"
+
+#if BENCH_NUMA
+#include "core/Core.h"
+
+using namespace Onca;
+
+// Set to a number larger than 1 to run the benchmark with a fake topology on a single node machine
+constexpr u32 NumFakeNodes = 0;
+constexpr usize BufferSize = 256_MiB;
+
+auto GetNumaBenchTopology() -> const NumaTopology&
+{
+	static NumaTopology topology = NumFakeNodes > 1 ? NumaTopology::CreateFake(NumFakeNodes) : NumaTopology::FromSystem();
+	return topology;
+}
+
+auto GetNumaBenchRegistry() -> Alloc::NumaAllocRegistry&
+{
+	static Alloc::NumaAllocRegistry registry{ GetNumaBenchTopology(), 1_GiB };
+	return registry;
+}
+
+// Streams over a buffer placed on the node of the thread, or on the next node, to measure local vs remote memory bandwidth
+template<bool Local>
+auto NumaBandwidthBench(benchmark::State& state) -> void
+{
+	const NumaTopology& topology = GetNumaBenchTopology();
+	Alloc::NumaAllocRegistry& registry = GetNumaBenchRegistry();
+
+	const u32 node = u32(state.thread_index()) % topology.GetNumNodes();
+	const u32 memNode = Local ? node : (node + 1) % topology.GetNumNodes();
+
+	Threading::Thread thread = Threading::Thread::FromCurrent();
+	if (!topology.GetNode(node).cpuSetIds.IsEmpty())
+		thread.SetCpuSetAffinity(topology.GetNode(node).cpuSetIds);
+
+	// Pages are bound to the node when they are committed, so touching them from this thread does not move them
+	MemRef<u64> buffer = registry.GetPageAlloc(memNode).Allocate<u64>(BufferSize);
+	const usize count = BufferSize / sizeof(u64);
+	u64* pData = buffer.Ptr();
+	for (usize i = 0; i < count; ++i)
+		pData[i] = i;
+
+	for (auto _ : state)
+	{
+		u64 sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+		for (usize i = 0; i < count; i += 4)
+		{
+			sum0 += pData[i];
+			sum1 += pData[i + 1];
+			sum2 += pData[i + 2];
+			sum3 += pData[i + 3];
+		}
+		benchmark::DoNotOptimize(sum0 + sum1 + sum2 + sum3);
+	}
+	state.SetBytesProcessed(state.iterations() * BufferSize);
+
+	registry.GetPageAlloc(memNode).Deallocate(Move(buffer));
+	thread.ResetAffinity();
+}
+BENCHMARK_TEMPLATE(NumaBandwidthBench, true)
+	->ThreadRange(1, 16)
+	->UseRealTime()
+	->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(NumaBandwidthBench, false)
+	->ThreadRange(1, 16)
+	->UseRealTime()
+	->Unit(benchmark::kMillisecond);
+
+#endif
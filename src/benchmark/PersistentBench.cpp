@@ -0,0 +1,231 @@
+#include "Config.h"
+
+#if BENCH_PERSISTENT
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_PERSISTENT_VECTOR 1
+#define BENCH_PERSISTENT_MAP 1
+
+namespace
+{
+	// Every iteration hands a consistent snapshot of the state to a reader, then applies a batch of modifications
+	constexpr u32 ModificationsPerSnapshot = 16;
+
+	auto NextIndex(u32& rng, u32 count) -> u32
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		return rng % count;
+	}
+}
+
+#if BENCH_PERSISTENT_VECTOR
+
+// How snapshots are currently made: the reader gets a deep copy
+auto DynArrayCopyMutate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	DynArray<u32> arr{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		arr.Add(i);
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+	{
+		DynArray<u32> snapshot{ arr };
+		benchmark::DoNotOptimize(snapshot.Data());
+		for (u32 i = 0; i < ModificationsPerSnapshot; ++i)
+			arr[NextIndex(rng, count)] = i;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(DynArrayCopyMutate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+auto PVectorSnapshotMutate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	TransientPVector<u32> builder{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		builder.PushBack(i);
+	PVector<u32> vec = builder.Persistent();
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+	{
+		PVector<u32> snapshot{ vec };
+		benchmark::DoNotOptimize(&snapshot);
+		for (u32 i = 0; i < ModificationsPerSnapshot; ++i)
+			vec = vec.Set(NextIndex(rng, count), i);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(PVectorSnapshotMutate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+auto PVectorSnapshotMutateTransient(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	TransientPVector<u32> builder{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		builder.PushBack(i);
+	PVector<u32> vec = builder.Persistent();
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+	{
+		PVector<u32> snapshot{ vec };
+		benchmark::DoNotOptimize(&snapshot);
+		TransientPVector<u32> transient = vec.AsTransient();
+		for (u32 i = 0; i < ModificationsPerSnapshot; ++i)
+			transient.Set(NextIndex(rng, count), i);
+		vec = transient.Persistent();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(PVectorSnapshotMutateTransient)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+// Reads pay for the trie, compare a full iteration
+auto DynArrayIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<u32> arr{ mallocator };
+	for (u32 i = 0; i < u32(state.range(0)); ++i)
+		arr.Add(i);
+
+	for (auto _ : state)
+	{
+		u32 sum = 0;
+		for (u32 val : arr)
+			sum += val;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(DynArrayIterate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+auto PVectorIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	TransientPVector<u32> builder{ mallocator };
+	for (u32 i = 0; i < u32(state.range(0)); ++i)
+		builder.PushBack(i);
+	const PVector<u32> vec = builder.Persistent();
+
+	for (auto _ : state)
+	{
+		u32 sum = 0;
+		for (u32 val : vec)
+			sum += val;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(PVectorIterate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+#endif
+
+#if BENCH_PERSISTENT_MAP
+
+auto HashMapCopyMutate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	HashMap<u32, u32> map{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		map.Insert(i, i);
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+	{
+		HashMap<u32, u32> snapshot{ map };
+		benchmark::DoNotOptimize(&snapshot);
+		for (u32 i = 0; i < ModificationsPerSnapshot; ++i)
+			map.Find(NextIndex(rng, count))->second = i;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(HashMapCopyMutate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+auto PHashMapSnapshotMutate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	TransientPHashMap<u32, u32> builder{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		builder.Insert(i, i);
+	PHashMap<u32, u32> map = builder.Persistent();
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+	{
+		PHashMap<u32, u32> snapshot{ map };
+		benchmark::DoNotOptimize(&snapshot);
+		for (u32 i = 0; i < ModificationsPerSnapshot; ++i)
+			map = map.Insert(NextIndex(rng, count), i);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(PHashMapSnapshotMutate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+auto PHashMapSnapshotMutateTransient(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	TransientPHashMap<u32, u32> builder{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		builder.Insert(i, i);
+	PHashMap<u32, u32> map = builder.Persistent();
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+	{
+		PHashMap<u32, u32> snapshot{ map };
+		benchmark::DoNotOptimize(&snapshot);
+		TransientPHashMap<u32, u32> transient = map.AsTransient();
+		for (u32 i = 0; i < ModificationsPerSnapshot; ++i)
+			transient.Insert(NextIndex(rng, count), i);
+		map = transient.Persistent();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(PHashMapSnapshotMutateTransient)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+auto HashMapFind(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	HashMap<u32, u32> map{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		map.Insert(i, i);
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(map.Find(NextIndex(rng, count)));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(HashMapFind)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+auto PHashMapFind(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const u32 count = u32(state.range(0));
+	TransientPHashMap<u32, u32> builder{ mallocator };
+	for (u32 i = 0; i < count; ++i)
+		builder.Insert(i, i);
+	const PHashMap<u32, u32> map = builder.Persistent();
+
+	u32 rng = 0x12345678;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(map.Find(NextIndex(rng, count)));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(PHashMapFind)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+#endif
+
+#endif
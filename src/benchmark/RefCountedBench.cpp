@@ -0,0 +1,91 @@
+#include "Config.h"
+
+#if BENCH_REFCOUNTED
+#include "core/Core.h"
+
+using namespace Onca;
+
+// Payload roughly the size of a small input object
+struct RcPayload
+{
+	u64 values[4];
+};
+
+struct IntrusivePayload : RcObject
+{
+	u64 values[4];
+};
+
+struct AtomicIntrusivePayload : ArcObject
+{
+	u64 values[4];
+};
+
+auto GetRcBenchAlloc() -> Alloc::Mallocator&
+{
+	static Alloc::Mallocator mallocator;
+	SetGlobalAlloc(mallocator);
+	return mallocator;
+}
+
+template<typename P>
+auto RcCreateBench(benchmark::State& state) -> void
+{
+	Alloc::Mallocator& alloc = GetRcBenchAlloc();
+	for (auto _ : state)
+	{
+		P ptr = P::CreateWithAlloc(alloc);
+		benchmark::DoNotOptimize(ptr);
+	}
+}
+BENCHMARK_TEMPLATE(RcCreateBench, Rc<RcPayload>);
+BENCHMARK_TEMPLATE(RcCreateBench, CompactRc<RcPayload>);
+BENCHMARK_TEMPLATE(RcCreateBench, IntrusiveRc<IntrusivePayload>);
+BENCHMARK_TEMPLATE(RcCreateBench, Arc<RcPayload>);
+BENCHMARK_TEMPLATE(RcCreateBench, CompactArc<RcPayload>);
+BENCHMARK_TEMPLATE(RcCreateBench, IntrusiveArc<AtomicIntrusivePayload>);
+
+// Copy a handle into an array and destroy all copies, like handing out shared objects to many users
+template<typename P>
+auto RcCopyDestroyBench(benchmark::State& state) -> void
+{
+	P ptr = P::CreateWithAlloc(GetRcBenchAlloc());
+	DynArray<P> copies(usize(state.range(0)));
+	for (auto _ : state)
+	{
+		for (i64 i = 0; i < state.range(0); ++i)
+			copies.Add(ptr);
+		copies.Clear();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(RcCopyDestroyBench, Rc<RcPayload>)->Arg(1024);
+BENCHMARK_TEMPLATE(RcCopyDestroyBench, CompactRc<RcPayload>)->Arg(1024);
+BENCHMARK_TEMPLATE(RcCopyDestroyBench, IntrusiveRc<IntrusivePayload>)->Arg(1024);
+BENCHMARK_TEMPLATE(RcCopyDestroyBench, Arc<RcPayload>)->Arg(1024);
+BENCHMARK_TEMPLATE(RcCopyDestroyBench, CompactArc<RcPayload>)->Arg(1024);
+BENCHMARK_TEMPLATE(RcCopyDestroyBench, IntrusiveArc<AtomicIntrusivePayload>)->Arg(1024);
+
+// Dereference many distinct handles, this mostly measures how many handles fit in a cache line
+template<typename P>
+auto RcDerefBench(benchmark::State& state) -> void
+{
+	Alloc::Mallocator& alloc = GetRcBenchAlloc();
+	DynArray<P> ptrs(usize(state.range(0)));
+	for (i64 i = 0; i < state.range(0); ++i)
+		ptrs.Add(P::CreateWithAlloc(alloc));
+
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (P& ptr : ptrs)
+			sum += ptr->values[0];
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(RcDerefBench, Rc<RcPayload>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(RcDerefBench, CompactRc<RcPayload>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(RcDerefBench, IntrusiveRc<IntrusivePayload>)->Arg(1 << 16);
+
+#endif
@@ -0,0 +1,275 @@
+#include "Config.h"
+
+#if BENCH_SERIALIZE
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_SERIALIZE_SCHEMA 1
+#define BENCH_SERIALIZE_VARINT 1
+#define BENCH_SERIALIZE_ARRAY 1
+
+struct BenchTransform
+{
+	f32 pos[3];
+	f32 rot[4];
+	f32 scale;
+	u32 flags;
+};
+
+struct BenchRecord
+{
+	u32            id;
+	u64            count;
+	BenchTransform transform;
+	String         name;
+};
+
+template<>
+struct Onca::SerializeSchema<BenchTransform>
+{
+	static constexpr auto Fields = SchemaFields(&BenchTransform::pos, &BenchTransform::rot, &BenchTransform::scale, &BenchTransform::flags);
+};
+
+template<>
+struct Onca::SerializeSchema<BenchRecord>
+{
+	static constexpr auto Fields = SchemaFields(&BenchRecord::id, AsVarInt(&BenchRecord::count), &BenchRecord::transform, &BenchRecord::name);
+};
+
+#if BENCH_SERIALIZE_SCHEMA
+
+auto MakeTransforms(usize count, Alloc::IAllocator& alloc) -> DynArray<BenchTransform>
+{
+	DynArray<BenchTransform> transforms{ alloc };
+	transforms.Reserve(count);
+	for (usize i = 0; i < count; ++i)
+	{
+		const f32 val = f32(i);
+		transforms.Add(BenchTransform{ { val, val + 1, val + 2 }, { 0, 0, 0, 1 }, 1.f, u32(i) });
+	}
+	return transforms;
+}
+
+// Baseline: write each field with ByteBuffer::Write
+auto ByteBufferWriteTransforms(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<BenchTransform> transforms = MakeTransforms(usize(state.range(0)), mallocator);
+	ByteBuffer buffer{ mallocator };
+	for (auto _ : state)
+	{
+		buffer.Seek(0);
+		for (const BenchTransform& transform : transforms)
+		{
+			for (f32 val : transform.pos)
+				buffer.Write(val);
+			for (f32 val : transform.rot)
+				buffer.Write(val);
+			buffer.Write(transform.scale);
+			buffer.Write(transform.flags);
+		}
+		benchmark::DoNotOptimize(buffer.Data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(BenchTransform));
+}
+BENCHMARK(ByteBufferWriteTransforms)->RangeMultiplier(8)->Range(64, 32768);
+
+template<ByteOrder Order>
+auto SchemaSerializeTransforms(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<BenchTransform> transforms = MakeTransforms(usize(state.range(0)), mallocator);
+	DynArray<u8> data{ mallocator };
+	for (auto _ : state)
+	{
+		data.Clear();
+		Serializer serializer{ data, Order };
+		for (const BenchTransform& transform : transforms)
+			serializer.Serialize(transform);
+		serializer.Finish();
+		benchmark::DoNotOptimize(data.Data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(BenchTransform));
+}
+BENCHMARK_TEMPLATE(SchemaSerializeTransforms, ByteOrder::Native)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(SchemaSerializeTransforms, ByteOrder::Big)->RangeMultiplier(8)->Range(64, 32768);
+
+// Baseline: read each field with ByteBuffer::Read
+auto ByteBufferReadTransforms(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<BenchTransform> transforms = MakeTransforms(usize(state.range(0)), mallocator);
+	ByteBuffer buffer{ reinterpret_cast<const u8*>(transforms.Data()), transforms.Size() * sizeof(BenchTransform) };
+	DynArray<BenchTransform> read{ transforms.Size(), BenchTransform{}, mallocator };
+	for (auto _ : state)
+	{
+		buffer.Seek(0);
+		for (BenchTransform& transform : read)
+		{
+			for (f32& val : transform.pos)
+				val = buffer.Read<f32>();
+			for (f32& val : transform.rot)
+				val = buffer.Read<f32>();
+			transform.scale = buffer.Read<f32>();
+			transform.flags = buffer.Read<u32>();
+		}
+		benchmark::DoNotOptimize(read.Data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(BenchTransform));
+}
+BENCHMARK(ByteBufferReadTransforms)->RangeMultiplier(8)->Range(64, 32768);
+
+template<ByteOrder Order>
+auto SchemaDeserializeTransforms(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<BenchTransform> transforms = MakeTransforms(usize(state.range(0)), mallocator);
+	DynArray<u8> data{ mallocator };
+	{
+		Serializer serializer{ data, Order };
+		for (const BenchTransform& transform : transforms)
+			serializer.Serialize(transform);
+	}
+
+	DynArray<BenchTransform> read{ transforms.Size(), BenchTransform{}, mallocator };
+	for (auto _ : state)
+	{
+		Deserializer deserializer{ data, Order };
+		for (BenchTransform& transform : read)
+			deserializer.Deserialize(transform);
+		benchmark::DoNotOptimize(read.Data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(BenchTransform));
+}
+BENCHMARK_TEMPLATE(SchemaDeserializeTransforms, ByteOrder::Native)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(SchemaDeserializeTransforms, ByteOrder::Big)->RangeMultiplier(8)->Range(64, 32768);
+
+auto SchemaRoundtripRecords(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<BenchRecord> records{ mallocator };
+	DynArray<BenchTransform> transforms = MakeTransforms(usize(state.range(0)), mallocator);
+	for (i64 i = 0; i < state.range(0); ++i)
+		records.Add(BenchRecord{ u32(i), u64(i * 3), transforms[usize(i)], String{ "record_name", mallocator } });
+
+	DynArray<u8> data{ mallocator };
+	for (auto _ : state)
+	{
+		data.Clear();
+		{
+			Serializer serializer{ data };
+			serializer.Serialize(records);
+		}
+
+		Deserializer deserializer{ data };
+		DynArray<BenchRecord> read{ mallocator };
+		deserializer.Deserialize(read);
+		benchmark::DoNotOptimize(read.Data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SchemaRoundtripRecords)->RangeMultiplier(8)->Range(64, 32768);
+
+#endif
+
+#if BENCH_SERIALIZE_VARINT
+
+auto VarIntEncode(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<u64> vals{ mallocator };
+	u64 rng = 0x9E37'79B9'7F4A'7C15;
+	for (i64 i = 0; i < state.range(0); ++i)
+	{
+		rng ^= rng << 13;
+		rng ^= rng >> 7;
+		rng ^= rng << 17;
+		// Mix of value sizes, mostly small
+		vals.Add(rng >> (rng & 63));
+	}
+
+	DynArray<u8> data{ mallocator };
+	for (auto _ : state)
+	{
+		data.Clear();
+		Serializer serializer{ data };
+		for (u64 val : vals)
+			serializer.WriteVarUInt(val);
+		serializer.Finish();
+		benchmark::DoNotOptimize(data.Data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(VarIntEncode)->RangeMultiplier(8)->Range(64, 32768);
+
+auto VarIntDecode(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<u8> data{ mallocator };
+	u64 rng = 0x9E37'79B9'7F4A'7C15;
+	{
+		Serializer serializer{ data };
+		for (i64 i = 0; i < state.range(0); ++i)
+		{
+			rng ^= rng << 13;
+			rng ^= rng >> 7;
+			rng ^= rng << 17;
+			serializer.WriteVarUInt(rng >> (rng & 63));
+		}
+	}
+
+	for (auto _ : state)
+	{
+		Deserializer deserializer{ data };
+		u64 sum = 0;
+		for (i64 i = 0; i < state.range(0); ++i)
+			sum += deserializer.ReadVarUInt();
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(VarIntDecode)->RangeMultiplier(8)->Range(64, 32768);
+
+#endif
+
+#if BENCH_SERIALIZE_ARRAY
+
+auto ByteBufferWriteArray(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<f32> vals{ usize(state.range(0)), 1.f, mallocator };
+	ByteBuffer buffer{ mallocator };
+	for (auto _ : state)
+	{
+		buffer.Seek(0);
+		for (f32 val : vals)
+			buffer.Write(val);
+		benchmark::DoNotOptimize(buffer.Data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(f32));
+}
+BENCHMARK(ByteBufferWriteArray)->RangeMultiplier(8)->Range(512, 262144);
+
+template<ByteOrder Order>
+auto SerializerWriteArray(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	DynArray<f32> vals{ usize(state.range(0)), 1.f, mallocator };
+	DynArray<u8> data{ mallocator };
+	for (auto _ : state)
+	{
+		data.Clear();
+		Serializer serializer{ data, Order };
+		serializer.Serialize(vals);
+		serializer.Finish();
+		benchmark::DoNotOptimize(data.Data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(f32));
+}
+BENCHMARK_TEMPLATE(SerializerWriteArray, ByteOrder::Native)->RangeMultiplier(8)->Range(512, 262144);
+BENCHMARK_TEMPLATE(SerializerWriteArray, ByteOrder::Big)->RangeMultiplier(8)->Range(512, 262144);
+
+#endif
+
+#endif
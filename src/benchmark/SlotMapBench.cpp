@@ -0,0 +1,332 @@
+#include "Config.h"
+
+#if BENCH_SLOTMAP
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_SLOTMAP_INSERT 1
+#define BENCH_SLOTMAP_LOOKUP 1
+#define BENCH_SLOTMAP_CHURN 1
+#define BENCH_SLOTMAP_ITERATE 1
+
+namespace
+{
+	// Element of a registry, roughly the size of the entries stored by the input and windowing registries
+	struct RegistryEntry
+	{
+		u64 data[4];
+		bool valid;
+	};
+
+	// Registry storing entries by index, with invalid entries as holes, like the registries before they used a SlotMap
+	class HoleRegistry
+	{
+	public:
+		explicit HoleRegistry(Alloc::IAllocator& alloc)
+			: m_entries(alloc)
+		{}
+
+		auto Insert(u64 val) -> u32
+		{
+			u32 id = 0;
+			for (; id < m_entries.Size(); ++id)
+			{
+				if (!m_entries[id].valid)
+					break;
+			}
+
+			RegistryEntry entry{ { val, val, val, val }, true };
+			if (id == m_entries.Size())
+				m_entries.Add(entry);
+			else
+				m_entries[id] = entry;
+			return id;
+		}
+
+		void Erase(u32 id) { m_entries[id].valid = false; }
+
+		auto Get(u32 id) -> RegistryEntry*
+		{
+			if (id >= m_entries.Size() || !m_entries[id].valid)
+				return nullptr;
+			return &m_entries[id];
+		}
+
+		auto GetEntries() -> DynArray<RegistryEntry>& { return m_entries; }
+
+	private:
+		DynArray<RegistryEntry> m_entries;
+	};
+
+	auto MakeEntry(u64 val) -> RegistryEntry
+	{
+		return RegistryEntry{ { val, val, val, val }, true };
+	}
+
+	// Shuffled ids 0..count-1, so lookups and erasures don't walk memory in order
+	auto ShuffledIds(u32 count, Alloc::IAllocator& alloc) -> DynArray<u32>
+	{
+		DynArray<u32> ids{ alloc };
+		for (u32 i = 0; i < count; ++i)
+			ids.Add(i);
+
+		u32 rng = 0x12345678;
+		for (u32 i = count; i > 1; --i)
+		{
+			rng ^= rng << 13;
+			rng ^= rng >> 17;
+			rng ^= rng << 5;
+			const u32 j = rng % i;
+			const u32 tmp = ids[i - 1];
+			ids[i - 1] = ids[j];
+			ids[j] = tmp;
+		}
+		return ids;
+	}
+}
+
+#if BENCH_SLOTMAP_INSERT
+
+auto SlotMapInsert(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		SlotMap<RegistryEntry> map{ mallocator };
+		for (i64 i = 0; i < state.range(0); ++i)
+			benchmark::DoNotOptimize(map.Insert(MakeEntry(u64(i))));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SlotMapInsert)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HashMapInsert(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		HashMap<u32, RegistryEntry> map{ mallocator };
+		for (i64 i = 0; i < state.range(0); ++i)
+			benchmark::DoNotOptimize(map.Insert(u32(i), MakeEntry(u64(i))).second);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapInsert)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HoleRegistryInsert(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	for (auto _ : state)
+	{
+		HoleRegistry registry{ mallocator };
+		for (i64 i = 0; i < state.range(0); ++i)
+			benchmark::DoNotOptimize(registry.Insert(u64(i)));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HoleRegistryInsert)->RangeMultiplier(8)->Range(64, 4096);
+
+#endif
+
+#if BENCH_SLOTMAP_LOOKUP
+
+auto SlotMapLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<RegistryEntry> map{ mallocator };
+	DynArray<u32> handles{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		handles.Add(map.Insert(MakeEntry(u64(i))));
+
+	DynArray<u32> order = ShuffledIds(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 idx : order)
+			benchmark::DoNotOptimize(map.Get(handles[idx]));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SlotMapLookup)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HashMapLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HashMap<u32, RegistryEntry> map{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		map.Insert(u32(i), MakeEntry(u64(i)));
+
+	DynArray<u32> order = ShuffledIds(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 id : order)
+			benchmark::DoNotOptimize(map.Find(id));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapLookup)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HoleRegistryLookup(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HoleRegistry registry{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		registry.Insert(u64(i));
+
+	DynArray<u32> order = ShuffledIds(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 id : order)
+			benchmark::DoNotOptimize(registry.Get(id));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HoleRegistryLookup)->RangeMultiplier(8)->Range(64, 32768);
+
+#endif
+
+#if BENCH_SLOTMAP_CHURN
+
+// Erase and re-insert a random element, with the container full, like devices and windows being added and removed
+auto SlotMapChurn(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<RegistryEntry> map{ mallocator };
+	DynArray<u32> handles{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		handles.Add(map.Insert(MakeEntry(u64(i))));
+
+	DynArray<u32> order = ShuffledIds(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 idx : order)
+		{
+			map.Erase(handles[idx]);
+			handles[idx] = map.Insert(MakeEntry(idx));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SlotMapChurn)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HashMapChurn(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HashMap<u32, RegistryEntry> map{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		map.Insert(u32(i), MakeEntry(u64(i)));
+
+	DynArray<u32> order = ShuffledIds(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 id : order)
+		{
+			map.Erase(id);
+			map.Insert(id, MakeEntry(id));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapChurn)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HoleRegistryChurn(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HoleRegistry registry{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		registry.Insert(u64(i));
+
+	DynArray<u32> order = ShuffledIds(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		for (u32 id : order)
+		{
+			registry.Erase(id);
+			benchmark::DoNotOptimize(registry.Insert(id));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HoleRegistryChurn)->RangeMultiplier(8)->Range(64, 4096);
+
+#endif
+
+#if BENCH_SLOTMAP_ITERATE
+
+// Iterate a container where half of the elements were erased
+auto SlotMapIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<RegistryEntry> map{ mallocator };
+	DynArray<u32> handles{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		handles.Add(map.Insert(MakeEntry(u64(i))));
+	for (u32 idx : ShuffledIds(u32(state.range(0)), mallocator))
+	{
+		if (idx & 1)
+			map.Erase(handles[idx]);
+	}
+
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (const RegistryEntry& entry : map)
+			sum += entry.data[0];
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SlotMapIterate)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HashMapIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HashMap<u32, RegistryEntry> map{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		map.Insert(u32(i), MakeEntry(u64(i)));
+	for (u32 id : ShuffledIds(u32(state.range(0)), mallocator))
+	{
+		if (id & 1)
+			map.Erase(id);
+	}
+
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (const Pair<const u32, RegistryEntry>& pair : map)
+			sum += pair.second.data[0];
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HashMapIterate)->RangeMultiplier(8)->Range(64, 32768);
+
+auto HoleRegistryIterate(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	HoleRegistry registry{ mallocator };
+	for (i64 i = 0; i < state.range(0); ++i)
+		registry.Insert(u64(i));
+	for (u32 id : ShuffledIds(u32(state.range(0)), mallocator))
+	{
+		if (id & 1)
+			registry.Erase(id);
+	}
+
+	for (auto _ : state)
+	{
+		u64 sum = 0;
+		for (const RegistryEntry& entry : registry.GetEntries())
+		{
+			if (entry.valid)
+				sum += entry.data[0];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(HoleRegistryIterate)->RangeMultiplier(8)->Range(64, 32768);
+
+#endif
+
+#endif
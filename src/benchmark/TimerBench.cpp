@@ -0,0 +1,228 @@
+#include "Config.h"
+
+#if BENCH_TIMER
+#include "core/Core.h"
+
+using namespace Onca;
+
+#define BENCH_TIMER_FIRE 1
+#define BENCH_TIMER_CANCEL 1
+
+namespace
+{
+	// Timers are in 1ms ticks, the simulation advances in frames of 16 ticks
+	constexpr u64 TicksPerFrame = 16;
+	constexpr u32 MaxDelayTicks = 10000;
+
+	struct TimerEntry
+	{
+		u64 expireTick;
+		u32 id;
+	};
+
+	struct TimerEntryComparator
+	{
+		auto operator()(const TimerEntry& a, const TimerEntry& b) const noexcept -> i8
+		{
+			return a.expireTick < b.expireTick ? -1 : a.expireTick > b.expireTick ? 1 : 0;
+		}
+	};
+
+	auto RandomDelays(u32 count, Alloc::IAllocator& alloc) -> DynArray<u32>
+	{
+		DynArray<u32> delays{ alloc };
+		delays.Reserve(count);
+
+		u32 rng = 0x12345678;
+		for (u32 i = 0; i < count; ++i)
+		{
+			rng ^= rng << 13;
+			rng ^= rng >> 17;
+			rng ^= rng << 5;
+			delays.Add(rng % MaxDelayTicks + 1);
+		}
+		return delays;
+	}
+}
+
+#if BENCH_TIMER_FIRE
+
+auto TimerWheelFire(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<u32> delays = RandomDelays(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		TimerWheel<u32> wheel{ 0.001f, mallocator };
+		wheel.Reserve(delays.Size());
+		for (u32 i = 0; i < delays.Size(); ++i)
+			wheel.ScheduleTicks(delays[i], u32(i));
+
+		u32 numFired = 0;
+		while (!wheel.IsEmpty())
+			wheel.AdvanceTicks(TicksPerFrame, [&numFired](u32&) { ++numFired; });
+		benchmark::DoNotOptimize(numFired);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(TimerWheelFire)->RangeMultiplier(8)->Range(1024, 1 << 20);
+
+auto PriorityQueueFire(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<u32> delays = RandomDelays(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		PriorityQueue<TimerEntry, TimerEntryComparator> queue{ mallocator };
+		queue.Reserve(delays.Size());
+		for (u32 i = 0; i < delays.Size(); ++i)
+			queue.Push(TimerEntry{ delays[i], i });
+
+		u64 curTick = 0;
+		u32 numFired = 0;
+		while (!queue.IsEmpty())
+		{
+			curTick += TicksPerFrame;
+			while (!queue.IsEmpty() && queue.Top().expireTick <= curTick)
+			{
+				queue.Pop();
+				++numFired;
+			}
+		}
+		benchmark::DoNotOptimize(numFired);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(PriorityQueueFire)->RangeMultiplier(8)->Range(1024, 1 << 20);
+
+auto PairingHeapFire(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<u32> delays = RandomDelays(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		PairingHeap<TimerEntry, TimerEntryComparator> heap{ mallocator };
+		heap.Reserve(delays.Size());
+		for (u32 i = 0; i < delays.Size(); ++i)
+			heap.Push(TimerEntry{ delays[i], i });
+
+		u64 curTick = 0;
+		u32 numFired = 0;
+		while (!heap.IsEmpty())
+		{
+			curTick += TicksPerFrame;
+			while (!heap.IsEmpty() && heap.Top().expireTick <= curTick)
+			{
+				heap.Pop();
+				++numFired;
+			}
+		}
+		benchmark::DoNotOptimize(numFired);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(PairingHeapFire)->RangeMultiplier(8)->Range(1024, 1 << 20);
+
+// How timeouts are currently handled: every pending timer is checked each frame
+auto LinearScanFire(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<u32> delays = RandomDelays(u32(state.range(0)), mallocator);
+	for (auto _ : state)
+	{
+		DynArray<TimerEntry> timers{ mallocator };
+		timers.Reserve(delays.Size());
+		for (u32 i = 0; i < delays.Size(); ++i)
+			timers.Add(TimerEntry{ delays[i], i });
+
+		u64 curTick = 0;
+		u32 numFired = 0;
+		while (!timers.IsEmpty())
+		{
+			curTick += TicksPerFrame;
+			for (usize i = 0; i < timers.Size();)
+			{
+				if (timers[i].expireTick <= curTick)
+				{
+					timers[i] = timers.Back();
+					timers.Pop();
+					++numFired;
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+		benchmark::DoNotOptimize(numFired);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(LinearScanFire)->RangeMultiplier(8)->Range(1024, 1 << 16);
+
+#endif
+
+#if BENCH_TIMER_CANCEL
+
+// Most timeouts never fire, they are cancelled when the operation they guard completes
+
+auto TimerWheelCancel(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<u32> delays = RandomDelays(u32(state.range(0)), mallocator);
+	DynArray<TimerWheel<u32>::Handle> handles{ mallocator };
+	handles.Resize(delays.Size());
+	for (auto _ : state)
+	{
+		TimerWheel<u32> wheel{ 0.001f, mallocator };
+		wheel.Reserve(delays.Size());
+		for (u32 i = 0; i < delays.Size(); ++i)
+			handles[i] = wheel.ScheduleTicks(delays[i], u32(i));
+		for (TimerWheel<u32>::Handle handle : handles)
+			benchmark::DoNotOptimize(wheel.Cancel(handle));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(TimerWheelCancel)->RangeMultiplier(8)->Range(1024, 1 << 20);
+
+auto PriorityQueueCancel(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<u32> delays = RandomDelays(u32(state.range(0)), mallocator);
+	DynArray<PriorityQueue<TimerEntry, TimerEntryComparator>::Handle> handles{ mallocator };
+	handles.Resize(delays.Size());
+	for (auto _ : state)
+	{
+		PriorityQueue<TimerEntry, TimerEntryComparator> queue{ mallocator };
+		queue.Reserve(delays.Size());
+		for (u32 i = 0; i < delays.Size(); ++i)
+			handles[i] = queue.Push(TimerEntry{ delays[i], i });
+		for (PriorityQueue<TimerEntry, TimerEntryComparator>::Handle handle : handles)
+			benchmark::DoNotOptimize(queue.Erase(handle));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(PriorityQueueCancel)->RangeMultiplier(8)->Range(1024, 1 << 20);
+
+auto PairingHeapCancel(benchmark::State& state) -> void
+{
+	Alloc::Mallocator mallocator;
+	const DynArray<u32> delays = RandomDelays(u32(state.range(0)), mallocator);
+	DynArray<PairingHeap<TimerEntry, TimerEntryComparator>::Handle> handles{ mallocator };
+	handles.Resize(delays.Size());
+	for (auto _ : state)
+	{
+		PairingHeap<TimerEntry, TimerEntryComparator> heap{ mallocator };
+		heap.Reserve(delays.Size());
+		for (u32 i = 0; i < delays.Size(); ++i)
+			handles[i] = heap.Push(TimerEntry{ delays[i], i });
+		for (PairingHeap<TimerEntry, TimerEntryComparator>::Handle handle : handles)
+			benchmark::DoNotOptimize(heap.Erase(handle));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(PairingHeapCancel)->RangeMultiplier(8)->Range(1024, 1 << 20);
+
+#endif
+
+#endif
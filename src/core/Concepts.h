@@ -82,6 +82,11 @@ namespace Onca
 		PrimitiveType<T> ||
 		TriviallyCopyable<T>;
 
+	template<typename T>
+	concept TriviallyRelocatable =
+		MemCopyable<T> ||
+		IsTriviallyRelocatable<T>;
+
 	template<typename T, typename... Args>
 	concept ConstructableFrom = std::constructible_from<T, Args...>;
 
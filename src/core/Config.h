@@ -25,6 +25,7 @@
 #define ENABLE_SLOW_ASSERT 0
 #define ENABLE_MATH_ASSERT 0
 #define ENABLE_ALLOC_STATS 0
+#define ENABLE_ALLOC_TRACKING 0
 
 #elif PROFILE_
 
@@ -35,6 +36,7 @@
 #define ENABLE_SLOW_ASSERT 0
 #define ENABLE_MATH_ASSERT 0
 #define ENABLE_ALLOC_STATS 1
+#define ENABLE_ALLOC_TRACKING 1
 
 #else
 
@@ -46,6 +48,7 @@
 #define ENABLE_SLOW_ASSERT 1
 #define ENABLE_MATH_ASSERT 1
 #define ENABLE_ALLOC_STATS 1
+#define ENABLE_ALLOC_TRACKING 1
 
 #endif
 
@@ -25,13 +25,17 @@
 
 #include "memory/MemUtils.h"
 #include "memory/MemRef.h"
+#include "memory/CompactMemRef.h"
 #include "memory/Unique.h"
 #include "memory/RefCounted.h"
+#include "memory/CompactRefCounted.h"
 
 #include "platform/SystemInfo.h"
+#include "platform/NumaTopology.h"
 #include "threading/Threading.h"
 
 #include "allocator/IAllocator.h"
+#include "allocator/ContainerAlloc.h"
 #include "allocator/primitives/Mallocator.h"
 #include "allocator/primitives/LinearAllocator.h"
 #include "allocator/primitives/StackAllocator.h"
@@ -39,9 +43,15 @@
 #include "allocator/primitives/BitmapAllocator.h"
 #include "allocator/primitives/BuddyAllocator.h"
 #include "allocator/primitives/FreeListAllocator.h"
+#include "allocator/primitives/VirtualArena.h"
+#include "allocator/primitives/SlabAllocator.h"
+#include "allocator/primitives/NumaAllocator.h"
 #include "allocator/composable/ExpandableArena.h"
+#include "allocator/composable/FrameAllocator.h"
 #include "allocator/composable/FallbackArena.h"
 #include "allocator/composable/SegregatorArena.h"
+#include "allocator/composable/NumaAllocRegistry.h"
+#include "allocator/composable/TrackingAllocator.h"
 
 #include "containers/Containers.h"
 
@@ -56,9 +66,12 @@
 #include "platform/Process.h"
 #include "platform/DynLib.h"
 #include "logging/Logger.h"
+#include "allocator/AllocTracker.h"
 #include "misc/CmdLine.h"
 
 #include "windowing/WindowManager.h"
 #include "input/InputManager.h"
 
-#include "parsers/Parsers.h"
\ No newline at end of file
+#include "parsers/Parsers.h"
+
+#include "serialization/Serialization.h"
\ No newline at end of file
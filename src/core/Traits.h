@@ -121,6 +121,14 @@ namespace Onca
 	template<typename T>
 	constexpr bool IteratorHasContiguousData = IsPointer<T>;
 
+	/**
+	 * Can a type be relocated using a memcpy, i.e. moving it to a new address and ending the lifetime of the original is equivalent to copying its bytes
+	 * \tparam T Type to check
+	 * \note This should be overloaded for types that are not trivially copyable, but don't store pointers into themselves, like most containers
+	 */
+	template<typename T>
+	constexpr bool IsTriviallyRelocatable = std::is_trivially_copyable_v<T>;
+
 	/**
 	 * Removes the reference from a type
 	 * \tparam T Type to remove reference from
@@ -0,0 +1,771 @@
+#include "AllocTracker.h"
+#include "core/filesystem/File.h"
+#include "core/logging/Logger.h"
+#include "core/platform/Debugger.h"
+
+namespace Onca::Alloc
+{
+	namespace Detail
+	{
+		/**
+		 * Allocation event written to a thread's buffer
+		 */
+		struct AllocTrackerEvent
+		{
+			u64                   seq;       ///< Global sequence number, used to order events of different threads
+			usize                 addr;      ///< Address of the allocation
+			usize                 srcAddr;   ///< Previous address of a moved allocation
+			usize                 size;      ///< Size of the allocation
+			const char*           pTag;      ///< Tag
+			u32                   stackHash; ///< Call stack hash
+			AllocTrackerEventKind kind;      ///< Kind of event
+		};
+
+		/**
+		 * Single producer, single consumer ring buffer with the events of a thread
+		 */
+		struct AllocTrackerBuffer
+		{
+			static constexpr u32 Capacity = 4096;
+
+			alignas(64) Atomic<u32> head;    ///< Index of the next event to write, only written by the owning thread
+			alignas(64) Atomic<u32> tail;    ///< Index of the next event to drain, only written while the tracker is locked
+			Atomic<bool>            isOwned; ///< Whether a thread owns the buffer
+			AllocTrackerBuffer*     pNext;   ///< Next buffer
+			AllocTrackerEvent       events[Capacity];
+		};
+
+		/**
+		 * Allocation tracking state of a thread
+		 */
+		struct AllocTrackerThreadState
+		{
+			u32                 depth            = 0;       ///< Depth of nested allocator calls, only the outermost call is recorded
+			const char*         pTag             = nullptr; ///< Tag of the innermost tag scope
+			const char*         pCallTag         = nullptr; ///< Tag set by a TrackingAllocator during the current call
+			AllocTrackerBuffer* pBuffer          = nullptr; ///< Buffer owned by the thread, kept alive until the thread releases it, even when its tracker is destroyed
+			u64                 bufferGeneration = 0;       ///< Generation of the tracker the buffer belongs to
+
+			~AllocTrackerThreadState() noexcept
+			{
+				if (pBuffer)
+					pBuffer->isOwned.Store(false, MemOrder::Release);
+			}
+		};
+
+		/**
+		 * Buffers shared by all trackers
+		 *
+		 * A tracker that is destroyed while a thread still owns one of its buffers retires the buffer instead of freeing it,
+		 * the next tracker acquiring a buffer adopts it once the thread released it.
+		 */
+		struct AllocTrackerBufferPool
+		{
+			Threading::Mutex    mutex;              ///< Mutex guarding the retired buffers
+			Mallocator          mallocator;         ///< Allocator used for the buffers
+			AllocTrackerBuffer* pRetired = nullptr; ///< Retired buffers
+		};
+
+		Atomic<AllocTracker*> g_pActiveAllocTracker{ nullptr };
+		Atomic<u64>           g_allocTrackerGeneration{ 0 };
+
+		auto GetAllocTrackerThreadState() noexcept -> AllocTrackerThreadState&
+		{
+			thread_local AllocTrackerThreadState t_state;
+			return t_state;
+		}
+
+		auto GetAllocTrackerBufferPool() noexcept -> AllocTrackerBufferPool&
+		{
+			static AllocTrackerBufferPool s_pool;
+			return s_pool;
+		}
+
+		void FreeAllocTrackerBuffer(AllocTrackerBufferPool& pool, AllocTrackerBuffer* pBuffer) noexcept
+		{
+			pool.mallocator.Deallocate(MemRef<AllocTrackerBuffer>{ pBuffer, &pool.mallocator, Math::Log2(64), sizeof(AllocTrackerBuffer), false });
+		}
+
+		/**
+		 * RAII scope preventing allocations made by the tracker itself from being recorded
+		 */
+		struct AllocTrackerSelfScope
+		{
+			AllocTrackerSelfScope() noexcept
+				: state(GetAllocTrackerThreadState())
+			{
+				++state.depth;
+			}
+
+			~AllocTrackerSelfScope() noexcept
+			{
+				--state.depth;
+			}
+
+			AllocTrackerThreadState& state;
+		};
+
+		template<typename T>
+		void WriteSnapshotValue(ByteBuffer& buffer, const T& val) noexcept
+		{
+			buffer.Write(val);
+		}
+
+#if ENABLE_ALLOC_TRACKING
+		auto AllocTrackingHooks::Allocate(IAllocator& alloc, usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+		{
+			AllocTracker* pTracker = g_pActiveAllocTracker.Load(MemOrder::Acquire);
+			if (!pTracker) LIKELY
+				return alloc.AllocateRaw(size, align, isBacking);
+
+			AllocTrackerThreadState& state = GetAllocTrackerThreadState();
+			if (state.depth)
+				return alloc.AllocateRaw(size, align, isBacking);
+
+			++state.depth;
+			state.pCallTag = nullptr;
+			MemRef<u8> mem = alloc.AllocateRaw(size, align, isBacking);
+			if (mem)
+				pTracker->Record(state, AllocTrackerEventKind::Alloc, usize(mem.Ptr()), mem.Size());
+			--state.depth;
+			return mem;
+		}
+
+		void AllocTrackingHooks::Deallocate(IAllocator& alloc, MemRef<u8>&& mem) noexcept
+		{
+			AllocTracker* pTracker = g_pActiveAllocTracker.Load(MemOrder::Acquire);
+			if (!pTracker) LIKELY
+				return alloc.DeallocateRaw(Move(mem));
+
+			AllocTrackerThreadState& state = GetAllocTrackerThreadState();
+			if (state.depth)
+				return alloc.DeallocateRaw(Move(mem));
+
+			// The deallocation is recorded before the memory is released, so it is always ordered before another thread can receive the same address
+			++state.depth;
+			if (mem)
+				pTracker->Record(state, AllocTrackerEventKind::Dealloc, usize(mem.Ptr()), mem.Size());
+			alloc.DeallocateRaw(Move(mem));
+			--state.depth;
+		}
+
+		auto AllocTrackingHooks::TryExpandInPlace(IAllocator& alloc, const MemRef<u8>& mem, usize newSize) noexcept -> bool
+		{
+			AllocTracker* pTracker = g_pActiveAllocTracker.Load(MemOrder::Acquire);
+			if (!pTracker) LIKELY
+				return alloc.TryExpandInPlaceRaw(mem, newSize);
+
+			AllocTrackerThreadState& state = GetAllocTrackerThreadState();
+			if (state.depth)
+				return alloc.TryExpandInPlaceRaw(mem, newSize);
+
+			++state.depth;
+			const bool expanded = alloc.TryExpandInPlaceRaw(mem, newSize);
+			if (expanded)
+				pTracker->Record(state, AllocTrackerEventKind::Resize, usize(mem.Ptr()), newSize);
+			--state.depth;
+			return expanded;
+		}
+
+		auto AllocTrackingHooks::Reallocate(IAllocator& alloc, MemRef<u8>& mem, usize newSize) noexcept -> bool
+		{
+			AllocTracker* pTracker = g_pActiveAllocTracker.Load(MemOrder::Acquire);
+			if (!pTracker) LIKELY
+				return alloc.ReallocateRaw(mem, newSize);
+
+			AllocTrackerThreadState& state = GetAllocTrackerThreadState();
+			if (state.depth)
+				return alloc.ReallocateRaw(mem, newSize);
+
+			// The sequence number is taken before the old memory can be released, so the move is ordered before another thread can receive the old address,
+			// the move is only recorded when the reallocation succeeded
+			++state.depth;
+			const usize srcAddr = usize(mem.Ptr());
+			const u64 seq = pTracker->m_seq.FetchAdd(1, MemOrder::Relaxed);
+			const bool reallocated = alloc.ReallocateRaw(mem, newSize);
+			if (reallocated)
+				pTracker->RecordMove(state, seq, srcAddr, usize(mem.Ptr()), mem.Size());
+			--state.depth;
+			return reallocated;
+		}
+#endif
+	}
+
+	ScopedAllocTag::ScopedAllocTag(const char* pTag) noexcept
+	{
+		Detail::AllocTrackerThreadState& state = Detail::GetAllocTrackerThreadState();
+		m_pPrev = state.pTag;
+		state.pTag = pTag;
+	}
+
+	ScopedAllocTag::~ScopedAllocTag() noexcept
+	{
+		Detail::GetAllocTrackerThreadState().pTag = m_pPrev;
+	}
+
+	const char* const AllocTracker::DefaultTag = "Untagged";
+
+	AllocTracker::AllocTracker() noexcept
+		: m_generation(Detail::g_allocTrackerGeneration.FetchAdd(1, MemOrder::Relaxed) + 1)
+		, m_pBuffers(nullptr)
+		, m_seq(0)
+		, m_flush(0)
+		, m_live(m_mallocator)
+		, m_tags(m_mallocator)
+		, m_orphans(m_mallocator)
+	{
+		// Create the buffer pool before the tracker, so it is destroyed after static trackers
+		Detail::GetAllocTrackerBufferPool();
+	}
+
+	AllocTracker::~AllocTracker() noexcept
+	{
+		AllocTracker* pThis = this;
+		Detail::g_pActiveAllocTracker.CompareExchangeStrong(pThis, nullptr);
+
+		Detail::AllocTrackerSelfScope scope;
+		Detail::AllocTrackerThreadState& state = scope.state;
+		if (state.bufferGeneration == m_generation)
+		{
+			state.pBuffer->isOwned.Store(false, MemOrder::Release);
+			state.pBuffer = nullptr;
+			state.bufferGeneration = 0;
+		}
+
+		Detail::AllocTrackerBufferPool& pool = Detail::GetAllocTrackerBufferPool();
+		Threading::Lock lock{ pool.mutex };
+
+		// Free the retired buffers that were released since, only buffers released by their thread can be freed
+		Detail::AllocTrackerBuffer** ppRetired = &pool.pRetired;
+		while (Detail::AllocTrackerBuffer* pBuffer = *ppRetired)
+		{
+			if (pBuffer->isOwned.Load(MemOrder::Acquire))
+			{
+				ppRetired = &pBuffer->pNext;
+				continue;
+			}
+			*ppRetired = pBuffer->pNext;
+			Detail::FreeAllocTrackerBuffer(pool, pBuffer);
+		}
+
+		// Buffers still owned by other threads are retired, as those threads keep referencing them until they exit or record events for another tracker
+		Detail::AllocTrackerBuffer* pBuffer = m_pBuffers.Load(MemOrder::Acquire);
+		while (pBuffer)
+		{
+			Detail::AllocTrackerBuffer* pNext = pBuffer->pNext;
+			if (pBuffer->isOwned.Load(MemOrder::Acquire))
+			{
+				pBuffer->pNext = pool.pRetired;
+				pool.pRetired = pBuffer;
+			}
+			else
+			{
+				Detail::FreeAllocTrackerBuffer(pool, pBuffer);
+			}
+			pBuffer = pNext;
+		}
+	}
+
+	void AllocTracker::Start(const AllocTrackerOptions& options) noexcept
+	{
+		Detail::AllocTrackerSelfScope scope;
+		Threading::Lock lock{ m_mutex };
+
+		// Drop any events left over from a previous run
+		for (Detail::AllocTrackerBuffer* pBuffer = m_pBuffers.Load(MemOrder::Acquire); pBuffer; pBuffer = pBuffer->pNext)
+			pBuffer->tail.Store(pBuffer->head.Load(MemOrder::Acquire), MemOrder::Release);
+
+		m_options = options;
+		m_options.stackDepth = Math::Min(m_options.stackDepth, Debugger::MaxStackHashDepth);
+		m_live.Clear();
+		m_tags.Clear();
+		m_orphans.Clear();
+
+		AllocTracker* pExpected = nullptr;
+		const bool started = Detail::g_pActiveAllocTracker.CompareExchangeStrong(pExpected, this);
+		ASSERT(started || pExpected == this, "Only a single allocation tracker can be active at a time");
+		UNUSED(started);
+	}
+
+	auto AllocTracker::Stop() noexcept -> usize
+	{
+		AllocTracker* pThis = this;
+		Detail::g_pActiveAllocTracker.CompareExchangeStrong(pThis, nullptr);
+
+		Detail::AllocTrackerSelfScope scope;
+		Threading::Lock lock{ m_mutex };
+		FlushLocked();
+
+		const usize numLeaks = m_live.Size();
+		if (numLeaks)
+		{
+			usize leakedBytes = 0;
+			for (const Pair<usize, AllocTagStats>& pair : m_tags)
+				leakedBytes += pair.second.liveBytes;
+
+			g_Logger.Warning(LogCategories::CORE, "Allocation tracker detected {} leaked allocations, {} bytes in total"_s, numLeaks, leakedBytes);
+			for (const Pair<usize, AllocTagStats>& pair : m_tags)
+			{
+				const AllocTagStats& stats = pair.second;
+				if (stats.liveAllocs)
+					g_Logger.Append("  {}: {} bytes in {} allocations"_s, stats.pTag, stats.liveBytes, stats.liveAllocs);
+			}
+		}
+		return numLeaks;
+	}
+
+	auto AllocTracker::IsActive() const noexcept -> bool
+	{
+		return Detail::g_pActiveAllocTracker.Load(MemOrder::Relaxed) == this;
+	}
+
+	void AllocTracker::Flush() noexcept
+	{
+		Detail::AllocTrackerSelfScope scope;
+		Threading::Lock lock{ m_mutex };
+		FlushLocked();
+	}
+
+	auto AllocTracker::GetTagStats() noexcept -> DynArray<AllocTagStats>
+	{
+		Detail::AllocTrackerSelfScope scope;
+		Threading::Lock lock{ m_mutex };
+		FlushLocked();
+
+		DynArray<AllocTagStats> stats;
+		stats.Reserve(m_tags.Size());
+		for (const Pair<usize, AllocTagStats>& pair : m_tags)
+		{
+			// Insertion sort, as there are only a handful of tags
+			usize idx = stats.Size();
+			stats.Add(pair.second);
+			for (; idx > 0 && stats[idx - 1].liveBytes < pair.second.liveBytes; --idx)
+				stats[idx] = stats[idx - 1];
+			stats[idx] = pair.second;
+		}
+		return stats;
+	}
+
+	auto AllocTracker::GetLiveAllocations() noexcept -> DynArray<AllocRecord>
+	{
+		Detail::AllocTrackerSelfScope scope;
+		Threading::Lock lock{ m_mutex };
+		FlushLocked();
+
+		DynArray<AllocRecord> records;
+		records.Reserve(m_live.Size());
+		for (const Pair<usize, LiveAlloc>& pair : m_live)
+			records.Add(AllocRecord{ pair.first, pair.second.size, pair.second.pTag, pair.second.stackHash });
+		return records;
+	}
+
+	auto AllocTracker::GetSummary() noexcept -> String
+	{
+		Detail::AllocTrackerSelfScope scope;
+		Threading::Lock lock{ m_mutex };
+		FlushLocked();
+		return GetSummaryLocked();
+	}
+
+	auto AllocTracker::WriteSnapshot(const FileSystem::Path& path) noexcept -> SystemError
+	{
+		Detail::AllocTrackerSelfScope scope;
+		ByteBuffer buffer{ m_mallocator };
+		{
+			Threading::Lock lock{ m_mutex };
+			FlushLocked();
+
+			HashMap<usize, u32> tagIndices{ m_tags.Size(), m_mallocator };
+			usize tagBytes = 0;
+			for (const Pair<usize, AllocTagStats>& pair : m_tags)
+				tagBytes += sizeof(u32) + StrLen(pair.second.pTag) + 5 * sizeof(u64);
+			buffer.Reserve(2 * sizeof(u32) + 2 * sizeof(u64) + tagBytes + m_live.Size() * (2 * sizeof(u64) + 2 * sizeof(u32)));
+
+			Detail::WriteSnapshotValue(buffer, SnapshotMagic);
+			Detail::WriteSnapshotValue(buffer, SnapshotVersion);
+			Detail::WriteSnapshotValue(buffer, u16(sizeof(void*)));
+			Detail::WriteSnapshotValue(buffer, u64(m_tags.Size()));
+			Detail::WriteSnapshotValue(buffer, u64(m_live.Size()));
+
+			for (const Pair<usize, AllocTagStats>& pair : m_tags)
+			{
+				const AllocTagStats& stats = pair.second;
+				tagIndices.Insert(pair.first, u32(tagIndices.Size()));
+
+				const u32 nameLen = u32(StrLen(stats.pTag));
+				Detail::WriteSnapshotValue(buffer, nameLen);
+				for (u32 i = 0; i < nameLen; ++i)
+					Detail::WriteSnapshotValue(buffer, u8(stats.pTag[i]));
+				Detail::WriteSnapshotValue(buffer, u64(stats.liveBytes));
+				Detail::WriteSnapshotValue(buffer, u64(stats.liveAllocs));
+				Detail::WriteSnapshotValue(buffer, u64(stats.peakBytes));
+				Detail::WriteSnapshotValue(buffer, u64(stats.totalBytes));
+				Detail::WriteSnapshotValue(buffer, u64(stats.totalAllocs));
+			}
+
+			for (const Pair<usize, LiveAlloc>& pair : m_live)
+			{
+				Detail::WriteSnapshotValue(buffer, u64(pair.first));
+				Detail::WriteSnapshotValue(buffer, u64(pair.second.size));
+				Detail::WriteSnapshotValue(buffer, *tagIndices.At(usize(pair.second.pTag)));
+				Detail::WriteSnapshotValue(buffer, pair.second.stackHash);
+			}
+		}
+
+		auto res = FileSystem::File::Create(path, FileSystem::FileCreateKind::CreateAlways, FileSystem::AccessMode::Write);
+		if (!res.Success())
+			return res.Error();
+		return res.MoveValue().Write(buffer);
+	}
+
+	auto AllocTracker::WriteSummary(const FileSystem::Path& path) noexcept -> SystemError
+	{
+		Detail::AllocTrackerSelfScope scope;
+		String summary;
+		{
+			Threading::Lock lock{ m_mutex };
+			FlushLocked();
+			summary = GetSummaryLocked();
+		}
+
+		auto res = FileSystem::File::Create(path, FileSystem::FileCreateKind::CreateAlways, FileSystem::AccessMode::Write);
+		if (!res.Success())
+			return res.Error();
+		return res.MoveValue().Write(ByteBuffer{ summary.Data(), summary.DataSize() });
+	}
+
+	auto AllocTracker::GetCurrentTag() noexcept -> const char*
+	{
+		const char* pTag = Detail::GetAllocTrackerThreadState().pTag;
+		return pTag ? pTag : DefaultTag;
+	}
+
+	void AllocTracker::Record(Detail::AllocTrackerThreadState& state, Detail::AllocTrackerEventKind kind, usize addr, usize size) noexcept
+	{
+		Detail::AllocTrackerEvent* pEvent = GetNextEvent(state);
+		if (!pEvent) UNLIKELY
+			return;
+
+		const char* pTag = nullptr;
+		u32 stackHash = 0;
+		if (kind == Detail::AllocTrackerEventKind::Alloc)
+		{
+			pTag = state.pCallTag ? state.pCallTag : state.pTag ? state.pTag : DefaultTag;
+			if (m_options.stackDepth)
+				stackHash = Debugger::CaptureStackHash(m_options.stackSkip, m_options.stackDepth);
+		}
+
+		Detail::AllocTrackerEvent& event = *pEvent;
+		event.seq = m_seq.FetchAdd(1, MemOrder::Relaxed);
+		event.addr = addr;
+		event.srcAddr = 0;
+		event.size = size;
+		event.pTag = pTag;
+		event.stackHash = stackHash;
+		event.kind = kind;
+		state.pBuffer->head.Store(state.pBuffer->head.Load(MemOrder::Relaxed) + 1, MemOrder::Release);
+	}
+
+	void AllocTracker::RecordMove(Detail::AllocTrackerThreadState& state, u64 seq, usize srcAddr, usize addr, usize size) noexcept
+	{
+		Detail::AllocTrackerEvent* pEvent = GetNextEvent(state);
+		if (!pEvent) UNLIKELY
+			return;
+
+		// The tag and call stack are taken from the allocation when the event is applied
+		Detail::AllocTrackerEvent& event = *pEvent;
+		event.seq = seq;
+		event.addr = addr;
+		event.srcAddr = srcAddr;
+		event.size = size;
+		event.pTag = nullptr;
+		event.stackHash = 0;
+		event.kind = Detail::AllocTrackerEventKind::Move;
+		state.pBuffer->head.Store(state.pBuffer->head.Load(MemOrder::Relaxed) + 1, MemOrder::Release);
+	}
+
+	auto AllocTracker::GetNextEvent(Detail::AllocTrackerThreadState& state) noexcept -> Detail::AllocTrackerEvent*
+	{
+		Detail::AllocTrackerBuffer* pBuffer = state.pBuffer;
+		if (state.bufferGeneration != m_generation) UNLIKELY
+		{
+			// The buffer belongs to another tracker, which keeps it alive until it is released here, even when that tracker was destroyed
+			if (pBuffer)
+				pBuffer->isOwned.Store(false, MemOrder::Release);
+			state.pBuffer = nullptr;
+			state.bufferGeneration = 0;
+
+			pBuffer = AcquireBuffer();
+			if (!pBuffer)
+				return nullptr;
+			state.pBuffer = pBuffer;
+			state.bufferGeneration = m_generation;
+		}
+
+		const u32 head = pBuffer->head.Load(MemOrder::Relaxed);
+		if (head - pBuffer->tail.Load(MemOrder::Acquire) == Detail::AllocTrackerBuffer::Capacity) UNLIKELY
+			Flush();
+		return &pBuffer->events[head % Detail::AllocTrackerBuffer::Capacity];
+	}
+
+	auto AllocTracker::AcquireBuffer() noexcept -> Detail::AllocTrackerBuffer*
+	{
+		Detail::AllocTrackerBuffer* pBuffer = m_pBuffers.Load(MemOrder::Acquire);
+		for (; pBuffer; pBuffer = pBuffer->pNext)
+		{
+			bool expected = false;
+			if (pBuffer->isOwned.CompareExchangeStrong(expected, true))
+				return pBuffer;
+		}
+
+		// Adopt a buffer retired by a destroyed tracker, once its thread released it
+		Detail::AllocTrackerBufferPool& pool = Detail::GetAllocTrackerBufferPool();
+		{
+			Threading::Lock lock{ pool.mutex };
+			for (Detail::AllocTrackerBuffer** ppRetired = &pool.pRetired; *ppRetired; ppRetired = &(*ppRetired)->pNext)
+			{
+				bool expected = false;
+				if ((*ppRetired)->isOwned.CompareExchangeStrong(expected, true))
+				{
+					pBuffer = *ppRetired;
+					*ppRetired = pBuffer->pNext;
+					break;
+				}
+			}
+		}
+
+		if (!pBuffer)
+		{
+			MemRef<Detail::AllocTrackerBuffer> mem = pool.mallocator.Allocate<Detail::AllocTrackerBuffer>(sizeof(Detail::AllocTrackerBuffer), 64);
+			if (!mem) UNLIKELY
+				return nullptr;
+			pBuffer = mem.Ptr();
+		}
+
+		pBuffer->head.Store(0, MemOrder::Relaxed);
+		pBuffer->tail.Store(0, MemOrder::Relaxed);
+		pBuffer->isOwned.Store(true, MemOrder::Relaxed);
+		pBuffer->pNext = m_pBuffers.Load(MemOrder::Relaxed);
+		while (!m_pBuffers.CompareExchangeWeak(pBuffer->pNext, pBuffer))
+			;
+		return pBuffer;
+	}
+
+	void AllocTracker::SetCallTag(const char* pTag) noexcept
+	{
+		Detail::GetAllocTrackerThreadState().pCallTag = pTag;
+	}
+
+	void AllocTracker::FlushLocked() noexcept
+	{
+		const u64 flush = ++m_flush;
+
+		for (Detail::AllocTrackerBuffer* pBuffer = m_pBuffers.Load(MemOrder::Acquire); pBuffer; pBuffer = pBuffer->pNext)
+		{
+			const u32 head = pBuffer->head.Load(MemOrder::Acquire);
+			u32 tail = pBuffer->tail.Load(MemOrder::Relaxed);
+			for (; tail != head; ++tail)
+				Apply(pBuffer->events[tail % Detail::AllocTrackerBuffer::Capacity]);
+			pBuffer->tail.Store(tail, MemOrder::Release);
+		}
+
+		// A deallocation that stays unmatched for a full flush belongs to memory that was allocated before tracking started
+		m_orphans.EraseIf([flush](usize, const OrphanDealloc& orphan) { return orphan.flush < flush; });
+	}
+
+	void AllocTracker::Apply(const Detail::AllocTrackerEvent& event) noexcept
+	{
+		// Events of different threads are drained in an arbitrary order, the sequence numbers are used to resolve allocations,
+		// deallocations and resizes of the same address that were drained out of order
+		switch (event.kind)
+		{
+		case Detail::AllocTrackerEventKind::Alloc:
+		{
+			auto orphanIt = m_orphans.Find(event.addr);
+			if (orphanIt != m_orphans.End() && orphanIt->second.seq > event.seq)
+			{
+				m_orphans.Erase(orphanIt);
+				AddToTag(event.pTag, event.size);
+				RemoveFromTag(event.pTag, event.size);
+				return;
+			}
+
+			auto liveIt = m_live.Find(event.addr);
+			if (liveIt != m_live.End())
+			{
+				LiveAlloc& live = liveIt->second;
+				// An older allocation of an address that has been reused since, its deallocation will be ignored when it is drained
+				if (live.seq > event.seq)
+				{
+					AddToTag(event.pTag, event.size);
+					RemoveFromTag(event.pTag, event.size);
+					return;
+				}
+
+				// The address was reused before the deallocation of the previous allocation was drained
+				RemoveFromTag(live.pTag, live.size);
+				live = LiveAlloc{ event.seq, event.size, event.pTag, event.stackHash };
+				AddToTag(event.pTag, event.size);
+				return;
+			}
+
+			m_live.Insert(event.addr, LiveAlloc{ event.seq, event.size, event.pTag, event.stackHash });
+			AddToTag(event.pTag, event.size);
+			break;
+		}
+		case Detail::AllocTrackerEventKind::Dealloc:
+		{
+			auto liveIt = m_live.Find(event.addr);
+			if (liveIt == m_live.End())
+			{
+				m_orphans.Insert(event.addr, OrphanDealloc{ event.seq, m_flush });
+				return;
+			}
+
+			if (liveIt->second.seq < event.seq)
+			{
+				RemoveFromTag(liveIt->second.pTag, liveIt->second.size);
+				m_live.Erase(liveIt);
+			}
+			break;
+		}
+		case Detail::AllocTrackerEventKind::Move:
+		{
+			auto liveIt = m_live.Find(event.srcAddr);
+			if (liveIt == m_live.End())
+			{
+				// The allocation was not drained yet, or was made before tracking started, either way the memory at the new address is not tracked
+				m_orphans.Insert(event.srcAddr, OrphanDealloc{ event.seq, m_flush });
+				return;
+			}
+			if (liveIt->second.seq > event.seq)
+				return;
+
+			// Applied as a deallocation followed by an allocation with the same tag and call stack, which resolves a reuse of the new address
+			Detail::AllocTrackerEvent alloc = event;
+			alloc.pTag = liveIt->second.pTag;
+			alloc.stackHash = liveIt->second.stackHash;
+			alloc.kind = Detail::AllocTrackerEventKind::Alloc;
+			RemoveFromTag(liveIt->second.pTag, liveIt->second.size);
+			m_live.Erase(liveIt);
+			Apply(alloc);
+			break;
+		}
+		case Detail::AllocTrackerEventKind::Resize:
+		{
+			auto liveIt = m_live.Find(event.addr);
+			if (liveIt == m_live.End() || liveIt->second.seq > event.seq)
+				return;
+
+			LiveAlloc& live = liveIt->second;
+			AllocTagStats& stats = m_tags.Find(usize(live.pTag))->second;
+			stats.liveBytes = stats.liveBytes - live.size + event.size;
+			if (event.size > live.size)
+				stats.totalBytes += event.size - live.size;
+			stats.peakBytes = Math::Max(stats.peakBytes, stats.liveBytes);
+			live.size = event.size;
+			live.seq = event.seq;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void AllocTracker::AddToTag(const char* pTag, usize size) noexcept
+	{
+		auto it = m_tags.Find(usize(pTag));
+		if (it == m_tags.End())
+			it = m_tags.Insert(usize(pTag), AllocTagStats{ pTag, 0, 0, 0, 0, 0 }).first;
+
+		AllocTagStats& stats = it->second;
+		stats.liveBytes += size;
+		++stats.liveAllocs;
+		stats.totalBytes += size;
+		++stats.totalAllocs;
+		stats.peakBytes = Math::Max(stats.peakBytes, stats.liveBytes);
+	}
+
+	void AllocTracker::RemoveFromTag(const char* pTag, usize size) noexcept
+	{
+		AllocTagStats& stats = m_tags.Find(usize(pTag))->second;
+		stats.liveBytes -= size;
+		--stats.liveAllocs;
+	}
+
+	auto AllocTracker::GetSummaryLocked() noexcept -> String
+	{
+		usize liveBytes = 0;
+		usize liveAllocs = 0;
+		for (const Pair<usize, AllocTagStats>& pair : m_tags)
+		{
+			liveBytes += pair.second.liveBytes;
+			liveAllocs += pair.second.liveAllocs;
+		}
+
+		String summary = Format("Allocation tracker summary: {} live bytes in {} allocations\n"_s, liveBytes, liveAllocs);
+		summary.Add("\nTags:\n"_s);
+		for (const Pair<usize, AllocTagStats>& pair : m_tags)
+		{
+			const AllocTagStats& stats = pair.second;
+			summary.Add(Format("  {}: {} live bytes in {} allocations, peak {} bytes, {} bytes in {} allocations in total\n"_s,
+				stats.pTag, stats.liveBytes, stats.liveAllocs, stats.peakBytes, stats.totalBytes, stats.totalAllocs));
+		}
+
+		if (m_options.stackDepth)
+		{
+			/**
+			 * Live memory allocated from the same call stack
+			 */
+			struct StackStats
+			{
+				u32         hash;   ///< Call stack hash
+				const char* pTag;   ///< Tag of the first allocation found for the call stack
+				usize       bytes;  ///< Live bytes
+				usize       allocs; ///< Live allocations
+			};
+
+			HashMap<u32, usize> stackIndices{ m_mallocator };
+			DynArray<StackStats> stacks{ m_mallocator };
+			for (const Pair<usize, LiveAlloc>& pair : m_live)
+			{
+				const LiveAlloc& live = pair.second;
+				auto it = stackIndices.Find(live.stackHash);
+				if (it == stackIndices.End())
+				{
+					it = stackIndices.Insert(live.stackHash, stacks.Size()).first;
+					stacks.Add(StackStats{ live.stackHash, live.pTag, 0, 0 });
+				}
+
+				StackStats& stack = stacks[it->second];
+				stack.bytes += live.size;
+				++stack.allocs;
+			}
+
+			constexpr usize MaxSummaryStacks = 16;
+			const usize numStacks = Math::Min(stacks.Size(), MaxSummaryStacks);
+			summary.Add(Format("\nTop {} call stacks:\n"_s, numStacks));
+			for (usize i = 0; i < numStacks; ++i)
+			{
+				// Partial selection sort, only the top of the list is needed
+				usize maxIdx = i;
+				for (usize j = i + 1; j < stacks.Size(); ++j)
+				{
+					if (stacks[j].bytes > stacks[maxIdx].bytes)
+						maxIdx = j;
+				}
+				Algo::Swap(stacks[i], stacks[maxIdx]);
+
+				const StackStats& stack = stacks[i];
+				summary.Add(Format("  {:X} ({}): {} live bytes in {} allocations\n"_s, stack.hash, stack.pTag, stack.bytes, stack.allocs));
+			}
+		}
+		return summary;
+	}
+
+	auto GetAllocTracker() noexcept -> AllocTracker&
+	{
+		static AllocTracker s_tracker;
+		return s_tracker;
+	}
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/primitives/Mallocator.h"
+#include "core/containers/HashMap.h"
+#include "core/filesystem/Path.h"
+#include "core/platform/SystemError.h"
+#include "core/threading/Sync.h"
+#include "core/utils/Atomic.h"
+
+namespace Onca::Alloc
+{
+	namespace Detail
+	{
+		struct AllocTrackerThreadState;
+		struct AllocTrackerBuffer;
+		struct AllocTrackerEvent;
+
+		/**
+		 * Kind of an allocation event
+		 */
+		enum class AllocTrackerEventKind : u32
+		{
+			Alloc,   ///< Memory was allocated
+			Dealloc, ///< Memory was deallocated
+			Resize,  ///< Memory was resized in place
+			Move,    ///< Memory was moved to a new address by a reallocation, keeping its tag and call stack
+		};
+	}
+
+	/**
+	 * Options for the allocation tracker
+	 */
+	struct AllocTrackerOptions
+	{
+		u32 stackDepth = 0; ///< Number of call stack frames hashed for each allocation, 0 to only attribute allocations to tags (up to Debugger::MaxStackHashDepth)
+		u32 stackSkip  = 2; ///< Number of frames at the top of the call stack to skip, so the hash starts at the caller of the allocator
+	};
+
+	/**
+	 * Aggregated statistics of all allocations with the same tag
+	 */
+	struct AllocTagStats
+	{
+		const char* pTag;        ///< Tag
+		usize       liveBytes;   ///< Bytes currently allocated
+		usize       liveAllocs;  ///< Number of live allocations
+		usize       peakBytes;   ///< Maximum number of live bytes
+		usize       totalBytes;  ///< Total bytes allocated since tracking started
+		usize       totalAllocs; ///< Total number of allocations since tracking started
+	};
+
+	/**
+	 * Live allocation known to the tracker
+	 */
+	struct AllocRecord
+	{
+		usize       addr;      ///< Address of the allocation
+		usize       size;      ///< Size of the allocation
+		const char* pTag;      ///< Tag the allocation is attributed to
+		u32         stackHash; ///< Hash of the call stack of the allocation, 0 when stacks are not captured
+	};
+
+	/**
+	 * RAII scope attributing all allocations made by the current thread to a tag
+	 *
+	 * Scopes can be nested, the previous tag is restored when the scope ends.
+	 * Use ALLOC_TAG_SCOPE to create a scope, so no code is generated when allocation tracking is disabled.
+	 *
+	 * \note Tags are identified by their address and need to outlive the tracker, which makes string literals the preferred tags
+	 */
+	class CORE_API ScopedAllocTag
+	{
+	public:
+		/**
+		 * Attribute allocations made by the current thread to a tag
+		 * \param[in] pTag Tag
+		 */
+		explicit ScopedAllocTag(const char* pTag) noexcept;
+		~ScopedAllocTag() noexcept;
+
+		DISABLE_COPY(ScopedAllocTag);
+		DISABLE_MOVE(ScopedAllocTag);
+
+	private:
+		const char* m_pPrev; ///< Previous tag
+	};
+
+	/**
+	 * \brief Allocation tracker, attributing live memory to call site tags and detecting leaks (threadsafe)
+	 *
+	 * While the tracker is running, every allocation and deallocation going through IAllocator is recorded with the current tag of the thread,
+	 * and optionally a hash of the call stack. Nested calls inside composable allocators are not recorded, so each allocation is recorded once,
+	 * attributed to the tag of a TrackingAllocator when one is involved in the allocation.
+	 *
+	 * Events are written to a per-thread ring buffer without taking any locks, the buffers are drained into the aggregated state when the tracker is flushed,
+	 * or when a buffer is full, in which case the thread owning it flushes the tracker.
+	 * Memory allocated before the tracker started is not tracked, deallocating it is ignored.
+	 *
+	 * \note Allocations are only recorded when ENABLE_ALLOC_TRACKING is enabled, otherwise the tracker never receives any events
+	 * \note Only a single tracker can run at a time, and it needs to be stopped before it is destroyed while other threads are allocating
+	 */
+	class CORE_API AllocTracker
+	{
+	public:
+		AllocTracker() noexcept;
+		~AllocTracker() noexcept;
+
+		DISABLE_COPY(AllocTracker);
+		DISABLE_MOVE(AllocTracker);
+
+		/**
+		 * Start tracking allocations, clearing all data of a previous run
+		 * \param[in] options Options
+		 */
+		void Start(const AllocTrackerOptions& options = {}) noexcept;
+		/**
+		 * Stop tracking allocations and report all allocations that are still alive as leaks
+		 * \return Number of leaked allocations
+		 * \note Call this at shutdown, after all systems released their memory, the aggregated data is kept until the tracker is started again
+		 */
+		auto Stop() noexcept -> usize;
+		/**
+		 * Check if the tracker is tracking allocations
+		 * \return Whether the tracker is tracking allocations
+		 */
+		auto IsActive() const noexcept -> bool;
+
+		/**
+		 * Drain the events of all threads into the aggregated data
+		 */
+		void Flush() noexcept;
+
+		/**
+		 * Get the stats of all tags, sorted by live bytes
+		 * \return Tag stats
+		 */
+		auto GetTagStats() noexcept -> DynArray<AllocTagStats>;
+		/**
+		 * Get all live allocations
+		 * \return Live allocations
+		 */
+		auto GetLiveAllocations() noexcept -> DynArray<AllocRecord>;
+
+		/**
+		 * Get a human readable summary of the tag stats and the call stacks holding the most memory
+		 * \return Summary
+		 */
+		auto GetSummary() noexcept -> String;
+		/**
+		 * Write a snapshot of the tag stats and all live allocations to a binary file
+		 * \param[in] path Path to the file
+		 * \return Error
+		 *
+		 * The snapshot is stored in native endianness and starts with a header, followed by the tags and the live allocations:
+		 * - header: u32 magic, u16 version, u16 pointer size, u64 tag count, u64 allocation count
+		 * - tag: u32 name length, name (not null-terminated), u64 live bytes, u64 live allocations, u64 peak bytes, u64 total bytes, u64 total allocations
+		 * - allocation: u64 address, u64 size, u32 tag index, u32 stack hash
+		 */
+		auto WriteSnapshot(const FileSystem::Path& path) noexcept -> SystemError;
+		/**
+		 * Write the summary to a text file
+		 * \param[in] path Path to the file
+		 * \return Error
+		 */
+		auto WriteSummary(const FileSystem::Path& path) noexcept -> SystemError;
+
+		/**
+		 * Get the tag allocations made by the current thread are attributed to
+		 * \return Current tag
+		 */
+		static auto GetCurrentTag() noexcept -> const char*;
+
+		static constexpr u32 SnapshotMagic   = 0x5354414F; ///< Magic value at the start of a snapshot, "OATS"
+		static constexpr u16 SnapshotVersion = 1;          ///< Version of the snapshot format
+		static const char* const DefaultTag;               ///< Tag of allocations made outside of any tag scope, defined once, as tags are identified by their address
+
+	private:
+#if ENABLE_ALLOC_TRACKING
+		friend class Detail::AllocTrackingHooks;
+#endif
+		friend class TrackingAllocator;
+
+		/**
+		 * Live allocation in the aggregated state
+		 */
+		struct LiveAlloc
+		{
+			u64         seq;       ///< Sequence number of the event that allocated or last resized the allocation
+			usize       size;      ///< Size of the allocation
+			const char* pTag;      ///< Tag
+			u32         stackHash; ///< Call stack hash
+		};
+
+		/**
+		 * Deallocation that was drained before its allocation, as the thread that allocated the memory did not publish its event yet
+		 */
+		struct OrphanDealloc
+		{
+			u64 seq;   ///< Sequence number of the deallocation
+			u64 flush; ///< Flush in which the deallocation was drained
+		};
+
+		/**
+		 * Record an event in the buffer of the current thread
+		 * \param[in] state State of the current thread
+		 * \param[in] kind Kind of event
+		 * \param[in] addr Address of the allocation
+		 * \param[in] size Size of the allocation
+		 */
+		void Record(Detail::AllocTrackerThreadState& state, Detail::AllocTrackerEventKind kind, usize addr, usize size) noexcept;
+		/**
+		 * Record that a reallocation moved memory in the buffer of the current thread
+		 * \param[in] state State of the current thread
+		 * \param[in] seq Sequence number, taken before the old memory could be released
+		 * \param[in] srcAddr Previous address of the allocation
+		 * \param[in] addr New address of the allocation
+		 * \param[in] size New size of the allocation
+		 */
+		void RecordMove(Detail::AllocTrackerThreadState& state, u64 seq, usize srcAddr, usize addr, usize size) noexcept;
+		/**
+		 * Get the next event to write in the buffer of the current thread, acquiring a buffer if the thread does not own one of this tracker yet
+		 * \param[in] state State of the current thread
+		 * \return Event, or nullptr if no buffer could be acquired
+		 * \note The event is published by incrementing the head of the buffer
+		 */
+		auto GetNextEvent(Detail::AllocTrackerThreadState& state) noexcept -> Detail::AllocTrackerEvent*;
+		/**
+		 * Acquire a buffer for the current thread, reusing a buffer released by another thread when possible
+		 * \return Buffer, or nullptr if no buffer could be allocated
+		 */
+		auto AcquireBuffer() noexcept -> Detail::AllocTrackerBuffer*;
+		/**
+		 * Set the tag the current allocation is attributed to, overriding the tag of the thread
+		 * \param[in] pTag Tag
+		 */
+		static void SetCallTag(const char* pTag) noexcept;
+		/**
+		 * Flush while the tracker is locked
+		 */
+		void FlushLocked() noexcept;
+		/**
+		 * Apply an event to the aggregated state
+		 * \param[in] event Event
+		 */
+		void Apply(const Detail::AllocTrackerEvent& event) noexcept;
+		/**
+		 * Add an allocation to the stats of its tag
+		 * \param[in] pTag Tag
+		 * \param[in] size Size of the allocation
+		 */
+		void AddToTag(const char* pTag, usize size) noexcept;
+		/**
+		 * Remove an allocation from the stats of its tag
+		 * \param[in] pTag Tag
+		 * \param[in] size Size of the allocation
+		 */
+		void RemoveFromTag(const char* pTag, usize size) noexcept;
+		/**
+		 * Create the summary while the tracker is locked
+		 * \return Summary
+		 */
+		auto GetSummaryLocked() noexcept -> String;
+
+		Mallocator                          m_mallocator; ///< Allocator used for the tracker's own memory
+		Threading::Mutex                    m_mutex;      ///< Mutex guarding the aggregated state
+		AllocTrackerOptions                 m_options;    ///< Options
+		u64                                 m_generation; ///< Generation of the tracker, identifying the tracker a thread's buffer belongs to, unlike its address, which can be reused
+		Atomic<Detail::AllocTrackerBuffer*> m_pBuffers;   ///< Buffers of all threads that recorded events
+		Atomic<u64>                         m_seq;        ///< Next sequence number
+		u64                                 m_flush;      ///< Number of flushes
+		HashMap<usize, LiveAlloc>           m_live;       ///< Live allocations
+		HashMap<usize, AllocTagStats>       m_tags;       ///< Stats per tag
+		HashMap<usize, OrphanDealloc>       m_orphans;    ///< Deallocations that were drained before their allocation
+	};
+
+	/**
+	 * Get the allocation tracker
+	 * \return Allocation tracker
+	 */
+	CORE_API auto GetAllocTracker() noexcept -> AllocTracker&;
+}
+
+#define g_AllocTracker (::Onca::Alloc::GetAllocTracker())
+
+/**
+ * \def ALLOC_TAG_SCOPE(tag)
+ * Attribute all allocations made by the current thread until the end of the scope to a tag
+ */
+#if ENABLE_ALLOC_TRACKING
+#	define ALLOC_TAG_SCOPE_IMPL(tag, line) ::Onca::Alloc::ScopedAllocTag _allocTagScope##line{ tag }
+#	define ALLOC_TAG_SCOPE_EXPAND(tag, line) ALLOC_TAG_SCOPE_IMPL(tag, line)
+#	define ALLOC_TAG_SCOPE(tag) ALLOC_TAG_SCOPE_EXPAND(tag, __LINE__)
+#else
+#	define ALLOC_TAG_SCOPE(tag) UNUSED(0)
+#endif
@@ -0,0 +1,148 @@
+#pragma once
+#include "IAllocator.h"
+#include "core/memory/CompactMemRef.h"
+
+namespace Onca::Alloc
+{
+	/**
+	 * \brief Allocator policy for containers, storing the allocator once per container
+	 *
+	 * Allocations are handed out as compact MemRefs, and are described by an element count instead of a size in bytes,
+	 * so containers only need to store the allocator once, instead of once per allocation.
+	 * Counted allocations additionally store their element count in a header in front of the elements, for containers that would otherwise need to store their capacity.
+	 */
+	class ContainerAlloc
+	{
+	public:
+		/**
+		 * Create a container allocator
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit ContainerAlloc(IAllocator& alloc) noexcept;
+
+		/**
+		 * Allocate memory for a number of elements
+		 * \tparam T Type to allocate
+		 * \param[in] count Number of elements
+		 * \param[in] align Alignment of the allocation
+		 * \return Allocated memory, invalid if the allocation failed
+		 */
+		template<typename T>
+		auto Allocate(usize count, u16 align = alignof(T)) noexcept -> CompactMemRef<T>;
+		/**
+		 * Deallocate memory allocated for a number of elements
+		 * \tparam T Type of the allocation
+		 * \param[in] mem Memory to deallocate
+		 * \param[in] count Number of elements the memory was allocated with
+		 * \param[in] align Alignment the memory was allocated with
+		 */
+		template<typename T>
+		void Deallocate(CompactMemRef<T>&& mem, usize count, u16 align = alignof(T)) noexcept;
+		/**
+		 * Try to expand memory allocated for a number of elements in place
+		 * \tparam T Type of the allocation
+		 * \param[in] mem Memory to expand
+		 * \param[in] count Number of elements the memory was allocated with
+		 * \param[in] newCount New number of elements
+		 * \param[in] align Alignment the memory was allocated with
+		 * \return Whether the memory could be expanded
+		 */
+		template<typename T>
+		auto TryExpandInPlace(const CompactMemRef<T>& mem, usize count, usize newCount, u16 align = alignof(T)) noexcept -> bool;
+		/**
+		 * Resize memory allocated for a number of elements, moving it when it cannot be resized in place
+		 * \tparam T Type of the allocation, needs to be trivially relocatable
+		 * \param[in,out] mem Memory to reallocate
+		 * \param[in] count Number of elements the memory was allocated with
+		 * \param[in] newCount New number of elements
+		 * \param[in] align Alignment the memory was allocated with
+		 * \return Whether the memory could be reallocated, if not, the original memory is left untouched
+		 */
+		template<TriviallyRelocatable T>
+		auto Reallocate(CompactMemRef<T>& mem, usize count, usize newCount, u16 align = alignof(T)) noexcept -> bool;
+
+		/**
+		 * Allocate memory for a number of elements and store the count in front of the elements
+		 * \tparam T Type to allocate
+		 * \param[in] count Number of elements
+		 * \param[in] align Alignment of the elements
+		 * \return Allocated memory, pointing to the first element, invalid if the allocation failed
+		 */
+		template<typename T>
+		auto AllocateCounted(usize count, u16 align = alignof(T)) noexcept -> CompactMemRef<T>;
+		/**
+		 * Deallocate counted memory
+		 * \tparam T Type of the allocation
+		 * \param[in] mem Memory to deallocate
+		 * \param[in] align Alignment the elements were allocated with
+		 */
+		template<typename T>
+		void DeallocateCounted(CompactMemRef<T>&& mem, u16 align = alignof(T)) noexcept;
+		/**
+		 * Try to expand counted memory in place, updating the stored count on success
+		 * \tparam T Type of the allocation
+		 * \param[in] mem Memory to expand
+		 * \param[in] newCount New number of elements
+		 * \param[in] align Alignment the elements were allocated with
+		 * \return Whether the memory could be expanded
+		 */
+		template<typename T>
+		auto TryExpandCountedInPlace(const CompactMemRef<T>& mem, usize newCount, u16 align = alignof(T)) noexcept -> bool;
+		/**
+		 * Resize counted memory, moving it when it cannot be resized in place, and update the stored count
+		 * \tparam T Type of the allocation, needs to be trivially relocatable
+		 * \param[in,out] mem Memory to reallocate
+		 * \param[in] newCount New number of elements
+		 * \param[in] align Alignment the elements were allocated with
+		 * \return Whether the memory could be reallocated, if not, the original memory is left untouched
+		 */
+		template<TriviallyRelocatable T>
+		auto ReallocateCounted(CompactMemRef<T>& mem, usize newCount, u16 align = alignof(T)) noexcept -> bool;
+		/**
+		 * Get the number of elements counted memory was allocated with
+		 * \tparam T Type of the allocation
+		 * \param[in] mem Counted memory
+		 * \return Number of elements, 0 if the memory is invalid
+		 */
+		template<typename T>
+		static auto GetCount(const CompactMemRef<T>& mem) noexcept -> usize;
+
+		/**
+		 * Allocate and construct a single object
+		 * \tparam T Type to create
+		 * \tparam Args Types of the arguments
+		 * \param[in] args Arguments
+		 * \return Created object, invalid if the allocation failed
+		 */
+		template<typename T, typename... Args>
+		auto Create(Args&&... args) noexcept -> CompactMemRef<T>;
+		/**
+		 * Destruct and deallocate a single object
+		 * \tparam T Type of the object
+		 * \param[in] mem Object to destroy
+		 */
+		template<typename T>
+		void Destroy(CompactMemRef<T>&& mem) noexcept;
+
+		/**
+		 * Get the underlying allocator
+		 * \return Underlying allocator
+		 */
+		auto Get() const noexcept -> IAllocator* { return m_pAlloc; }
+
+		auto operator==(const ContainerAlloc& other) const noexcept -> bool { return m_pAlloc == other.m_pAlloc; }
+		auto operator!=(const ContainerAlloc& other) const noexcept -> bool { return m_pAlloc != other.m_pAlloc; }
+
+	private:
+		/**
+		 * Get the size of the header in front of counted memory
+		 * \param[in] align Alignment of the elements
+		 * \return Size of the header
+		 */
+		static constexpr auto GetCountHeaderSize(u16 align) noexcept -> usize;
+
+		IAllocator* m_pAlloc; ///< Underlying allocator
+	};
+}
+
+#include "ContainerAlloc.inl"
@@ -0,0 +1,134 @@
+#pragma once
+#if __RESHARPER__
+#include "ContainerAlloc.h"
+#endif
+
+namespace Onca::Alloc
+{
+	inline ContainerAlloc::ContainerAlloc(IAllocator& alloc) noexcept
+		: m_pAlloc(&alloc)
+	{
+	}
+
+	template <typename T>
+	auto ContainerAlloc::Allocate(usize count, u16 align) noexcept -> CompactMemRef<T>
+	{
+		return CompactMemRef<T>{ m_pAlloc->template Allocate<T>(count * sizeof(T), align) };
+	}
+
+	template <typename T>
+	void ContainerAlloc::Deallocate(CompactMemRef<T>&& mem, usize count, u16 align) noexcept
+	{
+		mem.Dealloc(m_pAlloc, count * sizeof(T), align);
+	}
+
+	template <typename T>
+	auto ContainerAlloc::TryExpandInPlace(const CompactMemRef<T>& mem, usize count, usize newCount, u16 align) noexcept -> bool
+	{
+		MemRef<T> ref = mem.ToMemRef(m_pAlloc, count * sizeof(T), align);
+		return m_pAlloc->TryExpandInPlace(ref, newCount * sizeof(T));
+	}
+
+	template <TriviallyRelocatable T>
+	auto ContainerAlloc::Reallocate(CompactMemRef<T>& mem, usize count, usize newCount, u16 align) noexcept -> bool
+	{
+		MemRef<T> ref = mem.ToMemRef(m_pAlloc, count * sizeof(T), align);
+		if (!m_pAlloc->Reallocate(ref, newCount * sizeof(T)))
+			return false;
+
+		mem = CompactMemRef<T>{ Move(ref) };
+		return true;
+	}
+
+	template <typename T>
+	auto ContainerAlloc::AllocateCounted(usize count, u16 align) noexcept -> CompactMemRef<T>
+	{
+		const usize headerSize = GetCountHeaderSize(align);
+		MemRef<u8> mem = m_pAlloc->template Allocate<u8>(headerSize + count * sizeof(T), Math::Max<u16>(align, alignof(usize)));
+		if (!mem) UNLIKELY
+			return nullptr;
+
+		u8* pElems = mem.Ptr() + headerSize;
+		*reinterpret_cast<usize*>(pElems - sizeof(usize)) = count;
+		mem = nullptr;
+		return CompactMemRef<T>{ reinterpret_cast<T*>(pElems) };
+	}
+
+	template <typename T>
+	void ContainerAlloc::DeallocateCounted(CompactMemRef<T>&& mem, u16 align) noexcept
+	{
+		if (!mem)
+			return;
+
+		const usize headerSize = GetCountHeaderSize(align);
+		u8* pBase = reinterpret_cast<u8*>(mem.Ptr()) - headerSize;
+		m_pAlloc->Deallocate(MemRef<u8>{ pBase, m_pAlloc, Math::Log2(Math::Max<u16>(align, alignof(usize))), headerSize + GetCount(mem) * sizeof(T), false });
+		mem = nullptr;
+	}
+
+	template <typename T>
+	auto ContainerAlloc::TryExpandCountedInPlace(const CompactMemRef<T>& mem, usize newCount, u16 align) noexcept -> bool
+	{
+		if (!mem)
+			return false;
+
+		const usize headerSize = GetCountHeaderSize(align);
+		u8* pBase = reinterpret_cast<u8*>(mem.Ptr()) - headerSize;
+		MemRef<u8> ref{ pBase, m_pAlloc, Math::Log2(Math::Max<u16>(align, alignof(usize))), headerSize + GetCount(mem) * sizeof(T), false };
+		if (!m_pAlloc->TryExpandInPlace(ref, headerSize + newCount * sizeof(T)))
+			return false;
+
+		*(reinterpret_cast<usize*>(mem.Ptr()) - 1) = newCount;
+		return true;
+	}
+
+	template <TriviallyRelocatable T>
+	auto ContainerAlloc::ReallocateCounted(CompactMemRef<T>& mem, usize newCount, u16 align) noexcept -> bool
+	{
+		if (!mem)
+			return false;
+
+		const usize headerSize = GetCountHeaderSize(align);
+		u8* pBase = reinterpret_cast<u8*>(mem.Ptr()) - headerSize;
+		MemRef<u8> ref{ pBase, m_pAlloc, Math::Log2(Math::Max<u16>(align, alignof(usize))), headerSize + GetCount(mem) * sizeof(T), false };
+		if (!m_pAlloc->Reallocate(ref, headerSize + newCount * sizeof(T)))
+			return false;
+
+		T* pElems = reinterpret_cast<T*>(ref.Ptr() + headerSize);
+		*(reinterpret_cast<usize*>(pElems) - 1) = newCount;
+		mem = CompactMemRef<T>{ pElems };
+		ref = nullptr;
+		return true;
+	}
+
+	template <typename T>
+	auto ContainerAlloc::GetCount(const CompactMemRef<T>& mem) noexcept -> usize
+	{
+		if (!mem)
+			return 0;
+		return *(reinterpret_cast<const usize*>(mem.Ptr()) - 1);
+	}
+
+	template <typename T, typename ... Args>
+	auto ContainerAlloc::Create(Args&&... args) noexcept -> CompactMemRef<T>
+	{
+		CompactMemRef<T> mem = Allocate<T>(1);
+		if (mem) LIKELY
+			new (mem.Ptr()) T{ Forward<Args>(args)... };
+		return mem;
+	}
+
+	template <typename T>
+	void ContainerAlloc::Destroy(CompactMemRef<T>&& mem) noexcept
+	{
+		if (!mem)
+			return;
+		mem->~T();
+		Deallocate(Move(mem), 1);
+	}
+
+	constexpr auto ContainerAlloc::GetCountHeaderSize(u16 align) noexcept -> usize
+	{
+		return Math::Max<usize>(sizeof(usize), align);
+	}
+}
@@ -7,12 +7,20 @@ namespace Onca::Detail
 		static Alloc::IAllocator* pAlloc;
 		return pAlloc;
 	}
+
+	auto GetThreadGlobalAllocOverrideAddr() -> Onca::Alloc::IAllocator*&
+	{
+		thread_local Alloc::IAllocator* t_pAlloc = nullptr;
+		return t_pAlloc;
+	}
 }
 
 namespace Onca
 {
 	CORE_API auto GetGlobalAlloc() -> Onca::Alloc::IAllocator&
 	{
+		if (Alloc::IAllocator* pOverride = Detail::GetThreadGlobalAllocOverrideAddr()) UNLIKELY
+			return *pOverride;
 		return *Detail::GetGlobalAllocAddr();
 	}
 
@@ -21,4 +29,15 @@ namespace Onca
 		Alloc::IAllocator** ppAlloc = &Detail::GetGlobalAllocAddr();
 		*ppAlloc = &alloc;
 	}
+
+	ScopedGlobalAlloc::ScopedGlobalAlloc(Alloc::IAllocator& alloc) noexcept
+		: m_pPrev(Detail::GetThreadGlobalAllocOverrideAddr())
+	{
+		Detail::GetThreadGlobalAllocOverrideAddr() = &alloc;
+	}
+
+	ScopedGlobalAlloc::~ScopedGlobalAlloc() noexcept
+	{
+		Detail::GetThreadGlobalAllocOverrideAddr() = m_pPrev;
+	}
 }
\ No newline at end of file
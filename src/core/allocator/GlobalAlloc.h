@@ -8,6 +8,11 @@ namespace Onca::Detail
 	 * \return Pointer to the pointer storing the global allocator
 	 */
 	auto GetGlobalAllocAddr() ->Alloc::IAllocator*&;
+	/**
+	 * Get the address of the pointer pointing to the global alloc override of the current thread
+	 * \return Pointer to the pointer storing the override, pointing to nullptr when there is no override
+	 */
+	auto GetThreadGlobalAllocOverrideAddr() ->Alloc::IAllocator*&;
 }
 
 namespace Onca
@@ -24,6 +29,33 @@ namespace Onca
 	* \note The allocator being assigned needs to live longer than all allocations made by it
 	*/
 	CORE_API void SetGlobalAlloc(Alloc::IAllocator& alloc);
+
+	/**
+	 * RAII scope overriding the global allocator for the current thread
+	 *
+	 * While the scope is alive, the global allocator returns the overriding allocator on the thread that created the scope,
+	 * so any container created without an explicit allocator transparently allocates from it, e.g. to put temporaries in frame memory.
+	 * Scopes can be nested, the previous override is restored when the scope ends.
+	 *
+	 * \note Containers remember the allocator they allocated from, so memory allocated during the scope may still be deallocated afterwards,
+	 *       but anything outliving the scope should not be allocated from an allocator that does not outlive it
+	 */
+	class CORE_API ScopedGlobalAlloc
+	{
+	public:
+		/**
+		 * Override the global allocator for the current thread
+		 * \param[in] alloc Allocator to use as global allocator
+		 */
+		explicit ScopedGlobalAlloc(Alloc::IAllocator& alloc) noexcept;
+		~ScopedGlobalAlloc() noexcept;
+
+		DISABLE_COPY(ScopedGlobalAlloc);
+		DISABLE_MOVE(ScopedGlobalAlloc);
+
+	private:
+		Alloc::IAllocator* m_pPrev; ///< Previous override
+	};
 }
 
 #define g_GlobalAlloc (::Onca::GetGlobalAlloc())
\ No newline at end of file
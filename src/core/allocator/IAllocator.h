@@ -61,9 +61,60 @@ namespace Onca::Alloc
 		void GetCurStats(usize& memUse, usize& numAllocs, usize& overhead, usize& backingMem) noexcept;
 	};
 
+#if ENABLE_ALLOC_TRACKING
+	namespace Detail
+	{
+		/**
+		 * Hooks used by IAllocator to report allocations to the allocation tracker
+		 *
+		 * Only the outermost call on a thread is recorded, so allocations that composable allocators forward to their child allocators are only recorded once.
+		 */
+		class CORE_API AllocTrackingHooks
+		{
+		public:
+			/**
+			 * Allocate memory and record the allocation
+			 * \param[in] alloc Allocator to allocate from
+			 * \param[in] size Min size of the allocation
+			 * \param[in] align Min alignment of the allocation
+			 * \param[in] isBacking Whether the memory backs another allocator
+			 * \return Allocated memory
+			 */
+			static auto Allocate(IAllocator& alloc, usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>;
+			/**
+			 * Deallocate memory and record the deallocation
+			 * \param[in] alloc Allocator to deallocate from
+			 * \param[in] mem Memory to deallocate
+			 */
+			static void Deallocate(IAllocator& alloc, MemRef<u8>&& mem) noexcept;
+			/**
+			 * Try to grow memory in place and record the new size
+			 * \param[in] alloc Allocator owning the memory
+			 * \param[in] mem Memory to grow
+			 * \param[in] newSize New size of the allocation
+			 * \return Whether the allocation was grown
+			 */
+			static auto TryExpandInPlace(IAllocator& alloc, const MemRef<u8>& mem, usize newSize) noexcept -> bool;
+			/**
+			 * Reallocate memory and record the deallocation of the old and the allocation of the new memory
+			 * \param[in] alloc Allocator owning the memory
+			 * \param[in,out] mem Memory to reallocate
+			 * \param[in] newSize New size of the allocation
+			 * \return Whether the memory was reallocated
+			 */
+			static auto Reallocate(IAllocator& alloc, MemRef<u8>& mem, usize newSize) noexcept -> bool;
+		};
+	}
+#endif
+
 	// TODO: Go over ownership system + possible redo
 	class CORE_API IAllocator
 	{
+#if ENABLE_ALLOC_TRACKING
+		friend class Detail::AllocTrackingHooks;
+#endif
+
+
 	public:
 		virtual ~IAllocator() noexcept = default;
 
@@ -95,6 +146,26 @@ namespace Onca::Alloc
 		template<typename T>
 		auto Owns(const MemRef<T>& mem) noexcept -> bool;
 
+		/**
+		 * \brief Try to grow an allocation without moving it
+		 * \tparam T Underlying type of the MemRef
+		 * \param[in,out] mem MemRef to grow, its size is updated when the allocation was grown
+		 * \param[in] newSize New size of the allocation
+		 * \return Whether the allocation was grown
+		 */
+		template<typename T>
+		auto TryExpandInPlace(MemRef<T>& mem, usize newSize) noexcept -> bool;
+		/**
+		 * \brief Resize an allocation, moving it when it cannot be resized in place
+		 * \tparam T Underlying type of the MemRef
+		 * \param[in,out] mem MemRef to reallocate, updated to the new memory when the allocation was reallocated
+		 * \param[in] newSize New size of the allocation
+		 * \return Whether the allocation was reallocated, if not, the original memory is left untouched
+		 * \note The contents are moved using a memcpy, so the memory should only contain trivially relocatable types
+		 */
+		template<typename T>
+		auto Reallocate(MemRef<T>& mem, usize newSize) noexcept -> bool;
+
 		/**
 		 * Get statistics for this allocator 
 		 * \return Alloc stats
@@ -121,6 +192,22 @@ namespace Onca::Alloc
 		 * \return If the allocation is owned by the allocator
 		 */
 		virtual auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool;
+		/**
+		 * \brief Try to grow a raw allocation without moving it
+		 * \param[in] mem MemRef to grow
+		 * \param[in] newSize New size of the allocation
+		 * \return Whether the allocation was grown
+		 * \note The default implementation never grows allocations in place
+		 */
+		virtual auto TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool;
+		/**
+		 * \brief Resize a raw allocation, moving it when it cannot be resized in place
+		 * \param[in,out] mem MemRef to reallocate
+		 * \param[in] newSize New size of the allocation
+		 * \return Whether the allocation was reallocated
+		 * \note The default implementation tries to grow the allocation in place, otherwise allocates new memory, copies the contents and deallocates the old memory
+		 */
+		virtual auto ReallocateRaw(MemRef<u8>& mem, usize newSize) noexcept -> bool;
 		
 #if ENABLE_ALLOC_STATS
 		AllocatorStats m_stats;
@@ -134,6 +221,7 @@ namespace Onca::Alloc
 	{
 	public:
 		IMemBackedAllocator(MemRef<u8>&& mem) noexcept;
+		IMemBackedAllocator(IMemBackedAllocator&&) noexcept = default;
 		~IMemBackedAllocator() noexcept override;
 
 		/**
@@ -156,6 +244,12 @@ namespace Onca::Alloc
 		 */
 		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
 
+		/**
+		 * Get the memory backing the allocator
+		 * \return Memory backing the allocator
+		 */
+		auto GetBackingMem() const noexcept -> const MemRef<u8>& { return m_mem; }
+
 	protected:
 		MemRef<u8> m_mem; ///< Memory backing allocator
 	};
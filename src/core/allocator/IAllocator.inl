@@ -12,13 +12,21 @@ namespace Onca::Alloc
 	auto IAllocator::Allocate(usize size, u16 align, bool isBacking) noexcept -> MemRef<T>
 	{
 		ASSERT(align > 0 && Math::IsPowOf2(align), "Alignment needs to be a power of 2");
-		return AllocateRaw(size, align, isBacking).As<T>();
+#if ENABLE_ALLOC_TRACKING
+		return Detail::AllocTrackingHooks::Allocate(*this, size, align, isBacking).template As<T>();
+#else
+		return AllocateRaw(size, align, isBacking).template As<T>();
+#endif
 	}
 
 	template <typename T>
 	void IAllocator::Deallocate(MemRef<T>&& ref) noexcept
 	{
+#if ENABLE_ALLOC_TRACKING
+		Detail::AllocTrackingHooks::Deallocate(*this, ref.template As<u8>());
+#else
 		DeallocateRaw(ref.template As<u8>());
+#endif
 		MemClearData(ref);
 	}
 
@@ -28,6 +36,40 @@ namespace Onca::Alloc
 		return OwnsInternal(ref.template As<u8>());
 	}
 
+	template <typename T>
+	auto IAllocator::TryExpandInPlace(MemRef<T>& ref, usize newSize) noexcept -> bool
+	{
+#if ENABLE_ALLOC_TRACKING
+		if (!ref.IsValid() || !Detail::AllocTrackingHooks::TryExpandInPlace(*this, ref.template As<u8>(), newSize))
+			return false;
+#else
+		if (!ref.IsValid() || !TryExpandInPlaceRaw(ref.template As<u8>(), newSize))
+			return false;
+#endif
+
+		ref = MemRef<T>{ ref.Ptr(), ref.GetAlloc(), Math::Log2(ref.Align()), newSize, ref.IsBackingMem() };
+		return true;
+	}
+
+	template <typename T>
+	auto IAllocator::Reallocate(MemRef<T>& ref, usize newSize) noexcept -> bool
+	{
+		if (!ref.IsValid())
+			return false;
+
+		MemRef<u8> mem = ref.template As<u8>();
+#if ENABLE_ALLOC_TRACKING
+		if (!Detail::AllocTrackingHooks::Reallocate(*this, mem, newSize))
+			return false;
+#else
+		if (!ReallocateRaw(mem, newSize))
+			return false;
+#endif
+
+		ref = mem.template As<T>();
+		return true;
+	}
+
 	INL void AllocatorStats::AddAlloc(usize memUse, usize overhead, bool isBacking) noexcept
 	{
 		Threading::Lock lock(m_statMutex);
@@ -94,6 +136,31 @@ namespace Onca::Alloc
 		return mem.GetAlloc() == this;
 	}
 
+	INL auto IAllocator::TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		UNUSED(mem);
+		UNUSED(newSize);
+		return false;
+	}
+
+	INL auto IAllocator::ReallocateRaw(MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		if (newSize > mem.Size() && TryExpandInPlaceRaw(mem, newSize))
+		{
+			mem = MemRef<u8>{ mem.Ptr(), mem.GetAlloc(), Math::Log2(mem.Align()), newSize, mem.IsBackingMem() };
+			return true;
+		}
+
+		MemRef<u8> newMem = AllocateRaw(newSize, mem.Align(), mem.IsBackingMem());
+		if (!newMem) UNLIKELY
+			return false;
+
+		MemCpy(newMem.Ptr(), mem.Ptr(), Math::Min(mem.Size(), newSize));
+		DeallocateRaw(Move(mem));
+		mem = Move(newMem);
+		return true;
+	}
+
 	inline IMemBackedAllocator::IMemBackedAllocator(MemRef<u8>&& mem) noexcept
 		: m_mem(Move(mem))
 	{
@@ -2,16 +2,18 @@
 #include "core/allocator/IAllocator.h"
 #include "core/containers/DynArray.h"
 #include "core/memory/Unique.h"
+#include "core/utils/Atomic.h"
 
 namespace Onca::Alloc
 {
 	/**
 	 * An interface defining the requirements an allocator needs to be able to be used in an expandable allocator
 	 * \tparam T Type to constrain
+	 * \note The allocator needs to be backed by a single block of memory, which is used to find the allocator owning an allocation
 	 */
 	template<typename T>
 	concept ExtendableAlloc =
-		ImplementsIAllocator<T> &&
+		DerivesFrom<T, IMemBackedAllocator> &&
 		MoveConstructible<T> &&
 		requires(IAllocator* pAlloc)
 	{
@@ -21,6 +23,13 @@ namespace Onca::Alloc
 	/**
 	 * An expandable arena managed a set of allocators and allows the creation of additional allocators when the current ones run out of space
 	 *
+	 * The sub-allocators are kept in an index sorted by address, so the allocator owning an allocation is found with a binary search.
+	 * Allocations first go to the sub-allocator that last succeeded, only falling back to a search over all sub-allocators when it is full.
+	 * Both paths read the index without locking, only adding and removing sub-allocators is guarded by a mutex.
+	 * A sub-allocator that becomes empty is released back to the backing allocator, unless it's the sub-allocator currently used for allocations.
+	 *
+	 * Published indices and released sub-allocators are only freed when no thread is reading them, this is checked every time the index is modified.
+	 *
 	 * \tparam Alloc Allocator to use
 	 */
 	template<ExtendableAlloc Alloc>
@@ -33,16 +42,77 @@ namespace Onca::Alloc
 		 */
 		ExpandableArena(IAllocator* expandAlloc);
 
+		/**
+		 * Get the number of sub-allocators
+		 * \return Number of sub-allocators
+		 */
+		auto GetNumSubAllocs() noexcept -> usize;
+
 	protected:
 		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
 		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
 
 	private:
-		IAllocator*             m_backingAlloc; ///< Allocator to back sub-allocators
-		// TODO: replace with theadsafe container
-		DynArray<Unique<Alloc>> m_allocs;       ///< Allocators
-		Threading::Mutex        m_mutex;        ///< Mutex to guard DynArray
+		/**
+		 * Set in the allocation count of a sub-allocator when it's released, causing any new allocation to back off
+		 */
+		static constexpr usize ReleasedFlag = usize(1) << (sizeof(usize) * 8 - 1);
+
+		struct SubAlloc
+		{
+			Unique<Alloc> alloc;     ///< Allocator
+			u8*           pBegin;    ///< Start of the memory managed by the allocator
+			u8*           pEnd;      ///< End of the memory managed by the allocator
+			Atomic<usize> numAllocs; ///< Number of live allocations, including allocations in progress
+		};
+
+		struct Index
+		{
+			DynArray<SubAlloc*> subAllocs; ///< Sub-allocators, sorted by address
+		};
+
+		/**
+		 * Try to allocate from a sub-allocator
+		 * \param[in] pSubAlloc Sub-allocator
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 * \return Allocated memory, or an invalid MemRef if the sub-allocator is full or released
+		 */
+		auto TryAllocate(SubAlloc* pSubAlloc, usize size, u16 align) noexcept -> MemRef<u8>;
+		/**
+		 * Find the sub-allocator owning memory
+		 * \param[in] pIndex Index to search
+		 * \param[in] ptr Pointer to memory
+		 * \return Sub-allocator, or nullptr if the memory isn't owned by any sub-allocator
+		 */
+		static auto Find(Index* pIndex, const u8* ptr) noexcept -> SubAlloc*;
+		/**
+		 * Release a sub-allocator if it is still empty
+		 * \param[in] pSubAlloc Sub-allocator
+		 */
+		void TryRelease(SubAlloc* pSubAlloc) noexcept;
+		/**
+		 * Publish a new index, retiring the current index
+		 * \param[in] index New index
+		 * \note Needs to be called with the mutex locked
+		 */
+		void Publish(Unique<Index>&& index) noexcept;
+		/**
+		 * Free all retired indices and sub-allocators if no thread is reading them
+		 * \note Needs to be called with the mutex locked
+		 */
+		void Reclaim() noexcept;
+
+		IAllocator*                m_backingAlloc;     ///< Allocator to back sub-allocators
+		DynArray<Unique<SubAlloc>> m_subAllocs;        ///< Sub-allocators, guarded by the mutex
+		Unique<Index>              m_index;            ///< Current index, guarded by the mutex
+		Atomic<Index*>             m_pIndex;           ///< Current index, read without locking
+		Atomic<SubAlloc*>          m_pCurrent;         ///< Sub-allocator to try first when allocating
+		Atomic<u32>                m_numReaders;       ///< Number of threads reading the index without holding the mutex
+		DynArray<Unique<Index>>    m_retiredIndices;   ///< Indices that may still be read by other threads
+		DynArray<Unique<SubAlloc>> m_retiredSubAllocs; ///< Sub-allocators that may still be read by other threads
+		Threading::Mutex           m_mutex;            ///< Mutex to guard modifications of the sub-allocators
 	};
 }
 
@@ -8,85 +8,192 @@ namespace Onca::Alloc
 	template<ExtendableAlloc Alloc>
 	ExpandableArena<Alloc>::ExpandableArena(IAllocator* expandAlloc)
 		: m_backingAlloc(expandAlloc)
-		, m_allocs(*expandAlloc)
+		, m_subAllocs(*expandAlloc)
+		, m_index(Unique<Index>::CreateWithAlloc(*expandAlloc, DynArray<SubAlloc*>{ *expandAlloc }))
+		, m_pIndex(nullptr)
+		, m_pCurrent(nullptr)
+		, m_numReaders(0)
+		, m_retiredIndices(*expandAlloc)
+		, m_retiredSubAllocs(*expandAlloc)
 	{
+		m_pIndex.Store(m_index.Get());
 	}
 
 	template<ExtendableAlloc Alloc>
-	auto ExpandableArena<Alloc>::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	auto ExpandableArena<Alloc>::GetNumSubAllocs() noexcept -> usize
 	{
 		Threading::Lock lock{ m_mutex };
+		return m_subAllocs.Size();
+	}
+
+	template<ExtendableAlloc Alloc>
+	auto ExpandableArena<Alloc>::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+		// Try the sub-allocator that served the last allocation first, without locking
+		m_numReaders.FetchAdd(1);
+		SubAlloc* pCurrent = m_pCurrent.Load();
+		MemRef<u8> mem = pCurrent ? TryAllocate(pCurrent, size, align) : MemRef<u8>{};
+		m_numReaders.FetchSub(1);
 
-		for (Unique<Alloc>& alloc : m_allocs)
+		if (!mem)
 		{
-#if ENABLE_ALLOC_STATS
-			usize _, oldMemUse, oldOverhead;
-			alloc->GetAllocStats().GetCurStats(oldMemUse, _, oldOverhead, _);
-#endif
+			Threading::Lock lock{ m_mutex };
 
-			MemRef<u8> mem = alloc->template Allocate<u8>(size, align);
+			for (Unique<SubAlloc>& subAlloc : m_subAllocs)
+			{
+				mem = TryAllocate(subAlloc.Get(), size, align);
+				if (mem)
+				{
+					m_pCurrent.Store(subAlloc.Get());
+					break;
+				}
+			}
 
 			if (!mem)
-				continue;
+			{
+				// No place left, so expand the allocator
+				Unique<Alloc> alloc = Unique<Alloc>::CreateWithAlloc(*m_backingAlloc, m_backingAlloc);
+				u8* pBegin = alloc->GetBackingMem().Ptr();
+				u8* pEnd = pBegin + alloc->GetBackingMem().Size();
+				Unique<SubAlloc> subAlloc = Unique<SubAlloc>::CreateWithAlloc(*m_backingAlloc, Move(alloc), pBegin, pEnd, usize(0));
 
-#if ENABLE_ALLOC_STATS
-			usize newMemUse, newOverhead;
-			alloc->GetAllocStats().GetCurStats(newMemUse, _, newOverhead, _);
-			m_stats.AddAlloc(newMemUse - oldMemUse, newOverhead - oldOverhead, isBacking);
-#endif
-			
-			return mem;
-		}
+				// Allocation doesn't fit in an empty sub-allocator
+				mem = TryAllocate(subAlloc.Get(), size, align);
+				if (!mem)
+					return nullptr;
 
-		// No place left, so expand the allocator
-		m_allocs.Add(Unique<Alloc>::CreateWitAlloc(*m_backingAlloc, m_backingAlloc));
-		MemRef<u8> mem = m_allocs.Back()->template Allocate<u8>(size, align);
+				Unique<Index> index = Unique<Index>::CreateWithAlloc(*m_backingAlloc, DynArray<SubAlloc*>{ m_index->subAllocs, *m_backingAlloc });
+				usize insertIdx = 0;
+				while (insertIdx < index->subAllocs.Size() && index->subAllocs[insertIdx]->pBegin < pBegin)
+					++insertIdx;
+				index->subAllocs.Insert(insertIdx, subAlloc.Get());
+
+				m_pCurrent.Store(subAlloc.Get());
+				m_subAllocs.Add(Move(subAlloc));
+				Publish(Move(index));
+			}
+		}
 
 #if ENABLE_ALLOC_STATS
-		usize _, memUse, overhead;
-		m_allocs.Back()->GetAllocStats().GetCurStats(memUse, _, overhead, _);
-		m_stats.AddAlloc(memUse, overhead, isBacking);
+		m_stats.AddAlloc(mem.Size(), 0, isBacking);
 #endif
 
-		return mem;
+		// Memory is returned as owned by the arena, so deallocations always go through the arena
+		return { mem.Ptr(), this, Math::Log2(mem.Align()), mem.Size(), isBacking };
 	}
 
 	template<ExtendableAlloc Alloc>
 	void ExpandableArena<Alloc>::DeallocateRaw(MemRef<u8>&& mem) noexcept
 	{
-		Threading::Lock lock{ m_mutex };
+		m_numReaders.FetchAdd(1);
+		SubAlloc* pSubAlloc = Find(m_pIndex.Load(), mem.Ptr());
+		ASSERT(pSubAlloc, "Memory is not owned by the arena");
 
-		for (Unique<Alloc>& alloc : m_allocs)
+		bool release = false;
+		if (pSubAlloc)
 		{
-			if (alloc->Owns(mem))
-			{
-#if ENABLE_ALLOC_STATS
-				usize _, oldMemUse, oldOverhead;
-				alloc->GetAllocStats().GetCurStats(oldMemUse, _, oldOverhead, _);
-#endif
+			MemRef<u8> subMem{ mem.Ptr(), pSubAlloc->alloc.Get(), Math::Log2(mem.Align()), mem.Size(), mem.IsBackingMem() };
+			pSubAlloc->alloc->Deallocate(Move(subMem));
+			release = pSubAlloc->numAllocs.FetchSub(1) == 1 && pSubAlloc != m_pCurrent.Load();
+		}
+		m_numReaders.FetchSub(1);
 
-				alloc->Deallocate(Move(mem));
+		if (release)
+			TryRelease(pSubAlloc);
 
 #if ENABLE_ALLOC_STATS
-				usize newMemUse, newOverhead;
-				alloc->GetAllocStats().GetCurStats(newMemUse, _, newOverhead, _);
-				m_stats.AddAlloc(oldMemUse - newMemUse, oldOverhead - newOverhead, mem.IsBackingMem());
+		m_stats.RemoveAlloc(mem.Size(), 0, mem.IsBackingMem());
 #endif
-
-				break;
-			}
-		}
 	}
 
 	template <ExtendableAlloc Alloc>
 	bool ExpandableArena<Alloc>::OwnsInternal(const MemRef<u8>& mem) noexcept
 	{
-		Threading::Lock lock{ m_mutex };
-		for (Unique<Alloc>& subAlloc : m_allocs)
+		m_numReaders.FetchAdd(1);
+		const bool owns = Find(m_pIndex.Load(), mem.Ptr()) != nullptr;
+		m_numReaders.FetchSub(1);
+		return owns;
+	}
+
+	template<ExtendableAlloc Alloc>
+	auto ExpandableArena<Alloc>::TryAllocate(SubAlloc* pSubAlloc, usize size, u16 align) noexcept -> MemRef<u8>
+	{
+		// Count the allocation before it is made, so the sub-allocator can't be released while allocating from it
+		if (pSubAlloc->numAllocs.FetchAdd(1) & ReleasedFlag)
 		{
-			if (subAlloc->Owns(mem))
-				return true;
+			pSubAlloc->numAllocs.FetchSub(1);
+			return nullptr;
 		}
-		return false;
+
+		MemRef<u8> mem = pSubAlloc->alloc->template Allocate<u8>(size, align);
+		if (!mem)
+			pSubAlloc->numAllocs.FetchSub(1);
+		return mem;
+	}
+
+	template<ExtendableAlloc Alloc>
+	auto ExpandableArena<Alloc>::Find(Index* pIndex, const u8* ptr) noexcept -> SubAlloc*
+	{
+		// Find the last sub-allocator that starts at or before the pointer
+		const DynArray<SubAlloc*>& subAllocs = pIndex->subAllocs;
+		usize low = 0;
+		usize high = subAllocs.Size();
+		while (low < high)
+		{
+			const usize mid = (low + high) / 2;
+			if (subAllocs[mid]->pBegin <= ptr)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		if (!low)
+			return nullptr;
+		SubAlloc* pSubAlloc = subAllocs[low - 1];
+		return ptr < pSubAlloc->pEnd ? pSubAlloc : nullptr;
+	}
+
+	template<ExtendableAlloc Alloc>
+	void ExpandableArena<Alloc>::TryRelease(SubAlloc* pSubAlloc) noexcept
+	{
+		Threading::Lock lock{ m_mutex };
+
+		// The sub-allocator could already have been released by another thread, so only use the pointer after it's found in the list
+		usize idx = 0;
+		while (idx < m_subAllocs.Size() && m_subAllocs[idx].Get() != pSubAlloc)
+			++idx;
+		if (idx == m_subAllocs.Size() || pSubAlloc == m_pCurrent.Load())
+			return;
+
+		// Fails when another thread started allocating from the sub-allocator in the meantime
+		usize expected = 0;
+		if (!pSubAlloc->numAllocs.CompareExchangeStrong(expected, ReleasedFlag))
+			return;
+
+		Unique<Index> index = Unique<Index>::CreateWithAlloc(*m_backingAlloc, DynArray<SubAlloc*>{ m_index->subAllocs, *m_backingAlloc });
+		index->subAllocs.Erase(pSubAlloc, true);
+
+		m_retiredSubAllocs.Add(m_subAllocs.Extract(idx));
+		Publish(Move(index));
+	}
+
+	template<ExtendableAlloc Alloc>
+	void ExpandableArena<Alloc>::Publish(Unique<Index>&& index) noexcept
+	{
+		m_pIndex.Store(index.Get());
+		m_retiredIndices.Add(Move(m_index));
+		m_index = Move(index);
+		Reclaim();
+	}
+
+	template<ExtendableAlloc Alloc>
+	void ExpandableArena<Alloc>::Reclaim() noexcept
+	{
+		// Readers register themselves before loading the index, so when there are no readers, any new reader will see the published index
+		if (m_numReaders.Load())
+			return;
+
+		m_retiredIndices.Clear();
+		m_retiredSubAllocs.Clear();
 	}
 }
@@ -5,7 +5,9 @@ namespace Onca::Alloc
 {
 	/**
 	 * An allocator that can fallback to another allocator if the main allcoator fails to allocate
-	 * \tparam MainAlloc Main allocator type
+	 *
+	 * Memory is handed out as owned by the arena, deallocations are forwarded to the main allocator when it owns the address, otherwise to the fallback allocator.
+	 * \tparam MainAlloc Main allocator type, needs to be able to tell whether it owns an allocation by its address
 	 * \tparam FallbackAlloc Allocator type to use when the main allocator is out of memory
 	 */
 	template<ImplementsIAllocator MainAlloc, ImplementsIAllocator FallbackAlloc>
@@ -23,8 +25,16 @@ namespace Onca::Alloc
 	protected:
 		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
 
 	private:
+		/**
+		 * Check if the main allocator owns an allocation
+		 * \param[in] mem MemRef to check
+		 * \return Whether the main allocator owns the allocation
+		 */
+		auto MainOwns(const MemRef<u8>& mem) noexcept -> bool;
+
 		MainAlloc     m_main;     ///< Main allocator
 		FallbackAlloc m_fallback; ///< Fallback allocator
 	};
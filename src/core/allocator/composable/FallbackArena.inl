@@ -30,6 +30,7 @@ namespace Onca::Alloc
 			m_stats.AddAlloc(newMemUse - oldMemUse, newOverhead - oldOverhead, isBacking);
 #endif
 
+			mem.SetAlloc(this);
 			return mem;
 		}
 			
@@ -46,19 +47,22 @@ namespace Onca::Alloc
 		m_stats.AddAlloc(newMemUse - oldMemUse, newOverhead - oldOverhead, isBacking);
 #endif
 
+		if (mem)
+			mem.SetAlloc(this);
 		return mem;
 	}
 
 	template <ImplementsIAllocator MainAlloc, ImplementsIAllocator Fallback>
 	void FallbackArena<MainAlloc, Fallback>::DeallocateRaw(MemRef<u8>&& mem) noexcept
 	{
-		if (m_main.Owns(mem))
+		if (MainOwns(mem))
 		{
 #if ENABLE_ALLOC_STATS
 			usize _, oldMemUse, oldOverhead;
 			m_main.GetAllocStats().GetCurStats(oldMemUse, _, oldOverhead, _);
 #endif
 
+			mem.SetAlloc(&m_main);
 			m_main.Deallocate(Move(mem));
 
 #if ENABLE_ALLOC_STATS
@@ -74,6 +78,7 @@ namespace Onca::Alloc
 			m_fallback.GetAllocStats().GetCurStats(oldMemUse, _, oldOverhead, _);
 #endif
 
+			mem.SetAlloc(&m_fallback);
 			m_fallback.Deallocate(Move(mem));
 
 #if ENABLE_ALLOC_STATS
@@ -83,4 +88,21 @@ namespace Onca::Alloc
 #endif
 		}
 	}
+
+	template <ImplementsIAllocator MainAlloc, ImplementsIAllocator Fallback>
+	auto FallbackArena<MainAlloc, Fallback>::OwnsInternal(const MemRef<u8>& mem) noexcept -> bool
+	{
+		MemRef<u8> ref = mem;
+		ref.SetAlloc(&m_fallback);
+		return MainOwns(mem) || m_fallback.Owns(ref);
+	}
+
+	template <ImplementsIAllocator MainAlloc, ImplementsIAllocator Fallback>
+	auto FallbackArena<MainAlloc, Fallback>::MainOwns(const MemRef<u8>& mem) noexcept -> bool
+	{
+		// The memory is owned by the arena, so the main allocator can only recognize it by its address
+		MemRef<u8> ref = mem;
+		ref.SetAlloc(&m_main);
+		return m_main.Owns(ref);
+	}
 }
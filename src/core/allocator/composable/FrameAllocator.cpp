@@ -0,0 +1,356 @@
+#include "FrameAllocator.h"
+
+namespace Onca::Alloc
+{
+	namespace Detail
+	{
+		/**
+		 * Header in front of every frame allocation, used to validate deallocations
+		 */
+		struct FrameAllocHeader
+		{
+			u64 frame; ///< Frame the memory was allocated in
+			u64 magic; ///< Magic value identifying frame memory
+		};
+
+		constexpr u64 FrameAllocMagic = 0x434F4C4C414D5246; // "FRMALLOC"
+		constexpr u8 FrameAllocExpiredPattern = 0xFD;
+
+#if ENABLE_ASSERT
+		constexpr usize FrameAllocHeaderSize = sizeof(FrameAllocHeader);
+#else
+		constexpr usize FrameAllocHeaderSize = 0;
+#endif
+
+		auto GetFrameAllocThreadId() noexcept -> u32
+		{
+			static Atomic<u32> s_nextId{ 0 };
+			thread_local u32 t_id = s_nextId.FetchAdd(1, MemOrder::Relaxed) + 1;
+			return t_id;
+		}
+
+		auto AlignPtr(u8* ptr, usize align) noexcept -> u8*
+		{
+			return reinterpret_cast<u8*>((reinterpret_cast<usize>(ptr) + align - 1) & ~(align - 1));
+		}
+	}
+
+	FrameAllocator::Scope::Scope(FrameAllocator& alloc) noexcept
+		: m_alloc(alloc)
+		, m_pState(alloc.GetThreadState())
+		, m_frame(0)
+		, m_pBlock(nullptr)
+		, m_pHead(nullptr)
+		, m_pLarge(nullptr)
+	{
+		// Memory in the shared state can be allocated by other threads during the scope, so it can't be rewound
+		if (!m_pState)
+			return;
+
+		Buffer& buffer = alloc.GetBuffer(*m_pState);
+		m_frame = buffer.frame;
+		m_pBlock = buffer.pCur;
+		m_pHead = buffer.pHead;
+		m_pLarge = buffer.pLarge;
+	}
+
+	FrameAllocator::Scope::~Scope() noexcept
+	{
+		if (!m_pState)
+			return;
+
+		// When the buffer was reset in the meantime, the memory of the scope is already gone
+		Buffer& buffer = m_pState->buffers[m_frame % m_alloc.m_numFrames];
+		if (buffer.frame != m_frame)
+			return;
+
+		m_alloc.ReleaseBlocks(buffer.pLarge, m_pLarge);
+		buffer.pLarge = m_pLarge;
+
+		if (m_pBlock)
+		{
+			buffer.pCur = m_pBlock;
+			buffer.pHead = m_pHead;
+			buffer.pEnd = m_pBlock->mem.Ptr() + m_pBlock->mem.Size();
+		}
+		else
+		{
+			buffer.pCur = nullptr;
+			buffer.pHead = nullptr;
+			buffer.pEnd = nullptr;
+		}
+	}
+
+	FrameAllocator::FrameAllocator(IAllocator* pBackingAlloc, usize blockSize, u32 numFrames) noexcept
+		: m_pBackingAlloc(pBackingAlloc)
+		, m_blockSize(blockSize)
+		, m_numFrames(numFrames)
+		, m_frame(0)
+		, m_numBlocks(0)
+	{
+		ASSERT(numFrames >= 1 && numFrames <= MaxFrames, "Invalid number of frames");
+		ASSERT(blockSize > sizeof(Block) + Detail::FrameAllocHeaderSize, "Block size is too small");
+
+		m_states = pBackingAlloc->Allocate<ThreadState>(sizeof(ThreadState) * (MaxThreads + 1), alignof(ThreadState));
+		ASSERT(m_states.IsValid(), "Failed to allocate frame allocator thread states");
+		for (u32 i = 0; i <= MaxThreads; ++i)
+		{
+			ThreadState* pState = new (m_states.Ptr() + i) ThreadState{};
+			pState->owner.Store(0, MemOrder::Relaxed);
+		}
+	}
+
+	FrameAllocator::~FrameAllocator() noexcept
+	{
+		if (!m_states.IsValid())
+			return;
+
+		for (u32 i = 0; i <= MaxThreads; ++i)
+		{
+			ThreadState& state = m_states.Ptr()[i];
+			for (Buffer& buffer : state.buffers)
+			{
+				ReleaseBlocks(buffer.pFirst);
+				ReleaseBlocks(buffer.pLarge);
+			}
+			state.~ThreadState();
+		}
+		m_states.Dealloc();
+	}
+
+	void FrameAllocator::NextFrame() noexcept
+	{
+		m_frame.FetchAdd(1, MemOrder::AcqRel);
+	}
+
+	auto FrameAllocator::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
+#if ENABLE_ASSERT
+		align = Math::Max(align, u16(alignof(Detail::FrameAllocHeader)));
+#endif
+
+		u8* ptr;
+		u64 frame;
+		if (ThreadState* pState = GetThreadState()) LIKELY
+		{
+			Buffer& buffer = GetBuffer(*pState);
+			frame = buffer.frame;
+			ptr = AllocateFromBuffer(buffer, size, align);
+		}
+		else
+		{
+			Threading::Lock lock{ m_sharedMutex };
+			Buffer& buffer = GetBuffer(m_states.Ptr()[MaxThreads]);
+			frame = buffer.frame;
+			ptr = AllocateFromBuffer(buffer, size, align);
+		}
+
+		if (!ptr) UNLIKELY
+			return nullptr;
+
+#if ENABLE_ASSERT
+		Detail::FrameAllocHeader* pHeader = reinterpret_cast<Detail::FrameAllocHeader*>(ptr - sizeof(Detail::FrameAllocHeader));
+		pHeader->frame = frame;
+		pHeader->magic = Detail::FrameAllocMagic;
+#else
+		UNUSED(frame);
+#endif
+
+#if ENABLE_ALLOC_STATS
+		m_stats.AddAlloc(size, Detail::FrameAllocHeaderSize, isBacking);
+#endif
+
+		return { ptr, this, Math::Log2(align), size, isBacking };
+	}
+
+	void FrameAllocator::DeallocateRaw(MemRef<u8>&& mem) noexcept
+	{
+		// Frame memory is released in bulk, so only validate the deallocation
+#if ENABLE_ASSERT
+		const Detail::FrameAllocHeader* pHeader = reinterpret_cast<const Detail::FrameAllocHeader*>(mem.Ptr() - sizeof(Detail::FrameAllocHeader));
+		ASSERT(pHeader->magic == Detail::FrameAllocMagic, "Memory was not allocated by a frame allocator, or its buffer was already reused");
+		ASSERT(pHeader->frame + m_numFrames > GetFrame(), "Frame memory was deallocated after it expired");
+#endif
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), Detail::FrameAllocHeaderSize, mem.IsBackingMem());
+#else
+		UNUSED(mem);
+#endif
+	}
+
+	auto FrameAllocator::OwnsInternal(const MemRef<u8>& mem) noexcept -> bool
+	{
+		auto ownedByState = [&mem](const ThreadState& state) -> bool
+		{
+			const u8* ptr = mem.Ptr();
+			for (const Buffer& buffer : state.buffers)
+			{
+				const Block* heads[] = { buffer.pFirst, buffer.pLarge };
+				for (const Block* pBlock : heads)
+				{
+					for (; pBlock; pBlock = pBlock->pNext)
+					{
+						if (ptr >= pBlock->mem.Ptr() && ptr < pBlock->mem.Ptr() + pBlock->mem.Size())
+							return true;
+					}
+				}
+			}
+			return false;
+		};
+
+		// Other threads' states are never walked, their block chains are modified without any synchronization
+		if (ThreadState* pState = GetThreadState(); pState && ownedByState(*pState))
+			return true;
+
+		Threading::Lock lock{ m_sharedMutex };
+		return ownedByState(m_states.Ptr()[MaxThreads]);
+	}
+
+	auto FrameAllocator::TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		// Only the last allocation made by the calling thread in the current frame can grow
+		ThreadState* pState = GetThreadState();
+		if (!pState)
+			return false;
+
+		const u64 frame = GetFrame();
+		Buffer& buffer = pState->buffers[frame % m_numFrames];
+		u8* ptr = mem.Ptr();
+		if (buffer.frame != frame || ptr + mem.Size() != buffer.pHead || ptr + newSize > buffer.pEnd)
+			return false;
+
+		buffer.pHead = ptr + newSize;
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), Detail::FrameAllocHeaderSize, mem.IsBackingMem());
+		m_stats.AddAlloc(newSize, Detail::FrameAllocHeaderSize, mem.IsBackingMem());
+#endif
+		return true;
+	}
+
+	auto FrameAllocator::GetThreadState() noexcept -> ThreadState*
+	{
+		const u32 id = Detail::GetFrameAllocThreadId();
+		ThreadState& state = m_states.Ptr()[(id - 1) % MaxThreads];
+
+		u32 owner = state.owner.Load(MemOrder::Relaxed);
+		if (owner == id) LIKELY
+			return &state;
+		if (!owner && state.owner.CompareExchangeStrong(owner, id, MemOrder::Relaxed))
+			return &state;
+		return nullptr;
+	}
+
+	auto FrameAllocator::GetBuffer(ThreadState& state) noexcept -> Buffer&
+	{
+		const u64 frame = m_frame.Load(MemOrder::Acquire);
+		Buffer& buffer = state.buffers[frame % m_numFrames];
+		if (buffer.frame != frame) UNLIKELY
+		{
+			ResetBuffer(buffer);
+			buffer.frame = frame;
+		}
+		return buffer;
+	}
+
+	auto FrameAllocator::AllocateFromBuffer(Buffer& buffer, usize size, u16 align) noexcept -> u8*
+	{
+		for (;;)
+		{
+			if (buffer.pCur) LIKELY
+			{
+				u8* ptr = Detail::AlignPtr(buffer.pHead + Detail::FrameAllocHeaderSize, align);
+				if (ptr + size <= buffer.pEnd) LIKELY
+				{
+					buffer.pHead = ptr + size;
+					return ptr;
+				}
+			}
+
+			// Allocations that don't fit in an empty block get a dedicated block, which is released when the buffer is reset
+			const usize requiredSize = sizeof(Block) + Detail::FrameAllocHeaderSize + align + size;
+			if (requiredSize > m_blockSize)
+			{
+				Block* pBlock = AllocateBlock(requiredSize);
+				if (!pBlock)
+					return nullptr;
+
+				pBlock->pNext = buffer.pLarge;
+				buffer.pLarge = pBlock;
+				return Detail::AlignPtr(reinterpret_cast<u8*>(pBlock) + sizeof(Block) + Detail::FrameAllocHeaderSize, align);
+			}
+
+			Block* pNext = buffer.pCur ? buffer.pCur->pNext : buffer.pFirst;
+			if (!pNext)
+			{
+				pNext = AllocateBlock(m_blockSize);
+				if (!pNext)
+					return nullptr;
+
+				if (buffer.pCur)
+					buffer.pCur->pNext = pNext;
+				else
+					buffer.pFirst = pNext;
+			}
+			SetCurrentBlock(buffer, pNext);
+		}
+	}
+
+	auto FrameAllocator::AllocateBlock(usize size) noexcept -> Block*
+	{
+		MemRef<u8> mem = m_pBackingAlloc->Allocate<u8>(size, alignof(Block), true);
+		if (!mem)
+			return nullptr;
+
+		m_numBlocks.FetchAdd(1, MemOrder::Relaxed);
+		u8* ptr = mem.Ptr();
+		return new (ptr) Block{ .mem = Move(mem), .pNext = nullptr };
+	}
+
+	void FrameAllocator::ReleaseBlocks(Block* pBlock, Block* pLast) noexcept
+	{
+		while (pBlock != pLast)
+		{
+			Block* pNext = pBlock->pNext;
+			MemRef<u8> mem = Move(pBlock->mem);
+			pBlock->~Block();
+			mem.Dealloc();
+			m_numBlocks.FetchSub(1, MemOrder::Relaxed);
+			pBlock = pNext;
+		}
+	}
+
+	void FrameAllocator::SetCurrentBlock(Buffer& buffer, Block* pBlock) noexcept
+	{
+		buffer.pCur = pBlock;
+		buffer.pHead = pBlock ? reinterpret_cast<u8*>(pBlock) + sizeof(Block) : nullptr;
+		buffer.pEnd = pBlock ? pBlock->mem.Ptr() + pBlock->mem.Size() : nullptr;
+	}
+
+	void FrameAllocator::ResetBuffer(Buffer& buffer) noexcept
+	{
+#if ENABLE_ASSERT
+		// Fill the expired memory, so any use of it is easier to notice
+		for (Block* pBlock = buffer.pFirst; pBlock; pBlock = pBlock->pNext)
+		{
+			u8* pBegin = reinterpret_cast<u8*>(pBlock) + sizeof(Block);
+			u8* pEnd = pBlock == buffer.pCur ? buffer.pHead : pBlock->mem.Ptr() + pBlock->mem.Size();
+			MemSet(pBegin, Detail::FrameAllocExpiredPattern, usize(pEnd - pBegin));
+			if (pBlock == buffer.pCur)
+				break;
+		}
+#endif
+
+		// Blocks that weren't needed during the last frame of the buffer are released, so a single spike doesn't keep its memory alive
+		Block*& pUnused = buffer.pCur ? buffer.pCur->pNext : buffer.pFirst;
+		ReleaseBlocks(pUnused);
+		pUnused = nullptr;
+
+		ReleaseBlocks(buffer.pLarge);
+		buffer.pLarge = nullptr;
+
+		SetCurrentBlock(buffer, buffer.pFirst);
+	}
+}
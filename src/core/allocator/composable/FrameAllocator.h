@@ -0,0 +1,184 @@
+#pragma once
+#include "core/allocator/IAllocator.h"
+#include "core/utils/Atomic.h"
+
+namespace Onca::Alloc
+{
+	/**
+	 * \brief An allocator handing out per-thread linear memory that is released in bulk at frame boundaries (threadsafe)
+	 *
+	 * Each thread allocates from its own chain of linear blocks, taken from the backing allocator, so allocating never contends with other threads.
+	 * Every thread has a buffer per frame in flight, memory allocated during a frame stays valid until the same buffer is reused, i.e. for 'numFrames' frames.
+	 * A buffer is reset lazily, when the thread first allocates from it in a new frame, the blocks are kept around to be reused, only dedicated blocks for oversized allocations are released.
+	 * Nested scopes of temporary memory can be rewound early with a FrameAllocator::Scope.
+	 *
+	 * Deallocating frame memory does nothing, which allows existing containers to use the allocator, e.g. via a ScopedGlobalAlloc.
+	 * When asserts are enabled, each allocation is tagged with the frame it was allocated in,
+	 * which is used to catch deallocations of memory that was not allocated by the allocator or that outlived its frames, and expired memory is filled with a pattern.
+	 *
+	 * \note Threads are spread over 'MaxThreads' slots, a thread finding its slot taken by another thread shares a set of buffers guarded by a mutex
+	 * \note Ownership can only be checked for memory allocated by the calling thread
+	 */
+	class CORE_API FrameAllocator final : public IAllocator
+	{
+	private:
+		struct Block;
+		struct ThreadState;
+
+	public:
+		static constexpr u32 MaxThreads = 64;
+		static constexpr u32 MaxFrames  = 3;
+
+		/**
+		 * RAII scope rewinding the calling thread's frame memory when it ends
+		 * \note Any memory allocated by the calling thread during the scope may not be used after the scope ended
+		 */
+		class CORE_API Scope
+		{
+		public:
+			/**
+			 * Start a scope
+			 * \param[in] alloc Frame allocator
+			 */
+			explicit Scope(FrameAllocator& alloc) noexcept;
+			~Scope() noexcept;
+
+			DISABLE_COPY(Scope);
+			DISABLE_MOVE(Scope);
+
+		private:
+			FrameAllocator& m_alloc;   ///< Frame allocator
+			ThreadState*    m_pState;  ///< State of the calling thread, nullptr if the thread uses the shared state
+			u64             m_frame;   ///< Frame the scope started in
+			Block*          m_pBlock;  ///< Block the scope started in
+			u8*             m_pHead;   ///< Head the scope started at
+			Block*          m_pLarge;  ///< First dedicated block when the scope started
+		};
+
+		/**
+		 * Create a frame allocator
+		 * \param[in] pBackingAlloc Allocator used to allocate blocks
+		 * \param[in] blockSize Size of a block, allocations not fitting in a block get a dedicated block
+		 * \param[in] numFrames Number of frames memory stays valid for (1 to MaxFrames)
+		 */
+		FrameAllocator(IAllocator* pBackingAlloc, usize blockSize = 64_KiB, u32 numFrames = 2) noexcept;
+		~FrameAllocator() noexcept override;
+
+		DISABLE_COPY(FrameAllocator);
+		DISABLE_MOVE(FrameAllocator);
+
+		/**
+		 * Move to the next frame, expiring memory allocated 'numFrames' frames ago
+		 * \note Threads may not use memory from the expired frame after this call
+		 */
+		void NextFrame() noexcept;
+
+		/**
+		 * Get the current frame
+		 * \return Current frame
+		 */
+		auto GetFrame() const noexcept -> u64 { return m_frame.Load(MemOrder::Relaxed); }
+		/**
+		 * Get the number of frames memory stays valid for
+		 * \return Number of frames
+		 */
+		auto GetNumFrames() const noexcept -> u32 { return m_numFrames; }
+		/**
+		 * Get the number of blocks allocated from the backing allocator that are currently alive
+		 * \return Number of blocks
+		 */
+		auto GetNumBlocks() const noexcept -> usize { return m_numBlocks.Load(MemOrder::Relaxed); }
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		/**
+		 * Check if memory was allocated by the calling thread, or by any thread using the shared state
+		 * \param[in] mem Memory to check
+		 * \return Whether the memory is owned by the calling thread's state or the shared state
+		 * \note Memory allocated by another thread with its own slot is reported as not owned, as that thread's blocks can change at any time
+		 */
+		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
+		auto TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool override;
+
+	private:
+		/**
+		 * Header at the start of each block
+		 */
+		struct Block
+		{
+			MemRef<u8> mem;   ///< Memory of the block, including this header
+			Block*     pNext; ///< Next block in the chain
+		};
+
+		/**
+		 * Linear memory for a single frame in flight
+		 */
+		struct Buffer
+		{
+			Block* pFirst; ///< First block
+			Block* pCur;   ///< Block currently allocated from
+			u8*    pHead;  ///< First unused byte in the current block
+			u8*    pEnd;   ///< End of the current block
+			Block* pLarge; ///< Dedicated blocks for oversized allocations
+			u64    frame;  ///< Frame the buffer was last used in
+		};
+
+		struct alignas(64) ThreadState
+		{
+			Atomic<u32> owner;              ///< Id of the thread owning the state, 0 when unowned
+			Buffer      buffers[MaxFrames]; ///< Buffers per frame in flight
+		};
+
+		/**
+		 * Get the state owned by the calling thread
+		 * \return State, or nullptr if the thread has to use the shared state
+		 */
+		auto GetThreadState() noexcept -> ThreadState*;
+		/**
+		 * Get the buffer of a state for the current frame, resetting it when it was last used in an earlier frame
+		 * \param[in] state Thread state
+		 * \return Buffer
+		 */
+		auto GetBuffer(ThreadState& state) noexcept -> Buffer&;
+		/**
+		 * Allocate memory from a buffer
+		 * \param[in] buffer Buffer
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 * \return Pointer to the allocated memory, or nullptr if the backing allocator is out of memory
+		 */
+		auto AllocateFromBuffer(Buffer& buffer, usize size, u16 align) noexcept -> u8*;
+		/**
+		 * Allocate a new block from the backing allocator
+		 * \param[in] size Size of the block
+		 * \return Block, or nullptr if the backing allocator is out of memory
+		 */
+		auto AllocateBlock(usize size) noexcept -> Block*;
+		/**
+		 * Release a chain of blocks
+		 * \param[in] pBlock First block in the chain
+		 * \param[in] pLast Block at which to stop releasing
+		 */
+		void ReleaseBlocks(Block* pBlock, Block* pLast = nullptr) noexcept;
+		/**
+		 * Make the start of a block the head of the buffer
+		 * \param[in] buffer Buffer
+		 * \param[in] pBlock Block
+		 */
+		static void SetCurrentBlock(Buffer& buffer, Block* pBlock) noexcept;
+		/**
+		 * Reset a buffer, keeping the regular blocks that were used during the last frame of the buffer around
+		 * \param[in] buffer Buffer
+		 */
+		void ResetBuffer(Buffer& buffer) noexcept;
+
+		IAllocator*         m_pBackingAlloc; ///< Allocator used to allocate blocks
+		usize               m_blockSize;     ///< Size of a regular block
+		u32                 m_numFrames;     ///< Number of frames in flight
+		Atomic<u64>         m_frame;         ///< Current frame
+		Atomic<usize>       m_numBlocks;     ///< Number of live blocks
+		MemRef<ThreadState> m_states;        ///< Per-thread states, followed by the shared state
+		Threading::Mutex    m_sharedMutex;   ///< Mutex guarding the shared state
+	};
+}
@@ -0,0 +1,50 @@
+#include "NumaAllocRegistry.h"
+
+namespace Onca::Alloc
+{
+	namespace Detail
+	{
+		thread_local u32 t_numaNode = 0;
+	}
+
+	NumaAllocRegistry::NodeAllocs::NodeAllocs(u32 memNode, usize reserveSize) noexcept
+		: pageAlloc(memNode)
+		, alloc(&pageAlloc, reserveSize, memNode)
+	{
+	}
+
+	NumaAllocRegistry::NumaAllocRegistry(const NumaTopology& topology, usize reserveSize) noexcept
+		: m_nodes(topology.GetNumNodes())
+	{
+		for (u32 i = 0; i < topology.GetNumNodes(); ++i)
+			m_nodes.Add(Unique<NodeAllocs>::Create(topology.GetNode(i).memNode, reserveSize));
+	}
+
+	auto NumaAllocRegistry::GetNodeAlloc(u32 node) noexcept -> IAllocator&
+	{
+		ASSERT(node < m_nodes.Size(), "Node index out of range");
+		return m_nodes[node]->alloc;
+	}
+
+	auto NumaAllocRegistry::GetPageAlloc(u32 node) noexcept -> NumaAllocator&
+	{
+		ASSERT(node < m_nodes.Size(), "Node index out of range");
+		return m_nodes[node]->pageAlloc;
+	}
+
+	auto NumaAllocRegistry::GetCurrentNodeAlloc() noexcept -> IAllocator&
+	{
+		const u32 node = Detail::t_numaNode;
+		return GetNodeAlloc(node < m_nodes.Size() ? node : 0);
+	}
+
+	void NumaAllocRegistry::SetCurrentNode(u32 node) noexcept
+	{
+		Detail::t_numaNode = node;
+	}
+
+	auto NumaAllocRegistry::GetCurrentNode() noexcept -> u32
+	{
+		return Detail::t_numaNode;
+	}
+}
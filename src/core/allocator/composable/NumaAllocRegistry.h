@@ -0,0 +1,77 @@
+#pragma once
+#include "core/allocator/primitives/NumaAllocator.h"
+#include "core/allocator/primitives/SlabAllocator.h"
+#include "core/containers/DynArray.h"
+#include "core/memory/Unique.h"
+#include "core/platform/NumaTopology.h"
+
+namespace Onca::Alloc
+{
+	/**
+	 * \brief Registry of node-local allocators, with one set of allocators per node in a NUMA topology
+	 *
+	 * Each node gets a NumaAllocator, handing out whole pages on the node, and a general purpose SlabAllocator that commits its slabs on the node and uses the page allocator for large allocations.
+	 * Threads can mark which node they run on, so code that is not aware of the topology can still find the allocator local to it.
+	 */
+	class CORE_API NumaAllocRegistry
+	{
+	public:
+		/**
+		 * Create a registry with the allocators for each node in a topology
+		 * \param[in] topology NUMA topology
+		 * \param[in] reserveSize Size of the address range reserved for the slabs of each node
+		 */
+		explicit NumaAllocRegistry(const NumaTopology& topology, usize reserveSize = 16_GiB) noexcept;
+
+		DISABLE_COPY(NumaAllocRegistry);
+		DISABLE_MOVE(NumaAllocRegistry);
+
+		/**
+		 * Get the general purpose allocator of a node
+		 * \param[in] node Index of the node in the topology
+		 * \return Allocator
+		 */
+		auto GetNodeAlloc(u32 node) noexcept -> IAllocator&;
+		/**
+		 * Get the page allocator of a node
+		 * \param[in] node Index of the node in the topology
+		 * \return Page allocator
+		 */
+		auto GetPageAlloc(u32 node) noexcept -> NumaAllocator&;
+		/**
+		 * Get the general purpose allocator of the node the current thread is marked to run on
+		 * \return Allocator
+		 */
+		auto GetCurrentNodeAlloc() noexcept -> IAllocator&;
+		/**
+		 * Get the number of nodes
+		 * \return Number of nodes
+		 */
+		auto GetNumNodes() const noexcept -> u32 { return u32(m_nodes.Size()); }
+
+		/**
+		 * Mark the node the current thread runs on
+		 * \param[in] node Index of the node in the topology
+		 */
+		static void SetCurrentNode(u32 node) noexcept;
+		/**
+		 * Get the node the current thread is marked to run on
+		 * \return Index of the node in the topology, 0 if the thread was never marked
+		 */
+		static auto GetCurrentNode() noexcept -> u32;
+
+	private:
+		/**
+		 * Allocators of a node
+		 */
+		struct NodeAllocs
+		{
+			NodeAllocs(u32 memNode, usize reserveSize) noexcept;
+
+			NumaAllocator pageAlloc; ///< Page allocator
+			SlabAllocator alloc;     ///< General purpose allocator
+		};
+
+		DynArray<Unique<NodeAllocs>> m_nodes; ///< Allocators for each node
+	};
+}
@@ -25,6 +25,7 @@ namespace Onca::Alloc
 	protected:
 		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
 
 	private:
 		usize   m_bound;   ///< Boundary between allocators
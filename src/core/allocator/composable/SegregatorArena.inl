@@ -33,8 +33,28 @@ namespace Onca::Alloc
 		// TODO: Alloc stats
 
 		if (mem.Size() > m_bound)
+		{
+			mem.SetAlloc(&m_gtAlloc);
 			m_gtAlloc.Deallocate(Move(mem));
+		}
 		else
+		{
+			mem.SetAlloc(&m_leAlloc);
 			m_leAlloc.Deallocate(Move(mem));
+		}
+	}
+
+	template <ImplementsIAllocator GtAlloc, ImplementsIAllocator LeAlloc>
+	auto SegregatorAllocator<GtAlloc, LeAlloc>::OwnsInternal(const MemRef<u8>& mem) noexcept -> bool
+	{
+		// The memory is owned by the segregator, so the underlying allocators can only recognize it by its address
+		MemRef<u8> ref = mem;
+		if (mem.Size() > m_bound)
+		{
+			ref.SetAlloc(&m_gtAlloc);
+			return m_gtAlloc.Owns(ref);
+		}
+		ref.SetAlloc(&m_leAlloc);
+		return m_leAlloc.Owns(ref);
 	}
 }
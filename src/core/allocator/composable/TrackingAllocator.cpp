@@ -0,0 +1,90 @@
+#include "TrackingAllocator.h"
+#include "core/allocator/AllocTracker.h"
+
+namespace Onca::Alloc
+{
+	TrackingAllocator::TrackingAllocator(IAllocator* pAlloc, const char* pTag) noexcept
+		: m_pAlloc(pAlloc)
+		, m_pTag(pTag)
+		, m_liveBytes(0)
+		, m_liveAllocs(0)
+		, m_peakBytes(0)
+		, m_totalAllocs(0)
+	{
+		ASSERT(pAlloc, "Tracking allocator requires an underlying allocator");
+	}
+
+	auto TrackingAllocator::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+#if ENABLE_ALLOC_TRACKING
+		AllocTracker::SetCallTag(m_pTag);
+#endif
+
+		MemRef<u8> mem = m_pAlloc->Allocate<u8>(size, align, isBacking);
+		if (!mem) UNLIKELY
+			return mem;
+
+		AddLiveBytes(mem.Size());
+		m_liveAllocs.FetchAdd(1, MemOrder::Relaxed);
+		m_totalAllocs.FetchAdd(1, MemOrder::Relaxed);
+		mem.SetAlloc(this);
+		return mem;
+	}
+
+	void TrackingAllocator::DeallocateRaw(MemRef<u8>&& mem) noexcept
+	{
+		m_liveBytes.FetchSub(mem.Size(), MemOrder::Relaxed);
+		m_liveAllocs.FetchSub(1, MemOrder::Relaxed);
+		mem.SetAlloc(m_pAlloc);
+		m_pAlloc->Deallocate(Move(mem));
+	}
+
+	auto TrackingAllocator::OwnsInternal(const MemRef<u8>& mem) noexcept -> bool
+	{
+		MemRef<u8> ref = mem;
+		ref.SetAlloc(m_pAlloc);
+		return m_pAlloc->Owns(ref);
+	}
+
+	auto TrackingAllocator::TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		MemRef<u8> ref = mem;
+		ref.SetAlloc(m_pAlloc);
+		if (!m_pAlloc->TryExpandInPlace(ref, newSize))
+			return false;
+
+		if (newSize > mem.Size())
+			AddLiveBytes(newSize - mem.Size());
+		else
+			m_liveBytes.FetchSub(mem.Size() - newSize, MemOrder::Relaxed);
+		return true;
+	}
+
+	auto TrackingAllocator::ReallocateRaw(MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+#if ENABLE_ALLOC_TRACKING
+		AllocTracker::SetCallTag(m_pTag);
+#endif
+
+		const usize oldSize = mem.Size();
+		mem.SetAlloc(m_pAlloc);
+		const bool reallocated = m_pAlloc->Reallocate(mem, newSize);
+		mem.SetAlloc(this);
+		if (!reallocated)
+			return false;
+
+		if (newSize > oldSize)
+			AddLiveBytes(newSize - oldSize);
+		else
+			m_liveBytes.FetchSub(oldSize - newSize, MemOrder::Relaxed);
+		return true;
+	}
+
+	void TrackingAllocator::AddLiveBytes(usize size) noexcept
+	{
+		const usize liveBytes = m_liveBytes.FetchAdd(size, MemOrder::Relaxed) + size;
+		usize peak = m_peakBytes.Load(MemOrder::Relaxed);
+		while (peak < liveBytes && !m_peakBytes.CompareExchangeWeak(peak, liveBytes, MemOrder::Relaxed))
+			;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "core/allocator/IAllocator.h"
+#include "core/utils/Atomic.h"
+
+namespace Onca::Alloc
+{
+	/**
+	 * \brief An allocator forwarding to another allocator, while keeping track of the memory allocated through it (threadsafe)
+	 *
+	 * The allocator counts the memory that is currently allocated through it, independent of the allocation tracker,
+	 * which allows a subsystem to cheaply keep an eye on its own memory use by allocating through its own tracking allocator.
+	 * While the allocation tracker is running, all allocations made through the allocator are attributed to the allocator's tag,
+	 * taking precedence over the tag of the allocating thread.
+	 *
+	 * \note The tag needs to outlive the allocation tracker, as only its address is stored
+	 */
+	class CORE_API TrackingAllocator final : public IAllocator
+	{
+	public:
+		/**
+		 * Create a tracking allocator
+		 * \param[in] pAlloc Allocator to forward allocations to
+		 * \param[in] pTag Tag allocations are attributed to
+		 */
+		TrackingAllocator(IAllocator* pAlloc, const char* pTag) noexcept;
+
+		DISABLE_COPY(TrackingAllocator);
+		DISABLE_MOVE(TrackingAllocator);
+
+		/**
+		 * Get the tag allocations are attributed to
+		 * \return Tag
+		 */
+		auto GetTag() const noexcept -> const char* { return m_pTag; }
+		/**
+		 * Get the allocator allocations are forwarded to
+		 * \return Underlying allocator
+		 */
+		auto GetAllocator() const noexcept -> IAllocator* { return m_pAlloc; }
+
+		/**
+		 * Get the number of bytes currently allocated through the allocator
+		 * \return Live bytes
+		 */
+		auto GetLiveBytes() const noexcept -> usize { return m_liveBytes.Load(MemOrder::Relaxed); }
+		/**
+		 * Get the number of allocations currently alive
+		 * \return Live allocations
+		 */
+		auto GetLiveAllocs() const noexcept -> usize { return m_liveAllocs.Load(MemOrder::Relaxed); }
+		/**
+		 * Get the maximum number of bytes that were allocated through the allocator at the same time
+		 * \return Peak bytes
+		 */
+		auto GetPeakBytes() const noexcept -> usize { return m_peakBytes.Load(MemOrder::Relaxed); }
+		/**
+		 * Get the total number of allocations made through the allocator
+		 * \return Total allocations
+		 */
+		auto GetTotalAllocs() const noexcept -> usize { return m_totalAllocs.Load(MemOrder::Relaxed); }
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
+		auto TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool override;
+		auto ReallocateRaw(MemRef<u8>& mem, usize newSize) noexcept -> bool override;
+
+	private:
+		/**
+		 * Add bytes to the live bytes, updating the peak
+		 * \param[in] size Number of bytes
+		 */
+		void AddLiveBytes(usize size) noexcept;
+
+		IAllocator*   m_pAlloc;      ///< Underlying allocator
+		const char*   m_pTag;        ///< Tag
+		Atomic<usize> m_liveBytes;   ///< Bytes currently allocated
+		Atomic<usize> m_liveAllocs;  ///< Allocations currently alive
+		Atomic<usize> m_peakBytes;   ///< Maximum number of live bytes
+		Atomic<usize> m_totalAllocs; ///< Total number of allocations
+	};
+}
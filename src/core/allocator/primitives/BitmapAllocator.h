@@ -1,6 +1,8 @@
 #pragma once
 #include "core/allocator/IAllocator.h"
+#include "core/intrin/BitIntrin.h"
 #include "core/threading/Sync.h"
+#include "core/utils/Atomic.h"
 
 namespace Onca::Alloc
 {
@@ -12,6 +14,11 @@ namespace Onca::Alloc
 	 *
 	 * Each block's size is required to be a power of 2, as the size of the blocks also defines the maximum alignment of an allocation.
 	 *
+	 * The bitmap is stored as 64-bit words, with a summary bitmap on top of it that has 1 bit per word, which is set when the word is full.
+	 * This allows full regions of the bitmap to be skipped 4096 blocks at a time, while free runs within a word are found using bit intrinsics.
+	 * Single-block allocations and all deallocations are lock-free, multi-block allocations are serialized with a mutex, but claim their blocks atomically,
+	 * so they can run concurrently with the lock-free paths.
+	 *
 	 *     alloc 1  alloc 2  free     alloc 3  alloc 3  free     free
 	 *     v        v        v        v        v        v        v
 	 * +--------+--------+--------+--------+--------+--------+--------+
@@ -37,9 +44,13 @@ namespace Onca::Alloc
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
 
 	private:
+		static constexpr usize NumWords = (NumBlocks + 63) / 64;
+		static constexpr usize NumSummaryWords = (NumWords + 63) / 64;
+		static constexpr usize InvalidIdx = ~usize(0);
+
 		static constexpr auto CalcNumManagementBlocks() noexcept -> usize
 		{
-			const usize numManagmentBytes = (NumBlocks + 7) / 8;
+			const usize numManagmentBytes = (NumWords + NumSummaryWords) * sizeof(u64);
 			return (numManagmentBytes + BlockSize - 1) / BlockSize;
 		}
 		/**
@@ -52,16 +63,57 @@ namespace Onca::Alloc
 		}
 
 		/**
-		 * Mark bits to show the block has been used
-		 * \param[in] startIdx Index of first bit to mark
-		 * \param[in] numBlocks Number of blocks to mark
-		 * \param[in] set Whether to mark the bits as set or not
+		 * Find the first run of free bits in a word
+		 * \param[in] freeBits Free bits in the word
+		 * \param[in] numBlocks Length of the run, needs to be in the range [1, 64]
+		 * \return Index of the first bit of the run, or 64 if no run was found
+		 */
+		static constexpr auto FindRunInWord(u64 freeBits, usize numBlocks) noexcept -> u8;
+
+		/**
+		 * Allocate a single block, without locking
+		 * \return Index of the block, or InvalidIdx if no block is available
+		 */
+		auto AllocSingle() noexcept -> usize;
+		/**
+		 * Allocate a run of blocks
+		 * \param[in] numBlocks Number of blocks
+		 * \return Index of the first block, or InvalidIdx if no run is available
+		 * \note Needs to be called with the mutex locked
+		 */
+		auto AllocMultiple(usize numBlocks) noexcept -> usize;
+		/**
+		 * Try to mark a run of blocks as used
+		 * \param[in] startIdx Index of the first block
+		 * \param[in] numBlocks Number of blocks
+		 * \return Whether the blocks were marked, fails when another thread took one of the blocks in the meantime
 		 */
-		void MarkBits(usize startIdx, usize numBlocks, bool set) noexcept;
-	
-		static constexpr usize NumManagementBlocks = CalcNumManagementBlocks();                     
-	
-		Threading::Mutex m_mutex; ///< Mutex to guard bitmap modifications
+		auto ClaimRun(usize startIdx, usize numBlocks) noexcept -> bool;
+		/**
+		 * Mark a run of blocks as free
+		 * \param[in] startIdx Index of the first block
+		 * \param[in] numBlocks Number of blocks
+		 */
+		void ReleaseRun(usize startIdx, usize numBlocks) noexcept;
+		/**
+		 * Mark bits in a word as free
+		 * \param[in] wordIdx Index of the word
+		 * \param[in] mask Bits to clear
+		 * \return Value of the word before the bits were cleared
+		 */
+		auto ReleaseBits(usize wordIdx, u64 mask) noexcept -> u64;
+		/**
+		 * Mark a word as full in the summary
+		 * \param[in] wordIdx Index of the word
+		 */
+		void MarkWordFull(usize wordIdx) noexcept;
+
+		auto GetBitmap() noexcept -> Atomic<u64>* { return reinterpret_cast<Atomic<u64>*>(m_mem.Ptr()); }
+		auto GetSummary() noexcept -> Atomic<u64>* { return GetBitmap() + NumWords; }
+
+		static constexpr usize NumManagementBlocks = CalcNumManagementBlocks();
+
+		Threading::Mutex m_mutex; ///< Mutex to serialize multi-block allocations
 	};
 }
 
@@ -3,73 +3,61 @@
 #include "BitmapAllocator.h"
 #endif
 
-#include "core/memory/MemUtils.h"
-
 namespace Onca::Alloc
 {
 	template<usize BlockSize, usize NumBlocks>
 	BitmapAllocator<BlockSize, NumBlocks>::BitmapAllocator(IAllocator* pBackingAlloc) noexcept
-		: IMemBackedAllocator(pBackingAlloc->Allocate<u8>(CalcReqMemSize(), u16(BlockSize > 0x8000 ? 0x8000 : BlockSize), true))
+		: IMemBackedAllocator(pBackingAlloc->Allocate<u8>(CalcReqMemSize(), u16(BlockSize > 0x8000 ? 0x8000 : Math::Max(BlockSize, alignof(u64))), true))
 	{
 		STATIC_ASSERT(Math::IsPowOf2(BlockSize), "Blocksize needs to be a power of 2");
-		MemClear(m_mem.Ptr(), NumManagementBlocks * BlockSize);
+		STATIC_ASSERT(NumBlocks != 0, "Needs to have at least 1 block");
+
+		Atomic<u64>* pBitmap = GetBitmap();
+		for (usize i = 0; i < NumWords; ++i)
+			new (pBitmap + i) Atomic<u64>{ 0 };
+
+		// Bits past the last block are permanently marked as used, so runs never extend past the end
+		constexpr usize lastWordBits = NumBlocks % 64;
+		if constexpr (lastWordBits != 0)
+			pBitmap[NumWords - 1].Store(~0ull << lastWordBits, MemOrder::Relaxed);
+
+		Atomic<u64>* pSummary = GetSummary();
+		for (usize i = 0; i < NumSummaryWords; ++i)
+			new (pSummary + i) Atomic<u64>{ 0 };
+
+		constexpr usize lastSummaryBits = NumWords % 64;
+		if constexpr (lastSummaryBits != 0)
+			pSummary[NumSummaryWords - 1].Store(~0ull << lastSummaryBits, MemOrder::Relaxed);
 	}
-	
+
 	template<usize BlockSize, usize NumBlocks>
 	auto BitmapAllocator<BlockSize, NumBlocks>::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
 	{
 		ASSERT(align <= BlockSize, "Alignment cannot be greater than blocksize");
 		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
 
-		const usize blocksNeeded = (size + BlockSize - 1) / BlockSize;
+		const usize blocksNeeded = Math::Max((size + BlockSize - 1) / BlockSize, usize(1));
 
-		Threading::Lock lock{ m_mutex };
-		
-		const u8* pManagementInfo = m_mem.Ptr();
-		
-		for (usize i = 0; i < NumBlocks; ++i)
+		usize idx;
+		if (blocksNeeded == 1)
 		{
-			u8 startBit = u8(i & 0x07);
-			usize byteIdx = i / 8;
-			usize numBlocks = blocksNeeded;
-
-			// Up to first 8 blocks
-			const u8 firstBlockShift = u8(numBlocks >= 8 ? 0 : 8 - numBlocks);
-			u8 searchMask = u8(0xFF << firstBlockShift) >> startBit;
-			if (pManagementInfo[byteIdx] & searchMask)
-				continue;;
-
-			++byteIdx;
-
-			u8 blocksWritten = 8 - startBit;
-			numBlocks = blocksWritten >= numBlocks ? 0 : numBlocks - blocksWritten;
-
-			// If we need more blocks
-			while (numBlocks > 0)
-			{
-				const u8 curBlockShift = u8(numBlocks >= 8 ? 0 : 8 - numBlocks);
-				searchMask = u8(0xFF << curBlockShift);
-				if (pManagementInfo[byteIdx] & searchMask)
-					break;
-
-				++byteIdx;
-				numBlocks = numBlocks <= 8 ? 0 : numBlocks - 8;
-			}
+			idx = AllocSingle();
+		}
+		else
+		{
+			Threading::Lock lock{ m_mutex };
+			idx = AllocMultiple(blocksNeeded);
+		}
 
-			if (numBlocks == 0)
-			{
-				MarkBits(i, blocksNeeded, true);
+		if (idx == InvalidIdx)
+			return nullptr;
 
 #if ENABLE_ALLOC_STATS
-				const usize overhead = blocksNeeded * BlockSize - size;
-				m_stats.AddAlloc(size, overhead, isBacking);
+		const usize overhead = blocksNeeded * BlockSize - size;
+		m_stats.AddAlloc(size, overhead, isBacking);
 #endif
-				u8* ptr = m_mem.Ptr() + (i + NumManagementBlocks) * BlockSize;
-				return { ptr, this, Math::Log2(align), size, isBacking };
-			}
-		}
-
-		return nullptr;
+		u8* ptr = m_mem.Ptr() + (idx + NumManagementBlocks) * BlockSize;
+		return { ptr, this, Math::Log2(align), size, isBacking };
 	}
 
 	template<usize BlockSize, usize NumBlocks>
@@ -78,47 +66,207 @@ namespace Onca::Alloc
 		// Threadsafe as memory pointers and total allocator memory size is consistent over threads
 		const usize startIdx = (mem.Ptr() - m_mem.Ptr()) / BlockSize - NumManagementBlocks;
 		const usize size = mem.Size();
-		const usize numBlocks = (size + BlockSize - 1) / BlockSize;
+		const usize numBlocks = Math::Max((size + BlockSize - 1) / BlockSize, usize(1));
 
-		Threading::Lock lock{ m_mutex };
-		MarkBits(startIdx, numBlocks, false);
+		ReleaseRun(startIdx, numBlocks);
 
 #if ENABLE_ALLOC_STATS
 		const usize overhead = numBlocks * BlockSize - size;
 		m_stats.RemoveAlloc(size, overhead, mem.IsBackingMem());
 #endif
 	}
-	
+
+	template<usize BlockSize, usize NumBlocks>
+	constexpr auto BitmapAllocator<BlockSize, NumBlocks>::FindRunInWord(u64 freeBits, usize numBlocks) noexcept -> u8
+	{
+		// After each step, a bit is only set when it starts a run of 'len' free bits, doubling 'len' every step
+		usize len = 1;
+		while (len < numBlocks && freeBits)
+		{
+			const usize shift = Math::Min(len, numBlocks - len);
+			freeBits &= freeBits >> shift;
+			len += shift;
+		}
+		return freeBits ? Intrin::BitScanLSB(freeBits) : 64;
+	}
+
+	template<usize BlockSize, usize NumBlocks>
+	auto BitmapAllocator<BlockSize, NumBlocks>::AllocSingle() noexcept -> usize
+	{
+		Atomic<u64>* pBitmap = GetBitmap();
+		Atomic<u64>* pSummary = GetSummary();
+
+		for (usize summaryIdx = 0; summaryIdx < NumSummaryWords; ++summaryIdx)
+		{
+			u64 summary = pSummary[summaryIdx].Load(MemOrder::Acquire);
+			while (summary != ~0ull)
+			{
+				const usize summaryBit = Intrin::BitScanLSB(~summary);
+				const usize wordIdx = summaryIdx * 64 + summaryBit;
+
+				u64 word = pBitmap[wordIdx].Load(MemOrder::Relaxed);
+				while (word != ~0ull)
+				{
+					const u64 mask = 1ull << Intrin::BitScanLSB(~word);
+					const u64 prev = pBitmap[wordIdx].FetchOr(mask);
+					if (!(prev & mask))
+					{
+						if ((prev | mask) == ~0ull)
+							MarkWordFull(wordIdx);
+						return wordIdx * 64 + Intrin::BitScanLSB(mask);
+					}
+
+					// Another thread took the block first
+					word = prev | mask;
+				}
+
+				// Word was filled since the summary was read
+				summary |= 1ull << summaryBit;
+			}
+		}
+		return InvalidIdx;
+	}
+
+	template<usize BlockSize, usize NumBlocks>
+	auto BitmapAllocator<BlockSize, NumBlocks>::AllocMultiple(usize numBlocks) noexcept -> usize
+	{
+		Atomic<u64>* pBitmap = GetBitmap();
+		Atomic<u64>* pSummary = GetSummary();
+
+		usize wordIdx = 0;
+		usize runStart = 0;
+		usize runLen = 0;
+		while (wordIdx < NumWords)
+		{
+			// Skip 64 full words at once
+			if (wordIdx % 64 == 0 && pSummary[wordIdx / 64].Load(MemOrder::Relaxed) == ~0ull)
+			{
+				runLen = 0;
+				wordIdx += 64;
+				continue;
+			}
+
+			const u64 word = pBitmap[wordIdx].Load(MemOrder::Acquire);
+			if (word == ~0ull)
+			{
+				runLen = 0;
+				++wordIdx;
+				continue;
+			}
+
+			usize candidate = InvalidIdx;
+
+			// Run continuing from the previous words into the low bits of this word
+			if (!runLen)
+				runStart = wordIdx * 64;
+			const usize lowFree = word ? Intrin::BitScanLSB(word) : 64;
+			if (runLen + lowFree >= numBlocks)
+			{
+				candidate = runStart;
+			}
+			else if (!word)
+			{
+				runLen += 64;
+				++wordIdx;
+				continue;
+			}
+			else if (numBlocks <= 64)
+			{
+				// Run that fits completely inside of this word
+				const u8 bitIdx = FindRunInWord(~word, numBlocks);
+				if (bitIdx != 64)
+					candidate = wordIdx * 64 + bitIdx;
+			}
+
+			if (candidate != InvalidIdx)
+			{
+				if (ClaimRun(candidate, numBlocks))
+					return candidate;
+
+				// A concurrent single-block allocation took part of the run, so rescan the word
+				runLen = 0;
+				continue;
+			}
+
+			// Free bits at the top of the word start a new run
+			runLen = 63 - Intrin::BitScanMSB(word);
+			runStart = wordIdx * 64 + 64 - runLen;
+			++wordIdx;
+		}
+		return InvalidIdx;
+	}
+
 	template<usize BlockSize, usize NumBlocks>
-	void BitmapAllocator<BlockSize, NumBlocks>::MarkBits(usize startIdx, usize numBlocks, bool set) noexcept
+	auto BitmapAllocator<BlockSize, NumBlocks>::ClaimRun(usize startIdx, usize numBlocks) noexcept -> bool
 	{
-		u8* pManagementInfo = m_mem.Ptr();
+		Atomic<u64>* pBitmap = GetBitmap();
 
-		const u8 firstByteOffset = startIdx & 0x07;
-		if (firstByteOffset)
+		usize idx = startIdx;
+		usize remaining = numBlocks;
+		while (remaining)
 		{
-			const u8 curBlockShift = u8(numBlocks >= 8 ? 0 : 8 - numBlocks);
-			const u8 blocksWritten = 8 - firstByteOffset;
-			numBlocks = blocksWritten >= numBlocks ? 0 : numBlocks - blocksWritten;
+			const usize wordIdx = idx / 64;
+			const usize bitIdx = idx % 64;
+			const usize count = Math::Min(remaining, 64 - bitIdx);
+			const u64 mask = (count == 64 ? ~0ull : ((1ull << count) - 1)) << bitIdx;
+
+			const u64 prev = pBitmap[wordIdx].FetchOr(mask);
+			if (prev & mask)
+			{
+				// Only undo the bits set by this call, then release the words that were fully claimed before
+				ReleaseBits(wordIdx, mask & ~prev);
+				if (idx != startIdx)
+					ReleaseRun(startIdx, idx - startIdx);
+				return false;
+			}
 
-			u8 mask = u8(0xFF) << curBlockShift;
-			mask >>= firstByteOffset;
+			if ((prev | mask) == ~0ull)
+				MarkWordFull(wordIdx);
 
-			const usize byteIdx = startIdx / 8;
-			u8 curVal = pManagementInfo[byteIdx];
-			pManagementInfo[byteIdx] = set ? curVal | mask : curVal & ~mask;
-			startIdx += 8 - firstByteOffset;
+			idx += count;
+			remaining -= count;
 		}
+		return true;
+	}
 
-		for (usize i = startIdx, endIdx = startIdx + numBlocks; i < endIdx; i += 8)
+	template<usize BlockSize, usize NumBlocks>
+	void BitmapAllocator<BlockSize, NumBlocks>::ReleaseRun(usize startIdx, usize numBlocks) noexcept
+	{
+		while (numBlocks)
 		{
-			u8 curBlockShift = u8(numBlocks >= 8 ? 0 : 8 - numBlocks);
-			numBlocks -= 8;
-			u8 mask = u8(0xFF) << curBlockShift;
+			const usize wordIdx = startIdx / 64;
+			const usize bitIdx = startIdx % 64;
+			const usize count = Math::Min(numBlocks, 64 - bitIdx);
+			const u64 mask = (count == 64 ? ~0ull : ((1ull << count) - 1)) << bitIdx;
 
-			const usize byteIdx = i / 8;
-			u8 curVal = pManagementInfo[byteIdx];
-			pManagementInfo[byteIdx] = set ? curVal | mask : curVal & ~mask;
+			const u64 prev = ReleaseBits(wordIdx, mask);
+			ASSERT((prev & mask) == mask, "Releasing blocks that are not in use");
+			UNUSED(prev);
+
+			startIdx += count;
+			numBlocks -= count;
 		}
 	}
+
+	template<usize BlockSize, usize NumBlocks>
+	auto BitmapAllocator<BlockSize, NumBlocks>::ReleaseBits(usize wordIdx, u64 mask) noexcept -> u64
+	{
+		const u64 prev = GetBitmap()[wordIdx].FetchAnd(~mask);
+		if (prev == ~0ull)
+			GetSummary()[wordIdx / 64].FetchAnd(~(1ull << (wordIdx % 64)));
+		return prev;
+	}
+
+	template<usize BlockSize, usize NumBlocks>
+	void BitmapAllocator<BlockSize, NumBlocks>::MarkWordFull(usize wordIdx) noexcept
+	{
+		Atomic<u64>& summary = GetSummary()[wordIdx / 64];
+		const u64 summaryMask = 1ull << (wordIdx % 64);
+		summary.FetchOr(summaryMask);
+
+		// A block in the word could have been released before the summary bit was set, in which case the releasing thread did not see the bit to clear.
+		// All accesses involved are sequentially consistent, so either the releasing thread clears the bit, or this thread sees the released block.
+		if (GetBitmap()[wordIdx].Load() != ~0ull)
+			summary.FetchAnd(~summaryMask);
+	}
 }
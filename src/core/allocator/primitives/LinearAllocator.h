@@ -11,6 +11,7 @@ namespace Onca::Alloc
 	 * Any new allocation made on the allocator, will be appended to the end and this will happen until the entire allocator is reset,
 	 * allowing new memory to start at the beginning, but invalidating all former allocations made.
 	 * Alignment is done using padding between allocations.
+	 * The last allocation can be grown in place.
 	 *
 	 * begin                    head
 	 * v                        v
@@ -41,6 +42,7 @@ namespace Onca::Alloc
 	protected:
 		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool override;
 
 	private:
 		u8*        m_head; ///< Current location in the linear allocator
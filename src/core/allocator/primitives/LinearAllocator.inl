@@ -28,14 +28,14 @@ namespace Onca::Alloc
 		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
 
 		const usize mask = align - 1;
-		const usize diff = m_head & mask;
-		const usize padding = (align - diff) & align;
+		const usize diff = usize(m_head) & mask;
+		const usize padding = (align - diff) & mask;
 		const usize paddedSize = size + padding;
 
 		if (m_head + paddedSize > m_mem.Ptr() + m_mem.Size()) UNLIKELY
 			return nullptr;
 		
-		u8* ptr = m_head;
+		u8* ptr = m_head + padding;
 		m_head += paddedSize;
 
 #if ENABLE_ALLOC_STATS
@@ -50,4 +50,21 @@ namespace Onca::Alloc
 	{
 		UNUSED(mem);
 	}
+
+	template<usize Size, usize BaseAlignment>
+	auto LinearAllocator<Size, BaseAlignment>::TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		// Only the last allocation can be grown
+		u8* ptr = mem.Ptr();
+		if (ptr + mem.Size() != m_head || ptr + newSize > m_mem.Ptr() + m_mem.Size())
+			return false;
+
+		m_head = ptr + newSize;
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), 0, mem.IsBackingMem());
+		m_stats.AddAlloc(newSize, 0, mem.IsBackingMem());
+#endif
+		return true;
+	}
 }
@@ -1,8 +1,60 @@
 #include "Mallocator.h"
 #include <cstdlib>
 
+#if PLATFORM_WINDOWS
+#include <malloc.h>
+#endif
+
 namespace Onca::Alloc
 {
+	namespace Detail
+	{
+		/**
+		 * Align a pointer returned by malloc and store the offset to the pointer in front of the aligned memory
+		 * \param[in] ptr Pointer returned by malloc
+		 * \param[in] align Alignment
+		 * \return Aligned pointer
+		 */
+		auto AlignMallocPtr(u8* ptr, usize align) noexcept -> u8*
+		{
+			const usize mask = align - 1;
+			u8* alignedPtr = reinterpret_cast<u8*>(usize(ptr + mask) & ~mask);
+			isize diff = alignedPtr - ptr;
+			if (diff == 0)
+			{
+				alignedPtr += align;
+				diff = align;
+			}
+
+			if (diff <= 0x7F)
+			{
+				alignedPtr[-1] = u8(diff);
+			}
+			else
+			{
+				alignedPtr[-1] = (u8(diff) & 0x7F) | 0x80;
+				alignedPtr[-2] = u8(diff >> 7);
+			}
+			return alignedPtr;
+		}
+
+		/**
+		 * Get the offset of aligned memory to the pointer returned by malloc
+		 * \param[in] ptr Aligned pointer
+		 * \return Offset
+		 */
+		auto GetMallocOffset(const u8* ptr) noexcept -> usize
+		{
+			usize offset = ptr[-1];
+			if (offset & 0x80)
+			{
+				offset &= 0x7F;
+				offset |= usize(ptr[-2]) << 7;
+			}
+			return offset;
+		}
+	}
+
 	Mallocator::~Mallocator() noexcept
 	{
 	}
@@ -10,26 +62,8 @@ namespace Onca::Alloc
 	auto Mallocator::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
 	{
 		const usize allocSize = size + align;
-		const usize mask = align - 1;
-		
 		u8* ptr = static_cast<u8*>(malloc(allocSize));
-		u8* alignedPtr = reinterpret_cast<u8*>(usize(ptr + mask) & ~mask);
-		isize diff = alignedPtr - ptr;
-		if (diff == 0)
-		{
-			alignedPtr += align;
-			diff = align;
-		}
-
-		if (diff <= 0x7F)
-		{
-			alignedPtr[-1] = u8(diff);
-		}
-		else
-		{
-			alignedPtr[-1] = (u8(diff) & 0x7F) | 0x80;
-			alignedPtr[-2] = u8(diff >> 7);
-		}
+		u8* alignedPtr = Detail::AlignMallocPtr(ptr, align);
 
 #if ENABLE_ALLOC_STATS
 		m_stats.AddAlloc(size, align, isBacking);
@@ -41,14 +75,7 @@ namespace Onca::Alloc
 	void Mallocator::DeallocateRaw(MemRef<u8>&& mem) noexcept
 	{
 		u8* ptr = mem.Ptr();
-		usize offset = ptr[-1];
-		if (offset & 0x80)
-		{
-			offset &= 0x7F;
-			offset |= usize(ptr[-2]) << 7;
-		}
-
-		free(ptr - offset);
+		free(ptr - Detail::GetMallocOffset(ptr));
 
 #if ENABLE_ALLOC_STATS
 		m_stats.RemoveAlloc(mem.Size(), mem.Align(), mem.IsBackingMem());
@@ -59,4 +86,53 @@ namespace Onca::Alloc
 	{
 		return true;
 	}
+
+	auto Mallocator::TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+#if PLATFORM_WINDOWS
+		u8* ptr = mem.Ptr();
+		const usize offset = Detail::GetMallocOffset(ptr);
+		if (!_expand(ptr - offset, offset + newSize))
+			return false;
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), mem.Align(), mem.IsBackingMem());
+		m_stats.AddAlloc(newSize, mem.Align(), mem.IsBackingMem());
+#endif
+		return true;
+#else
+		UNUSED(mem);
+		UNUSED(newSize);
+		return false;
+#endif
+	}
+
+	auto Mallocator::ReallocateRaw(MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		u8* ptr = mem.Ptr();
+		const usize align = mem.Align();
+		const usize offset = Detail::GetMallocOffset(ptr);
+
+		u8* newPtr = static_cast<u8*>(realloc(ptr - offset, newSize + align));
+		if (!newPtr) UNLIKELY
+			return false;
+
+		// realloc keeps the data at the same offset, which might not be aligned anymore when the memory moved
+		const usize mask = align - 1;
+		u8* pData = newPtr + offset;
+		u8* alignedPtr = reinterpret_cast<u8*>(usize(newPtr + mask) & ~mask);
+		if (alignedPtr == newPtr)
+			alignedPtr += align;
+		if (alignedPtr != pData)
+			MemMove(alignedPtr, pData, Math::Min(mem.Size(), newSize));
+		Detail::AlignMallocPtr(newPtr, align);
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), mem.Align(), mem.IsBackingMem());
+		m_stats.AddAlloc(newSize, mem.Align(), mem.IsBackingMem());
+#endif
+
+		mem = MemRef<u8>{ alignedPtr, this, Math::Log2(align), newSize, mem.IsBackingMem() };
+		return true;
+	}
 }
@@ -5,6 +5,9 @@ namespace Onca::Alloc
 {
 	/**
 	 * \brief An allocator that uses malloc
+	 *
+	 * Reallocations use realloc, allowing the C runtime to grow the memory in place, or to remap it for large allocations.
+	 * Growing memory in place without a fallback is only supported on Windows, using _expand.
 	 */
 	class CORE_API Mallocator final : public IAllocator
 	{
@@ -17,5 +20,7 @@ namespace Onca::Alloc
 		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
 		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
+		auto TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool override;
+		auto ReallocateRaw(MemRef<u8>& mem, usize newSize) noexcept -> bool override;
 	};
 }
@@ -0,0 +1,59 @@
+#include "NumaAllocator.h"
+
+#include "core/platform/SystemInfo.h"
+
+namespace Onca::Alloc
+{
+	NumaAllocator::NumaAllocator(u32 node) noexcept
+		: m_node(node)
+	{
+	}
+
+	NumaAllocator::~NumaAllocator() noexcept
+	{
+	}
+
+	auto NumaAllocator::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+		// Ranges are aligned to the allocation granularity, which is larger than any supported alignment
+		ASSERT(align <= g_SystemInfo.GetVirtualAllocGranularity(), "Alignment is larger than the virtual allocation granularity");
+
+		const usize rangeSize = GetRangeSize(size);
+		u8* ptr = VirtualMemory::Reserve(rangeSize, false);
+		if (!ptr) UNLIKELY
+			return nullptr;
+
+		if (!VirtualMemory::CommitOnNode(ptr, rangeSize, m_node)) UNLIKELY
+		{
+			VirtualMemory::Release(ptr, rangeSize);
+			return nullptr;
+		}
+
+#if ENABLE_ALLOC_STATS
+		m_stats.AddAlloc(size, rangeSize - size, isBacking);
+#endif
+		return { ptr, this, Math::Log2(align), size, isBacking };
+	}
+
+	void NumaAllocator::DeallocateRaw(MemRef<u8>&& mem) noexcept
+	{
+		const usize rangeSize = GetRangeSize(mem.Size());
+		VirtualMemory::Release(mem.Ptr(), rangeSize);
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), rangeSize - mem.Size(), mem.IsBackingMem());
+#endif
+	}
+
+	auto NumaAllocator::OwnsInternal(const MemRef<u8>& mem) noexcept -> bool
+	{
+		UNUSED(mem);
+		return true;
+	}
+
+	auto NumaAllocator::GetRangeSize(usize size) noexcept -> usize
+	{
+		const usize granularity = g_SystemInfo.GetVirtualAllocGranularity();
+		return (size + granularity - 1) & ~(granularity - 1);
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "core/allocator/IAllocator.h"
+#include "core/platform/VirtualMemory.h"
+
+namespace Onca::Alloc
+{
+	/**
+	 * \brief An allocator that allocates pages directly from the system, with their physical memory placed on a given NUMA node (threadsafe)
+	 *
+	 * Every allocation is rounded up to the virtual allocation granularity and gets its own range of address space, so the allocator is meant to be used as a backing allocator.
+	 * As pages are only placed on the node when they are first touched, a thread on any node may initialize the memory.
+	 */
+	class CORE_API NumaAllocator final : public IAllocator
+	{
+	public:
+		/**
+		 * Create a NUMA allocator
+		 * \param[in] node NUMA node id, or VirtualMemory::NoNumaNode to not bind memory to a node
+		 */
+		explicit NumaAllocator(u32 node) noexcept;
+		NumaAllocator(NumaAllocator&&) = default;
+		~NumaAllocator() noexcept override;
+
+		/**
+		 * Get the NUMA node id the allocator places its memory on
+		 * \return NUMA node id
+		 */
+		auto GetNode() const noexcept -> u32 { return m_node; }
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
+
+	private:
+		/**
+		 * Get the size of the range an allocation uses
+		 * \param[in] size Size of the allocation
+		 * \return Size of the range
+		 */
+		static auto GetRangeSize(usize size) noexcept -> usize;
+
+		u32 m_node; ///< NUMA node id
+	};
+}
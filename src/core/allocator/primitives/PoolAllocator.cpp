@@ -0,0 +1,313 @@
+#include "PoolAllocator.h"
+
+namespace Onca::Alloc
+{
+	namespace Detail
+	{
+		auto GetPoolCacheSlot() noexcept -> u32
+		{
+			static Atomic<u32> s_nextSlot{ 0 };
+			thread_local u32 t_slot = s_nextSlot.FetchAdd(1, MemOrder::Relaxed) % PoolFreeList::MaxThreadCaches;
+			return t_slot;
+		}
+
+		PoolFreeList::PoolFreeList() noexcept
+			: m_pMem(nullptr)
+			, m_blockSize(0)
+			, m_numBlocks(0)
+			, m_threadCacheSize(0)
+			, m_head(0)
+		{
+		}
+
+		PoolFreeList::PoolFreeList(PoolFreeList&& other) noexcept
+			: m_pMem(other.m_pMem)
+			, m_blockSize(other.m_blockSize)
+			, m_numBlocks(other.m_numBlocks)
+			, m_threadCacheSize(other.m_threadCacheSize)
+			, m_head(other.m_head.Load())
+			, m_caches(Move(other.m_caches))
+		{
+			other.m_pMem = nullptr;
+			other.m_head.Store(0);
+		}
+
+		PoolFreeList::~PoolFreeList() noexcept
+		{
+			if (!m_caches.IsValid())
+				return;
+
+			for (u32 i = 0; i < MaxThreadCaches; ++i)
+				m_caches.Ptr()[i].~ThreadCache();
+			m_caches.Dealloc();
+		}
+
+		void PoolFreeList::Init(u8* pMem, usize blockSize, usize numBlocks, u32 threadCacheSize, IAllocator* pAlloc) noexcept
+		{
+			m_pMem = pMem;
+			m_blockSize = blockSize;
+			m_numBlocks = u32(numBlocks);
+			m_threadCacheSize = threadCacheSize;
+
+			if (!m_pMem)
+			{
+				m_head.Store(0);
+				return;
+			}
+
+			// Link all blocks, the last block terminates the list
+			for (u32 i = 1; i < m_numBlocks; ++i)
+				Next(i) = i + 1;
+			Next(m_numBlocks) = 0;
+			m_head.Store(1);
+
+			if (m_threadCacheSize)
+			{
+				m_caches = pAlloc->Allocate<ThreadCache>(sizeof(ThreadCache) * MaxThreadCaches, alignof(ThreadCache));
+				for (u32 i = 0; i < MaxThreadCaches; ++i)
+					new (m_caches.Ptr() + i) ThreadCache{ .inUse = false, .head = 0, .count = 0 };
+			}
+		}
+
+		auto PoolFreeList::Pop() noexcept -> u8*
+		{
+			u32 idx = 0;
+			if (ThreadCache* pCache = AcquireCache())
+			{
+				// Refill half of the cache, so the next frees don't immediately cause a flush
+				u32 count = pCache->count.Load(MemOrder::Relaxed);
+				if (!count)
+					pCache->head = PopShared(Math::Max(m_threadCacheSize / 2, 1u), count);
+
+				idx = pCache->head;
+				if (idx)
+				{
+					pCache->head = Next(idx);
+					--count;
+				}
+				pCache->count.Store(count, MemOrder::Relaxed);
+				pCache->inUse.Store(false, MemOrder::Release);
+			}
+			else
+			{
+				u32 count;
+				idx = PopShared(1, count);
+			}
+
+			// Blocks sitting in the caches of other threads are still free, so the pool is only exhausted when those are gone too
+			if (!idx && m_caches.IsValid())
+				idx = StealCached();
+
+			return idx ? m_pMem + (idx - 1) * m_blockSize : nullptr;
+		}
+
+		void PoolFreeList::Push(u8* pBlock) noexcept
+		{
+			ASSERT(pBlock >= m_pMem && pBlock < m_pMem + m_numBlocks * m_blockSize, "Block is not owned by the pool");
+			const u32 idx = u32((pBlock - m_pMem) / m_blockSize) + 1;
+
+			ThreadCache* pCache = AcquireCache();
+			if (!pCache)
+			{
+				PushShared(idx, idx);
+				return;
+			}
+
+			Next(idx) = pCache->head;
+			pCache->head = idx;
+			u32 count = pCache->count.Load(MemOrder::Relaxed) + 1;
+
+			// Flush half of the cache, so the next allocations can still be served from the cache
+			if (count > m_threadCacheSize)
+			{
+				const u32 toFlush = count / 2;
+				u32 last = pCache->head;
+				for (u32 i = 1; i < toFlush; ++i)
+					last = Next(last);
+
+				const u32 first = pCache->head;
+				pCache->head = Next(last);
+				count -= toFlush;
+				PushShared(first, last);
+			}
+			pCache->count.Store(count, MemOrder::Relaxed);
+			pCache->inUse.Store(false, MemOrder::Release);
+		}
+
+		void PoolFreeList::FlushThreadCache() noexcept
+		{
+			ThreadCache* pCache = AcquireCache();
+			if (!pCache)
+				return;
+
+			if (pCache->count.Load(MemOrder::Relaxed))
+			{
+				u32 last = pCache->head;
+				while (Next(last))
+					last = Next(last);
+
+				PushShared(pCache->head, last);
+				pCache->head = 0;
+				pCache->count.Store(0, MemOrder::Relaxed);
+			}
+			pCache->inUse.Store(false, MemOrder::Release);
+		}
+
+		auto PoolFreeList::PopShared(u32 maxCount, u32& count) noexcept -> u32
+		{
+			u64 head = m_head.Load(MemOrder::Acquire);
+			for (;;)
+			{
+				const u32 first = u32(head);
+				if (!first)
+				{
+					count = 0;
+					return 0;
+				}
+
+				// The links may be read from blocks that were taken by another thread in the meantime, so they are validated before being followed.
+				// Any such value is discarded, as the tag in the head will have changed, causing the compare-exchange to fail.
+				u32 last = first;
+				u32 numPopped = 1;
+				u32 next = Next(last);
+				while (numPopped < maxCount && next && next <= m_numBlocks)
+				{
+					last = next;
+					next = Next(last);
+					++numPopped;
+				}
+
+				const u64 newHead = (((head >> 32) + 1) << 32) | next;
+				if (m_head.CompareExchangeWeak(head, newHead, MemOrder::AcqRel))
+				{
+					Next(last) = 0;
+					count = numPopped;
+					return first;
+				}
+			}
+		}
+
+		void PoolFreeList::PushShared(u32 first, u32 last) noexcept
+		{
+			u64 head = m_head.Load(MemOrder::Relaxed);
+			u64 newHead;
+			do
+			{
+				Next(last) = u32(head);
+				newHead = (((head >> 32) + 1) << 32) | first;
+			}
+			while (!m_head.CompareExchangeWeak(head, newHead, MemOrder::AcqRel));
+		}
+
+		auto PoolFreeList::StealCached() noexcept -> u32
+		{
+			for (;;)
+			{
+				bool anyBusy = false;
+				for (u32 i = 0; i < MaxThreadCaches; ++i)
+				{
+					ThreadCache& cache = m_caches.Ptr()[i];
+					if (!cache.count.Load(MemOrder::Relaxed) && !cache.inUse.Load(MemOrder::Relaxed))
+						continue;
+
+					// A busy cache may be in the middle of a refill, so it needs to be checked again once it is released.
+					// Only a single cache is ever held at a time, so this can't deadlock with other threads doing the same.
+					if (cache.inUse.Exchange(true, MemOrder::Acquire))
+					{
+						anyBusy = true;
+						continue;
+					}
+
+					const u32 idx = cache.head;
+					if (idx)
+					{
+						// Return the rest of the cache to the shared list, so other threads running out don't need to come looking here
+						const u32 first = Next(idx);
+						if (first)
+						{
+							u32 last = first;
+							while (Next(last))
+								last = Next(last);
+							PushShared(first, last);
+						}
+						cache.head = 0;
+						cache.count.Store(0, MemOrder::Relaxed);
+					}
+					cache.inUse.Store(false, MemOrder::Release);
+
+					if (idx)
+						return idx;
+				}
+
+				// Blocks may have been flushed to the shared list while the caches were being checked
+				u32 count;
+				const u32 idx = PopShared(1, count);
+				if (idx || !anyBusy)
+					return idx;
+			}
+		}
+
+		auto PoolFreeList::AcquireCache() noexcept -> ThreadCache*
+		{
+			if (!m_caches.IsValid())
+				return nullptr;
+
+			// Slots are only shared when there are more threads than slots, in which case the shared list is used when the slot is busy
+			ThreadCache* pCache = m_caches.Ptr() + GetPoolCacheSlot();
+			return pCache->inUse.Exchange(true, MemOrder::Acquire) ? nullptr : pCache;
+		}
+	}
+
+	DynamicPoolAllocator::DynamicPoolAllocator(IAllocator* pBackingAlloc, usize blockSize, usize numBlocks, u32 threadCacheSize) noexcept
+		: IMemBackedAllocator(nullptr)
+		, m_blockSize(blockSize)
+	{
+		ASSERT(Math::IsPowOf2(blockSize), "Block size needs to be a power of 2");
+		ASSERT(blockSize >= sizeof(u32), "Block size needs to be larger or equal than the size of a u32");
+		ASSERT(numBlocks != 0 && numBlocks < Math::Consts::MaxVal<u32>, "Invalid number of blocks");
+
+		m_mem = pBackingAlloc->Allocate<u8>(blockSize * numBlocks, u16(Math::Min(blockSize, usize(Math::Consts::MaxVal<u16> / 2 + 1))), true);
+		m_freeList.Init(m_mem.Ptr(), blockSize, numBlocks, threadCacheSize, pBackingAlloc);
+	}
+
+	DynamicPoolAllocator::DynamicPoolAllocator(DynamicPoolAllocator&& other) noexcept
+		: IMemBackedAllocator(Move(other.m_mem))
+		, m_freeList(Move(other.m_freeList))
+		, m_blockSize(other.m_blockSize)
+	{
+	}
+
+	void DynamicPoolAllocator::FlushThreadCache() noexcept
+	{
+		m_freeList.FlushThreadCache();
+	}
+
+	auto DynamicPoolAllocator::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+		ASSERT(align <= m_blockSize, "Cannot have a greater aligment than the blocksize");
+		ASSERT(size <= m_blockSize, "Cannot allocate more than the blocksize");
+		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
+
+		u8* ptr = m_freeList.Pop();
+		if (!ptr)
+			return nullptr;
+
+#if ENABLE_ALLOC_STATS
+		const usize overhead = m_blockSize - size;
+		m_stats.AddAlloc(size, overhead, isBacking);
+#endif
+
+		return { ptr, this, Math::Log2(align), size, isBacking };
+	}
+
+	void DynamicPoolAllocator::DeallocateRaw(MemRef<u8>&& mem) noexcept
+	{
+		m_freeList.Push(mem.Ptr());
+
+#if ENABLE_ALLOC_STATS
+		const usize size = mem.Size();
+		const usize overhead = m_blockSize - size;
+		m_stats.RemoveAlloc(size, overhead, mem.IsBackingMem());
+#endif
+	}
+}
@@ -4,12 +4,114 @@
 
 namespace Onca::Alloc
 {
+	namespace Detail
+	{
+		/**
+		 * Get the index of the per-thread cache slot of the current thread
+		 * \return Cache slot index
+		 */
+		CORE_API auto GetPoolCacheSlot() noexcept -> u32;
+
+		/**
+		 * \brief Lock-free free list of fixed-size blocks, shared by the pool allocators
+		 *
+		 * Blocks are referred to by 1-based indices, which allows the head to pack the index of the first free block together with a tag.
+		 * The tag is incremented on every update of the head, so a compare-exchange on a head that was modified in the meantime always fails, making the list immune to ABA.
+		 * This also means that a popping thread may read the link of a block that was just given out to another thread, but that value is discarded, as the compare-exchange will fail.
+		 *
+		 * Optionally, blocks can be cached per thread, caches are refilled from and flushed to the shared list in batches.
+		 * When the shared list runs dry, blocks are stolen from the caches of other threads, so the pool can always be allocated up to its capacity.
+		 */
+		class CORE_API PoolFreeList
+		{
+		public:
+			static constexpr u32 MaxThreadCaches = 64;
+
+			PoolFreeList() noexcept;
+			PoolFreeList(PoolFreeList&& other) noexcept;
+			~PoolFreeList() noexcept;
+
+			/**
+			 * Initialize the free list
+			 * \param[in] pMem Memory containing the blocks
+			 * \param[in] blockSize Size of a block
+			 * \param[in] numBlocks Number of blocks
+			 * \param[in] threadCacheSize Maximum number of blocks cached per thread, 0 disables caching
+			 * \param[in] pAlloc Allocator used to allocate the thread caches
+			 */
+			void Init(u8* pMem, usize blockSize, usize numBlocks, u32 threadCacheSize, IAllocator* pAlloc) noexcept;
+
+			/**
+			 * Take a free block
+			 * \return Pointer to the block, or nullptr if no block is available
+			 */
+			auto Pop() noexcept -> u8*;
+			/**
+			 * Return a block
+			 * \param[in] pBlock Pointer to the block
+			 */
+			void Push(u8* pBlock) noexcept;
+
+			/**
+			 * Return all blocks that are cached by the current thread to the shared list
+			 */
+			void FlushThreadCache() noexcept;
+
+		private:
+			struct alignas(64) ThreadCache
+			{
+				Atomic<bool> inUse; ///< Whether a thread is currently using the cache
+				u32          head;  ///< First cached block
+				Atomic<u32>  count; ///< Number of cached blocks, only written while holding the cache, but read by threads looking for blocks to steal
+			};
+
+			/**
+			 * Pop a chain of blocks from the shared list
+			 * \param[in] maxCount Maximum number of blocks to pop
+			 * \param[out] count Number of blocks that were popped
+			 * \return First block in the chain, the chain is terminated with 0
+			 */
+			auto PopShared(u32 maxCount, u32& count) noexcept -> u32;
+			/**
+			 * Push a chain of blocks to the shared list
+			 * \param[in] first First block of the chain
+			 * \param[in] last Last block of the chain
+			 */
+			void PushShared(u32 first, u32 last) noexcept;
+			/**
+			 * Take a block from the cache of any thread, the remaining blocks of that cache are returned to the shared list
+			 * \return Block, or 0 if all caches are empty
+			 */
+			auto StealCached() noexcept -> u32;
+			/**
+			 * Try to get exclusive access to the cache of the current thread
+			 * \return Cache, or nullptr if caching is disabled or the cache is in use by another thread sharing the same slot
+			 */
+			auto AcquireCache() noexcept -> ThreadCache*;
+
+			/**
+			 * Get the link to the next block stored in a block
+			 * \param[in] idx Index of the block
+			 * \return Link to the next block
+			 */
+			auto Next(u32 idx) noexcept -> u32& { return *reinterpret_cast<u32*>(m_pMem + (idx - 1) * m_blockSize); }
+
+			u8*                 m_pMem;            ///< Memory containing the blocks
+			usize               m_blockSize;       ///< Size of a block
+			u32                 m_numBlocks;       ///< Number of blocks
+			u32                 m_threadCacheSize; ///< Maximum number of blocks cached per thread
+			Atomic<u64>         m_head;            ///< Tag (upper 32 bits) and index of the first free block (lower 32 bits, 0 when empty)
+			MemRef<ThreadCache> m_caches;          ///< Thread caches
+		};
+	}
+
 	/**
 	 * \brief An allocator that allocates memory from fixed-size block in the allocator
 	 *
 	 * A pool allocator manages a chunk of memory as a pool of blocks, which can be given out or returned at any moment.
 	 * Each block's size is required to be a power of 2, as the size of the blocks also defines the maximum alignment of an allocation.
 	 * Each allocation is limited to the size of a single block, this help avoid the need for defragmentation and avoids additional overhead to manage the allocations.
+	 * Allocation and deallocation are lock-free, optionally with per-thread caches of blocks to avoid contention on the shared free list.
 	 *
 	 *     used     used     free     used     used     free     free
 	 *     v        v        v        v        v        v        v
@@ -27,16 +129,64 @@ namespace Onca::Alloc
 		/**
 		 * \brief Create a pool allocator
 		 * \param[in] pBackingAlloc Allocator to create the underlying memory block
+		 * \param[in] threadCacheSize Maximum number of blocks cached per thread, 0 disables caching
 		 */
-		explicit PoolAllocator(IAllocator* pBackingAlloc) noexcept;
+		explicit PoolAllocator(IAllocator* pBackingAlloc, u32 threadCacheSize = 0) noexcept;
 		PoolAllocator(PoolAllocator&& other) noexcept;
 
+		/**
+		 * Return all blocks that are cached by the current thread to the shared pool
+		 */
+		void FlushThreadCache() noexcept;
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+
+	private:
+		Detail::PoolFreeList m_freeList; ///< Free blocks
+	};
+
+	/**
+	 * \brief A pool allocator with a block size and number of blocks that are determined at runtime
+	 * \see PoolAllocator
+	 */
+	class CORE_API DynamicPoolAllocator final : public IMemBackedAllocator
+	{
+	public:
+		/**
+		 * \brief Create a pool allocator
+		 * \param[in] pBackingAlloc Allocator to create the underlying memory block
+		 * \param[in] blockSize Size of the blocks, needs to be a power of 2
+		 * \param[in] numBlocks Number of blocks
+		 * \param[in] threadCacheSize Maximum number of blocks cached per thread, 0 disables caching
+		 */
+		DynamicPoolAllocator(IAllocator* pBackingAlloc, usize blockSize, usize numBlocks, u32 threadCacheSize = 0) noexcept;
+		DynamicPoolAllocator(DynamicPoolAllocator&& other) noexcept;
+
+		/**
+		 * Return all blocks that are cached by the current thread to the shared pool
+		 */
+		void FlushThreadCache() noexcept;
+
+		/**
+		 * Get the size of a block
+		 * \return Size of a block
+		 */
+		auto GetBlockSize() const noexcept -> usize { return m_blockSize; }
+		/**
+		 * Get the number of blocks
+		 * \return Number of blocks
+		 */
+		auto GetNumBlocks() const noexcept -> usize { return m_mem.Size() / m_blockSize; }
+
 	protected:
 		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
 
 	private:
-		Atomic<u8*>  m_head;         ///< Offset to first empty block
+		Detail::PoolFreeList m_freeList;  ///< Free blocks
+		usize                m_blockSize; ///< Size of a block
 	};
 }
 
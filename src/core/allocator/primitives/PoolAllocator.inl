@@ -6,74 +6,55 @@
 namespace Onca::Alloc
 {
 	template<usize BlockSize, usize NumBlocks>
-	PoolAllocator<BlockSize, NumBlocks>::PoolAllocator(IAllocator* pBackingAlloc) noexcept
+	PoolAllocator<BlockSize, NumBlocks>::PoolAllocator(IAllocator* pBackingAlloc, u32 threadCacheSize) noexcept
 		: IMemBackedAllocator(nullptr)
-		, m_head(0)
 	{
 		STATIC_ASSERT(Math::IsPowOf2(BlockSize), "Block size needs to be a power of 2");
-		STATIC_ASSERT(BlockSize >= sizeof(u8*), "Block size needs to be larger or equal than the size of a pointer");
+		STATIC_ASSERT(BlockSize >= sizeof(u32), "Block size needs to be larger or equal than the size of a u32");
 		STATIC_ASSERT(NumBlocks != 0, "Needs to have at least 1 block");
-		
+		STATIC_ASSERT(NumBlocks < Math::Consts::MaxVal<u32>, "Too many blocks");
+
 		constexpr usize memSize = BlockSize * NumBlocks;
 		m_mem = pBackingAlloc->Allocate<u8>(memSize, BlockSize, true);
-
-		// Setup free blocks
-		m_head = m_mem.Ptr();
-		u8* pEnd = m_head + memSize - BlockSize;
-
-		for (u8* ptr = m_head; ptr < pEnd;)
-		{
-			u8* pNext = ptr + BlockSize;
-			*reinterpret_cast<u8**>(ptr) = pNext;
-			ptr = pNext;
-		}
+		m_freeList.Init(m_mem.Ptr(), BlockSize, NumBlocks, threadCacheSize, pBackingAlloc);
 	}
 
 	template<usize BlockSize, usize NumBlocks>
 	PoolAllocator<BlockSize, NumBlocks>::PoolAllocator(PoolAllocator&& other) noexcept
 		: IMemBackedAllocator(Move(other.m_mem))
-		, m_head(Move(other.m_head))
+		, m_freeList(Move(other.m_freeList))
 	{
 	}
-	
+
+	template<usize BlockSize, usize NumBlocks>
+	void PoolAllocator<BlockSize, NumBlocks>::FlushThreadCache() noexcept
+	{
+		m_freeList.FlushThreadCache();
+	}
+
 	template<usize BlockSize, usize NumBlocks>
 	auto PoolAllocator<BlockSize, NumBlocks>::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
 	{
 		ASSERT(align <= BlockSize, "Cannot have a greater aligment than the blocksize");
 		ASSERT(size <= BlockSize, "Cannot allocate more than the blocksize");
 		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
-		
-		u8* ptr = m_head;
-		u8* next;
-		do
-		{
-			if (!ptr)
-				return nullptr;
 
-			next = *reinterpret_cast<u8**>(ptr);
-		}
-		while (!m_head.CompareExchangeWeak(ptr, next));
+		u8* ptr = m_freeList.Pop();
+		if (!ptr)
+			return nullptr;
 
 #if ENABLE_ALLOC_STATS
 		const usize overhead = BlockSize - size;
 		m_stats.AddAlloc(size, overhead, isBacking);
 #endif
-		
+
 		return { ptr, this, Math::Log2(align), size, isBacking };
 	}
 
 	template<usize BlockSize, usize NumBlocks>
 	void PoolAllocator<BlockSize, NumBlocks>::DeallocateRaw(MemRef<u8>&& mem) noexcept
 	{
-		u8* ptr = mem.Ptr();
-		u8** pBlock = reinterpret_cast<u8**>(ptr);
-		u8* cur;
-		do
-		{
-			cur = m_head;
-			*pBlock = cur;
-		}
-		while (!m_head.CompareExchangeWeak(cur, ptr));
+		m_freeList.Push(mem.Ptr());
 
 #if ENABLE_ALLOC_STATS
 		const usize size = mem.Size();
@@ -0,0 +1,343 @@
+#include "SlabAllocator.h"
+
+#include "core/intrin/BitIntrin.h"
+#include "core/memory/MemUtils.h"
+#include "core/platform/SystemInfo.h"
+#include "core/platform/VirtualMemory.h"
+
+namespace Onca::Alloc
+{
+	namespace Detail
+	{
+		constexpr u32 SlabSizeClasses[SlabAllocator::NumSizeClasses] = {
+			    8,    16,    24,    32,    40,    48,    56,    64,
+			   80,    96,   112,   128,   160,   192,   224,   256,
+			  320,   384,   448,   512,   640,   768,   896,  1024,
+			 1280,  1536,  1792,  2048,  2560,  3072,  3584,  4096,
+			 5120,  6144,  7168,  8192, 10240, 12288, 14336, 16384,
+		};
+		STATIC_ASSERT(SlabSizeClasses[SlabAllocator::NumSizeClasses - 1] == SlabAllocator::MaxSmallSize, "Largest size class needs to match the max small size");
+
+		constexpr usize SlabSmallLookupMax = 1024;
+
+		/**
+		 * Lookup tables from a size to its size class, sizes up to 1 KiB are looked up in 8 byte steps, larger sizes in 128 byte steps
+		 */
+		struct SlabSizeClassLookup
+		{
+			u8 small[SlabSmallLookupMax / 8 + 1];
+			u8 large[SlabAllocator::MaxSmallSize / 128 + 1];
+		};
+
+		constexpr auto BuildSlabSizeClassLookup() noexcept -> SlabSizeClassLookup
+		{
+			SlabSizeClassLookup lookup = {};
+			u8 sizeClass = 0;
+			for (usize i = 0; i < sizeof(lookup.small); ++i)
+			{
+				while (SlabSizeClasses[sizeClass] < i * 8)
+					++sizeClass;
+				lookup.small[i] = sizeClass;
+			}
+
+			sizeClass = 0;
+			for (usize i = 0; i < sizeof(lookup.large); ++i)
+			{
+				while (SlabSizeClasses[sizeClass] < i * 128)
+					++sizeClass;
+				lookup.large[i] = sizeClass;
+			}
+			return lookup;
+		}
+
+		constexpr SlabSizeClassLookup SlabLookup = BuildSlabSizeClassLookup();
+
+		auto LookupSlabSizeClass(usize size) noexcept -> u32
+		{
+			return size <= SlabSmallLookupMax ? SlabLookup.small[(size + 7) >> 3] : SlabLookup.large[(size + 127) >> 7];
+		}
+	}
+
+	SlabAllocator::SlabAllocator(IAllocator* pLargeAlloc, usize reserveSize, u32 numaNode) noexcept
+		: m_pLargeAlloc(pLargeAlloc)
+		, m_numaNode(numaNode)
+		, m_pReserved(nullptr)
+		, m_reserveSize(0)
+		, m_pBase(nullptr)
+		, m_pEnd(nullptr)
+		, m_pNextSlab(nullptr)
+		, m_pPool(nullptr)
+		, m_numSlabs(0)
+		, m_numPooledSlabs(0)
+		, m_largeAllocs(*pLargeAlloc)
+	{
+		ASSERT(g_SystemInfo.GetPageSize() >= SlabHeaderSize, "The slab header needs to fit in a single page");
+
+		for (SizeClass& sizeClass : m_sizeClasses)
+			sizeClass.pPartial = nullptr;
+
+		// Reserve an additional slab, so the slabs can be aligned to their size, which allows the slab to be found from any address inside of it
+		const usize granularity = Math::Max(g_SystemInfo.GetVirtualAllocGranularity(), SlabSize);
+		const usize alignedSize = (reserveSize + SlabSize + granularity - 1) & ~(granularity - 1);
+		m_pReserved = VirtualMemory::Reserve(alignedSize, false);
+		ASSERT(m_pReserved, "Failed to reserve virtual memory");
+		if (!m_pReserved)
+			return;
+
+		m_reserveSize = alignedSize;
+		m_pBase = reinterpret_cast<u8*>((reinterpret_cast<usize>(m_pReserved) + SlabSize - 1) & ~(SlabSize - 1));
+		m_pEnd = m_pBase + (m_pReserved + m_reserveSize - m_pBase) / SlabSize * SlabSize;
+		m_pNextSlab = m_pBase;
+	}
+
+	SlabAllocator::~SlabAllocator() noexcept
+	{
+		if (m_pReserved)
+			VirtualMemory::Release(m_pReserved, m_reserveSize);
+	}
+
+	void SlabAllocator::Trim() noexcept
+	{
+		// The header stays committed, so the pool can still be walked
+		const usize pageSize = g_SystemInfo.GetPageSize();
+
+		Threading::Lock lock{ m_poolMutex };
+		for (Slab* pSlab = m_pPool; pSlab; pSlab = pSlab->pNext)
+		{
+			if (pSlab->isTrimmed)
+				continue;
+
+			VirtualMemory::Decommit(reinterpret_cast<u8*>(pSlab) + pageSize, SlabSize - pageSize);
+			pSlab->isTrimmed = true;
+		}
+	}
+
+	auto SlabAllocator::GetSizeClassSize(usize size, u16 align) noexcept -> usize
+	{
+		const u32 sizeClass = GetSizeClass(size, align);
+		return sizeClass == InvalidSizeClass ? 0 : Detail::SlabSizeClasses[sizeClass];
+	}
+
+	auto SlabAllocator::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
+
+		const u32 sizeClassIdx = GetSizeClass(size, align);
+		if (sizeClassIdx == InvalidSizeClass) UNLIKELY
+			return AllocateLarge(size, align, isBacking);
+
+		SizeClass& sizeClass = m_sizeClasses[sizeClassIdx];
+		u8* ptr;
+		{
+			Threading::Lock lock{ sizeClass.mutex };
+
+			Slab* pSlab = sizeClass.pPartial;
+			if (!pSlab) UNLIKELY
+			{
+				pSlab = AcquireSlab(sizeClassIdx);
+				if (!pSlab)
+					return AllocateLarge(size, align, isBacking);
+				sizeClass.pPartial = pSlab;
+			}
+
+			ptr = TakeObject(pSlab);
+
+			// Full slabs are not tracked, they only get back into the partial list when one of their objects is freed
+			if (!pSlab->numFree)
+			{
+				sizeClass.pPartial = pSlab->pNext;
+				if (sizeClass.pPartial)
+					sizeClass.pPartial->pPrev = nullptr;
+				pSlab->pNext = nullptr;
+			}
+		}
+
+#if ENABLE_ALLOC_STATS
+		m_stats.AddAlloc(size, Detail::SlabSizeClasses[sizeClassIdx] - size, isBacking);
+#endif
+
+		return { ptr, this, Math::Log2(align), size, isBacking };
+	}
+
+	void SlabAllocator::DeallocateRaw(MemRef<u8>&& mem) noexcept
+	{
+		u8* ptr = mem.Ptr();
+		if (ptr < m_pBase || ptr >= m_pEnd) UNLIKELY
+		{
+			{
+				Threading::Lock lock{ m_largeMutex };
+				const usize numErased = m_largeAllocs.Erase(usize(ptr));
+				ASSERT(numErased, "Memory was not allocated by the slab allocator");
+				UNUSED(numErased);
+			}
+			mem.SetAlloc(m_pLargeAlloc);
+			m_pLargeAlloc->Deallocate(Move(mem));
+			return;
+		}
+
+		// The slab can't change size class while it has objects in use, so it's safe to read it before locking
+		Slab* pSlab = reinterpret_cast<Slab*>(reinterpret_cast<usize>(ptr) & ~(SlabSize - 1));
+		const u32 offset = u32(ptr - reinterpret_cast<u8*>(pSlab) - SlabHeaderSize);
+		const u32 idx = u32((u64(offset) * pSlab->divMagic) >> 32);
+		const u32 wordIdx = idx / 64;
+		const u64 bit = 1ull << (idx % 64);
+
+		const u32 sizeClassIdx = pSlab->sizeClass;
+		SizeClass& sizeClass = m_sizeClasses[sizeClassIdx];
+		bool release = false;
+		{
+			Threading::Lock lock{ sizeClass.mutex };
+			ASSERT(pSlab->bitmap[wordIdx] & bit, "Slab memory was already deallocated");
+
+			pSlab->bitmap[wordIdx] &= ~bit;
+			pSlab->hint = Math::Min(pSlab->hint, wordIdx);
+
+			if (pSlab->numFree++ == 0)
+			{
+				pSlab->pPrev = nullptr;
+				pSlab->pNext = sizeClass.pPartial;
+				if (sizeClass.pPartial)
+					sizeClass.pPartial->pPrev = pSlab;
+				sizeClass.pPartial = pSlab;
+			}
+			// Keep the last partial slab of a size class around, so a single allocation going back and forth doesn't keep acquiring and releasing a slab
+			else if (pSlab->numFree == pSlab->numObjects && (pSlab->pNext || pSlab->pPrev))
+			{
+				if (pSlab->pPrev)
+					pSlab->pPrev->pNext = pSlab->pNext;
+				else
+					sizeClass.pPartial = pSlab->pNext;
+				if (pSlab->pNext)
+					pSlab->pNext->pPrev = pSlab->pPrev;
+				release = true;
+			}
+		}
+
+		if (release)
+			ReleaseSlab(pSlab);
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), Detail::SlabSizeClasses[sizeClassIdx] - mem.Size(), mem.IsBackingMem());
+#endif
+	}
+
+	auto SlabAllocator::OwnsInternal(const MemRef<u8>& mem) noexcept -> bool
+	{
+		const u8* ptr = mem.Ptr();
+		if (ptr >= m_pBase && ptr < m_pEnd)
+			return true;
+
+		Threading::Lock lock{ m_largeMutex };
+		return m_largeAllocs.Contains(usize(ptr));
+	}
+
+	auto SlabAllocator::AllocateLarge(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+		MemRef<u8> mem = m_pLargeAlloc->Allocate<u8>(size, align, isBacking);
+		if (!mem.IsValid()) UNLIKELY
+			return mem;
+
+		{
+			Threading::Lock lock{ m_largeMutex };
+			m_largeAllocs.Insert(usize(mem.Ptr()));
+		}
+
+		// Deallocations need to go through the slab allocator, so the address is removed again
+		mem.SetAlloc(this);
+		return mem;
+	}
+
+	auto SlabAllocator::GetSizeClass(usize size, u16 align) noexcept -> u32
+	{
+		if (size > MaxSmallSize || align > SlabHeaderSize) UNLIKELY
+			return InvalidSizeClass;
+
+		u32 sizeClass = Detail::LookupSlabSizeClass(Math::Max(size, usize(1)));
+
+		// Objects are only aligned to the largest power of 2 dividing their size, so fall back to a power of 2 size class for larger alignments
+		if (align > 8 && Detail::SlabSizeClasses[sizeClass] % align) UNLIKELY
+		{
+			const usize pow2Size = usize(1) << (Math::Log2(Math::Max(size, usize(align)) - 1) + 1);
+			if (pow2Size > MaxSmallSize)
+				return InvalidSizeClass;
+			sizeClass = Detail::LookupSlabSizeClass(pow2Size);
+		}
+		return sizeClass;
+	}
+
+	auto SlabAllocator::TakeObject(Slab* pSlab) noexcept -> u8*
+	{
+		// All words before the hint are full
+		u32 wordIdx = pSlab->hint;
+		while (!~pSlab->bitmap[wordIdx])
+			++wordIdx;
+		ASSERT(wordIdx < (pSlab->numObjects + 63) / 64, "Slab has no free objects");
+
+		const u32 bitIdx = Intrin::BitScanLSB(~pSlab->bitmap[wordIdx]);
+		pSlab->bitmap[wordIdx] |= 1ull << bitIdx;
+		pSlab->hint = wordIdx;
+		--pSlab->numFree;
+
+		const usize idx = usize(wordIdx) * 64 + bitIdx;
+		return reinterpret_cast<u8*>(pSlab) + SlabHeaderSize + idx * pSlab->objSize;
+	}
+
+	auto SlabAllocator::AcquireSlab(u32 sizeClass) noexcept -> Slab*
+	{
+		Slab* pSlab;
+		{
+			Threading::Lock lock{ m_poolMutex };
+			if (m_pPool)
+			{
+				pSlab = m_pPool;
+				if (pSlab->isTrimmed)
+				{
+					const usize pageSize = g_SystemInfo.GetPageSize();
+					if (!VirtualMemory::CommitOnNode(reinterpret_cast<u8*>(pSlab) + pageSize, SlabSize - pageSize, m_numaNode)) UNLIKELY
+						return nullptr;
+				}
+				m_pPool = pSlab->pNext;
+				m_numPooledSlabs.FetchSub(1, MemOrder::Relaxed);
+			}
+			else
+			{
+				if (m_pNextSlab == m_pEnd || !VirtualMemory::CommitOnNode(m_pNextSlab, SlabSize, m_numaNode)) UNLIKELY
+					return nullptr;
+				pSlab = reinterpret_cast<Slab*>(m_pNextSlab);
+				m_pNextSlab += SlabSize;
+			}
+		}
+		m_numSlabs.FetchAdd(1, MemOrder::Relaxed);
+
+		const u32 objSize = Detail::SlabSizeClasses[sizeClass];
+		const u32 numObjects = u32((SlabSize - SlabHeaderSize) / objSize);
+		const u32 numWords = (numObjects + 63) / 64;
+
+		pSlab->pNext = nullptr;
+		pSlab->pPrev = nullptr;
+		pSlab->sizeClass = sizeClass;
+		pSlab->objSize = objSize;
+		pSlab->divMagic = u32(((u64(1) << 32) + objSize - 1) / objSize);
+		pSlab->numObjects = numObjects;
+		pSlab->numFree = numObjects;
+		pSlab->hint = 0;
+		pSlab->isTrimmed = false;
+
+		// Padding bits are marked as used, so they are never handed out
+		MemClear(pSlab->bitmap, numWords * sizeof(u64));
+		if (numObjects % 64)
+			pSlab->bitmap[numWords - 1] = ~0ull << (numObjects % 64);
+
+		return pSlab;
+	}
+
+	void SlabAllocator::ReleaseSlab(Slab* pSlab) noexcept
+	{
+		m_numSlabs.FetchSub(1, MemOrder::Relaxed);
+		m_numPooledSlabs.FetchAdd(1, MemOrder::Relaxed);
+
+		Threading::Lock lock{ m_poolMutex };
+		pSlab->pNext = m_pPool;
+		m_pPool = pSlab;
+	}
+}
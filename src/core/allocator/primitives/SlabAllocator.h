@@ -0,0 +1,163 @@
+#pragma once
+#include "core/allocator/IAllocator.h"
+#include "core/containers/HashSet.h"
+#include "core/platform/VirtualMemory.h"
+#include "core/threading/Sync.h"
+#include "core/utils/Atomic.h"
+
+namespace Onca::Alloc
+{
+	/**
+	 * \brief A general purpose allocator that serves small allocations from slabs of same-sized objects (threadsafe)
+	 *
+	 * Allocations are rounded up to one of 40 size classes, growing geometrically with 4 classes per power of 2, from 8 bytes up to 16 KiB.
+	 * The size class of an allocation is found with a single table lookup.
+	 * Each size class carves its objects out of fixed-size slabs, which keep track of their free objects with a bitmap in the slab header.
+	 * Slabs are aligned to their size, so the slab owning an allocation is found by masking its address, without any per-allocation header.
+	 *
+	 * The slabs are taken from a single reserved range of virtual address space and are only committed when they are first used.
+	 * Empty slabs are returned to a shared pool, from which they can be reused by any size class, Trim() returns the memory of pooled slabs to the system.
+	 * Allocations larger than the largest size class, or with an alignment larger than the slab header, are forwarded to a fallback allocator.
+ * Their addresses are recorded, so the slab allocator only owns the fallback memory it allocated itself.
+	 *
+	 * Every size class has its own lock, so threads only contend when allocating objects of a similar size.
+	 * As the allocator never allocates from the global allocator itself, it can be installed as the global allocator with SetGlobalAlloc.
+	 *
+	 * slab
+	 * v
+	 * +--------+----+----+----+----+----+----+----+----+
+	 * | header |536C|6162|????|416C|6C6F|????|????|6361|
+	 * +--------+----+----+----+----+----+----+----+----+
+	 */
+	class CORE_API SlabAllocator final : public IAllocator
+	{
+	public:
+		static constexpr usize SlabSize       = 64_KiB;
+		static constexpr usize SlabHeaderSize = 2_KiB;
+		static constexpr u32   NumSizeClasses = 40;
+		static constexpr usize MaxSmallSize   = 16_KiB;
+
+		/**
+		 * Create a slab allocator
+		 * \param[in] pLargeAlloc Allocator used for allocations that don't fit in any size class
+		 * \param[in] reserveSize Size of the address range to reserve for slabs
+		 * \param[in] numaNode NUMA node the slabs are committed on
+		 */
+		explicit SlabAllocator(IAllocator* pLargeAlloc, usize reserveSize = 64_GiB, u32 numaNode = VirtualMemory::NoNumaNode) noexcept;
+		~SlabAllocator() noexcept override;
+
+		DISABLE_COPY(SlabAllocator);
+		DISABLE_MOVE(SlabAllocator);
+
+		/**
+		 * Return the physical memory of all empty pooled slabs to the system, while keeping the slabs reserved
+		 */
+		void Trim() noexcept;
+
+		/**
+		 * Get the size of the size class an allocation would be rounded up to
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 * \return Size of the size class, or 0 if the allocation would go to the fallback allocator
+		 */
+		static auto GetSizeClassSize(usize size, u16 align = 8) noexcept -> usize;
+
+		/**
+		 * Get the number of slabs in use by size classes
+		 * \return Number of slabs in use
+		 */
+		auto GetNumSlabs() const noexcept -> usize { return m_numSlabs.Load(MemOrder::Relaxed); }
+		/**
+		 * Get the number of empty slabs in the pool
+		 * \return Number of pooled slabs
+		 */
+		auto GetNumPooledSlabs() const noexcept -> usize { return m_numPooledSlabs.Load(MemOrder::Relaxed); }
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
+
+	private:
+		static constexpr usize MaxObjectsPerSlab = (SlabSize - SlabHeaderSize) / 8;
+		static constexpr usize NumBitmapWords    = (MaxObjectsPerSlab + 63) / 64;
+		static constexpr u32   InvalidSizeClass  = 0xFF;
+
+		/**
+		 * Header at the start of each slab
+		 */
+		struct Slab
+		{
+			Slab* pNext;                    ///< Next slab in the partial list of the size class, or in the pool
+			Slab* pPrev;                    ///< Previous slab in the partial list of the size class
+			u32   sizeClass;                ///< Size class of the slab
+			u32   objSize;                  ///< Size of an object
+			u32   divMagic;                 ///< Magic multiplier to divide an offset by the object size
+			u32   numObjects;               ///< Number of objects in the slab
+			u32   numFree;                  ///< Number of free objects
+			u32   hint;                     ///< Index of the first bitmap word that may contain a free object
+			bool  isTrimmed;                ///< Whether the memory after the first page is decommitted
+			u64   bitmap[NumBitmapWords];   ///< Bitmap with a bit set for each object in use, including padding bits
+		};
+		STATIC_ASSERT(sizeof(Slab) <= SlabHeaderSize, "Slab header does not fit in the reserved header space");
+
+		struct alignas(64) SizeClass
+		{
+			Threading::Mutex mutex;    ///< Mutex guarding the partial list and its slabs
+			Slab*            pPartial; ///< Slabs with at least 1 free object
+		};
+
+		/**
+		 * Get the index of the size class of an allocation
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 * \return Index of the size class, or InvalidSizeClass if the allocation does not fit in a size class
+		 */
+		static auto GetSizeClass(usize size, u16 align) noexcept -> u32;
+
+		/**
+		 * Take an object from a slab
+		 * \param[in] pSlab Slab with at least 1 free object
+		 * \return Pointer to the object
+		 */
+		static auto TakeObject(Slab* pSlab) noexcept -> u8*;
+
+		/**
+		 * Get an empty slab from the pool, or commit a new one
+		 * \param[in] sizeClass Size class to initialize the slab for
+		 * \return Slab, or nullptr if the reserved range is exhausted
+		 */
+		auto AcquireSlab(u32 sizeClass) noexcept -> Slab*;
+		/**
+		 * Return an empty slab to the pool
+		 * \param[in] pSlab Slab
+		 */
+		void ReleaseSlab(Slab* pSlab) noexcept;
+
+		/**
+		 * Allocate memory from the large allocator and record its address
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 * \param[in] isBacking Whether the memory is backing memory
+		 * \return Memory
+		 */
+		auto AllocateLarge(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>;
+
+		IAllocator*      m_pLargeAlloc;                 ///< Allocator for allocations that don't fit in a size class
+		u32              m_numaNode;                    ///< NUMA node the slabs are committed on
+		u8*              m_pReserved;                   ///< Start of the reserved range, as returned by the system
+		usize            m_reserveSize;                 ///< Size of the reserved range
+		u8*              m_pBase;                       ///< Start of the first slab, aligned to the slab size
+		u8*              m_pEnd;                        ///< End of the last slab that fits in the range
+		SizeClass        m_sizeClasses[NumSizeClasses]; ///< Size classes
+
+		Threading::Mutex m_poolMutex;                   ///< Mutex guarding the slab pool
+		u8*              m_pNextSlab;                   ///< First slab that was never used
+		Slab*            m_pPool;                       ///< Empty slabs
+		Atomic<usize>    m_numSlabs;                    ///< Number of slabs in use
+		Atomic<usize>    m_numPooledSlabs;              ///< Number of slabs in the pool
+
+		Threading::Mutex m_largeMutex;                  ///< Mutex guarding the large allocations
+		HashSet<usize>   m_largeAllocs;                 ///< Addresses of the live allocations made from the large allocator, stored in the large allocator's memory
+	};
+}
@@ -10,6 +10,7 @@ namespace Onca::Alloc
 	  * memory can also be deallocated, but this is required to happen in the reverse order of allocation (FILO).
 	  *	This limitation is what limits the allocator to just 1 thread, since otherwise no guarantee can be made about the order of deallocations.
 	  *	Each new allocation is aligned to the allocator's max alignment, any allocation with a smaller or equal alignment are possible.
+	  *	The allocation at the top of the stack can be grown in place.
 	  *
 	  * begin        last        head
 	  * v            v           v
@@ -34,8 +35,16 @@ namespace Onca::Alloc
 	protected:
 		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
 		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool override;
 
 	private:
+		/**
+		 * Get the size an allocation takes up on the stack, so the next allocation is aligned to the max alignment
+		 * \param[in] size Size of the allocation
+		 * \return Padded size
+		 */
+		static constexpr auto GetPaddedSize(usize size) noexcept -> usize;
+
 		u8*        m_head;   ///< Current location on the stack
 	};
 }
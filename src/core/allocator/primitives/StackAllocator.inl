@@ -22,11 +22,7 @@ namespace Onca::Alloc
 		ASSERT(align <= MaxAlignment, "Alignment cannot be larger than is allowed by the allocator");
 		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
 
-		const usize mask = align - 1;
-		const usize diff = size & mask;
-		const usize padding = (MaxAlignment - diff) & mask;
-		const usize paddedSize = size + padding;
-
+		const usize paddedSize = GetPaddedSize(size);
 		if (m_head + paddedSize > m_mem.Ptr() + m_mem.Size()) UNLIKELY
 			return nullptr;
 		 
@@ -34,7 +30,7 @@ namespace Onca::Alloc
 		m_head += paddedSize;
 
 #if ENABLE_ALLOC_STATS
-		m_stats.AddAlloc(size, padding, isBacking);
+		m_stats.AddAlloc(size, paddedSize - size, isBacking);
 #endif
 		
 		return { ptr, this, Math::Log2(align), size, isBacking };
@@ -44,12 +40,8 @@ namespace Onca::Alloc
 	void StackAllocator<Size, MaxAlignment>::DeallocateRaw(MemRef<u8>&& mem) noexcept
 	{
 #if ENABLE_ASSERT || ENABLE_ALLOC_STATS
-		const usize align = mem.Align();
 		const usize size = mem.Size();
-		const usize mask = align - 1;
-		const usize diff = size & mask;
-		const usize padding = (diff == 0 ? 0 : MaxAlignment - diff);
-		const usize paddedSize = size + padding;
+		const usize paddedSize = GetPaddedSize(size);
 #endif
 
 		u8* memStart = mem.Ptr();
@@ -57,7 +49,31 @@ namespace Onca::Alloc
 		m_head = memStart;
 
 #if ENABLE_ALLOC_STATS
-		m_stats.RemoveAlloc(size, padding, mem.IsBackingMem());
+		m_stats.RemoveAlloc(size, paddedSize - size, mem.IsBackingMem());
 #endif
 	}
+
+	template<usize Size, usize MaxAlignment>
+	auto StackAllocator<Size, MaxAlignment>::TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		// Only the allocation at the top of the stack can be grown
+		u8* ptr = mem.Ptr();
+		const usize newPaddedSize = GetPaddedSize(newSize);
+		if (ptr + GetPaddedSize(mem.Size()) != m_head || ptr + newPaddedSize > m_mem.Ptr() + m_mem.Size())
+			return false;
+
+		m_head = ptr + newPaddedSize;
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), GetPaddedSize(mem.Size()) - mem.Size(), mem.IsBackingMem());
+		m_stats.AddAlloc(newSize, newPaddedSize - newSize, mem.IsBackingMem());
+#endif
+		return true;
+	}
+
+	template<usize Size, usize MaxAlignment>
+	constexpr auto StackAllocator<Size, MaxAlignment>::GetPaddedSize(usize size) noexcept -> usize
+	{
+		return (size + MaxAlignment - 1) & ~(MaxAlignment - 1);
+	}
 }
@@ -0,0 +1,164 @@
+#include "VirtualArena.h"
+
+#include "core/platform/SystemInfo.h"
+#include "core/platform/VirtualMemory.h"
+
+namespace Onca::Alloc
+{
+	namespace Detail
+	{
+		constexpr usize LargePageSize = 2_MiB;
+
+		auto AlignUp(usize val, usize align) noexcept -> usize
+		{
+			return (val + align - 1) & ~(align - 1);
+		}
+	}
+
+	VirtualArena::VirtualArena(usize reserveSize, VirtualArenaFlags flags) noexcept
+		: m_pBase(nullptr)
+		, m_reserveSize(0)
+		, m_commitGranularity(g_SystemInfo.GetPageSize())
+		, m_flags(flags)
+		, m_head(0)
+		, m_committed(0)
+	{
+		// Commit at least a large page at a time when large pages are requested, otherwise they can never be used to back the memory
+		if (flags.IsSet(VirtualArenaFlag::LargePages))
+			m_commitGranularity = Math::Max(m_commitGranularity, Detail::LargePageSize);
+
+		const usize granularity = Math::Max(g_SystemInfo.GetVirtualAllocGranularity(), m_commitGranularity);
+		const usize alignedSize = Detail::AlignUp(reserveSize, granularity);
+		m_pBase = VirtualMemory::Reserve(alignedSize, flags.IsSet(VirtualArenaFlag::LargePages));
+		ASSERT(m_pBase, "Failed to reserve virtual memory");
+		if (m_pBase)
+			m_reserveSize = alignedSize;
+	}
+
+	VirtualArena::VirtualArena(VirtualArena&& other) noexcept
+		: m_pBase(other.m_pBase)
+		, m_reserveSize(other.m_reserveSize)
+		, m_commitGranularity(other.m_commitGranularity)
+		, m_flags(other.m_flags)
+		, m_head(other.m_head.Load())
+		, m_committed(other.m_committed.Load())
+	{
+		other.m_pBase = nullptr;
+		other.m_reserveSize = 0;
+		other.m_head.Store(0);
+		other.m_committed.Store(0);
+	}
+
+	VirtualArena::~VirtualArena() noexcept
+	{
+		if (m_pBase)
+			VirtualMemory::Release(m_pBase, m_reserveSize);
+	}
+
+	void VirtualArena::Reset() noexcept
+	{
+		m_head.Store(0);
+
+		if (m_flags.IsSet(VirtualArenaFlag::DecommitOnReset))
+		{
+			Threading::Lock lock{ m_commitMutex };
+			const usize committed = m_committed.Load();
+			if (committed)
+				VirtualMemory::Decommit(m_pBase, committed);
+			m_committed.Store(0);
+		}
+
+#if ENABLE_ALLOC_STATS
+		m_stats.ResetCur();
+#endif
+	}
+
+	auto VirtualArena::AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8>
+	{
+		ASSERT(Math::IsPowOf2(align), "Alignment needs to be a power of 2");
+
+		usize head = m_head.Load(MemOrder::Relaxed);
+		usize begin;
+		usize end;
+		do
+		{
+			begin = Detail::AlignUp(reinterpret_cast<usize>(m_pBase) + head, align) - reinterpret_cast<usize>(m_pBase);
+			end = begin + size;
+			if (end > m_reserveSize) UNLIKELY
+				return nullptr;
+		}
+		while (!m_head.CompareExchangeWeak(head, end, MemOrder::Relaxed));
+
+		if (!EnsureCommitted(end)) UNLIKELY
+		{
+			// Only give the memory back when no other allocation was made in the meantime
+			m_head.CompareExchangeStrong(end, head, MemOrder::Relaxed);
+			return nullptr;
+		}
+
+#if ENABLE_ALLOC_STATS
+		m_stats.AddAlloc(size, begin - head, isBacking);
+#endif
+
+		return { m_pBase + begin, this, Math::Log2(align), size, isBacking };
+	}
+
+	void VirtualArena::DeallocateRaw(MemRef<u8>&& mem) noexcept
+	{
+		// The last allocation can be returned to the arena, which allows a container to repeatedly shrink and grow at the end of the arena
+		const usize begin = usize(mem.Ptr() - m_pBase);
+		usize end = begin + mem.Size();
+		m_head.CompareExchangeStrong(end, begin, MemOrder::Relaxed);
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), 0, mem.IsBackingMem());
+#endif
+	}
+
+	auto VirtualArena::OwnsInternal(const MemRef<u8>& mem) noexcept -> bool
+	{
+		const u8* ptr = mem.Ptr();
+		return ptr >= m_pBase && ptr < m_pBase + m_reserveSize;
+	}
+
+	auto VirtualArena::TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool
+	{
+		// Only the last allocation can be grown
+		const usize begin = usize(mem.Ptr() - m_pBase);
+		const usize newEnd = begin + newSize;
+		usize end = begin + mem.Size();
+		if (newEnd > m_reserveSize || !m_head.CompareExchangeStrong(end, newEnd, MemOrder::Relaxed))
+			return false;
+
+		if (!EnsureCommitted(newEnd)) UNLIKELY
+		{
+			usize expected = newEnd;
+			m_head.CompareExchangeStrong(expected, end, MemOrder::Relaxed);
+			return false;
+		}
+
+#if ENABLE_ALLOC_STATS
+		m_stats.RemoveAlloc(mem.Size(), 0, mem.IsBackingMem());
+		m_stats.AddAlloc(newSize, 0, mem.IsBackingMem());
+#endif
+		return true;
+	}
+
+	auto VirtualArena::EnsureCommitted(usize end) noexcept -> bool
+	{
+		if (end <= m_committed.Load(MemOrder::Acquire)) LIKELY
+			return true;
+
+		Threading::Lock lock{ m_commitMutex };
+		const usize committed = m_committed.Load(MemOrder::Relaxed);
+		if (end <= committed)
+			return true;
+
+		const usize newCommitted = Math::Min(Detail::AlignUp(end, m_commitGranularity), m_reserveSize);
+		if (!VirtualMemory::Commit(m_pBase + committed, newCommitted - committed))
+			return false;
+
+		m_committed.Store(newCommitted, MemOrder::Release);
+		return true;
+	}
+}
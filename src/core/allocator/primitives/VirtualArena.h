@@ -0,0 +1,96 @@
+#pragma once
+#include "core/allocator/IAllocator.h"
+#include "core/memory/MemUtils.h"
+#include "core/utils/Atomic.h"
+#include "core/utils/Flags.h"
+
+namespace Onca::Alloc
+{
+	enum class VirtualArenaFlag : u8
+	{
+		None            = 0     , ///< None
+		DecommitOnReset = BIT(0), ///< Return all committed memory to the system when the arena is reset
+		LargePages      = BIT(1), ///< Hint that the memory should be backed by large pages
+	};
+	DEFINE_FLAGS(VirtualArenaFlag);
+
+	/**
+	 * \brief A linear allocator that reserves a large range of virtual address space and commits memory as it grows (threadsafe)
+	 *
+	 * A virtual arena works like a linear allocator, but instead of requesting its memory from a backing allocator, it reserves a range of address space from the system.
+	 * Memory is only committed when the head of the arena moves into it, so the arena can be reserved far larger than it will ever grow, while only paying for the memory that is used.
+	 * As the range never moves, all addresses stay valid while the arena grows.
+	 *
+	 * The last allocation can be grown in place and is returned to the arena when it's deallocated,
+	 * which allows a single container, like a DynArray, to grow inside of the arena without ever needing to move its elements.
+	 *
+	 * begin                    head             committed                             reserved
+	 * v                        v                v                                     v
+	 * +------------------------+----------------+-------------------------------------+
+	 * |5669727475616C4172656E61|????????????????|                                     |
+	 * +------------------------+----------------+-------------------------------------+
+	 */
+	class CORE_API VirtualArena final : public IAllocator
+	{
+	public:
+		/**
+		 * Create a virtual arena
+		 * \param[in] reserveSize Size of the address range to reserve, rounded up to the virtual allocation granularity
+		 * \param[in] flags Flags
+		 */
+		explicit VirtualArena(usize reserveSize = 64_GiB, VirtualArenaFlags flags = VirtualArenaFlag::None) noexcept;
+		VirtualArena(VirtualArena&& other) noexcept;
+		~VirtualArena() noexcept override;
+
+		/**
+		 * Reset the head of the allocator
+		 * \note This will invalidate all memory owned by this allocator and may not be called while other threads are allocating from the arena
+		 */
+		void Reset() noexcept;
+
+		/**
+		 * Check if the address range was successfully reserved
+		 * \return Whether the address range was reserved
+		 */
+		auto IsValid() const noexcept -> bool { return m_pBase; }
+		/**
+		 * Get the size of the reserved address range
+		 * \return Size of the reserved address range
+		 */
+		auto GetReservedSize() const noexcept -> usize { return m_reserveSize; }
+		/**
+		 * Get the size of the committed memory
+		 * \return Size of the committed memory
+		 */
+		auto GetCommittedSize() const noexcept -> usize { return m_committed.Load(MemOrder::Relaxed); }
+		/**
+		 * Get the size of the memory in use, including padding
+		 * \return Size of the memory in use
+		 */
+		auto GetUsedSize() const noexcept -> usize { return m_head.Load(MemOrder::Relaxed); }
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override;
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override;
+		auto OwnsInternal(const MemRef<u8>& mem) noexcept -> bool override;
+		auto TryExpandInPlaceRaw(const MemRef<u8>& mem, usize newSize) noexcept -> bool override;
+
+	private:
+		/**
+		 * Make sure that all memory up to an offset is committed
+		 * \param[in] end Offset up to which memory needs to be committed
+		 * \return Whether the memory is committed
+		 */
+		auto EnsureCommitted(usize end) noexcept -> bool;
+
+		u8*               m_pBase;             ///< Start of the reserved address range
+		usize             m_reserveSize;       ///< Size of the reserved address range
+		usize             m_commitGranularity; ///< Granularity in which memory is committed
+		VirtualArenaFlags m_flags;             ///< Flags
+		Atomic<usize>     m_head;              ///< Offset of the first unused byte
+		Atomic<usize>     m_committed;         ///< Size of the committed memory
+		Threading::Mutex  m_commitMutex;       ///< Mutex to guard committing memory
+	};
+}
+
+DEFINE_ENUM_FLAG_OPS(Onca::Alloc::VirtualArenaFlag);
@@ -2,15 +2,48 @@
 #include "core/MinInclude.h"
 #include "allocator/IAllocator.h"
 #include "allocator/GlobalAlloc.h"
+#include "core/intrin/Pack.h"
 
 namespace Onca
 {
+	namespace Detail
+	{
+		using BitSetPack = Intrin::Pack<u64, 4>; ///< Pack used for bulk operations on the words of a bitset
+
+		/**
+		 * Apply an operation to the words of 2 bitsets, a pack at a time
+		 * \tparam F Operation, needs to be callable with 2 packs and 2 words
+		 * \param[in,out] pDst Words to apply the operation to, receives the result
+		 * \param[in] pSrc Words to apply the operation with
+		 * \param[in] count Number of words
+		 * \param[in] op Operation
+		 */
+		template<typename F>
+		void BitSetBulkOp(usize* pDst, const usize* pSrc, usize count, F op) noexcept;
+		/**
+		 * Count the bits set in the result of an operation on the words of 2 bitsets, without storing the result
+		 * \tparam F Operation, needs to be callable with 2 packs and 2 words
+		 * \param[in] pA First words
+		 * \param[in] pB Second words
+		 * \param[in] count Number of words
+		 * \param[in] op Operation
+		 * \return Number of bits set in the result
+		 */
+		template<typename F>
+		auto BitSetBulkCount(const usize* pA, const usize* pB, usize count, F op) noexcept -> usize;
+	}
+
 	/**
-	 * Dynamically sized bitset
+	 * \brief Dynamically sized bitset
+	 *
+	 * Bits are stored from the most significant bit of each word, so bit 0 is the top bit of the first word.
+	 * Bulk operations work on multiple words at a time using Intrin::Pack, operations on bitsets of a different size act as if the smaller bitset is padded with 0s.
 	 */
 	class BitSet
 	{
 	public:
+		static constexpr usize NPos = usize(-1); ///< Index returned when no bit could be found
+
 		/**
 		 * Create a BitSet
 		 * \param[in] alloc Allocator
@@ -67,6 +100,45 @@ namespace Onca
 		 */
 		auto Match(const BitSet& other) const noexcept -> bool;
 
+		/**
+		 * Unset all bits that are set in another bitset, in place
+		 * \param[in] other Other bitset
+		 * \return Reference to the bitset
+		 * \note The number of bits is not changed
+		 */
+		auto AndNot(const BitSet& other) noexcept -> BitSet&;
+
+		/**
+		 * Count the number of bits set in both bitsets, without creating a new bitset
+		 * \param[in] other Other bitset
+		 * \return Number of bits in the intersection
+		 */
+		auto AndCount(const BitSet& other) const noexcept -> usize;
+		/**
+		 * Count the number of bits set in this bitset, but not in the other bitset, without creating a new bitset
+		 * \param[in] other Other bitset
+		 * \return Number of bits in the difference
+		 */
+		auto AndNotCount(const BitSet& other) const noexcept -> usize;
+		/**
+		 * Count the number of bits set in either bitset, without creating a new bitset
+		 * \param[in] other Other bitset
+		 * \return Number of bits in the union
+		 */
+		auto OrCount(const BitSet& other) const noexcept -> usize;
+		/**
+		 * Count the number of bits that differ between the bitsets, without creating a new bitset
+		 * \param[in] other Other bitset
+		 * \return Number of bits in the symmetric difference
+		 */
+		auto XorCount(const BitSet& other) const noexcept -> usize;
+		/**
+		 * Check if any bit is set in both bitsets
+		 * \param[in] other Other bitset
+		 * \return Whether the bitsets intersect
+		 */
+		auto Intersects(const BitSet& other) const noexcept -> bool;
+
 		/**
 		 * Set a bit to a certain value
 		 * \param[in] idx Index of the bit to set
@@ -114,6 +186,25 @@ namespace Onca
 		 */
 		auto All() const noexcept -> bool;
 
+		/**
+		 * Find the first bit that is set
+		 * \return Index of the first set bit, or NPos if no bit is set
+		 */
+		auto FindFirst() const noexcept -> usize;
+		/**
+		 * Find the first bit that is set after a given bit
+		 * \param[in] idx Index of the bit to start searching after
+		 * \return Index of the next set bit, or NPos if no bit after the index is set
+		 */
+		auto FindNext(usize idx) const noexcept -> usize;
+		/**
+		 * Call a function for the index of each bit that is set, in order
+		 * \tparam F Function type
+		 * \param[in] fun Function
+		 */
+		template<Callable<void, usize> F>
+		void ForEachSetBit(F fun) const noexcept;
+
 		/**
 		 * Resize the bitset to a new number of bits
 		 * \param[in] numBits Number of bits
@@ -136,7 +227,7 @@ namespace Onca
 		 */
 		auto Data() const noexcept -> const usize*;
 		/**
-		 * Get the size of the data (in bytes)
+		 * Get the size of the data (in elements)
 		 * \return Size of the data
 		 */
 		auto DataSize() const noexcept -> usize;
@@ -147,13 +238,23 @@ namespace Onca
 		 */
 		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
 
+		static constexpr usize BitsPerElem = sizeof(usize) * 8; ///< Number of bits in each element of the data
 	private:
-		static constexpr usize BitsPerElem = sizeof(usize) * 8;
 		static constexpr usize BitIdxMask = BitsPerElem - 1;
 
+		/**
+		 * Grow the bitset to at least a number of bits, new bits are unset
+		 * \param[in] numBits Number of bits
+		 */
+		void GrowTo(usize numBits) noexcept;
+		/**
+		 * Unset the bits in the last element that are past the end of the bitset
+		 */
+		void ClearUnusedBits() noexcept;
+
 		DynArray<usize> m_data;    ///< Data
 		usize           m_numBits; ///< Number of bits
 	};
 }
 
-#include "BitSet.inl"
\ No newline at end of file
+#include "BitSet.inl"
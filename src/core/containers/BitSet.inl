@@ -5,6 +5,46 @@
 
 namespace Onca
 {
+	namespace Detail
+	{
+		template <typename F>
+		void BitSetBulkOp(usize* pDst, const usize* pSrc, usize count, F op) noexcept
+		{
+			constexpr usize elemsPerPack = sizeof(BitSetPack) / sizeof(usize);
+
+			usize i = 0;
+			for (; i + elemsPerPack <= count; i += elemsPerPack)
+			{
+				const BitSetPack a = BitSetPack::Load(reinterpret_cast<const u64*>(pDst + i));
+				const BitSetPack b = BitSetPack::Load(reinterpret_cast<const u64*>(pSrc + i));
+				op(a, b).Store(reinterpret_cast<u64*>(pDst + i));
+			}
+			for (; i < count; ++i)
+				pDst[i] = op(pDst[i], pSrc[i]);
+		}
+
+		template <typename F>
+		auto BitSetBulkCount(const usize* pA, const usize* pB, usize count, F op) noexcept -> usize
+		{
+			constexpr usize elemsPerPack = sizeof(BitSetPack) / sizeof(usize);
+
+			usize cnt = 0;
+			usize i = 0;
+			for (; i + elemsPerPack <= count; i += elemsPerPack)
+			{
+				const BitSetPack a = BitSetPack::Load(reinterpret_cast<const u64*>(pA + i));
+				const BitSetPack b = BitSetPack::Load(reinterpret_cast<const u64*>(pB + i));
+				const BitSetPack res = op(a, b);
+				// Pack has no byte shuffle to count bits per lane, so the lanes are counted with the popcnt instruction
+				cnt += Intrin::PopCnt(res.data.u64_[0]) + Intrin::PopCnt(res.data.u64_[1]) +
+				       Intrin::PopCnt(res.data.u64_[2]) + Intrin::PopCnt(res.data.u64_[3]);
+			}
+			for (; i < count; ++i)
+				cnt += Intrin::PopCnt(op(pA[i], pB[i]));
+			return cnt;
+		}
+	}
+
 	inline BitSet::BitSet(Alloc::IAllocator& alloc) noexcept
 		: m_data(alloc)
 		, m_numBits(0)
@@ -12,7 +52,7 @@ namespace Onca
 	}
 
 	inline BitSet::BitSet(usize numBits, Alloc::IAllocator& alloc) noexcept
-		: m_data((numBits + BitIdxMask) / BitsPerElem, alloc)
+		: m_data((numBits + BitIdxMask) / BitsPerElem, usize(0), alloc)
 		, m_numBits(numBits)
 	{
 	}
@@ -44,49 +84,29 @@ namespace Onca
 
 	inline auto BitSet::operator~() const noexcept -> BitSet
 	{
-		BitSet res{ m_numBits, *m_data.GetAllocator() };
-		for (usize i = 0; i < DataSize(); ++i)
-			res.m_data[i] = ~m_data[i];
+		BitSet res{ *this };
+		res.Flip();
 		return res;
 	}
 
 	inline auto BitSet::operator|(const BitSet& other) const noexcept -> BitSet
 	{
-		BitSet res{ Math::Max(m_numBits, other.m_numBits), *m_data.GetAllocator() };
-
-		const usize minElems = Math::Min(DataSize(), other.DataSize());
-		for (usize i = 0; i < minElems; ++i)
-			res.m_data[i] = m_data[i] | other.m_data[i];
-		
-		if (DataSize() > minElems)
-			MemCpy(res.Data() + minElems, Data() + minElems, (DataSize() - minElems) * sizeof(usize));
-		else if (other.DataSize() > minElems)
-			MemCpy(res.Data() + minElems, other.Data() + minElems, (other.DataSize() - minElems) * sizeof(usize));
+		BitSet res{ *this };
+		res |= other;
 		return res;
 	}
 
 	inline auto BitSet::operator^(const BitSet& other) const noexcept -> BitSet
 	{
-		BitSet res{ Math::Max(m_numBits, other.m_numBits), *m_data.GetAllocator() };
-
-		const usize minElems = Math::Min(DataSize(), other.DataSize());
-		for (usize i = 0; i < minElems; ++i)
-			res.m_data[i] = m_data[i] ^ other.m_data[i];
-		
-		if (DataSize() > minElems)
-			MemCpy(res.Data() + minElems, Data() + minElems, DataSize() - minElems);
-		else if (other.DataSize() > minElems)
-			MemCpy(res.Data() + minElems, other.Data() + minElems, other.DataSize() - minElems);
+		BitSet res{ *this };
+		res ^= other;
 		return res;
 	}
 
 	inline auto BitSet::operator&(const BitSet& other) const noexcept -> BitSet
 	{
-		BitSet res{ Math::Max(m_numBits, other.m_numBits), *m_data.GetAllocator() };
-
-		const usize minElems = Math::Min(DataSize(), other.DataSize());
-		for (usize i = 0; i < minElems; ++i)
-			res.m_data[i] = m_data[i] & other.m_data[i];
+		BitSet res{ *this };
+		res &= other;
 		return res;
 	}
 
@@ -107,56 +127,27 @@ namespace Onca
 
 	inline auto BitSet::operator|=(const BitSet& other) noexcept -> BitSet&
 	{
-		usize numElems = DataSize();
-		usize numOtherElems = other.DataSize();
-		if (numOtherElems > numElems)
-			m_data.Resize(numOtherElems);
-		
-		const usize minElems = Math::Min(numElems, numOtherElems);
-		for (usize i = 0; i < minElems; ++i)
-			m_data[i] |= other.m_data[i];
-
-		if (numOtherElems > numElems)
-		{
-			MemCpy(Data() + minElems, other.Data() + minElems, (numOtherElems - numElems) * sizeof(usize));
-		}
-		else
-		{
-			usize mask = usize(-1) << (BitIdxMask - (m_numBits & BitIdxMask));
-			m_data.Back() &= mask;
-		}
+		GrowTo(other.m_numBits);
+		Detail::BitSetBulkOp(Data(), other.Data(), other.DataSize(), [](const auto& a, const auto& b) { return a | b; });
 		return *this;
 	}
 
 	inline auto BitSet::operator^=(const BitSet& other) noexcept -> BitSet&
 	{
-		usize numElems = DataSize();
-		usize numOtherElems = other.DataSize();
-		if (numOtherElems > numElems)
-			m_data.Resize(numOtherElems);
-
-		usize minElems = Math::Min(numElems, numOtherElems);
-		for (usize i = 0; i < minElems; ++i)
-			m_data[i] ^= other.m_data[i];
-
-		if (numOtherElems > numElems)
-		{
-			for (usize i = DataSize(); i < numOtherElems; ++i)
-				m_data[i] = other.m_data[i];
-		}
+		GrowTo(other.m_numBits);
+		Detail::BitSetBulkOp(Data(), other.Data(), other.DataSize(), [](const auto& a, const auto& b) { return a ^ b; });
 		return *this;
 	}
 
 	inline auto BitSet::operator&=(const BitSet& other) noexcept -> BitSet&
 	{
-		usize numElems = DataSize();
-		usize numOtherElems = other.DataSize();
-		if (numOtherElems > numElems)
-			m_data.Resize(numOtherElems);
+		GrowTo(other.m_numBits);
+		const usize numOtherElems = other.DataSize();
+		Detail::BitSetBulkOp(Data(), other.Data(), numOtherElems, [](const auto& a, const auto& b) { return a & b; });
 
-		const usize minSize = Math::Min(numElems, numOtherElems);
-		for (usize i = 0; i < minSize; ++i)
-			m_data[i] &= other.m_data[i];
+		// Bits past the end of the other bitset are 0 in the other bitset
+		if (DataSize() > numOtherElems)
+			MemClear(Data() + numOtherElems, (DataSize() - numOtherElems) * sizeof(usize));
 		return *this;
 	}
 
@@ -174,7 +165,7 @@ namespace Onca
 	{
 		if (m_numBits != other.m_numBits)
 			return false;
-		
+
 		for (usize i = 0; i < m_data.Size(); ++i)
 		{
 			if (m_data[i] != other.m_data[i])
@@ -194,6 +185,61 @@ namespace Onca
 		return true;
 	}
 
+	inline auto BitSet::AndNot(const BitSet& other) noexcept -> BitSet&
+	{
+		const usize minElems = Math::Min(DataSize(), other.DataSize());
+		Detail::BitSetBulkOp(Data(), other.Data(), minElems, [](const auto& a, const auto& b) { return a & ~b; });
+		return *this;
+	}
+
+	inline auto BitSet::AndCount(const BitSet& other) const noexcept -> usize
+	{
+		const usize minElems = Math::Min(DataSize(), other.DataSize());
+		return Detail::BitSetBulkCount(Data(), other.Data(), minElems, [](const auto& a, const auto& b) { return a & b; });
+	}
+
+	inline auto BitSet::AndNotCount(const BitSet& other) const noexcept -> usize
+	{
+		const usize minElems = Math::Min(DataSize(), other.DataSize());
+		usize cnt = Detail::BitSetBulkCount(Data(), other.Data(), minElems, [](const auto& a, const auto& b) { return a & ~b; });
+		for (usize i = minElems; i < DataSize(); ++i)
+			cnt += Intrin::PopCnt(m_data[i]);
+		return cnt;
+	}
+
+	inline auto BitSet::OrCount(const BitSet& other) const noexcept -> usize
+	{
+		const usize minElems = Math::Min(DataSize(), other.DataSize());
+		usize cnt = Detail::BitSetBulkCount(Data(), other.Data(), minElems, [](const auto& a, const auto& b) { return a | b; });
+
+		const BitSet& larger = DataSize() > minElems ? *this : other;
+		for (usize i = minElems; i < larger.DataSize(); ++i)
+			cnt += Intrin::PopCnt(larger.m_data[i]);
+		return cnt;
+	}
+
+	inline auto BitSet::XorCount(const BitSet& other) const noexcept -> usize
+	{
+		const usize minElems = Math::Min(DataSize(), other.DataSize());
+		usize cnt = Detail::BitSetBulkCount(Data(), other.Data(), minElems, [](const auto& a, const auto& b) { return a ^ b; });
+
+		const BitSet& larger = DataSize() > minElems ? *this : other;
+		for (usize i = minElems; i < larger.DataSize(); ++i)
+			cnt += Intrin::PopCnt(larger.m_data[i]);
+		return cnt;
+	}
+
+	inline auto BitSet::Intersects(const BitSet& other) const noexcept -> bool
+	{
+		const usize minElems = Math::Min(DataSize(), other.DataSize());
+		for (usize i = 0; i < minElems; ++i)
+		{
+			if (m_data[i] & other.m_data[i])
+				return true;
+		}
+		return false;
+	}
+
 	inline void BitSet::Set(usize idx, bool val) noexcept
 	{
 		if (val)
@@ -231,6 +277,7 @@ namespace Onca
 	{
 		for (usize i = 0; i < DataSize(); ++i)
 			m_data[i] = ~m_data[i];
+		ClearUnusedBits();
 	}
 
 	inline auto BitSet::Count() const noexcept -> usize
@@ -245,22 +292,11 @@ namespace Onca
 
 	inline auto BitSet::None() const noexcept -> bool
 	{
-		if (m_numBits == 0)
-			return true;
-		
-		for (usize i = 0; i < m_data.Size(); ++i)
-		{
-			if (m_data[i])
-				return false;
-		}
-		return true;
+		return !Any();
 	}
 
 	inline auto BitSet::Any() const noexcept -> bool
 	{
-		if (m_numBits == 0)
-			return true;
-		
 		for (usize i = 0; i < m_data.Size(); ++i)
 		{
 			if (m_data[i])
@@ -274,26 +310,73 @@ namespace Onca
 		if (m_numBits == 0)
 			return true;
 
-		const usize numFullBytes = m_numBits / BitsPerElem;
-		for (usize i = 0; i < numFullBytes; ++i)
+		const usize numFullElems = m_numBits / BitsPerElem;
+		for (usize i = 0; i < numFullElems; ++i)
 		{
-			if (m_data[i] != 0xFF)
+			if (m_data[i] != usize(-1))
 				return false;
 		}
 
 		const usize finalBits = m_numBits & BitIdxMask;
-		const u8 bitMask = usize(-1) << (BitIdxMask - finalBits);
-		return (m_data.Back() & bitMask) == bitMask;
+		if (finalBits == 0)
+			return true;
+
+		const usize bitMask = usize(-1) << (BitsPerElem - finalBits);
+		return m_data.Back() == bitMask;
+	}
+
+	inline auto BitSet::FindFirst() const noexcept -> usize
+	{
+		for (usize i = 0; i < DataSize(); ++i)
+		{
+			if (m_data[i])
+				return i * BitsPerElem + Intrin::ZeroCountMSB(m_data[i]);
+		}
+		return NPos;
+	}
+
+	inline auto BitSet::FindNext(usize idx) const noexcept -> usize
+	{
+		++idx;
+		if (idx >= m_numBits)
+			return NPos;
+
+		usize elemIdx = idx / BitsPerElem;
+		const usize bitIdx = idx & BitIdxMask;
+
+		// Mask out the bits up to and including the given bit
+		const usize elem = m_data[elemIdx] & (usize(-1) >> bitIdx);
+		if (elem)
+			return elemIdx * BitsPerElem + Intrin::ZeroCountMSB(elem);
+
+		for (++elemIdx; elemIdx < DataSize(); ++elemIdx)
+		{
+			if (m_data[elemIdx])
+				return elemIdx * BitsPerElem + Intrin::ZeroCountMSB(m_data[elemIdx]);
+		}
+		return NPos;
+	}
+
+	template <Callable<void, usize> F>
+	void BitSet::ForEachSetBit(F fun) const noexcept
+	{
+		for (usize i = 0; i < DataSize(); ++i)
+		{
+			usize elem = m_data[i];
+			while (elem)
+			{
+				const u8 bitIdx = Intrin::ZeroCountMSB(elem);
+				fun(i * BitsPerElem + bitIdx);
+				elem &= ~(usize(1) << (BitIdxMask - bitIdx));
+			}
+		}
 	}
 
 	inline void BitSet::Resize(usize numBits) noexcept
 	{
 		m_data.Resize((numBits + BitIdxMask) / BitsPerElem);
-
-		const usize bits = numBits < m_numBits ? numBits : m_numBits;
-		const usize elemIdx = bits / BitsPerElem;
-		const usize bitIdx = bits & BitsPerElem;
-		m_data[elemIdx] &= usize(-1) >> (BitIdxMask - bitIdx);
+		m_numBits = numBits;
+		ClearUnusedBits();
 	}
 
 	inline auto BitSet::NumBits() const noexcept -> usize
@@ -320,4 +403,20 @@ namespace Onca
 	{
 		return m_data.GetAllocator();
 	}
+
+	inline void BitSet::GrowTo(usize numBits) noexcept
+	{
+		if (numBits <= m_numBits)
+			return;
+
+		m_data.Resize((numBits + BitIdxMask) / BitsPerElem);
+		m_numBits = numBits;
+	}
+
+	inline void BitSet::ClearUnusedBits() noexcept
+	{
+		const usize finalBits = m_numBits & BitIdxMask;
+		if (finalBits)
+			m_data.Back() &= usize(-1) << (BitsPerElem - finalBits);
+	}
 }
@@ -167,6 +167,9 @@ namespace Onca
 		DynArray<u8> m_data;   ///< Data
 		usize        m_cursor; ///< Cursor into data (index)
 	};
+
+	template<>
+	constexpr bool IsTriviallyRelocatable<ByteBuffer> = true;
 	
 }
 
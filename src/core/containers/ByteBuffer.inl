@@ -105,7 +105,7 @@ namespace Onca
 	template <typename T>
 	auto ByteBuffer::Peek(usize offset) noexcept -> const T&
 	{
-		ASSERT(m_cursor + offset < Size(), "Peek out of range");
+		ASSERT(m_cursor + offset + sizeof(T) <= Size(), "Peek out of range");
 		return *reinterpret_cast<T*>(&m_data[m_cursor + offset]);
 	}
 
@@ -113,8 +113,8 @@ namespace Onca
 	auto ByteBuffer::Read(usize offset) noexcept -> const T&
 	{
 		usize readPos = m_cursor + offset;
-		ASSERT(readPos < Size(), "Read out of range");
-		m_cursor += offset;
+		ASSERT(readPos + sizeof(T) <= Size(), "Read out of range");
+		m_cursor = readPos + sizeof(T);
 		return *reinterpret_cast<T*>(&m_data[readPos]);
 	}
 
@@ -134,6 +134,11 @@ namespace Onca
 		Write(val);
 	}
 
+	inline auto ByteBuffer::GetCursor() const noexcept -> usize
+	{
+		return m_cursor;
+	}
+
 	inline auto ByteBuffer::GetContainer() noexcept -> DynArray<u8>&
 	{
 		return m_data;
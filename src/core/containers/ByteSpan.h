@@ -0,0 +1,177 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "DynArray.h"
+#include "ByteBuffer.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Non-owning view into a range of constant bytes
+	 *
+	 * A ByteSpan can wrap any contiguous memory, like a ByteBuffer, a mapped file or an I/O buffer, without copying it.
+	 * The memory needs to outlive the span.
+	 */
+	class ByteSpan
+	{
+	public:
+		/**
+		 * Create an empty ByteSpan
+		 */
+		constexpr ByteSpan() noexcept;
+		/**
+		 * Create a ByteSpan from a pointer and a size
+		 * \param[in] pData Pointer to the data
+		 * \param[in] size Size of the data
+		 */
+		constexpr ByteSpan(const u8* pData, usize size) noexcept;
+		/**
+		 * Create a ByteSpan from a pointer to any memory and a size
+		 * \param[in] pData Pointer to the data
+		 * \param[in] size Size of the data
+		 */
+		ByteSpan(const void* pData, usize size) noexcept;
+		/**
+		 * Create a ByteSpan viewing the contents of a ByteBuffer
+		 * \param[in] buffer ByteBuffer
+		 */
+		ByteSpan(const ByteBuffer& buffer) noexcept;
+		/**
+		 * Create a ByteSpan viewing the contents of a DynArray
+		 * \param[in] data DynArray with data
+		 */
+		ByteSpan(const DynArray<u8>& data) noexcept;
+
+		constexpr auto operator[](usize idx) const noexcept -> u8;
+
+		auto operator==(const ByteSpan& other) const noexcept -> bool;
+
+		/**
+		 * Get a span of part of the bytes
+		 * \param[in] offset Offset of the first byte
+		 * \param[in] count Number of bytes, clamped to the number of bytes after the offset
+		 * \return Span of the bytes
+		 */
+		constexpr auto SubSpan(usize offset, usize count = usize(-1)) const noexcept -> ByteSpan;
+		/**
+		 * Get a span of the first bytes
+		 * \param[in] count Number of bytes
+		 * \return Span of the bytes
+		 */
+		constexpr auto First(usize count) const noexcept -> ByteSpan;
+		/**
+		 * Get a span of the last bytes
+		 * \param[in] count Number of bytes
+		 * \return Span of the bytes
+		 */
+		constexpr auto Last(usize count) const noexcept -> ByteSpan;
+
+		/**
+		 * Get the size of the span
+		 * \return Size of the span
+		 */
+		constexpr auto Size() const noexcept -> usize;
+		/**
+		 * Check if the span is empty
+		 * \return Whether the span is empty
+		 */
+		constexpr auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get a pointer to the span's data
+		 * \return Pointer to the span's data
+		 */
+		constexpr auto Data() const noexcept -> const u8*;
+
+		constexpr auto begin() const noexcept -> const u8*;
+		constexpr auto end() const noexcept -> const u8*;
+
+	private:
+		const u8* m_pData; ///< Pointer to the data
+		usize     m_size;  ///< Size of the data
+	};
+
+	/**
+	 * \brief Non-owning view into a range of modifiable bytes
+	 *
+	 * A MutableByteSpan can wrap any contiguous memory, like a ByteBuffer, a mapped file or an I/O buffer, without copying it.
+	 * The memory needs to outlive the span.
+	 */
+	class MutableByteSpan
+	{
+	public:
+		/**
+		 * Create an empty MutableByteSpan
+		 */
+		constexpr MutableByteSpan() noexcept;
+		/**
+		 * Create a MutableByteSpan from a pointer and a size
+		 * \param[in] pData Pointer to the data
+		 * \param[in] size Size of the data
+		 */
+		constexpr MutableByteSpan(u8* pData, usize size) noexcept;
+		/**
+		 * Create a MutableByteSpan from a pointer to any memory and a size
+		 * \param[in] pData Pointer to the data
+		 * \param[in] size Size of the data
+		 */
+		MutableByteSpan(void* pData, usize size) noexcept;
+		/**
+		 * Create a MutableByteSpan viewing the contents of a ByteBuffer
+		 * \param[in] buffer ByteBuffer
+		 */
+		MutableByteSpan(ByteBuffer& buffer) noexcept;
+		/**
+		 * Create a MutableByteSpan viewing the contents of a DynArray
+		 * \param[in] data DynArray with data
+		 */
+		MutableByteSpan(DynArray<u8>& data) noexcept;
+
+		constexpr operator ByteSpan() const noexcept;
+
+		constexpr auto operator[](usize idx) const noexcept -> u8&;
+
+		/**
+		 * Get a span of part of the bytes
+		 * \param[in] offset Offset of the first byte
+		 * \param[in] count Number of bytes, clamped to the number of bytes after the offset
+		 * \return Span of the bytes
+		 */
+		constexpr auto SubSpan(usize offset, usize count = usize(-1)) const noexcept -> MutableByteSpan;
+		/**
+		 * Get a span of the first bytes
+		 * \param[in] count Number of bytes
+		 * \return Span of the bytes
+		 */
+		constexpr auto First(usize count) const noexcept -> MutableByteSpan;
+		/**
+		 * Get a span of the last bytes
+		 * \param[in] count Number of bytes
+		 * \return Span of the bytes
+		 */
+		constexpr auto Last(usize count) const noexcept -> MutableByteSpan;
+
+		/**
+		 * Get the size of the span
+		 * \return Size of the span
+		 */
+		constexpr auto Size() const noexcept -> usize;
+		/**
+		 * Check if the span is empty
+		 * \return Whether the span is empty
+		 */
+		constexpr auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get a pointer to the span's data
+		 * \return Pointer to the span's data
+		 */
+		constexpr auto Data() const noexcept -> u8*;
+
+		constexpr auto begin() const noexcept -> u8*;
+		constexpr auto end() const noexcept -> u8*;
+
+	private:
+		u8*   m_pData; ///< Pointer to the data
+		usize m_size;  ///< Size of the data
+	};
+}
+
+#include "ByteSpan.inl"
@@ -0,0 +1,179 @@
+#pragma once
+#if __RESHARPER__
+#include "ByteSpan.h"
+#endif
+
+namespace Onca
+{
+	constexpr ByteSpan::ByteSpan() noexcept
+		: m_pData(nullptr)
+		, m_size(0)
+	{
+	}
+
+	constexpr ByteSpan::ByteSpan(const u8* pData, usize size) noexcept
+		: m_pData(pData)
+		, m_size(size)
+	{
+	}
+
+	inline ByteSpan::ByteSpan(const void* pData, usize size) noexcept
+		: m_pData(static_cast<const u8*>(pData))
+		, m_size(size)
+	{
+	}
+
+	inline ByteSpan::ByteSpan(const ByteBuffer& buffer) noexcept
+		: m_pData(buffer.Data())
+		, m_size(buffer.Size())
+	{
+	}
+
+	inline ByteSpan::ByteSpan(const DynArray<u8>& data) noexcept
+		: m_pData(data.Data())
+		, m_size(data.Size())
+	{
+	}
+
+	constexpr auto ByteSpan::operator[](usize idx) const noexcept -> u8
+	{
+		ASSERT(idx < m_size, "Index out of range");
+		return m_pData[idx];
+	}
+
+	inline auto ByteSpan::operator==(const ByteSpan& other) const noexcept -> bool
+	{
+		if (m_size != other.m_size)
+			return false;
+		return m_pData == other.m_pData || MemCmp(m_pData, other.m_pData, m_size) == 0;
+	}
+
+	constexpr auto ByteSpan::SubSpan(usize offset, usize count) const noexcept -> ByteSpan
+	{
+		ASSERT(offset <= m_size, "Offset out of range");
+		return { m_pData + offset, Math::Min(count, m_size - offset) };
+	}
+
+	constexpr auto ByteSpan::First(usize count) const noexcept -> ByteSpan
+	{
+		ASSERT(count <= m_size, "Count out of range");
+		return { m_pData, count };
+	}
+
+	constexpr auto ByteSpan::Last(usize count) const noexcept -> ByteSpan
+	{
+		ASSERT(count <= m_size, "Count out of range");
+		return { m_pData + m_size - count, count };
+	}
+
+	constexpr auto ByteSpan::Size() const noexcept -> usize
+	{
+		return m_size;
+	}
+
+	constexpr auto ByteSpan::IsEmpty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	constexpr auto ByteSpan::Data() const noexcept -> const u8*
+	{
+		return m_pData;
+	}
+
+	constexpr auto ByteSpan::begin() const noexcept -> const u8*
+	{
+		return m_pData;
+	}
+
+	constexpr auto ByteSpan::end() const noexcept -> const u8*
+	{
+		return m_pData + m_size;
+	}
+
+	////////////////////////////////////////////////////////////////
+
+	constexpr MutableByteSpan::MutableByteSpan() noexcept
+		: m_pData(nullptr)
+		, m_size(0)
+	{
+	}
+
+	constexpr MutableByteSpan::MutableByteSpan(u8* pData, usize size) noexcept
+		: m_pData(pData)
+		, m_size(size)
+	{
+	}
+
+	inline MutableByteSpan::MutableByteSpan(void* pData, usize size) noexcept
+		: m_pData(static_cast<u8*>(pData))
+		, m_size(size)
+	{
+	}
+
+	inline MutableByteSpan::MutableByteSpan(ByteBuffer& buffer) noexcept
+		: m_pData(buffer.Data())
+		, m_size(buffer.Size())
+	{
+	}
+
+	inline MutableByteSpan::MutableByteSpan(DynArray<u8>& data) noexcept
+		: m_pData(data.Data())
+		, m_size(data.Size())
+	{
+	}
+
+	constexpr MutableByteSpan::operator ByteSpan() const noexcept
+	{
+		return { m_pData, m_size };
+	}
+
+	constexpr auto MutableByteSpan::operator[](usize idx) const noexcept -> u8&
+	{
+		ASSERT(idx < m_size, "Index out of range");
+		return m_pData[idx];
+	}
+
+	constexpr auto MutableByteSpan::SubSpan(usize offset, usize count) const noexcept -> MutableByteSpan
+	{
+		ASSERT(offset <= m_size, "Offset out of range");
+		return { m_pData + offset, Math::Min(count, m_size - offset) };
+	}
+
+	constexpr auto MutableByteSpan::First(usize count) const noexcept -> MutableByteSpan
+	{
+		ASSERT(count <= m_size, "Count out of range");
+		return { m_pData, count };
+	}
+
+	constexpr auto MutableByteSpan::Last(usize count) const noexcept -> MutableByteSpan
+	{
+		ASSERT(count <= m_size, "Count out of range");
+		return { m_pData + m_size - count, count };
+	}
+
+	constexpr auto MutableByteSpan::Size() const noexcept -> usize
+	{
+		return m_size;
+	}
+
+	constexpr auto MutableByteSpan::IsEmpty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	constexpr auto MutableByteSpan::Data() const noexcept -> u8*
+	{
+		return m_pData;
+	}
+
+	constexpr auto MutableByteSpan::begin() const noexcept -> u8*
+	{
+		return m_pData;
+	}
+
+	constexpr auto MutableByteSpan::end() const noexcept -> u8*
+	{
+		return m_pData + m_size;
+	}
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "core/memory/CompactMemRef.h"
+#include "core/allocator/ContainerAlloc.h"
+#include "core/threading/Sync.h"
+#include "HashMap.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Hash map split into independently locked shards (threadsafe)
+	 *
+	 * Every key is assigned to a shard using the upper bits of its hash, each shard is a HashMap with its own mutex,
+	 * so threads that access keys in different shards never contend for the same lock.
+	 * Shards are aligned to a cache line, so locking one shard does not invalidate the cache line of its neighbours.
+	 *
+	 * Values are returned by copy, as a reference into a shard would not be protected by its lock, use Update() to modify a value in place.
+	 *
+	 * \tparam K Key type (needs to conform to Onca::Movable)
+	 * \tparam V Value type (needs to conform to Onca::Movable)
+	 * \tparam H Hasher
+	 * \tparam C Equality comparator
+	 * \note Functors passed to the map are called while a shard is locked, and may not access the map themselves
+	 */
+	template<typename K, typename V, Hasher<K> H = Hash<K>, EqualsComparator<K> C = DefaultEqualComparator<K>>
+	class ConcurrentHashMap
+	{
+		STATIC_ASSERT(Movable<K>, "Key needs to be movable to be used in a ConcurrentHashMap");
+		STATIC_ASSERT(Movable<V>, "Value needs to be movable to be used in a ConcurrentHashMap");
+	public:
+		static constexpr usize DefaultShardCount = 64; ///< Default number of shards
+
+		/**
+		 * Create a ConcurrentHashMap
+		 * \param[in] shardCount Minimum number of shards, rounded up to a power of 2
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit ConcurrentHashMap(usize shardCount = DefaultShardCount, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		~ConcurrentHashMap() noexcept;
+
+		DISABLE_COPY(ConcurrentHashMap);
+		DISABLE_MOVE(ConcurrentHashMap);
+
+		/**
+		 * Insert a key-value pair into the map, override value if it already exists
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return Whether the key was newly inserted
+		 */
+		auto Insert(const K& key, const V& val) noexcept -> bool requires CopyConstructible<K> && CopyConstructible<V>;
+		/**
+		 * Insert a key-value pair into the map, override value if it already exists
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return Whether the key was newly inserted
+		 */
+		auto Insert(K&& key, V&& val) noexcept -> bool;
+		/**
+		 * Try to insert a key-value pair into the map
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return Whether the pair was inserted, false if the key already exists
+		 */
+		auto TryInsert(const K& key, const V& val) noexcept -> bool requires CopyConstructible<K> && CopyConstructible<V>;
+		/**
+		 * Try to insert a key-value pair into the map
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return Whether the pair was inserted, false if the key already exists
+		 */
+		auto TryInsert(K&& key, V&& val) noexcept -> bool;
+
+		/**
+		 * Erase an element from the map
+		 * \param[in] key Key
+		 * \return Whether an element was erased
+		 */
+		auto Erase(const K& key) noexcept -> bool;
+
+		/**
+		 * Get a copy of the value at a key
+		 * \param[in] key Key
+		 * \return Copy of the value, or nothing if the key does not exist
+		 */
+		auto At(const K& key) const noexcept -> Optional<V> requires CopyConstructible<V>;
+		/**
+		 * Check if the map contains a key
+		 * \param[in] key Key
+		 * \return Whether the map contains the key
+		 */
+		auto Contains(const K& key) const noexcept -> bool;
+
+		/**
+		 * Modify the value at a key while its shard is locked
+		 * \tparam F Functor type
+		 * \param[in] key Key
+		 * \param[in] fun Functor modifying the value
+		 * \return Whether the key exists
+		 */
+		template<Callable<void, V&> F>
+		auto Update(const K& key, F fun) noexcept -> bool;
+		/**
+		 * Call a functor for all elements in the map, locking one shard at a time
+		 * \tparam F Functor type
+		 * \param[in] fun Functor
+		 * \note Elements in shards that were already visited can be modified by other threads while the remaining shards are iterated
+		 */
+		template<Callable<void, const K&, const V&> F>
+		void ForEach(F fun) const noexcept;
+
+		/**
+		 * Clear the contents of the map
+		 * \param[in] clearMemory Whether to deallocate the memory of the shards
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+
+		/**
+		 * Get the size of the map
+		 * \return Size of the map
+		 * \note The size is only an approximation when the map is being modified by other threads
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the map is empty
+		 * \return Whether the map is empty
+		 * \note The result is only an approximation when the map is being modified by other threads
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get the number of shards
+		 * \return Number of shards
+		 */
+		auto GetShardCount() const noexcept -> usize;
+
+		/**
+		 * Get the allocator used by the map
+		 * \return Allocator used by the map
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		/**
+		 * Shard of the map
+		 */
+		struct alignas(64) Shard
+		{
+			explicit Shard(Alloc::IAllocator& alloc) noexcept : map(alloc) {}
+
+			mutable Threading::Mutex mutex; ///< Mutex guarding the shard
+			HashMap<K, V, H, C>      map;   ///< Elements in the shard
+		};
+
+		/**
+		 * Get the shard a key belongs to
+		 * \param[in] key Key
+		 * \return Shard
+		 */
+		auto GetShard(const K& key) const noexcept -> Shard&;
+
+		Alloc::ContainerAlloc m_alloc;     ///< Allocator
+		CompactMemRef<Shard>  m_shards;    ///< Shards
+		usize                 m_shardMask; ///< Number of shards - 1
+	};
+}
+
+#include "ConcurrentHashMap.inl"
@@ -0,0 +1,174 @@
+#pragma once
+#if __RESHARPER__
+#include "ConcurrentHashMap.h"
+#endif
+
+namespace Onca
+{
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	ConcurrentHashMap<K, V, H, C>::ConcurrentHashMap(usize shardCount, Alloc::IAllocator& alloc) noexcept
+		: m_alloc(alloc)
+		, m_shardMask(0)
+	{
+		shardCount = Math::Max<usize>(shardCount, 1);
+		if (!Math::IsPowOf2(shardCount))
+			shardCount = usize(1) << (Intrin::BitScanMSB(shardCount) + 1);
+
+		m_shards = m_alloc.Allocate<Shard>(shardCount);
+		ASSERT(m_shards, "Failed to allocate the shards of the map");
+		m_shardMask = shardCount - 1;
+
+		Shard* pShards = m_shards.Ptr();
+		for (usize i = 0; i < shardCount; ++i)
+			new (pShards + i) Shard{ alloc };
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	ConcurrentHashMap<K, V, H, C>::~ConcurrentHashMap() noexcept
+	{
+		Shard* pShards = m_shards.Ptr();
+		for (usize i = 0; i <= m_shardMask; ++i)
+			pShards[i].~Shard();
+		m_alloc.Deallocate(Move(m_shards), m_shardMask + 1);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::Insert(const K& key, const V& val) noexcept -> bool requires CopyConstructible<K> && CopyConstructible<V>
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		return shard.map.Insert(key, val).second;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::Insert(K&& key, V&& val) noexcept -> bool
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		return shard.map.Insert(Move(key), Move(val)).second;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::TryInsert(const K& key, const V& val) noexcept -> bool requires CopyConstructible<K> && CopyConstructible<V>
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		return shard.map.TryInsert(key, val).second;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::TryInsert(K&& key, V&& val) noexcept -> bool
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		return shard.map.TryInsert(Move(key), Move(val)).second;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::Erase(const K& key) noexcept -> bool
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		return shard.map.Erase(key) != 0;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::At(const K& key) const noexcept -> Optional<V> requires CopyConstructible<V>
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		return shard.map.At(key);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::Contains(const K& key) const noexcept -> bool
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		return shard.map.Contains(key);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	template <Callable<void, V&> F>
+	auto ConcurrentHashMap<K, V, H, C>::Update(const K& key, F fun) noexcept -> bool
+	{
+		Shard& shard = GetShard(key);
+		Threading::Lock lock{ shard.mutex };
+		auto it = shard.map.Find(key);
+		if (it == shard.map.End())
+			return false;
+		fun(it->second);
+		return true;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	template <Callable<void, const K&, const V&> F>
+	void ConcurrentHashMap<K, V, H, C>::ForEach(F fun) const noexcept
+	{
+		const Shard* pShards = m_shards.Ptr();
+		for (usize i = 0; i <= m_shardMask; ++i)
+		{
+			const Shard& shard = pShards[i];
+			Threading::Lock lock{ shard.mutex };
+			for (const Pair<const K, V>& pair : shard.map)
+				fun(pair.first, pair.second);
+		}
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	void ConcurrentHashMap<K, V, H, C>::Clear(bool clearMemory) noexcept
+	{
+		Shard* pShards = m_shards.Ptr();
+		for (usize i = 0; i <= m_shardMask; ++i)
+		{
+			Threading::Lock lock{ pShards[i].mutex };
+			pShards[i].map.Clear(clearMemory);
+		}
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::Size() const noexcept -> usize
+	{
+		usize size = 0;
+		const Shard* pShards = m_shards.Ptr();
+		for (usize i = 0; i <= m_shardMask; ++i)
+		{
+			Threading::Lock lock{ pShards[i].mutex };
+			size += pShards[i].map.Size();
+		}
+		return size;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::IsEmpty() const noexcept -> bool
+	{
+		const Shard* pShards = m_shards.Ptr();
+		for (usize i = 0; i <= m_shardMask; ++i)
+		{
+			Threading::Lock lock{ pShards[i].mutex };
+			if (!pShards[i].map.IsEmpty())
+				return false;
+		}
+		return true;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::GetShardCount() const noexcept -> usize
+	{
+		return m_shardMask + 1;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_alloc.Get();
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto ConcurrentHashMap<K, V, H, C>::GetShard(const K& key) const noexcept -> Shard&
+	{
+		// The HashMap picks its bucket from the lower bits of the hash, so use the upper bits to pick the shard, keeping the buckets within a shard evenly used
+		const u64 hash = H{}(key);
+		return m_shards.Ptr()[(hash >> 32) & m_shardMask];
+	}
+}
@@ -4,6 +4,7 @@
 
 #include "DynArray.h"
 #include "InplaceDynArray.h"
+#include "SmallDynArray.h"
 
 #include "Deque.h"
 
@@ -15,10 +16,33 @@
 #include "HashMap.h"
 #include "HashSet.h"
 
+#include "SlotMap.h"
+#include "SparseSet.h"
+
 #include "RedBlackTree.h"
 #include "SortedSet.h"
 
+#include "FlatSet.h"
+#include "FlatMap.h"
+#include "EytzingerIndex.h"
+
+#include "PriorityQueue.h"
+#include "PairingHeap.h"
+#include "TimerWheel.h"
+
+#include "PVector.h"
+#include "PHashMap.h"
+
 #include "ByteBuffer.h"
+#include "ByteSpan.h"
 
 #include "BitSet.h"
-#include "InplaceBitSet.h"
\ No newline at end of file
+#include "InplaceBitSet.h"
+#include "RankSelectIndex.h"
+#include "RoaringBitSet.h"
+
+#include "SpscRing.h"
+#include "MpmcQueue.h"
+#include "MpscQueue.h"
+#include "WorkStealingDeque.h"
+#include "ConcurrentHashMap.h"
\ No newline at end of file
@@ -1,24 +1,43 @@
 #pragma once
 #include "core/MinInclude.h"
 #include "core/allocator/GlobalAlloc.h"
-#include "core/memory/MemRef.h"
+#include "core/memory/CompactMemRef.h"
+#include "core/allocator/ContainerAlloc.h"
 
 namespace Onca
 {
+	namespace Detail
+	{
+		constexpr usize DequeBlockByteSize = 4096; ///< Size in bytes targeted by automatically sized Deque blocks
+		constexpr usize DequeMinBlockSize  = 16;   ///< Minimum number of elements in an automatically sized Deque block
+
+		/**
+		 * Get the number of elements in an automatically sized Deque block
+		 * \tparam T Element type
+		 * \return Largest power of 2 number of elements that fits in DequeBlockByteSize, but at least DequeMinBlockSize
+		 */
+		template<typename T>
+		constexpr auto DequeAutoBlockSize() noexcept -> usize;
+	}
 
 	/**
 	 * A double-ended queue
+	 *
+	 * Elements are stored in fixed size blocks, which are referenced from a block table. Blocks that are no longer used after a pop or clear are kept in the table
+	 * and reused when the Deque grows again, they are only deallocated when the memory of the Deque is cleared.
+	 *
 	 * \tparam T Underlying type (needs to conform to Onca::Movable)
-	 * \tparam BlockSize Size of a block allocated by the Deque
+	 * \tparam BlockSize Number of elements in a block allocated by the Deque, 0 to size blocks to Detail::DequeBlockByteSize bytes
 	 */
 	// TODO: Balance MemRefs in base array to be centered (less moving on PushFront)
-	template<typename T, usize BlockSize = 8>
+	template<typename T, usize BlockSize = 0>
 	class Deque
 	{
 		// static assert to get around incomplete type issues when a class can return a Deque of itself
 		STATIC_ASSERT(Movable<T>, "Type needs to be movable to be used in a Deque");
-		STATIC_ASSERT(Math::IsPowOf2(BlockSize), "BlockSize needs to be a power of 2");
+		STATIC_ASSERT(Math::IsPowOf2(BlockSize) || BlockSize == 0, "BlockSize needs to be a power of 2");
 	public:
+		static constexpr usize ElemsPerBlock = BlockSize ? BlockSize : Detail::DequeAutoBlockSize<T>(); ///< Number of elements in a block
 
 		/**
 		 * Deque iterator
@@ -57,9 +76,9 @@ namespace Onca
 			auto operator[](usize idx) const noexcept -> const T&;
 
 		private:
-			Iterator(const MemRef<MemRef<T>>& blocks, usize blockOffset, usize idx) noexcept;
+			Iterator(CompactMemRef<T>* pBlocks, usize blockOffset, usize idx) noexcept;
 
-			MemRef<MemRef<T>> m_blocks;   ///< Deque blocks
+			CompactMemRef<T>* m_pBlocks;  ///< Deque blocks
 			usize             m_blockIdx; ///< Index of block
 			usize             m_idx;      ///< Index in block
 
@@ -137,11 +156,11 @@ namespace Onca
 		Deque(Deque<T, B>&& other, Alloc::IAllocator& alloc) noexcept;
 		~Deque() noexcept;
 
-		auto operator=(const InitializerList<T>& il) noexcept -> Deque<T>& requires CopyConstructible<T>;
-		auto operator=(const Deque& other) noexcept -> Deque<T>& requires CopyConstructible<T>;
+		auto operator=(const InitializerList<T>& il) noexcept -> Deque& requires CopyConstructible<T>;
+		auto operator=(const Deque& other) noexcept -> Deque& requires CopyConstructible<T>;
 		template<usize B>
-		auto operator=(const Deque<T, B>& other) noexcept -> Deque<T>& requires CopyConstructible<T>;
-		auto operator=(Deque&& other) noexcept -> Deque<T>&;
+		auto operator=(const Deque<T, B>& other) noexcept -> Deque& requires CopyConstructible<T>;
+		auto operator=(Deque&& other) noexcept -> Deque&;
 
 		/**
 		 * Assign an iterable range to the Deque
@@ -239,6 +258,13 @@ namespace Onca
 		 */
 		template<usize B>
 		void Push(Deque<T, B>&& other);
+		/**
+		 * Add a contiguous range of elements to the Deque
+		 * \param[in] pData Pointer to the elements
+		 * \param[in] count Number of elements
+		 * \note All needed blocks are allocated up front, after which the elements are copied a block at a time
+		 */
+		void Push(const T* pData, usize count) noexcept requires CopyConstructible<T>;
 
 		/**
 		 * Emplace an element at the back of the Deque
@@ -326,10 +352,20 @@ namespace Onca
 		 * Remove the first element from the Deque
 		 */
 		void PopFront() noexcept;
+		/**
+		 * Remove a number of elements from the front of the Deque
+		 * \param[in] count Number of elements to remove
+		 */
+		void PopFront(usize count) noexcept;
 		/**
 		 * Remove the last element from the Deque
 		 */
 		void Pop() noexcept;
+		/**
+		 * Remove a number of elements from the back of the Deque
+		 * \param[in] count Number of elements to remove
+		 */
+		void Pop(usize count) noexcept;
 		/**
 		 * Erase an element from the Deque
 		 * \param[in] it Iterator to element to erase
@@ -495,12 +531,16 @@ namespace Onca
 		auto cend() const noexcept -> ConstIterator;
 
 	private:
-		static constexpr usize Mask          = BlockSize - 1;         ///< Mask to mask out index bits
-		static constexpr usize BlockByteSize = BlockSize * sizeof(T); ///< Size of a block in bytes
+		template<typename, usize>
+		friend class Deque;
 
-		MemRef<MemRef<T>> m_blocks;     ///< Array of blocks
-		usize             m_initialIdx; ///< Starting index in the first block
-		usize             m_size;       ///< Size of the deck
+		static constexpr usize Mask          = ElemsPerBlock - 1;         ///< Mask to mask out index bits
+		static constexpr usize BlockByteSize = ElemsPerBlock * sizeof(T); ///< Size of a block in bytes
+
+		CompactMemRef<CompactMemRef<T>> m_blocks;     ///< Array of blocks, with its capacity stored in front of the blocks, unused entries are either null or a spare block
+		Alloc::ContainerAlloc           m_alloc;      ///< Allocator
+		usize                           m_initialIdx; ///< Starting index in the first block
+		usize                           m_size;       ///< Size of the deck
 
 		/**
 		 * Get the block offset and index of the element
@@ -520,7 +560,7 @@ namespace Onca
 		 * \param[in] idx Index of the element
 		 * \return Address of the element
 		 */
-		auto GetElemAddr(MemRef<T>* pBegin, usize idx) const noexcept -> T*;
+		auto GetElemAddr(CompactMemRef<T>* pBegin, usize idx) const noexcept -> T*;
 		
 		/**
 		 * Add a number of blocks at the back of the current blocks
@@ -540,7 +580,19 @@ namespace Onca
 		 * \return Pointer to the first new element in the base array
 		 */
 		template<bool AtBack>
-		auto ReserveBase(usize numAdditionalBlocks) noexcept -> MemRef<T>*;
+		auto ReserveBase(usize numAdditionalBlocks) noexcept -> CompactMemRef<T>*;
+		/**
+		 * Rotate blocks in the block table to the left
+		 * \param[in] pBlocks Pointer to the first block to rotate
+		 * \param[in] count Number of blocks to rotate
+		 * \param[in] shift Number of places to rotate the blocks by
+		 */
+		static void RotateBlocks(CompactMemRef<T>* pBlocks, usize count, usize shift) noexcept;
+		/**
+		 * Move the start of the Deque forward, without destroying any elements, blocks that become unused are moved after the used blocks
+		 * \param[in] count Number of elements to move the start by
+		 */
+		void AdvanceFront(usize count) noexcept;
 
 		/**
 		 * Prepare the Deque to insert a number of elements
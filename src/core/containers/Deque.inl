@@ -5,16 +5,30 @@
 
 namespace Onca
 {
+	namespace Detail
+	{
+		template <typename T>
+		constexpr auto DequeAutoBlockSize() noexcept -> usize
+		{
+			const usize count = DequeBlockByteSize / sizeof(T);
+			usize size = DequeMinBlockSize;
+			while (size * 2 <= count)
+				size *= 2;
+			return size;
+		}
+	}
+
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Iterator::Iterator()
-		: m_blockIdx(0)
+		: m_pBlocks(nullptr)
+		, m_blockIdx(0)
 		, m_idx(0)
 	{
 	}
 
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Iterator::Iterator(const Iterator& other) noexcept
-		: m_blocks(other.m_blocks)
+		: m_pBlocks(other.m_pBlocks)
 		, m_blockIdx(other.m_blockIdx)
 		, m_idx(other.m_idx)
 	{
@@ -22,7 +36,7 @@ namespace Onca
 
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Iterator::Iterator(Iterator&& other) noexcept
-		: m_blocks(Move(other.m_blocks))
+		: m_pBlocks(other.m_pBlocks)
 		, m_blockIdx(other.m_blockIdx)
 		, m_idx(other.m_idx)
 	{
@@ -31,7 +45,7 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator=(const Iterator& other) noexcept
 	{
-		m_blocks = other.m_blocks;
+		m_pBlocks = other.m_pBlocks;
 		m_blockIdx = other.m_blockIdx;
 		m_idx = other.m_idx;
 		return *this;
@@ -40,7 +54,7 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator=(Iterator&& other) noexcept -> Iterator&
 	{
-		m_blocks = Move(other.m_blocks);
+		m_pBlocks = other.m_pBlocks;
 		m_blockIdx = other.m_blockIdx;
 		m_idx = other.m_idx;
 		return *this;
@@ -49,20 +63,20 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator->() const noexcept -> T*
 	{
-		return (m_blocks.Ptr() + m_blockIdx)->Ptr() + m_idx;
+		return (m_pBlocks + m_blockIdx)->Ptr() + m_idx;
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator*() const noexcept -> T&
 	{
-		return *((m_blocks.Ptr() + m_blockIdx)->Ptr() + m_idx);
+		return *((m_pBlocks + m_blockIdx)->Ptr() + m_idx);
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator++() noexcept -> Iterator
 	{
 		++m_idx;
-		if (m_idx == BlockSize)
+		if (m_idx == ElemsPerBlock)
 		{
 			m_idx = 0;
 			++m_blockIdx;
@@ -83,7 +97,7 @@ namespace Onca
 	{
 		if (m_idx == 0)
 		{
-			m_idx = BlockSize - 1;
+			m_idx = ElemsPerBlock - 1;
 			--m_blockIdx;
 		}
 		else
@@ -105,28 +119,28 @@ namespace Onca
 	auto Deque<T, BlockSize>::Iterator::operator+(usize count) const noexcept -> Iterator
 	{
 		usize idx = m_idx + count;
-		usize offset = m_blockIdx + idx / BlockSize;
+		usize offset = m_blockIdx + idx / ElemsPerBlock;
 		idx &= Mask;
-		return Iterator{ m_blocks, offset, idx };
+		return Iterator{ m_pBlocks, offset, idx };
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator-(usize count) const noexcept -> Iterator
 	{
-		usize actIdx = m_blockIdx * BlockSize + m_idx;
+		usize actIdx = m_blockIdx * ElemsPerBlock + m_idx;
 		if (actIdx < count)
-			return Iterator{ m_blocks, 0, 0 };
+			return Iterator{ m_pBlocks, 0, 0 };
 		actIdx -= count;
 		usize idx = actIdx & Mask;
-		usize offset = actIdx / BlockSize;
-		return Iterator{ m_blocks, offset, idx };
+		usize offset = actIdx / ElemsPerBlock;
+		return Iterator{ m_pBlocks, offset, idx };
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator-(const Iterator& it) const noexcept -> isize
 	{
-		usize actIdx = m_blockIdx * BlockSize + m_idx;
-		usize otherIdx = it.m_blockIdx * BlockSize + it.m_idx;
+		usize actIdx = m_blockIdx * ElemsPerBlock + m_idx;
+		usize otherIdx = it.m_blockIdx * ElemsPerBlock + it.m_idx;
 		ASSERT(actIdx > otherIdx, "Iterator subtraction is in the wrong order");
 		return actIdx - otherIdx;
 	}
@@ -135,7 +149,7 @@ namespace Onca
 	auto Deque<T, BlockSize>::Iterator::operator+=(usize count) noexcept -> Iterator&
 	{
 		m_idx = m_idx + count;
-		m_blockIdx = m_blockIdx + m_idx / BlockSize;
+		m_blockIdx = m_blockIdx + m_idx / ElemsPerBlock;
 		m_idx &= Mask;
 		return *this;
 	}
@@ -143,21 +157,21 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator-=(usize count) noexcept -> Iterator&
 	{
-		usize actIdx = m_blockIdx * BlockSize + m_idx;
+		usize actIdx = m_blockIdx * ElemsPerBlock + m_idx;
 		if (actIdx < count)
 		{
 			m_blockIdx = m_idx = 0;
 		}
 		actIdx -= count;
 		m_idx = actIdx & Mask;
-		m_blockIdx = actIdx / BlockSize;
+		m_blockIdx = actIdx / ElemsPerBlock;
 		return *this;
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator==(const Iterator& other) const noexcept -> bool
 	{
-		return m_blockIdx == other.m_blockIdx && m_idx == other.m_idx && m_blocks == other.m_blocks;
+		return m_blockIdx == other.m_blockIdx && m_idx == other.m_idx && m_pBlocks == other.m_pBlocks;
 	}
 
 	template <typename T, usize BlockSize>
@@ -169,11 +183,11 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator<=>(const Iterator& other) const noexcept -> std::partial_ordering
 	{
-		if (m_blocks != other.m_blocks)
+		if (m_pBlocks != other.m_pBlocks)
 			return std::partial_ordering::unordered;
 
-		usize actIdx = m_blockIdx * BlockSize + m_idx;
-		usize otherIdx = other.m_blockIdx * BlockSize + other.m_idx;
+		usize actIdx = m_blockIdx * ElemsPerBlock + m_idx;
+		usize otherIdx = other.m_blockIdx * ElemsPerBlock + other.m_idx;
 
 		if (actIdx == otherIdx) return std::strong_ordering::equal;
 		if (actIdx < otherIdx) return std::strong_ordering::less;
@@ -183,24 +197,24 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator[](usize idx) noexcept -> T&
 	{
-		usize actIdx = m_blockIdx * BlockSize + m_idx + idx;
-		usize offset = actIdx / BlockSize;
+		usize actIdx = m_blockIdx * ElemsPerBlock + m_idx + idx;
+		usize offset = actIdx / ElemsPerBlock;
 		usize blockIdx = actIdx & Mask;
-		return (m_blocks.Ptr() + offset)->Ptr() + blockIdx;
+		return *((m_pBlocks + offset)->Ptr() + blockIdx);
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Iterator::operator[](usize idx) const noexcept -> const T&
 	{
-		usize actIdx = m_blockIdx * BlockSize + m_idx + idx;
-		usize offset = actIdx / BlockSize;
+		usize actIdx = m_blockIdx * ElemsPerBlock + m_idx + idx;
+		usize offset = actIdx / ElemsPerBlock;
 		usize blockIdx = actIdx & Mask;
-		return (m_blocks.Ptr() + offset)->Ptr() + blockIdx;
+		return *((m_pBlocks + offset)->Ptr() + blockIdx);
 	}
 
 	template <typename T, usize BlockSize>
-	Deque<T, BlockSize>::Iterator::Iterator(const MemRef<MemRef<T>>& blocks, usize blockOffset, usize idx) noexcept
-		: m_blocks(blocks)
+	Deque<T, BlockSize>::Iterator::Iterator(CompactMemRef<T>* pBlocks, usize blockOffset, usize idx) noexcept
+		: m_pBlocks(pBlocks)
 		, m_blockIdx(blockOffset)
 		, m_idx(idx)
 	{
@@ -208,7 +222,8 @@ namespace Onca
 
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Deque(Alloc::IAllocator& alloc) noexcept
-		: m_blocks(&alloc)
+		: m_blocks()
+		, m_alloc(alloc)
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -216,7 +231,8 @@ namespace Onca
 
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Deque(usize count, Alloc::IAllocator& alloc) noexcept requires DefaultConstructible<T>
-		: m_blocks(&alloc)
+		: m_blocks()
+		, m_alloc(alloc)
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -225,7 +241,8 @@ namespace Onca
 
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Deque(usize count, const T& val, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_blocks(&alloc)
+		: m_blocks()
+		, m_alloc(alloc)
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -234,7 +251,8 @@ namespace Onca
 
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Deque(const InitializerList<T>& il, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_blocks(&alloc)
+		: m_blocks()
+		, m_alloc(alloc)
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -244,7 +262,8 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	template <ForwardIterator It>
 	Deque<T, BlockSize>::Deque(const It& begin, const It& end, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_blocks(&alloc)
+		: m_blocks()
+		, m_alloc(alloc)
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -253,7 +272,8 @@ namespace Onca
 
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Deque(const Deque& other) noexcept requires CopyConstructible<T>
-		: m_blocks(other.GetAllocator())
+		: m_blocks()
+		, m_alloc(*other.GetAllocator())
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -263,7 +283,8 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	template <usize B>
 	Deque<T, BlockSize>::Deque(const Deque<T, B>& other) noexcept requires CopyConstructible<T>
-		: m_blocks(other.GetAllocator())
+		: m_blocks()
+		, m_alloc(*other.GetAllocator())
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -273,7 +294,8 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	template <usize B>
 	Deque<T, BlockSize>::Deque(const Deque<T, B>& other, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_blocks(&alloc)
+		: m_blocks()
+		, m_alloc(alloc)
 		, m_initialIdx(0)
 		, m_size(0)
 	{
@@ -283,6 +305,7 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	Deque<T, BlockSize>::Deque(Deque&& other) noexcept
 		: m_blocks(Move(other.m_blocks))
+		, m_alloc(other.m_alloc)
 		, m_initialIdx(other.m_initialIdx)
 		, m_size(other.m_size)
 	{
@@ -292,22 +315,12 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	template <usize B>
 	Deque<T, BlockSize>::Deque(Deque<T, B>&& other, Alloc::IAllocator& alloc) noexcept
-		: m_blocks(&alloc)
-		, m_initialIdx(other.m_initialIdx)
-		, m_size(other.m_size)
+		: m_blocks()
+		, m_alloc(alloc)
+		, m_initialIdx(0)
+		, m_size(0)
 	{
-		usize size = m_size + m_initialIdx;
-		usize blocksNeeded = (size + Mask) / BlockSize;
-		MemRef<T>* pBlocks = AddBackBlocks(blocksNeeded);
-		MemRef<T>* pOtherBlocks = other.m_blocks.Ptr();
-		for (usize i = 0; i < blocksNeeded; ++i)
-		{
-			MemRef<T>& otherBlock = *(pOtherBlocks + i);
-			MemRefCpy(*(pBlocks + i), otherBlock, BlockSize);
-			otherBlock.Dealloc();
-		}
-		other.m_blocks.Dealloc();
-		other.m_initialIdx = other.m_size = 0;
+		Push(Move(other));
 	}
 
 	template <typename T, usize BlockSize>
@@ -317,14 +330,14 @@ namespace Onca
 	}
 
 	template <typename T, usize BlockSize>
-	auto Deque<T, BlockSize>::operator=(const InitializerList<T>& il) noexcept -> Deque<T>& requires CopyConstructible<T>
+	auto Deque<T, BlockSize>::operator=(const InitializerList<T>& il) noexcept -> Deque& requires CopyConstructible<T>
 	{
 		Assign(il);
 		return *this;
 	}
 
 	template <typename T, usize BlockSize>
-	auto Deque<T, BlockSize>::operator=(const Deque& other) noexcept -> Deque<T>& requires CopyConstructible<T>
+	auto Deque<T, BlockSize>::operator=(const Deque& other) noexcept -> Deque& requires CopyConstructible<T>
 	{
 		Assign(other.Begin(), other.End());
 		return *this;
@@ -332,16 +345,18 @@ namespace Onca
 
 	template <typename T, usize BlockSize>
 	template <usize B>
-	auto Deque<T, BlockSize>::operator=(const Deque<T, B>& other) noexcept -> Deque<T>& requires CopyConstructible<T>
+	auto Deque<T, BlockSize>::operator=(const Deque<T, B>& other) noexcept -> Deque& requires CopyConstructible<T>
 	{
 		Assign(other.Begin(), other.End()); 
 		return *this;
 	}
 
 	template <typename T, usize BlockSize>
-	auto Deque<T, BlockSize>::operator=(Deque&& other) noexcept -> Deque<T>&
+	auto Deque<T, BlockSize>::operator=(Deque&& other) noexcept -> Deque&
 	{
+		Clear(true);
 		m_blocks = Move(other.m_blocks);
+		m_alloc = other.m_alloc;
 		m_initialIdx = other.m_initialIdx;
 		m_size = other.m_size;
 		other.m_initialIdx = other.m_size = 0;
@@ -353,18 +368,11 @@ namespace Onca
 	void Deque<T, BlockSize>::Assign(const It& begin, const It& end) noexcept requires CopyConstructible<T>
 	{
 		Clear(false);
-		if constexpr (ContiguousIterator<T> && MemCopyable<T>)
+		if constexpr (ContiguousIterator<It>)
 		{
-			ASSERT(begin < end, "'begin' iterator must be smaller than 'end' iterator");
-			usize size = end - begin;
-			usize blocksNeeded = (size + Mask) / Mask;
-			MemRef<T>* pBlocks = AddBackBlocks(blocksNeeded);
-			const T* pSrc = &*begin;
-			for (usize i = 0; i < blocksNeeded; ++i)
-			{
-				usize count = Min(size, blocksNeeded);
-				MemCpy(pBlocks + i, pSrc + i, count + 1);
-			}
+			ASSERT(begin <= end, "'begin' iterator must be smaller than 'end' iterator");
+			if (begin != end)
+				Push(&*begin, usize(end - begin));
 		}
 		else
 		{
@@ -377,23 +385,7 @@ namespace Onca
 	void Deque<T, BlockSize>::Assign(const InitializerList<T>& il) noexcept requires CopyConstructible<T>
 	{
 		Clear(false);
-		if constexpr (ContiguousIterator<T> && MemCopyable<T>)
-		{
-			usize size = end - begin;
-			usize blockNeeded = (size + Mask) / Mask;
-			MemRef<T>* pBlocks = AddBackBlocks((il.size() + Mask) / BlockSize);
-			const T* pSrc = &*begin;
-			for (usize i = 0; i < blockNeeded; ++i)
-			{
-				usize count = Min(size, blockNeeded);
-				MemCpy(pBlocks + i, pSrc + i, count + 1);
-			}
-		}
-		else
-		{
-			for (const T* it = il.begin(), *end = il.end(); it != end; ++it)
-				Push(T{ *it });
-		}
+		Push(il.begin(), il.size());
 	}
 
 	template <typename T, usize BlockSize>
@@ -417,9 +409,10 @@ namespace Onca
 	{
 		if (newSize < m_size)
 		{
-			MemRef<T>* pBlocks = m_blocks.Ptr();
+			CompactMemRef<T>* pBlocks = m_blocks.Ptr();
 			for (usize i = newSize; i < m_size; ++i)
 				GetElemAddr(pBlocks, i)->~T();
+			m_size = newSize;
 		}
 		else
 		{
@@ -433,7 +426,7 @@ namespace Onca
 	{
 		if (newSize < m_size)
 		{
-			MemRef<T>* pBlocks = m_blocks.Ptr();
+			CompactMemRef<T>* pBlocks = m_blocks.Ptr();
 			for (usize i = newSize; i < m_size; ++i)
 				GetElemAddr(pBlocks, i)->~T();
 		}
@@ -457,7 +450,7 @@ namespace Onca
 		if (m_initialIdx == 0)
 		{
 			AddFrontBlocks(1);
-			m_initialIdx = BlockSize;
+			m_initialIdx = ElemsPerBlock;
 		}
 
 		--m_initialIdx;
@@ -479,8 +472,7 @@ namespace Onca
 	{
 		for (usize i = 0; i < other.m_size; ++i)
 			PushFront(*other.GetElemAddr(other.m_size - i - 1));
-		other.m_blocks.Dealloc();
-		other.m_initialIdx = other.m_size = 0;
+		other.Clear(true);
 	}
 
 	template <typename T, usize BlockSize>
@@ -521,8 +513,42 @@ namespace Onca
 	{
 		for (usize i = 0; i < other.m_size; ++i)
 			Push(Move(*other.GetElemAddr(i)));
-		other.m_blocks.Dealloc();
-		other.m_initialIdx = other.m_size = 0;
+		other.Clear(true);
+	}
+
+	template <typename T, usize BlockSize>
+	void Deque<T, BlockSize>::Push(const T* pData, usize count) noexcept requires CopyConstructible<T>
+	{
+		if (!count)
+			return;
+
+		usize actIdx = m_initialIdx + m_size;
+		const usize usedBlocks = (actIdx + Mask) / ElemsPerBlock;
+		const usize neededBlocks = (actIdx + count + Mask) / ElemsPerBlock;
+		if (neededBlocks > usedBlocks)
+			AddBackBlocks(neededBlocks - usedBlocks);
+
+		CompactMemRef<T>* pBlocks = m_blocks.Ptr();
+		while (count)
+		{
+			const usize blockIdx = actIdx & Mask;
+			const usize numElems = Math::Min(count, ElemsPerBlock - blockIdx);
+			T* pDst = (pBlocks + actIdx / ElemsPerBlock)->Ptr() + blockIdx;
+			if constexpr (MemCopyable<T>)
+			{
+				MemCpy(pDst, pData, numElems * sizeof(T));
+			}
+			else
+			{
+				for (usize i = 0; i < numElems; ++i)
+					new (pDst + i) T{ pData[i] };
+			}
+
+			pData += numElems;
+			actIdx += numElems;
+			count -= numElems;
+			m_size += numElems;
+		}
 	}
 
 	template <typename T, usize BlockSize>
@@ -541,7 +567,7 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Insert(ConstIterator& it, T&& val) noexcept -> Iterator
 	{
-		usize itIdx = it.m_blockIdx * BlockSize + it.m_idx - m_initialIdx;
+		usize itIdx = it.m_blockIdx * ElemsPerBlock + it.m_idx - m_initialIdx;
 		PrepareInsert(itIdx, 1);
 		new (GetElemAddr(itIdx)) T{ Move(val) };
 		++m_size;
@@ -551,7 +577,7 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Insert(ConstIterator& it, usize count, const T& val) noexcept -> Iterator requires CopyConstructible<T>
 	{
-		usize itIdx = it.m_blockIdx * BlockSize + it.m_idx - m_initialIdx;
+		usize itIdx = it.m_blockIdx * ElemsPerBlock + it.m_idx - m_initialIdx;
 		PrepareInsert(itIdx, count);
 		for (usize i = 0; i < count; ++i)
 			new (GetElemAddr(itIdx + i)) T{ Move(val) };
@@ -584,19 +610,13 @@ namespace Onca
 	template <usize B>
 	auto Deque<T, BlockSize>::Insert(ConstIterator& it, Deque<T, B>&& other) noexcept -> Iterator
 	{
-		usize itIdx = it.m_blockIdx * BlockSize + it.m_idx - m_initialIdx;
+		usize itIdx = it.m_blockIdx * ElemsPerBlock + it.m_idx - m_initialIdx;
 		PrepareInsert(itIdx, other.m_size);
 		usize i = itIdx;
 		for (Iterator valIt = other.Begin(), end = other.End(); valIt != end; ++valIt, ++i)
 			new (GetElemAddr(i)) T{ Move(*valIt) };
 		m_size += other.m_size;
-
-		usize otherBlocks = (other.m_initialIdx + other.m_size + B - 1) / B;
-		MemRef<T>* pOtherBegin = other.m_blocks.Ptr();
-		for (i = 0; i < otherBlocks; ++i)
-			(pOtherBegin + i)->Dealloc();
-		other.m_blocks.Dealloc();
-		other.m_initialIdx = other.m_size = 0;
+		other.Clear(true);
 
 		return IteratorAt(itIdx);
 	}
@@ -611,54 +631,65 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	void Deque<T, BlockSize>::Clear(bool clearMemory) noexcept
 	{
-		for (usize i = 0; i < m_size; ++i)
-			GetElemAddr(i)->~T();
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			for (usize i = 0; i < m_size; ++i)
+				GetElemAddr(i)->~T();
+		}
+		m_initialIdx = 0;
+		m_size = 0;
 
 		if (!clearMemory)
-		{
-			m_size = 0;
 			return;
-		}
 
-		usize usedBlocks = (m_initialIdx + m_size + Mask) / BlockSize;
-		MemRef<T>* pBegin = m_blocks.Ptr();
-		for (usize i = 0; i < usedBlocks; ++i)
-			(pBegin + i)->Dealloc();
-		Alloc::IAllocator* pAlloc = m_blocks.GetAlloc();
-		m_blocks.Dealloc();
-		m_blocks = MemRef<MemRef<T>>{ pAlloc };
-		m_size = 0;
+		const usize numBlocks = Alloc::ContainerAlloc::GetCount(m_blocks);
+		CompactMemRef<T>* pBegin = m_blocks.Ptr();
+		for (usize i = 0; i < numBlocks; ++i)
+		{
+			if (*(pBegin + i))
+				m_alloc.Deallocate(Move(*(pBegin + i)), ElemsPerBlock);
+		}
+		m_alloc.DeallocateCounted(Move(m_blocks));
 	}
 
 	template <typename T, usize BlockSize>
 	void Deque<T, BlockSize>::PopFront() noexcept
 	{
+		ASSERT(m_size, "Invalid when Deque is empty");
 		GetElemAddr(0)->~T();
-		if (m_initialIdx == BlockSize - 1)
-		{
-			m_blocks->Dealloc();
-			const usize numBlocks = (m_initialIdx + m_size + Mask) / BlockSize - 1;
-			MemMove(m_blocks, 0, 1, numBlocks * sizeof(MemRef<T>));
-			m_initialIdx = 0;
-		}
-		else
+		AdvanceFront(1);
+	}
+
+	template <typename T, usize BlockSize>
+	void Deque<T, BlockSize>::PopFront(usize count) noexcept
+	{
+		ASSERT(count <= m_size, "Cannot pop more elements than are in the Deque");
+		if constexpr (!std::is_trivially_destructible_v<T>)
 		{
-			++m_initialIdx;
+			for (usize i = 0; i < count; ++i)
+				GetElemAddr(i)->~T();
 		}
-		--m_size;
+		AdvanceFront(count);
 	}
 
 	template <typename T, usize BlockSize>
 	void Deque<T, BlockSize>::Pop() noexcept
 	{
+		ASSERT(m_size, "Invalid when Deque is empty");
 		GetElemAddr(m_size - 1)->~T();
-		usize endIdx = (m_initialIdx + m_size) & Mask;
-		if (endIdx == 0)
+		--m_size;
+	}
+
+	template <typename T, usize BlockSize>
+	void Deque<T, BlockSize>::Pop(usize count) noexcept
+	{
+		ASSERT(count <= m_size, "Cannot pop more elements than are in the Deque");
+		if constexpr (!std::is_trivially_destructible_v<T>)
 		{
-			usize endBlock = (m_initialIdx + m_size) / BlockSize;
-			(m_blocks.Ptr() + endBlock)->Dealloc();
+			for (usize i = m_size - count; i < m_size; ++i)
+				GetElemAddr(i)->~T();
 		}
-		--m_size;
+		m_size -= count;
 	}
 
 	template <typename T, usize BlockSize>
@@ -670,46 +701,19 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	void Deque<T, BlockSize>::Erase(const Iterator& it, usize count) noexcept
 	{
-		usize itIdx = it.m_blockIdx * BlockSize + it.m_idx - m_initialIdx;
-		usize center = itIdx + count / 2;
-		usize halfSize = m_size / 2;
-
-		for (usize i = itIdx, end = itIdx + count; i < end; ++i)
-			GetElemAddr(i)->~T();
-
-		if (center >= halfSize)
+		usize itIdx = it.m_blockIdx * ElemsPerBlock + it.m_idx - m_initialIdx;
+		if (itIdx + count / 2 >= m_size / 2)
 		{
-			usize numElems = m_size - itIdx - count + 1;
-			Algo::Move(it + count, it, numElems);
-
-			auto [offset, index] = GetElemOffsetIdx(m_size - count);
-			if (offset)
-			{
-				usize usedBlocks = (m_initialIdx + m_size + Mask) / BlockSize;
-				MemRef<T>* pEnd = m_blocks.Ptr() - usedBlocks;
-				for (usize i = 0; i < offset; ++i)
-					(pEnd - i - 1)->Dealloc();
-				MemMove(pEnd, pEnd - offset, usedBlocks - offset);
-			}
+			for (usize i = itIdx; i + count < m_size; ++i)
+				*GetElemAddr(i) = Move(*GetElemAddr(i + count));
+			Pop(count);
 		}
 		else
 		{
-			Iterator begin = Begin();
-			Algo::Move(begin, begin + count, itIdx);
-			auto [offset, index] = GetElemOffsetIdx(count);
-
-			if (offset)
-			{
-				MemRef<T>* pBegin = m_blocks.Ptr();
-				for (usize i = 0; i < offset; ++i)
-					(pBegin + i)->Dealloc();
-				usize usedBlocks = (m_initialIdx + m_size + Mask) / BlockSize;
-				MemMove(pBegin, pBegin + offset, usedBlocks - offset);
-			}
-
-			m_initialIdx = index;
+			for (usize i = itIdx + count; i-- > count;)
+				*GetElemAddr(i) = Move(*GetElemAddr(i - count));
+			PopFront(count);
 		}
-		m_size -= count;
 	}
 
 	template <typename T, usize BlockSize>
@@ -795,61 +799,61 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::GetAllocator() const noexcept -> Alloc::IAllocator*
 	{
-		return m_blocks.GetAlloc();
+		return m_alloc.Get();
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Front() noexcept -> T&
 	{
 		ASSERT(m_size, "Invalid when Deque is empty");
-		return *(*m_blocks.Ptr() + m_initialIdx);
+		return *GetElemAddr(0);
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Front() const noexcept -> const T&
 	{
 		ASSERT(m_size, "Invalid when Deque is empty");
-		return *(*m_blocks.Ptr() + m_initialIdx);
+		return *GetElemAddr(0);
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Back() noexcept -> T&
 	{
 		ASSERT(m_size, "Invalid when Deque is empty");
-		return GetElemAddr(m_size - 1);
+		return *GetElemAddr(m_size - 1);
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Back() const noexcept -> const T&
 	{
 		ASSERT(m_size, "Invalid when Deque is empty");
-		return GetElemAddr(m_size - 1);
+		return *GetElemAddr(m_size - 1);
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Begin() noexcept -> Iterator
 	{
-		return Iterator{ m_blocks, 0, m_initialIdx };
+		return Iterator{ m_blocks.Ptr(), 0, m_initialIdx };
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::Begin() const noexcept -> ConstIterator
 	{
-		return Iterator{ m_blocks, 0, m_initialIdx };
+		return Iterator{ m_blocks.Ptr(), 0, m_initialIdx };
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::End() noexcept -> Iterator
 	{
 		auto [offset, idx] = GetElemOffsetIdx(m_size);
-		return Iterator{ m_blocks, offset, idx };
+		return Iterator{ m_blocks.Ptr(), offset, idx };
 	}
 
 	template <typename T, usize BlockSize>
 	auto Deque<T, BlockSize>::End() const noexcept -> ConstIterator
 	{
 		auto [offset, idx] = GetElemOffsetIdx(m_size);
-		return Iterator{ m_blocks, offset, idx };
+		return Iterator{ m_blocks.Ptr(), offset, idx };
 	}
 
 	template <typename T, usize BlockSize>
@@ -916,7 +920,7 @@ namespace Onca
 	auto Deque<T, BlockSize>::GetElemOffsetIdx(usize idx) const noexcept -> Pair<usize, usize>
 	{
 		usize actIdx = m_initialIdx + idx;
-		return Pair{ actIdx / BlockSize, actIdx & Mask };
+		return Pair{ actIdx / ElemsPerBlock, actIdx & Mask };
 	}
 
 	template <typename T, usize BlockSize>
@@ -926,7 +930,7 @@ namespace Onca
 	}
 
 	template <typename T, usize BlockSize>
-	auto Deque<T, BlockSize>::GetElemAddr(MemRef<T>* pBegin, usize idx) const noexcept -> T*
+	auto Deque<T, BlockSize>::GetElemAddr(CompactMemRef<T>* pBegin, usize idx) const noexcept -> T*
 	{
 		auto [offset, blockIdx] = GetElemOffsetIdx(idx);
 		return (pBegin + offset)->Ptr() + blockIdx;
@@ -935,30 +939,31 @@ namespace Onca
 	template <typename T, usize BlockSize>
 	void Deque<T, BlockSize>::AddBackBlocks(usize numBlocks) noexcept
 	{
-		ReserveBase<true>(numBlocks);
-		Alloc::IAllocator* pAlloc = m_blocks.GetAlloc();
-		usize usedBlocks = (m_initialIdx + m_size + Mask) / BlockSize;
-		MemRef<T>* pEnd = m_blocks.Ptr() + usedBlocks;
+		CompactMemRef<T>* pEnd = ReserveBase<true>(numBlocks);
 		for (usize i = 0; i < numBlocks; ++i)
-			*(pEnd + i) = pAlloc->Allocate<T>(BlockByteSize);
+		{
+			if (!*(pEnd + i))
+				*(pEnd + i) = m_alloc.template Allocate<T>(ElemsPerBlock);
+		}
 	}
 
 	template <typename T, usize BlockSize>
 	void Deque<T, BlockSize>::AddFrontBlocks(usize numBlocks) noexcept
 	{
-		ReserveBase<false>(numBlocks);
-		Alloc::IAllocator* pAlloc = m_blocks.GetAlloc();
-		MemRef<T>* pBegin = m_blocks.Ptr();
+		CompactMemRef<T>* pBegin = ReserveBase<false>(numBlocks);
 		for (usize i = 0; i < numBlocks; ++i)
-			*(pBegin + i) = pAlloc->Allocate<T>(BlockByteSize);
+		{
+			if (!*(pBegin + i))
+				*(pBegin + i) = m_alloc.template Allocate<T>(ElemsPerBlock);
+		}
 	}
 	
 	template <typename T, usize BlockSize>
 	template <bool AtBack>
-	auto Deque<T, BlockSize>::ReserveBase(usize numAdditionalBlocks) noexcept -> MemRef<T>*
+	auto Deque<T, BlockSize>::ReserveBase(usize numAdditionalBlocks) noexcept -> CompactMemRef<T>*
 	{
-		usize curBlocks = m_blocks.Size() / sizeof(MemRef<T>);
- 		usize usedBlocks = (m_initialIdx + m_size + Mask) / BlockSize;
+		usize curBlocks = Alloc::ContainerAlloc::GetCount(m_blocks);
+ 		usize usedBlocks = (m_initialIdx + m_size + Mask) / ElemsPerBlock;
 		usize neededBlocks = usedBlocks + numAdditionalBlocks;
 
 		if (neededBlocks <= curBlocks)
@@ -969,30 +974,75 @@ namespace Onca
 			}
 			else
 			{
-				MemMove(m_blocks, numAdditionalBlocks, 0, usedBlocks * sizeof(MemRef<T>));
-				return m_blocks.Ptr();
+				// Rotate the spare blocks after the used blocks to the front, so they can be reused
+				CompactMemRef<T>* pBegin = m_blocks.Ptr();
+				RotateBlocks(pBegin, neededBlocks, usedBlocks);
+				return pBegin;
 			}
 		}
 
+		// All current entries are kept, including spare blocks, so make sure they fit next to the new blocks
+		const usize minCap = curBlocks + numAdditionalBlocks;
 		usize cap = Math::Max(curBlocks, usize(1));
-		while (cap < neededBlocks)
+		while (cap < minCap)
 			cap = (cap << 1) - (cap >> 1);
 
-		Alloc::IAllocator* pAlloc = m_blocks.GetAlloc();
-		MemRef<MemRef<T>> oldBlock = Move(m_blocks);
+		// Blocks are only referenced by their address, so the block table stays a third of the size compared to storing full MemRefs
+		CompactMemRef<CompactMemRef<T>> oldBlocks = Move(m_blocks);
+		m_blocks = m_alloc.template AllocateCounted<CompactMemRef<T>>(cap);
+		ASSERT(m_blocks, "Failed to allocate memory");
 
-		m_blocks = pAlloc->Allocate<MemRef<T>>(cap * sizeof(MemRef<T>));
+		CompactMemRef<T>* pBegin = m_blocks.Ptr();
+		MemClear(pBegin, cap * sizeof(CompactMemRef<T>));
 		if (curBlocks)
 		{
 			if constexpr (AtBack)
-				MemRefCpy(m_blocks, oldBlock, curBlocks);
+				MemCpy(pBegin, oldBlocks.Ptr(), curBlocks * sizeof(CompactMemRef<T>));
 			else
-				MemRefCpy(m_blocks, numAdditionalBlocks, oldBlock, 0, curBlocks);
+				MemCpy(pBegin + numAdditionalBlocks, oldBlocks.Ptr(), curBlocks * sizeof(CompactMemRef<T>));
 		}
+		m_alloc.DeallocateCounted(Move(oldBlocks));
+
+		if constexpr (AtBack)
+			return pBegin + usedBlocks;
+		else
+			return pBegin;
+	}
 
-		oldBlock.Dealloc();
+	template <typename T, usize BlockSize>
+	void Deque<T, BlockSize>::RotateBlocks(CompactMemRef<T>* pBlocks, usize count, usize shift) noexcept
+	{
+		if (shift == 0 || shift == count)
+			return;
+
+		// Blocks are plain addresses, so reverse them in place: reverse both parts, then the whole range
+		T** pAddrs = reinterpret_cast<T**>(pBlocks);
+		auto reverse = [](T** pBegin, T** pEnd)
+		{
+			for (; pBegin < --pEnd; ++pBegin)
+				Algo::Swap(*pBegin, *pEnd);
+		};
+		reverse(pAddrs, pAddrs + shift);
+		reverse(pAddrs + shift, pAddrs + count);
+		reverse(pAddrs, pAddrs + count);
+	}
+
+	template <typename T, usize BlockSize>
+	void Deque<T, BlockSize>::AdvanceFront(usize count) noexcept
+	{
+		const usize usedBlocks = (m_initialIdx + m_size + Mask) / ElemsPerBlock;
+		m_size -= count;
+		if (m_size == 0)
+		{
+			m_initialIdx = 0;
+			return;
+		}
 
-		return m_blocks.Ptr();
+		const usize actIdx = m_initialIdx + count;
+		const usize freedBlocks = actIdx / ElemsPerBlock;
+		if (freedBlocks)
+			RotateBlocks(m_blocks.Ptr(), usedBlocks, freedBlocks);
+		m_initialIdx = actIdx & Mask;
 	}
 
 	// TODO: optimizations for types that allow memcpy/memmove in containers
@@ -1003,8 +1053,8 @@ namespace Onca
 		if (idx > halfSize)
 		{
 			const usize actEndIdx = m_initialIdx + m_size;
-			const usize lastBlock = (actEndIdx + Mask) / BlockSize;
-			const usize usedBlocks = (actEndIdx + moveOffset + Mask) / BlockSize;
+			const usize lastBlock = (actEndIdx + Mask) / ElemsPerBlock;
+			const usize usedBlocks = (actEndIdx + moveOffset + Mask) / ElemsPerBlock;
 			const usize neededBlocks = usedBlocks - lastBlock;
 			AddBackBlocks(neededBlocks);
 
@@ -1014,15 +1064,15 @@ namespace Onca
 		else
 		{
 			const usize actEndIdx = m_initialIdx + m_size;
-			const usize lastBlock = (actEndIdx + Mask) / BlockSize;
-			const usize usedBlocks = (actEndIdx + moveOffset + Mask) / BlockSize;
+			const usize lastBlock = (actEndIdx + Mask) / ElemsPerBlock;
+			const usize usedBlocks = (actEndIdx + moveOffset + Mask) / ElemsPerBlock;
 			const usize neededBlocks = usedBlocks - lastBlock;
 			AddFrontBlocks(neededBlocks);
 
-			const usize oldOffset = neededBlocks * BlockSize + m_initialIdx;
+			const usize oldOffset = neededBlocks * ElemsPerBlock + m_initialIdx;
 			const usize offset = moveOffset & Mask;
 			if (offset > m_initialIdx)
-				m_initialIdx = (BlockSize + m_initialIdx - offset);
+				m_initialIdx = (ElemsPerBlock + m_initialIdx - offset);
 			else
 				m_initialIdx -= offset;
 			
@@ -1035,7 +1085,7 @@ namespace Onca
 	template <ForwardIterator It>
 	auto Deque<T, BlockSize>::InsertIts(ConstIterator& it, usize count, const It& begin, const It& end) noexcept -> Iterator
 	{
-		usize idx = it.m_blockIdx * BlockSize + it.m_idx - m_initialIdx;
+		usize idx = it.m_blockIdx * ElemsPerBlock + it.m_idx - m_initialIdx;
 		PrepareInsert(idx, count);
 		usize tmp = idx;
 		for (It valIt = begin; valIt != end; ++valIt, ++tmp)
@@ -1048,6 +1098,6 @@ namespace Onca
 	auto Deque<T, BlockSize>::IteratorAtInternal(usize idx) const noexcept -> Iterator
 	{
 		auto [offset, blockIdx] = GetElemOffsetIdx(idx);
-		return Iterator{ m_blocks, offset, blockIdx };
+		return Iterator{ m_blocks.Ptr(), offset, blockIdx };
 	}
 }
@@ -2,6 +2,7 @@
 #include "core/MinInclude.h"
 #include "core/allocator/GlobalAlloc.h"
 #include "core/allocator/IAllocator.h"
+#include "core/allocator/ContainerAlloc.h"
 
 namespace Onca
 {
@@ -553,11 +554,20 @@ namespace Onca
 
 		auto InsertEnd(T&& val) noexcept -> Iterator;
 		auto PrepareInsert(usize offset, usize count) noexcept -> Iterator;
+		/**
+		 * Get the alignment of the allocated memory
+		 * \return Alignment of the allocated memory
+		 */
+		static constexpr auto GetAlign() noexcept -> u16;
 		
-		MemRef<T> m_mem;  ///< Managed memory
-		usize     m_size; ///< Size of the DynArray
+		CompactMemRef<T>      m_mem;   ///< Managed memory, with the capacity stored in front of the elements
+		Alloc::ContainerAlloc m_alloc; ///< Allocator
+		usize                 m_size;  ///< Size of the DynArray
 	};
 
+	template<typename T>
+	constexpr bool IsTriviallyRelocatable<DynArray<T>> = true;
+
 }
 
 #include "DynArray.inl"
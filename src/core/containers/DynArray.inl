@@ -9,14 +9,16 @@ namespace Onca
 {
 	template <typename T>
 	DynArray<T>::DynArray(Alloc::IAllocator& alloc) noexcept
-		: m_mem(&alloc)
+		: m_mem()
+		, m_alloc(alloc)
 		, m_size(0)
 	{
 	}
 
 	template <typename T>
 	DynArray<T>::DynArray(usize capacity, Alloc::IAllocator& alloc) noexcept
-		: m_mem(&alloc)
+		: m_mem()
+		, m_alloc(alloc)
 		, m_size(0)
 	{
 		Reserve(capacity);
@@ -24,7 +26,8 @@ namespace Onca
 
 	template <typename T>
 	DynArray<T>::DynArray(usize count, const T& val, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_mem(&alloc)
+		: m_mem()
+		, m_alloc(alloc)
 		, m_size(0)
 	{
 		Resize(count, val);
@@ -32,7 +35,8 @@ namespace Onca
 
 	template <typename T>
 	DynArray<T>::DynArray(const InitializerList<T>& il, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_mem(&alloc)
+		: m_mem()
+		, m_alloc(alloc)
 		, m_size(0)
 	{
 		Assign(il);
@@ -41,7 +45,8 @@ namespace Onca
 	template <typename T>
 	template <ForwardIterator It>
 	DynArray<T>::DynArray(const It& begin, const It& end, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_mem(&alloc)
+		: m_mem()
+		, m_alloc(alloc)
 		, m_size(0)
 	{
 		Assign(begin, end);
@@ -49,7 +54,8 @@ namespace Onca
 
 	template <typename T>
 	DynArray<T>::DynArray(const DynArray& other) noexcept requires CopyConstructible<T>
-		: m_mem(other.GetAllocator())
+		: m_mem()
+		, m_alloc(*other.GetAllocator())
 		, m_size(0)
 	{
 		Reserve(other.m_size);
@@ -58,7 +64,8 @@ namespace Onca
 
 	template <typename T>
 	DynArray<T>::DynArray(const DynArray& other, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
-		: m_mem(&alloc)
+		: m_mem()
+		, m_alloc(alloc)
 		, m_size(0)
 	{
 		Reserve(other.m_size);
@@ -68,23 +75,27 @@ namespace Onca
 	template <typename T>
 	DynArray<T>::DynArray(DynArray&& other) noexcept
 		: m_mem(Move(other.m_mem))
-		, m_size(Move(other.m_size))
+		, m_alloc(other.m_alloc)
+		, m_size(other.m_size)
 	{
 		other.m_size = 0;
 	}
 
 	template <typename T>
 	DynArray<T>::DynArray(DynArray&& other, Alloc::IAllocator& alloc) noexcept
-		: m_mem(&alloc)
-		, m_size(other.m_size)
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
 	{
-		Reserve(m_size);
+		Reserve(other.m_size);
 		if constexpr (MemCopyable<T>)
-			MemCpy(m_mem.Ptr(), other.m_mem.Ptr(), m_size);
+			MemCpy(m_mem.Ptr(), other.m_mem.Ptr(), other.m_size * sizeof(T));
 		else
-			Algo::Move(other.m_mem.Ptr(), m_mem.Ptr(), m_size);
-		other.m_mem.Dealloc();
-		other.m_mem = nullptr;
+			Algo::Move(other.m_mem.Ptr(), m_mem.Ptr(), other.m_size);
+		m_size = other.m_size;
+
+		other.m_alloc.DeallocateCounted(Move(other.m_mem), GetAlign());
+		other.m_size = 0;
 	}
 
 	template <typename T>
@@ -112,6 +123,7 @@ namespace Onca
 	{
 		Clear(true);
 		m_mem = Move(other.m_mem);
+		m_alloc = other.m_alloc;
 		m_size = other.m_size;
 		other.m_size = 0;
 		return *this;
@@ -135,8 +147,8 @@ namespace Onca
 		{
 			const usize size = usize(end - begin);
 			T* pBegin = m_mem.Ptr();
-			MemCpy(pBegin, &*begin, size);
-			m_size = size; 
+			MemCpy(pBegin, &*begin, size * sizeof(T));
+			m_size = size;
 		}
 		else
 		{
@@ -192,15 +204,26 @@ namespace Onca
 		usize cap = curCap == 0 ? 2 : curCap;
 		while (cap < newCap)
 			cap = (cap << 1) - (cap >> 1);
+
+		// Allocators like the VirtualArena can grow the memory without needing to move the elements
+		if (m_alloc.TryExpandCountedInPlace(m_mem, cap, GetAlign()))
+			return;
+
+		// Trivially relocatable elements can be moved by the allocator, which can use realloc or grow the memory in place
+		if constexpr (TriviallyRelocatable<T>)
+		{
+			if (m_alloc.ReallocateCounted(m_mem, cap, GetAlign()))
+				return;
+		}
 		
-		MemRef<T> mem = m_mem.GetAlloc()->template Allocate<T>(cap * sizeof(T), Math::Max(8, alignof(T)));
-		if (m_mem.IsValid())
+		CompactMemRef<T> mem = m_alloc.template AllocateCounted<T>(cap, GetAlign());
+		ASSERT(mem, "Failed to allocate memory");
+		if (m_mem)
 		{
 			Algo::Move(m_mem.Ptr(), mem.Ptr(), m_size);
-			m_mem.Dealloc();
+			m_alloc.DeallocateCounted(Move(m_mem), GetAlign());
 		}
 		m_mem = Move(mem);
-		ASSERT(m_mem, "Failed to allocate memory");
 	}
 
 	template <typename T>
@@ -254,15 +277,23 @@ namespace Onca
 		usize cap = Capacity();
 		if (cap > m_size)
 		{
-			MemRef<T> mem = m_mem.GetAlloc()->template Allocate<T>(m_size * sizeof(T));
-			if (m_mem.IsValid())
+			if constexpr (TriviallyRelocatable<T>)
+			{
+				if (m_size > 0 && m_alloc.ReallocateCounted(m_mem, m_size, GetAlign()))
+					return;
+			}
+
+			CompactMemRef<T> mem;
+			if (m_size > 0)
 			{
-				if (MemCopyable<T>)
-					MemCpy(mem.Ptr(), m_mem.Ptr(), m_size);
+				mem = m_alloc.template AllocateCounted<T>(m_size, GetAlign());
+				ASSERT(mem, "Failed to allocate memory");
+				if constexpr (MemCopyable<T>)
+					MemCpy(mem.Ptr(), m_mem.Ptr(), m_size * sizeof(T));
 				else
-					Algo::Copy(m_mem.Ptr(), mem.Ptr(), m_size);
-				m_mem.Dealloc();
+					Algo::Move(m_mem.Ptr(), mem.Ptr(), m_size);
 			}
+			m_alloc.DeallocateCounted(Move(m_mem), GetAlign());
 			m_mem = Move(mem);
 		}
 	}
@@ -298,12 +329,11 @@ namespace Onca
 	template <typename T>
 	void DynArray<T>::Add(DynArray&& other)
 	{
-		const usize idx = m_size;
-		m_size += other.m_size;
-		Reserve(m_size);
+		Reserve(m_size + other.m_size);
 
-		Algo::Move(other.m_mem.Ptr(), m_mem.Ptr() + idx, other.Size());
-		other.m_mem.Dealloc();
+		Algo::Move(other.m_mem.Ptr(), m_mem.Ptr() + m_size, other.m_size);
+		m_size += other.m_size;
+		other.m_alloc.DeallocateCounted(Move(other.m_mem), GetAlign());
 		other.m_size = 0;
 	}
 
@@ -414,7 +444,7 @@ namespace Onca
 		for (T* curIt = other.Begin(); curIt != other.End(); ++curIt, ++loc)
 			new (loc) T{ Move(*curIt) };
 
-		other.m_mem.Dealloc();
+		other.m_alloc.DeallocateCounted(Move(other.m_mem), GetAlign());
 		other.m_size = 0;
 		return loc;
 	}
@@ -479,13 +509,15 @@ namespace Onca
 	template <typename T>
 	void DynArray<T>::Clear(bool clearMemory) noexcept
 	{
-		m_size = 0;
-		if (clearMemory && m_mem)
+		if constexpr (!TriviallyCopyable<T>)
 		{
-			Alloc::IAllocator* pAlloc = m_mem.GetAlloc();
-			m_mem.Dealloc();
-			m_mem = MemRef<T>(pAlloc);
+			T* pBegin = m_mem.Ptr();
+			for (T* it = pBegin, *end = pBegin + m_size; it != end; ++it)
+				it->~T();
 		}
+		m_size = 0;
+		if (clearMemory)
+			m_alloc.DeallocateCounted(Move(m_mem), GetAlign());
 	}
 
 	template <typename T>
@@ -726,7 +758,7 @@ namespace Onca
 	template <typename T>
 	auto DynArray<T>::Capacity() const noexcept -> usize
 	{
-		return m_mem.Size() / sizeof(T);
+		return Alloc::ContainerAlloc::GetCount(m_mem);
 	}
 
 	template <typename T>
@@ -750,7 +782,7 @@ namespace Onca
 	template <typename T>
 	auto DynArray<T>::GetAllocator() const noexcept -> Alloc::IAllocator*
 	{
-		return m_mem.GetAlloc();
+		return m_alloc.Get();
 	}
 
 	template <typename T>
@@ -879,16 +911,25 @@ namespace Onca
 	auto DynArray<T>::PrepareInsert(usize offset, usize count) noexcept -> Iterator
 	{
 		const usize endIdx = m_size;
+		Reserve(m_size + count);
 		m_size += count;
 
-		Reserve(m_size);
 		Iterator from = m_mem.Ptr() + offset;
 
 		if (offset == endIdx)
 			return from;
 
 		Iterator to = from + count;
-		Algo::Move(from, to, endIdx - offset);
+		if constexpr (TriviallyRelocatable<T>)
+			MemMove(to, from, (endIdx - offset) * sizeof(T));
+		else
+			Algo::Move(from, to, endIdx - offset);
 		return from;
 	}
+
+	template <typename T>
+	constexpr auto DynArray<T>::GetAlign() noexcept -> u16
+	{
+		return u16(Math::Max<usize>(8, alignof(T)));
+	}
 }
@@ -0,0 +1,91 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "allocator/GlobalAlloc.h"
+#include "DynArray.h"
+#include "core/intrin/BitIntrin.h"
+#include "core/utils/Utils.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Search index over a sorted array of keys, storing a copy of the keys in Eytzinger (breadth-first) order
+	 *
+	 * A binary search over a large sorted array touches a new cache line at almost every step, and the lines it touches are far apart.
+	 * In the Eytzinger layout, the children of the key at index i are at 2i and 2i + 1, so the first steps of every search hit the same few cache lines,
+	 * and the keys of the next steps are adjacent in memory. This makes lookups in large, read-only key sets (e.g. a FlatMap or FlatSet) considerably faster.
+	 * Lookups return the index into the sorted array, so the index can be used alongside the container it was built from.
+	 *
+	 * \tparam K Key type
+	 * \tparam C Comparator type
+	 * \note The index stores a copy of the keys and needs to be rebuilt after the sorted keys are modified
+	 */
+	template<typename K, Comparator<K, K> C = DefaultComparator<K>>
+	class EytzingerIndex
+	{
+	public:
+		static constexpr usize NPos = usize(-1); ///< Index returned when a key could not be found
+
+		/**
+		 * Create an empty index
+		 * \param[in] alloc Allocator
+		 */
+		explicit EytzingerIndex(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create an index over sorted keys
+		 * \param[in] pSorted Pointer to the sorted keys
+		 * \param[in] count Number of keys
+		 * \param[in] alloc Allocator
+		 */
+		explicit EytzingerIndex(const K* pSorted, usize count, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept requires CopyConstructible<K>;
+
+		/**
+		 * Build the index over sorted keys
+		 * \param[in] pSorted Pointer to the sorted keys
+		 * \param[in] count Number of keys
+		 */
+		void Build(const K* pSorted, usize count) noexcept requires CopyConstructible<K>;
+
+		/**
+		 * Get the index of the first key that is not ordered before a key
+		 * \param[in] key Key to look for
+		 * \return Index into the sorted keys, or the number of keys when all keys are ordered before the key
+		 */
+		auto LowerBound(const K& key) const noexcept -> usize;
+		/**
+		 * Get the index of a key
+		 * \param[in] key Key to find
+		 * \return Index into the sorted keys, or NPos when the key wasn't found
+		 */
+		auto Find(const K& key) const noexcept -> usize;
+
+		/**
+		 * Get the number of indexed keys
+		 * \return Number of indexed keys
+		 */
+		auto Size() const noexcept -> usize;
+
+	private:
+		// Number of levels below a node that are prefetched, i.e. the largest level whose descendants all fit in a single cache line
+		static constexpr usize PrefetchLevels = sizeof(K) <= 4 ? 4 : sizeof(K) <= 8 ? 3 : sizeof(K) <= 16 ? 2 : 0;
+
+		/**
+		 * Prefetch the descendants of a node
+		 * \param[in] pKeys Keys in Eytzinger order
+		 * \param[in] node 1-based index of the node in Eytzinger order
+		 */
+		static void Prefetch(const K* pKeys, usize node) noexcept;
+
+		/**
+		 * Assign sorted indices to the subtree at a node, in order
+		 * \param[in] node 1-based index of the node in Eytzinger order
+		 * \param[in,out] sortedIdx Next index into the sorted keys
+		 */
+		void AssignRanks(usize node, u32& sortedIdx) noexcept;
+
+		DynArray<K>         m_keys;  ///< Keys in Eytzinger order
+		DynArray<u32>       m_ranks; ///< Index into the sorted keys for each key in m_keys
+		NO_UNIQUE_ADDRESS C m_comp;  ///< Comparator
+	};
+}
+
+#include "EytzingerIndex.inl"
@@ -0,0 +1,111 @@
+#pragma once
+#if __RESHARPER__
+#include "EytzingerIndex.h"
+#endif
+
+namespace Onca
+{
+	template <typename K, Comparator<K, K> C>
+	EytzingerIndex<K, C>::EytzingerIndex(Alloc::IAllocator& alloc) noexcept
+		: m_keys(alloc)
+		, m_ranks(alloc)
+		, m_comp()
+	{
+	}
+
+	template <typename K, Comparator<K, K> C>
+	EytzingerIndex<K, C>::EytzingerIndex(const K* pSorted, usize count, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<K>
+		: m_keys(alloc)
+		, m_ranks(alloc)
+		, m_comp()
+	{
+		Build(pSorted, count);
+	}
+
+	template <typename K, Comparator<K, K> C>
+	void EytzingerIndex<K, C>::Build(const K* pSorted, usize count) noexcept requires CopyConstructible<K>
+	{
+		ASSERT(count < usize(u32(-1)), "Too many keys for an EytzingerIndex");
+
+		m_ranks.Clear();
+		m_ranks.Resize(count);
+		u32 sortedIdx = 0;
+		AssignRanks(1, sortedIdx);
+
+		m_keys.Clear();
+		m_keys.Reserve(count);
+		for (u32 rank : m_ranks)
+			m_keys.Add(pSorted[rank]);
+	}
+
+	template <typename K, Comparator<K, K> C>
+	auto EytzingerIndex<K, C>::LowerBound(const K& key) const noexcept -> usize
+	{
+		const K* pKeys = m_keys.Data();
+		const usize size = m_keys.Size();
+
+		// Descend the implicit tree, the path taken is encoded in the bits of the node index (1 for right, 0 for left)
+		usize node = 1;
+		while (node <= size)
+		{
+			Prefetch(pKeys, node);
+			node = node * 2 + usize(m_comp(pKeys[node - 1], key) < 0);
+		}
+
+		// The lower bound is the last node where the search went left, so strip the trailing right turns and the final left turn
+		node >>= Intrin::OneCountLSB(node) + 1;
+		return node == 0 ? size : m_ranks[node - 1];
+	}
+
+	template <typename K, Comparator<K, K> C>
+	auto EytzingerIndex<K, C>::Find(const K& key) const noexcept -> usize
+	{
+		const K* pKeys = m_keys.Data();
+		const usize size = m_keys.Size();
+
+		usize node = 1;
+		while (node <= size)
+		{
+			Prefetch(pKeys, node);
+			node = node * 2 + usize(m_comp(pKeys[node - 1], key) < 0);
+		}
+
+		node >>= Intrin::OneCountLSB(node) + 1;
+		return node != 0 && m_comp(pKeys[node - 1], key) == 0 ? m_ranks[node - 1] : NPos;
+	}
+
+	template <typename K, Comparator<K, K> C>
+	auto EytzingerIndex<K, C>::Size() const noexcept -> usize
+	{
+		return m_keys.Size();
+	}
+
+	template <typename K, Comparator<K, K> C>
+	void EytzingerIndex<K, C>::Prefetch(const K* pKeys, usize node) noexcept
+	{
+		// The descendants of a node, a number of levels down, are stored contiguously, so when they fit in a cache line, that line can be fetched while the levels in between are searched
+		if constexpr (PrefetchLevels != 0)
+		{
+			// The address is calculated as an integer, since it is allowed to point past the end of the keys
+			const usize descendant = node << PrefetchLevels;
+			const K* pDescendants = reinterpret_cast<const K*>(reinterpret_cast<usize>(pKeys) + descendant * sizeof(K));
+#if COMPILER_MSVC
+			_mm_prefetch(reinterpret_cast<const char*>(pDescendants), _MM_HINT_T0);
+#elif COMPILER_CLANG || COMPILER_GCC
+			__builtin_prefetch(pDescendants);
+#endif
+		}
+	}
+
+	template <typename K, Comparator<K, K> C>
+	void EytzingerIndex<K, C>::AssignRanks(usize node, u32& sortedIdx) noexcept
+	{
+		// An in-order walk of the implicit tree visits the nodes in sorted order
+		if (node > m_ranks.Size())
+			return;
+
+		AssignRanks(node * 2, sortedIdx);
+		m_ranks[node - 1] = sortedIdx++;
+		AssignRanks(node * 2 + 1, sortedIdx);
+	}
+}
@@ -0,0 +1,366 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "DynArray.h"
+#include "InplaceDynArray.h"
+#include "core/utils/Algo.h"
+#include "core/utils/Utils.h"
+
+namespace Onca
+{
+	/**
+	 * \brief A sorted map, storing its keys and values in 2 separate contiguous arrays
+	 *
+	 * Keys and values are stored as a structure of arrays, so a lookup only touches the keys, which are searched with a branchless binary search.
+	 * For small or read-mostly maps this is considerably faster than walking a tree, and iteration is a linear walk over memory.
+	 * Inserting and erasing needs to shift all elements after the modified element, so they are O(n).
+	 * When building a map from a lot of elements, prefer the bulk constructors, which sort and deduplicate the elements in a single pass.
+	 *
+	 * \tparam K Key type (needs to conform to Onca::Movable)
+	 * \tparam V Value type (needs to conform to Onca::Movable)
+	 * \tparam C Comparator type
+	 * \tparam KS Key storage type, a contiguous array of keys (DynArray or InplaceDynArray)
+	 * \tparam VS Value storage type, a contiguous array of values (DynArray or InplaceDynArray)
+	 */
+	template<typename K, typename V, Comparator<K, K> C = DefaultComparator<K>, typename KS = DynArray<K>, typename VS = DynArray<V>>
+	class FlatMap
+	{
+		// static assert to get around incomplete type issues when a class can return a FlatMap of itself
+		STATIC_ASSERT(Movable<K>, "Key type needs to be movable to be used in a FlatMap");
+		STATIC_ASSERT(Movable<V>, "Value type needs to be movable to be used in a FlatMap");
+		STATIC_ASSERT((IsSame<typename KS::Iterator, K*>), "FlatMap key storage needs to store its keys contiguously");
+		STATIC_ASSERT((IsSame<typename VS::Iterator, V*>), "FlatMap value storage needs to store its values contiguously");
+	private:
+		template<bool IsConst>
+		class IteratorImpl
+		{
+			using ValueType = Conditional<IsConst, const V, V>;
+		public:
+			/**
+			 * References to the key and value an iterator points to
+			 */
+			struct Reference
+			{
+				const K&   key;   ///< Key
+				ValueType& value; ///< Value
+			};
+
+			IteratorImpl() noexcept = default;
+
+			operator IteratorImpl<true>() const noexcept requires (!IsConst);
+
+			auto Key() const noexcept -> const K&;
+			auto Value() const noexcept -> ValueType&;
+			auto operator*() const noexcept -> Reference;
+
+			auto operator++() noexcept -> IteratorImpl&;
+			auto operator++(int) noexcept -> IteratorImpl;
+
+			auto operator--() noexcept -> IteratorImpl&;
+			auto operator--(int) noexcept -> IteratorImpl;
+
+			auto operator+(usize count) const noexcept -> IteratorImpl;
+			auto operator-(usize count) const noexcept -> IteratorImpl;
+			auto operator-(const IteratorImpl& other) const noexcept -> isize;
+
+			auto operator+=(usize count) noexcept -> IteratorImpl&;
+			auto operator-=(usize count) noexcept -> IteratorImpl&;
+
+			auto operator==(const IteratorImpl& other) const noexcept -> bool;
+			auto operator!=(const IteratorImpl& other) const noexcept -> bool;
+
+		private:
+			IteratorImpl(const K* pKey, ValueType* pValue) noexcept;
+
+			const K*   m_pKey = nullptr;   ///< Pointer to the key
+			ValueType* m_pValue = nullptr; ///< Pointer to the value
+
+			template<bool>
+			friend class IteratorImpl;
+			friend class FlatMap;
+		};
+
+	public:
+		using Iterator = IteratorImpl<false>;
+		using ConstIterator = IteratorImpl<true>;
+		using KeyStorage = KS;
+		using ValueStorage = VS;
+
+		/**
+		 * Create an empty FlatMap
+		 */
+		FlatMap() noexcept;
+		/**
+		 * Create an empty FlatMap
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit FlatMap(Alloc::IAllocator& alloc) noexcept requires ConstructableFrom<KS, Alloc::IAllocator&> && ConstructableFrom<VS, Alloc::IAllocator&>;
+		/**
+		 * Create a FlatMap from unsorted key-value pairs, of all pairs with the same key only the last one is kept, like when inserting them in order
+		 * \param[in] pairs Key-value pairs
+		 * \param[in] comp Comparator to compare keys with
+		 * \note When the storage supports allocators, it will use the allocator of the pairs
+		 */
+		explicit FlatMap(DynArray<Pair<K, V>>&& pairs, C comp = C{}) noexcept;
+		/**
+		 * Create a FlatMap from unsorted key-value pairs, of all pairs with the same key only the last one is kept, like when inserting them in order
+		 * \param[in] il Initializer list with key-value pairs
+		 * \param[in] comp Comparator to compare keys with
+		 */
+		explicit FlatMap(const InitializerList<Pair<K, V>>& il, C comp = C{}) noexcept requires CopyConstructible<K> && CopyConstructible<V>;
+		/**
+		 * Create a FlatMap from unsorted key-value pairs, of all pairs with the same key only the last one is kept, like when inserting them in order
+		 * \tparam It Iterator type
+		 * \param[in] begin Begin iterator
+		 * \param[in] end End iterator
+		 * \param[in] comp Comparator to compare keys with
+		 */
+		template<ForwardIterator It>
+		explicit FlatMap(const It& begin, const It& end, C comp = C{}) noexcept requires CopyConstructible<K> && CopyConstructible<V>;
+
+		/**
+		 * Insert a key-value pair into the FlatMap, override the value if the key already exists
+		 * \param[in] key Key to insert
+		 * \param[in] val Value to insert
+		 * \return A pair with the iterator to the element and a bool, where true means the element was inserted and false if the value was overriden
+		 */
+		auto Insert(const K& key, const V& val) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K> && CopyConstructible<V>;
+		/**
+		 * Insert a key-value pair into the FlatMap, override the value if the key already exists
+		 * \param[in] key Key to insert
+		 * \param[in] val Value to insert
+		 * \return A pair with the iterator to the element and a bool, where true means the element was inserted and false if the value was overriden
+		 */
+		auto Insert(K&& key, V&& val) noexcept -> Pair<Iterator, bool>;
+		/**
+		 * Try to insert a key-value pair into the FlatMap
+		 * \param[in] key Key to insert
+		 * \param[in] val Value to insert
+		 * \return A pair with the iterator to the element and a bool if the insertion was successful
+		 */
+		auto TryInsert(const K& key, const V& val) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K> && CopyConstructible<V>;
+		/**
+		 * Try to insert a key-value pair into the FlatMap
+		 * \param[in] key Key to insert
+		 * \param[in] val Value to insert
+		 * \return A pair with the iterator to the element and a bool if the insertion was successful
+		 */
+		auto TryInsert(K&& key, V&& val) noexcept -> Pair<Iterator, bool>;
+		/**
+		 * Try to emplace a value into the FlatMap, the value is only constructed when the key does not exist yet
+		 * \tparam Args Type of arguments
+		 * \param[in] key Key to insert
+		 * \param[in] args Arguments
+		 * \return A pair with the iterator to the element and a bool if the insertion was successful
+		 */
+		template<typename ...Args>
+			requires ConstructableFrom<V, Args...>
+		auto TryEmplace(const K& key, Args&&... args) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K>;
+
+		/**
+		 * Reserve space for a number of elements
+		 * \param[in] capacity Number of elements to reserve space for
+		 */
+		void Reserve(usize capacity) noexcept requires requires(KS& keys, VS& values, usize n) { keys.Reserve(n); values.Reserve(n); };
+		/**
+		 * Clear the contents of the FlatMap
+		 */
+		void Clear() noexcept;
+
+		/**
+		 * Erase an element from the FlatMap
+		 * \param[in] it Iterator to the element to erase
+		 * \return Iterator to the element after the erased element
+		 */
+		auto Erase(ConstIterator it) noexcept -> Iterator;
+		/**
+		 * Erase an element from the FlatMap
+		 * \param[in] key Key of the element to erase
+		 * \return Number of elements removed
+		 */
+		auto Erase(const K& key) noexcept -> usize;
+
+		/**
+		 * Find the element with a key
+		 * \param[in] key Key to find
+		 * \return Iterator to the found element, or to end when the key wasn't found
+		 */
+		auto Find(const K& key) noexcept -> Iterator;
+		/**
+		 * Find the element with a key
+		 * \param[in] key Key to find
+		 * \return Iterator to the found element, or to end when the key wasn't found
+		 */
+		auto Find(const K& key) const noexcept -> ConstIterator;
+		/**
+		 * Get an iterator to the first element with a key that is not ordered before a key
+		 * \param[in] key Key to look for
+		 * \return Iterator to the found element, or to end when all keys are ordered before the key
+		 */
+		auto LowerBound(const K& key) noexcept -> Iterator;
+		/**
+		 * Get an iterator to the first element with a key that is not ordered before a key
+		 * \param[in] key Key to look for
+		 * \return Iterator to the found element, or to end when all keys are ordered before the key
+		 */
+		auto LowerBound(const K& key) const noexcept -> ConstIterator;
+		/**
+		 * Check if the FlatMap contains a key
+		 * \param[in] key Key to find
+		 * \return Whether the FlatMap contains the key
+		 */
+		auto Contains(const K& key) const noexcept -> bool;
+
+		/**
+		 * \brief Get the value at a key
+		 * \param[in] key Key of the element
+		 * \return Optional with value
+		 * \note Will return an empty optional when the key wasn't found
+		 */
+		auto At(const K& key) const noexcept -> Optional<V> requires CopyConstructible<V>;
+		/**
+		 * \brief Get the value at a key
+		 * \param[in] key Key of the element
+		 * \return Value at the key
+		 * \note Only use when the FlatMap contains the key
+		 */
+		auto operator[](const K& key) noexcept -> V&;
+		/**
+		 * \brief Get the value at a key
+		 * \param[in] key Key of the element
+		 * \return Value at the key
+		 * \note Only use when the FlatMap contains the key
+		 */
+		auto operator[](const K& key) const noexcept -> const V&;
+
+		/**
+		 * Get the key at an index
+		 * \param[in] idx Index of the element
+		 * \return Key at the index
+		 */
+		auto KeyAt(usize idx) const noexcept -> const K&;
+		/**
+		 * Get the value at an index
+		 * \param[in] idx Index of the element
+		 * \return Value at the index
+		 */
+		auto ValueAt(usize idx) noexcept -> V&;
+		/**
+		 * Get the value at an index
+		 * \param[in] idx Index of the element
+		 * \return Value at the index
+		 */
+		auto ValueAt(usize idx) const noexcept -> const V&;
+
+		/**
+		 * Get the sorted keys
+		 * \return Sorted keys
+		 */
+		auto Keys() const noexcept -> const KS&;
+		/**
+		 * Get the values, in the same order as the keys
+		 * \return Values
+		 */
+		auto Values() const noexcept -> const VS&;
+
+		/**
+		 * Get the size of the FlatMap
+		 * \return Size of the FlatMap
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Get the capacity of the FlatMap
+		 * \return Capacity of the FlatMap
+		 */
+		auto Capacity() const noexcept -> usize;
+		/**
+		 * Check if the FlatMap is empty
+		 * \return Whether the FlatMap is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+		/**
+		 * Get an iterator to the first element
+		 * \return Iterator to the first element
+		 */
+		auto Begin() noexcept -> Iterator;
+		/**
+		 * Get an iterator to the first element
+		 * \return Iterator to the first element
+		 */
+		auto Begin() const noexcept -> ConstIterator;
+		/**
+		 * Get an iterator to the end of the elements
+		 * \return Iterator to the end of the elements
+		 */
+		auto End() noexcept -> Iterator;
+		/**
+		 * Get an iterator to the end of the elements
+		 * \return Iterator to the end of the elements
+		 */
+		auto End() const noexcept -> ConstIterator;
+
+		// Overloads for 'for ( ... : ... )'
+		auto begin() noexcept -> Iterator;
+		auto begin() const noexcept -> ConstIterator;
+		auto cbegin() const noexcept -> ConstIterator;
+		auto end() noexcept -> Iterator;
+		auto end() const noexcept -> ConstIterator;
+		auto cend() const noexcept -> ConstIterator;
+
+	private:
+		/**
+		 * Create an empty storage, using an allocator if the storage supports it
+		 * \tparam S Storage type
+		 * \param[in] alloc Allocator
+		 * \return Storage
+		 */
+		template<typename S>
+		static auto CreateStorage(Alloc::IAllocator& alloc) noexcept -> S;
+
+		/**
+		 * Sort and deduplicate key-value pairs and move them into the storage, keeping the last pair of each key
+		 * \param[in] pairs Key-value pairs
+		 */
+		void Build(DynArray<Pair<K, V>>& pairs) noexcept;
+
+		/**
+		 * Get the index of the first key that is not ordered before a key
+		 * \param[in] key Key to look for
+		 * \return Index of the found key, or the size when all keys are ordered before the key
+		 */
+		auto LowerBoundIndex(const K& key) const noexcept -> usize;
+		/**
+		 * Get the index of a key
+		 * \param[in] key Key to find
+		 * \return Index of the key, or the size when the key wasn't found
+		 */
+		auto FindIndex(const K& key) const noexcept -> usize;
+		/**
+		 * Insert a key-value pair at an index
+		 * \param[in] idx Index to insert at
+		 * \param[in] key Key to insert
+		 * \param[in] val Value to insert
+		 * \return Iterator to the inserted element
+		 */
+		auto InsertAt(usize idx, K&& key, V&& val) noexcept -> Iterator;
+
+		auto IteratorAt(usize idx) noexcept -> Iterator;
+		auto IteratorAt(usize idx) const noexcept -> ConstIterator;
+
+		KS                  m_keys;   ///< Sorted keys
+		VS                  m_values; ///< Values, in the same order as the keys
+		NO_UNIQUE_ADDRESS C m_comp;   ///< Comparator
+	};
+
+	/**
+	 * A FlatMap with a fixed capacity, storing its keys and values inline
+	 * \tparam K Key type (needs to conform to Onca::Movable)
+	 * \tparam V Value type (needs to conform to Onca::Movable)
+	 * \tparam Cap Maximum number of elements
+	 * \tparam C Comparator type
+	 */
+	template<typename K, typename V, usize Cap, Comparator<K, K> C = DefaultComparator<K>>
+	using InplaceFlatMap = FlatMap<K, V, C, InplaceDynArray<K, Cap>, InplaceDynArray<V, Cap>>;
+}
+
+#include "FlatMap.inl"
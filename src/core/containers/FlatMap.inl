@@ -0,0 +1,495 @@
+#pragma once
+#if __RESHARPER__
+#include "FlatMap.h"
+#endif
+
+namespace Onca
+{
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator IteratorImpl<true>() const noexcept requires (!IsConst)
+	{
+		return { m_pKey, m_pValue };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::Key() const noexcept -> const K&
+	{
+		return *m_pKey;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::Value() const noexcept -> ValueType&
+	{
+		return *m_pValue;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator*() const noexcept -> Reference
+	{
+		return { *m_pKey, *m_pValue };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator++() noexcept -> IteratorImpl&
+	{
+		++m_pKey;
+		++m_pValue;
+		return *this;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator++(int) noexcept -> IteratorImpl
+	{
+		IteratorImpl tmp = *this;
+		++*this;
+		return tmp;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator--() noexcept -> IteratorImpl&
+	{
+		--m_pKey;
+		--m_pValue;
+		return *this;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator--(int) noexcept -> IteratorImpl
+	{
+		IteratorImpl tmp = *this;
+		--*this;
+		return tmp;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator+(usize count) const noexcept -> IteratorImpl
+	{
+		return { m_pKey + count, m_pValue + count };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator-(usize count) const noexcept -> IteratorImpl
+	{
+		return { m_pKey - count, m_pValue - count };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator-(const IteratorImpl& other) const noexcept -> isize
+	{
+		return m_pKey - other.m_pKey;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator+=(usize count) noexcept -> IteratorImpl&
+	{
+		m_pKey += count;
+		m_pValue += count;
+		return *this;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator-=(usize count) noexcept -> IteratorImpl&
+	{
+		m_pKey -= count;
+		m_pValue -= count;
+		return *this;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator==(const IteratorImpl& other) const noexcept -> bool
+	{
+		return m_pKey == other.m_pKey;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	auto FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::operator!=(const IteratorImpl& other) const noexcept -> bool
+	{
+		return !(*this == other);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <bool IsConst>
+	FlatMap<K, V, C, KS, VS>::IteratorImpl<IsConst>::IteratorImpl(const K* pKey, ValueType* pValue) noexcept
+		: m_pKey(pKey)
+		, m_pValue(pValue)
+	{
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	FlatMap<K, V, C, KS, VS>::FlatMap() noexcept
+		: m_keys()
+		, m_values()
+		, m_comp()
+	{
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	FlatMap<K, V, C, KS, VS>::FlatMap(Alloc::IAllocator& alloc) noexcept requires ConstructableFrom<KS, Alloc::IAllocator&> && ConstructableFrom<VS, Alloc::IAllocator&>
+		: m_keys(alloc)
+		, m_values(alloc)
+		, m_comp()
+	{
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	FlatMap<K, V, C, KS, VS>::FlatMap(DynArray<Pair<K, V>>&& pairs, C comp) noexcept
+		: m_keys(CreateStorage<KS>(*pairs.GetAllocator()))
+		, m_values(CreateStorage<VS>(*pairs.GetAllocator()))
+		, m_comp(Move(comp))
+	{
+		Build(pairs);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	FlatMap<K, V, C, KS, VS>::FlatMap(const InitializerList<Pair<K, V>>& il, C comp) noexcept requires CopyConstructible<K> && CopyConstructible<V>
+		: FlatMap(DynArray<Pair<K, V>>(il), Move(comp))
+	{
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <ForwardIterator It>
+	FlatMap<K, V, C, KS, VS>::FlatMap(const It& begin, const It& end, C comp) noexcept requires CopyConstructible<K> && CopyConstructible<V>
+		: FlatMap(DynArray<Pair<K, V>>(begin, end), Move(comp))
+	{
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Insert(const K& key, const V& val) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K> && CopyConstructible<V>
+	{
+		return Insert(K{ key }, V{ val });
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Insert(K&& key, V&& val) noexcept -> Pair<Iterator, bool>
+	{
+		const usize idx = LowerBoundIndex(key);
+		if (idx != m_keys.Size() && m_comp(m_keys[idx], key) == 0)
+		{
+			m_values[idx] = Move(val);
+			return { IteratorAt(idx), false };
+		}
+		return { InsertAt(idx, Move(key), Move(val)), true };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::TryInsert(const K& key, const V& val) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K> && CopyConstructible<V>
+	{
+		return TryInsert(K{ key }, V{ val });
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::TryInsert(K&& key, V&& val) noexcept -> Pair<Iterator, bool>
+	{
+		const usize idx = LowerBoundIndex(key);
+		if (idx != m_keys.Size() && m_comp(m_keys[idx], key) == 0)
+			return { IteratorAt(idx), false };
+		return { InsertAt(idx, Move(key), Move(val)), true };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <typename ... Args>
+		requires ConstructableFrom<V, Args...>
+	auto FlatMap<K, V, C, KS, VS>::TryEmplace(const K& key, Args&&... args) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K>
+	{
+		const usize idx = LowerBoundIndex(key);
+		if (idx != m_keys.Size() && m_comp(m_keys[idx], key) == 0)
+			return { IteratorAt(idx), false };
+		return { InsertAt(idx, K{ key }, V{ Forward<Args>(args)... }), true };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	void FlatMap<K, V, C, KS, VS>::Reserve(usize capacity) noexcept requires requires(KS& keys, VS& values, usize n) { keys.Reserve(n); values.Reserve(n); }
+	{
+		m_keys.Reserve(capacity);
+		m_values.Reserve(capacity);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	void FlatMap<K, V, C, KS, VS>::Clear() noexcept
+	{
+		m_keys.Clear();
+		m_values.Clear();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Erase(ConstIterator it) noexcept -> Iterator
+	{
+		const usize idx = usize(it.m_pKey - m_keys.Data());
+		ASSERT(idx < m_keys.Size(), "Iterator out of range");
+		m_keys.Erase(m_keys.Data() + idx);
+		m_values.Erase(m_values.Data() + idx);
+		return IteratorAt(idx);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Erase(const K& key) noexcept -> usize
+	{
+		const usize idx = FindIndex(key);
+		if (idx == m_keys.Size())
+			return 0;
+		Erase(IteratorAt(idx));
+		return 1;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Find(const K& key) noexcept -> Iterator
+	{
+		return IteratorAt(FindIndex(key));
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Find(const K& key) const noexcept -> ConstIterator
+	{
+		return IteratorAt(FindIndex(key));
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::LowerBound(const K& key) noexcept -> Iterator
+	{
+		return IteratorAt(LowerBoundIndex(key));
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::LowerBound(const K& key) const noexcept -> ConstIterator
+	{
+		return IteratorAt(LowerBoundIndex(key));
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Contains(const K& key) const noexcept -> bool
+	{
+		return FindIndex(key) != m_keys.Size();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::At(const K& key) const noexcept -> Optional<V> requires CopyConstructible<V>
+	{
+		const usize idx = FindIndex(key);
+		if (idx == m_keys.Size())
+			return NullOpt;
+		return m_values[idx];
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::operator[](const K& key) noexcept -> V&
+	{
+		const usize idx = FindIndex(key);
+		ASSERT(idx != m_keys.Size(), "Key is not in the FlatMap");
+		return m_values[idx];
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::operator[](const K& key) const noexcept -> const V&
+	{
+		const usize idx = FindIndex(key);
+		ASSERT(idx != m_keys.Size(), "Key is not in the FlatMap");
+		return m_values[idx];
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::KeyAt(usize idx) const noexcept -> const K&
+	{
+		return m_keys[idx];
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::ValueAt(usize idx) noexcept -> V&
+	{
+		return m_values[idx];
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::ValueAt(usize idx) const noexcept -> const V&
+	{
+		return m_values[idx];
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Keys() const noexcept -> const KS&
+	{
+		return m_keys;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Values() const noexcept -> const VS&
+	{
+		return m_values;
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Size() const noexcept -> usize
+	{
+		return m_keys.Size();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Capacity() const noexcept -> usize
+	{
+		return m_keys.Capacity() < m_values.Capacity() ? m_keys.Capacity() : m_values.Capacity();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::IsEmpty() const noexcept -> bool
+	{
+		return m_keys.IsEmpty();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Begin() noexcept -> Iterator
+	{
+		return IteratorAt(0);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::Begin() const noexcept -> ConstIterator
+	{
+		return IteratorAt(0);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::End() noexcept -> Iterator
+	{
+		return IteratorAt(m_keys.Size());
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::End() const noexcept -> ConstIterator
+	{
+		return IteratorAt(m_keys.Size());
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::begin() noexcept -> Iterator
+	{
+		return Begin();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::begin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::cbegin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::end() noexcept -> Iterator
+	{
+		return End();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::end() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::cend() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	template <typename S>
+	auto FlatMap<K, V, C, KS, VS>::CreateStorage(Alloc::IAllocator& alloc) noexcept -> S
+	{
+		if constexpr (ConstructableFrom<S, Alloc::IAllocator&>)
+			return S(alloc);
+		else
+			return S();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	void FlatMap<K, V, C, KS, VS>::Build(DynArray<Pair<K, V>>& pairs) noexcept
+	{
+		// Indices are sorted instead of the pairs, with the original index breaking ties, so the order of pairs with the same key is kept
+		const usize size = pairs.Size();
+		DynArray<usize> order{ size, *pairs.GetAllocator() };
+		for (usize i = 0; i < size; ++i)
+			order.Add(i);
+
+		Algo::Sort(order.begin(), order.end(), [this, &pairs](usize i0, usize i1) noexcept -> i8
+		{
+			const i8 res = m_comp(pairs[i0].first, pairs[i1].first);
+			return res ? res : (i0 < i1 ? -1 : 1);
+		});
+
+		// Of all pairs with the same key, only the last one is kept, as if the pairs were inserted in order
+		const auto isLastOfKey = [this, &pairs, &order, size](usize i) noexcept -> bool
+		{
+			return i + 1 == size || m_comp(pairs[order[i]].first, pairs[order[i + 1]].first) != 0;
+		};
+
+		if constexpr (requires(KS& keys, VS& values, usize n) { keys.Reserve(n); values.Reserve(n); })
+		{
+			usize numUnique = 0;
+			for (usize i = 0; i < size; ++i)
+				numUnique += isLastOfKey(i);
+			Reserve(numUnique);
+		}
+
+		for (usize i = 0; i < size; ++i)
+		{
+			if (!isLastOfKey(i))
+				continue;
+
+			Pair<K, V>& pair = pairs[order[i]];
+			m_keys.Add(Move(pair.first));
+			m_values.Add(Move(pair.second));
+		}
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::LowerBoundIndex(const K& key) const noexcept -> usize
+	{
+		const K* pKeys = m_keys.Data();
+		return usize(Algo::LowerBound(pKeys, pKeys + m_keys.Size(), key, m_comp) - pKeys);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::FindIndex(const K& key) const noexcept -> usize
+	{
+		const usize idx = LowerBoundIndex(key);
+		return idx != m_keys.Size() && m_comp(m_keys[idx], key) == 0 ? idx : m_keys.Size();
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::InsertAt(usize idx, K&& key, V&& val) noexcept -> Iterator
+	{
+		m_keys.Insert(m_keys.Data() + idx, Move(key));
+		m_values.Insert(m_values.Data() + idx, Move(val));
+		return IteratorAt(idx);
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::IteratorAt(usize idx) noexcept -> Iterator
+	{
+		return { m_keys.Data() + idx, m_values.Data() + idx };
+	}
+
+	template <typename K, typename V, Comparator<K, K> C, typename KS, typename VS>
+	auto FlatMap<K, V, C, KS, VS>::IteratorAt(usize idx) const noexcept -> ConstIterator
+	{
+		return { m_keys.Data() + idx, m_values.Data() + idx };
+	}
+}
@@ -0,0 +1,221 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "DynArray.h"
+#include "InplaceDynArray.h"
+#include "core/utils/Algo.h"
+#include "core/utils/Utils.h"
+
+namespace Onca
+{
+	/**
+	 * \brief A sorted set, storing its keys in a contiguous array
+	 *
+	 * Lookups are a branchless binary search over the keys, which for small or read-mostly sets is considerably faster than walking a tree,
+	 * and iteration is a linear walk over memory. Inserting and erasing needs to shift all keys after the modified key, so they are O(n).
+	 * When building a set from a lot of keys, prefer the bulk constructors or the range insert, which sort and deduplicate the keys in a single pass.
+	 *
+	 * \tparam K Key type (needs to conform to Onca::Movable)
+	 * \tparam C Comparator type
+	 * \tparam S Storage type, a contiguous array of keys (DynArray or InplaceDynArray)
+	 */
+	template<typename K, Comparator<K, K> C = DefaultComparator<K>, typename S = DynArray<K>>
+	class FlatSet
+	{
+		// static assert to get around incomplete type issues when a class can return a FlatSet of itself
+		STATIC_ASSERT(Movable<K>, "Key type needs to be movable to be used in a FlatSet");
+		STATIC_ASSERT((IsSame<typename S::Iterator, K*>), "FlatSet storage needs to store its keys contiguously");
+	public:
+		using Iterator = const K*;
+		using ConstIterator = const K*;
+		using Storage = S;
+
+		/**
+		 * Create an empty FlatSet
+		 */
+		FlatSet() noexcept;
+		/**
+		 * Create an empty FlatSet
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit FlatSet(Alloc::IAllocator& alloc) noexcept requires ConstructableFrom<S, Alloc::IAllocator&>;
+		/**
+		 * Create a FlatSet from unsorted keys, duplicate keys are removed
+		 * \param[in] keys Keys
+		 * \param[in] comp Comparator to compare keys with
+		 */
+		explicit FlatSet(S&& keys, C comp = C{}) noexcept;
+		/**
+		 * Create a FlatSet from unsorted keys, duplicate keys are removed
+		 * \param[in] il Initializer list with keys
+		 * \param[in] comp Comparator to compare keys with
+		 */
+		explicit FlatSet(const InitializerList<K>& il, C comp = C{}) noexcept requires CopyConstructible<K>;
+		/**
+		 * Create a FlatSet from unsorted keys, duplicate keys are removed
+		 * \tparam It Iterator type
+		 * \param[in] begin Begin iterator
+		 * \param[in] end End iterator
+		 * \param[in] comp Comparator to compare keys with
+		 */
+		template<ForwardIterator It>
+		explicit FlatSet(const It& begin, const It& end, C comp = C{}) noexcept requires CopyConstructible<K>;
+
+		/**
+		 * Insert a key into the FlatSet
+		 * \param[in] key Key to insert
+		 * \return A pair with the iterator to the key and a bool, where true means the key was inserted and false means the key was already in the FlatSet
+		 */
+		auto Insert(const K& key) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K>;
+		/**
+		 * Insert a key into the FlatSet
+		 * \param[in] key Key to insert
+		 * \return A pair with the iterator to the key and a bool, where true means the key was inserted and false means the key was already in the FlatSet
+		 */
+		auto Insert(K&& key) noexcept -> Pair<Iterator, bool>;
+		/**
+		 * Insert a range of unsorted keys into the FlatSet
+		 * \tparam It Iterator type
+		 * \param[in] begin Begin iterator
+		 * \param[in] end End iterator
+		 * \note The keys are appended and the FlatSet is sorted once, so this is O((n + m) log(n + m)) instead of O(n * m) when inserting the keys one by one
+		 */
+		template<ForwardIterator It>
+		void Insert(const It& begin, const It& end) noexcept requires CopyConstructible<K>;
+		/**
+		 * Emplace a key into the FlatSet
+		 * \tparam Args Type of arguments
+		 * \param[in] args Arguments
+		 * \return A pair with the iterator to the key and a bool, where true means the key was inserted and false means the key was already in the FlatSet
+		 */
+		template<typename ...Args>
+			requires ConstructableFrom<K, Args...>
+		auto Emplace(Args&&... args) noexcept -> Pair<Iterator, bool>;
+
+		/**
+		 * Reserve space for a number of keys
+		 * \param[in] capacity Number of keys to reserve space for
+		 */
+		void Reserve(usize capacity) noexcept requires requires(S& storage, usize n) { storage.Reserve(n); };
+		/**
+		 * Clear the contents of the FlatSet
+		 */
+		void Clear() noexcept;
+
+		/**
+		 * Erase a key from the FlatSet
+		 * \param[in] it Iterator to the key to erase
+		 * \return Iterator to the key after the erased key
+		 */
+		auto Erase(ConstIterator it) noexcept -> Iterator;
+		/**
+		 * Erase a key from the FlatSet
+		 * \param[in] key Key to erase
+		 * \return Number of keys removed
+		 */
+		auto Erase(const K& key) noexcept -> usize;
+
+		/**
+		 * Find a key
+		 * \param[in] key Key to find
+		 * \return Iterator to the found key, or to end when the key wasn't found
+		 */
+		auto Find(const K& key) const noexcept -> ConstIterator;
+		/**
+		 * Get an iterator to the first key that is not ordered before a key
+		 * \param[in] key Key to look for
+		 * \return Iterator to the found key, or to end when all keys are ordered before the key
+		 */
+		auto LowerBound(const K& key) const noexcept -> ConstIterator;
+		/**
+		 * Get an iterator to the first key that is ordered after a key
+		 * \param[in] key Key to look for
+		 * \return Iterator to the found key, or to end when no key is ordered after the key
+		 */
+		auto UpperBound(const K& key) const noexcept -> ConstIterator;
+		/**
+		 * Check if the FlatSet contains a key
+		 * \param[in] key Key to find
+		 * \return Whether the FlatSet contains the key
+		 */
+		auto Contains(const K& key) const noexcept -> bool;
+
+		/**
+		 * Get the key at an index
+		 * \param[in] idx Index of the key
+		 * \return Key at the index
+		 * \note Only use with an index smaller than the size of the FlatSet
+		 */
+		auto operator[](usize idx) const noexcept -> const K&;
+
+		/**
+		 * Get the size of the FlatSet
+		 * \return Size of the FlatSet
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Get the capacity of the FlatSet
+		 * \return Capacity of the FlatSet
+		 */
+		auto Capacity() const noexcept -> usize;
+		/**
+		 * Check if the FlatSet is empty
+		 * \return Whether the FlatSet is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get a pointer to the sorted keys
+		 * \return Pointer to the sorted keys
+		 */
+		auto Data() const noexcept -> const K*;
+
+		/**
+		 * Get the first key in the FlatSet
+		 * \return First key in the FlatSet
+		 * \note Only use when the FlatSet is not empty
+		 */
+		auto Front() const noexcept -> const K&;
+		/**
+		 * Get the last key in the FlatSet
+		 * \return Last key in the FlatSet
+		 * \note Only use when the FlatSet is not empty
+		 */
+		auto Back() const noexcept -> const K&;
+
+		/**
+		 * Get an iterator to the first key
+		 * \return Iterator to the first key
+		 */
+		auto Begin() const noexcept -> ConstIterator;
+		/**
+		 * Get an iterator to the end of the keys
+		 * \return Iterator to the end of the keys
+		 */
+		auto End() const noexcept -> ConstIterator;
+
+		// Overloads for 'for ( ... : ... )'
+		auto begin() const noexcept -> ConstIterator;
+		auto cbegin() const noexcept -> ConstIterator;
+		auto end() const noexcept -> ConstIterator;
+		auto cend() const noexcept -> ConstIterator;
+
+	private:
+		/**
+		 * Sort all keys and remove duplicates
+		 */
+		void SortAndDedupe() noexcept;
+
+		S                   m_keys; ///< Sorted keys
+		NO_UNIQUE_ADDRESS C m_comp; ///< Comparator
+	};
+
+	/**
+	 * A FlatSet with a fixed capacity, storing its keys inline
+	 * \tparam K Key type (needs to conform to Onca::Movable)
+	 * \tparam Cap Maximum number of keys
+	 * \tparam C Comparator type
+	 */
+	template<typename K, usize Cap, Comparator<K, K> C = DefaultComparator<K>>
+	using InplaceFlatSet = FlatSet<K, C, InplaceDynArray<K, Cap>>;
+}
+
+#include "FlatSet.inl"
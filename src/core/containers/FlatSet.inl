@@ -0,0 +1,230 @@
+#pragma once
+#if __RESHARPER__
+#include "FlatSet.h"
+#endif
+
+namespace Onca
+{
+	template <typename K, Comparator<K, K> C, typename S>
+	FlatSet<K, C, S>::FlatSet() noexcept
+		: m_keys()
+		, m_comp()
+	{
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	FlatSet<K, C, S>::FlatSet(Alloc::IAllocator& alloc) noexcept requires ConstructableFrom<S, Alloc::IAllocator&>
+		: m_keys(alloc)
+		, m_comp()
+	{
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	FlatSet<K, C, S>::FlatSet(S&& keys, C comp) noexcept
+		: m_keys(Move(keys))
+		, m_comp(Move(comp))
+	{
+		SortAndDedupe();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	FlatSet<K, C, S>::FlatSet(const InitializerList<K>& il, C comp) noexcept requires CopyConstructible<K>
+		: m_keys(il)
+		, m_comp(Move(comp))
+	{
+		SortAndDedupe();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	template <ForwardIterator It>
+	FlatSet<K, C, S>::FlatSet(const It& begin, const It& end, C comp) noexcept requires CopyConstructible<K>
+		: m_keys(begin, end)
+		, m_comp(Move(comp))
+	{
+		SortAndDedupe();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Insert(const K& key) noexcept -> Pair<Iterator, bool> requires CopyConstructible<K>
+	{
+		return Insert(K{ key });
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Insert(K&& key) noexcept -> Pair<Iterator, bool>
+	{
+		const usize idx = usize(LowerBound(key) - m_keys.Data());
+		if (idx != m_keys.Size() && m_comp(m_keys[idx], key) == 0)
+			return { m_keys.Data() + idx, false };
+
+		m_keys.Insert(m_keys.Data() + idx, Move(key));
+		return { m_keys.Data() + idx, true };
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	template <ForwardIterator It>
+	void FlatSet<K, C, S>::Insert(const It& begin, const It& end) noexcept requires CopyConstructible<K>
+	{
+		if constexpr (requires(S& storage, usize n) { storage.Reserve(n); })
+			m_keys.Reserve(m_keys.Size() + CountElems(begin, end));
+
+		for (It it = begin; it != end; ++it)
+			m_keys.Add(*it);
+		SortAndDedupe();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	template <typename ... Args>
+		requires ConstructableFrom<K, Args...>
+	auto FlatSet<K, C, S>::Emplace(Args&&... args) noexcept -> Pair<Iterator, bool>
+	{
+		return Insert(K{ Forward<Args>(args)... });
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	void FlatSet<K, C, S>::Reserve(usize capacity) noexcept requires requires(S& storage, usize n) { storage.Reserve(n); }
+	{
+		m_keys.Reserve(capacity);
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	void FlatSet<K, C, S>::Clear() noexcept
+	{
+		m_keys.Clear();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Erase(ConstIterator it) noexcept -> Iterator
+	{
+		const usize idx = usize(it - m_keys.Data());
+		ASSERT(idx < m_keys.Size(), "Iterator out of range");
+		m_keys.Erase(m_keys.Data() + idx);
+		return m_keys.Data() + idx;
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Erase(const K& key) noexcept -> usize
+	{
+		ConstIterator it = Find(key);
+		if (it == End())
+			return 0;
+		Erase(it);
+		return 1;
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Find(const K& key) const noexcept -> ConstIterator
+	{
+		ConstIterator it = LowerBound(key);
+		return it != End() && m_comp(*it, key) == 0 ? it : End();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::LowerBound(const K& key) const noexcept -> ConstIterator
+	{
+		return Algo::LowerBound(Begin(), End(), key, m_comp);
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::UpperBound(const K& key) const noexcept -> ConstIterator
+	{
+		// An upper bound is a lower bound where equal keys are also ordered before the key
+		return Algo::LowerBound(Begin(), End(), key, [this](const K& elem, const K& val) noexcept -> i8 { return m_comp(elem, val) <= 0 ? -1 : 1; });
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Contains(const K& key) const noexcept -> bool
+	{
+		return Find(key) != End();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::operator[](usize idx) const noexcept -> const K&
+	{
+		return m_keys[idx];
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Size() const noexcept -> usize
+	{
+		return m_keys.Size();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Capacity() const noexcept -> usize
+	{
+		return m_keys.Capacity();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::IsEmpty() const noexcept -> bool
+	{
+		return m_keys.IsEmpty();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Data() const noexcept -> const K*
+	{
+		return m_keys.Data();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Front() const noexcept -> const K&
+	{
+		return m_keys.Front();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Back() const noexcept -> const K&
+	{
+		return m_keys.Back();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::Begin() const noexcept -> ConstIterator
+	{
+		return m_keys.Data();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::End() const noexcept -> ConstIterator
+	{
+		return m_keys.Data() + m_keys.Size();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::begin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::cbegin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::end() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	auto FlatSet<K, C, S>::cend() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename K, Comparator<K, K> C, typename S>
+	void FlatSet<K, C, S>::SortAndDedupe() noexcept
+	{
+		K* pBegin = m_keys.Data();
+		K* pEnd = pBegin + m_keys.Size();
+		Algo::Sort(pBegin, pEnd, m_comp);
+
+		const usize newSize = usize(Algo::Unique(pBegin, pEnd, m_comp) - pBegin);
+		while (m_keys.Size() > newSize)
+			m_keys.Pop();
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "core/MinInclude.h"
-#include "core/memory/MemRef.h"
+#include "core/memory/CompactMemRef.h"
+#include "core/allocator/ContainerAlloc.h"
 #include "core/allocator/GlobalAlloc.h"
 #include "core/utils/Utils.h"
 
@@ -29,11 +30,11 @@ namespace Onca
 		{
 			Node() : hash(0) {}
 
-			MemRef<Node> next; ///< Reference to next node in the bucket
-			u64          hash; ///< Hash of the key
-			Pair<K, V>   pair; ///< Key-value pair
+			CompactMemRef<Node> next; ///< Reference to next node in the bucket
+			u64                 hash; ///< Hash of the key
+			Pair<K, V>          pair; ///< Key-value pair
 		};
-		using NodeRef = MemRef<Node>;
+		using NodeRef = CompactMemRef<Node>;
 
 	public:
 
@@ -59,11 +60,12 @@ namespace Onca
 			auto operator!=(const Iterator & other) const noexcept -> bool;
 
 		private:
-			Iterator(const MemRef<NodeRef>& buckets, usize bucketIdx, const NodeRef& node) noexcept;
+			Iterator(const NodeRef* pBuckets, usize bucketCount, usize bucketIdx, const NodeRef& node) noexcept;
 
-			MemRef<NodeRef> m_buckets;
-			usize           m_bucketIdx;
-			NodeRef         m_node;
+			const NodeRef* m_pBuckets    = nullptr;
+			usize          m_bucketCount = 0;
+			usize          m_bucketIdx   = 0;
+			NodeRef        m_node;
 
 			friend class HashMap;
 		};
@@ -599,12 +601,13 @@ namespace Onca
 		 */
 		auto GetLastNode() const noexcept -> NodeRef;
 
-		MemRef<NodeRef>     m_buckets;       ///< Managed memory with buckets
-		usize               m_bucketCount;   ///< Number of buckets
-		usize               m_size;          ///< Number of elements
-		f32                 m_maxLoadFactor; ///< Maximum load factor
-		NO_UNIQUE_ADDRESS H m_hash;          ///< Hasher for keys
-		NO_UNIQUE_ADDRESS C m_comp;          ///< Comparator for keys
+		CompactMemRef<NodeRef> m_buckets;       ///< Managed memory with buckets
+		Alloc::ContainerAlloc  m_alloc;         ///< Allocator for the buckets and nodes
+		usize                  m_bucketCount;   ///< Number of buckets
+		usize                  m_size;          ///< Number of elements
+		f32                    m_maxLoadFactor; ///< Maximum load factor
+		NO_UNIQUE_ADDRESS H    m_hash;          ///< Hasher for keys
+		NO_UNIQUE_ADDRESS C    m_comp;          ///< Comparator for keys
 	};
 
 	template<Movable K, Movable V, Hasher<K> H, EqualsComparator<K> C>
@@ -25,19 +25,17 @@ namespace Onca
 			return *this;
 		}
 
-		NodeRef* pNodes = m_buckets.Ptr();
-		usize bucketCount = m_buckets.Size() / sizeof(NodeRef);
 		do
 		{
 			++m_bucketIdx;
-			if (m_bucketIdx >= bucketCount)
+			if (m_bucketIdx >= m_bucketCount)
 			{
 				m_node = nullptr;
 				return *this;
 			}
-			m_node = *(pNodes + m_bucketIdx);
+			m_node = *(m_pBuckets + m_bucketIdx);
 		}
-		while (!m_node && m_bucketIdx < bucketCount);
+		while (!m_node && m_bucketIdx < m_bucketCount);
 
 		return *this;
 	}
@@ -45,7 +43,7 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	auto HashMap<K, V, H, C, IsMultiMap>::Iterator::operator++(int) noexcept -> Iterator
 	{
-		Iterator tmp{ m_node };
+		Iterator tmp = *this;
 		operator++();
 		return tmp;
 	}
@@ -53,7 +51,7 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	auto HashMap<K, V, H, C, IsMultiMap>::Iterator::operator+(usize count) const noexcept -> Iterator
 	{
-		Iterator it{ m_buckets, m_bucketIdx, m_node };
+		Iterator it = *this;
 		for (usize i = 0; i < count; ++i)
 			++it;
 		return it;
@@ -80,8 +78,9 @@ namespace Onca
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
-	HashMap<K, V, H, C, IsMultiMap>::Iterator::Iterator(const MemRef<NodeRef>& buckets, usize bucketIdx, const NodeRef& node) noexcept
-		: m_buckets(buckets)
+	HashMap<K, V, H, C, IsMultiMap>::Iterator::Iterator(const NodeRef* pBuckets, usize bucketCount, usize bucketIdx, const NodeRef& node) noexcept
+		: m_pBuckets(pBuckets)
+		, m_bucketCount(bucketCount)
 		, m_bucketIdx(bucketIdx)
 		, m_node(node)
 	{
@@ -102,7 +101,8 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	HashMap<K, V, H, C, IsMultiMap>::HashMap(usize minBuckets, H hasher, C comp,
 		Alloc::IAllocator& alloc) noexcept
-		: m_buckets(&alloc)
+		: m_buckets()
+		, m_alloc(alloc)
 		, m_bucketCount(0)
 		, m_size(0)
 		, m_maxLoadFactor(1.0f)
@@ -130,7 +130,8 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	HashMap<K, V, H, C, IsMultiMap>::HashMap(const InitializerList<Pair<K, V>>& il, usize minBuckets, H hasher,	C comp, Alloc::IAllocator& alloc) noexcept
 		requires CopyConstructible<K> && CopyConstructible<V>
-		: m_buckets(&alloc)
+		: m_buckets()
+		, m_alloc(alloc)
 		, m_bucketCount(0)
 		, m_size(0)
 		, m_maxLoadFactor(1.0f)
@@ -164,7 +165,8 @@ namespace Onca
 	template <ForwardIterator It>
 	HashMap<K, V, H, C, IsMultiMap>::HashMap(const It& begin, const It& end, usize minBuckets, H hasher, C comp, Alloc::IAllocator& alloc) noexcept
 		requires CopyConstructible<K> && CopyConstructible<V>
-		: m_buckets(&alloc)
+		: m_buckets()
+		, m_alloc(alloc)
 		, m_bucketCount(0)
 		, m_size(0)
 		, m_maxLoadFactor(1.0f)
@@ -190,9 +192,10 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	HashMap<K, V, H, C, IsMultiMap>::HashMap(const HashMap& other, Alloc::IAllocator& alloc) noexcept requires
 		CopyConstructible<K> && CopyConstructible<V>
-		: m_buckets(&alloc)
-		, m_bucketCount(other.m_bucketCount)
-		, m_size(other.m_size)
+		: m_buckets()
+		, m_alloc(alloc)
+		, m_bucketCount(0)
+		, m_size(0)
 		, m_maxLoadFactor(other.m_maxLoadFactor)
 		, m_hash(other.m_hash)
 		, m_comp(other.m_comp)
@@ -205,6 +208,7 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	HashMap<K, V, H, C, IsMultiMap>::HashMap(HashMap&& other) noexcept
 		: m_buckets(Move(other.m_buckets))
+		, m_alloc(other.m_alloc)
 		, m_bucketCount(other.m_bucketCount)
 		, m_size(other.m_size)
 		, m_maxLoadFactor(other.m_maxLoadFactor)
@@ -217,16 +221,17 @@ namespace Onca
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	HashMap<K, V, H, C, IsMultiMap>::HashMap(HashMap&& other, Alloc::IAllocator& alloc) noexcept
-		: m_buckets(&alloc)
-		, m_bucketCount(other.m_bucketCount)
-		, m_size(other.m_size)
+		: m_buckets()
+		, m_alloc(alloc)
+		, m_bucketCount(0)
+		, m_size(0)
 		, m_maxLoadFactor(other.m_maxLoadFactor)
 		, m_hash(Move(other.m_hash))
 		, m_comp(Move(other.m_comp))
 	{
 		Rehash(other.BucketCount());
 		for (Iterator it = other.Begin(), end = other.End(); it != end; ++it)
-			Insert(StdMove(it.m_node->pair));
+			Insert(Move(it.m_node->pair));
 
 		other.ClearInternal<false>(true);
 	}
@@ -268,6 +273,7 @@ namespace Onca
 			ClearInternal<true>(true);
 
 			m_buckets = Move(other.m_buckets);
+			m_alloc = other.m_alloc;
 			m_bucketCount = other.m_bucketCount;
 			m_size = other.m_size;
 			m_maxLoadFactor = other.m_maxLoadFactor;
@@ -293,31 +299,33 @@ namespace Onca
 		if (m_bucketCount >= count)
 			return;
 
+		const usize oldCount = m_bucketCount;
 		m_bucketCount = 2;
 		while (m_bucketCount < count)
 			m_bucketCount <<= 1;
 
-		Alloc::IAllocator* pAlloc = m_buckets.GetAlloc();
-
-		Iterator it = Begin(); // Still valid after the move below
-		Iterator end;
-		MemRef<NodeRef> oldData = Move(m_buckets);
+		CompactMemRef<NodeRef> oldData = Move(m_buckets);
 
-		m_buckets = pAlloc->Allocate<NodeRef>(m_bucketCount * sizeof(NodeRef));
+		m_buckets = m_alloc.template Allocate<NodeRef>(m_bucketCount);
 		NodeRef* pBegin = m_buckets.Ptr();
 		for (usize i = 0; i < m_bucketCount; ++i)
 			new (pBegin + i) NodeRef{};
 
 		m_size = 0;
-		for (; it != end;)
+		NodeRef* pOldBegin = oldData.Ptr();
+		for (usize i = 0; i < oldCount; ++i)
 		{
-			Iterator cur = it;
-			++it;
-			cur.m_node->next = nullptr;
-			InsertNode<true>(cur.m_node);
+			NodeRef node = *(pOldBegin + i);
+			while (node)
+			{
+				NodeRef next = node->next;
+				node->next = nullptr;
+				InsertNode<true>(node);
+				node = next;
+			}
 		}
 
-		oldData.Dealloc();
+		m_alloc.Deallocate(Move(oldData), oldCount);
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
@@ -467,7 +475,6 @@ namespace Onca
 		ASSERT(it.m_node, "Invalid iterator");
 
 		Iterator nextIt = it + 1;
-		it.m_node->pair.~Pair();
 		RemoveNode(it.m_node);
 		return nextIt;
 	}
@@ -699,7 +706,7 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	auto HashMap<K, V, H, C, IsMultiMap>::GetAllocator() const noexcept -> Alloc::IAllocator*
 	{
-		return m_buckets.GetAlloc();
+		return m_alloc.Get();
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
@@ -732,7 +739,7 @@ namespace Onca
 		auto [idx, node] = GetFirstNode();
 		if (!node)
 			return Iterator{};
-		return Iterator{ m_buckets, idx, node };
+		return Iterator{ m_buckets.Ptr(), m_bucketCount, idx, node };
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
@@ -741,7 +748,7 @@ namespace Onca
 		auto [idx, node] = GetFirstNode();
 		if (!node)
 			return Iterator{};
-		return Iterator{ m_buckets, idx, node };
+		return Iterator{ m_buckets.Ptr(), m_bucketCount, idx, node };
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
@@ -795,12 +802,9 @@ namespace Onca
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
 	auto HashMap<K, V, H, C, IsMultiMap>::CreateNode(u64 hash, Pair<K, V>&& pair)  noexcept -> NodeRef
 	{
-		NodeRef node = m_buckets.GetAlloc()->template Allocate<Node>();
-		Node* pNode = node.Ptr();
-		new (pNode) Node{};
-		pNode->next = NodeRef{};
-		pNode->hash = hash; 
-		pNode->pair = Move(pair);
+		NodeRef node = m_alloc.template Create<Node>();
+		node->hash = hash;
+		node->pair = Move(pair);
 		return node;
 	}
 
@@ -820,7 +824,7 @@ namespace Onca
 		{
 			new (pBucket) NodeRef{ Move(node) };
 			++m_size;
-			return { Iterator{ m_buckets, bucketIdx, *pBucket }, true };
+			return { Iterator{ m_buckets.Ptr(), m_bucketCount, bucketIdx, *pBucket }, true };
 		}
 
 		if constexpr (IsMultiMap)
@@ -840,7 +844,7 @@ namespace Onca
 						node->next = Move(bucket->next);
 						bucket->next = Move(node);
 						++m_size;
-						return { Iterator{ m_buckets, bucketIdx, bucket }, true };
+						return { Iterator{ m_buckets.Ptr(), m_bucketCount, bucketIdx, bucket }, true };
 					}
 				}
 				else
@@ -855,11 +859,11 @@ namespace Onca
 
 			bucket->next = Move(node);
 			++m_size;
-			return { Iterator{ m_buckets, bucketIdx, bucket }, true };
+			return { Iterator{ m_buckets.Ptr(), m_bucketCount, bucketIdx, bucket }, true };
 		}
 		else
 		{
-			if (bucket->hash == hash && m_comp(node->pair.first, key))
+			if (bucket->hash == hash && m_comp(bucket->pair.first, key))
 			{
 				if constexpr (AllowOverride)
 				{
@@ -867,9 +871,13 @@ namespace Onca
 					new (pBucket) NodeRef{ Move(node) };
 
 					bucket->pair.~Pair();
-					bucket.Dealloc();
+					m_alloc.Deallocate(Move(bucket), 1);
 				}
-				return { Iterator{ m_buckets, bucketIdx, *pBucket }, false };
+				else
+				{
+					m_alloc.Destroy(Move(node));
+				}
+				return { Iterator{ m_buckets.Ptr(), m_bucketCount, bucketIdx, *pBucket }, false };
 			}
 
 			NodeRef next = bucket->next;
@@ -878,12 +886,9 @@ namespace Onca
 				if (next->hash == hash && m_comp(next->pair.first, key))
 				{
 					if constexpr (AllowOverride)
-					{
-						bucket->pair.~Pair();
-						bucket->pair = Move(node->pair);
-						node.Dealloc();
-					}
-					return { Iterator{ m_buckets, bucketIdx, bucket }, false };
+						next->pair = Move(node->pair);
+					m_alloc.Destroy(Move(node));
+					return { Iterator{ m_buckets.Ptr(), m_bucketCount, bucketIdx, next }, false };
 				}
 				bucket = next;
 				next = next->next;
@@ -891,7 +896,7 @@ namespace Onca
 
 			bucket->next = Move(node);
 			++m_size;
-			return { Iterator{ m_buckets, bucketIdx, bucket->next }, true };
+			return { Iterator{ m_buckets.Ptr(), m_bucketCount, bucketIdx, bucket->next }, true };
 		}
 	}
 
@@ -915,7 +920,8 @@ namespace Onca
 		}
 
 		node->pair.~Pair();
-		node.Dealloc();
+		m_alloc.Deallocate(Move(node), 1);
+		--m_size;
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
@@ -931,7 +937,7 @@ namespace Onca
 				NodeRef next = node->next;
 				if constexpr (Destruct)
 					node->pair.~Pair();
-				node.Dealloc();
+				m_alloc.Deallocate(Move(node), 1);
 				node = next;
 			}
 			new (pBuckets + i) NodeRef{};
@@ -939,7 +945,10 @@ namespace Onca
 		m_size = 0;
 
 		if (clearMemory)
-			m_buckets.Dealloc();
+		{
+			m_alloc.Deallocate(Move(m_buckets), m_bucketCount);
+			m_bucketCount = 0;
+		}
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
@@ -959,7 +968,7 @@ namespace Onca
 		while (node && (node->hash & mask) == bucketIdx)
 		{
 			if (node->hash == hash && m_comp(node->pair.first, key))
-				return Iterator{ m_buckets, bucketIdx, node };
+				return Iterator{ m_buckets.Ptr(), m_bucketCount, bucketIdx, node };
 			node = node->next;
 		}
 		return Iterator{};
@@ -1006,20 +1015,20 @@ namespace Onca
 				else
 				{
 					if (node->hash == hash && m_comp(node->pair.first, key))
-						startIt = Iterator{ m_buckets, node->hash & mask, node };
+						startIt = Iterator{ m_buckets.Ptr(), m_bucketCount, node->hash & mask, node };
 				}
 			}
 			else
 			{
 				if (node->hash == hash && m_comp(node->pair.first, key))
 				{
-					startIt = Iterator{ m_buckets, node->hash & mask, node };
+					startIt = Iterator{ m_buckets.Ptr(), m_bucketCount, node->hash & mask, node };
 					break;
 				}
 			}
 			node = node->next;
 		}
-		return Pair{ startIt, Iterator{ m_buckets, node->hash & mask, node } + 1 };
+		return Pair{ startIt, Iterator{ m_buckets.Ptr(), m_bucketCount, node->hash & mask, node } + 1 };
 	}
 
 	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C, bool IsMultiMap>
@@ -366,11 +366,12 @@ namespace Onca
 	{
 		const usize idx = usize(it - m_data);
 		ASSERT(idx <= m_size, "Iterator out of range");
-		ASSERT(count < m_size, "Cannot remove more elements than are in the InplaceDynArray");
+		ASSERT(count <= m_size - idx, "Cannot remove more elements than are in the InplaceDynArray");
 
-		const usize moveCount = m_size - idx - count;
-		if (moveCount)
-			Algo::Move(it + count, m_data + idx, moveCount);
+		for (usize i = idx, end = m_size - count; i < end; ++i)
+			m_data[i] = Move(m_data[i + count]);
+		for (usize i = m_size - count; i < m_size; ++i)
+			m_data[i].~T();
 		m_size -= count;
 	}
 
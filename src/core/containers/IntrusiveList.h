@@ -5,6 +5,8 @@ namespace Onca
 {
 	template<typename T>
 	class IntrusiveList;
+	template<typename T>
+	class MpscQueue;
 
 	/**
 	 * Node in a intrusive linked list
@@ -35,6 +37,7 @@ namespace Onca
 
 		friend class IntrusiveList<Owner>;
 		friend class IntrusiveList<Owner>::Iterator;
+		friend class MpscQueue<Owner>;
 	};
 
 
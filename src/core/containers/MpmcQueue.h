@@ -0,0 +1,103 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "core/memory/CompactMemRef.h"
+#include "core/allocator/ContainerAlloc.h"
+#include "core/utils/Atomic.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Bounded multi producer, multi consumer queue (lock-free)
+	 *
+	 * Implementation of Dmitry Vyukov's bounded MPMC queue: every cell stores a sequence number, which tells producers and consumers whether the cell is ready for them,
+	 * so claiming a cell only takes a single CAS on the enqueue or dequeue position, and the positions are never shared with the element data.
+	 *
+	 * \tparam T Stored type (needs to conform to Onca::Movable)
+	 */
+	template<typename T>
+	class MpmcQueue
+	{
+		STATIC_ASSERT(Movable<T>, "Type needs to be movable to be used in an MpmcQueue");
+	public:
+		/**
+		 * Create a queue
+		 * \param[in] capacity Minimum capacity of the queue, rounded up to a power of 2
+		 * \param[in] alloc Allocator to use
+		 */
+		explicit MpmcQueue(usize capacity, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		~MpmcQueue() noexcept;
+
+		DISABLE_COPY(MpmcQueue);
+		DISABLE_MOVE(MpmcQueue);
+
+		/**
+		 * Try to push an element into the queue
+		 * \param[in] val Element to push
+		 * \return Whether the element was pushed, false if the queue is full
+		 */
+		auto TryPush(const T& val) noexcept -> bool requires CopyConstructible<T>;
+		/**
+		 * Try to push an element into the queue
+		 * \param[in] val Element to push
+		 * \return Whether the element was pushed, false if the queue is full
+		 */
+		auto TryPush(T&& val) noexcept -> bool;
+		/**
+		 * Try to construct an element in place at the end of the queue
+		 * \tparam Args Types of the arguments
+		 * \param[in] args Arguments
+		 * \return Whether the element was pushed, false if the queue is full
+		 */
+		template<typename... Args>
+		auto TryEmplace(Args&&... args) noexcept -> bool;
+
+		/**
+		 * Try to pop the element at the front of the queue
+		 * \return Popped element, or nothing if the queue is empty
+		 */
+		auto TryPop() noexcept -> Optional<T>;
+
+		/**
+		 * Get the number of elements in the queue
+		 * \return Number of elements in the queue
+		 * \note The size is only an approximation when the queue is being used by other threads
+		 */
+		auto SizeApprox() const noexcept -> usize;
+		/**
+		 * Check if the queue is empty
+		 * \return Whether the queue is empty
+		 * \note The result is only an approximation when the queue is being used by other threads
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get the capacity of the queue
+		 * \return Capacity of the queue
+		 */
+		auto Capacity() const noexcept -> usize;
+
+		/**
+		 * Get the allocator used by the queue
+		 * \return Allocator used by the queue
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		/**
+		 * Cell in the queue
+		 */
+		struct Cell
+		{
+			Atomic<usize>       seq;                ///< Sequence number, equal to the position when the cell is free, or the position + 1 when it stores an element
+			alignas(T) u8       data[sizeof(T)];    ///< Element storage
+		};
+
+		Alloc::ContainerAlloc     m_alloc;          ///< Allocator
+		CompactMemRef<Cell>       m_cells;          ///< Cells
+		usize                     m_mask;           ///< Capacity - 1
+		alignas(64) Atomic<usize> m_enqueuePos;     ///< Position of the next element to push
+		alignas(64) Atomic<usize> m_dequeuePos;     ///< Position of the next element to pop
+	};
+}
+
+#include "MpmcQueue.inl"
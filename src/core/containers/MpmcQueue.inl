@@ -0,0 +1,135 @@
+#pragma once
+#if __RESHARPER__
+#include "MpmcQueue.h"
+#endif
+
+namespace Onca
+{
+	template <typename T>
+	MpmcQueue<T>::MpmcQueue(usize capacity, Alloc::IAllocator& alloc) noexcept
+		: m_alloc(alloc)
+		, m_mask(0)
+		, m_enqueuePos(0)
+		, m_dequeuePos(0)
+	{
+		capacity = Math::Max<usize>(capacity, 2);
+		if (!Math::IsPowOf2(capacity))
+			capacity = usize(1) << (Intrin::BitScanMSB(capacity) + 1);
+
+		m_cells = m_alloc.Allocate<Cell>(capacity);
+		ASSERT(m_cells, "Failed to allocate the cells of the queue");
+		m_mask = capacity - 1;
+
+		Cell* pCells = m_cells.Ptr();
+		for (usize i = 0; i < capacity; ++i)
+			new (&pCells[i].seq) Atomic<usize>{ i };
+	}
+
+	template <typename T>
+	MpmcQueue<T>::~MpmcQueue() noexcept
+	{
+		while (TryPop());
+		m_alloc.Deallocate(Move(m_cells), m_mask + 1);
+	}
+
+	template <typename T>
+	auto MpmcQueue<T>::TryPush(const T& val) noexcept -> bool requires CopyConstructible<T>
+	{
+		return TryEmplace(val);
+	}
+
+	template <typename T>
+	auto MpmcQueue<T>::TryPush(T&& val) noexcept -> bool
+	{
+		return TryEmplace(Move(val));
+	}
+
+	template <typename T>
+	template <typename ... Args>
+	auto MpmcQueue<T>::TryEmplace(Args&&... args) noexcept -> bool
+	{
+		Cell* pCell;
+		usize pos = m_enqueuePos.Load(MemOrder::Relaxed);
+		while (true)
+		{
+			pCell = m_cells.Ptr() + (pos & m_mask);
+			const usize seq = pCell->seq.Load(MemOrder::Acquire);
+			const isize diff = isize(seq) - isize(pos);
+			if (diff == 0)
+			{
+				if (m_enqueuePos.CompareExchangeWeak(pos, pos + 1, MemOrder::Relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_enqueuePos.Load(MemOrder::Relaxed);
+			}
+		}
+
+		new (pCell->data) T{ Forward<Args>(args)... };
+		pCell->seq.Store(pos + 1, MemOrder::Release);
+		return true;
+	}
+
+	template <typename T>
+	auto MpmcQueue<T>::TryPop() noexcept -> Optional<T>
+	{
+		Cell* pCell;
+		usize pos = m_dequeuePos.Load(MemOrder::Relaxed);
+		while (true)
+		{
+			pCell = m_cells.Ptr() + (pos & m_mask);
+			const usize seq = pCell->seq.Load(MemOrder::Acquire);
+			const isize diff = isize(seq) - isize(pos + 1);
+			if (diff == 0)
+			{
+				if (m_dequeuePos.CompareExchangeWeak(pos, pos + 1, MemOrder::Relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				return NullOpt;
+			}
+			else
+			{
+				pos = m_dequeuePos.Load(MemOrder::Relaxed);
+			}
+		}
+
+		T* pVal = reinterpret_cast<T*>(pCell->data);
+		Optional<T> val{ Move(*pVal) };
+		pVal->~T();
+		pCell->seq.Store(pos + m_mask + 1, MemOrder::Release);
+		return val;
+	}
+
+	template <typename T>
+	auto MpmcQueue<T>::SizeApprox() const noexcept -> usize
+	{
+		const usize dequeuePos = m_dequeuePos.Load(MemOrder::Relaxed);
+		const usize enqueuePos = m_enqueuePos.Load(MemOrder::Relaxed);
+		return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+	}
+
+	template <typename T>
+	auto MpmcQueue<T>::IsEmpty() const noexcept -> bool
+	{
+		return SizeApprox() == 0;
+	}
+
+	template <typename T>
+	auto MpmcQueue<T>::Capacity() const noexcept -> usize
+	{
+		return m_mask + 1;
+	}
+
+	template <typename T>
+	auto MpmcQueue<T>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_alloc.Get();
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/utils/Atomic.h"
+#include "IntrusiveList.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Unbounded multi producer, single consumer intrusive queue (lock-free)
+	 *
+	 * Implementation of Dmitry Vyukov's intrusive MPSC queue: pushing only takes a single atomic exchange, and popping does not need any atomic read-modify-write operations.
+	 * Elements are linked using the same nodes as Onca::IntrusiveList, so the queue never allocates, and an element can be moved between a list and the queue.
+	 *
+	 * \tparam T Underlying type
+	 * \note Only a single thread may pop at any time, and a pushed element needs to stay alive and in place until it is popped
+	 * \note A pop may fail while a producer is in the middle of a push, even when other elements were pushed before it
+	 */
+	template<typename T>
+	class MpscQueue
+	{
+	public:
+		using Node = IntrusiveListNode<T>;
+
+		MpscQueue() noexcept;
+
+		DISABLE_COPY(MpscQueue);
+		DISABLE_MOVE(MpscQueue);
+
+		/**
+		 * Push an element into the queue
+		 * \param[in] node Node of the element to push
+		 */
+		void Push(Node& node) noexcept;
+		/**
+		 * Try to pop the element at the front of the queue (consumer only)
+		 * \return Popped element, or nullptr if the queue is empty
+		 */
+		auto TryPop() noexcept -> T*;
+
+		/**
+		 * Check if the queue is empty (consumer only)
+		 * \return Whether the queue is empty
+		 * \note Elements that are in the middle of being pushed are not seen by this check
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+	private:
+		/**
+		 * Atomically load the next node of a node
+		 * \param[in] pNode Node
+		 * \return Next node
+		 */
+		static auto LoadNext(Node* pNode) noexcept -> Node*;
+		/**
+		 * Atomically store the next node of a node
+		 * \param[in] pNode Node
+		 * \param[in] pNext Next node
+		 */
+		static void StoreNext(Node* pNode, Node* pNext) noexcept;
+
+		alignas(64) Atomic<Node*> m_pHead; ///< Last pushed node, written by the producers
+		alignas(64) Node*         m_pTail; ///< Next node to pop, only accessed by the consumer
+		Node                      m_stub;  ///< Stub node, keeping the queue linked when it is empty
+	};
+}
+
+#include "MpscQueue.inl"
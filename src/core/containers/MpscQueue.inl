@@ -0,0 +1,77 @@
+#pragma once
+#if __RESHARPER__
+#include "MpscQueue.h"
+#endif
+
+namespace Onca
+{
+	template <typename T>
+	MpscQueue<T>::MpscQueue() noexcept
+		: m_pHead(&m_stub)
+		, m_pTail(&m_stub)
+		, m_stub(0)
+	{
+	}
+
+	template <typename T>
+	void MpscQueue<T>::Push(Node& node) noexcept
+	{
+		StoreNext(&node, nullptr);
+		Node* pPrev = m_pHead.Exchange(&node, MemOrder::AcqRel);
+		// Between the exchange and this store, the node is not reachable from the tail, which is why a pop can fail while a push is in progress
+		StoreNext(pPrev, &node);
+	}
+
+	template <typename T>
+	auto MpscQueue<T>::TryPop() noexcept -> T*
+	{
+		Node* pTail = m_pTail;
+		Node* pNext = LoadNext(pTail);
+
+		if (pTail == &m_stub)
+		{
+			if (!pNext)
+				return nullptr;
+			m_pTail = pNext;
+			pTail = pNext;
+			pNext = LoadNext(pNext);
+		}
+
+		if (pNext)
+		{
+			m_pTail = pNext;
+			return pTail->Get();
+		}
+
+		// The tail is the last node, so it can only be popped after the stub is pushed behind it
+		if (pTail != m_pHead.Load(MemOrder::Acquire))
+			return nullptr;
+
+		Push(m_stub);
+		pNext = LoadNext(pTail);
+		if (pNext)
+		{
+			m_pTail = pNext;
+			return pTail->Get();
+		}
+		return nullptr;
+	}
+
+	template <typename T>
+	auto MpscQueue<T>::IsEmpty() const noexcept -> bool
+	{
+		return m_pTail == &m_stub && !LoadNext(const_cast<Node*>(&m_stub));
+	}
+
+	template <typename T>
+	auto MpscQueue<T>::LoadNext(Node* pNode) noexcept -> Node*
+	{
+		return AtomicRef<Node*>{ pNode->m_pNext }.Load(MemOrder::Acquire);
+	}
+
+	template <typename T>
+	void MpscQueue<T>::StoreNext(Node* pNode, Node* pNext) noexcept
+	{
+		AtomicRef<Node*>{ pNode->m_pNext }.Store(pNext, MemOrder::Release);
+	}
+}
@@ -0,0 +1,320 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "core/allocator/ContainerAlloc.h"
+#include "core/intrin/BitIntrin.h"
+#include "core/memory/CompactRefCounted.h"
+#include "core/utils/Pair.h"
+
+namespace Onca
+{
+	template<typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	class TransientPHashMap;
+
+	/**
+	 * \brief A persistent (immutable) hash map, implemented as a hash array mapped trie
+	 *
+	 * Every level of the trie uses 5 bits of the hash to select 1 of 32 slots. A node stores a bitmap of slots containing an entry and a bitmap of slots containing a child node,
+	 * followed by the entries and children packed next to each other, so a node only takes up memory for the slots that are used.
+	 * Keys whose hashes are completely equal end up in a collision node at the bottom of the trie.
+	 *
+	 * Modifying a PHashMap returns a new PHashMap and leaves the original untouched. Only the nodes on the path to the modified entry are copied,
+	 * all other nodes are shared between both maps, so an update is O(log32 n) and copying a PHashMap is O(1).
+	 * Nodes are reference counted atomically, so a copy of a PHashMap can be handed to other threads as a consistent snapshot.
+	 *
+	 * When a lot of modifications are made at once, use a TransientPHashMap, which modifies nodes it owns in place instead of copying them.
+	 *
+	 * \tparam K Key type (needs to conform to Onca::CopyConstructible)
+	 * \tparam V Value type (needs to conform to Onca::CopyConstructible)
+	 * \tparam H Hasher type
+	 * \tparam C Comparator type
+	 */
+	template<typename K, typename V, Hasher<K> H = Hash<K>, EqualsComparator<K> C = DefaultEqualComparator<K>>
+	class PHashMap
+	{
+		STATIC_ASSERT(CopyConstructible<K>, "Key type needs to be copy constructible to be used in a PHashMap");
+		STATIC_ASSERT(CopyConstructible<V>, "Value type needs to be copy constructible to be used in a PHashMap");
+	public:
+		using Entry = Pair<K, V>;
+
+		/**
+		 * Create an empty PHashMap
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit PHashMap(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create a PHashMap that shares all nodes with another PHashMap
+		 * \param[in] other PHashMap to share with
+		 */
+		PHashMap(const PHashMap& other) noexcept;
+		PHashMap(PHashMap&& other) noexcept;
+		~PHashMap() noexcept;
+
+		auto operator=(const PHashMap& other) noexcept -> PHashMap&;
+		auto operator=(PHashMap&& other) noexcept -> PHashMap&;
+
+		/**
+		 * Create a PHashMap with an entry inserted, or with the value of the entry replaced when the key is already in the map
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return PHashMap with the entry
+		 */
+		auto Insert(const K& key, const V& val) const noexcept -> PHashMap;
+		/**
+		 * Create a PHashMap with an entry inserted, or with the value of the entry replaced when the key is already in the map
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return PHashMap with the entry
+		 */
+		auto Insert(K&& key, V&& val) const noexcept -> PHashMap;
+		/**
+		 * Create a PHashMap with an entry removed
+		 * \param[in] key Key of the entry
+		 * \return PHashMap without the entry, or a PHashMap sharing all nodes with this one when the key is not in the map
+		 */
+		auto Erase(const K& key) const noexcept -> PHashMap;
+
+		/**
+		 * Create a transient map that starts out sharing all nodes with this PHashMap
+		 * \return Transient map
+		 */
+		auto AsTransient() const noexcept -> TransientPHashMap<K, V, H, C>;
+
+		/**
+		 * Find the value of an entry
+		 * \param[in] key Key of the entry
+		 * \return Pointer to the value, or nullptr when the key is not in the map
+		 */
+		auto Find(const K& key) const noexcept -> const V*;
+		/**
+		 * Check if the map contains a key
+		 * \param[in] key Key
+		 * \return Whether the map contains the key
+		 */
+		auto Contains(const K& key) const noexcept -> bool;
+
+		/**
+		 * Call a function for each entry in the map, in no particular order
+		 * \tparam F Function type
+		 * \param[in] fun Function
+		 */
+		template<Callable<void, const K&, const V&> F>
+		void ForEach(F fun) const noexcept;
+
+		/**
+		 * Get the number of entries in the map
+		 * \return Number of entries in the map
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the map is empty
+		 * \return Whether the map is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Check if 2 PHashMaps share the same nodes, which means they are equal without comparing any entries
+		 * \param[in] other PHashMap to check
+		 * \return Whether both PHashMaps share the same nodes
+		 */
+		auto IsSharedWith(const PHashMap& other) const noexcept -> bool;
+
+		/**
+		 * Get the allocator used by the PHashMap
+		 * \return Allocator used by the PHashMap
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		friend class TransientPHashMap<K, V, H, C>;
+
+		static constexpr u32 BranchBits = 5;                                                 ///< Number of bits of the hash used per level of the trie
+		static constexpr u32 BranchMask = (1u << BranchBits) - 1;                            ///< Mask for the slot in a node
+		static constexpr u32 CollisionShift = (64 + BranchBits - 1) / BranchBits * BranchBits; ///< Shift of the level at which all hash bits are used up
+
+		/**
+		 * Node header, followed by the entries and child pointers
+		 * \note For collision nodes, 'dataMap' stores the number of entries instead
+		 */
+		struct Node
+		{
+			Detail::AtomicRefCount refs;    ///< Number of references to the node
+			u32                    dataMap; ///< Bitmap of slots containing an entry
+			u32                    nodeMap; ///< Bitmap of slots containing a child node
+		};
+
+		static constexpr usize EntriesOffset = (sizeof(Node) + alignof(Entry) - 1) & ~(alignof(Entry) - 1);             ///< Offset of the entries in a node
+		static constexpr u16   NodeAlign = u16(alignof(Entry) > alignof(Node*) ? alignof(Entry) : alignof(Node*)); ///< Alignment of a node
+
+		static auto ChildrenOffset(u32 numEntries) noexcept -> usize;
+		static auto NodeSize(u32 numEntries, u32 numChildren) noexcept -> usize;
+		static auto NumEntries(const Node* pNode, u32 shift) noexcept -> u32;
+		static auto NumChildren(const Node* pNode) noexcept -> u32;
+		static auto Entries(Node* pNode) noexcept -> Entry*;
+		static auto Children(Node* pNode, u32 numEntries) noexcept -> Node**;
+		static auto IsUnique(const Node* pNode) noexcept -> bool;
+		static auto SlotBit(u64 hash, u32 shift) noexcept -> u32;
+		static auto SlotIndex(u32 map, u32 bit) noexcept -> u32;
+
+		/**
+		 * Allocate a node, without constructing its entries or children
+		 * \param[in] dataMap Bitmap of slots containing an entry, or the number of entries for a collision node
+		 * \param[in] nodeMap Bitmap of slots containing a child node
+		 * \param[in] numEntries Number of entries
+		 * \param[in] numChildren Number of children
+		 * \return Allocated node
+		 */
+		auto AllocateNode(u32 dataMap, u32 nodeMap, u32 numEntries, u32 numChildren) noexcept -> Node*;
+		/**
+		 * Deallocate the memory of a node, without touching its entries or children
+		 * \param[in] pNode Node
+		 * \param[in] shift Shift of the level of the node
+		 */
+		void DeallocateNode(Node* pNode, u32 shift) noexcept;
+		/**
+		 * Drop a reference to a node, destroying it and dropping the references to its children when it was the last reference
+		 * \param[in] pNode Node, may be null
+		 * \param[in] shift Shift of the level of the node
+		 */
+		void Release(Node* pNode, u32 shift) noexcept;
+		/**
+		 * Make sure a node is only referenced by this map, copying it when it is shared
+		 * \param[in,out] pNode Node, replaced by its copy if it was shared
+		 * \param[in] shift Shift of the level of the node
+		 */
+		void MakeUnique(Node*& pNode, u32 shift) noexcept;
+		/**
+		 * Create a node with different slots from an existing node, the existing node is moved from when unique, or copied from when shared, and is released afterwards
+		 * \param[in] pSrc Existing node
+		 * \param[in] shift Shift of the level of the node
+		 * \param[in] dataMap Bitmap of slots containing an entry in the new node
+		 * \param[in] nodeMap Bitmap of slots containing a child node in the new node
+		 * \param[in] bit Slot that changed
+		 * \param[in] pEntry Entry to put in the changed slot, or nullptr if it does not contain a new entry
+		 * \param[in] pChild Child to put in the changed slot, or nullptr if it does not contain a new child
+		 * \return New node
+		 */
+		auto Rebuild(Node* pSrc, u32 shift, u32 dataMap, u32 nodeMap, u32 bit, Entry* pEntry, Node* pChild) noexcept -> Node*;
+		/**
+		 * Create a collision node with an entry removed and/or appended, the existing node is moved from when unique, or copied from when shared, and is released afterwards
+		 * \param[in] pSrc Existing collision node
+		 * \param[in] skipIdx Index of the entry to remove, or ~0u to keep all entries
+		 * \param[in] pEntry Entry to append, or nullptr
+		 * \return New node
+		 */
+		auto RebuildCollision(Node* pSrc, u32 skipIdx, Entry* pEntry) noexcept -> Node*;
+		/**
+		 * Create a subtree containing 2 entries whose hashes are equal up to a level
+		 * \param[in] a First entry
+		 * \param[in] hashA Hash of the first entry
+		 * \param[in] b Second entry
+		 * \param[in] hashB Hash of the second entry
+		 * \param[in] shift Shift of the level of the subtree
+		 * \return Root of the subtree
+		 */
+		auto MergeEntries(Entry&& a, u64 hashA, Entry&& b, u64 hashB, u32 shift) noexcept -> Node*;
+
+		// Modifications in place, nodes that are shared are copied before they are modified
+		auto InsertInPlace(K&& key, V&& val) noexcept -> bool;
+		auto InsertInPlace(Node*& pNode, u32 shift, u64 hash, K&& key, V&& val) noexcept -> bool;
+		auto EraseInPlace(const K& key) noexcept -> bool;
+		auto EraseInPlace(Node*& pNode, u32 shift, u64 hash, const K& key) noexcept -> bool;
+
+		template<typename F>
+		static void ForEachImpl(Node* pNode, u32 shift, F& fun) noexcept;
+
+		Alloc::ContainerAlloc m_alloc; ///< Allocator
+		Node*                 m_pRoot; ///< Root node, null when the map is empty
+		usize                 m_size;  ///< Number of entries
+	};
+
+	/**
+	 * \brief A mutable view of a PHashMap for batches of modifications
+	 *
+	 * A transient map modifies the nodes it does not share with any PHashMap in place, so after the first modification to a path,
+	 * further modifications on the same path don't copy anymore. Nodes that are still shared are copied, like a PHashMap would.
+	 * When done, the transient map is turned back into a PHashMap in O(1).
+	 *
+	 * \tparam K Key type (needs to conform to Onca::CopyConstructible)
+	 * \tparam V Value type (needs to conform to Onca::CopyConstructible)
+	 * \tparam H Hasher type
+	 * \tparam C Comparator type
+	 */
+	template<typename K, typename V, Hasher<K> H = Hash<K>, EqualsComparator<K> C = DefaultEqualComparator<K>>
+	class TransientPHashMap
+	{
+	public:
+		/**
+		 * Create an empty TransientPHashMap
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit TransientPHashMap(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		TransientPHashMap(TransientPHashMap&& other) noexcept = default;
+
+		auto operator=(TransientPHashMap&& other) noexcept -> TransientPHashMap& = default;
+
+		DISABLE_COPY(TransientPHashMap);
+
+		/**
+		 * Insert an entry, or replace the value of the entry when the key is already in the map
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return Whether a new entry was inserted
+		 */
+		auto Insert(const K& key, const V& val) noexcept -> bool;
+		/**
+		 * Insert an entry, or replace the value of the entry when the key is already in the map
+		 * \param[in] key Key
+		 * \param[in] val Value
+		 * \return Whether a new entry was inserted
+		 */
+		auto Insert(K&& key, V&& val) noexcept -> bool;
+		/**
+		 * Erase an entry
+		 * \param[in] key Key of the entry
+		 * \return Whether an entry was erased
+		 */
+		auto Erase(const K& key) noexcept -> bool;
+
+		/**
+		 * Turn the transient map into a PHashMap, the transient map is empty afterwards
+		 * \return PHashMap with the contents of the transient map
+		 */
+		auto Persistent() noexcept -> PHashMap<K, V, H, C>;
+
+		/**
+		 * Find the value of an entry
+		 * \param[in] key Key of the entry
+		 * \return Pointer to the value, or nullptr when the key is not in the map
+		 */
+		auto Find(const K& key) const noexcept -> const V*;
+		/**
+		 * Check if the map contains a key
+		 * \param[in] key Key
+		 * \return Whether the map contains the key
+		 */
+		auto Contains(const K& key) const noexcept -> bool;
+		/**
+		 * Get the number of entries in the map
+		 * \return Number of entries in the map
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the map is empty
+		 * \return Whether the map is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+	private:
+		friend class PHashMap<K, V, H, C>;
+
+		/**
+		 * Create a TransientPHashMap that starts out sharing all nodes with a PHashMap
+		 * \param[in] map PHashMap
+		 */
+		explicit TransientPHashMap(const PHashMap<K, V, H, C>& map) noexcept;
+
+		PHashMap<K, V, H, C> m_map; ///< Map that is modified in place
+	};
+}
+
+#include "PHashMap.inl"
@@ -0,0 +1,618 @@
+#pragma once
+#if __RESHARPER__
+#include "PHashMap.h"
+#endif
+
+namespace Onca
+{
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	PHashMap<K, V, H, C>::PHashMap(Alloc::IAllocator& alloc) noexcept
+		: m_alloc(alloc)
+		, m_pRoot(nullptr)
+		, m_size(0)
+	{
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	PHashMap<K, V, H, C>::PHashMap(const PHashMap& other) noexcept
+		: m_alloc(other.m_alloc)
+		, m_pRoot(other.m_pRoot)
+		, m_size(other.m_size)
+	{
+		if (m_pRoot)
+			m_pRoot->refs.Inc();
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	PHashMap<K, V, H, C>::PHashMap(PHashMap&& other) noexcept
+		: m_alloc(other.m_alloc)
+		, m_pRoot(other.m_pRoot)
+		, m_size(other.m_size)
+	{
+		other.m_pRoot = nullptr;
+		other.m_size = 0;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	PHashMap<K, V, H, C>::~PHashMap() noexcept
+	{
+		Release(m_pRoot, 0);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::operator=(const PHashMap& other) noexcept -> PHashMap&
+	{
+		if (this != &other)
+		{
+			PHashMap copy{ other };
+			*this = Move(copy);
+		}
+		return *this;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::operator=(PHashMap&& other) noexcept -> PHashMap&
+	{
+		if (this != &other)
+		{
+			Release(m_pRoot, 0);
+
+			m_alloc = other.m_alloc;
+			m_pRoot = other.m_pRoot;
+			m_size = other.m_size;
+
+			other.m_pRoot = nullptr;
+			other.m_size = 0;
+		}
+		return *this;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Insert(const K& key, const V& val) const noexcept -> PHashMap
+	{
+		return Insert(K{ key }, V{ val });
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Insert(K&& key, V&& val) const noexcept -> PHashMap
+	{
+		// The copy shares all nodes with this map, so modifying it in place copies the path to the entry
+		PHashMap res{ *this };
+		res.InsertInPlace(Move(key), Move(val));
+		return res;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Erase(const K& key) const noexcept -> PHashMap
+	{
+		PHashMap res{ *this };
+		res.EraseInPlace(key);
+		return res;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::AsTransient() const noexcept -> TransientPHashMap<K, V, H, C>
+	{
+		return TransientPHashMap<K, V, H, C>{ *this };
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Find(const K& key) const noexcept -> const V*
+	{
+		const u64 hash = H{}(key);
+		Node* pNode = m_pRoot;
+		for (u32 shift = 0; pNode; shift += BranchBits)
+		{
+			if (shift >= CollisionShift)
+			{
+				Entry* pEntries = Entries(pNode);
+				for (u32 i = 0; i < pNode->dataMap; ++i)
+				{
+					if (C{}(pEntries[i].first, key))
+						return &pEntries[i].second;
+				}
+				return nullptr;
+			}
+
+			const u32 bit = SlotBit(hash, shift);
+			if (pNode->dataMap & bit)
+			{
+				const Entry& entry = Entries(pNode)[SlotIndex(pNode->dataMap, bit)];
+				return C{}(entry.first, key) ? &entry.second : nullptr;
+			}
+			if (!(pNode->nodeMap & bit))
+				return nullptr;
+			pNode = Children(pNode, Intrin::PopCnt(pNode->dataMap))[SlotIndex(pNode->nodeMap, bit)];
+		}
+		return nullptr;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Contains(const K& key) const noexcept -> bool
+	{
+		return Find(key) != nullptr;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	template <Callable<void, const K&, const V&> F>
+	void PHashMap<K, V, H, C>::ForEach(F fun) const noexcept
+	{
+		if (m_pRoot)
+			ForEachImpl(m_pRoot, 0, fun);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Size() const noexcept -> usize
+	{
+		return m_size;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::IsEmpty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::IsSharedWith(const PHashMap& other) const noexcept -> bool
+	{
+		return m_pRoot == other.m_pRoot;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_alloc.Get();
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::ChildrenOffset(u32 numEntries) noexcept -> usize
+	{
+		return (EntriesOffset + numEntries * sizeof(Entry) + alignof(Node*) - 1) & ~(alignof(Node*) - 1);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::NodeSize(u32 numEntries, u32 numChildren) noexcept -> usize
+	{
+		return ChildrenOffset(numEntries) + numChildren * sizeof(Node*);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::NumEntries(const Node* pNode, u32 shift) noexcept -> u32
+	{
+		return shift >= CollisionShift ? pNode->dataMap : Intrin::PopCnt(pNode->dataMap);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::NumChildren(const Node* pNode) noexcept -> u32
+	{
+		return Intrin::PopCnt(pNode->nodeMap);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Entries(Node* pNode) noexcept -> Entry*
+	{
+		return reinterpret_cast<Entry*>(reinterpret_cast<u8*>(pNode) + EntriesOffset);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Children(Node* pNode, u32 numEntries) noexcept -> Node**
+	{
+		return reinterpret_cast<Node**>(reinterpret_cast<u8*>(pNode) + ChildrenOffset(numEntries));
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::IsUnique(const Node* pNode) noexcept -> bool
+	{
+		// Acquire makes sure that reads by other threads that dropped their reference happen before the node is modified
+		return pNode->refs.count.Load(MemOrder::Acquire) == 1;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::SlotBit(u64 hash, u32 shift) noexcept -> u32
+	{
+		return 1u << u32((hash >> shift) & BranchMask);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::SlotIndex(u32 map, u32 bit) noexcept -> u32
+	{
+		return Intrin::PopCnt(map & (bit - 1));
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::AllocateNode(u32 dataMap, u32 nodeMap, u32 numEntries, u32 numChildren) noexcept -> Node*
+	{
+		CompactMemRef<u8> mem = m_alloc.Allocate<u8>(NodeSize(numEntries, numChildren), NodeAlign);
+		ASSERT(mem, "Failed to allocate a PHashMap node");
+		return new (mem.Ptr()) Node{ Detail::AtomicRefCount{ 1 }, dataMap, nodeMap };
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	void PHashMap<K, V, H, C>::DeallocateNode(Node* pNode, u32 shift) noexcept
+	{
+		const usize size = NodeSize(NumEntries(pNode, shift), NumChildren(pNode));
+		pNode->~Node();
+		m_alloc.Deallocate(CompactMemRef<u8>{ reinterpret_cast<u8*>(pNode) }, size, NodeAlign);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	void PHashMap<K, V, H, C>::Release(Node* pNode, u32 shift) noexcept
+	{
+		if (!pNode || !pNode->refs.Dec())
+			return;
+
+		const u32 numEntries = NumEntries(pNode, shift);
+		Entry* pEntries = Entries(pNode);
+		for (u32 i = 0; i < numEntries; ++i)
+			pEntries[i].~Entry();
+
+		const u32 numChildren = NumChildren(pNode);
+		Node** ppChildren = Children(pNode, numEntries);
+		for (u32 i = 0; i < numChildren; ++i)
+			Release(ppChildren[i], shift + BranchBits);
+
+		DeallocateNode(pNode, shift);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	void PHashMap<K, V, H, C>::MakeUnique(Node*& pNode, u32 shift) noexcept
+	{
+		if (IsUnique(pNode))
+			return;
+
+		const u32 numEntries = NumEntries(pNode, shift);
+		const u32 numChildren = NumChildren(pNode);
+		Node* pCopy = AllocateNode(pNode->dataMap, pNode->nodeMap, numEntries, numChildren);
+
+		Entry* pSrcEntries = Entries(pNode);
+		Entry* pDstEntries = Entries(pCopy);
+		for (u32 i = 0; i < numEntries; ++i)
+			new (pDstEntries + i) Entry{ pSrcEntries[i] };
+
+		Node** ppSrcChildren = Children(pNode, numEntries);
+		Node** ppDstChildren = Children(pCopy, numEntries);
+		for (u32 i = 0; i < numChildren; ++i)
+		{
+			ppSrcChildren[i]->refs.Inc();
+			ppDstChildren[i] = ppSrcChildren[i];
+		}
+
+		// Children have a reference from the copy now, so releasing the original never releases them
+		Release(pNode, shift);
+		pNode = pCopy;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::Rebuild(Node* pSrc, u32 shift, u32 dataMap, u32 nodeMap, u32 bit, Entry* pEntry, Node* pChild) noexcept -> Node*
+	{
+		const bool unique = IsUnique(pSrc);
+		const u32 srcNumEntries = Intrin::PopCnt(pSrc->dataMap);
+		Entry* pSrcEntries = Entries(pSrc);
+		Node** ppSrcChildren = Children(pSrc, srcNumEntries);
+
+		const u32 numEntries = Intrin::PopCnt(dataMap);
+		Node* pDst = AllocateNode(dataMap, nodeMap, numEntries, Intrin::PopCnt(nodeMap));
+		Entry* pDstEntries = Entries(pDst);
+		Node** ppDstChildren = Children(pDst, numEntries);
+
+		// Iterate over the set bits of the new maps, taking each slot from the source node unless it is the changed slot
+		u32 idx = 0;
+		for (u32 map = dataMap; map; map &= map - 1, ++idx)
+		{
+			const u32 slot = map & (~map + 1);
+			if (slot == bit && pEntry)
+				new (pDstEntries + idx) Entry{ Move(*pEntry) };
+			else if (unique)
+				new (pDstEntries + idx) Entry{ Move(pSrcEntries[SlotIndex(pSrc->dataMap, slot)]) };
+			else
+				new (pDstEntries + idx) Entry{ pSrcEntries[SlotIndex(pSrc->dataMap, slot)] };
+		}
+
+		idx = 0;
+		for (u32 map = nodeMap; map; map &= map - 1, ++idx)
+		{
+			const u32 slot = map & (~map + 1);
+			if (slot == bit && pChild)
+			{
+				ppDstChildren[idx] = pChild;
+			}
+			else
+			{
+				Node* pSrcChild = ppSrcChildren[SlotIndex(pSrc->nodeMap, slot)];
+				if (!unique)
+					pSrcChild->refs.Inc();
+				ppDstChildren[idx] = pSrcChild;
+			}
+		}
+
+		if (!unique)
+		{
+			Release(pSrc, shift);
+			return pDst;
+		}
+
+		// Children of the unique source that did not move to the new node are dropped
+		const u32 keptMap = nodeMap & ~(pChild ? bit : 0);
+		for (u32 map = pSrc->nodeMap & ~keptMap; map; map &= map - 1)
+			Release(ppSrcChildren[SlotIndex(pSrc->nodeMap, map & (~map + 1))], shift + BranchBits);
+		for (u32 i = 0; i < srcNumEntries; ++i)
+			pSrcEntries[i].~Entry();
+		DeallocateNode(pSrc, shift);
+		return pDst;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::RebuildCollision(Node* pSrc, u32 skipIdx, Entry* pEntry) noexcept -> Node*
+	{
+		const bool unique = IsUnique(pSrc);
+		const u32 srcCount = pSrc->dataMap;
+		const u32 count = srcCount - (skipIdx < srcCount ? 1 : 0) + (pEntry ? 1 : 0);
+		Node* pDst = AllocateNode(count, 0, count, 0);
+
+		Entry* pSrcEntries = Entries(pSrc);
+		Entry* pDstEntries = Entries(pDst);
+		u32 idx = 0;
+		for (u32 i = 0; i < srcCount; ++i)
+		{
+			if (i == skipIdx)
+				continue;
+			if (unique)
+				new (pDstEntries + idx++) Entry{ Move(pSrcEntries[i]) };
+			else
+				new (pDstEntries + idx++) Entry{ pSrcEntries[i] };
+		}
+		if (pEntry)
+			new (pDstEntries + idx) Entry{ Move(*pEntry) };
+
+		if (!unique)
+		{
+			Release(pSrc, CollisionShift);
+			return pDst;
+		}
+
+		for (u32 i = 0; i < srcCount; ++i)
+			pSrcEntries[i].~Entry();
+		DeallocateNode(pSrc, CollisionShift);
+		return pDst;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::MergeEntries(Entry&& a, u64 hashA, Entry&& b, u64 hashB, u32 shift) noexcept -> Node*
+	{
+		if (shift >= CollisionShift)
+		{
+			Node* pNode = AllocateNode(2, 0, 2, 0);
+			new (Entries(pNode)) Entry{ Move(a) };
+			new (Entries(pNode) + 1) Entry{ Move(b) };
+			return pNode;
+		}
+
+		const u32 bitA = SlotBit(hashA, shift);
+		const u32 bitB = SlotBit(hashB, shift);
+		if (bitA == bitB)
+		{
+			Node* pChild = MergeEntries(Move(a), hashA, Move(b), hashB, shift + BranchBits);
+			Node* pNode = AllocateNode(0, bitA, 0, 1);
+			Children(pNode, 0)[0] = pChild;
+			return pNode;
+		}
+
+		Node* pNode = AllocateNode(bitA | bitB, 0, 2, 0);
+		const u32 idxA = bitA < bitB ? 0 : 1;
+		new (Entries(pNode) + idxA) Entry{ Move(a) };
+		new (Entries(pNode) + (1 - idxA)) Entry{ Move(b) };
+		return pNode;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::InsertInPlace(K&& key, V&& val) noexcept -> bool
+	{
+		const u64 hash = H{}(key);
+		if (!m_pRoot)
+		{
+			m_pRoot = AllocateNode(SlotBit(hash, 0), 0, 1, 0);
+			new (Entries(m_pRoot)) Entry{ Move(key), Move(val) };
+			++m_size;
+			return true;
+		}
+
+		if (!InsertInPlace(m_pRoot, 0, hash, Move(key), Move(val)))
+			return false;
+		++m_size;
+		return true;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::InsertInPlace(Node*& pNode, u32 shift, u64 hash, K&& key, V&& val) noexcept -> bool
+	{
+		if (shift >= CollisionShift)
+		{
+			Entry* pEntries = Entries(pNode);
+			for (u32 i = 0; i < pNode->dataMap; ++i)
+			{
+				if (C{}(pEntries[i].first, key))
+				{
+					MakeUnique(pNode, shift);
+					Entries(pNode)[i].second = Move(val);
+					return false;
+				}
+			}
+
+			Entry entry{ Move(key), Move(val) };
+			pNode = RebuildCollision(pNode, ~0u, &entry);
+			return true;
+		}
+
+		const u32 bit = SlotBit(hash, shift);
+		if (pNode->dataMap & bit)
+		{
+			const u32 idx = SlotIndex(pNode->dataMap, bit);
+			Entry& existing = Entries(pNode)[idx];
+			if (C{}(existing.first, key))
+			{
+				MakeUnique(pNode, shift);
+				Entries(pNode)[idx].second = Move(val);
+				return false;
+			}
+
+			// Both entries move down into a new child
+			const u64 existingHash = H{}(existing.first);
+			Entry moved = IsUnique(pNode) ? Entry{ Move(existing) } : Entry{ existing };
+			Node* pChild = MergeEntries(Move(moved), existingHash, Entry{ Move(key), Move(val) }, hash, shift + BranchBits);
+			pNode = Rebuild(pNode, shift, pNode->dataMap & ~bit, pNode->nodeMap | bit, bit, nullptr, pChild);
+			return true;
+		}
+
+		if (pNode->nodeMap & bit)
+		{
+			MakeUnique(pNode, shift);
+			Node*& pChild = Children(pNode, Intrin::PopCnt(pNode->dataMap))[SlotIndex(pNode->nodeMap, bit)];
+			return InsertInPlace(pChild, shift + BranchBits, hash, Move(key), Move(val));
+		}
+
+		Entry entry{ Move(key), Move(val) };
+		pNode = Rebuild(pNode, shift, pNode->dataMap | bit, pNode->nodeMap, bit, &entry, nullptr);
+		return true;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::EraseInPlace(const K& key) noexcept -> bool
+	{
+		// Checking first prevents copying the path to a key that is not in the map
+		if (!Contains(key))
+			return false;
+
+		EraseInPlace(m_pRoot, 0, H{}(key), key);
+		--m_size;
+		if (m_size == 0)
+		{
+			Release(m_pRoot, 0);
+			m_pRoot = nullptr;
+		}
+		return true;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto PHashMap<K, V, H, C>::EraseInPlace(Node*& pNode, u32 shift, u64 hash, const K& key) noexcept -> bool
+	{
+		if (shift >= CollisionShift)
+		{
+			Entry* pEntries = Entries(pNode);
+			for (u32 i = 0; i < pNode->dataMap; ++i)
+			{
+				if (C{}(pEntries[i].first, key))
+				{
+					pNode = RebuildCollision(pNode, i, nullptr);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		const u32 bit = SlotBit(hash, shift);
+		if (pNode->dataMap & bit)
+		{
+			if (!C{}(Entries(pNode)[SlotIndex(pNode->dataMap, bit)].first, key))
+				return false;
+			pNode = Rebuild(pNode, shift, pNode->dataMap & ~bit, pNode->nodeMap, bit, nullptr, nullptr);
+			return true;
+		}
+
+		if (!(pNode->nodeMap & bit))
+			return false;
+
+		MakeUnique(pNode, shift);
+		Node*& pChild = Children(pNode, Intrin::PopCnt(pNode->dataMap))[SlotIndex(pNode->nodeMap, bit)];
+		const u32 childShift = shift + BranchBits;
+		if (!EraseInPlace(pChild, childShift, hash, key))
+			return false;
+
+		// A child with a single entry left is inlined, so the trie does not keep chains of nodes with a single entry at the bottom
+		if (NumChildren(pChild) == 0 && NumEntries(pChild, childShift) == 1)
+		{
+			Entry& last = Entries(pChild)[0];
+			Entry entry = IsUnique(pChild) ? Entry{ Move(last) } : Entry{ last };
+			pNode = Rebuild(pNode, shift, pNode->dataMap | bit, pNode->nodeMap & ~bit, bit, &entry, nullptr);
+		}
+		return true;
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	template <typename F>
+	void PHashMap<K, V, H, C>::ForEachImpl(Node* pNode, u32 shift, F& fun) noexcept
+	{
+		const u32 numEntries = NumEntries(pNode, shift);
+		const Entry* pEntries = Entries(pNode);
+		for (u32 i = 0; i < numEntries; ++i)
+			fun(pEntries[i].first, pEntries[i].second);
+
+		const u32 numChildren = NumChildren(pNode);
+		Node** ppChildren = Children(pNode, numEntries);
+		for (u32 i = 0; i < numChildren; ++i)
+			ForEachImpl(ppChildren[i], shift + BranchBits, fun);
+	}
+
+	////////////////////////////////////////////////////////////////
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	TransientPHashMap<K, V, H, C>::TransientPHashMap(Alloc::IAllocator& alloc) noexcept
+		: m_map(alloc)
+	{
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	TransientPHashMap<K, V, H, C>::TransientPHashMap(const PHashMap<K, V, H, C>& map) noexcept
+		: m_map(map)
+	{
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::Insert(const K& key, const V& val) noexcept -> bool
+	{
+		return m_map.InsertInPlace(K{ key }, V{ val });
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::Insert(K&& key, V&& val) noexcept -> bool
+	{
+		return m_map.InsertInPlace(Move(key), Move(val));
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::Erase(const K& key) noexcept -> bool
+	{
+		return m_map.EraseInPlace(key);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::Persistent() noexcept -> PHashMap<K, V, H, C>
+	{
+		// Moving out leaves the transient map empty, with the same allocator
+		return PHashMap<K, V, H, C>{ Move(m_map) };
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::Find(const K& key) const noexcept -> const V*
+	{
+		return m_map.Find(key);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::Contains(const K& key) const noexcept -> bool
+	{
+		return m_map.Contains(key);
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::Size() const noexcept -> usize
+	{
+		return m_map.Size();
+	}
+
+	template <typename K, typename V, Hasher<K> H, EqualsComparator<K> C>
+	auto TransientPHashMap<K, V, H, C>::IsEmpty() const noexcept -> bool
+	{
+		return m_map.IsEmpty();
+	}
+}
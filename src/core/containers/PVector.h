@@ -0,0 +1,367 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "core/allocator/ContainerAlloc.h"
+#include "core/memory/CompactRefCounted.h"
+
+namespace Onca
+{
+	template<typename T>
+	class TransientPVector;
+
+	/**
+	 * \brief A persistent (immutable) vector, implemented as a bit-partitioned trie with a tail
+	 *
+	 * Elements are stored in leaves of 32 elements, which are the leaves of a trie with a branching factor of 32.
+	 * The last leaf is kept outside of the trie as the tail, so appending only touches the trie once every 32 elements.
+	 *
+	 * Modifying a PVector returns a new PVector and leaves the original untouched. Only the nodes on the path to the modified element are copied,
+	 * all other nodes are shared between both vectors, so an update is O(log32 n) and copying a PVector is O(1).
+	 * Nodes are reference counted atomically, so a copy of a PVector can be handed to other threads as a consistent snapshot.
+	 *
+	 * When a lot of modifications are made at once, use a TransientPVector, which modifies nodes it owns in place instead of copying them.
+	 *
+	 * \tparam T Element type (needs to conform to Onca::CopyConstructible)
+	 */
+	template<typename T>
+	class PVector
+	{
+		STATIC_ASSERT(CopyConstructible<T>, "Type needs to be copy constructible to be used in a PVector");
+	public:
+		static constexpr u32 BranchBits = 5;                     ///< Number of bits of an index used per level of the trie
+		static constexpr u32 BranchFactor = 1u << BranchBits;    ///< Number of children per node
+		static constexpr u32 BranchMask = BranchFactor - 1;      ///< Mask for the index into a node
+
+		/**
+		 * Iterator over the elements of a PVector
+		 */
+		class ConstIterator
+		{
+		public:
+			auto operator++() noexcept -> ConstIterator&;
+			auto operator++(int) noexcept -> ConstIterator;
+
+			auto operator*() const noexcept -> const T&;
+			auto operator->() const noexcept -> const T*;
+
+			auto operator==(const ConstIterator& other) const noexcept -> bool;
+			auto operator!=(const ConstIterator& other) const noexcept -> bool;
+
+		private:
+			friend class PVector;
+
+			ConstIterator(const PVector* pVec, usize idx) noexcept;
+
+			const PVector* m_pVec;  ///< Vector
+			usize          m_idx;   ///< Index of the element
+			const T*       m_pLeaf; ///< Leaf containing the element
+		};
+
+		/**
+		 * Create an empty PVector
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit PVector(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create a PVector from an initializer list
+		 * \param[in] il Initializer list with elements
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit PVector(const InitializerList<T>& il, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create a PVector that shares all nodes with another PVector
+		 * \param[in] other PVector to share with
+		 */
+		PVector(const PVector& other) noexcept;
+		PVector(PVector&& other) noexcept;
+		~PVector() noexcept;
+
+		auto operator=(const PVector& other) noexcept -> PVector&;
+		auto operator=(PVector&& other) noexcept -> PVector&;
+
+		/**
+		 * Create a PVector with an element replaced
+		 * \param[in] idx Index of the element
+		 * \param[in] val New value
+		 * \return PVector with the replaced element
+		 * \note Only use with an index smaller than the size of the PVector
+		 */
+		auto Set(usize idx, const T& val) const noexcept -> PVector;
+		/**
+		 * Create a PVector with an element replaced
+		 * \param[in] idx Index of the element
+		 * \param[in] val New value
+		 * \return PVector with the replaced element
+		 * \note Only use with an index smaller than the size of the PVector
+		 */
+		auto Set(usize idx, T&& val) const noexcept -> PVector;
+		/**
+		 * Create a PVector with an element appended
+		 * \param[in] val Element to append
+		 * \return PVector with the appended element
+		 */
+		auto PushBack(const T& val) const noexcept -> PVector;
+		/**
+		 * Create a PVector with an element appended
+		 * \param[in] val Element to append
+		 * \return PVector with the appended element
+		 */
+		auto PushBack(T&& val) const noexcept -> PVector;
+		/**
+		 * Create a PVector with the last element removed
+		 * \return PVector without the last element
+		 * \note Only use when the PVector is not empty
+		 */
+		auto PopBack() const noexcept -> PVector;
+
+		/**
+		 * Create a transient vector that starts out sharing all nodes with this PVector
+		 * \return Transient vector
+		 */
+		auto AsTransient() const noexcept -> TransientPVector<T>;
+
+		/**
+		 * Get the element at an index
+		 * \param[in] idx Index of the element
+		 * \return Element at the index
+		 * \note Only use with an index smaller than the size of the PVector
+		 */
+		auto operator[](usize idx) const noexcept -> const T&;
+		/**
+		 * Get the first element in the PVector
+		 * \return First element in the PVector
+		 * \note Only use when the PVector is not empty
+		 */
+		auto Front() const noexcept -> const T&;
+		/**
+		 * Get the last element in the PVector
+		 * \return Last element in the PVector
+		 * \note Only use when the PVector is not empty
+		 */
+		auto Back() const noexcept -> const T&;
+
+		/**
+		 * Get the size of the PVector
+		 * \return Size of the PVector
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the PVector is empty
+		 * \return Whether the PVector is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Check if 2 PVectors share the same nodes, which means they are equal without comparing any elements
+		 * \param[in] other PVector to check
+		 * \return Whether both PVectors share the same nodes
+		 */
+		auto IsSharedWith(const PVector& other) const noexcept -> bool;
+
+		/**
+		 * Get the allocator used by the PVector
+		 * \return Allocator used by the PVector
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+		/**
+		 * Get an iterator to the first element
+		 * \return Iterator to the first element
+		 */
+		auto Begin() const noexcept -> ConstIterator;
+		/**
+		 * Get an iterator to the end of the elements
+		 * \return Iterator to the end of the elements
+		 */
+		auto End() const noexcept -> ConstIterator;
+
+		// Overloads for 'for ( ... : ... )'
+		auto begin() const noexcept -> ConstIterator;
+		auto end() const noexcept -> ConstIterator;
+
+	private:
+		friend class TransientPVector<T>;
+
+		/**
+		 * Node header, followed by 32 child pointers for inner nodes, or 32 elements for leaves
+		 */
+		struct Node
+		{
+			Detail::AtomicRefCount refs;  ///< Number of references to the node
+			u32                    count; ///< Number of children, or number of constructed elements for a leaf
+		};
+
+		static constexpr usize ValuesOffset = (sizeof(Node) + alignof(T) - 1) & ~(alignof(T) - 1);         ///< Offset of the elements in a leaf
+		static constexpr usize LeafSize = ValuesOffset + BranchFactor * sizeof(T);                          ///< Size of a leaf
+		static constexpr usize InnerSize = sizeof(Node) + BranchFactor * sizeof(Node*);                     ///< Size of an inner node
+		static constexpr u16   NodeAlign = u16(alignof(T) > alignof(Node*) ? alignof(T) : alignof(Node*)); ///< Alignment of a node
+
+		static auto Children(Node* pNode) noexcept -> Node**;
+		static auto Values(Node* pNode) noexcept -> T*;
+		static auto Values(const Node* pNode) noexcept -> const T*;
+
+		/**
+		 * Allocate a node without children or elements
+		 * \param[in] isLeaf Whether the node is a leaf
+		 * \return Allocated node
+		 */
+		auto AllocateNode(bool isLeaf) noexcept -> Node*;
+		/**
+		 * Deallocate the memory of a node, without touching its children or elements
+		 * \param[in] pNode Node
+		 * \param[in] isLeaf Whether the node is a leaf
+		 */
+		void DeallocateNode(Node* pNode, bool isLeaf) noexcept;
+		/**
+		 * Drop a reference to a node, destroying it and dropping the references to its children when it was the last reference
+		 * \param[in] pNode Node, may be null
+		 * \param[in] shift Shift of the level of the node, 0 for leaves
+		 */
+		void Release(Node* pNode, u32 shift) noexcept;
+
+		/**
+		 * Make sure an inner node is only referenced by this vector, copying it when it is shared
+		 * \param[in,out] pNode Node, replaced by its copy if it was shared
+		 */
+		void MakeUniqueInner(Node*& pNode) noexcept;
+		/**
+		 * Make sure a leaf is only referenced by this vector, copying it when it is shared
+		 * \param[in,out] pNode Leaf, replaced by its copy if it was shared
+		 * \param[in] liveCount Number of elements in the leaf that are part of this vector
+		 */
+		void MakeUniqueLeaf(Node*& pNode, u32 liveCount) noexcept;
+
+		/**
+		 * Get the index of the first element in the tail
+		 * \return Index of the first element in the tail
+		 */
+		auto TailOffset() const noexcept -> usize;
+		/**
+		 * Get the leaf containing an element
+		 * \param[in] idx Index of the element
+		 * \return Elements of the leaf
+		 */
+		auto GetLeaf(usize idx) const noexcept -> const T*;
+
+		// Modifications in place, nodes that are shared are copied before they are modified
+		void SetInPlace(usize idx, T&& val) noexcept;
+		void PushBackInPlace(T&& val) noexcept;
+		void PopBackInPlace() noexcept;
+		/**
+		 * Move the full tail into the trie
+		 */
+		void PushTail() noexcept;
+		/**
+		 * Create a path of single child inner nodes down to a leaf
+		 * \param[in] shift Shift of the level of the top of the path
+		 * \param[in] pLeaf Leaf
+		 * \return Top of the path
+		 */
+		auto NewPath(u32 shift, Node* pLeaf) noexcept -> Node*;
+		/**
+		 * Remove the last leaf from the trie
+		 * \param[in,out] pNode Node to remove the leaf from
+		 * \param[in] shift Shift of the level of the node
+		 * \param[in] leafOffset Index of the first element of the leaf
+		 * \return Removed leaf
+		 */
+		auto PopLeaf(Node*& pNode, u32 shift, usize leafOffset) noexcept -> Node*;
+
+		Alloc::ContainerAlloc m_alloc; ///< Allocator
+		Node*                 m_pRoot; ///< Root of the trie, null when all elements fit in the tail
+		Node*                 m_pTail; ///< Tail, null when the PVector is empty
+		usize                 m_size;  ///< Number of elements
+		u32                   m_shift; ///< Shift of the level of the root
+	};
+
+	/**
+	 * \brief A mutable view of a PVector for batches of modifications
+	 *
+	 * A transient vector modifies the nodes it does not share with any PVector in place, so after the first modification to a path,
+	 * further modifications on the same path don't allocate anymore. Nodes that are still shared are copied, like a PVector would.
+	 * When done, the transient vector is turned back into a PVector in O(1).
+	 *
+	 * \tparam T Element type (needs to conform to Onca::CopyConstructible)
+	 */
+	template<typename T>
+	class TransientPVector
+	{
+	public:
+		/**
+		 * Create an empty TransientPVector
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit TransientPVector(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		TransientPVector(TransientPVector&& other) noexcept = default;
+
+		auto operator=(TransientPVector&& other) noexcept -> TransientPVector& = default;
+
+		DISABLE_COPY(TransientPVector);
+
+		/**
+		 * Replace an element
+		 * \param[in] idx Index of the element
+		 * \param[in] val New value
+		 * \note Only use with an index smaller than the size of the vector
+		 */
+		void Set(usize idx, const T& val) noexcept;
+		/**
+		 * Replace an element
+		 * \param[in] idx Index of the element
+		 * \param[in] val New value
+		 * \note Only use with an index smaller than the size of the vector
+		 */
+		void Set(usize idx, T&& val) noexcept;
+		/**
+		 * Append an element
+		 * \param[in] val Element to append
+		 */
+		void PushBack(const T& val) noexcept;
+		/**
+		 * Append an element
+		 * \param[in] val Element to append
+		 */
+		void PushBack(T&& val) noexcept;
+		/**
+		 * Remove the last element
+		 * \note Only use when the vector is not empty
+		 */
+		void PopBack() noexcept;
+
+		/**
+		 * Turn the transient vector into a PVector, the transient vector is empty afterwards
+		 * \return PVector with the contents of the transient vector
+		 */
+		auto Persistent() noexcept -> PVector<T>;
+
+		/**
+		 * Get the element at an index
+		 * \param[in] idx Index of the element
+		 * \return Element at the index
+		 * \note Only use with an index smaller than the size of the vector
+		 */
+		auto operator[](usize idx) const noexcept -> const T&;
+		/**
+		 * Get the size of the vector
+		 * \return Size of the vector
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the vector is empty
+		 * \return Whether the vector is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+	private:
+		friend class PVector<T>;
+
+		/**
+		 * Create a TransientPVector that starts out sharing all nodes with a PVector
+		 * \param[in] vec PVector
+		 */
+		explicit TransientPVector(const PVector<T>& vec) noexcept;
+
+		PVector<T> m_vec; ///< Vector that is modified in place
+	};
+}
+
+#include "PVector.inl"
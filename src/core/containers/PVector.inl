@@ -0,0 +1,603 @@
+#pragma once
+#if __RESHARPER__
+#include "PVector.h"
+#endif
+
+namespace Onca
+{
+	template <typename T>
+	PVector<T>::ConstIterator::ConstIterator(const PVector* pVec, usize idx) noexcept
+		: m_pVec(pVec)
+		, m_idx(idx)
+		, m_pLeaf(idx < pVec->m_size ? pVec->GetLeaf(idx) : nullptr)
+	{
+	}
+
+	template <typename T>
+	auto PVector<T>::ConstIterator::operator++() noexcept -> ConstIterator&
+	{
+		++m_idx;
+		// The leaf only needs to be looked up when crossing into the next leaf
+		if ((m_idx & BranchMask) == 0 && m_idx < m_pVec->m_size)
+			m_pLeaf = m_pVec->GetLeaf(m_idx);
+		return *this;
+	}
+
+	template <typename T>
+	auto PVector<T>::ConstIterator::operator++(int) noexcept -> ConstIterator
+	{
+		ConstIterator it = *this;
+		operator++();
+		return it;
+	}
+
+	template <typename T>
+	auto PVector<T>::ConstIterator::operator*() const noexcept -> const T&
+	{
+		return m_pLeaf[m_idx & BranchMask];
+	}
+
+	template <typename T>
+	auto PVector<T>::ConstIterator::operator->() const noexcept -> const T*
+	{
+		return m_pLeaf + (m_idx & BranchMask);
+	}
+
+	template <typename T>
+	auto PVector<T>::ConstIterator::operator==(const ConstIterator& other) const noexcept -> bool
+	{
+		return m_idx == other.m_idx;
+	}
+
+	template <typename T>
+	auto PVector<T>::ConstIterator::operator!=(const ConstIterator& other) const noexcept -> bool
+	{
+		return m_idx != other.m_idx;
+	}
+
+	////////////////////////////////////////////////////////////////
+
+	template <typename T>
+	PVector<T>::PVector(Alloc::IAllocator& alloc) noexcept
+		: m_alloc(alloc)
+		, m_pRoot(nullptr)
+		, m_pTail(nullptr)
+		, m_size(0)
+		, m_shift(BranchBits)
+	{
+	}
+
+	template <typename T>
+	PVector<T>::PVector(const InitializerList<T>& il, Alloc::IAllocator& alloc) noexcept
+		: PVector(alloc)
+	{
+		for (const T& val : il)
+			PushBackInPlace(T{ val });
+	}
+
+	template <typename T>
+	PVector<T>::PVector(const PVector& other) noexcept
+		: m_alloc(other.m_alloc)
+		, m_pRoot(other.m_pRoot)
+		, m_pTail(other.m_pTail)
+		, m_size(other.m_size)
+		, m_shift(other.m_shift)
+	{
+		if (m_pRoot)
+			m_pRoot->refs.Inc();
+		if (m_pTail)
+			m_pTail->refs.Inc();
+	}
+
+	template <typename T>
+	PVector<T>::PVector(PVector&& other) noexcept
+		: m_alloc(other.m_alloc)
+		, m_pRoot(other.m_pRoot)
+		, m_pTail(other.m_pTail)
+		, m_size(other.m_size)
+		, m_shift(other.m_shift)
+	{
+		other.m_pRoot = nullptr;
+		other.m_pTail = nullptr;
+		other.m_size = 0;
+		other.m_shift = BranchBits;
+	}
+
+	template <typename T>
+	PVector<T>::~PVector() noexcept
+	{
+		Release(m_pRoot, m_shift);
+		Release(m_pTail, 0);
+	}
+
+	template <typename T>
+	auto PVector<T>::operator=(const PVector& other) noexcept -> PVector&
+	{
+		if (this != &other)
+		{
+			PVector copy{ other };
+			*this = Move(copy);
+		}
+		return *this;
+	}
+
+	template <typename T>
+	auto PVector<T>::operator=(PVector&& other) noexcept -> PVector&
+	{
+		if (this != &other)
+		{
+			Release(m_pRoot, m_shift);
+			Release(m_pTail, 0);
+
+			m_alloc = other.m_alloc;
+			m_pRoot = other.m_pRoot;
+			m_pTail = other.m_pTail;
+			m_size = other.m_size;
+			m_shift = other.m_shift;
+
+			other.m_pRoot = nullptr;
+			other.m_pTail = nullptr;
+			other.m_size = 0;
+			other.m_shift = BranchBits;
+		}
+		return *this;
+	}
+
+	template <typename T>
+	auto PVector<T>::Set(usize idx, const T& val) const noexcept -> PVector
+	{
+		return Set(idx, T{ val });
+	}
+
+	template <typename T>
+	auto PVector<T>::Set(usize idx, T&& val) const noexcept -> PVector
+	{
+		// The copy shares all nodes with this vector, so modifying it in place copies the path to the element
+		PVector res{ *this };
+		res.SetInPlace(idx, Move(val));
+		return res;
+	}
+
+	template <typename T>
+	auto PVector<T>::PushBack(const T& val) const noexcept -> PVector
+	{
+		return PushBack(T{ val });
+	}
+
+	template <typename T>
+	auto PVector<T>::PushBack(T&& val) const noexcept -> PVector
+	{
+		PVector res{ *this };
+		res.PushBackInPlace(Move(val));
+		return res;
+	}
+
+	template <typename T>
+	auto PVector<T>::PopBack() const noexcept -> PVector
+	{
+		PVector res{ *this };
+		res.PopBackInPlace();
+		return res;
+	}
+
+	template <typename T>
+	auto PVector<T>::AsTransient() const noexcept -> TransientPVector<T>
+	{
+		return TransientPVector<T>{ *this };
+	}
+
+	template <typename T>
+	auto PVector<T>::operator[](usize idx) const noexcept -> const T&
+	{
+		ASSERT(idx < m_size, "Index out of range");
+		return GetLeaf(idx)[idx & BranchMask];
+	}
+
+	template <typename T>
+	auto PVector<T>::Front() const noexcept -> const T&
+	{
+		return operator[](0);
+	}
+
+	template <typename T>
+	auto PVector<T>::Back() const noexcept -> const T&
+	{
+		ASSERT(m_size, "PVector is empty");
+		return Values(m_pTail)[m_size - 1 - TailOffset()];
+	}
+
+	template <typename T>
+	auto PVector<T>::Size() const noexcept -> usize
+	{
+		return m_size;
+	}
+
+	template <typename T>
+	auto PVector<T>::IsEmpty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	template <typename T>
+	auto PVector<T>::IsSharedWith(const PVector& other) const noexcept -> bool
+	{
+		return m_pRoot == other.m_pRoot && m_pTail == other.m_pTail && m_size == other.m_size;
+	}
+
+	template <typename T>
+	auto PVector<T>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_alloc.Get();
+	}
+
+	template <typename T>
+	auto PVector<T>::Begin() const noexcept -> ConstIterator
+	{
+		return ConstIterator{ this, 0 };
+	}
+
+	template <typename T>
+	auto PVector<T>::End() const noexcept -> ConstIterator
+	{
+		return ConstIterator{ this, m_size };
+	}
+
+	template <typename T>
+	auto PVector<T>::begin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename T>
+	auto PVector<T>::end() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename T>
+	auto PVector<T>::Children(Node* pNode) noexcept -> Node**
+	{
+		return reinterpret_cast<Node**>(reinterpret_cast<u8*>(pNode) + sizeof(Node));
+	}
+
+	template <typename T>
+	auto PVector<T>::Values(Node* pNode) noexcept -> T*
+	{
+		return reinterpret_cast<T*>(reinterpret_cast<u8*>(pNode) + ValuesOffset);
+	}
+
+	template <typename T>
+	auto PVector<T>::Values(const Node* pNode) noexcept -> const T*
+	{
+		return reinterpret_cast<const T*>(reinterpret_cast<const u8*>(pNode) + ValuesOffset);
+	}
+
+	template <typename T>
+	auto PVector<T>::AllocateNode(bool isLeaf) noexcept -> Node*
+	{
+		CompactMemRef<u8> mem = m_alloc.Allocate<u8>(isLeaf ? LeafSize : InnerSize, NodeAlign);
+		ASSERT(mem, "Failed to allocate a PVector node");
+		return new (mem.Ptr()) Node{ Detail::AtomicRefCount{ 1 }, 0 };
+	}
+
+	template <typename T>
+	void PVector<T>::DeallocateNode(Node* pNode, bool isLeaf) noexcept
+	{
+		pNode->~Node();
+		m_alloc.Deallocate(CompactMemRef<u8>{ reinterpret_cast<u8*>(pNode) }, isLeaf ? LeafSize : InnerSize, NodeAlign);
+	}
+
+	template <typename T>
+	void PVector<T>::Release(Node* pNode, u32 shift) noexcept
+	{
+		if (!pNode || !pNode->refs.Dec())
+			return;
+
+		if (shift == 0)
+		{
+			T* pValues = Values(pNode);
+			for (u32 i = 0; i < pNode->count; ++i)
+				pValues[i].~T();
+		}
+		else
+		{
+			Node** ppChildren = Children(pNode);
+			for (u32 i = 0; i < pNode->count; ++i)
+				Release(ppChildren[i], shift - BranchBits);
+		}
+		DeallocateNode(pNode, shift == 0);
+	}
+
+	template <typename T>
+	void PVector<T>::MakeUniqueInner(Node*& pNode) noexcept
+	{
+		// Acquire makes sure that reads by other threads that dropped their reference happen before the node is modified
+		if (pNode->refs.count.Load(MemOrder::Acquire) == 1)
+			return;
+
+		Node* pCopy = AllocateNode(false);
+		Node** ppSrc = Children(pNode);
+		Node** ppDst = Children(pCopy);
+		for (u32 i = 0; i < pNode->count; ++i)
+		{
+			ppSrc[i]->refs.Inc();
+			ppDst[i] = ppSrc[i];
+		}
+		pCopy->count = pNode->count;
+
+		// Children have a reference from the copy now, so releasing the original never releases them
+		Release(pNode, BranchBits);
+		pNode = pCopy;
+	}
+
+	template <typename T>
+	void PVector<T>::MakeUniqueLeaf(Node*& pNode, u32 liveCount) noexcept
+	{
+		if (pNode->refs.count.Load(MemOrder::Acquire) == 1)
+		{
+			// Elements that were popped while the leaf was shared are still constructed
+			T* pValues = Values(pNode);
+			for (u32 i = liveCount; i < pNode->count; ++i)
+				pValues[i].~T();
+			pNode->count = liveCount;
+			return;
+		}
+
+		Node* pCopy = AllocateNode(true);
+		const T* pSrc = Values(pNode);
+		T* pDst = Values(pCopy);
+		for (u32 i = 0; i < liveCount; ++i)
+			new (pDst + i) T{ pSrc[i] };
+		pCopy->count = liveCount;
+
+		Release(pNode, 0);
+		pNode = pCopy;
+	}
+
+	template <typename T>
+	auto PVector<T>::TailOffset() const noexcept -> usize
+	{
+		return m_size < BranchFactor ? 0 : ((m_size - 1) >> BranchBits) << BranchBits;
+	}
+
+	template <typename T>
+	auto PVector<T>::GetLeaf(usize idx) const noexcept -> const T*
+	{
+		if (idx >= TailOffset())
+			return Values(m_pTail);
+
+		Node* pNode = m_pRoot;
+		for (u32 shift = m_shift; shift > 0; shift -= BranchBits)
+			pNode = Children(pNode)[(idx >> shift) & BranchMask];
+		return Values(pNode);
+	}
+
+	template <typename T>
+	void PVector<T>::SetInPlace(usize idx, T&& val) noexcept
+	{
+		ASSERT(idx < m_size, "Index out of range");
+		const usize tailOffset = TailOffset();
+		if (idx >= tailOffset)
+		{
+			MakeUniqueLeaf(m_pTail, u32(m_size - tailOffset));
+			Values(m_pTail)[idx - tailOffset] = Move(val);
+			return;
+		}
+
+		Node** ppNode = &m_pRoot;
+		for (u32 shift = m_shift; shift > 0; shift -= BranchBits)
+		{
+			MakeUniqueInner(*ppNode);
+			ppNode = &Children(*ppNode)[(idx >> shift) & BranchMask];
+		}
+		MakeUniqueLeaf(*ppNode, BranchFactor);
+		Values(*ppNode)[idx & BranchMask] = Move(val);
+	}
+
+	template <typename T>
+	void PVector<T>::PushBackInPlace(T&& val) noexcept
+	{
+		if (m_pTail)
+		{
+			const u32 tailSize = u32(m_size - TailOffset());
+			if (tailSize < BranchFactor)
+			{
+				MakeUniqueLeaf(m_pTail, tailSize);
+				new (Values(m_pTail) + tailSize) T{ Move(val) };
+				++m_pTail->count;
+				++m_size;
+				return;
+			}
+			PushTail();
+		}
+
+		m_pTail = AllocateNode(true);
+		new (Values(m_pTail)) T{ Move(val) };
+		m_pTail->count = 1;
+		++m_size;
+	}
+
+	template <typename T>
+	void PVector<T>::PopBackInPlace() noexcept
+	{
+		ASSERT(m_size, "Cannot pop from an empty PVector");
+		const usize tailOffset = TailOffset();
+		const u32 tailSize = u32(m_size - tailOffset);
+		--m_size;
+
+		if (tailSize > 1)
+		{
+			// A shared tail is left as is, the element is no longer part of this vector, but still part of the vectors sharing the tail
+			if (m_pTail->refs.count.Load(MemOrder::Acquire) == 1)
+				MakeUniqueLeaf(m_pTail, tailSize - 1);
+			return;
+		}
+
+		Release(m_pTail, 0);
+		m_pTail = nullptr;
+		if (!m_pRoot)
+			return;
+
+		// The last leaf in the trie becomes the new tail
+		m_pTail = PopLeaf(m_pRoot, m_shift, tailOffset - BranchFactor);
+		if (m_pRoot->count == 0)
+		{
+			DeallocateNode(m_pRoot, false);
+			m_pRoot = nullptr;
+			m_shift = BranchBits;
+		}
+		else if (m_shift > BranchBits && m_pRoot->count == 1)
+		{
+			// The root only has a single child left, so the trie can lose a level
+			Node* pChild = Children(m_pRoot)[0];
+			DeallocateNode(m_pRoot, false);
+			m_pRoot = pChild;
+			m_shift -= BranchBits;
+		}
+	}
+
+	template <typename T>
+	void PVector<T>::PushTail() noexcept
+	{
+		const usize tailOffset = m_size - BranchFactor;
+		if (!m_pRoot)
+		{
+			m_pRoot = AllocateNode(false);
+			Children(m_pRoot)[0] = m_pTail;
+			m_pRoot->count = 1;
+			m_shift = BranchBits;
+			return;
+		}
+
+		// When the trie is full, the old root becomes the first child of a new root
+		if ((tailOffset >> BranchBits) >= (usize(1) << m_shift))
+		{
+			Node* pRoot = AllocateNode(false);
+			Children(pRoot)[0] = m_pRoot;
+			Children(pRoot)[1] = NewPath(m_shift, m_pTail);
+			pRoot->count = 2;
+			m_pRoot = pRoot;
+			m_shift += BranchBits;
+			return;
+		}
+
+		Node** ppNode = &m_pRoot;
+		for (u32 shift = m_shift; ; shift -= BranchBits)
+		{
+			MakeUniqueInner(*ppNode);
+			Node* pNode = *ppNode;
+			const u32 childIdx = u32(tailOffset >> shift) & BranchMask;
+			if (shift == BranchBits || childIdx == pNode->count)
+			{
+				Children(pNode)[childIdx] = NewPath(shift - BranchBits, m_pTail);
+				pNode->count = childIdx + 1;
+				return;
+			}
+			ppNode = &Children(pNode)[childIdx];
+		}
+	}
+
+	template <typename T>
+	auto PVector<T>::NewPath(u32 shift, Node* pLeaf) noexcept -> Node*
+	{
+		if (shift == 0)
+			return pLeaf;
+
+		Node* pNode = AllocateNode(false);
+		Children(pNode)[0] = NewPath(shift - BranchBits, pLeaf);
+		pNode->count = 1;
+		return pNode;
+	}
+
+	template <typename T>
+	auto PVector<T>::PopLeaf(Node*& pNode, u32 shift, usize leafOffset) noexcept -> Node*
+	{
+		MakeUniqueInner(pNode);
+		const u32 childIdx = u32(leafOffset >> shift) & BranchMask;
+		Node*& pChild = Children(pNode)[childIdx];
+		if (shift == BranchBits)
+		{
+			// The reference of the node to the leaf is handed over to the caller
+			Node* pLeaf = pChild;
+			--pNode->count;
+			return pLeaf;
+		}
+
+		Node* pLeaf = PopLeaf(pChild, shift - BranchBits, leafOffset);
+		if (pChild->count == 0)
+		{
+			DeallocateNode(pChild, false);
+			--pNode->count;
+		}
+		return pLeaf;
+	}
+
+	////////////////////////////////////////////////////////////////
+
+	template <typename T>
+	TransientPVector<T>::TransientPVector(Alloc::IAllocator& alloc) noexcept
+		: m_vec(alloc)
+	{
+	}
+
+	template <typename T>
+	TransientPVector<T>::TransientPVector(const PVector<T>& vec) noexcept
+		: m_vec(vec)
+	{
+	}
+
+	template <typename T>
+	void TransientPVector<T>::Set(usize idx, const T& val) noexcept
+	{
+		m_vec.SetInPlace(idx, T{ val });
+	}
+
+	template <typename T>
+	void TransientPVector<T>::Set(usize idx, T&& val) noexcept
+	{
+		m_vec.SetInPlace(idx, Move(val));
+	}
+
+	template <typename T>
+	void TransientPVector<T>::PushBack(const T& val) noexcept
+	{
+		m_vec.PushBackInPlace(T{ val });
+	}
+
+	template <typename T>
+	void TransientPVector<T>::PushBack(T&& val) noexcept
+	{
+		m_vec.PushBackInPlace(Move(val));
+	}
+
+	template <typename T>
+	void TransientPVector<T>::PopBack() noexcept
+	{
+		m_vec.PopBackInPlace();
+	}
+
+	template <typename T>
+	auto TransientPVector<T>::Persistent() noexcept -> PVector<T>
+	{
+		// Moving out leaves the transient vector empty, with the same allocator
+		return PVector<T>{ Move(m_vec) };
+	}
+
+	template <typename T>
+	auto TransientPVector<T>::operator[](usize idx) const noexcept -> const T&
+	{
+		return m_vec[idx];
+	}
+
+	template <typename T>
+	auto TransientPVector<T>::Size() const noexcept -> usize
+	{
+		return m_vec.Size();
+	}
+
+	template <typename T>
+	auto TransientPVector<T>::IsEmpty() const noexcept -> bool
+	{
+		return m_vec.IsEmpty();
+	}
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "DynArray.h"
+#include "core/utils/Algo.h"
+#include "core/utils/Utils.h"
+
+namespace Onca
+{
+	/**
+	 * \brief A priority queue, implemented as a pairing heap
+	 *
+	 * The element that is ordered first by the comparator is at the top of the heap, so the default comparator results in a min-heap.
+	 * Pushing and decreasing the key of an element are O(1), popping is O(log n) amortized.
+	 * This makes the pairing heap a better fit than PriorityQueue for workloads that mostly push or decrease keys, like pathfinding,
+	 * while the PriorityQueue is faster when elements are popped about as often as they are pushed.
+	 *
+	 * Nodes are stored in a pool, so the heap does not allocate per element and handles are indices into the pool.
+	 * A handle stays valid until the element is popped or erased, after which it may be reused by a new element.
+	 *
+	 * \tparam T Element type (needs to conform to Onca::Movable)
+	 * \tparam C Comparator type
+	 * \note Popped and erased elements are moved out of their node, the moved-from value stays in the pool until the node is reused
+	 */
+	template<typename T, Comparator<T, T> C = DefaultComparator<T>>
+	class PairingHeap
+	{
+		STATIC_ASSERT(Movable<T>, "Type needs to be movable to be used in a PairingHeap");
+	public:
+		using Handle = u32;
+
+		static constexpr Handle InvalidHandle = Handle(-1); ///< Invalid handle
+
+		/**
+		 * Create an empty PairingHeap
+		 * \param[in] alloc Allocator the container should use
+		 * \param[in] comp Comparator to order elements with
+		 */
+		explicit PairingHeap(Alloc::IAllocator& alloc = g_GlobalAlloc, C comp = C{}) noexcept;
+		PairingHeap(const PairingHeap& other) noexcept requires CopyConstructible<T> = default;
+		PairingHeap(PairingHeap&& other) noexcept;
+
+		auto operator=(const PairingHeap& other) noexcept -> PairingHeap& requires CopyConstructible<T> = default;
+		auto operator=(PairingHeap&& other) noexcept -> PairingHeap&;
+
+		/**
+		 * Push an element into the PairingHeap
+		 * \param[in] val Element to push
+		 * \return Handle to the element
+		 */
+		auto Push(const T& val) noexcept -> Handle requires CopyConstructible<T>;
+		/**
+		 * Push an element into the PairingHeap
+		 * \param[in] val Element to push
+		 * \return Handle to the element
+		 */
+		auto Push(T&& val) noexcept -> Handle;
+
+		/**
+		 * Pop the element at the top of the PairingHeap
+		 * \return Popped element
+		 * \note Only use when the PairingHeap is not empty
+		 */
+		auto Pop() noexcept -> T;
+		/**
+		 * Decrease the key of an element, the new value may not be ordered after the current value
+		 * \param[in] handle Handle to the element
+		 * \param[in] val New value
+		 * \note Only use with a handle to an element in the PairingHeap
+		 */
+		void DecreaseKey(Handle handle, T&& val) noexcept;
+		/**
+		 * Erase an element from the PairingHeap
+		 * \param[in] handle Handle to the element
+		 * \return Whether the element was erased
+		 */
+		auto Erase(Handle handle) noexcept -> bool;
+
+		/**
+		 * Reserve space for a number of elements
+		 * \param[in] capacity Number of elements to reserve space for
+		 */
+		void Reserve(usize capacity) noexcept;
+		/**
+		 * Clear the contents of the PairingHeap
+		 * \param[in] clearMemory Whether to free the memory used by the PairingHeap
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+
+		/**
+		 * Get the element at the top of the PairingHeap
+		 * \return Element at the top of the PairingHeap
+		 * \note Only use when the PairingHeap is not empty
+		 */
+		auto Top() const noexcept -> const T&;
+		/**
+		 * Get the handle of the element at the top of the PairingHeap
+		 * \return Handle of the element at the top of the PairingHeap, or InvalidHandle if the PairingHeap is empty
+		 */
+		auto TopHandle() const noexcept -> Handle;
+		/**
+		 * Get the element a handle refers to
+		 * \param[in] handle Handle to the element
+		 * \return Element
+		 * \note Only use with a handle to an element in the PairingHeap
+		 */
+		auto Get(Handle handle) const noexcept -> const T&;
+		/**
+		 * Check if a handle refers to an element in the PairingHeap
+		 * \param[in] handle Handle to check
+		 * \return Whether the handle refers to an element in the PairingHeap
+		 */
+		auto Contains(Handle handle) const noexcept -> bool;
+
+		/**
+		 * Get the number of elements in the PairingHeap
+		 * \return Number of elements in the PairingHeap
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the PairingHeap is empty
+		 * \return Whether the PairingHeap is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+		/**
+		 * Get the allocator used by the PairingHeap
+		 * \return Allocator used by the PairingHeap
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		/**
+		 * Node in the heap
+		 */
+		struct Node
+		{
+			T      value;   ///< Value
+			Handle child;   ///< First child
+			Handle sibling; ///< Next sibling, or next free node when the node is free
+			Handle prev;    ///< Previous sibling, or parent when the node is the first child, or the node itself when the node is free
+		};
+
+		/**
+		 * Get a free node
+		 * \return Handle to the node
+		 */
+		auto AllocateNode(T&& val) noexcept -> Handle;
+		/**
+		 * Return a node to the pool
+		 * \param[in] handle Handle to the node
+		 */
+		void FreeNode(Handle handle) noexcept;
+		/**
+		 * Link 2 root nodes, the node ordered last becomes the first child of the other
+		 * \param[in] first First root node
+		 * \param[in] second Second root node
+		 * \return New root node
+		 */
+		auto Link(Handle first, Handle second) noexcept -> Handle;
+		/**
+		 * Remove a node that is not the root from its parent
+		 * \param[in] handle Handle to the node
+		 */
+		void Detach(Handle handle) noexcept;
+		/**
+		 * Merge a list of siblings into a single tree, using the two-pass pairing strategy
+		 * \param[in] first First sibling
+		 * \return Root of the merged tree, or InvalidHandle if the list is empty
+		 */
+		auto MergePairs(Handle first) noexcept -> Handle;
+
+		DynArray<Node>      m_nodes;    ///< Node pool
+		Handle              m_root;     ///< Root node
+		Handle              m_freeHead; ///< First free node, InvalidHandle if no node is free
+		usize               m_size;     ///< Number of elements
+		NO_UNIQUE_ADDRESS C m_comp;     ///< Comparator
+	};
+}
+
+#include "PairingHeap.inl"
@@ -0,0 +1,272 @@
+#pragma once
+#if __RESHARPER__
+#include "PairingHeap.h"
+#endif
+
+namespace Onca
+{
+	template <typename T, Comparator<T, T> C>
+	PairingHeap<T, C>::PairingHeap(Alloc::IAllocator& alloc, C comp) noexcept
+		: m_nodes(alloc)
+		, m_root(InvalidHandle)
+		, m_freeHead(InvalidHandle)
+		, m_size(0)
+		, m_comp(Move(comp))
+	{
+	}
+
+	template <typename T, Comparator<T, T> C>
+	PairingHeap<T, C>::PairingHeap(PairingHeap&& other) noexcept
+		: m_nodes(Move(other.m_nodes))
+		, m_root(other.m_root)
+		, m_freeHead(other.m_freeHead)
+		, m_size(other.m_size)
+		, m_comp(Move(other.m_comp))
+	{
+		other.m_root = InvalidHandle;
+		other.m_freeHead = InvalidHandle;
+		other.m_size = 0;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::operator=(PairingHeap&& other) noexcept -> PairingHeap&
+	{
+		m_nodes = Move(other.m_nodes);
+		m_root = other.m_root;
+		m_freeHead = other.m_freeHead;
+		m_size = other.m_size;
+		m_comp = Move(other.m_comp);
+		other.m_root = InvalidHandle;
+		other.m_freeHead = InvalidHandle;
+		other.m_size = 0;
+		return *this;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Push(const T& val) noexcept -> Handle requires CopyConstructible<T>
+	{
+		return Push(T{ val });
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Push(T&& val) noexcept -> Handle
+	{
+		const Handle handle = AllocateNode(Move(val));
+		m_root = m_root == InvalidHandle ? handle : Link(m_root, handle);
+		++m_size;
+		return handle;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Pop() noexcept -> T
+	{
+		ASSERT(m_root != InvalidHandle, "Cannot pop from an empty PairingHeap");
+		const Handle root = m_root;
+		T val = Move(m_nodes[root].value);
+		m_root = MergePairs(m_nodes[root].child);
+		FreeNode(root);
+		--m_size;
+		return val;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	void PairingHeap<T, C>::DecreaseKey(Handle handle, T&& val) noexcept
+	{
+		ASSERT(Contains(handle), "Invalid PairingHeap handle");
+		ASSERT(m_comp(val, m_nodes[handle].value) <= 0, "New value may not be ordered after the current value");
+		m_nodes[handle].value = Move(val);
+		if (handle == m_root)
+			return;
+
+		// The subtree of the node stays a valid heap, so it can be cut and linked with the root
+		Detach(handle);
+		m_root = Link(m_root, handle);
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Erase(Handle handle) noexcept -> bool
+	{
+		if (!Contains(handle))
+			return false;
+
+		if (handle == m_root)
+		{
+			m_root = MergePairs(m_nodes[handle].child);
+		}
+		else
+		{
+			Detach(handle);
+			const Handle subtree = MergePairs(m_nodes[handle].child);
+			if (subtree != InvalidHandle)
+				m_root = Link(m_root, subtree);
+		}
+
+		// Move the value into a temporary that is destroyed right away, so anything it owns is released now instead of when the node is reused
+		UNUSED(T(Move(m_nodes[handle].value)));
+		FreeNode(handle);
+		--m_size;
+		return true;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	void PairingHeap<T, C>::Reserve(usize capacity) noexcept
+	{
+		m_nodes.Reserve(capacity);
+	}
+
+	template <typename T, Comparator<T, T> C>
+	void PairingHeap<T, C>::Clear(bool clearMemory) noexcept
+	{
+		m_nodes.Clear(clearMemory);
+		m_root = InvalidHandle;
+		m_freeHead = InvalidHandle;
+		m_size = 0;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Top() const noexcept -> const T&
+	{
+		ASSERT(m_root != InvalidHandle, "PairingHeap is empty");
+		return m_nodes[m_root].value;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::TopHandle() const noexcept -> Handle
+	{
+		return m_root;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Get(Handle handle) const noexcept -> const T&
+	{
+		ASSERT(Contains(handle), "Invalid PairingHeap handle");
+		return m_nodes[handle].value;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Contains(Handle handle) const noexcept -> bool
+	{
+		return handle < m_nodes.Size() && m_nodes[handle].prev != handle;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Size() const noexcept -> usize
+	{
+		return m_size;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::IsEmpty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_nodes.GetAllocator();
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::AllocateNode(T&& val) noexcept -> Handle
+	{
+		if (m_freeHead != InvalidHandle)
+		{
+			const Handle handle = m_freeHead;
+			Node& node = m_nodes[handle];
+			m_freeHead = node.sibling;
+			node.value = Move(val);
+			node.child = node.sibling = node.prev = InvalidHandle;
+			return handle;
+		}
+
+		const Handle handle = Handle(m_nodes.Size());
+		ASSERT(handle != InvalidHandle, "Ran out of PairingHeap handles");
+		m_nodes.Add(Node{ Move(val), InvalidHandle, InvalidHandle, InvalidHandle });
+		return handle;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	void PairingHeap<T, C>::FreeNode(Handle handle) noexcept
+	{
+		Node& node = m_nodes[handle];
+		node.child = InvalidHandle;
+		node.sibling = m_freeHead;
+		node.prev = handle;
+		m_freeHead = handle;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::Link(Handle first, Handle second) noexcept -> Handle
+	{
+		// On a tie, the first node stays the root
+		if (m_comp(m_nodes[second].value, m_nodes[first].value) < 0)
+			Algo::Swap(first, second);
+
+		Node& parent = m_nodes[first];
+		Node& child = m_nodes[second];
+		child.sibling = parent.child;
+		child.prev = first;
+		if (parent.child != InvalidHandle)
+			m_nodes[parent.child].prev = second;
+		parent.child = second;
+		parent.sibling = parent.prev = InvalidHandle;
+		return first;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	void PairingHeap<T, C>::Detach(Handle handle) noexcept
+	{
+		Node& node = m_nodes[handle];
+		Node& prev = m_nodes[node.prev];
+		if (prev.child == handle)
+			prev.child = node.sibling;
+		else
+			prev.sibling = node.sibling;
+
+		if (node.sibling != InvalidHandle)
+			m_nodes[node.sibling].prev = node.prev;
+		node.sibling = node.prev = InvalidHandle;
+	}
+
+	template <typename T, Comparator<T, T> C>
+	auto PairingHeap<T, C>::MergePairs(Handle first) noexcept -> Handle
+	{
+		if (first == InvalidHandle)
+			return InvalidHandle;
+
+		// First pass: link siblings in pairs from left to right, chaining the results in reverse order through their sibling handle
+		Handle merged = InvalidHandle;
+		Handle cur = first;
+		while (cur != InvalidHandle)
+		{
+			const Handle a = cur;
+			const Handle b = m_nodes[a].sibling;
+			if (b == InvalidHandle)
+			{
+				m_nodes[a].prev = InvalidHandle;
+				m_nodes[a].sibling = merged;
+				merged = a;
+				break;
+			}
+
+			cur = m_nodes[b].sibling;
+			const Handle linked = Link(a, b);
+			m_nodes[linked].sibling = merged;
+			merged = linked;
+		}
+
+		// Second pass: link the pairs from right to left into a single tree
+		Handle root = merged;
+		Handle next = m_nodes[root].sibling;
+		m_nodes[root].sibling = InvalidHandle;
+		while (next != InvalidHandle)
+		{
+			const Handle tree = next;
+			next = m_nodes[tree].sibling;
+			m_nodes[tree].sibling = InvalidHandle;
+			root = Link(root, tree);
+		}
+		return root;
+	}
+}
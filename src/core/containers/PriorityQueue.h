@@ -0,0 +1,179 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "DynArray.h"
+#include "core/utils/Utils.h"
+
+namespace Onca
+{
+	/**
+	 * \brief A priority queue, implemented as an implicit d-ary heap
+	 *
+	 * The element that is ordered first by the comparator is at the top of the queue, so the default comparator results in a min-heap.
+	 * A wider heap is shallower than a binary heap, which means less cache misses on a push, at the cost of more comparisons on a pop.
+	 * 4 children per node fits a cache line for small elements and tends to be the fastest in practice.
+	 *
+	 * Each pushed element gets a handle, which can be used to update the priority (decrease-key) or erase the element in O(log n).
+	 * A handle stays valid until the element is popped or erased, after which it may be reused by a new element.
+	 *
+	 * \tparam T Element type (needs to conform to Onca::Movable)
+	 * \tparam C Comparator type
+	 * \tparam D Number of children per node
+	 */
+	template<typename T, Comparator<T, T> C = DefaultComparator<T>, u32 D = 4>
+	class PriorityQueue
+	{
+		STATIC_ASSERT(Movable<T>, "Type needs to be movable to be used in a PriorityQueue");
+		STATIC_ASSERT(D >= 2, "PriorityQueue needs at least 2 children per node");
+	public:
+		using Handle = u32;
+
+		static constexpr Handle InvalidHandle = Handle(-1); ///< Invalid handle
+
+		/**
+		 * Create an empty PriorityQueue
+		 * \param[in] alloc Allocator the container should use
+		 * \param[in] comp Comparator to order elements with
+		 */
+		explicit PriorityQueue(Alloc::IAllocator& alloc = g_GlobalAlloc, C comp = C{}) noexcept;
+		PriorityQueue(const PriorityQueue& other) noexcept requires CopyConstructible<T> = default;
+		PriorityQueue(PriorityQueue&& other) noexcept;
+
+		auto operator=(const PriorityQueue& other) noexcept -> PriorityQueue& requires CopyConstructible<T> = default;
+		auto operator=(PriorityQueue&& other) noexcept -> PriorityQueue&;
+
+		/**
+		 * Push an element into the PriorityQueue
+		 * \param[in] val Element to push
+		 * \return Handle to the element
+		 */
+		auto Push(const T& val) noexcept -> Handle requires CopyConstructible<T>;
+		/**
+		 * Push an element into the PriorityQueue
+		 * \param[in] val Element to push
+		 * \return Handle to the element
+		 */
+		auto Push(T&& val) noexcept -> Handle;
+		/**
+		 * Emplace an element into the PriorityQueue
+		 * \tparam Args Type of arguments
+		 * \param[in] args Arguments
+		 * \return Handle to the element
+		 */
+		template<typename... Args>
+			requires ConstructableFrom<T, Args...>
+		auto Emplace(Args&&... args) noexcept -> Handle;
+
+		/**
+		 * Pop the element at the top of the PriorityQueue
+		 * \return Popped element
+		 * \note Only use when the PriorityQueue is not empty
+		 */
+		auto Pop() noexcept -> T;
+		/**
+		 * Update the value of an element, moving it up or down the heap depending on its new priority
+		 * \param[in] handle Handle to the element
+		 * \param[in] val New value
+		 * \note Only use with a handle to an element in the PriorityQueue
+		 */
+		void Update(Handle handle, T&& val) noexcept;
+		/**
+		 * Erase an element from the PriorityQueue
+		 * \param[in] handle Handle to the element
+		 * \return Whether the element was erased
+		 */
+		auto Erase(Handle handle) noexcept -> bool;
+
+		/**
+		 * Reserve space for a number of elements
+		 * \param[in] capacity Number of elements to reserve space for
+		 */
+		void Reserve(usize capacity) noexcept;
+		/**
+		 * Clear the contents of the PriorityQueue
+		 * \param[in] clearMemory Whether to free the memory used by the PriorityQueue
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+
+		/**
+		 * Get the element at the top of the PriorityQueue
+		 * \return Element at the top of the PriorityQueue
+		 * \note Only use when the PriorityQueue is not empty
+		 */
+		auto Top() const noexcept -> const T&;
+		/**
+		 * Get the handle of the element at the top of the PriorityQueue
+		 * \return Handle of the element at the top of the PriorityQueue
+		 * \note Only use when the PriorityQueue is not empty
+		 */
+		auto TopHandle() const noexcept -> Handle;
+		/**
+		 * Get the element a handle refers to
+		 * \param[in] handle Handle to the element
+		 * \return Element
+		 * \note Only use with a handle to an element in the PriorityQueue
+		 */
+		auto Get(Handle handle) const noexcept -> const T&;
+		/**
+		 * Check if a handle refers to an element in the PriorityQueue
+		 * \param[in] handle Handle to check
+		 * \return Whether the handle refers to an element in the PriorityQueue
+		 */
+		auto Contains(Handle handle) const noexcept -> bool;
+
+		/**
+		 * Get the number of elements in the PriorityQueue
+		 * \return Number of elements in the PriorityQueue
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the PriorityQueue is empty
+		 * \return Whether the PriorityQueue is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+		/**
+		 * Get the allocator used by the PriorityQueue
+		 * \return Allocator used by the PriorityQueue
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		/**
+		 * Element in the heap
+		 */
+		struct Entry
+		{
+			T      value;  ///< Value
+			Handle handle; ///< Handle of the element
+		};
+
+		/**
+		 * Get a free handle
+		 * \return Handle
+		 */
+		auto AllocateHandle() noexcept -> Handle;
+		/**
+		 * Remove the element at a position in the heap and free its handle
+		 * \param[in] idx Index of the element in the heap
+		 */
+		void RemoveAt(u32 idx) noexcept;
+		/**
+		 * Move the element at a position up the heap until its parent is ordered before it
+		 * \param[in] idx Index of the element in the heap
+		 */
+		void SiftUp(u32 idx) noexcept;
+		/**
+		 * Move the element at a position down the heap until all of its children are ordered after it
+		 * \param[in] idx Index of the element in the heap
+		 */
+		void SiftDown(u32 idx) noexcept;
+
+		DynArray<Entry>     m_heap;      ///< Heap
+		DynArray<u32>       m_positions; ///< Heap index of each handle, or index of the next free handle when the handle is free
+		Handle              m_freeHead;  ///< First free handle, InvalidHandle if no handle is free
+		NO_UNIQUE_ADDRESS C m_comp;      ///< Comparator
+	};
+}
+
+#include "PriorityQueue.inl"
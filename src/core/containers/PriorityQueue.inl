@@ -0,0 +1,251 @@
+#pragma once
+#if __RESHARPER__
+#include "PriorityQueue.h"
+#endif
+
+namespace Onca
+{
+	template <typename T, Comparator<T, T> C, u32 D>
+	PriorityQueue<T, C, D>::PriorityQueue(Alloc::IAllocator& alloc, C comp) noexcept
+		: m_heap(alloc)
+		, m_positions(alloc)
+		, m_freeHead(InvalidHandle)
+		, m_comp(Move(comp))
+	{
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	PriorityQueue<T, C, D>::PriorityQueue(PriorityQueue&& other) noexcept
+		: m_heap(Move(other.m_heap))
+		, m_positions(Move(other.m_positions))
+		, m_freeHead(other.m_freeHead)
+		, m_comp(Move(other.m_comp))
+	{
+		other.m_freeHead = InvalidHandle;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::operator=(PriorityQueue&& other) noexcept -> PriorityQueue&
+	{
+		m_heap = Move(other.m_heap);
+		m_positions = Move(other.m_positions);
+		m_freeHead = other.m_freeHead;
+		m_comp = Move(other.m_comp);
+		other.m_freeHead = InvalidHandle;
+		return *this;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Push(const T& val) noexcept -> Handle requires CopyConstructible<T>
+	{
+		return Emplace(val);
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Push(T&& val) noexcept -> Handle
+	{
+		return Emplace(Move(val));
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	template <typename ... Args>
+		requires ConstructableFrom<T, Args...>
+	auto PriorityQueue<T, C, D>::Emplace(Args&&... args) noexcept -> Handle
+	{
+		const Handle handle = AllocateHandle();
+		const u32 idx = u32(m_heap.Size());
+		m_heap.Add(Entry{ T{ Forward<Args>(args)... }, handle });
+		m_positions[handle] = idx;
+		SiftUp(idx);
+		return handle;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Pop() noexcept -> T
+	{
+		ASSERT(!m_heap.IsEmpty(), "Cannot pop from an empty PriorityQueue");
+		T val = Move(m_heap[0].value);
+		RemoveAt(0);
+		return val;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	void PriorityQueue<T, C, D>::Update(Handle handle, T&& val) noexcept
+	{
+		ASSERT(Contains(handle), "Invalid PriorityQueue handle");
+		const u32 idx = m_positions[handle];
+		const i8 order = m_comp(val, m_heap[idx].value);
+		m_heap[idx].value = Move(val);
+
+		if (order < 0)
+			SiftUp(idx);
+		else if (order > 0)
+			SiftDown(idx);
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Erase(Handle handle) noexcept -> bool
+	{
+		if (!Contains(handle))
+			return false;
+		RemoveAt(m_positions[handle]);
+		return true;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	void PriorityQueue<T, C, D>::Reserve(usize capacity) noexcept
+	{
+		m_heap.Reserve(capacity);
+		m_positions.Reserve(capacity);
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	void PriorityQueue<T, C, D>::Clear(bool clearMemory) noexcept
+	{
+		m_heap.Clear(clearMemory);
+		m_positions.Clear(clearMemory);
+		m_freeHead = InvalidHandle;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Top() const noexcept -> const T&
+	{
+		ASSERT(!m_heap.IsEmpty(), "PriorityQueue is empty");
+		return m_heap[0].value;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::TopHandle() const noexcept -> Handle
+	{
+		ASSERT(!m_heap.IsEmpty(), "PriorityQueue is empty");
+		return m_heap[0].handle;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Get(Handle handle) const noexcept -> const T&
+	{
+		ASSERT(Contains(handle), "Invalid PriorityQueue handle");
+		return m_heap[m_positions[handle]].value;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Contains(Handle handle) const noexcept -> bool
+	{
+		// A free handle stores the next free handle, which can never point to a heap entry that refers back to the free handle
+		if (handle >= m_positions.Size())
+			return false;
+		const u32 idx = m_positions[handle];
+		return idx < m_heap.Size() && m_heap[idx].handle == handle;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::Size() const noexcept -> usize
+	{
+		return m_heap.Size();
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::IsEmpty() const noexcept -> bool
+	{
+		return m_heap.IsEmpty();
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_heap.GetAllocator();
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	auto PriorityQueue<T, C, D>::AllocateHandle() noexcept -> Handle
+	{
+		if (m_freeHead != InvalidHandle)
+		{
+			const Handle handle = m_freeHead;
+			m_freeHead = m_positions[handle];
+			return handle;
+		}
+
+		const Handle handle = Handle(m_positions.Size());
+		ASSERT(handle != InvalidHandle, "Ran out of PriorityQueue handles");
+		m_positions.Add(0);
+		return handle;
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	void PriorityQueue<T, C, D>::RemoveAt(u32 idx) noexcept
+	{
+		const Handle handle = m_heap[idx].handle;
+		m_positions[handle] = m_freeHead;
+		m_freeHead = handle;
+
+		// Fill the hole with the last element and restore the heap property from there
+		const u32 lastIdx = u32(m_heap.Size() - 1);
+		if (idx != lastIdx)
+		{
+			m_heap[idx] = Move(m_heap[lastIdx]);
+			m_positions[m_heap[idx].handle] = idx;
+			m_heap.Pop();
+
+			if (idx > 0 && m_comp(m_heap[idx].value, m_heap[(idx - 1) / D].value) < 0)
+				SiftUp(idx);
+			else
+				SiftDown(idx);
+		}
+		else
+		{
+			m_heap.Pop();
+		}
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	void PriorityQueue<T, C, D>::SiftUp(u32 idx) noexcept
+	{
+		// Move parents down into the hole instead of swapping, the element is only written once at its final position
+		Entry entry = Move(m_heap[idx]);
+		while (idx > 0)
+		{
+			const u32 parent = (idx - 1) / D;
+			if (m_comp(entry.value, m_heap[parent].value) >= 0)
+				break;
+
+			m_heap[idx] = Move(m_heap[parent]);
+			m_positions[m_heap[idx].handle] = idx;
+			idx = parent;
+		}
+
+		m_positions[entry.handle] = idx;
+		m_heap[idx] = Move(entry);
+	}
+
+	template <typename T, Comparator<T, T> C, u32 D>
+	void PriorityQueue<T, C, D>::SiftDown(u32 idx) noexcept
+	{
+		const u32 size = u32(m_heap.Size());
+		Entry entry = Move(m_heap[idx]);
+		while (true)
+		{
+			const u32 firstChild = idx * D + 1;
+			if (firstChild >= size)
+				break;
+
+			const u32 endChild = Math::Min(firstChild + D, size);
+			u32 best = firstChild;
+			for (u32 child = firstChild + 1; child < endChild; ++child)
+			{
+				if (m_comp(m_heap[child].value, m_heap[best].value) < 0)
+					best = child;
+			}
+
+			if (m_comp(m_heap[best].value, entry.value) >= 0)
+				break;
+
+			m_heap[idx] = Move(m_heap[best]);
+			m_positions[m_heap[idx].handle] = idx;
+			idx = best;
+		}
+
+		m_positions[entry.handle] = idx;
+		m_heap[idx] = Move(entry);
+	}
+}
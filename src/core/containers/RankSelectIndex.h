@@ -0,0 +1,74 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "allocator/GlobalAlloc.h"
+#include "BitSet.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Index over a BitSet to answer rank and select queries
+	 *
+	 * The index stores the number of set bits before each block of words, so rank only needs to count the bits inside a single block,
+	 * and select can binary search the block containing the bit, before searching inside the block.
+	 *
+	 * \note The index references the bitset and needs to be rebuilt after the bitset is modified
+	 */
+	class RankSelectIndex
+	{
+	public:
+		static constexpr usize NPos = BitSet::NPos;                                ///< Index returned when no bit could be found
+		static constexpr usize ElemsPerBlock = 8;                                  ///< Number of bitset elements covered by each block
+		static constexpr usize BitsPerBlock = ElemsPerBlock * BitSet::BitsPerElem; ///< Number of bits covered by each block
+
+		/**
+		 * Create an empty index
+		 * \param[in] alloc Allocator
+		 */
+		explicit RankSelectIndex(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create an index over a bitset
+		 * \param[in] bits Bitset
+		 * \param[in] alloc Allocator
+		 */
+		explicit RankSelectIndex(const BitSet& bits, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+
+		/**
+		 * Build the index over a bitset
+		 * \param[in] bits Bitset
+		 */
+		void Build(const BitSet& bits) noexcept;
+
+		/**
+		 * Get the number of set bits before a bit
+		 * \param[in] idx Index of the bit
+		 * \return Number of set bits in [0, idx)
+		 */
+		auto Rank(usize idx) const noexcept -> usize;
+		/**
+		 * Get the index of the n-th set bit
+		 * \param[in] n Number of set bits to skip (0 returns the first set bit)
+		 * \return Index of the n-th set bit, or NPos if less bits are set
+		 */
+		auto Select(usize n) const noexcept -> usize;
+
+		/**
+		 * Get the number of set bits in the bitset
+		 * \return Number of set bits
+		 */
+		auto Count() const noexcept -> usize;
+
+	private:
+		/**
+		 * Get the index of the n-th set bit in an element
+		 * \param[in] elem Element
+		 * \param[in] n Number of set bits to skip
+		 * \return Index of the bit in the element
+		 */
+		static auto SelectInElem(usize elem, usize n) noexcept -> usize;
+
+		const BitSet*   m_pBits;      ///< Indexed bitset
+		DynArray<usize> m_blockRanks; ///< Number of bits set before each block, with the total number of set bits at the end
+	};
+}
+
+#include "RankSelectIndex.inl"
@@ -0,0 +1,114 @@
+#pragma once
+#if __RESHARPER__
+#include "RankSelectIndex.h"
+#endif
+
+namespace Onca
+{
+	inline RankSelectIndex::RankSelectIndex(Alloc::IAllocator& alloc) noexcept
+		: m_pBits(nullptr)
+		, m_blockRanks(alloc)
+	{
+	}
+
+	inline RankSelectIndex::RankSelectIndex(const BitSet& bits, Alloc::IAllocator& alloc) noexcept
+		: m_pBits(nullptr)
+		, m_blockRanks(alloc)
+	{
+		Build(bits);
+	}
+
+	inline void RankSelectIndex::Build(const BitSet& bits) noexcept
+	{
+		m_pBits = &bits;
+
+		const usize* pData = bits.Data();
+		const usize numElems = bits.DataSize();
+		const usize numBlocks = (numElems + ElemsPerBlock - 1) / ElemsPerBlock;
+
+		m_blockRanks.Clear();
+		m_blockRanks.Reserve(numBlocks + 1);
+
+		usize rank = 0;
+		for (usize i = 0; i < numElems; ++i)
+		{
+			if (i % ElemsPerBlock == 0)
+				m_blockRanks.Add(rank);
+			rank += Intrin::PopCnt(pData[i]);
+		}
+		m_blockRanks.Add(rank);
+	}
+
+	inline auto RankSelectIndex::Rank(usize idx) const noexcept -> usize
+	{
+		if (!m_pBits)
+			return 0;
+		if (idx >= m_pBits->NumBits())
+			return Count();
+
+		const usize* pData = m_pBits->Data();
+		const usize elemIdx = idx / BitSet::BitsPerElem;
+		const usize bitIdx = idx % BitSet::BitsPerElem;
+		const usize blockIdx = elemIdx / ElemsPerBlock;
+
+		usize rank = m_blockRanks[blockIdx];
+		for (usize i = blockIdx * ElemsPerBlock; i < elemIdx; ++i)
+			rank += Intrin::PopCnt(pData[i]);
+
+		// Bits are stored from the most significant bit, so the bits before idx are the top bits of the element
+		if (bitIdx)
+			rank += Intrin::PopCnt(pData[elemIdx] >> (BitSet::BitsPerElem - bitIdx));
+		return rank;
+	}
+
+	inline auto RankSelectIndex::Select(usize n) const noexcept -> usize
+	{
+		if (n >= Count())
+			return NPos;
+
+		// Find the last block that starts with at most n bits set before it
+		usize low = 0;
+		usize high = m_blockRanks.Size() - 1;
+		while (high - low > 1)
+		{
+			const usize mid = (low + high) / 2;
+			if (m_blockRanks[mid] <= n)
+				low = mid;
+			else
+				high = mid;
+		}
+
+		n -= m_blockRanks[low];
+		const usize* pData = m_pBits->Data();
+		for (usize i = low * ElemsPerBlock, end = Math::Min(i + ElemsPerBlock, m_pBits->DataSize()); i < end; ++i)
+		{
+			const usize cnt = Intrin::PopCnt(pData[i]);
+			if (n < cnt)
+				return i * BitSet::BitsPerElem + SelectInElem(pData[i], n);
+			n -= cnt;
+		}
+		return NPos;
+	}
+
+	inline auto RankSelectIndex::Count() const noexcept -> usize
+	{
+		return m_blockRanks.IsEmpty() ? 0 : m_blockRanks.Back();
+	}
+
+	inline auto RankSelectIndex::SelectInElem(usize elem, usize n) noexcept -> usize
+	{
+		// Narrow down the bit by halving the window, keeping the window in the top bits of the element
+		usize idx = 0;
+		for (usize width = BitSet::BitsPerElem / 2; width > 0; width /= 2)
+		{
+			const usize cnt = Intrin::PopCnt(elem >> (BitSet::BitsPerElem - width));
+			if (n >= cnt)
+			{
+				n -= cnt;
+				elem <<= width;
+				idx += width;
+			}
+		}
+		return idx;
+	}
+}
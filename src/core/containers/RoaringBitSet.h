@@ -0,0 +1,180 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "allocator/GlobalAlloc.h"
+#include "core/intrin/Pack.h"
+#include "DynArray.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Compressed bitset for sparse sets of 32-bit values (Roaring bitmap)
+	 *
+	 * The values are split in chunks of 2^16 values by their upper 16 bits, each chunk that contains a value has its own container storing the lower 16 bits.
+	 * A container is either a sorted array of values, when it contains at most MaxArrayCount values, or a bitmap of 2^16 bits when it contains more.
+	 * This makes the memory used by the set proportional to the number of values, instead of the largest value, while dense chunks still use fast bitmap operations.
+	 *
+	 * \note Run-length encoded containers are not supported
+	 */
+	class RoaringBitSet
+	{
+	public:
+		static constexpr u32 MaxArrayCount = 4096;         ///< Maximum number of values stored in an array container, a bitmap container uses the same memory
+		static constexpr u32 BitmapWords = (1 << 16) / 64; ///< Number of 64-bit words in a bitmap container
+
+		/**
+		 * Create an empty RoaringBitSet
+		 * \param[in] alloc Allocator
+		 */
+		explicit RoaringBitSet(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		RoaringBitSet(const RoaringBitSet& other) noexcept = default;
+		RoaringBitSet(RoaringBitSet&& other) noexcept = default;
+
+		auto operator=(const RoaringBitSet& other) noexcept -> RoaringBitSet& = default;
+		auto operator=(RoaringBitSet&& other) noexcept -> RoaringBitSet& = default;
+
+		auto operator|=(const RoaringBitSet& other) noexcept -> RoaringBitSet&;
+		auto operator&=(const RoaringBitSet& other) noexcept -> RoaringBitSet&;
+
+		auto operator==(const RoaringBitSet& other) const noexcept -> bool;
+
+		/**
+		 * Add a value to the set
+		 * \param[in] val Value
+		 * \return Whether the value was added, false if it already was in the set
+		 */
+		auto Add(u32 val) noexcept -> bool;
+		/**
+		 * Remove a value from the set
+		 * \param[in] val Value
+		 * \return Whether the value was removed, false if it wasn't in the set
+		 */
+		auto Remove(u32 val) noexcept -> bool;
+		/**
+		 * Check if the set contains a value
+		 * \param[in] val Value
+		 * \return Whether the set contains the value
+		 */
+		auto Contains(u32 val) const noexcept -> bool;
+		/**
+		 * Clear the set
+		 * \param[in] clearMemory Whether to deallocate the memory
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+
+		/**
+		 * Count the number of values in both sets, without creating a new set
+		 * \param[in] other Other set
+		 * \return Number of values in the intersection
+		 */
+		auto AndCount(const RoaringBitSet& other) const noexcept -> usize;
+
+		/**
+		 * Call a function for each value in the set, in ascending order
+		 * \tparam F Function type
+		 * \param[in] fun Function
+		 */
+		template<Callable<void, u32> F>
+		void ForEachSetBit(F fun) const noexcept;
+
+		/**
+		 * Get the number of values in the set
+		 * \return Number of values
+		 */
+		auto Count() const noexcept -> usize;
+		/**
+		 * Check if the set is empty
+		 * \return Whether the set is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get the number of bytes used to store the values, excluding unused capacity
+		 * \return Number of bytes
+		 */
+		auto DataSize() const noexcept -> usize;
+
+		/**
+		 * Get the allocator used by the set
+		 * \return Allocator used by the set
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		/**
+		 * Container storing the lower 16 bits of the values in a chunk
+		 */
+		struct Container
+		{
+			/**
+			 * Create an empty array container
+			 * \param[in] alloc Allocator
+			 */
+			explicit Container(Alloc::IAllocator& alloc) noexcept;
+			/**
+			 * Create a copy of a container with a different allocator
+			 * \param[in] other Container to copy
+			 * \param[in] alloc Allocator
+			 */
+			Container(const Container& other, Alloc::IAllocator& alloc) noexcept;
+			Container(const Container& other) noexcept = default;
+			Container(Container&& other) noexcept = default;
+
+			auto operator=(const Container& other) noexcept -> Container& = default;
+			auto operator=(Container&& other) noexcept -> Container& = default;
+
+			/**
+			 * Check if the container is a bitmap container
+			 * \return Whether the container is a bitmap container
+			 */
+			auto IsBitmap() const noexcept -> bool { return !bits.IsEmpty(); }
+
+			DynArray<u16> values; ///< Sorted values, when the container is an array container
+			DynArray<u64> bits;   ///< Bitmap, when the container is a bitmap container, empty otherwise
+			u32           count;  ///< Number of values in the container
+		};
+
+		/**
+		 * Find the index of the first element that is not less than a value in a sorted array
+		 * \tparam T Element type
+		 * \param[in] arr Array
+		 * \param[in] val Value
+		 * \return Index of the element, or the size of the array if all elements are less than the value
+		 */
+		template<typename T>
+		static auto LowerBound(const DynArray<T>& arr, T val) noexcept -> usize;
+
+		/**
+		 * Convert an array container to a bitmap container
+		 * \param[in] container Container
+		 */
+		static void ToBitmap(Container& container) noexcept;
+		/**
+		 * Convert a bitmap container to an array container
+		 * \param[in] container Container
+		 */
+		static void ToArray(Container& container) noexcept;
+		/**
+		 * Add the values of a container to another container
+		 * \param[in] dst Container to add the values to
+		 * \param[in] src Container with the values to add
+		 */
+		static void OrInto(Container& dst, const Container& src) noexcept;
+		/**
+		 * Remove the values of a container that are not in another container
+		 * \param[in] dst Container to remove the values from
+		 * \param[in] src Container with the values to keep
+		 */
+		static void AndInto(Container& dst, const Container& src) noexcept;
+		/**
+		 * Count the values that are in both containers
+		 * \param[in] a First container
+		 * \param[in] b Second container
+		 * \return Number of values in both containers
+		 */
+		static auto AndCount(const Container& a, const Container& b) noexcept -> usize;
+
+		DynArray<u16>       m_keys;       ///< Upper 16 bits of the values in each container, sorted
+		DynArray<Container> m_containers; ///< Containers
+	};
+}
+
+#include "RoaringBitSet.inl"
@@ -0,0 +1,494 @@
+#pragma once
+#if __RESHARPER__
+#include "RoaringBitSet.h"
+#endif
+
+namespace Onca
+{
+	namespace Detail
+	{
+		using RoaringPack = Intrin::Pack<u64, 4>; ///< Pack used for bulk operations on bitmap containers
+
+		/**
+		 * Apply an operation to 2 bitmap containers and count the bits in the result
+		 * \tparam F Operation, needs to be callable with 2 packs
+		 * \param[in] pA First bitmap
+		 * \param[in] pB Second bitmap
+		 * \param[out] pDst Bitmap receiving the result, nullptr to only count the bits
+		 * \param[in] op Operation
+		 * \return Number of bits set in the result
+		 */
+		template<typename F>
+		auto RoaringBitmapOp(const u64* pA, const u64* pB, u64* pDst, F op) noexcept -> u32
+		{
+			u32 cnt = 0;
+			for (u32 i = 0; i < RoaringBitSet::BitmapWords; i += 4)
+			{
+				const RoaringPack res = op(RoaringPack::Load(pA + i), RoaringPack::Load(pB + i));
+				if (pDst)
+					res.Store(pDst + i);
+				cnt += Intrin::PopCnt(res.data.u64_[0]) + Intrin::PopCnt(res.data.u64_[1]) +
+				       Intrin::PopCnt(res.data.u64_[2]) + Intrin::PopCnt(res.data.u64_[3]);
+			}
+			return cnt;
+		}
+	}
+
+	inline RoaringBitSet::Container::Container(Alloc::IAllocator& alloc) noexcept
+		: values(alloc)
+		, bits(alloc)
+		, count(0)
+	{
+	}
+
+	inline RoaringBitSet::Container::Container(const Container& other, Alloc::IAllocator& alloc) noexcept
+		: values(other.values, alloc)
+		, bits(other.bits, alloc)
+		, count(other.count)
+	{
+	}
+
+	inline RoaringBitSet::RoaringBitSet(Alloc::IAllocator& alloc) noexcept
+		: m_keys(alloc)
+		, m_containers(alloc)
+	{
+	}
+
+	inline auto RoaringBitSet::operator|=(const RoaringBitSet& other) noexcept -> RoaringBitSet&
+	{
+		Alloc::IAllocator& alloc = *GetAllocator();
+		DynArray<u16> keys{ alloc };
+		DynArray<Container> containers{ alloc };
+		keys.Reserve(m_keys.Size() + other.m_keys.Size());
+		containers.Reserve(m_keys.Size() + other.m_keys.Size());
+
+		usize i = 0, j = 0;
+		while (i < m_keys.Size() || j < other.m_keys.Size())
+		{
+			if (j == other.m_keys.Size() || (i < m_keys.Size() && m_keys[i] < other.m_keys[j]))
+			{
+				keys.Add(m_keys[i]);
+				containers.Add(Move(m_containers[i]));
+				++i;
+			}
+			else if (i == m_keys.Size() || other.m_keys[j] < m_keys[i])
+			{
+				keys.Add(other.m_keys[j]);
+				containers.Add(Container{ other.m_containers[j], alloc });
+				++j;
+			}
+			else
+			{
+				OrInto(m_containers[i], other.m_containers[j]);
+				keys.Add(m_keys[i]);
+				containers.Add(Move(m_containers[i]));
+				++i;
+				++j;
+			}
+		}
+
+		m_keys = Move(keys);
+		m_containers = Move(containers);
+		return *this;
+	}
+
+	inline auto RoaringBitSet::operator&=(const RoaringBitSet& other) noexcept -> RoaringBitSet&
+	{
+		// Compact the containers that are left in place
+		usize write = 0;
+		usize j = 0;
+		for (usize i = 0; i < m_keys.Size(); ++i)
+		{
+			while (j < other.m_keys.Size() && other.m_keys[j] < m_keys[i])
+				++j;
+			if (j == other.m_keys.Size())
+				break;
+			if (other.m_keys[j] != m_keys[i])
+				continue;
+
+			AndInto(m_containers[i], other.m_containers[j]);
+			if (m_containers[i].count == 0)
+				continue;
+
+			if (write != i)
+			{
+				m_keys[write] = m_keys[i];
+				m_containers[write] = Move(m_containers[i]);
+			}
+			++write;
+		}
+
+		while (m_keys.Size() > write)
+		{
+			m_keys.Pop();
+			m_containers.Pop();
+		}
+		return *this;
+	}
+
+	inline auto RoaringBitSet::operator==(const RoaringBitSet& other) const noexcept -> bool
+	{
+		if (m_keys.Size() != other.m_keys.Size())
+			return false;
+
+		for (usize i = 0; i < m_keys.Size(); ++i)
+		{
+			const Container& a = m_containers[i];
+			const Container& b = other.m_containers[i];
+			if (m_keys[i] != other.m_keys[i] || a.count != b.count)
+				return false;
+
+			// Containers with the same number of values always have the same type
+			if (a.IsBitmap())
+			{
+				if (MemCmp(a.bits.Data(), b.bits.Data(), BitmapWords * sizeof(u64)) != 0)
+					return false;
+			}
+			else if (MemCmp(a.values.Data(), b.values.Data(), a.count * sizeof(u16)) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	inline auto RoaringBitSet::Add(u32 val) noexcept -> bool
+	{
+		const u16 key = u16(val >> 16);
+		const u16 low = u16(val);
+
+		const usize idx = LowerBound(m_keys, key);
+		if (idx == m_keys.Size() || m_keys[idx] != key)
+		{
+			m_keys.Insert(idx, key);
+			m_containers.Insert(idx, Container{ *GetAllocator() });
+		}
+
+		Container& container = m_containers[idx];
+		if (container.IsBitmap())
+		{
+			u64& word = container.bits[low / 64];
+			const u64 mask = u64(1) << (low % 64);
+			if (word & mask)
+				return false;
+			word |= mask;
+			++container.count;
+			return true;
+		}
+
+		const usize pos = LowerBound(container.values, low);
+		if (pos < container.values.Size() && container.values[pos] == low)
+			return false;
+
+		if (container.count < MaxArrayCount)
+		{
+			container.values.Insert(pos, low);
+		}
+		else
+		{
+			ToBitmap(container);
+			container.bits[low / 64] |= u64(1) << (low % 64);
+		}
+		++container.count;
+		return true;
+	}
+
+	inline auto RoaringBitSet::Remove(u32 val) noexcept -> bool
+	{
+		const u16 key = u16(val >> 16);
+		const u16 low = u16(val);
+
+		const usize idx = LowerBound(m_keys, key);
+		if (idx == m_keys.Size() || m_keys[idx] != key)
+			return false;
+
+		Container& container = m_containers[idx];
+		if (container.IsBitmap())
+		{
+			u64& word = container.bits[low / 64];
+			const u64 mask = u64(1) << (low % 64);
+			if (!(word & mask))
+				return false;
+			word &= ~mask;
+			if (--container.count <= MaxArrayCount)
+				ToArray(container);
+			return true;
+		}
+
+		const usize pos = LowerBound(container.values, low);
+		if (pos == container.values.Size() || container.values[pos] != low)
+			return false;
+
+		container.values.EraseAt(pos);
+		if (--container.count == 0)
+		{
+			m_keys.EraseAt(idx);
+			m_containers.EraseAt(idx);
+		}
+		return true;
+	}
+
+	inline auto RoaringBitSet::Contains(u32 val) const noexcept -> bool
+	{
+		const u16 key = u16(val >> 16);
+		const u16 low = u16(val);
+
+		const usize idx = LowerBound(m_keys, key);
+		if (idx == m_keys.Size() || m_keys[idx] != key)
+			return false;
+
+		const Container& container = m_containers[idx];
+		if (container.IsBitmap())
+			return (container.bits[low / 64] >> (low % 64)) & 1;
+
+		const usize pos = LowerBound(container.values, low);
+		return pos < container.values.Size() && container.values[pos] == low;
+	}
+
+	inline void RoaringBitSet::Clear(bool clearMemory) noexcept
+	{
+		m_keys.Clear(clearMemory);
+		m_containers.Clear(clearMemory);
+	}
+
+	inline auto RoaringBitSet::AndCount(const RoaringBitSet& other) const noexcept -> usize
+	{
+		usize cnt = 0;
+		usize i = 0, j = 0;
+		while (i < m_keys.Size() && j < other.m_keys.Size())
+		{
+			if (m_keys[i] < other.m_keys[j])
+			{
+				++i;
+			}
+			else if (other.m_keys[j] < m_keys[i])
+			{
+				++j;
+			}
+			else
+			{
+				cnt += AndCount(m_containers[i], other.m_containers[j]);
+				++i;
+				++j;
+			}
+		}
+		return cnt;
+	}
+
+	template <Callable<void, u32> F>
+	void RoaringBitSet::ForEachSetBit(F fun) const noexcept
+	{
+		for (usize i = 0; i < m_keys.Size(); ++i)
+		{
+			const u32 high = u32(m_keys[i]) << 16;
+			const Container& container = m_containers[i];
+			if (container.IsBitmap())
+			{
+				for (u32 wordIdx = 0; wordIdx < BitmapWords; ++wordIdx)
+				{
+					u64 word = container.bits[wordIdx];
+					while (word)
+					{
+						fun(high | (wordIdx * 64 + Intrin::ZeroCountLSB(word)));
+						word &= word - 1;
+					}
+				}
+			}
+			else
+			{
+				for (u16 low : container.values)
+					fun(high | low);
+			}
+		}
+	}
+
+	inline auto RoaringBitSet::Count() const noexcept -> usize
+	{
+		usize cnt = 0;
+		for (const Container& container : m_containers)
+			cnt += container.count;
+		return cnt;
+	}
+
+	inline auto RoaringBitSet::IsEmpty() const noexcept -> bool
+	{
+		return m_keys.IsEmpty();
+	}
+
+	inline auto RoaringBitSet::DataSize() const noexcept -> usize
+	{
+		usize size = m_keys.Size() * sizeof(u16) + m_containers.Size() * sizeof(Container);
+		for (const Container& container : m_containers)
+			size += container.values.Size() * sizeof(u16) + container.bits.Size() * sizeof(u64);
+		return size;
+	}
+
+	inline auto RoaringBitSet::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_keys.GetAllocator();
+	}
+
+	template <typename T>
+	auto RoaringBitSet::LowerBound(const DynArray<T>& arr, T val) noexcept -> usize
+	{
+		usize low = 0;
+		usize high = arr.Size();
+		while (low < high)
+		{
+			const usize mid = (low + high) / 2;
+			if (arr[mid] < val)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low;
+	}
+
+	inline void RoaringBitSet::ToBitmap(Container& container) noexcept
+	{
+		container.bits.Resize(BitmapWords);
+		for (u16 val : container.values)
+			container.bits[val / 64] |= u64(1) << (val % 64);
+		container.values.Clear(true);
+	}
+
+	inline void RoaringBitSet::ToArray(Container& container) noexcept
+	{
+		container.values.Clear();
+		container.values.Reserve(container.count);
+		for (u32 wordIdx = 0; wordIdx < BitmapWords; ++wordIdx)
+		{
+			u64 word = container.bits[wordIdx];
+			while (word)
+			{
+				container.values.Add(u16(wordIdx * 64 + Intrin::ZeroCountLSB(word)));
+				word &= word - 1;
+			}
+		}
+		container.bits.Clear(true);
+	}
+
+	inline void RoaringBitSet::OrInto(Container& dst, const Container& src) noexcept
+	{
+		if (src.IsBitmap())
+		{
+			if (!dst.IsBitmap())
+				ToBitmap(dst);
+			dst.count = Detail::RoaringBitmapOp(dst.bits.Data(), src.bits.Data(), dst.bits.Data(), [](const auto& a, const auto& b) { return a | b; });
+			return;
+		}
+
+		if (dst.IsBitmap())
+		{
+			for (u16 val : src.values)
+			{
+				u64& word = dst.bits[val / 64];
+				const u64 mask = u64(1) << (val % 64);
+				dst.count += !(word & mask);
+				word |= mask;
+			}
+			return;
+		}
+
+		// Merge 2 sorted arrays
+		DynArray<u16> merged{ *dst.values.GetAllocator() };
+		merged.Reserve(dst.values.Size() + src.values.Size());
+		usize i = 0, j = 0;
+		while (i < dst.values.Size() && j < src.values.Size())
+		{
+			const u16 a = dst.values[i];
+			const u16 b = src.values[j];
+			merged.Add(a < b ? a : b);
+			i += a <= b;
+			j += b <= a;
+		}
+		for (; i < dst.values.Size(); ++i)
+			merged.Add(dst.values[i]);
+		for (; j < src.values.Size(); ++j)
+			merged.Add(src.values[j]);
+
+		dst.values = Move(merged);
+		dst.count = u32(dst.values.Size());
+		if (dst.count > MaxArrayCount)
+			ToBitmap(dst);
+	}
+
+	inline void RoaringBitSet::AndInto(Container& dst, const Container& src) noexcept
+	{
+		if (dst.IsBitmap() && src.IsBitmap())
+		{
+			dst.count = Detail::RoaringBitmapOp(dst.bits.Data(), src.bits.Data(), dst.bits.Data(), [](const auto& a, const auto& b) { return a & b; });
+			if (dst.count <= MaxArrayCount)
+				ToArray(dst);
+			return;
+		}
+
+		if (dst.IsBitmap())
+		{
+			// The result is a subset of the array, so it's an array container
+			DynArray<u16> values{ *dst.values.GetAllocator() };
+			values.Reserve(src.values.Size());
+			for (u16 val : src.values)
+			{
+				if ((dst.bits[val / 64] >> (val % 64)) & 1)
+					values.Add(val);
+			}
+			dst.values = Move(values);
+			dst.bits.Clear(true);
+			dst.count = u32(dst.values.Size());
+			return;
+		}
+
+		usize write = 0;
+		if (src.IsBitmap())
+		{
+			for (u16 val : dst.values)
+			{
+				if ((src.bits[val / 64] >> (val % 64)) & 1)
+					dst.values[write++] = val;
+			}
+		}
+		else
+		{
+			usize j = 0;
+			for (usize i = 0; i < dst.values.Size() && j < src.values.Size(); ++i)
+			{
+				const u16 val = dst.values[i];
+				while (j < src.values.Size() && src.values[j] < val)
+					++j;
+				if (j < src.values.Size() && src.values[j] == val)
+					dst.values[write++] = val;
+			}
+		}
+		dst.values.Resize(write);
+		dst.count = u32(write);
+	}
+
+	inline auto RoaringBitSet::AndCount(const Container& a, const Container& b) noexcept -> usize
+	{
+		if (a.IsBitmap() && b.IsBitmap())
+			return Detail::RoaringBitmapOp(a.bits.Data(), b.bits.Data(), nullptr, [](const auto& x, const auto& y) { return x & y; });
+
+		if (a.IsBitmap() || b.IsBitmap())
+		{
+			const Container& bitmap = a.IsBitmap() ? a : b;
+			const Container& array = a.IsBitmap() ? b : a;
+			usize cnt = 0;
+			for (u16 val : array.values)
+				cnt += (bitmap.bits[val / 64] >> (val % 64)) & 1;
+			return cnt;
+		}
+
+		usize cnt = 0;
+		usize i = 0, j = 0;
+		while (i < a.values.Size() && j < b.values.Size())
+		{
+			const u16 x = a.values[i];
+			const u16 y = b.values[j];
+			cnt += x == y;
+			i += x <= y;
+			j += y <= x;
+		}
+		return cnt;
+	}
+}
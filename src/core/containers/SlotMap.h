@@ -0,0 +1,196 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "DynArray.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Container storing elements densely, referenced by generational handles
+	 *
+	 * Elements are stored in a contiguous array, so iterating them is as cheap as iterating a DynArray.
+	 * A handle stores the index of a slot and the generation of the slot when the element was inserted, the slot points to the element in the dense array.
+	 * Erasing an element moves the last element in its place and increments the generation of its slot,
+	 * so insertion, erasure and lookup are O(1), and handles to erased elements are detected instead of silently referencing another element.
+	 *
+	 * The lower half of the bits of a handle stores the slot index, the upper half stores the generation.
+	 * A handle with all bits set is never returned and can be used as an invalid handle.
+	 *
+	 * \tparam T Stored type (needs to conform to Onca::Movable)
+	 * \tparam H Handle type, u32 supports up to 65535 slots, u64 up to 2^32 - 1 slots
+	 * \note Erasing elements changes the order of the elements, and pointers to elements are invalidated by insertion and erasure
+	 * \note Generations wrap around, so a handle can become valid again after its slot was reused 2^(bits in H / 2) times
+	 */
+	template<typename T, UnsignedIntegral H = u32>
+	class SlotMap
+	{
+		STATIC_ASSERT(Movable<T>, "Type needs to be movable to be used in a SlotMap");
+		STATIC_ASSERT(sizeof(H) >= sizeof(u32), "Handle needs to be at least 32-bits");
+	public:
+		using Handle = H;
+		using Iterator = T*;
+		using ConstIterator = const T*;
+
+		static constexpr u8 IndexBits = sizeof(H) * 4;                     ///< Number of bits in a handle used by the slot index
+		static constexpr H  IndexMask = (H(1) << IndexBits) - 1;           ///< Mask for the slot index in a handle
+		static constexpr H  InvalidHandle = H(-1);                         ///< Invalid handle
+		static constexpr H  MaxSlots = IndexMask;                          ///< Maximum number of slots, the last index is reserved for the invalid handle
+
+		/**
+		 * Create a SlotMap
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit SlotMap(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		SlotMap(const SlotMap& other) noexcept requires CopyConstructible<T> = default;
+		SlotMap(SlotMap&& other) noexcept;
+
+		auto operator=(const SlotMap& other) noexcept -> SlotMap& requires CopyConstructible<T> = default;
+		auto operator=(SlotMap&& other) noexcept -> SlotMap&;
+
+		/**
+		 * Insert an element into the SlotMap
+		 * \param[in] val Value to insert
+		 * \return Handle to the element, or InvalidHandle if no slot is available
+		 */
+		auto Insert(const T& val) noexcept -> H requires CopyConstructible<T>;
+		/**
+		 * Insert an element into the SlotMap
+		 * \param[in] val Value to insert
+		 * \return Handle to the element, or InvalidHandle if no slot is available
+		 */
+		auto Insert(T&& val) noexcept -> H;
+		/**
+		 * Emplace an element into the SlotMap
+		 * \tparam Args Types of the arguments
+		 * \param[in] args Arguments
+		 * \return Handle to the element, or InvalidHandle if no slot is available
+		 */
+		template<typename... Args>
+			requires ConstructableFrom<T, Args...>
+		auto Emplace(Args&&... args) noexcept -> H;
+
+		/**
+		 * Erase an element from the SlotMap
+		 * \param[in] handle Handle to the element
+		 * \return Whether an element was erased, false if the handle is invalid or stale
+		 */
+		auto Erase(H handle) noexcept -> bool;
+		/**
+		 * Clear the contents of the SlotMap, invalidating all handles
+		 * \param[in] clearMemory Whether to deallocate the memory
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+		/**
+		 * Reserve space for a number of elements
+		 * \param[in] newCap New capacity
+		 */
+		void Reserve(usize newCap) noexcept;
+
+		/**
+		 * Get the element a handle refers to
+		 * \param[in] handle Handle
+		 * \return Pointer to the element, nullptr if the handle is invalid or stale
+		 */
+		auto Get(H handle) noexcept -> T*;
+		/**
+		 * Get the element a handle refers to
+		 * \param[in] handle Handle
+		 * \return Pointer to the element, nullptr if the handle is invalid or stale
+		 */
+		auto Get(H handle) const noexcept -> const T*;
+		/**
+		 * Check if a handle refers to an element in the SlotMap
+		 * \param[in] handle Handle
+		 * \return Whether the handle refers to an element
+		 */
+		auto Contains(H handle) const noexcept -> bool;
+
+		/**
+		 * Get the element at an index in the dense array
+		 * \param[in] idx Index
+		 * \return Element
+		 */
+		auto GetValueAt(usize idx) noexcept -> T&;
+		/**
+		 * Get the element at an index in the dense array
+		 * \param[in] idx Index
+		 * \return Element
+		 */
+		auto GetValueAt(usize idx) const noexcept -> const T&;
+		/**
+		 * Get the handle of the element at an index in the dense array
+		 * \param[in] idx Index
+		 * \return Handle
+		 */
+		auto GetHandleAt(usize idx) const noexcept -> H;
+
+		/**
+		 * Get the number of elements in the SlotMap
+		 * \return Number of elements
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the SlotMap is empty
+		 * \return Whether the SlotMap is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+		/**
+		 * Get the allocator used by the SlotMap
+		 * \return Allocator used by the SlotMap
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+		/**
+		 * Get the slot index stored in a handle
+		 * \param[in] handle Handle
+		 * \return Slot index
+		 */
+		static constexpr auto GetIndex(H handle) noexcept -> H { return handle & IndexMask; }
+		/**
+		 * Get the generation stored in a handle
+		 * \param[in] handle Handle
+		 * \return Generation
+		 */
+		static constexpr auto GetGeneration(H handle) noexcept -> H { return handle >> IndexBits; }
+
+		auto Begin() noexcept -> Iterator;
+		auto Begin() const noexcept -> ConstIterator;
+		auto End() noexcept -> Iterator;
+		auto End() const noexcept -> ConstIterator;
+
+		auto begin() noexcept -> Iterator;
+		auto begin() const noexcept -> ConstIterator;
+		auto end() noexcept -> Iterator;
+		auto end() const noexcept -> ConstIterator;
+
+	private:
+		/**
+		 * Slot referencing an element
+		 */
+		struct Slot
+		{
+			H denseIdx;   ///< Index of the element in the dense array, or index of the next free slot when the slot is free
+			H generation; ///< Generation of the slot, incremented when its element is erased
+		};
+
+		/**
+		 * Allocate a slot for an element that will be added to the back of the dense array
+		 * \return Handle, or InvalidHandle if no slot is available
+		 */
+		auto AllocateSlot() noexcept -> H;
+		/**
+		 * Get the index in the dense array for a handle
+		 * \param[in] handle Handle
+		 * \return Index in the dense array, or InvalidHandle if the handle is invalid or stale
+		 */
+		auto GetDenseIdx(H handle) const noexcept -> H;
+
+		DynArray<T>    m_values;      ///< Elements
+		DynArray<H>    m_denseSlots;  ///< Slot index of each element
+		DynArray<Slot> m_slots;       ///< Slots
+		H              m_freeHead;    ///< First free slot, InvalidHandle if no slot is free
+	};
+}
+
+#include "SlotMap.inl"
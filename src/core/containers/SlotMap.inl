@@ -0,0 +1,255 @@
+#pragma once
+#if __RESHARPER__
+#include "SlotMap.h"
+#endif
+
+namespace Onca
+{
+	template <typename T, UnsignedIntegral H>
+	SlotMap<T, H>::SlotMap(Alloc::IAllocator& alloc) noexcept
+		: m_values(alloc)
+		, m_denseSlots(alloc)
+		, m_slots(alloc)
+		, m_freeHead(InvalidHandle)
+	{
+	}
+
+	template <typename T, UnsignedIntegral H>
+	SlotMap<T, H>::SlotMap(SlotMap&& other) noexcept
+		: m_values(Move(other.m_values))
+		, m_denseSlots(Move(other.m_denseSlots))
+		, m_slots(Move(other.m_slots))
+		, m_freeHead(other.m_freeHead)
+	{
+		other.m_freeHead = InvalidHandle;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::operator=(SlotMap&& other) noexcept -> SlotMap&
+	{
+		m_values = Move(other.m_values);
+		m_denseSlots = Move(other.m_denseSlots);
+		m_slots = Move(other.m_slots);
+		m_freeHead = other.m_freeHead;
+		other.m_freeHead = InvalidHandle;
+		return *this;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Insert(const T& val) noexcept -> H requires CopyConstructible<T>
+	{
+		return Emplace(val);
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Insert(T&& val) noexcept -> H
+	{
+		return Emplace(Move(val));
+	}
+
+	template <typename T, UnsignedIntegral H>
+	template <typename ... Args>
+		requires ConstructableFrom<T, Args...>
+	auto SlotMap<T, H>::Emplace(Args&&... args) noexcept -> H
+	{
+		const H handle = AllocateSlot();
+		if (handle == InvalidHandle) UNLIKELY
+			return InvalidHandle;
+
+		m_values.EmplaceBack(Forward<Args>(args)...);
+		m_denseSlots.Add(GetIndex(handle));
+		return handle;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Erase(H handle) noexcept -> bool
+	{
+		const H denseIdx = GetDenseIdx(handle);
+		if (denseIdx == InvalidHandle)
+			return false;
+
+		// Move the last element into the hole, so the elements stay contiguous
+		const H lastIdx = H(m_values.Size() - 1);
+		if (denseIdx != lastIdx)
+		{
+			m_values[denseIdx] = Move(m_values[lastIdx]);
+			m_denseSlots[denseIdx] = m_denseSlots[lastIdx];
+			m_slots[m_denseSlots[denseIdx]].denseIdx = denseIdx;
+		}
+		m_values.Pop();
+		m_denseSlots.Pop();
+
+		const H slotIdx = GetIndex(handle);
+		Slot& slot = m_slots[slotIdx];
+		slot.generation = (slot.generation + 1) & IndexMask;
+		slot.denseIdx = m_freeHead;
+		m_freeHead = slotIdx;
+		return true;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	void SlotMap<T, H>::Clear(bool clearMemory) noexcept
+	{
+		// Slots are kept to bump their generations, so handles from before the clear stay invalid
+		for (H idx : m_denseSlots)
+		{
+			Slot& slot = m_slots[idx];
+			slot.generation = (slot.generation + 1) & IndexMask;
+			slot.denseIdx = m_freeHead;
+			m_freeHead = idx;
+		}
+
+		m_values.Clear(clearMemory);
+		m_denseSlots.Clear(clearMemory);
+	}
+
+	template <typename T, UnsignedIntegral H>
+	void SlotMap<T, H>::Reserve(usize newCap) noexcept
+	{
+		m_values.Reserve(newCap);
+		m_denseSlots.Reserve(newCap);
+		m_slots.Reserve(newCap);
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Get(H handle) noexcept -> T*
+	{
+		const H denseIdx = GetDenseIdx(handle);
+		return denseIdx == InvalidHandle ? nullptr : m_values.Data() + denseIdx;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Get(H handle) const noexcept -> const T*
+	{
+		const H denseIdx = GetDenseIdx(handle);
+		return denseIdx == InvalidHandle ? nullptr : m_values.Data() + denseIdx;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Contains(H handle) const noexcept -> bool
+	{
+		return GetDenseIdx(handle) != InvalidHandle;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::GetValueAt(usize idx) noexcept -> T&
+	{
+		ASSERT(idx < m_values.Size(), "Index out of range");
+		return m_values[idx];
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::GetValueAt(usize idx) const noexcept -> const T&
+	{
+		ASSERT(idx < m_values.Size(), "Index out of range");
+		return m_values[idx];
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::GetHandleAt(usize idx) const noexcept -> H
+	{
+		ASSERT(idx < m_values.Size(), "Index out of range");
+		const H slotIdx = m_denseSlots[idx];
+		return (m_slots[slotIdx].generation << IndexBits) | slotIdx;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Size() const noexcept -> usize
+	{
+		return m_values.Size();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::IsEmpty() const noexcept -> bool
+	{
+		return m_values.IsEmpty();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_values.GetAllocator();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Begin() noexcept -> Iterator
+	{
+		return m_values.Data();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::Begin() const noexcept -> ConstIterator
+	{
+		return m_values.Data();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::End() noexcept -> Iterator
+	{
+		return m_values.Data() + m_values.Size();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::End() const noexcept -> ConstIterator
+	{
+		return m_values.Data() + m_values.Size();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::begin() noexcept -> Iterator
+	{
+		return Begin();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::begin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::end() noexcept -> Iterator
+	{
+		return End();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::end() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::AllocateSlot() noexcept -> H
+	{
+		if (m_freeHead != InvalidHandle)
+		{
+			const H slotIdx = m_freeHead;
+			Slot& slot = m_slots[slotIdx];
+			m_freeHead = slot.denseIdx;
+			slot.denseIdx = H(m_values.Size());
+			return (slot.generation << IndexBits) | slotIdx;
+		}
+
+		if (m_slots.Size() >= MaxSlots) UNLIKELY
+			return InvalidHandle;
+
+		const H slotIdx = H(m_slots.Size());
+		m_slots.Add(Slot{ H(m_values.Size()), 0 });
+		return slotIdx;
+	}
+
+	template <typename T, UnsignedIntegral H>
+	auto SlotMap<T, H>::GetDenseIdx(H handle) const noexcept -> H
+	{
+		const H slotIdx = GetIndex(handle);
+		if (slotIdx >= m_slots.Size())
+			return InvalidHandle;
+
+		// A free slot stores a free list link instead of a dense index, so also check that the element points back to the slot
+		const Slot& slot = m_slots[slotIdx];
+		if (slot.generation != GetGeneration(handle) || slot.denseIdx >= m_values.Size() || m_denseSlots[slot.denseIdx] != slotIdx)
+			return InvalidHandle;
+		return slot.denseIdx;
+	}
+}
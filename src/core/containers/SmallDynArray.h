@@ -0,0 +1,598 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "core/allocator/IAllocator.h"
+#include "core/allocator/ContainerAlloc.h"
+
+namespace Onca
+{
+
+	/**
+	 * Dynamically sized array, which stores a small number of elements inline and only allocates memory when it grows past that
+	 * \tparam T Stored type (needs to conform to Onca::Movable)
+	 * \tparam N Number of elements stored inline
+	 * \note Iterators are invalidated after certain container modifications
+	 * \note Moving a SmallDynArray only takes ownership of the memory when its elements are stored in allocated memory, inline elements are moved one by one
+	 */
+	template<typename T, usize N>
+	class SmallDynArray
+	{
+		// static assert to get around incomplete type issues when a class can return a SmallDynArray of itself
+		STATIC_ASSERT(Movable<T>, "Type needs to be moveable to be used in a SmallDynArray");
+		STATIC_ASSERT(N > 0, "A SmallDynArray needs to store at least 1 element inline");
+	public:
+		using Iterator = T*;
+		using ConstIterator = const T* const;
+
+		/**
+		 * Create a SmallDynArray with an allocator
+		 * \param[in] alloc Allocator the container should use when the elements don't fit inline
+		 */
+		explicit SmallDynArray(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create a SmallDynArray with a capacity and an allocator
+		 * \param[in] capacity Capacity of the array
+		 * \param[in] alloc Allocator the container should use when the elements don't fit inline
+		 */
+		explicit SmallDynArray(usize capacity, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create a SmallDynArray filled with a number of elements
+		 * \param[in] count Number of elements to create
+		 * \param[in] val Value of elements
+		 * \param[in] alloc Allocator the container should use when the elements don't fit inline
+		 */
+		explicit SmallDynArray(usize count, const T& val, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept requires CopyConstructible<T>;
+		/**
+		 * Create a SmallDynArray from an initializer list
+		 * \param[in] il Initializer list with elements
+		 * \param[in] alloc Allocator the container should use when the elements don't fit inline
+		 */
+		explicit SmallDynArray(const InitializerList<T>& il, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept requires CopyConstructible<T>;
+		/**
+		 * Create a SmallDynArray from an iterable range
+		 * \tparam It Iterator type
+		 * \param[in] begin Begin iterator
+		 * \param[in] end End iterator
+		 * \param[in] alloc Allocator the container should use when the elements don't fit inline
+		 */
+		template<ForwardIterator It>
+		explicit SmallDynArray(const It& begin, const It& end, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept requires CopyConstructible<T>;
+		/**
+		 * Create a SmallDynArray with the contents of another SmallDynArray
+		 * \param[in] other SmallDynArray to copy
+		 */
+		SmallDynArray(const SmallDynArray& other) noexcept requires CopyConstructible<T>;
+		/**
+		 * Create a SmallDynArray with the contents of another SmallDynArray, but with a different allocator
+		 * \param[in] other SmallDynArray to copy
+		 * \param[in] alloc Allocator the container should use when the elements don't fit inline
+		 */
+		explicit SmallDynArray(const SmallDynArray& other, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>;
+		/**
+		 * Move another SmallDynArray into a new SmallDynArray
+		 * \param[in] other SmallDynArray to move from
+		 */
+		SmallDynArray(SmallDynArray&& other) noexcept;
+		/**
+		 * Move another SmallDynArray into a new SmallDynArray, but with a different allocator
+		 * \param[in] other SmallDynArray to move from
+		 * \param[in] alloc Allocator the container should use when the elements don't fit inline
+		 * \note Allocated memory is only taken over when both SmallDynArrays use the same allocator
+		 */
+		SmallDynArray(SmallDynArray&& other, Alloc::IAllocator& alloc) noexcept;
+		~SmallDynArray() noexcept;
+
+		auto operator=(const InitializerList<T>& il) noexcept -> SmallDynArray& requires CopyConstructible<T>;
+		auto operator=(const SmallDynArray& other) noexcept -> SmallDynArray& requires CopyConstructible<T>;
+		auto operator=(SmallDynArray&& other) noexcept -> SmallDynArray&;
+
+		/**
+		 * Assign an iterable range to the SmallDynArray
+		 * \tparam It Iterator type
+		 * \param[in] begin Begin iterator
+		 * \param[in] end End iterator
+		 */
+		template<ForwardIterator It>
+		void Assign(const It& begin, const It& end) noexcept requires CopyConstructible<T>;
+		/**
+		 * Assign an initializer list to the SmallDynArray
+		 * \param[in] il Initializer list with elements
+		 */
+		void Assign(const InitializerList<T>& il) noexcept requires CopyConstructible<T>;
+
+		/**
+		 * Fill the SmallDynArray with a number of elements
+		 * \param[in] count Number of elements to fill
+		 * \param[in] val Value to fill elements with
+		 */
+		void Fill(usize count, const T& val) noexcept requires CopyConstructible<T>;
+		/**
+		 * Fill the SmallDynArray with a number of elements with a default value (via placement new)
+		 * \param[in] count Number of elements to fill
+		 */
+		void FillDefault(usize count) noexcept requires NoThrowDefaultConstructible<T>;
+
+		/**
+		 * Reserve additional space in the SmallDynArray
+		 * \param[in] newCap New capacity
+		 * \note Memory is only allocated when the new capacity is larger than N
+		 */
+		void Reserve(usize newCap) noexcept;
+		/**
+		 * Resize the SmallDynArray and fill missing elements if needed
+		 * \param[in] newSize New size of the SmallDynArray
+		 * \param[in] val Value to fill missing elements with
+		 */
+		void Resize(usize newSize, const T& val) noexcept requires CopyConstructible<T>;
+		/**
+		 * Resize the SmallDynArray and fill missing elements with a default value (via placement new) if needed
+		 * \param[in] newSize New size of the SmallDynArray
+		 */
+		void Resize(usize newSize) noexcept requires NoThrowDefaultConstructible<T>;
+		/**
+		 * Shrink the memory used by the SmallDynArray to the minimum needed, moving the elements back inline when they fit
+		 */
+		void ShrinkToFit() noexcept;
+
+		/**
+		 * Add an element to the SmallDynArray
+		 * \param[in] val Element to add
+		 */
+		void Add(const T& val) noexcept requires CopyConstructible<T>;
+		/**
+		 * Add an element to the SmallDynArray
+		 * \param[in] val Element to add
+		 */
+		void Add(T&& val) noexcept;
+		/**
+		 * Add the contents of a SmallDynArray to the SmallDynArray
+		 * \param[in] other SmallDynArray to add
+		 */
+		void Add(const SmallDynArray& other) requires CopyConstructible<T>;
+		/**
+		 * Add the contents of a SmallDynArray to the SmallDynArray
+		 * \param[in] other SmallDynArray to add
+		 */
+		void Add(SmallDynArray&& other);
+
+		/**
+		 * Add a unique element to the SmallDynArray (only add when not in the SmallDynArray)
+		 * \param[in] val Element to add
+		 * \return Whether the value was added
+		 */
+		auto AddUnique(const T& val) noexcept -> bool requires CopyConstructible<T>;
+		/**
+		 * Add a unique element to the SmallDynArray (only add when not in the SmallDynArray)
+		 * \param[in] val Element to add
+		 * \return Whether the value was added
+		 */
+		auto AddUnique(T&& val) noexcept -> bool;
+
+		/**
+		 * Emplace an element at the back of the SmallDynArray
+		 * \tparam Args Type of arguments
+		 * \param[in] args Arguments
+		 */
+		template<typename ...Args>
+			requires ConstructableFrom<T, Args...>
+		void EmplaceBack(Args&&... args) noexcept;
+
+		/**
+		 * Insert an element in a certain location
+		 * \param[in] it Iterator to position to insert the element at
+		 * \param[in] val Element to insert
+		 * \return Iterator to inserted element
+		 */
+		auto Insert(ConstIterator& it, const T& val) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert an element in a certain location
+		 * \param[in] it Iterator to position to insert the element at
+		 * \param[in] val Element to insert
+		 * \return Iterator to inserted element
+		 */
+		auto Insert(ConstIterator& it, T&& val) noexcept -> Iterator;
+		/**
+		 * Insert a number of elements in the SmallDynArray
+		 * \param[in] it Iterator to position to insert elements at
+		 * \param[in] count Number of elements to insert
+		 * \param[in] val Value of elements to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(ConstIterator& it, usize count, const T& val) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert an iterable range into the SmallDynArray
+		 * \tparam It Iterator type
+		 * \param[in] it Iterator to position to insert elements at
+		 * \param[in] begin Begin iterator
+		 * \param[in] end End iterator
+		 * \return Iterator to the first element that was inserted
+		 */
+		template<ForwardIterator It>
+		auto Insert(ConstIterator& it, const It& begin, const It& end) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert an initializer list into the SmallDynArray
+		 * \param[in] it Iterator to position to insert elements at
+		 * \param[in] il Initializer list to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(ConstIterator& it, const InitializerList<T>& il) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert a SmallDynArray into the SmallDynArray
+		 * \param[in] it Iterator to position to insert elements at
+		 * \param[in] other SmallDynArray to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(ConstIterator& it, const SmallDynArray& other) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert a SmallDynArray into the SmallDynArray
+		 * \param[in] it Iterator to position to insert elements at
+		 * \param[in] other SmallDynArray to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(ConstIterator& it, SmallDynArray&& other) noexcept -> Iterator;
+
+		/**
+		 * Insert an element in a certain location
+		 * \param[in] idx Index to insert the element at
+		 * \param[in] val Element to insert
+		 * \return Iterator to inserted element
+		 */
+		auto Insert(usize idx, const T& val) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert an element in a certain location
+		 * \param[in] idx Index to insert the element at
+		 * \param[in] val Element to insert
+		 * \return Iterator to inserted element
+		 */
+		auto Insert(usize idx, T&& val) noexcept -> Iterator;
+		/**
+		 * Insert a number of elements in the SmallDynArray
+		 * \param[in] idx Index to insert elements at
+		 * \param[in] count Number of elements to insert
+		 * \param[in] val Value of elements to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(usize idx, usize count, const T& val) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert an iterable range into the SmallDynArray
+		 * \tparam It Iterator type
+		 * \param[in] idx Index to insert elements at
+		 * \param[in] begin Begin iterator
+		 * \param[in] end End iterator
+		 * \return Iterator to the first element that was inserted
+		 */
+		template<ForwardIterator It>
+		auto Insert(usize idx, const It& begin, const It& end) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert an initializer list into the SmallDynArray
+		 * \param[in] idx Index to insert elements at
+		 * \param[in] il Initializer list to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(usize idx, const InitializerList<T>& il) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert a SmallDynArray into the SmallDynArray
+		 * \param[in] idx Index to insert elements at
+		 * \param[in] other SmallDynArray to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(usize idx, const SmallDynArray& other) noexcept -> Iterator requires CopyConstructible<T>;
+		/**
+		 * Insert a SmallDynArray into the SmallDynArray
+		 * \param[in] idx Index to insert elements at
+		 * \param[in] other SmallDynArray to insert
+		 * \return Iterator to the first element that was inserted
+		 */
+		auto Insert(usize idx, SmallDynArray&& other) noexcept -> Iterator;
+
+		/**
+		 * Emplace an element into the SmallDynArray
+		 * \tparam Args Type of arguments
+		 * \param[in] it Iterator to position to insert elements at
+		 * \param[in] args Arguments
+		 */
+		template<typename ...Args>
+			requires ConstructableFrom<T, Args...>
+		auto Emplace(ConstIterator& it, Args&&... args) noexcept -> Iterator;
+
+		/**
+		 * Clear the contents of the SmallDynArray, possibly also deallocate the memory
+		 * \param[in] clearMemory Whether to deallocate the memory, the SmallDynArray will store its elements inline again
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+		/**
+		 * Remove the last element from the SmallDynArray
+		 */
+		void Pop() noexcept;
+		/**
+		 * Erase an element from the SmallDynArray
+		 * \param[in] it Iterator to element to erase
+		 */
+		void Erase(ConstIterator& it) noexcept;
+		/**
+		 * Erase a number of elements from the SmallDynArray
+		 * \param[in] it Iterator to first element to erase
+		 * \param[in] count Number of elements to erase
+		 */
+		void Erase(ConstIterator& it, usize count) noexcept;
+		/**
+		 * Erase a range of elements from the SmallDynArray
+		 * \param[in] begin Iterator to first element to erase
+		 * \param[in] end Iterator to last element to erase
+		 */
+		void Erase(ConstIterator& begin, ConstIterator& end) noexcept;
+		/**
+		 * Remove all occurrences that are equal to a given value from the SmallDynArray
+		 * \tparam U Type to compare with
+		 * \param[in] val Value to remove
+		 * \param[in] onlyFirst Whether to only remove the first occurrence of the value
+		 */
+		template<EqualComparable<T> U>
+		void Erase(const U& val, bool onlyFirst = false) noexcept;
+		/**
+		 * Erase all elements for which the functor returns true
+		 * \tparam F Functor type
+		 * \param[in] fun Functor
+		 */
+		template<Callable<bool, const T&> F>
+		void EraseIf(F fun) noexcept;
+		/**
+		 * Erase an element at a given index from the SmallDynArray
+		 * \param[in] idx Index
+		 */
+		void EraseAt(usize idx) noexcept;
+		/**
+		 * Erase a number of element at a given index from the SmallDynArray
+		 * \param[in] idx Index
+		 * \param[in] count Number of elements to erase
+		 */
+		void EraseAt(usize idx, usize count) noexcept;
+
+		/**
+		 * Move the element out of the SmallDynArray and erase the invalid data at its iterator
+		 * \param[in] it Iterator to element
+		 * \return Extracted element
+		 */
+		auto Extract(ConstIterator& it) noexcept -> T;
+		/**
+		 * Move the element out of the SmallDynArray and erase the invalid data at its iterator
+		 * \param[in] idx index of the element
+		 * \return Extracted element
+		 */
+		auto Extract(usize idx) noexcept -> T;
+
+		/**
+		 * Find the first element that matches the looked for value
+		 * \tparam U Type to compare with
+		 * \param[in] value Value to find
+		 * \return Iterator to the found element
+		 */
+		template<EqualComparable<T> U>
+		auto Find(const U& value) noexcept -> Iterator;
+		/**
+		 * Find the first element that matches the looked for value
+		 * \tparam U Type to compare with
+		 * \param[in] value Value to find
+		 * \return Iterator to the found element
+		 */
+		template<EqualComparable<T> U>
+		auto Find(const U& value) const noexcept -> ConstIterator;
+		/**
+		 * Find the first element where the functor returns true
+		 * \tparam F Functor type
+		 * \param[in] fun Functor
+		 * \return Iterator to the found element
+		 */
+		template<Callable<bool, const T&> F>
+		auto FindIf(F fun) noexcept -> Iterator;
+		/**
+		 * Find the first element where the functor returns true
+		 * \tparam F Functor type
+		 * \param[in] fun Functor
+		 * \return Iterator to the found element
+		 */
+		template<Callable<bool, const T&> F>
+		auto FindIf(F fun) const noexcept -> ConstIterator;
+
+		/**
+		 * Check if the SmallDynArray contains a value
+		 * \tparam U Type to compare with
+		 * \param[in] value Value to find
+		 * \return Whether the SmallDynArray contains the value
+		 */
+		template<EqualComparable<T> U>
+		auto Contains(const U& value) const noexcept -> bool;
+		/**
+		 * Check if the SmallDynArray contains a value where the functor returns true
+		 * \tparam F Functor type
+		 * \param[in] fun Functor
+		 * \return Whether the SmallDynArray contains the value
+		 */
+		template<Callable<bool, const T&> F>
+		auto ContainsIf(F fun) const noexcept -> bool;
+
+		/**
+		 * Get the element at an index
+		 * \param[in] idx Index of element
+		 * \return Optional with value
+		 * \note Will return an empty optional when index is out of bounds
+		 */
+		auto At(usize idx) const noexcept -> Optional<T>;
+		/**
+		 * Get an iterator to the element at an index
+		 * \param[in] idx Index to get iterator to
+		 * \return Iterator to element at idx
+		 */
+		auto IteratorAt(usize idx) noexcept -> Iterator;
+		/**
+		 * Get an iterator to the element at an index
+		 * \param[in] idx Index to get iterator to
+		 * \return Iterator to element at idx
+		 */
+		auto IteratorAt(usize idx) const noexcept -> ConstIterator;
+
+		/**
+		 * Get the element at an index
+		 * \param[in] idx Index of element
+		 * \return Element at index
+		 * \note Only use when certain the index is not out of bounds
+		 */
+		auto operator[](usize idx) noexcept -> T&;
+		/**
+		 * Get the element at an index
+		 * \param[in] idx Index of element
+		 * \return Element at index
+		 * \note Only use when certain the index is not out of bounds
+		 */
+		auto operator[](usize idx) const noexcept -> const T&;
+
+		/**
+		 * Get the size of the SmallDynArray
+		 * \return Size of the SmallDynArray
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Get the capacity of the SmallDynArray
+		 * \return Capacity of the SmallDynArray
+		 */
+		auto Capacity() const noexcept -> usize;
+		/**
+		 * Check if the SmallDynArray is empty
+		 * \return Whether the SmallDynArray is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Check if the elements are stored inline
+		 * \return Whether the elements are stored inline
+		 */
+		auto IsInline() const noexcept -> bool;
+		/**
+		 * Get a pointer to the SmallDynArray's data
+		 * \return Pointer to the SmallDynArray's data
+		 */
+		auto Data() noexcept -> T*;
+		/**
+		 * Get a pointer to the SmallDynArray's data
+		 * \return Pointer to the SmallDynArray's data
+		 */
+		auto Data() const noexcept -> const T*;
+
+		/**
+		 * Get the allocator used by the SmallDynArray
+		 * \return Allocator used by the SmallDynArray
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+		/**
+		 * Get the first element in the SmallDynArray
+		 * \return First element in the SmallDynArray
+		 * \note Only use when the SmallDynArray is not empty
+		 */
+		auto Front() noexcept -> T&;
+		/**
+		 * Get the first element in the SmallDynArray
+		 * \return First element in the SmallDynArray
+		 * \note Only use when the SmallDynArray is not empty
+		 */
+		auto Front() const noexcept -> const T&;
+		/**
+		 * Get the last element in the SmallDynArray
+		 * \return Last element in the SmallDynArray
+		 * \note Only use when the SmallDynArray is not empty
+		 */
+		auto Back() noexcept -> T&;
+		/**
+		 * Get the last element in the SmallDynArray
+		 * \return Last element in the SmallDynArray
+		 * \note Only use when the SmallDynArray is not empty
+		 */
+		auto Back() const noexcept -> const T&;
+
+		/**
+		 * Get an iterator to the first element
+		 * \return Iterator to the first element
+		 */
+		auto Begin() noexcept -> Iterator;
+		/**
+		 * Get an iterator to the first element
+		 * \return Iterator to the first element
+		 */
+		auto Begin() const noexcept -> ConstIterator;
+
+		/**
+		 * Get an iterator to the end of the elements
+		 * \return Iterator to the end of the elements
+		 */
+		auto End() noexcept -> Iterator;
+		/**
+		 * Get an iterator to the end of the elements
+		 * \return Iterator to the end of the elements
+		 */
+		auto End() const noexcept -> ConstIterator;
+
+		/**
+		 * Get a reverse Reverse iterator to the first element
+		 * \return Reverse iterator to the first element
+		 */
+		auto RBegin() noexcept -> Iterator;
+		/**
+		 * Get a reverse Reverse iterator to the first element
+		 * \return Reverse iterator to the first element
+		 */
+		auto RBegin() const noexcept -> ConstIterator;
+
+		/**
+		 * Get a reverse Reverse iterator to the end of the elements
+		 * \return Reverse iterator to the end of the elements
+		 */
+		auto REnd() noexcept -> Iterator;
+		/**
+		 * Get a reverse Reverse iterator to the end of the elements
+		 * \return Reverse iterator to the end of the elements
+		 */
+		auto REnd() const noexcept -> ConstIterator;
+
+		// Overloads for 'for ( ... : ... )'
+		auto begin() noexcept -> Iterator;
+		auto begin() const noexcept -> ConstIterator;
+		auto cbegin() const noexcept -> ConstIterator;
+		auto end() noexcept -> Iterator;
+		auto end() const noexcept -> ConstIterator;
+		auto cend() const noexcept -> ConstIterator;
+
+	private:
+
+		auto InsertEnd(T&& val) noexcept -> Iterator;
+		auto PrepareInsert(usize offset, usize count) noexcept -> Iterator;
+		/**
+		 * Move elements to a new location and destroy the original elements, the ranges may overlap
+		 * \param[in] pSrc Elements to move
+		 * \param[in] pDst Location to move the elements to
+		 * \param[in] count Number of elements
+		 */
+		static void Relocate(T* pSrc, T* pDst, usize count) noexcept;
+		/**
+		 * Take over the elements of another SmallDynArray, the SmallDynArray needs to be empty and store its elements inline
+		 * \param[in] other SmallDynArray to take the elements from
+		 */
+		void Steal(SmallDynArray& other) noexcept;
+		/**
+		 * Get the alignment of the allocated memory
+		 * \return Alignment of the allocated memory
+		 */
+		static constexpr auto GetAlign() noexcept -> u16;
+
+		alignas(T) u8         m_inline[N * sizeof(T)]; ///< Inline storage
+		CompactMemRef<T>      m_mem;                   ///< Managed memory, only valid when the elements don't fit inline
+		Alloc::ContainerAlloc m_alloc;                 ///< Allocator
+		usize                 m_size;                  ///< Size of the SmallDynArray
+		usize                 m_capacity;              ///< Capacity of the SmallDynArray, N while the elements are stored inline
+	};
+
+	// Elements are accessed via their offset in the inline storage, so no pointers into the array are stored
+	template<typename T, usize N>
+	constexpr bool IsTriviallyRelocatable<SmallDynArray<T, N>> = TriviallyRelocatable<T>;
+
+}
+
+#include "SmallDynArray.inl"
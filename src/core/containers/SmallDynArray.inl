@@ -0,0 +1,890 @@
+#pragma once
+#if __RESHARPER__
+#include "SmallDynArray.h"
+#endif
+
+namespace Onca
+{
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(Alloc::IAllocator& alloc) noexcept
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(usize capacity, Alloc::IAllocator& alloc) noexcept
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		Reserve(capacity);
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(usize count, const T& val, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		Fill(count, val);
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(const InitializerList<T>& il, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		Assign(il);
+	}
+
+	template <typename T, usize N>
+	template <ForwardIterator It>
+	SmallDynArray<T, N>::SmallDynArray(const It& begin, const It& end, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		Assign(begin, end);
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(const SmallDynArray& other) noexcept requires CopyConstructible<T>
+		: m_mem()
+		, m_alloc(other.m_alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		Assign(other.Begin(), other.End());
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(const SmallDynArray& other, Alloc::IAllocator& alloc) noexcept requires CopyConstructible<T>
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		Assign(other.Begin(), other.End());
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(SmallDynArray&& other) noexcept
+		: m_mem()
+		, m_alloc(other.m_alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		Steal(other);
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::SmallDynArray(SmallDynArray&& other, Alloc::IAllocator& alloc) noexcept
+		: m_mem()
+		, m_alloc(alloc)
+		, m_size(0)
+		, m_capacity(N)
+	{
+		if (m_alloc == other.m_alloc)
+		{
+			Steal(other);
+			return;
+		}
+
+		Reserve(other.m_size);
+		Relocate(other.Data(), Data(), other.m_size);
+		m_size = other.m_size;
+		other.m_size = 0;
+		other.Clear(true);
+	}
+
+	template <typename T, usize N>
+	SmallDynArray<T, N>::~SmallDynArray() noexcept
+	{
+		Clear(true);
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::operator=(const InitializerList<T>& il) noexcept -> SmallDynArray& requires CopyConstructible<T>
+	{
+		Assign(il);
+		return *this;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::operator=(const SmallDynArray& other) noexcept -> SmallDynArray& requires CopyConstructible<T>
+	{
+		if (this != &other)
+			Assign(other.Begin(), other.End());
+		return *this;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::operator=(SmallDynArray&& other) noexcept -> SmallDynArray&
+	{
+		if (this != &other)
+		{
+			Clear(true);
+			m_alloc = other.m_alloc;
+			Steal(other);
+		}
+		return *this;
+	}
+
+	template <typename T, usize N>
+	template <ForwardIterator It>
+	void SmallDynArray<T, N>::Assign(const It& begin, const It& end) noexcept requires CopyConstructible<T>
+	{
+		Clear();
+		Reserve(CountElems(begin, end));
+
+		T* pData = Data();
+		for (It it = begin; it != end; ++it, ++m_size)
+			new (pData + m_size) T{ *it };
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Assign(const InitializerList<T>& il) noexcept requires CopyConstructible<T>
+	{
+		Assign(il.begin(), il.end());
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Fill(usize count, const T& val) noexcept requires CopyConstructible<T>
+	{
+		Clear();
+		Resize(count, val);
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::FillDefault(usize count) noexcept requires NoThrowDefaultConstructible<T>
+	{
+		Clear();
+		Resize(count);
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Reserve(usize newCap) noexcept
+	{
+		if (m_capacity >= newCap)
+			return;
+
+		// Capacity increases in 1.5x steps, starting from the inline capacity
+		usize cap = m_capacity;
+		while (cap < newCap)
+			cap = (cap << 1) - (cap >> 1);
+
+		if (!IsInline())
+		{
+			if (m_alloc.TryExpandInPlace(m_mem, m_capacity, cap, GetAlign()))
+			{
+				m_capacity = cap;
+				return;
+			}
+
+			if constexpr (TriviallyRelocatable<T>)
+			{
+				if (m_alloc.Reallocate(m_mem, m_capacity, cap, GetAlign()))
+				{
+					m_capacity = cap;
+					return;
+				}
+			}
+		}
+
+		CompactMemRef<T> mem = m_alloc.template Allocate<T>(cap, GetAlign());
+		ASSERT(mem, "Failed to allocate memory");
+		Relocate(Data(), mem.Ptr(), m_size);
+		if (!IsInline())
+			m_alloc.Deallocate(Move(m_mem), m_capacity, GetAlign());
+		m_mem = Move(mem);
+		m_capacity = cap;
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Resize(usize newSize, const T& val) noexcept requires CopyConstructible<T>
+	{
+		if (newSize < m_size)
+		{
+			T* pBegin = Data();
+			for (T* it = pBegin + newSize, *end = pBegin + m_size; it != end; ++it)
+				it->~T();
+		}
+		else
+		{
+			Reserve(newSize);
+			T* pBegin = Data();
+			for (T* it = pBegin + m_size, *end = pBegin + newSize; it != end; ++it)
+				new (it) T{ val };
+		}
+		m_size = newSize;
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Resize(usize newSize) noexcept requires NoThrowDefaultConstructible<T>
+	{
+		if (newSize < m_size)
+		{
+			T* pBegin = Data();
+			for (T* it = pBegin + newSize, *end = pBegin + m_size; it != end; ++it)
+				it->~T();
+		}
+		else
+		{
+			Reserve(newSize);
+			T* pBegin = Data();
+			if constexpr (IsPrimitive<T>)
+			{
+				MemClear(pBegin + m_size, (newSize - m_size) * sizeof(T));
+			}
+			else
+			{
+				for (T* it = pBegin + m_size, *end = pBegin + newSize; it != end; ++it)
+					new (it) T{};
+			}
+		}
+		m_size = newSize;
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::ShrinkToFit() noexcept
+	{
+		if (IsInline() || m_capacity == m_size)
+			return;
+
+		if (m_size <= N)
+		{
+			Relocate(m_mem.Ptr(), reinterpret_cast<T*>(m_inline), m_size);
+			m_alloc.Deallocate(Move(m_mem), m_capacity, GetAlign());
+			m_capacity = N;
+			return;
+		}
+
+		if constexpr (TriviallyRelocatable<T>)
+		{
+			if (m_alloc.Reallocate(m_mem, m_capacity, m_size, GetAlign()))
+			{
+				m_capacity = m_size;
+				return;
+			}
+		}
+
+		CompactMemRef<T> mem = m_alloc.template Allocate<T>(m_size, GetAlign());
+		ASSERT(mem, "Failed to allocate memory");
+		Relocate(m_mem.Ptr(), mem.Ptr(), m_size);
+		m_alloc.Deallocate(Move(m_mem), m_capacity, GetAlign());
+		m_mem = Move(mem);
+		m_capacity = m_size;
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Add(const T& val) noexcept requires CopyConstructible<T>
+	{
+		InsertEnd(Move(T{ val }));
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Add(T&& val) noexcept
+	{
+		InsertEnd(Move(val));
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Add(const SmallDynArray& other) requires CopyConstructible<T>
+	{
+		Insert(m_size, other.Begin(), other.End());
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Add(SmallDynArray&& other)
+	{
+		Insert(m_size, Move(other));
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::AddUnique(const T& val) noexcept -> bool requires CopyConstructible<T>
+	{
+		if (!Contains(val))
+		{
+			Add(val);
+			return true;
+		}
+		return false;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::AddUnique(T&& val) noexcept -> bool
+	{
+		if (!Contains(val))
+		{
+			Add(Move(val));
+			return true;
+		}
+		return false;
+	}
+
+	template <typename T, usize N>
+	template <typename ... Args>
+		requires ConstructableFrom<T, Args...>
+	void SmallDynArray<T, N>::EmplaceBack(Args&&... args) noexcept
+	{
+		InsertEnd(Move(T{ Forward<Args>(args)... }));
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(ConstIterator& it, const T& val) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Emplace(it, val);
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(ConstIterator& it, T&& val) noexcept -> Iterator
+	{
+		return Emplace(it, Move(val));
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(ConstIterator& it, usize count, const T& val) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		const usize offset = usize(it - Data());
+		ASSERT(offset <= m_size, "Iterator out of range");
+
+		Iterator loc = PrepareInsert(offset, count);
+		for (usize i = 0; i < count; ++i)
+			new (loc + i) T{ val };
+		return loc;
+	}
+
+	template <typename T, usize N>
+	template <ForwardIterator It>
+	auto SmallDynArray<T, N>::Insert(ConstIterator& it, const It& begin, const It& end) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		const usize offset = usize(it - Data());
+		ASSERT(offset <= m_size, "Iterator out of range");
+
+		Iterator loc = PrepareInsert(offset, CountElems(begin, end));
+		Iterator dst = loc;
+		for (It curIt = begin; curIt != end; ++curIt, ++dst)
+			new (dst) T{ *curIt };
+		return loc;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(ConstIterator& it, const InitializerList<T>& il) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Insert(it, il.begin(), il.end());
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(ConstIterator& it, const SmallDynArray& other) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Insert(it, other.Begin(), other.End());
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(ConstIterator& it, SmallDynArray&& other) noexcept -> Iterator
+	{
+		const usize offset = usize(it - Data());
+		ASSERT(offset <= m_size, "Iterator out of range");
+
+		Iterator loc = PrepareInsert(offset, other.m_size);
+		Relocate(other.Data(), loc, other.m_size);
+		other.m_size = 0;
+		other.Clear(true);
+		return loc;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(usize idx, const T& val) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Insert(IteratorAt(idx), val);
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(usize idx, T&& val) noexcept -> Iterator
+	{
+		return Insert(IteratorAt(idx), Move(val));
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(usize idx, usize count, const T& val) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Insert(IteratorAt(idx), count, val);
+	}
+
+	template <typename T, usize N>
+	template <ForwardIterator It>
+	auto SmallDynArray<T, N>::Insert(usize idx, const It& begin, const It& end) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Insert(IteratorAt(idx), begin, end);
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(usize idx, const InitializerList<T>& il) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Insert(IteratorAt(idx), il);
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(usize idx, const SmallDynArray& other) noexcept -> Iterator requires CopyConstructible<T>
+	{
+		return Insert(IteratorAt(idx), other);
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Insert(usize idx, SmallDynArray&& other) noexcept -> Iterator
+	{
+		return Insert(IteratorAt(idx), Move(other));
+	}
+
+	template <typename T, usize N>
+	template <typename ... Args>
+		requires ConstructableFrom<T, Args...>
+	auto SmallDynArray<T, N>::Emplace(ConstIterator& it, Args&&... args) noexcept -> Iterator
+	{
+		const usize offset = usize(it - Data());
+		ASSERT(offset <= m_size, "Iterator out of range");
+
+		Iterator loc = PrepareInsert(offset, 1);
+		new (loc) T{ Forward<Args>(args)... };
+		return loc;
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Clear(bool clearMemory) noexcept
+	{
+		if constexpr (!TriviallyCopyable<T>)
+		{
+			T* pBegin = Data();
+			for (T* it = pBegin, *end = pBegin + m_size; it != end; ++it)
+				it->~T();
+		}
+		m_size = 0;
+
+		if (clearMemory && !IsInline())
+		{
+			m_alloc.Deallocate(Move(m_mem), m_capacity, GetAlign());
+			m_capacity = N;
+		}
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Pop() noexcept
+	{
+		ASSERT(m_size, "Cannot pop from an empty SmallDynArray");
+		--m_size;
+		(Data() + m_size)->~T();
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Erase(ConstIterator& it) noexcept
+	{
+		Erase(it, 1);
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Erase(ConstIterator& it, usize count) noexcept
+	{
+		T* pData = Data();
+		const usize offset = usize(it - pData);
+		ASSERT(offset <= m_size, "Iterator out of range");
+		count = Math::Min(count, m_size - offset);
+
+		T* pErase = pData + offset;
+		for (T* pIt = pErase, *pEnd = pErase + count; pIt != pEnd; ++pIt)
+			pIt->~T();
+
+		Relocate(pErase + count, pErase, m_size - offset - count);
+		m_size -= count;
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Erase(ConstIterator& begin, ConstIterator& end) noexcept
+	{
+		Erase(begin, usize(end - begin));
+	}
+
+	template <typename T, usize N>
+	template <EqualComparable<T> U>
+	void SmallDynArray<T, N>::Erase(const U& val, bool onlyFirst) noexcept
+	{
+		if (onlyFirst)
+		{
+			auto it = Find(val);
+			if (it != End())
+				Erase(it);
+		}
+		else
+		{
+			EraseIf([&val](const T& elem) { return elem == val; });
+		}
+	}
+
+	template <typename T, usize N>
+	template <Callable<bool, const T&> F>
+	void SmallDynArray<T, N>::EraseIf(F fun) noexcept
+	{
+		for (auto it = Begin(); it != End();)
+		{
+			if (fun(*it))
+				Erase(it);
+			else
+				++it;
+		}
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::EraseAt(usize idx) noexcept
+	{
+		Erase(IteratorAt(idx), 1);
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::EraseAt(usize idx, usize count) noexcept
+	{
+		Erase(IteratorAt(idx), count);
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Extract(ConstIterator& it) noexcept -> T
+	{
+		T* pData = Data();
+		const usize offset = usize(it - pData);
+		ASSERT(offset < m_size, "Iterator out of range");
+
+		T val = Move(pData[offset]);
+		pData[offset].~T();
+		Relocate(pData + offset + 1, pData + offset, m_size - offset - 1);
+		--m_size;
+		return val;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Extract(usize idx) noexcept -> T
+	{
+		return Extract(IteratorAt(idx));
+	}
+
+	template <typename T, usize N>
+	template <EqualComparable<T> U>
+	auto SmallDynArray<T, N>::Find(const U& value) noexcept -> Iterator
+	{
+		return FindIf([&value](const T& elem) { return elem == value; });
+	}
+
+	template <typename T, usize N>
+	template <EqualComparable<T> U>
+	auto SmallDynArray<T, N>::Find(const U& value) const noexcept -> ConstIterator
+	{
+		return FindIf([&value](const T& elem) { return elem == value; });
+	}
+
+	template <typename T, usize N>
+	template <Callable<bool, const T&> F>
+	auto SmallDynArray<T, N>::FindIf(F fun) noexcept -> Iterator
+	{
+		for (auto it = Begin(), end = End(); it != end; ++it)
+		{
+			if (fun(*it))
+				return it;
+		}
+		return End();
+	}
+
+	template <typename T, usize N>
+	template <Callable<bool, const T&> F>
+	auto SmallDynArray<T, N>::FindIf(F fun) const noexcept -> ConstIterator
+	{
+		for (auto it = Begin(), end = End(); it != end; ++it)
+		{
+			if (fun(*it))
+				return it;
+		}
+		return End();
+	}
+
+	template <typename T, usize N>
+	template <EqualComparable<T> U>
+	auto SmallDynArray<T, N>::Contains(const U& value) const noexcept -> bool
+	{
+		return Find(value) != End();
+	}
+
+	template <typename T, usize N>
+	template <Callable<bool, const T&> F>
+	auto SmallDynArray<T, N>::ContainsIf(F fun) const noexcept -> bool
+	{
+		return FindIf(fun) != End();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::At(usize idx) const noexcept -> Optional<T>
+	{
+		if (idx < m_size) LIKELY
+			return Data()[idx];
+		return NullOpt;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::IteratorAt(usize idx) noexcept -> Iterator
+	{
+		FREQ_ASSERT(idx <= m_size, "Index out of range");
+		return Data() + idx;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::IteratorAt(usize idx) const noexcept -> ConstIterator
+	{
+		FREQ_ASSERT(idx <= m_size, "Index out of range");
+		return Data() + idx;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::operator[](usize idx) noexcept -> T&
+	{
+		FREQ_ASSERT(idx < m_size, "Index out of range");
+		return Data()[idx];
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::operator[](usize idx) const noexcept -> const T&
+	{
+		FREQ_ASSERT(idx < m_size, "Index out of range");
+		return Data()[idx];
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Size() const noexcept -> usize
+	{
+		return m_size;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Capacity() const noexcept -> usize
+	{
+		return m_capacity;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::IsEmpty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::IsInline() const noexcept -> bool
+	{
+		// Allocated memory always has a larger capacity than the inline storage
+		return m_capacity == N;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Data() noexcept -> T*
+	{
+		return IsInline() ? reinterpret_cast<T*>(m_inline) : m_mem.Ptr();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Data() const noexcept -> const T*
+	{
+		return IsInline() ? reinterpret_cast<const T*>(m_inline) : m_mem.Ptr();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_alloc.Get();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Front() noexcept -> T&
+	{
+		ASSERT(m_size, "Invalid when SmallDynArray is empty");
+		return Data()[0];
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Front() const noexcept -> const T&
+	{
+		ASSERT(m_size, "Invalid when SmallDynArray is empty");
+		return Data()[0];
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Back() noexcept -> T&
+	{
+		ASSERT(m_size, "Invalid when SmallDynArray is empty");
+		return Data()[m_size - 1];
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Back() const noexcept -> const T&
+	{
+		ASSERT(m_size, "Invalid when SmallDynArray is empty");
+		return Data()[m_size - 1];
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Begin() noexcept -> Iterator
+	{
+		return Data();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::Begin() const noexcept -> ConstIterator
+	{
+		return Data();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::End() noexcept -> Iterator
+	{
+		return Data() + m_size;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::End() const noexcept -> ConstIterator
+	{
+		return Data() + m_size;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::RBegin() noexcept -> Iterator
+	{
+		return End();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::RBegin() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::REnd() noexcept -> Iterator
+	{
+		return Begin();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::REnd() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::begin() noexcept -> Iterator
+	{
+		return Begin();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::begin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::cbegin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::end() noexcept -> Iterator
+	{
+		return End();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::end() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::cend() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::InsertEnd(T&& val) noexcept -> Iterator
+	{
+		Reserve(m_size + 1);
+		T* loc = Data() + m_size;
+		new (loc) T{ Move(val) };
+		++m_size;
+		return loc;
+	}
+
+	template <typename T, usize N>
+	auto SmallDynArray<T, N>::PrepareInsert(usize offset, usize count) noexcept -> Iterator
+	{
+		Reserve(m_size + count);
+
+		Iterator from = Data() + offset;
+		Relocate(from, from + count, m_size - offset);
+		m_size += count;
+		return from;
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Relocate(T* pSrc, T* pDst, usize count) noexcept
+	{
+		if (count == 0 || pSrc == pDst)
+			return;
+
+		if constexpr (TriviallyRelocatable<T>)
+		{
+			MemMove(pDst, pSrc, count * sizeof(T));
+		}
+		else if (pDst < pSrc)
+		{
+			for (usize i = 0; i < count; ++i)
+			{
+				new (pDst + i) T{ Move(pSrc[i]) };
+				pSrc[i].~T();
+			}
+		}
+		else
+		{
+			for (usize i = count; i-- > 0;)
+			{
+				new (pDst + i) T{ Move(pSrc[i]) };
+				pSrc[i].~T();
+			}
+		}
+	}
+
+	template <typename T, usize N>
+	void SmallDynArray<T, N>::Steal(SmallDynArray& other) noexcept
+	{
+		ASSERT(m_size == 0 && IsInline(), "SmallDynArray needs to be empty and inline to steal the elements of another SmallDynArray");
+		if (other.IsInline())
+		{
+			Relocate(other.Data(), Data(), other.m_size);
+		}
+		else
+		{
+			m_mem = Move(other.m_mem);
+			m_capacity = other.m_capacity;
+			other.m_capacity = N;
+		}
+		m_size = other.m_size;
+		other.m_size = 0;
+	}
+
+	template <typename T, usize N>
+	constexpr auto SmallDynArray<T, N>::GetAlign() noexcept -> u16
+	{
+		return u16(Math::Max<usize>(8, alignof(T)));
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "DynArray.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Set of integer ids, mapping each id to an index in a dense array
+	 *
+	 * The set stores the ids contiguously in a dense array, and a sparse array, indexed by id, stores the index of each id in the dense array.
+	 * Insertion, erasure and lookup are O(1), and iterating the ids only touches the dense array.
+	 * Erasing an id moves the last id in its place, data stored in parallel to the dense array should do the same, see Erase().
+	 *
+	 * \tparam I Id type
+	 * \note The sparse array grows to the largest id that was inserted, so the set is meant for small ids, like indices or the index part of a SlotMap handle
+	 */
+	template<UnsignedIntegral I = u32>
+	class SparseSet
+	{
+	public:
+		using Iterator = const I*;
+		using ConstIterator = const I*;
+
+		static constexpr I InvalidIndex = I(-1); ///< Index returned for ids that are not in the set
+
+		/**
+		 * Create a SparseSet
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit SparseSet(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+
+		/**
+		 * Insert an id into the set
+		 * \param[in] id Id
+		 * \return Whether the id was inserted, false if it was already in the set
+		 */
+		auto Insert(I id) noexcept -> bool;
+		/**
+		 * Erase an id from the set, moving the last id into its index
+		 * \param[in] id Id
+		 * \return Index the id was at, which now contains the id that was the last id, or InvalidIndex if the id was not in the set
+		 */
+		auto Erase(I id) noexcept -> I;
+		/**
+		 * Clear the set
+		 * \param[in] clearMemory Whether to deallocate the memory
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+		/**
+		 * Reserve space for a number of ids
+		 * \param[in] numIds Number of ids in the dense array
+		 * \param[in] maxId Largest id that is expected to be inserted
+		 */
+		void Reserve(usize numIds, I maxId) noexcept;
+
+		/**
+		 * Check if the set contains an id
+		 * \param[in] id Id
+		 * \return Whether the set contains the id
+		 */
+		auto Contains(I id) const noexcept -> bool;
+		/**
+		 * Get the index of an id in the dense array
+		 * \param[in] id Id
+		 * \return Index of the id, or InvalidIndex if the id is not in the set
+		 */
+		auto IndexOf(I id) const noexcept -> I;
+		/**
+		 * Get the id at an index in the dense array
+		 * \param[in] idx Index
+		 * \return Id
+		 */
+		auto GetIdAt(usize idx) const noexcept -> I;
+
+		/**
+		 * Get the number of ids in the set
+		 * \return Number of ids
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the set is empty
+		 * \return Whether the set is empty
+		 */
+		auto IsEmpty() const noexcept -> bool;
+
+		auto Begin() const noexcept -> ConstIterator;
+		auto End() const noexcept -> ConstIterator;
+
+		auto begin() const noexcept -> ConstIterator;
+		auto end() const noexcept -> ConstIterator;
+
+	private:
+		DynArray<I> m_dense;  ///< Ids
+		DynArray<I> m_sparse; ///< Index in the dense array for each id, the entries of ids not in the set are undefined
+	};
+}
+
+#include "SparseSet.inl"
@@ -0,0 +1,116 @@
+#pragma once
+#if __RESHARPER__
+#include "SparseSet.h"
+#endif
+
+namespace Onca
+{
+	template <UnsignedIntegral I>
+	SparseSet<I>::SparseSet(Alloc::IAllocator& alloc) noexcept
+		: m_dense(alloc)
+		, m_sparse(alloc)
+	{
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::Insert(I id) noexcept -> bool
+	{
+		if (Contains(id))
+			return false;
+
+		if (id >= m_sparse.Size())
+			m_sparse.Resize(usize(id) + 1, InvalidIndex);
+
+		m_sparse[id] = I(m_dense.Size());
+		m_dense.Add(id);
+		return true;
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::Erase(I id) noexcept -> I
+	{
+		const I idx = IndexOf(id);
+		if (idx == InvalidIndex)
+			return InvalidIndex;
+
+		const I lastId = m_dense.Back();
+		m_dense[idx] = lastId;
+		m_sparse[lastId] = idx;
+		m_dense.Pop();
+		return idx;
+	}
+
+	template <UnsignedIntegral I>
+	void SparseSet<I>::Clear(bool clearMemory) noexcept
+	{
+		m_dense.Clear(clearMemory);
+		m_sparse.Clear(clearMemory);
+	}
+
+	template <UnsignedIntegral I>
+	void SparseSet<I>::Reserve(usize numIds, I maxId) noexcept
+	{
+		m_dense.Reserve(numIds);
+		m_sparse.Reserve(usize(maxId) + 1);
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::Contains(I id) const noexcept -> bool
+	{
+		return IndexOf(id) != InvalidIndex;
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::IndexOf(I id) const noexcept -> I
+	{
+		if (id >= m_sparse.Size())
+			return InvalidIndex;
+
+		// Entries of erased ids are left behind, so the id is only in the set when the dense array points back to it
+		const I idx = m_sparse[id];
+		return idx < m_dense.Size() && m_dense[idx] == id ? idx : InvalidIndex;
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::GetIdAt(usize idx) const noexcept -> I
+	{
+		ASSERT(idx < m_dense.Size(), "Index out of range");
+		return m_dense[idx];
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::Size() const noexcept -> usize
+	{
+		return m_dense.Size();
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::IsEmpty() const noexcept -> bool
+	{
+		return m_dense.IsEmpty();
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::Begin() const noexcept -> ConstIterator
+	{
+		return m_dense.Data();
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::End() const noexcept -> ConstIterator
+	{
+		return m_dense.Data() + m_dense.Size();
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::begin() const noexcept -> ConstIterator
+	{
+		return Begin();
+	}
+
+	template <UnsignedIntegral I>
+	auto SparseSet<I>::end() const noexcept -> ConstIterator
+	{
+		return End();
+	}
+}
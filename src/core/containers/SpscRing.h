@@ -0,0 +1,91 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/math/MathUtils.h"
+#include "core/utils/Atomic.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Bounded single producer, single consumer ring buffer (lock-free)
+	 *
+	 * One thread can push elements while another thread pops them, without any locks.
+	 * The producer and the consumer each keep a cached copy of the other side's index, so they only touch each other's cache line when the ring looks full or empty.
+	 *
+	 * \tparam T Stored type (needs to conform to Onca::Movable)
+	 * \tparam N Capacity, needs to be a power of 2
+	 * \note Only a single thread may push and only a single thread may pop at any time
+	 */
+	template<typename T, usize N>
+	class SpscRing
+	{
+		STATIC_ASSERT(Movable<T>, "Type needs to be movable to be used in an SpscRing");
+		STATIC_ASSERT(Math::IsPowOf2(N), "Capacity needs to be a power of 2");
+	public:
+		SpscRing() noexcept;
+		~SpscRing() noexcept;
+
+		DISABLE_COPY(SpscRing);
+		DISABLE_MOVE(SpscRing);
+
+		/**
+		 * Try to push an element into the ring (producer only)
+		 * \param[in] val Element to push
+		 * \return Whether the element was pushed, false if the ring is full
+		 */
+		auto TryPush(const T& val) noexcept -> bool requires CopyConstructible<T>;
+		/**
+		 * Try to push an element into the ring (producer only)
+		 * \param[in] val Element to push
+		 * \return Whether the element was pushed, false if the ring is full
+		 */
+		auto TryPush(T&& val) noexcept -> bool;
+		/**
+		 * Try to construct an element in place at the end of the ring (producer only)
+		 * \tparam Args Types of the arguments
+		 * \param[in] args Arguments
+		 * \return Whether the element was pushed, false if the ring is full
+		 */
+		template<typename... Args>
+		auto TryEmplace(Args&&... args) noexcept -> bool;
+
+		/**
+		 * Try to pop the element at the front of the ring (consumer only)
+		 * \return Popped element, or nothing if the ring is empty
+		 */
+		auto TryPop() noexcept -> Optional<T>;
+
+		/**
+		 * Get the number of elements in the ring
+		 * \return Number of elements in the ring
+		 * \note The size is only an approximation when the ring is being used by other threads
+		 */
+		auto SizeApprox() const noexcept -> usize;
+		/**
+		 * Check if the ring is empty
+		 * \return Whether the ring is empty
+		 * \note The result is only an approximation when the ring is being used by other threads
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get the capacity of the ring
+		 * \return Capacity of the ring
+		 */
+		static constexpr auto Capacity() noexcept -> usize { return N; }
+
+	private:
+		/**
+		 * Get the slot of an index
+		 * \param[in] idx Index
+		 * \return Slot
+		 */
+		auto GetSlot(usize idx) noexcept -> T*;
+
+		alignas(64) Atomic<usize> m_head;                      ///< Index of the next element to push, written by the producer
+		usize                     m_cachedTail;                ///< Tail as last seen by the producer
+		alignas(64) Atomic<usize> m_tail;                      ///< Index of the next element to pop, written by the consumer
+		usize                     m_cachedHead;                ///< Head as last seen by the consumer
+		alignas(64) alignas(T) u8 m_data[N * sizeof(T)];       ///< Element storage
+	};
+}
+
+#include "SpscRing.inl"
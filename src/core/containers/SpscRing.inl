@@ -0,0 +1,91 @@
+#pragma once
+#if __RESHARPER__
+#include "SpscRing.h"
+#endif
+
+namespace Onca
+{
+	template <typename T, usize N>
+	SpscRing<T, N>::SpscRing() noexcept
+		: m_head(0)
+		, m_cachedTail(0)
+		, m_tail(0)
+		, m_cachedHead(0)
+	{
+	}
+
+	template <typename T, usize N>
+	SpscRing<T, N>::~SpscRing() noexcept
+	{
+		const usize head = m_head.Load(MemOrder::Relaxed);
+		for (usize idx = m_tail.Load(MemOrder::Relaxed); idx != head; ++idx)
+			GetSlot(idx)->~T();
+	}
+
+	template <typename T, usize N>
+	auto SpscRing<T, N>::TryPush(const T& val) noexcept -> bool requires CopyConstructible<T>
+	{
+		return TryEmplace(val);
+	}
+
+	template <typename T, usize N>
+	auto SpscRing<T, N>::TryPush(T&& val) noexcept -> bool
+	{
+		return TryEmplace(Move(val));
+	}
+
+	template <typename T, usize N>
+	template <typename ... Args>
+	auto SpscRing<T, N>::TryEmplace(Args&&... args) noexcept -> bool
+	{
+		const usize head = m_head.Load(MemOrder::Relaxed);
+		if (head - m_cachedTail == N)
+		{
+			m_cachedTail = m_tail.Load(MemOrder::Acquire);
+			if (head - m_cachedTail == N)
+				return false;
+		}
+
+		new (GetSlot(head)) T{ Forward<Args>(args)... };
+		m_head.Store(head + 1, MemOrder::Release);
+		return true;
+	}
+
+	template <typename T, usize N>
+	auto SpscRing<T, N>::TryPop() noexcept -> Optional<T>
+	{
+		const usize tail = m_tail.Load(MemOrder::Relaxed);
+		if (tail == m_cachedHead)
+		{
+			m_cachedHead = m_head.Load(MemOrder::Acquire);
+			if (tail == m_cachedHead)
+				return NullOpt;
+		}
+
+		T* pSlot = GetSlot(tail);
+		Optional<T> val{ Move(*pSlot) };
+		pSlot->~T();
+		m_tail.Store(tail + 1, MemOrder::Release);
+		return val;
+	}
+
+	template <typename T, usize N>
+	auto SpscRing<T, N>::SizeApprox() const noexcept -> usize
+	{
+		const usize tail = m_tail.Load(MemOrder::Acquire);
+		const usize head = m_head.Load(MemOrder::Acquire);
+		return head - tail;
+	}
+
+	template <typename T, usize N>
+	auto SpscRing<T, N>::IsEmpty() const noexcept -> bool
+	{
+		return SizeApprox() == 0;
+	}
+
+	template <typename T, usize N>
+	auto SpscRing<T, N>::GetSlot(usize idx) noexcept -> T*
+	{
+		return reinterpret_cast<T*>(m_data) + (idx & (N - 1));
+	}
+}
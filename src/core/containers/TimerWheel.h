@@ -0,0 +1,204 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "core/chrono/DeltaTime.h"
+#include "DynArray.h"
+
+namespace Onca
+{
+	/**
+	 * \brief A hierarchical timer wheel
+	 *
+	 * Time is divided in ticks of a fixed length. Timers are stored in intrusive lists in 4 levels of 256 slots each, where a slot on level n covers 256^n ticks.
+	 * A timer is put on the lowest level that can hold its remaining time, and timers are moved down a level each time the wheel below a level wraps around.
+	 * This makes scheduling and cancelling a timer O(1), while advancing the wheel only touches the slots that are due, independent of the number of timers.
+ * Ticks on which no slot can be due, because the levels below them are empty, are skipped, so advancing a sparse wheel by a long time stays cheap.
+	 * The wheel covers 2^32 ticks, timers that are scheduled further into the future are kept on the last level until they are in range.
+	 *
+	 * Timers fire on the tick their delay is rounded to, so the tick length determines the resolution of the timers.
+	 * Timers that expire on the same tick fire in no particular order.
+	 *
+	 * \tparam T Payload type (needs to conform to Onca::Movable)
+	 */
+	template<typename T>
+	class TimerWheel
+	{
+		STATIC_ASSERT(Movable<T>, "Type needs to be movable to be used in a TimerWheel");
+	public:
+		using Handle = u64;
+
+		static constexpr Handle InvalidHandle = Handle(-1);                   ///< Invalid handle
+		static constexpr u32    NumLevels = 4;                                ///< Number of levels in the wheel
+		static constexpr u32    SlotBits = 8;                                 ///< Number of bits of a tick used to index the slots of a level
+		static constexpr u32    NumSlots = 1u << SlotBits;                    ///< Number of slots per level
+		static constexpr u64    MaxTicks = u64(1) << (NumLevels * SlotBits);  ///< Number of ticks covered by the wheel
+
+		/**
+		 * Create an empty TimerWheel
+		 * \param[in] tickTime Length of a tick in seconds
+		 * \param[in] alloc Allocator the container should use
+		 */
+		explicit TimerWheel(f32 tickTime = 0.001f, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		TimerWheel(const TimerWheel& other) noexcept requires CopyConstructible<T> = default;
+		TimerWheel(TimerWheel&& other) noexcept;
+
+		auto operator=(const TimerWheel& other) noexcept -> TimerWheel& requires CopyConstructible<T> = default;
+		auto operator=(TimerWheel&& other) noexcept -> TimerWheel&;
+
+		/**
+		 * Schedule a timer
+		 * \param[in] delay Delay in seconds before the timer fires
+		 * \param[in] payload Payload passed to the callback when the timer fires
+		 * \return Handle to the timer
+		 */
+		auto Schedule(f32 delay, const T& payload) noexcept -> Handle requires CopyConstructible<T>;
+		/**
+		 * Schedule a timer
+		 * \param[in] delay Delay in seconds before the timer fires
+		 * \param[in] payload Payload passed to the callback when the timer fires
+		 * \return Handle to the timer
+		 */
+		auto Schedule(f32 delay, T&& payload) noexcept -> Handle;
+		/**
+		 * Schedule a timer
+		 * \param[in] ticks Number of ticks before the timer fires, a timer always fires at least 1 tick in the future
+		 * \param[in] payload Payload passed to the callback when the timer fires
+		 * \return Handle to the timer
+		 */
+		auto ScheduleTicks(u64 ticks, T&& payload) noexcept -> Handle;
+		/**
+		 * Reschedule a pending timer, relative to the current time
+		 * \param[in] handle Handle to the timer
+		 * \param[in] delay New delay in seconds before the timer fires
+		 * \return Whether the timer was rescheduled, false if the timer already fired or was cancelled
+		 */
+		auto Reschedule(Handle handle, f32 delay) noexcept -> bool;
+		/**
+		 * Cancel a pending timer
+		 * \param[in] handle Handle to the timer
+		 * \return Whether the timer was cancelled, false if the timer already fired or was cancelled
+		 */
+		auto Cancel(Handle handle) noexcept -> bool;
+		/**
+		 * Check if a timer is still pending
+		 * \param[in] handle Handle to the timer
+		 * \return Whether the timer is pending
+		 */
+		auto IsPending(Handle handle) const noexcept -> bool;
+
+		/**
+		 * Advance the wheel and fire all timers that expire
+		 * \tparam F Function type
+		 * \param[in] dt Time to advance the wheel with, time that does not fill a whole tick is carried over to the next call
+		 * \param[in] fun Function called with the payload of each timer that fires
+		 * \return Number of timers that fired
+		 * \note The callback may schedule and cancel timers, timers scheduled from the callback fire at the earliest on the next tick
+		 */
+		template<Callable<void, T&> F>
+		auto Advance(const Chrono::DeltaTime& dt, F fun) noexcept -> usize;
+		/**
+		 * Advance the wheel by a number of ticks and fire all timers that expire
+		 * \tparam F Function type
+		 * \param[in] ticks Number of ticks to advance the wheel with
+		 * \param[in] fun Function called with the payload of each timer that fires
+		 * \return Number of timers that fired
+		 * \note The callback may schedule and cancel timers, timers scheduled from the callback fire at the earliest on the next tick
+		 */
+		template<Callable<void, T&> F>
+		auto AdvanceTicks(u64 ticks, F fun) noexcept -> usize;
+
+		/**
+		 * Reserve space for a number of timers
+		 * \param[in] capacity Number of timers to reserve space for
+		 */
+		void Reserve(usize capacity) noexcept;
+		/**
+		 * Cancel all timers
+		 * \param[in] clearMemory Whether to free the memory used by the TimerWheel
+		 */
+		void Clear(bool clearMemory = false) noexcept;
+
+		/**
+		 * Get the number of pending timers
+		 * \return Number of pending timers
+		 */
+		auto Size() const noexcept -> usize;
+		/**
+		 * Check if the TimerWheel has no pending timers
+		 * \return Whether the TimerWheel has no pending timers
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get the length of a tick
+		 * \return Length of a tick in seconds
+		 */
+		auto GetTickTime() const noexcept -> f32;
+		/**
+		 * Get the current tick
+		 * \return Number of ticks the wheel was advanced with
+		 */
+		auto GetCurrentTick() const noexcept -> u64;
+
+		/**
+		 * Get the allocator used by the TimerWheel
+		 * \return Allocator used by the TimerWheel
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		static constexpr u32 InvalidIdx = u32(-1); ///< Invalid node or slot index
+
+		/**
+		 * Timer node
+		 */
+		struct Node
+		{
+			T   payload;    ///< Payload
+			u64 expireTick; ///< Tick on which the timer fires
+			u32 next;       ///< Next node in the slot, or next free node when the node is free
+			u32 prev;       ///< Previous node in the slot, InvalidIdx if the node is the first in the slot
+			u32 slot;       ///< Slot the node is linked in, InvalidIdx when the node is free
+			u32 generation; ///< Generation of the node, incremented when its timer fires or is cancelled
+		};
+
+		/**
+		 * Convert a delay to a number of ticks
+		 * \param[in] delay Delay in seconds
+		 * \return Number of ticks, at least 1
+		 */
+		auto DelayToTicks(f32 delay) const noexcept -> u64;
+		/**
+		 * Get the node index of a pending timer
+		 * \param[in] handle Handle to the timer
+		 * \return Index of the node, InvalidIdx if the handle does not refer to a pending timer
+		 */
+		auto GetNodeIdx(Handle handle) const noexcept -> u32;
+		/**
+		 * Return a node to the pool, moving its payload out
+		 * \param[in] idx Index of the node
+		 * \return Payload of the node
+		 */
+		auto FreeNode(u32 idx) noexcept -> T;
+		/**
+		 * Link a node into the slot for its expire tick
+		 * \param[in] idx Index of the node
+		 */
+		void Link(u32 idx) noexcept;
+		/**
+		 * Unlink a node from its slot
+		 * \param[in] idx Index of the node
+		 */
+		void Unlink(u32 idx) noexcept;
+
+		DynArray<Node> m_nodes;                        ///< Node pool
+		u32            m_slots[NumLevels * NumSlots];  ///< First node in each slot
+		u32            m_levelCounts[NumLevels];       ///< Number of timers on each level
+		u32            m_freeHead;                     ///< First free node, InvalidIdx if no node is free
+		usize          m_size;                         ///< Number of pending timers
+		u64            m_currentTick;                  ///< Current tick
+		f32            m_tickTime;                     ///< Length of a tick in seconds
+		f32            m_accumulator;                  ///< Time carried over that does not fill a whole tick yet
+	};
+}
+
+#include "TimerWheel.inl"
@@ -0,0 +1,336 @@
+#pragma once
+#if __RESHARPER__
+#include "TimerWheel.h"
+#endif
+
+namespace Onca
+{
+	template <typename T>
+	TimerWheel<T>::TimerWheel(f32 tickTime, Alloc::IAllocator& alloc) noexcept
+		: m_nodes(alloc)
+		, m_freeHead(InvalidIdx)
+		, m_size(0)
+		, m_currentTick(0)
+		, m_tickTime(tickTime)
+		, m_accumulator(0.f)
+	{
+		ASSERT(tickTime > 0.f, "Tick time needs to be larger than 0");
+		for (u32& slot : m_slots)
+			slot = InvalidIdx;
+		for (u32& count : m_levelCounts)
+			count = 0;
+	}
+
+	template <typename T>
+	TimerWheel<T>::TimerWheel(TimerWheel&& other) noexcept
+		: m_nodes(Move(other.m_nodes))
+		, m_freeHead(other.m_freeHead)
+		, m_size(other.m_size)
+		, m_currentTick(other.m_currentTick)
+		, m_tickTime(other.m_tickTime)
+		, m_accumulator(other.m_accumulator)
+	{
+		for (u32 i = 0; i < NumLevels * NumSlots; ++i)
+		{
+			m_slots[i] = other.m_slots[i];
+			other.m_slots[i] = InvalidIdx;
+		}
+		for (u32 i = 0; i < NumLevels; ++i)
+		{
+			m_levelCounts[i] = other.m_levelCounts[i];
+			other.m_levelCounts[i] = 0;
+		}
+		other.m_freeHead = InvalidIdx;
+		other.m_size = 0;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::operator=(TimerWheel&& other) noexcept -> TimerWheel&
+	{
+		m_nodes = Move(other.m_nodes);
+		for (u32 i = 0; i < NumLevels * NumSlots; ++i)
+		{
+			m_slots[i] = other.m_slots[i];
+			other.m_slots[i] = InvalidIdx;
+		}
+		for (u32 i = 0; i < NumLevels; ++i)
+		{
+			m_levelCounts[i] = other.m_levelCounts[i];
+			other.m_levelCounts[i] = 0;
+		}
+		m_freeHead = other.m_freeHead;
+		m_size = other.m_size;
+		m_currentTick = other.m_currentTick;
+		m_tickTime = other.m_tickTime;
+		m_accumulator = other.m_accumulator;
+		other.m_freeHead = InvalidIdx;
+		other.m_size = 0;
+		return *this;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::Schedule(f32 delay, const T& payload) noexcept -> Handle requires CopyConstructible<T>
+	{
+		return ScheduleTicks(DelayToTicks(delay), T{ payload });
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::Schedule(f32 delay, T&& payload) noexcept -> Handle
+	{
+		return ScheduleTicks(DelayToTicks(delay), Move(payload));
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::ScheduleTicks(u64 ticks, T&& payload) noexcept -> Handle
+	{
+		const u64 expireTick = m_currentTick + (ticks == 0 ? 1 : ticks);
+
+		u32 idx;
+		if (m_freeHead != InvalidIdx)
+		{
+			idx = m_freeHead;
+			Node& node = m_nodes[idx];
+			m_freeHead = node.next;
+			node.payload = Move(payload);
+			node.expireTick = expireTick;
+		}
+		else
+		{
+			idx = u32(m_nodes.Size());
+			ASSERT(idx != InvalidIdx, "Ran out of TimerWheel nodes");
+			m_nodes.Add(Node{ Move(payload), expireTick, InvalidIdx, InvalidIdx, InvalidIdx, 0 });
+		}
+
+		Link(idx);
+		++m_size;
+		return (Handle(m_nodes[idx].generation) << 32) | idx;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::Reschedule(Handle handle, f32 delay) noexcept -> bool
+	{
+		const u32 idx = GetNodeIdx(handle);
+		if (idx == InvalidIdx)
+			return false;
+
+		Unlink(idx);
+		m_nodes[idx].expireTick = m_currentTick + DelayToTicks(delay);
+		Link(idx);
+		return true;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::Cancel(Handle handle) noexcept -> bool
+	{
+		const u32 idx = GetNodeIdx(handle);
+		if (idx == InvalidIdx)
+			return false;
+
+		Unlink(idx);
+		FreeNode(idx);
+		return true;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::IsPending(Handle handle) const noexcept -> bool
+	{
+		return GetNodeIdx(handle) != InvalidIdx;
+	}
+
+	template <typename T>
+	template <Callable<void, T&> F>
+	auto TimerWheel<T>::Advance(const Chrono::DeltaTime& dt, F fun) noexcept -> usize
+	{
+		m_accumulator += dt.GetTime();
+		const u64 ticks = u64(m_accumulator / m_tickTime);
+		m_accumulator -= f32(ticks) * m_tickTime;
+		return AdvanceTicks(ticks, Move(fun));
+	}
+
+	template <typename T>
+	template <Callable<void, T&> F>
+	auto TimerWheel<T>::AdvanceTicks(u64 ticks, F fun) noexcept -> usize
+	{
+		usize numFired = 0;
+		while (ticks > 0)
+		{
+			// Nothing can fire, so the remaining ticks can be skipped
+			if (m_size == 0)
+			{
+				m_currentTick += ticks;
+				break;
+			}
+
+			// When the lowest levels are empty, nothing happens until the lowest level with timers needs to cascade, so those ticks can be skipped
+			u32 lowestLevel = 0;
+			while (m_levelCounts[lowestLevel] == 0)
+				++lowestLevel;
+			if (lowestLevel > 0)
+			{
+				const u64 mask = (u64(1) << (lowestLevel * SlotBits)) - 1;
+				const u64 skip = Math::Min((m_currentTick | mask) - m_currentTick, ticks);
+				m_currentTick += skip;
+				ticks -= skip;
+				if (ticks == 0)
+					break;
+			}
+
+			++m_currentTick;
+			--ticks;
+
+			// When the wheel below a level wraps around, the timers in the level's current slot are within range of the levels below it
+			for (u32 level = 1; level < NumLevels; ++level)
+			{
+				const u32 shift = level * SlotBits;
+				if ((m_currentTick & ((u64(1) << shift) - 1)) != 0)
+					break;
+
+				u32& head = m_slots[level * NumSlots + u32((m_currentTick >> shift) & (NumSlots - 1))];
+				u32 idx = head;
+				head = InvalidIdx;
+				while (idx != InvalidIdx)
+				{
+					const u32 next = m_nodes[idx].next;
+					--m_levelCounts[level];
+					Link(idx);
+					idx = next;
+				}
+			}
+
+			// All timers in the current slot of the first level expire on this tick.
+			// Nodes are unlinked one at a time, as the callback is allowed to cancel other timers in the same slot
+			u32& head = m_slots[u32(m_currentTick & (NumSlots - 1))];
+			while (head != InvalidIdx)
+			{
+				const u32 idx = head;
+				Unlink(idx);
+				T payload = FreeNode(idx);
+				fun(payload);
+				++numFired;
+			}
+		}
+		return numFired;
+	}
+
+	template <typename T>
+	void TimerWheel<T>::Reserve(usize capacity) noexcept
+	{
+		m_nodes.Reserve(capacity);
+	}
+
+	template <typename T>
+	void TimerWheel<T>::Clear(bool clearMemory) noexcept
+	{
+		m_nodes.Clear(clearMemory);
+		for (u32& slot : m_slots)
+			slot = InvalidIdx;
+		for (u32& count : m_levelCounts)
+			count = 0;
+		m_freeHead = InvalidIdx;
+		m_size = 0;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::Size() const noexcept -> usize
+	{
+		return m_size;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::IsEmpty() const noexcept -> bool
+	{
+		return m_size == 0;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::GetTickTime() const noexcept -> f32
+	{
+		return m_tickTime;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::GetCurrentTick() const noexcept -> u64
+	{
+		return m_currentTick;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_nodes.GetAllocator();
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::DelayToTicks(f32 delay) const noexcept -> u64
+	{
+		if (delay <= 0.f)
+			return 1;
+		const u64 ticks = u64(delay / m_tickTime + 0.5f);
+		return ticks == 0 ? 1 : ticks;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::GetNodeIdx(Handle handle) const noexcept -> u32
+	{
+		const u32 idx = u32(handle);
+		if (idx >= m_nodes.Size())
+			return InvalidIdx;
+
+		const Node& node = m_nodes[idx];
+		return node.slot != InvalidIdx && node.generation == u32(handle >> 32) ? idx : InvalidIdx;
+	}
+
+	template <typename T>
+	auto TimerWheel<T>::FreeNode(u32 idx) noexcept -> T
+	{
+		Node& node = m_nodes[idx];
+		node.slot = InvalidIdx;
+		node.next = m_freeHead;
+		++node.generation;
+		m_freeHead = idx;
+		--m_size;
+		return Move(node.payload);
+	}
+
+	template <typename T>
+	void TimerWheel<T>::Link(u32 idx) noexcept
+	{
+		Node& node = m_nodes[idx];
+		const u64 delta = node.expireTick - m_currentTick;
+
+		// Timers beyond the range of the wheel are put in the furthest slot, they are relinked when that slot comes around
+		u32 level = NumLevels - 1;
+		u64 tick = m_currentTick + MaxTicks - 1;
+		if (delta < MaxTicks)
+		{
+			level = 0;
+			while (delta >= (u64(1) << ((level + 1) * SlotBits)))
+				++level;
+			tick = node.expireTick;
+		}
+
+		const u32 slot = level * NumSlots + u32((tick >> (level * SlotBits)) & (NumSlots - 1));
+		++m_levelCounts[level];
+		u32& head = m_slots[slot];
+		node.slot = slot;
+		node.prev = InvalidIdx;
+		node.next = head;
+		if (head != InvalidIdx)
+			m_nodes[head].prev = idx;
+		head = idx;
+	}
+
+	template <typename T>
+	void TimerWheel<T>::Unlink(u32 idx) noexcept
+	{
+		Node& node = m_nodes[idx];
+		if (node.prev != InvalidIdx)
+			m_nodes[node.prev].next = node.next;
+		else
+			m_slots[node.slot] = node.next;
+
+		if (node.next != InvalidIdx)
+			m_nodes[node.next].prev = node.prev;
+		--m_levelCounts[node.slot / NumSlots];
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/allocator/GlobalAlloc.h"
+#include "core/memory/CompactMemRef.h"
+#include "core/allocator/ContainerAlloc.h"
+#include "core/utils/Atomic.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Work-stealing deque, a single owner pushes and pops at the bottom, while any thread can steal from the top (lock-free)
+	 *
+	 * Implementation of the Chase-Lev deque, using the memory orderings from "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.).
+	 * The owner works LIFO on its own elements, which keeps recently pushed work hot in its cache, while thieves take the oldest elements.
+	 * Only popping the last element and stealing need a CAS, pushing and popping otherwise only touch the bottom index.
+	 *
+	 * The buffer grows when the owner pushes into a full deque. Thieves may still be reading from the old buffer, so old buffers are kept alive until the deque is destroyed,
+	 * as the buffers double in size, these never take more memory than the current buffer.
+	 *
+	 * \tparam T Stored type, elements are read by thieves before they are claimed, so the type needs to be memcopyable and fit in a usize (e.g. a pointer to a task)
+	 */
+	template<typename T>
+	class WorkStealingDeque
+	{
+		STATIC_ASSERT(MemCopyable<T> && sizeof(T) <= sizeof(usize), "Type needs to be memcopyable and fit in a usize to be used in a WorkStealingDeque");
+	public:
+		/**
+		 * Create a work-stealing deque
+		 * \param[in] capacity Minimum initial capacity of the deque, rounded up to a power of 2
+		 * \param[in] alloc Allocator to use
+		 */
+		explicit WorkStealingDeque(usize capacity = 256, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		~WorkStealingDeque() noexcept;
+
+		DISABLE_COPY(WorkStealingDeque);
+		DISABLE_MOVE(WorkStealingDeque);
+
+		/**
+		 * Push an element at the bottom of the deque, growing the deque if it is full
+		 * \param[in] val Element to push
+		 * \note Only the owner of the deque may call this
+		 */
+		void Push(T val) noexcept;
+		/**
+		 * Pop the element at the bottom of the deque
+		 * \return Popped element, or nothing if the deque is empty
+		 * \note Only the owner of the deque may call this
+		 */
+		auto Pop() noexcept -> Optional<T>;
+		/**
+		 * Try to steal the element at the top of the deque
+		 * \return Stolen element, or nothing if the deque is empty or another thread claimed the element first
+		 * \note Can be called from any thread
+		 */
+		auto Steal() noexcept -> Optional<T>;
+
+		/**
+		 * Get the number of elements in the deque
+		 * \return Number of elements in the deque
+		 * \note The size is only an approximation when the deque is being used by other threads
+		 */
+		auto SizeApprox() const noexcept -> usize;
+		/**
+		 * Check if the deque is empty
+		 * \return Whether the deque is empty
+		 * \note The result is only an approximation when the deque is being used by other threads
+		 */
+		auto IsEmpty() const noexcept -> bool;
+		/**
+		 * Get the capacity of the deque
+		 * \return Capacity of the deque
+		 */
+		auto Capacity() const noexcept -> usize;
+
+		/**
+		 * Get the allocator used by the deque
+		 * \return Allocator used by the deque
+		 */
+		auto GetAllocator() const noexcept -> Alloc::IAllocator*;
+
+	private:
+		/**
+		 * Circular buffer with the elements
+		 */
+		struct Buffer
+		{
+			CompactMemRef<Atomic<T>> elems; ///< Elements
+			usize                    mask;  ///< Capacity - 1
+			CompactMemRef<Buffer>    prev;  ///< Buffer that was replaced by this buffer
+		};
+
+		/**
+		 * Create a buffer
+		 * \param[in] capacity Capacity of the buffer, needs to be a power of 2
+		 * \param[in] prev Buffer that is replaced by the new buffer
+		 * \return Created buffer
+		 */
+		auto CreateBuffer(usize capacity, CompactMemRef<Buffer> prev) noexcept -> CompactMemRef<Buffer>;
+		/**
+		 * Replace the buffer with one with double the capacity
+		 * \param[in] pBuffer Current buffer
+		 * \param[in] top Current top index
+		 * \param[in] bottom Current bottom index
+		 * \return New buffer
+		 */
+		auto Grow(Buffer* pBuffer, isize top, isize bottom) noexcept -> Buffer*;
+
+		Alloc::ContainerAlloc     m_alloc;  ///< Allocator
+		Atomic<Buffer*>           m_buffer; ///< Current buffer
+		alignas(64) Atomic<isize> m_top;    ///< Index of the top element, the next element to be stolen
+		alignas(64) Atomic<isize> m_bottom; ///< Index past the bottom element, where the owner pushes the next element
+	};
+}
+
+#include "WorkStealingDeque.inl"
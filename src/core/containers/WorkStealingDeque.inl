@@ -0,0 +1,144 @@
+#pragma once
+#if __RESHARPER__
+#include "WorkStealingDeque.h"
+#endif
+
+namespace Onca
+{
+	template <typename T>
+	WorkStealingDeque<T>::WorkStealingDeque(usize capacity, Alloc::IAllocator& alloc) noexcept
+		: m_alloc(alloc)
+		, m_buffer(nullptr)
+		, m_top(0)
+		, m_bottom(0)
+	{
+		capacity = Math::Max<usize>(capacity, 2);
+		if (!Math::IsPowOf2(capacity))
+			capacity = usize(1) << (Intrin::BitScanMSB(capacity) + 1);
+
+		m_buffer.Store(CreateBuffer(capacity, nullptr).Ptr(), MemOrder::Relaxed);
+	}
+
+	template <typename T>
+	WorkStealingDeque<T>::~WorkStealingDeque() noexcept
+	{
+		CompactMemRef<Buffer> buffer{ m_buffer.Load(MemOrder::Relaxed) };
+		while (buffer)
+		{
+			CompactMemRef<Buffer> prev = buffer->prev;
+			m_alloc.Deallocate(Move(buffer->elems), buffer->mask + 1);
+			m_alloc.Destroy(Move(buffer));
+			buffer = prev;
+		}
+	}
+
+	template <typename T>
+	void WorkStealingDeque<T>::Push(T val) noexcept
+	{
+		const isize bottom = m_bottom.Load(MemOrder::Relaxed);
+		const isize top = m_top.Load(MemOrder::Acquire);
+		Buffer* pBuffer = m_buffer.Load(MemOrder::Relaxed);
+		if (bottom - top > isize(pBuffer->mask)) UNLIKELY
+			pBuffer = Grow(pBuffer, top, bottom);
+
+		pBuffer->elems.Ptr()[bottom & pBuffer->mask].Store(val, MemOrder::Relaxed);
+		AtomicThreadFence(MemOrder::Release);
+		m_bottom.Store(bottom + 1, MemOrder::Relaxed);
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::Pop() noexcept -> Optional<T>
+	{
+		// Reserve the bottom element before looking at the top, so a thief can't take the element at the same time without one of us noticing
+		const isize bottom = m_bottom.Load(MemOrder::Relaxed) - 1;
+		Buffer* pBuffer = m_buffer.Load(MemOrder::Relaxed);
+		m_bottom.Store(bottom, MemOrder::Relaxed);
+		AtomicThreadFence(MemOrder::SeqCst);
+		isize top = m_top.Load(MemOrder::Relaxed);
+
+		if (top > bottom)
+		{
+			m_bottom.Store(bottom + 1, MemOrder::Relaxed);
+			return NullOpt;
+		}
+
+		T val = pBuffer->elems.Ptr()[bottom & pBuffer->mask].Load(MemOrder::Relaxed);
+		if (top != bottom)
+			return val;
+
+		// Last element, thieves might be trying to steal it
+		const bool claimed = m_top.CompareExchangeStrong(top, top + 1, MemOrder::SeqCst);
+		m_bottom.Store(bottom + 1, MemOrder::Relaxed);
+		if (!claimed)
+			return NullOpt;
+		return val;
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::Steal() noexcept -> Optional<T>
+	{
+		isize top = m_top.Load(MemOrder::Acquire);
+		AtomicThreadFence(MemOrder::SeqCst);
+		const isize bottom = m_bottom.Load(MemOrder::Acquire);
+		if (top >= bottom)
+			return NullOpt;
+
+		Buffer* pBuffer = m_buffer.Load(MemOrder::Acquire);
+		T val = pBuffer->elems.Ptr()[top & pBuffer->mask].Load(MemOrder::Relaxed);
+		if (!m_top.CompareExchangeStrong(top, top + 1, MemOrder::SeqCst))
+			return NullOpt;
+		return val;
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::SizeApprox() const noexcept -> usize
+	{
+		const isize bottom = m_bottom.Load(MemOrder::Relaxed);
+		const isize top = m_top.Load(MemOrder::Relaxed);
+		return bottom > top ? usize(bottom - top) : 0;
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::IsEmpty() const noexcept -> bool
+	{
+		return SizeApprox() == 0;
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::Capacity() const noexcept -> usize
+	{
+		return m_buffer.Load(MemOrder::Relaxed)->mask + 1;
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::GetAllocator() const noexcept -> Alloc::IAllocator*
+	{
+		return m_alloc.Get();
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::CreateBuffer(usize capacity, CompactMemRef<Buffer> prev) noexcept -> CompactMemRef<Buffer>
+	{
+		CompactMemRef<Atomic<T>> elems = m_alloc.Allocate<Atomic<T>>(capacity);
+		ASSERT(elems, "Failed to allocate the elements of the deque");
+		Atomic<T>* pElems = elems.Ptr();
+		for (usize i = 0; i < capacity; ++i)
+			new (pElems + i) Atomic<T>{ T{} };
+
+		CompactMemRef<Buffer> buffer = m_alloc.Create<Buffer>(elems, capacity - 1, prev);
+		ASSERT(buffer, "Failed to allocate the buffer of the deque");
+		return buffer;
+	}
+
+	template <typename T>
+	auto WorkStealingDeque<T>::Grow(Buffer* pBuffer, isize top, isize bottom) noexcept -> Buffer*
+	{
+		CompactMemRef<Buffer> newBuffer = CreateBuffer((pBuffer->mask + 1) * 2, CompactMemRef<Buffer>{ pBuffer });
+		Buffer* pNewBuffer = newBuffer.Ptr();
+		for (isize i = top; i < bottom; ++i)
+			pNewBuffer->elems.Ptr()[i & pNewBuffer->mask].Store(pBuffer->elems.Ptr()[i & pBuffer->mask].Load(MemOrder::Relaxed), MemOrder::Relaxed);
+
+		m_buffer.Store(pNewBuffer, MemOrder::Release);
+		return pNewBuffer;
+	}
+}
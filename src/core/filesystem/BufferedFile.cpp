@@ -0,0 +1,310 @@
+#include "BufferedFile.h"
+
+namespace Onca::FileSystem
+{
+	BufferedFileWriter::BufferedFileWriter(const BufferedStreamOptions& options, Alloc::IAllocator& alloc) noexcept
+		: m_options(options)
+		, m_pAlloc(&alloc)
+		, m_inFlight{ false, false }
+		, m_active(0)
+		, m_used(0)
+		, m_fileOffset(0)
+	{
+		ASSERT(m_options.bufferSize, "Buffer size cannot be 0");
+	}
+
+	BufferedFileWriter::BufferedFileWriter(File&& file, const BufferedStreamOptions& options, Alloc::IAllocator& alloc) noexcept
+		: BufferedFileWriter(options, alloc)
+	{
+		SetFile(Onca::Move(file));
+	}
+
+	BufferedFileWriter::~BufferedFileWriter() noexcept
+	{
+		Close();
+		for (MemRef<u8>& buffer : m_buffers)
+		{
+			if (buffer.IsValid())
+				m_pAlloc->Deallocate(Onca::Move(buffer));
+		}
+	}
+
+	auto BufferedFileWriter::SetFile(File&& file) noexcept -> SystemError
+	{
+		SystemError err = Flush();
+		m_file = Onca::Move(file);
+		if (!m_file.IsValid())
+			return err;
+
+		m_fileOffset = m_file.GetFileOffset();
+		m_used = 0;
+		AllocateBuffers();
+		return err;
+	}
+
+	auto BufferedFileWriter::Close() noexcept -> SystemError
+	{
+		if (!m_file.IsValid())
+			return SystemErrorCode::Success;
+
+		SystemError err = Flush();
+		m_file.Close();
+		return err;
+	}
+
+	auto BufferedFileWriter::Write(const u8* pData, usize size) noexcept -> SystemError
+	{
+		if (!m_file.IsValid())
+			return SystemErrorCode::InvalidHandle;
+
+		const usize bufferSize = m_options.bufferSize;
+
+		// Copying data that fills a whole buffer gains nothing, so write it directly
+		if (size >= bufferSize)
+		{
+			SystemError err = Flush();
+			if (!err)
+				return err;
+			return WriteDirect(pData, size);
+		}
+
+		while (size)
+		{
+			if (m_used == bufferSize)
+			{
+				SystemError err = FlushBuffer();
+				if (!err)
+					return err;
+			}
+
+			const usize toCopy = Math::Min(size, bufferSize - m_used);
+			MemCpy(m_buffers[m_active].Ptr() + m_used, pData, toCopy);
+			m_used += toCopy;
+			pData += toCopy;
+			size -= toCopy;
+		}
+		return SystemErrorCode::Success;
+	}
+
+	auto BufferedFileWriter::WriteV(const WriteRegion* pRegions, usize count) noexcept -> SystemError
+	{
+		for (usize i = 0; i < count; ++i)
+		{
+			SystemError err = Write(pRegions[i].pData, pRegions[i].size);
+			if (!err)
+				return err;
+		}
+		return SystemErrorCode::Success;
+	}
+
+	auto BufferedFileWriter::Flush() noexcept -> SystemError
+	{
+		if (!m_file.IsValid())
+			return SystemErrorCode::Success;
+
+		SystemError err = FlushBuffer();
+		for (u8 i = 0; i < 2; ++i)
+		{
+			SystemError waitErr = WaitForBuffer(i);
+			if (err)
+				err = Onca::Move(waitErr);
+		}
+		return err;
+	}
+
+	auto BufferedFileWriter::FlushBuffer() noexcept -> SystemError
+	{
+		if (!m_used)
+			return SystemErrorCode::Success;
+
+		if (!UseDoubleBuffer())
+		{
+			const usize size = m_used;
+			m_used = 0;
+			return WriteDirect(m_buffers[m_active].Ptr(), size);
+		}
+
+		// Start writing the full buffer and continue filling the other buffer, once that buffer's previous write has finished
+		SystemError err = WriteAsync(m_active, m_used);
+		m_fileOffset += m_used;
+		m_used = 0;
+		m_active ^= 1;
+
+		SystemError waitErr = WaitForBuffer(m_active);
+		return err ? waitErr : err;
+	}
+
+	void BufferedFileWriter::AllocateBuffers() noexcept
+	{
+		const u8 numBuffers = UseDoubleBuffer() ? 2 : 1;
+		for (u8 i = 0; i < numBuffers; ++i)
+		{
+			if (!m_buffers[i].IsValid())
+				m_buffers[i] = m_pAlloc->Allocate<u8>(m_options.bufferSize, m_options.alignment);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////
+
+	BufferedFileReader::BufferedFileReader(File&& file, const BufferedStreamOptions& options, Alloc::IAllocator& alloc) noexcept
+		: m_file(Onca::Move(file))
+		, m_options(options)
+		, m_pAlloc(&alloc)
+		, m_prefetchOffset(0)
+		, m_inFlight{ false, false }
+		, m_active(0)
+		, m_pos(0)
+		, m_size(0)
+		, m_bufferOffset(0)
+		, m_fileSize(0)
+	{
+		ASSERT(m_options.bufferSize, "Buffer size cannot be 0");
+		if (!m_file.IsValid())
+			return;
+
+		m_bufferOffset = m_file.GetFileOffset();
+		m_fileSize = m_file.GetFileSize();
+
+		const u8 numBuffers = UseDoubleBuffer() ? 2 : 1;
+		for (u8 i = 0; i < numBuffers; ++i)
+			m_buffers[i] = m_pAlloc->Allocate<u8>(m_options.bufferSize, m_options.alignment);
+	}
+
+	BufferedFileReader::~BufferedFileReader() noexcept
+	{
+		CancelPrefetch();
+		for (MemRef<u8>& buffer : m_buffers)
+		{
+			if (buffer.IsValid())
+				m_pAlloc->Deallocate(Onca::Move(buffer));
+		}
+	}
+
+	auto BufferedFileReader::Read(u8* pData, usize size) noexcept -> Result<usize, SystemError>
+	{
+		if (!m_file.IsValid())
+			return SystemError{ SystemErrorCode::InvalidHandle };
+
+		usize totalRead = 0;
+		while (size)
+		{
+			if (m_pos == m_size)
+			{
+				if (IsEof())
+					break;
+
+				// Reads that cover at least a full buffer go directly into the destination
+				if (size >= m_options.bufferSize)
+				{
+					const u64 offset = GetOffset();
+					const usize toRead = usize(Math::Min(u64(size), m_fileSize - offset));
+
+					CancelPrefetch();
+					SystemError err = ReadDirect(offset, pData, toRead);
+					if (!err)
+						return err;
+
+					m_bufferOffset = offset + toRead;
+					m_pos = m_size = 0;
+					totalRead += toRead;
+					pData += toRead;
+					size -= toRead;
+					continue;
+				}
+
+				SystemError err = Refill();
+				if (!err)
+					return err;
+				if (!m_size)
+					break;
+			}
+
+			const usize toCopy = Math::Min(size, m_size - m_pos);
+			MemCpy(pData, m_buffers[m_active].Ptr() + m_pos, toCopy);
+			m_pos += toCopy;
+			totalRead += toCopy;
+			pData += toCopy;
+			size -= toCopy;
+		}
+		return totalRead;
+	}
+
+	auto BufferedFileReader::ReadToEnd() noexcept -> Result<ByteBuffer, SystemError>
+	{
+		if (!m_file.IsValid())
+			return SystemError{ SystemErrorCode::InvalidHandle };
+
+		ByteBuffer buffer;
+		buffer.Resize(usize(m_fileSize - Math::Min(GetOffset(), m_fileSize)));
+		Result<usize, SystemError> res = Read(buffer.Data(), buffer.Size());
+		if (res.Failed())
+			return SystemError{ res.Error() };
+
+		buffer.Resize(res.Value());
+		return buffer;
+	}
+
+	auto BufferedFileReader::ReadStringToEnd() noexcept -> Result<String, SystemError>
+	{
+		Result<ByteBuffer, SystemError> res = ReadToEnd();
+		if (res.Failed())
+			return SystemError{ res.Error() };
+		return String{ res.Value() };
+	}
+
+	void BufferedFileReader::Skip(u64 size) noexcept
+	{
+		const u64 target = Math::Min(GetOffset() + size, m_fileSize);
+		if (target < m_bufferOffset + m_size)
+		{
+			m_pos = usize(target - m_bufferOffset);
+		}
+		else
+		{
+			m_bufferOffset = target;
+			m_pos = m_size = 0;
+		}
+	}
+
+	auto BufferedFileReader::Refill() noexcept -> SystemError
+	{
+		const u64 offset = m_bufferOffset + m_size;
+		m_bufferOffset = offset;
+		m_pos = m_size = 0;
+		if (offset >= m_fileSize)
+			return SystemErrorCode::Success;
+
+		const usize toRead = usize(Math::Min(u64(m_options.bufferSize), m_fileSize - offset));
+		if (!UseDoubleBuffer())
+		{
+			SystemError err = ReadDirect(offset, m_buffers[m_active].Ptr(), toRead);
+			if (err)
+				m_size = toRead;
+			return err;
+		}
+
+		// Switch to the prefetched buffer when it contains the requested data, otherwise read it now
+		const u8 other = m_active ^ 1;
+		SystemError err;
+		if (m_inFlight[other] && m_prefetchOffset == offset)
+		{
+			err = WaitForBuffer(other);
+			m_active = other;
+		}
+		else
+		{
+			CancelPrefetch();
+			err = ReadDirect(offset, m_buffers[m_active].Ptr(), toRead);
+		}
+
+		if (!err)
+			return err;
+		m_size = toRead;
+
+		// Prefetch the next buffer while the current buffer is being consumed
+		const u64 nextOffset = offset + toRead;
+		if (nextOffset < m_fileSize)
+			UNUSED(ReadAsync(m_active ^ 1, nextOffset));
+		return SystemErrorCode::Success;
+	}
+}
@@ -0,0 +1,293 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "File.h"
+
+namespace Onca::FileSystem
+{
+	/**
+	 * Options for buffered file streams
+	 */
+	struct BufferedStreamOptions
+	{
+		u32  bufferSize       = u32(64_KiB); ///< Size of a single buffer
+		u16  alignment        = 4096;        ///< Alignment of the buffers
+		bool doubleBuffer : 1 = false;       ///< Use 2 buffers, so I/O on one buffer overlaps with filling/consuming the other, requires a file opened with FileFlag::AllowAsync
+	};
+
+	/**
+	 * Region of memory used in a vectored write
+	 */
+	struct WriteRegion
+	{
+		const u8* pData; ///< Data
+		usize     size;  ///< Size of the data
+	};
+
+	/**
+	 * Buffered sequential writer over a file
+	 *
+	 * Small writes are gathered in a buffer and only written to the file when the buffer is full or when the writer is flushed.
+	 * When double buffering is enabled, a full buffer is written asynchronously while the next buffer is being filled.
+	 */
+	class CORE_API BufferedFileWriter
+	{
+	public:
+		DEFINE_SIZED_OPAQUE_HANDLE(NativeDataHandle, 32);
+
+		DISABLE_COPY(BufferedFileWriter);
+		DISABLE_MOVE(BufferedFileWriter);
+
+		/**
+		 * Create a writer without a file
+		 * \param[in] options Options
+		 * \param[in] alloc Allocator used for the buffers
+		 */
+		explicit BufferedFileWriter(const BufferedStreamOptions& options = {}, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create a writer that starts writing at the current offset of a file
+		 * \param[in] file File to write to
+		 * \param[in] options Options
+		 * \param[in] alloc Allocator used for the buffers
+		 */
+		explicit BufferedFileWriter(File&& file, const BufferedStreamOptions& options = {}, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		~BufferedFileWriter() noexcept;
+
+		/**
+		 * Flush the current file and start writing to a new file
+		 * \param[in] file File to write to
+		 * \return Error that occurred when flushing the previous file
+		 */
+		auto SetFile(File&& file) noexcept -> SystemError;
+		/**
+		 * Flush and close the file
+		 * \return Error
+		 */
+		auto Close() noexcept -> SystemError;
+
+		/**
+		 * Write data
+		 * \param[in] pData Data
+		 * \param[in] size Size of the data
+		 * \return Error
+		 * \note Errors that occur during an asynchronous write are returned by the next call that needs the buffer
+		 */
+		auto Write(const u8* pData, usize size) noexcept -> SystemError;
+		/**
+		 * Write the content of a byte buffer
+		 * \param[in] buffer Buffer
+		 * \return Error
+		 */
+		auto Write(const ByteBuffer& buffer) noexcept -> SystemError { return Write(buffer.Data(), buffer.Size()); }
+		/**
+		 * Write a string (utf8)
+		 * \param[in] str String
+		 * \return Error
+		 */
+		auto Write(const String& str) noexcept -> SystemError { return Write(str.Data(), str.DataSize()); }
+		/**
+		 * Write multiple regions of memory as a single sequential write
+		 * \param[in] pRegions Regions
+		 * \param[in] count Number of regions
+		 * \return Error
+		 * \note Regions are gathered into the buffer, only regions that are larger than the buffer are written directly to the file
+		 */
+		auto WriteV(const WriteRegion* pRegions, usize count) noexcept -> SystemError;
+
+		/**
+		 * Write all buffered data to the file and wait for all outstanding writes to finish
+		 * \return Error
+		 */
+		auto Flush() noexcept -> SystemError;
+
+		/**
+		 * Get the number of bytes that are buffered, but not yet written
+		 * \return Number of buffered bytes
+		 */
+		auto GetBufferedSize() const noexcept -> usize { return m_used; }
+		/**
+		 * Get the offset in the file the next write will end up at
+		 * \return Offset in the file
+		 */
+		auto GetOffset() const noexcept -> u64 { return m_fileOffset + m_used; }
+		/**
+		 * Get the file
+		 * \return File
+		 */
+		auto GetFile() noexcept -> File& { return m_file; }
+		/**
+		 * Check if the writer has a valid file
+		 * \return Whether the writer has a valid file
+		 */
+		auto IsValid() const noexcept -> bool { return m_file.IsValid(); }
+
+		explicit operator bool() const noexcept { return IsValid(); }
+
+	private:
+		/**
+		 * Write out the active buffer and switch to the next buffer
+		 * \return Error
+		 */
+		auto FlushBuffer() noexcept -> SystemError;
+		/**
+		 * Write data directly to the file at the current file offset
+		 * \param[in] pData Data
+		 * \param[in] size Size of the data
+		 * \return Error
+		 */
+		auto WriteDirect(const u8* pData, usize size) noexcept -> SystemError;
+		/**
+		 * Start an asynchronous write of a buffer
+		 * \param[in] idx Index of the buffer
+		 * \param[in] size Number of bytes to write
+		 * \return Error
+		 */
+		auto WriteAsync(u8 idx, usize size) noexcept -> SystemError;
+		/**
+		 * Wait for the asynchronous write of a buffer to finish
+		 * \param[in] idx Index of the buffer
+		 * \return Error of the asynchronous write
+		 */
+		auto WaitForBuffer(u8 idx) noexcept -> SystemError;
+		/**
+		 * Allocate the buffers
+		 */
+		void AllocateBuffers() noexcept;
+		/**
+		 * Check if double buffering is used for the current file
+		 * \return Whether double buffering is used
+		 */
+		auto UseDoubleBuffer() const noexcept -> bool { return m_options.doubleBuffer && m_file.GetFlags() & FileFlag::AllowAsync; }
+
+		File                  m_file;           ///< File
+		BufferedStreamOptions m_options;        ///< Options
+		Alloc::IAllocator*    m_pAlloc;         ///< Allocator used for the buffers
+		MemRef<u8>            m_buffers[2];     ///< Buffers (the 2nd buffer is only used when double buffering)
+		NativeDataHandle      m_nData[2];       ///< Native data for the asynchronous write of each buffer
+		bool                  m_inFlight[2];    ///< Whether an asynchronous write of a buffer is in progress
+		u8                    m_active;         ///< Index of the buffer being filled
+		usize                 m_used;           ///< Number of bytes used in the active buffer
+		u64                   m_fileOffset;     ///< Offset in the file the active buffer will be written to
+	};
+
+	/**
+	 * Buffered sequential reader over a file
+	 *
+	 * Reads are served from a buffer, which is refilled with a single large read when it runs out.
+	 * When double buffering is enabled, the next buffer is read asynchronously while the current buffer is being consumed.
+	 */
+	class CORE_API BufferedFileReader
+	{
+	public:
+		DEFINE_SIZED_OPAQUE_HANDLE(NativeDataHandle, 32);
+
+		DISABLE_COPY(BufferedFileReader);
+		DISABLE_MOVE(BufferedFileReader);
+
+		/**
+		 * Create a reader that starts reading at the current offset of a file
+		 * \param[in] file File to read from
+		 * \param[in] options Options
+		 * \param[in] alloc Allocator used for the buffers
+		 */
+		explicit BufferedFileReader(File&& file, const BufferedStreamOptions& options = {}, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		~BufferedFileReader() noexcept;
+
+		/**
+		 * Read data
+		 * \param[out] pData Buffer to read into
+		 * \param[in] size Number of bytes to read
+		 * \return Result with the number of bytes read, which is only smaller than size when the end of the file was reached
+		 */
+		auto Read(u8* pData, usize size) noexcept -> Result<usize, SystemError>;
+		/**
+		 * Read all remaining data
+		 * \return Result with the remaining data
+		 * \note Unlike File::Read(), this is not limited to 4GiB
+		 */
+		auto ReadToEnd() noexcept -> Result<ByteBuffer, SystemError>;
+		/**
+		 * Read all remaining data as a string
+		 * \return Result with the remaining data as a string
+		 */
+		auto ReadStringToEnd() noexcept -> Result<String, SystemError>;
+
+		/**
+		 * Skip data
+		 * \param[in] size Number of bytes to skip
+		 */
+		void Skip(u64 size) noexcept;
+
+		/**
+		 * Get the offset in the file of the next byte that will be read
+		 * \return Offset in the file
+		 */
+		auto GetOffset() const noexcept -> u64 { return m_bufferOffset + m_pos; }
+		/**
+		 * Check if the end of the file was reached
+		 * \return Whether the end of the file was reached
+		 */
+		auto IsEof() const noexcept -> bool { return GetOffset() >= m_fileSize; }
+		/**
+		 * Get the file
+		 * \return File
+		 */
+		auto GetFile() noexcept -> File& { return m_file; }
+		/**
+		 * Check if the reader has a valid file
+		 * \return Whether the reader has a valid file
+		 */
+		auto IsValid() const noexcept -> bool { return m_file.IsValid(); }
+
+		explicit operator bool() const noexcept { return IsValid(); }
+
+	private:
+		/**
+		 * Refill the active buffer, switching to the prefetched buffer if available
+		 * \return Error
+		 */
+		auto Refill() noexcept -> SystemError;
+		/**
+		 * Read data directly from the file
+		 * \param[in] offset Offset in the file
+		 * \param[out] pData Buffer to read into
+		 * \param[in] size Number of bytes to read
+		 * \return Error
+		 */
+		auto ReadDirect(u64 offset, u8* pData, usize size) noexcept -> SystemError;
+		/**
+		 * Start an asynchronous read into a buffer
+		 * \param[in] idx Index of the buffer
+		 * \param[in] offset Offset in the file
+		 * \return Error
+		 */
+		auto ReadAsync(u8 idx, u64 offset) noexcept -> SystemError;
+		/**
+		 * Wait for the asynchronous read into a buffer to finish
+		 * \param[in] idx Index of the buffer
+		 * \return Error of the asynchronous read
+		 */
+		auto WaitForBuffer(u8 idx) noexcept -> SystemError;
+		/**
+		 * Cancel any outstanding asynchronous read
+		 */
+		void CancelPrefetch() noexcept;
+		/**
+		 * Check if double buffering is used for the current file
+		 * \return Whether double buffering is used
+		 */
+		auto UseDoubleBuffer() const noexcept -> bool { return m_options.doubleBuffer && m_file.GetFlags() & FileFlag::AllowAsync; }
+
+		File                  m_file;           ///< File
+		BufferedStreamOptions m_options;        ///< Options
+		Alloc::IAllocator*    m_pAlloc;         ///< Allocator used for the buffers
+		MemRef<u8>            m_buffers[2];     ///< Buffers (the 2nd buffer is only used when double buffering)
+		NativeDataHandle      m_nData[2];       ///< Native data for the asynchronous read into each buffer
+		u64                   m_prefetchOffset; ///< Offset in the file of the prefetched data
+		bool                  m_inFlight[2];    ///< Whether an asynchronous read into a buffer is in progress
+		u8                    m_active;         ///< Index of the buffer being consumed
+		usize                 m_pos;            ///< Position in the active buffer
+		usize                 m_size;           ///< Number of valid bytes in the active buffer
+		u64                   m_bufferOffset;   ///< Offset in the file of the active buffer
+		u64                   m_fileSize;       ///< Size of the file
+	};
+}
@@ -0,0 +1,563 @@
+#include "ContentCache.h"
+#include "core/hash/Hash.h"
+#include "core/string/Format.h"
+#include "Directory.h"
+#include "Entry.h"
+#include "File.h"
+
+namespace Onca::FileSystem
+{
+	namespace Detail
+	{
+		constexpr u32 ContentCacheMagic = 0x4943434F; // 'OCCI'
+		constexpr u32 ContentCacheVersion = 2;
+
+		/**
+		 * Find the slot of a key using linear probing
+		 * \tparam Slot Slot type
+		 * \param[in] pSlots Slots
+		 * \param[in] capacity Number of slots
+		 * \param[in] key Key
+		 * \param[in] forInsert Whether to return the first empty slot, instead of the slot containing the key
+		 * \return Slot, or nullptr if the key was not found
+		 * \note Removed slots are never reused, so a reader that is looking at a slot never sees it change to a different key
+		 */
+		template<typename Slot, typename State>
+		auto ProbeSlots(Slot* pSlots, u64 capacity, const ContentKey& key, bool forInsert) noexcept -> Slot*
+		{
+			const u64 mask = capacity - 1;
+			for (u64 i = 0, idx = key.hash & mask; i < capacity; ++i, idx = (idx + 1) & mask)
+			{
+				Slot& slot = pSlots[idx];
+				const State state = slot.state.Load(MemOrder::Acquire);
+				if (state == State::Empty)
+					return forInsert ? &slot : nullptr;
+				if (!forInsert && state == State::Used && slot.hash == key.hash && slot.check == key.check)
+					return &slot;
+			}
+			return nullptr;
+		}
+	}
+
+	auto ContentKey::FromData(const u8* pData, usize size) noexcept -> ContentKey
+	{
+		const u64 hash = Hashing::FVN1A_64{}(pData, size);
+		const u32 crc = Hashing::Crc32{}(pData, size);
+		return { hash, (u64(crc) << 32) | u32(size) };
+	}
+
+	ContentCache::ContentCache(const ContentCacheOptions& options) noexcept
+		: m_options(options)
+		, m_packFile(nullptr)
+		, m_indexFile(nullptr)
+		, m_mapping(nullptr)
+		, m_pHeader(nullptr)
+		, m_pSlots(nullptr)
+		, m_readers(0)
+		, m_remapping(false)
+	{
+		ASSERT(Math::IsPowOf2(m_options.initialCapacity), "Initial capacity of the content cache needs to be a power of 2");
+		ASSERT(m_options.evictPercentage <= 100, "Evict percentage needs to be in the range [0, 100]");
+	}
+
+	ContentCache::~ContentCache() noexcept
+	{
+		Close();
+	}
+
+	auto ContentCache::Open(const Path& dir) noexcept -> SystemError
+	{
+		Close();
+
+		Threading::Lock lock{ m_writeMutex };
+		if (!IsDirectory(dir))
+		{
+			SystemError err = CreateDirectory(dir);
+			if (!err)
+				return err;
+		}
+		m_dir = dir.AsAbsolute();
+
+		SystemError err = OpenNative(m_dir / "index.bin"_path, m_indexFile);
+		if (!err)
+			return err;
+
+		// Validate the existing index, an index that does not match expectations results in an empty cache
+		const u64 indexSize = GetSizeNative(m_indexFile);
+		bool valid = false;
+		if (indexSize >= sizeof(IndexHeader))
+		{
+			IndexHeader header;
+			err = ReadNative(m_indexFile, 0, reinterpret_cast<u8*>(&header), sizeof(IndexHeader));
+			valid = err &&
+			        header.magic == Detail::ContentCacheMagic &&
+			        header.version == Detail::ContentCacheVersion &&
+			        Math::IsPowOf2(header.capacity) &&
+			        indexSize == sizeof(IndexHeader) + header.capacity * sizeof(IndexSlot);
+		}
+
+		if (valid)
+		{
+			err = MapIndex(indexSize);
+			if (err)
+				err = OpenNative(GetPackPath(m_pHeader->packGen), m_packFile);
+			if (err)
+				err = RecoverTail();
+			valid = err;
+		}
+
+		if (!valid)
+		{
+			err = Reset();
+			if (!err)
+			{
+				UnmapIndex();
+				CloseNative(m_indexFile);
+				CloseNative(m_packFile);
+			}
+		}
+		return err;
+	}
+
+	void ContentCache::Close() noexcept
+	{
+		Threading::Lock lock{ m_writeMutex };
+		if (!IsOpen())
+			return;
+
+		BeginRemap();
+		m_packMapping = Arc<Detail::ContentPackMapping>{};
+		UnmapIndex();
+		CloseNative(m_indexFile);
+		CloseNative(m_packFile);
+		EndRemap();
+	}
+
+	auto ContentCache::Get(const ContentKey& key) noexcept -> Result<ContentView, SystemError>
+	{
+		BeginRead();
+		if (!IsOpen())
+		{
+			EndRead();
+			return SystemError{ SystemErrorCode::InvalidHandle };
+		}
+
+		IndexSlot* pSlot = FindSlot(key);
+		if (!pSlot)
+		{
+			EndRead();
+			return SystemError{ SystemErrorCode::NotFound, "Key is not in the content cache"_s };
+		}
+
+		pSlot->lastAccess.Store(m_pHeader->tick.FetchAdd(1, MemOrder::Relaxed) + 1, MemOrder::Relaxed);
+
+		const u64 offset = pSlot->offset;
+		const u64 size = pSlot->size;
+		if (!size)
+		{
+			EndRead();
+			return ContentView{};
+		}
+
+		Arc<Detail::ContentPackMapping> mapping = GetPackMapping(offset + size);
+		EndRead();
+
+		if (!mapping)
+			return SystemError{ SystemErrorCode::ReadFault, "Could not map the content cache pack"_s };
+		const u8* pData = mapping->pData + offset;
+		return ContentView{ Onca::Move(mapping), pData, usize(size) };
+	}
+
+	auto ContentCache::Contains(const ContentKey& key) noexcept -> bool
+	{
+		BeginRead();
+		const bool found = IsOpen() && FindSlot(key);
+		EndRead();
+		return found;
+	}
+
+	auto ContentCache::Put(const ContentKey& key, const u8* pData, usize size) noexcept -> SystemError
+	{
+		Threading::Lock lock{ m_writeMutex };
+		if (!IsOpen())
+			return SystemErrorCode::InvalidHandle;
+
+		// Keep the load factor of the index below 70%, including removed slots
+		if ((m_pHeader->used + 1) * 10 > m_pHeader->capacity * 7)
+		{
+			u64 capacity = m_pHeader->capacity;
+			while ((m_pHeader->count + 1) * 2 > capacity)
+				capacity *= 2;
+
+			SystemError err = Rebuild(u64(-1), capacity);
+			if (!err)
+				return err;
+		}
+
+		// Data is appended before the slot is published, so readers never see a slot with incomplete data
+		const u64 offset = m_pHeader->packSize;
+		SystemError err = WriteNative(m_packFile, offset, pData, size);
+		if (!err)
+			return err;
+
+		IndexSlot* pOld = FindSlot(key);
+		IndexSlot* pSlot = FindInsertSlot(key);
+		pSlot->hash = key.hash;
+		pSlot->check = key.check;
+		pSlot->offset = offset;
+		pSlot->size = size;
+		pSlot->crc = Hashing::Crc32{}(pData, size);
+		pSlot->lastAccess.Store(m_pHeader->tick.FetchAdd(1, MemOrder::Relaxed) + 1, MemOrder::Relaxed);
+		pSlot->state.Store(SlotState::Used, MemOrder::Release);
+
+		++m_pHeader->used;
+		++m_pHeader->count;
+		m_pHeader->packSize += size;
+		m_pHeader->liveSize += size;
+
+		if (pOld)
+		{
+			pOld->state.Store(SlotState::Removed, MemOrder::Release);
+			--m_pHeader->count;
+			m_pHeader->liveSize -= pOld->size;
+		}
+
+		if (m_pHeader->packSize > m_options.maxPackSize)
+			return Rebuild(m_options.maxPackSize / 100 * (100 - m_options.evictPercentage), m_pHeader->capacity);
+		return SystemErrorCode::Success;
+	}
+
+	auto ContentCache::Remove(const ContentKey& key) noexcept -> bool
+	{
+		Threading::Lock lock{ m_writeMutex };
+		if (!IsOpen())
+			return false;
+
+		IndexSlot* pSlot = FindSlot(key);
+		if (!pSlot)
+			return false;
+
+		pSlot->state.Store(SlotState::Removed, MemOrder::Release);
+		--m_pHeader->count;
+		m_pHeader->liveSize -= pSlot->size;
+		return true;
+	}
+
+	auto ContentCache::Compact(u64 targetSize) noexcept -> SystemError
+	{
+		Threading::Lock lock{ m_writeMutex };
+		if (!IsOpen())
+			return SystemErrorCode::InvalidHandle;
+		return Rebuild(targetSize, m_pHeader->capacity);
+	}
+
+	auto ContentCache::Flush() noexcept -> SystemError
+	{
+		Threading::Lock lock{ m_writeMutex };
+		if (!IsOpen())
+			return SystemErrorCode::InvalidHandle;
+
+		// The pack needs to be on disk before the index that references it
+		SystemError err = FlushNative(m_packFile);
+		if (!err)
+			return err;
+		m_pHeader->flushSize = m_pHeader->packSize;
+		return FlushIndex();
+	}
+
+	auto ContentCache::GetCount() const noexcept -> u64
+	{
+		return m_pHeader ? m_pHeader->count : 0;
+	}
+
+	auto ContentCache::GetPackSize() const noexcept -> u64
+	{
+		return m_pHeader ? m_pHeader->packSize : 0;
+	}
+
+	auto ContentCache::FindSlot(const ContentKey& key) const noexcept -> IndexSlot*
+	{
+		return Detail::ProbeSlots<IndexSlot, SlotState>(m_pSlots, m_pHeader->capacity, key, false);
+	}
+
+	auto ContentCache::FindInsertSlot(const ContentKey& key) noexcept -> IndexSlot*
+	{
+		IndexSlot* pSlot = Detail::ProbeSlots<IndexSlot, SlotState>(m_pSlots, m_pHeader->capacity, key, true);
+		ASSERT(pSlot, "Content cache index is full");
+		return pSlot;
+	}
+
+	auto ContentCache::FindEvictionTick(u64 targetSize) const noexcept -> u64
+	{
+		// The size that is kept decreases when the tick increases, so binary search for the smallest tick that fits
+		u64 lo = 0;
+		u64 hi = m_pHeader->tick.Load(MemOrder::Relaxed) + 1;
+		while (lo < hi)
+		{
+			const u64 mid = lo + (hi - lo) / 2;
+			u64 keptSize = 0;
+			for (u64 i = 0; i < m_pHeader->capacity; ++i)
+			{
+				const IndexSlot& slot = m_pSlots[i];
+				if (slot.state.Load(MemOrder::Relaxed) == SlotState::Used && slot.lastAccess.Load(MemOrder::Relaxed) >= mid)
+					keptSize += slot.size;
+			}
+
+			if (keptSize <= targetSize)
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	auto ContentCache::RecoverTail() noexcept -> SystemError
+	{
+		// Data before the last flush is known to be on disk, so a pack that is smaller than that means data was lost
+		const u64 fileSize = GetSizeNative(m_packFile);
+		if (fileSize < m_pHeader->flushSize || m_pHeader->flushSize > m_pHeader->packSize)
+			return SystemError{ SystemErrorCode::ReadFault, "Content cache pack is missing flushed data"_s };
+
+		DynArray<u8> buffer;
+		u64 validEnd = m_pHeader->flushSize;
+		for (u64 i = 0; i < m_pHeader->capacity; ++i)
+		{
+			IndexSlot& slot = m_pSlots[i];
+			if (slot.state.Load(MemOrder::Relaxed) != SlotState::Used)
+				continue;
+
+			const u64 end = slot.offset + slot.size;
+			if (end <= m_pHeader->flushSize)
+				continue;
+
+			bool valid = end <= fileSize && slot.offset >= m_pHeader->flushSize;
+			if (valid)
+			{
+				buffer.Resize(slot.size);
+				valid = ReadNative(m_packFile, slot.offset, buffer.Data(), slot.size) && Hashing::Crc32{}(buffer.Data(), slot.size) == slot.crc;
+			}
+
+			if (valid)
+			{
+				validEnd = Math::Max(validEnd, end);
+			}
+			else
+			{
+				slot.state.Store(SlotState::Removed, MemOrder::Relaxed);
+				--m_pHeader->count;
+				m_pHeader->liveSize -= slot.size;
+			}
+		}
+
+		// Anything after the last valid entry is either torn or belongs to an append that was never published
+		m_pHeader->packSize = validEnd;
+		if (fileSize > validEnd)
+			return SetSizeNative(m_packFile, validEnd);
+		return SystemErrorCode::Success;
+	}
+
+	auto ContentCache::GetPackMapping(u64 minSize) noexcept -> Arc<Detail::ContentPackMapping>
+	{
+		Threading::Lock lock{ m_mapMutex };
+		if (m_packMapping && m_packMapping->size >= minSize)
+			return m_packMapping;
+
+		// Published data is always in the pack file, so its current size covers every entry a reader can find
+		// Views into the previous mapping keep it alive, so it is only unmapped once they are all released
+		Arc<Detail::ContentPackMapping> mapping = Arc<Detail::ContentPackMapping>::Create();
+		if (!MapReadOnlyNative(m_packFile, GetSizeNative(m_packFile), *mapping))
+			return Arc<Detail::ContentPackMapping>{};
+
+		m_packMapping = mapping;
+		return mapping;
+	}
+
+	auto ContentCache::Rebuild(u64 targetSize, u64 capacity) noexcept -> SystemError
+	{
+		const u64 oldGen = m_pHeader->packGen;
+		const u64 newGen = oldGen + 1;
+		const Path newPackPath = GetPackPath(newGen);
+		UNUSED(DeleteFile(newPackPath));
+
+		NativeHandle newPack;
+		SystemError err = OpenNative(newPackPath, newPack);
+		if (!err)
+			return err;
+
+		const u64 minTick = m_pHeader->liveSize > targetSize ? FindEvictionTick(targetSize) : 0;
+
+		// Build the new index in memory, it only replaces the current index once all data has been written
+		const u64 indexSize = sizeof(IndexHeader) + capacity * sizeof(IndexSlot);
+		DynArray<u8> index;
+		index.Resize(indexSize, 0);
+		IndexHeader* pHeader = reinterpret_cast<IndexHeader*>(index.Data());
+		IndexSlot* pSlots = reinterpret_cast<IndexSlot*>(pHeader + 1);
+
+		DynArray<u8> buffer;
+		u64 packSize = 0;
+		u64 count = 0;
+		for (u64 i = 0; i < m_pHeader->capacity; ++i)
+		{
+			const IndexSlot& slot = m_pSlots[i];
+			if (slot.state.Load(MemOrder::Relaxed) != SlotState::Used || slot.lastAccess.Load(MemOrder::Relaxed) < minTick)
+				continue;
+
+			buffer.Resize(slot.size);
+			err = ReadNative(m_packFile, slot.offset, buffer.Data(), slot.size);
+			if (err)
+				err = WriteNative(newPack, packSize, buffer.Data(), slot.size);
+			if (!err)
+			{
+				CloseNative(newPack);
+				UNUSED(DeleteFile(newPackPath));
+				return err;
+			}
+
+			IndexSlot* pDst = Detail::ProbeSlots<IndexSlot, SlotState>(pSlots, capacity, { slot.hash, slot.check }, true);
+			pDst->hash = slot.hash;
+			pDst->check = slot.check;
+			pDst->offset = packSize;
+			pDst->size = slot.size;
+			pDst->crc = slot.crc;
+			pDst->lastAccess.Store(slot.lastAccess.Load(MemOrder::Relaxed), MemOrder::Relaxed);
+			pDst->state.Store(SlotState::Used, MemOrder::Relaxed);
+
+			packSize += slot.size;
+			++count;
+		}
+
+		pHeader->magic = Detail::ContentCacheMagic;
+		pHeader->version = Detail::ContentCacheVersion;
+		pHeader->capacity = capacity;
+		pHeader->count = count;
+		pHeader->used = count;
+		pHeader->packSize = packSize;
+		pHeader->liveSize = packSize;
+		pHeader->flushSize = packSize;
+		pHeader->packGen = newGen;
+		pHeader->tick.Store(m_pHeader->tick.Load(MemOrder::Relaxed), MemOrder::Relaxed);
+
+		err = FlushNative(newPack);
+
+		// Write the new index to a temporary file, so the rename below is the only point where the cache switches over
+		const Path indexPath = m_dir / "index.bin"_path;
+		const Path tmpIndexPath = m_dir / "index.tmp"_path;
+		if (err)
+		{
+			UNUSED(DeleteFile(tmpIndexPath));
+			NativeHandle tmpIndex;
+			err = OpenNative(tmpIndexPath, tmpIndex);
+			if (err)
+			{
+				err = WriteNative(tmpIndex, 0, index.Data(), indexSize);
+				if (err)
+					err = FlushNative(tmpIndex);
+				CloseNative(tmpIndex);
+			}
+		}
+
+		if (!err)
+		{
+			CloseNative(newPack);
+			UNUSED(DeleteFile(newPackPath));
+			UNUSED(DeleteFile(tmpIndexPath));
+			return err;
+		}
+
+		BeginRemap();
+		m_packMapping = Arc<Detail::ContentPackMapping>{};
+		UnmapIndex();
+		CloseNative(m_indexFile);
+
+		err = FileSystem::Move(tmpIndexPath, indexPath, MoveFlag::ReplaceExisting | MoveFlag::Wait);
+		const bool switched = err;
+		if (switched)
+		{
+			CloseNative(m_packFile);
+			m_packFile = newPack;
+		}
+		else
+		{
+			CloseNative(newPack);
+		}
+
+		// Reopen whichever index is now in place
+		SystemError mapErr = OpenNative(indexPath, m_indexFile);
+		if (mapErr)
+			mapErr = MapIndex(GetSizeNative(m_indexFile));
+		if (!mapErr)
+		{
+			CloseNative(m_indexFile);
+			CloseNative(m_packFile);
+		}
+		EndRemap();
+
+		UNUSED(DeleteFile(switched ? GetPackPath(oldGen) : newPackPath));
+		return err ? mapErr : err;
+	}
+
+	auto ContentCache::Reset() noexcept -> SystemError
+	{
+		m_packMapping = Arc<Detail::ContentPackMapping>{};
+		UnmapIndex();
+		CloseNative(m_indexFile);
+		CloseNative(m_packFile);
+
+		const Path indexPath = m_dir / "index.bin"_path;
+		UNUSED(DeleteFile(indexPath));
+		SystemError err = OpenNative(indexPath, m_indexFile);
+		if (!err)
+			return err;
+
+		// Mapping a larger size than the file grows the file, with the new content zeroed
+		const u64 capacity = m_options.initialCapacity;
+		err = MapIndex(sizeof(IndexHeader) + capacity * sizeof(IndexSlot));
+		if (!err)
+			return err;
+
+		m_pHeader->magic = Detail::ContentCacheMagic;
+		m_pHeader->version = Detail::ContentCacheVersion;
+		m_pHeader->capacity = capacity;
+
+		const Path packPath = GetPackPath(0);
+		UNUSED(DeleteFile(packPath));
+		return OpenNative(packPath, m_packFile);
+	}
+
+	auto ContentCache::GetPackPath(u64 gen) const noexcept -> Path
+	{
+		return m_dir / Path{ Format("pack{}.bin"_s, gen) };
+	}
+
+	void ContentCache::BeginRead() noexcept
+	{
+		while (true)
+		{
+			m_readers.FetchAdd(1, MemOrder::Acquire);
+			if (!m_remapping.Load(MemOrder::Acquire))
+				return;
+
+			EndRead();
+			m_remapping.Wait(true);
+		}
+	}
+
+	void ContentCache::EndRead() noexcept
+	{
+		if (m_readers.FetchSub(1, MemOrder::Release) == 1)
+			m_readers.NotifyAll();
+	}
+
+	void ContentCache::BeginRemap() noexcept
+	{
+		m_remapping.Store(true, MemOrder::Release);
+		for (u32 readers = m_readers.Load(MemOrder::Acquire); readers; readers = m_readers.Load(MemOrder::Acquire))
+			m_readers.Wait(readers);
+	}
+
+	void ContentCache::EndRemap() noexcept
+	{
+		m_remapping.Store(false, MemOrder::Release);
+		m_remapping.NotifyAll();
+	}
+}
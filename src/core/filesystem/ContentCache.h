@@ -0,0 +1,411 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/containers/ByteBuffer.h"
+#include "core/memory/RefCounted.h"
+#include "core/string/StringId.h"
+#include "core/threading/Sync.h"
+#include "core/utils/Result.h"
+#include "Path.h"
+
+namespace Onca::FileSystem
+{
+	/**
+	 * Key of an entry in a content cache
+	 */
+	struct ContentKey
+	{
+		u64 hash  = 0; ///< Primary hash, used to find the entry
+		u64 check = 0; ///< Secondary hash, used to reject collisions of the primary hash
+
+		constexpr ContentKey() noexcept = default;
+		/**
+		 * Create a key from 2 hashes
+		 * \param[in] hash Primary hash
+		 * \param[in] check Secondary hash
+		 */
+		constexpr ContentKey(u64 hash, u64 check) noexcept : hash(hash), check(check) {}
+		/**
+		 * Create a key from a string id
+		 * \param[in] id String id
+		 */
+		constexpr ContentKey(StringId id) noexcept : hash(u64(id)), check(0) {}
+
+		constexpr auto operator==(const ContentKey& other) const noexcept -> bool = default;
+
+		/**
+		 * Create a key from the content of a buffer
+		 * \param[in] pData Data
+		 * \param[in] size Size of the data
+		 * \return Key
+		 * \note The key consists of a 64-bit FNV-1a hash and a 32-bit CRC combined with the size
+		 */
+		static auto FromData(const u8* pData, usize size) noexcept -> ContentKey;
+	};
+
+	namespace Detail
+	{
+		/**
+		 * Read-only mapping of a content cache pack file, unmapped when the last view into it is released
+		 */
+		struct CORE_API ContentPackMapping
+		{
+			void*     handle = nullptr; ///< Native mapping handle
+			const u8* pData  = nullptr; ///< Mapped data
+			u64       size   = 0;       ///< Size of the mapped data
+
+			~ContentPackMapping() noexcept;
+		};
+	}
+
+	/**
+	 * Read-only view of the data of a content cache entry
+	 *
+	 * The view points directly into the memory mapped pack file, so getting an entry does not copy its data.
+	 * The view keeps the mapping alive, so it stays valid when the cache is written to, compacted or closed.
+	 */
+	class CORE_API ContentView
+	{
+	public:
+		/**
+		 * Create an empty view
+		 */
+		ContentView() noexcept = default;
+
+		/**
+		 * Copy the data of the view into a buffer
+		 * \return Buffer
+		 */
+		auto ToBuffer() const noexcept -> ByteBuffer { return ByteBuffer{ m_pData, m_size }; }
+
+		/**
+		 * Get the data of the view
+		 * \return Data
+		 */
+		auto Data() const noexcept -> const u8* { return m_pData; }
+		/**
+		 * Get the size of the view
+		 * \return Size
+		 */
+		auto Size() const noexcept -> usize { return m_size; }
+		/**
+		 * Check if the view is empty
+		 * \return Whether the view is empty
+		 */
+		auto IsEmpty() const noexcept -> bool { return !m_size; }
+
+	private:
+		friend class ContentCache;
+
+		ContentView(Arc<Detail::ContentPackMapping>&& mapping, const u8* pData, usize size) noexcept
+			: m_mapping(Onca::Move(mapping))
+			, m_pData(pData)
+			, m_size(size)
+		{}
+
+		Arc<Detail::ContentPackMapping> m_mapping;         ///< Mapping the data is in
+		const u8*                       m_pData = nullptr; ///< Data
+		usize                           m_size  = 0;       ///< Size of the data
+	};
+
+	/**
+	 * Content cache options
+	 */
+	struct ContentCacheOptions
+	{
+		u64 maxPackSize     = 256_MiB; ///< Max size of the pack file, least recently used entries get evicted when the pack grows larger
+		u8  evictPercentage = 25;      ///< Percentage of the max pack size that is freed when evicting
+		u32 initialCapacity = 4096;    ///< Initial capacity of the index (needs to be a power of 2)
+	};
+
+	/**
+	 * Persistent content-addressed cache
+	 *
+	 * The cache consists of 2 files in its directory:
+	 * - an append-only pack file that contains the data of all entries
+	 * - an open-addressed index that is memory mapped, so a lookup does not need to load anything
+	 *
+	 * Entries are written to the end of the pack file before being published in the index.
+	 * The OS writes back the mapped index independently of the pack file though, so after a crash the index can reference data that never reached the disk.
+	 * Entries appended since the last Flush() are therefore checked against their size and CRC when the cache is opened, torn entries are dropped and the pack is truncated after the last valid entry.
+	 * When the cache gets compacted, the new pack and index are first written to temporary files, after which the index is renamed over the old one.
+	 *
+	 * Lookups can run concurrently with each other, writes are serialized.
+	 * Only a single process can have a cache open, the cache files are not shared for writing, so opening a cache that is in use by another process fails with SystemErrorCode::ShareViolation.
+	 */
+	class CORE_API ContentCache
+	{
+	public:
+		DEFINE_OPAQUE_HANDLE(NativeHandle);
+
+		DISABLE_COPY(ContentCache);
+		DISABLE_MOVE(ContentCache);
+
+		/**
+		 * Create a closed content cache
+		 * \param[in] options Options
+		 */
+		explicit ContentCache(const ContentCacheOptions& options = {}) noexcept;
+		~ContentCache() noexcept;
+
+		/**
+		 * Open the cache in a directory, the directory and cache files will be created if they don't exist
+		 * \param[in] dir Cache directory
+		 * \return Error
+		 * \note An index that cannot be validated results in an empty cache, torn entries at the end of the pack are dropped
+		 */
+		auto Open(const Path& dir) noexcept -> SystemError;
+		/**
+		 * Close the cache
+		 */
+		void Close() noexcept;
+
+		/**
+		 * Get the data of an entry
+		 * \param[in] key Key
+		 * \return Result with a view of the data, or SystemErrorCode::NotFound if the cache does not contain the key
+		 */
+		auto Get(const ContentKey& key) noexcept -> Result<ContentView, SystemError>;
+		/**
+		 * Check if the cache contains a key
+		 * \param[in] key Key
+		 * \return Whether the cache contains the key
+		 */
+		auto Contains(const ContentKey& key) noexcept -> bool;
+		/**
+		 * Add an entry to the cache, overwriting any existing entry with the same key
+		 * \param[in] key Key
+		 * \param[in] pData Data
+		 * \param[in] size Size of the data
+		 * \return Error
+		 */
+		auto Put(const ContentKey& key, const u8* pData, usize size) noexcept -> SystemError;
+		/**
+		 * Add an entry to the cache, overwriting any existing entry with the same key
+		 * \param[in] key Key
+		 * \param[in] data Data
+		 * \return Error
+		 */
+		auto Put(const ContentKey& key, const ByteBuffer& data) noexcept -> SystemError { return Put(key, data.Data(), data.Size()); }
+		/**
+		 * Remove an entry from the cache
+		 * \param[in] key Key
+		 * \return Whether an entry was removed
+		 * \note The data of the entry stays in the pack file until the cache is compacted
+		 */
+		auto Remove(const ContentKey& key) noexcept -> bool;
+
+		/**
+		 * Compact the cache, dropping removed entries and evicting least recently used entries until the pack is smaller than the target size
+		 * \param[in] targetSize Target size of the pack file
+		 * \return Error
+		 */
+		auto Compact(u64 targetSize = u64(-1)) noexcept -> SystemError;
+		/**
+		 * Flush all changes to disk
+		 * \return Error
+		 */
+		auto Flush() noexcept -> SystemError;
+
+		/**
+		 * Get the number of entries in the cache
+		 * \return Number of entries
+		 */
+		auto GetCount() const noexcept -> u64;
+		/**
+		 * Get the size of the pack file
+		 * \return Size of the pack file
+		 */
+		auto GetPackSize() const noexcept -> u64;
+		/**
+		 * Check if the cache is open
+		 * \return Whether the cache is open
+		 */
+		auto IsOpen() const noexcept -> bool { return m_pHeader; }
+
+	private:
+		struct IndexHeader
+		{
+			u32         magic;     ///< Magic
+			u32         version;   ///< Version of the index layout
+			u64         capacity;  ///< Number of slots
+			u64         count;     ///< Number of live entries
+			u64         used;      ///< Number of used slots (including removed entries)
+			u64         packSize;  ///< Size of the pack file
+			u64         liveSize;  ///< Size of the data of all live entries
+			u64         flushSize; ///< Size of the pack file at the last flush, entries past it are validated when opening
+			u64         packGen;   ///< Generation of the pack file, incremented on each compaction
+			Atomic<u64> tick;      ///< Access counter, used to track recently used entries
+		};
+
+		enum class SlotState : u32
+		{
+			Empty,   ///< Slot was never used
+			Used,    ///< Slot contains a live entry
+			Removed, ///< Slot contained an entry that was removed
+		};
+
+		struct IndexSlot
+		{
+			u64               hash;       ///< Primary hash
+			u64               check;      ///< Secondary hash
+			u64               offset;     ///< Offset of the data in the pack file
+			u64               size;       ///< Size of the data
+			Atomic<u64>       lastAccess; ///< Tick of the last access
+			u32               crc;        ///< CRC of the data
+			Atomic<SlotState> state;      ///< State, written last when publishing a slot
+		};
+
+		/**
+		 * Find the slot of a key
+		 * \param[in] key Key
+		 * \return Slot, or nullptr if the key is not in the index
+		 */
+		auto FindSlot(const ContentKey& key) const noexcept -> IndexSlot*;
+		/**
+		 * Find the slot a new key can be inserted in
+		 * \param[in] key Key
+		 * \return Slot
+		 */
+		auto FindInsertSlot(const ContentKey& key) noexcept -> IndexSlot*;
+		/**
+		 * Find the oldest access tick that still fits in the target size, when only keeping entries accessed at or after that tick
+		 * \param[in] targetSize Target size of the pack file
+		 * \return Access tick
+		 */
+		auto FindEvictionTick(u64 targetSize) const noexcept -> u64;
+		/**
+		 * Drop entries that were appended since the last flush, but whose data did not fully reach the pack file
+		 * \return Error
+		 */
+		auto RecoverTail() noexcept -> SystemError;
+		/**
+		 * Get a mapping of the pack file that covers at least a given size, remapping the pack when it grew
+		 * \param[in] minSize Minimum size the mapping needs to cover
+		 * \return Mapping, or a null mapping if the pack could not be mapped
+		 * \note Needs to be called in a read section
+		 */
+		auto GetPackMapping(u64 minSize) noexcept -> Arc<Detail::ContentPackMapping>;
+		/**
+		 * Throw away the current content, and create an empty index and pack file
+		 * \return Error
+		 */
+		auto Reset() noexcept -> SystemError;
+		/**
+		 * Rewrite the pack file and index, keeping the most recently used entries up to a target size
+		 * \param[in] targetSize Target size of the pack file
+		 * \param[in] capacity Capacity of the new index
+		 * \return Error
+		 */
+		auto Rebuild(u64 targetSize, u64 capacity) noexcept -> SystemError;
+		/**
+		 * Get the path to a pack file
+		 * \param[in] gen Generation of the pack file
+		 * \return Path to the pack file
+		 */
+		auto GetPackPath(u64 gen) const noexcept -> Path;
+
+		/**
+		 * Enter a read section, waiting if the index is being remapped
+		 */
+		void BeginRead() noexcept;
+		/**
+		 * Exit a read section
+		 */
+		void EndRead() noexcept;
+		/**
+		 * Block new read sections and wait until all current read sections have finished
+		 */
+		void BeginRemap() noexcept;
+		/**
+		 * Allow read sections again
+		 */
+		void EndRemap() noexcept;
+
+		/**
+		 * Open or create a native file
+		 * \param[in] path Path to the file
+		 * \param[out] handle Native handle
+		 * \return Error
+		 */
+		static auto OpenNative(const Path& path, NativeHandle& handle) noexcept -> SystemError;
+		/**
+		 * Close a native file
+		 * \param[in] handle Native handle
+		 */
+		static void CloseNative(NativeHandle& handle) noexcept;
+		/**
+		 * Read from a native file at an offset
+		 * \param[in] handle Native handle
+		 * \param[in] offset Offset in the file
+		 * \param[out] pData Buffer to read into
+		 * \param[in] size Number of bytes to read
+		 * \return Error
+		 */
+		static auto ReadNative(NativeHandle handle, u64 offset, u8* pData, u64 size) noexcept -> SystemError;
+		/**
+		 * Write to a native file at an offset
+		 * \param[in] handle Native handle
+		 * \param[in] offset Offset in the file
+		 * \param[in] pData Data to write
+		 * \param[in] size Number of bytes to write
+		 * \return Error
+		 */
+		static auto WriteNative(NativeHandle handle, u64 offset, const u8* pData, u64 size) noexcept -> SystemError;
+		/**
+		 * Flush a native file
+		 * \param[in] handle Native handle
+		 * \return Error
+		 */
+		static auto FlushNative(NativeHandle handle) noexcept -> SystemError;
+		/**
+		 * Get the size of a native file
+		 * \param[in] handle Native handle
+		 * \return Size of the file
+		 */
+		static auto GetSizeNative(NativeHandle handle) noexcept -> u64;
+		/**
+		 * Set the size of a native file
+		 * \param[in] handle Native handle
+		 * \param[in] size New size of the file
+		 * \return Error
+		 */
+		static auto SetSizeNative(NativeHandle handle, u64 size) noexcept -> SystemError;
+		/**
+		 * Map a native file into memory as read-only
+		 * \param[in] handle Native handle
+		 * \param[in] size Size of the mapping, needs to be larger than 0 and not larger than the file
+		 * \param[out] mapping Mapping
+		 * \return Error
+		 */
+		static auto MapReadOnlyNative(NativeHandle handle, u64 size, Detail::ContentPackMapping& mapping) noexcept -> SystemError;
+		/**
+		 * Map the index file into memory
+		 * \param[in] size Size of the mapping
+		 * \return Error
+		 */
+		auto MapIndex(u64 size) noexcept -> SystemError;
+		/**
+		 * Unmap the index file
+		 */
+		void UnmapIndex() noexcept;
+		/**
+		 * Flush the mapped index to disk
+		 * \return Error
+		 */
+		auto FlushIndex() noexcept -> SystemError;
+
+		ContentCacheOptions m_options;     ///< Options
+		Path                m_dir;         ///< Cache directory
+		NativeHandle        m_packFile;    ///< Pack file
+		NativeHandle        m_indexFile;   ///< Index file
+		NativeHandle        m_mapping;     ///< Index file mapping
+		IndexHeader*        m_pHeader;     ///< Mapped index header
+		IndexSlot*          m_pSlots;      ///< Mapped index slots
+		Threading::Mutex    m_writeMutex;  ///< Mutex serializing writes
+		Atomic<u32>         m_readers;     ///< Number of active read sections
+		Atomic<bool>        m_remapping;   ///< Whether the index is being remapped
+
+		Arc<Detail::ContentPackMapping> m_packMapping; ///< Most recent mapping of the pack file
+		Threading::Mutex                m_mapMutex;    ///< Mutex protecting the pack mapping
+	};
+}
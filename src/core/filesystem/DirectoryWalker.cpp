@@ -0,0 +1,283 @@
+#include "DirectoryWalker.h"
+#include "core/threading/Thread.h"
+
+namespace Onca::FileSystem
+{
+	EntryBatch::EntryBatch(Alloc::IAllocator& alloc) noexcept
+		: m_dir(alloc)
+		, m_names(alloc)
+		, m_items(alloc)
+		, m_depth(0)
+	{
+	}
+
+	auto EntryBatch::GetItem(usize idx) const noexcept -> const Item&
+	{
+		ASSERT(idx < m_items.Size(), "Index out of range");
+		return m_items[idx];
+	}
+
+	auto EntryBatch::IsDirectory(usize idx) const noexcept -> bool
+	{
+		return GetItem(idx).attribs & FileAttribute::Directory;
+	}
+
+	auto EntryBatch::GetName(usize idx) const noexcept -> String
+	{
+		const Item& item = GetItem(idx);
+		const char16_t* pBegin = m_names.Data() + item.nameOffset;
+		return String{ pBegin, pBegin + item.nameLength, *m_names.GetAllocator() };
+	}
+
+	auto EntryBatch::GetPath(usize idx) const noexcept -> Path
+	{
+		return m_dir / Path{ GetName(idx) };
+	}
+
+	auto EntryBatch::GetEntry(usize idx) const noexcept -> Entry
+	{
+		const Item& item = GetItem(idx);
+		return
+		{
+			.path = GetPath(idx),
+			.attribs = item.attribs,
+			.creationTimeStamp = item.creationTimeStamp,
+			.lastAccessTimestamp = item.lastAccessTimestamp,
+			.lastWriteTimestamp = item.lastWriteTimestamp,
+			.size = item.size
+		};
+	}
+
+	void EntryBatch::Clear() noexcept
+	{
+		m_names.Clear();
+		m_items.Clear();
+	}
+
+	void EntryBatch::Add(const char16_t* pName, u32 nameLen, Item item) noexcept
+	{
+		item.nameOffset = u32(m_names.Size());
+		item.nameLength = nameLen;
+
+		m_names.Resize(m_names.Size() + nameLen);
+		MemCpy(m_names.Data() + item.nameOffset, pName, nameLen * sizeof(char16_t));
+		m_items.Add(item);
+	}
+
+	DirectoryWalker::DirectoryWalker(const Path& root, const DirectoryWalkOptions& options) noexcept
+		: m_options(options)
+		, m_state{ .handle = nullptr, .offset = 0, .hasData = false }
+		, m_stateOpen(false)
+		, m_queueVersion(0)
+		, m_pendingDirs(0)
+		, m_done(false)
+	{
+		m_options.batchSize = Math::Max(m_options.batchSize, 1u);
+		m_options.numThreads = Math::Max(m_options.numThreads, u16(1));
+		m_stack.Add({ root, 0 });
+	}
+
+	DirectoryWalker::~DirectoryWalker() noexcept
+	{
+		if (m_stateOpen)
+			CloseDir(m_state);
+	}
+
+	auto DirectoryWalker::Next(EntryBatch& batch) noexcept -> bool
+	{
+		batch.Clear();
+
+		DynArray<PendingDir> subDirs;
+		while (true)
+		{
+			if (!m_stateOpen)
+			{
+				if (m_stack.IsEmpty())
+					return false;
+
+				PendingDir dir = Onca::Move(m_stack.Back());
+				m_stack.Pop();
+
+				SystemError err = OpenDir(m_state, Onca::Move(dir));
+				if (!err.Succeeded())
+				{
+					SetError(err);
+					continue;
+				}
+				m_stateOpen = true;
+			}
+
+			const bool hasMore = ReadBatch(m_state, batch, subDirs);
+			for (PendingDir& subDir : subDirs)
+				m_stack.Add(Onca::Move(subDir));
+			subDirs.Clear();
+
+			if (!hasMore)
+			{
+				CloseDir(m_state);
+				m_stateOpen = false;
+			}
+
+			if (!batch.IsEmpty())
+				return true;
+		}
+	}
+
+	auto DirectoryWalker::Walk(EntryBatchCallback callback) noexcept -> SystemError
+	{
+		if (m_options.numThreads <= 1)
+		{
+			EntryBatch batch;
+			while (Next(batch))
+				callback(batch);
+			return m_error;
+		}
+
+		// Move all directories that still need to be walked to the shared queue
+		for (PendingDir& dir : m_stack)
+			m_queue.Push(Onca::Move(dir));
+		m_pendingDirs.Store(m_queue.Size());
+		m_stack.Clear();
+		m_done.Store(m_queue.IsEmpty());
+
+		auto workerFunc = [this, &callback]() -> u32
+		{
+			WorkerLoop(callback);
+			return 0;
+		};
+		const Delegate<u32()> workerDelegate{ workerFunc };
+
+		DynArray<Threading::Thread> workers;
+		workers.Reserve(m_options.numThreads - 1);
+		for (u16 i = 1; i < m_options.numThreads; ++i)
+		{
+			Threading::ThreadAttribs attribs{ .desc = "DirectoryWalker worker"_s };
+			Result<Threading::Thread, SystemError> res = Threading::Thread::Create(attribs, workerDelegate);
+			if (res.Failed())
+			{
+				SetError(res.Error());
+				break;
+			}
+			workers.Add(res.MoveValue());
+		}
+
+		// The calling thread also takes part in the walk
+		WorkerLoop(callback);
+
+		for (Threading::Thread& worker : workers)
+			worker.Join();
+		return m_error;
+	}
+
+	void DirectoryWalker::WorkerLoop(EntryBatchCallback& callback) noexcept
+	{
+		ReadState state{ .handle = nullptr, .offset = 0, .hasData = false };
+		EntryBatch batch;
+		DynArray<PendingDir> subDirs;
+		// Directories that did not fit in the shared queue, these are walked depth first by this thread
+		DynArray<PendingDir> local;
+
+		while (true)
+		{
+			PendingDir dir;
+			if (!local.IsEmpty())
+			{
+				dir = Onca::Move(local.Back());
+				local.Pop();
+			}
+			else if (!PopShared(dir))
+			{
+				break;
+			}
+
+			SystemError err = OpenDir(state, Onca::Move(dir));
+			if (!err.Succeeded())
+			{
+				SetError(err);
+				FinishDir();
+				continue;
+			}
+
+			bool hasMore = true;
+			while (hasMore)
+			{
+				batch.Clear();
+				hasMore = ReadBatch(state, batch, subDirs);
+				if (!batch.IsEmpty())
+					callback(batch);
+
+				if (subDirs.IsEmpty())
+					continue;
+
+				m_pendingDirs.FetchAdd(subDirs.Size(), MemOrder::AcqRel);
+
+				usize pushed = 0;
+				{
+					Threading::Lock lock{ m_queueMutex };
+					for (; pushed < subDirs.Size() && m_queue.Size() < m_options.maxQueuedDirs; ++pushed)
+						m_queue.Push(Onca::Move(subDirs[pushed]));
+				}
+				for (usize i = pushed; i < subDirs.Size(); ++i)
+					local.Add(Onca::Move(subDirs[i]));
+				subDirs.Clear();
+
+				if (pushed)
+				{
+					m_queueVersion.FetchAdd(1, MemOrder::Release);
+					if (pushed == 1)
+						m_queueVersion.NotifyOne();
+					else
+						m_queueVersion.NotifyAll();
+				}
+			}
+
+			CloseDir(state);
+			FinishDir();
+		}
+	}
+
+	auto DirectoryWalker::PopShared(PendingDir& dir) noexcept -> bool
+	{
+		while (true)
+		{
+			// Read the version before checking the queue, so a push in between the check and the wait will wake us up
+			const u32 version = m_queueVersion.Load(MemOrder::Acquire);
+			{
+				Threading::Lock lock{ m_queueMutex };
+				if (!m_queue.IsEmpty())
+				{
+					dir = Onca::Move(m_queue.Front());
+					m_queue.PopFront();
+					return true;
+				}
+			}
+
+			if (m_done.Load(MemOrder::Acquire))
+				return false;
+			m_queueVersion.Wait(version, MemOrder::Acquire);
+		}
+	}
+
+	void DirectoryWalker::FinishDir() noexcept
+	{
+		if (m_pendingDirs.FetchSub(1, MemOrder::AcqRel) != 1)
+			return;
+
+		m_done.Store(true, MemOrder::Release);
+		m_queueVersion.FetchAdd(1, MemOrder::Release);
+		m_queueVersion.NotifyAll();
+	}
+
+	void DirectoryWalker::SetError(const SystemError& err) noexcept
+	{
+		Threading::Lock lock{ m_errorMutex };
+		if (m_error.Succeeded())
+			m_error = err;
+	}
+
+	auto WalkDirectory(EntryBatchCallback callback, const Path& path, const DirectoryWalkOptions& options) noexcept -> SystemError
+	{
+		DirectoryWalker walker{ path, options };
+		return walker.Walk(Onca::Move(callback));
+	}
+}
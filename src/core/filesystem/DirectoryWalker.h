@@ -0,0 +1,253 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/containers/Deque.h"
+#include "core/threading/Sync.h"
+#include "Entry.h"
+
+namespace Onca::FileSystem
+{
+	/**
+	 * Options for a directory walk
+	 */
+	struct DirectoryWalkOptions
+	{
+		FileAttributes toSkip         = FileAttribute::None; ///< Attributes to skip (skipped if any attribute matches)
+		u16 maxResursionDepth         = u16(-1);             ///< Max recursion depth
+		u16 numThreads                = 1;                   ///< Number of threads used to walk the directory tree (including the calling thread)
+		u32 maxQueuedDirs             = 4096;                ///< Max number of directories queued for other threads, when full, directories are walked by the thread that found them
+		u32 batchSize                 = 1024;                ///< Max number of entries in a single batch
+		u32 readBufferSize            = u32(64_KiB);         ///< Size of the buffer used to read raw directory entries
+		bool recurseSubDirs     : 1   = true;                ///< Recurse through sub-directories
+		bool returnSpecialDirs  : 1   = false;               ///< Visit special directories like '.' and '..'
+		bool onlyVisitFiles     : 1   = false;               ///< Only visit files
+		bool onlyVisitDirs      : 1   = false;               ///< Only visit directories
+	};
+
+	/**
+	 * Batch of entries that are all located in the same directory
+	 * \note Names are stored in a single shared buffer, paths and entries are only created when requested
+	 */
+	class CORE_API EntryBatch
+	{
+	public:
+		/**
+		 * Entry in the batch
+		 */
+		struct Item
+		{
+			u32            nameOffset;          ///< Offset of the name in the batch's name buffer
+			u32            nameLength;          ///< Length of the name (in utf16 code units)
+			FileAttributes attribs;             ///< Attributes
+			u64            creationTimeStamp;   ///< Timestamp of its creation (needs to be converted to know actual time)
+			u64            lastAccessTimestamp; ///< Timestamp of its last access (needs to be converted to know actual time)
+			u64            lastWriteTimestamp;  ///< Timestamp of its last write (needs to be converted to know actual time)
+			u64            size;                ///< Size of the entry (invalid for directories)
+		};
+
+		/**
+		 * Create an empty entry batch
+		 * \param[in] alloc Allocator the batch should use
+		 */
+		explicit EntryBatch(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+
+		/**
+		 * Get the number of entries in the batch
+		 * \return Number of entries in the batch
+		 */
+		auto Size() const noexcept -> usize { return m_items.Size(); }
+		/**
+		 * Check if the batch is empty
+		 * \return Whether the batch is empty
+		 */
+		auto IsEmpty() const noexcept -> bool { return m_items.IsEmpty(); }
+		/**
+		 * Get the directory the entries in this batch are located in
+		 * \return Directory
+		 */
+		auto GetDirectory() const noexcept -> const Path& { return m_dir; }
+		/**
+		 * Get the depth of the directory relative to the root of the walk
+		 * \return Depth of the directory
+		 */
+		auto GetDepth() const noexcept -> u16 { return m_depth; }
+
+		/**
+		 * Get the raw item at an index
+		 * \param[in] idx Index
+		 * \return Item
+		 */
+		auto GetItem(usize idx) const noexcept -> const Item&;
+		/**
+		 * Check if the entry at an index is a directory
+		 * \param[in] idx Index
+		 * \return Whether the entry is a directory
+		 */
+		auto IsDirectory(usize idx) const noexcept -> bool;
+		/**
+		 * Get the name of the entry at an index
+		 * \param[in] idx Index
+		 * \return Name
+		 */
+		auto GetName(usize idx) const noexcept -> String;
+		/**
+		 * Get the full path of the entry at an index
+		 * \param[in] idx Index
+		 * \return Path
+		 */
+		auto GetPath(usize idx) const noexcept -> Path;
+		/**
+		 * Create a full entry for the entry at an index
+		 * \param[in] idx Index
+		 * \return Entry
+		 */
+		auto GetEntry(usize idx) const noexcept -> Entry;
+
+		/**
+		 * Clear the batch, while keeping its memory
+		 */
+		void Clear() noexcept;
+
+	private:
+		friend class DirectoryWalker;
+
+		/**
+		 * Add an entry to the batch
+		 * \param[in] pName Name (utf16)
+		 * \param[in] nameLen Length of the name
+		 * \param[in] item Item, name offset and length will be overwritten
+		 */
+		void Add(const char16_t* pName, u32 nameLen, Item item) noexcept;
+
+		Path               m_dir;   ///< Directory containing the entries
+		DynArray<char16_t> m_names; ///< Shared name buffer
+		DynArray<Item>     m_items; ///< Items
+		u16                m_depth; ///< Depth of the directory
+	};
+
+	using EntryBatchCallback = Delegate<void(const EntryBatch&)>;
+
+	/**
+	 * Walks over a directory tree, returning entries in batches
+	 *
+	 * The walker can either be used to pull batches one at a time on the current thread using Next(),
+	 * or it can walk the entire tree using Walk(), which can spread the work over multiple threads.
+	 */
+	class CORE_API DirectoryWalker
+	{
+	public:
+		DEFINE_OPAQUE_HANDLE(NativeHandle);
+
+		DISABLE_COPY(DirectoryWalker);
+		DISABLE_MOVE(DirectoryWalker);
+
+		/**
+		 * Create a directory walker
+		 * \param[in] root Root directory of the walk
+		 * \param[in] options Walk options
+		 */
+		explicit DirectoryWalker(const Path& root, const DirectoryWalkOptions& options = {}) noexcept;
+		~DirectoryWalker() noexcept;
+
+		/**
+		 * Get the next batch of entries
+		 * \param[out] batch Batch to fill
+		 * \return Whether a batch was returned, false if the walk has finished
+		 * \note Next() always runs on the calling thread and ignores DirectoryWalkOptions::numThreads
+		 */
+		auto Next(EntryBatch& batch) noexcept -> bool;
+		/**
+		 * Walk the entire directory tree
+		 * \param[in] callback Callback invoked for each batch
+		 * \return Result, the first error that was encountered when walking the tree
+		 * \note When more than 1 thread is used, the callback will be invoked concurrently from multiple threads
+		 */
+		auto Walk(EntryBatchCallback callback) noexcept -> SystemError;
+
+		/**
+		 * Get the first error that occurred during the walk
+		 * \return Error
+		 */
+		auto GetError() const noexcept -> const SystemError& { return m_error; }
+
+	private:
+		struct PendingDir
+		{
+			Path path;  ///< Path to the directory
+			u16  depth; ///< Depth relative to the root
+		};
+
+		struct ReadState
+		{
+			NativeHandle handle;   ///< Handle to the open directory
+			DynArray<u8> buffer;   ///< Raw entry buffer
+			usize        offset;   ///< Offset of the next raw entry in the buffer
+			bool         hasData;  ///< Whether the buffer contains unprocessed entries
+			PendingDir   dir;      ///< Directory being read
+		};
+
+		/**
+		 * Open a directory for reading
+		 * \param[in] state Read state
+		 * \param[in] dir Directory to open
+		 * \return Result
+		 */
+		auto OpenDir(ReadState& state, PendingDir&& dir) noexcept -> SystemError;
+		/**
+		 * Read the next batch from a directory
+		 * \param[in] state Read state
+		 * \param[out] batch Batch to fill
+		 * \param[out] subDirs Sub-directories that still need to be walked
+		 * \return Whether there are still entries left in the directory
+		 */
+		auto ReadBatch(ReadState& state, EntryBatch& batch, DynArray<PendingDir>& subDirs) noexcept -> bool;
+		/**
+		 * Close a directory
+		 * \param[in] state Read state
+		 */
+		void CloseDir(ReadState& state) noexcept;
+
+		/**
+		 * Worker loop used when walking over multiple threads
+		 * \param[in] callback Callback
+		 */
+		void WorkerLoop(EntryBatchCallback& callback) noexcept;
+		/**
+		 * Pop a directory from the shared queue, waiting for one if no directory is currently available
+		 * \param[out] dir Popped directory
+		 * \return Whether a directory was popped, false if the walk has finished
+		 */
+		auto PopShared(PendingDir& dir) noexcept -> bool;
+		/**
+		 * Mark a directory as fully walked
+		 */
+		void FinishDir() noexcept;
+		/**
+		 * Store an error, only the first error is kept
+		 * \param[in] err Error
+		 */
+		void SetError(const SystemError& err) noexcept;
+
+		DirectoryWalkOptions m_options;       ///< Options
+		SystemError          m_error;         ///< First error that occurred
+		Threading::Mutex     m_errorMutex;    ///< Mutex protecting the error
+
+		ReadState            m_state;         ///< Read state used by Next()
+		DynArray<PendingDir> m_stack;         ///< Directories still to be walked by Next()
+		bool                 m_stateOpen;     ///< Whether the read state has an open directory
+
+		Deque<PendingDir>    m_queue;         ///< Shared directory queue used by Walk()
+		Threading::Mutex     m_queueMutex;    ///< Mutex protecting the shared queue
+		Atomic<u32>          m_queueVersion;  ///< Version of the queue, used to wait for new directories
+		Atomic<usize>        m_pendingDirs;   ///< Number of directories found, but not fully walked yet
+		Atomic<bool>         m_done;          ///< Whether the walk has finished
+	};
+
+	/**
+	 * Walk over a directory tree, returning entries in batches
+	 * \param[in] callback Callback invoked for each batch
+	 * \param[in] path Root of the directory tree
+	 * \param[in] options Walk options
+	 * \return Result
+	 */
+	CORE_API auto WalkDirectory(EntryBatchCallback callback, const Path& path, const DirectoryWalkOptions& options = {}) noexcept -> SystemError;
+}
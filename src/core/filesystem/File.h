@@ -117,6 +117,19 @@ namespace Onca::FileSystem
 		 */
 		auto ReadString(const FileRegion& region) const noexcept -> Result<String, SystemError>;
 
+		/**
+		 * Read a part of the file directly into a caller provided buffer
+		 * \param[out] pData Buffer to read into
+		 * \param[in] size Number of bytes to read
+		 * \param[in] offset Absolute offset in the file to start reading at
+		 * \return Result with the number of bytes read, which is only smaller than size when the end of the file was reached
+		 * \note Reads are not limited to 4GiB and start at the given offset instead of the file offset
+		 * \note When the file was opened without FileFlag::AllowAsync, the file offset is left after the last byte read
+		 * \note When the file was opened with FileFlag::AllowAsync, large reads are split into chunks that are read in parallel
+		 * \note When the file was opened with FileFlag::Unbuffered, the buffer, size and offset need to be aligned to the sector size
+		 */
+		auto ReadInto(u8* pData, u64 size, u64 offset = 0) const noexcept -> Result<u64, SystemError>;
+
 		/**
 		 * Initiate an async I/O read operation
 		 * \param[in] callback Callback on async completion
@@ -315,6 +328,16 @@ namespace Onca::FileSystem
 	 */
 	auto IsFile(const Path& path) noexcept -> bool;
 
+	/**
+	 * Read an entire file into a byte buffer
+	 * \param[in] path Path to file
+	 * \param[in] alloc Allocator used for the byte buffer
+	 * \return Result with the content of the file
+	 * \note The file size is only queried once, and large files are read in parallel chunks, reads are not limited to 4GiB
+	 * \note The file can be read while it is open for writing elsewhere
+	 */
+	auto ReadAll(const Path& path, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept -> Result<ByteBuffer, SystemError>;
+
 	/**
 	 * Delete a file
 	 * \param[in] path Path to file
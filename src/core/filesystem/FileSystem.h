@@ -6,3 +6,7 @@
 #include "File.h"
 #include "Directory.h"
 #include "Entry.h"
+#include "DirectoryWalker.h"
+#include "FileWatcher.h"
+#include "ContentCache.h"
+#include "BufferedFile.h"
@@ -0,0 +1,156 @@
+#include "FileWatcher.h"
+#include "DirectoryWalker.h"
+
+namespace Onca::FileSystem
+{
+	auto FileWatcher::Dispatch(FileChangeCallback callback) noexcept -> usize
+	{
+		DynArray<FileChange> changes;
+		{
+			const u64 now = GetTimeMs();
+			Threading::Lock lock{ m_pendingMutex };
+			if (m_pending.IsEmpty())
+				return 0;
+
+			for (const Pair<const String, PendingChange>& pair : m_pending)
+			{
+				if (now - pair.second.lastEvent < m_options.debounceMs)
+					continue;
+				changes.Add({ pair.second.kind, Path{ pair.first }, pair.second.oldPath });
+			}
+
+			if (changes.IsEmpty())
+				return 0;
+
+			m_pending.EraseIf([now, this](const String&, const PendingChange& change) -> bool
+			{
+				return now - change.lastEvent >= m_options.debounceMs;
+			});
+		}
+
+		callback(changes);
+		return changes.Size();
+	}
+
+	auto FileWatcher::GetPendingCount() noexcept -> usize
+	{
+		Threading::Lock lock{ m_pendingMutex };
+		return m_pending.Size();
+	}
+
+	void FileWatcher::QueueChange(FileChangeKind kind, const Path& path, const Path& oldPath) noexcept
+	{
+		const u64 now = GetTimeMs();
+		Threading::Lock lock{ m_pendingMutex };
+
+		Path fromPath = oldPath;
+		if (kind == FileChangeKind::Renamed)
+		{
+			// The old path no longer exists, so its pending change moves along with the rename
+			auto oldIt = m_pending.Find(oldPath.GetString());
+			if (oldIt != m_pending.End())
+			{
+				const FileChangeKind oldKind = oldIt->second.kind;
+				Path oldFrom = Onca::Move(oldIt->second.oldPath);
+				m_pending.Erase(oldPath.GetString());
+
+				if (oldKind == FileChangeKind::Created)
+				{
+					// The user never saw the old path, so the entry is simply created at the new path
+					kind = FileChangeKind::Created;
+					fromPath = Path{};
+				}
+				else if (oldKind == FileChangeKind::Renamed)
+				{
+					// Chained renames are reported as a single rename from the original path
+					fromPath = Onca::Move(oldFrom);
+				}
+			}
+		}
+
+		auto it = m_pending.Find(path.GetString());
+		if (it == m_pending.End())
+		{
+			m_pending.Insert(path.GetString(), PendingChange{ kind, fromPath, now });
+			return;
+		}
+
+		PendingChange& pending = it->second;
+		pending.lastEvent = now;
+		switch (pending.kind)
+		{
+		case FileChangeKind::Created:
+		{
+			// The entry never existed for the user, so a delete cancels out the create
+			if (kind == FileChangeKind::Deleted)
+				m_pending.Erase(path.GetString());
+			break;
+		}
+		case FileChangeKind::Deleted:
+		{
+			// Re-creating a deleted entry (e.g. save via temp file) is a modification to the user
+			pending.kind = kind == FileChangeKind::Created ? FileChangeKind::Modified : kind;
+			pending.oldPath = fromPath;
+			break;
+		}
+		case FileChangeKind::Modified:
+		case FileChangeKind::Renamed:
+		{
+			if (kind == FileChangeKind::Modified)
+				break;
+			pending.kind = kind;
+			pending.oldPath = fromPath;
+			break;
+		}
+		default: ;
+		}
+	}
+
+	auto FileWatcher::TakeSnapshot(const Path& dir) noexcept -> HashMap<String, u64>
+	{
+		HashMap<String, u64> snapshot;
+		DirectoryWalker walker{ dir, { .recurseSubDirs = m_options.recursive } };
+		EntryBatch batch;
+		while (walker.Next(batch))
+		{
+			for (usize i = 0; i < batch.Size(); ++i)
+			{
+				const EntryBatch::Item& item = batch.GetItem(i);
+				snapshot.Insert(batch.GetPath(i).GetString(), item.lastWriteTimestamp ^ item.size);
+			}
+		}
+		return snapshot;
+	}
+
+	void FileWatcher::PollWatch(const Path& dir, HashMap<String, u64>& prevSnapshot) noexcept
+	{
+		HashMap<String, u64> snapshot = TakeSnapshot(dir);
+
+		for (const Pair<const String, u64>& pair : snapshot)
+		{
+			auto it = prevSnapshot.Find(pair.first);
+			if (it == prevSnapshot.End())
+				QueueChange(FileChangeKind::Created, Path{ pair.first });
+			else if (it->second != pair.second)
+				QueueChange(FileChangeKind::Modified, Path{ pair.first });
+		}
+
+		for (const Pair<const String, u64>& pair : prevSnapshot)
+		{
+			if (!snapshot.Contains(pair.first))
+				QueueChange(FileChangeKind::Deleted, Path{ pair.first });
+		}
+
+		prevSnapshot = Move(snapshot);
+	}
+
+	auto FileWatcher::FindWatch(WatchId id) const noexcept -> usize
+	{
+		for (usize i = 0; i < m_watches.Size(); ++i)
+		{
+			if (m_watches[i]->id == id)
+				return i;
+		}
+		return usize(-1);
+	}
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/containers/HashMap.h"
+#include "core/memory/Unique.h"
+#include "core/threading/Thread.h"
+#include "core/utils/Result.h"
+#include "Path.h"
+#include "core/platform/SystemError.h"
+
+namespace Onca::FileSystem
+{
+	/**
+	 * Kind of file system change
+	 */
+	enum class FileChangeKind : u8
+	{
+		Created , ///< Entry was created
+		Modified, ///< Entry was modified
+		Deleted , ///< Entry was deleted
+		Renamed , ///< Entry was renamed, FileChange::oldPath contains the previous path
+	};
+
+	/**
+	 * Coalesced file system change
+	 */
+	struct FileChange
+	{
+		FileChangeKind kind;    ///< Kind of change
+		Path           path;    ///< Path to the changed entry
+		Path           oldPath; ///< Previous path of a renamed entry
+	};
+
+	using FileChangeCallback = Delegate<void(const DynArray<FileChange>&)>;
+
+	/**
+	 * File watcher options
+	 */
+	struct FileWatcherOptions
+	{
+		u32  debounceMs       = 100;          ///< Time an entry needs to be unchanged before its change is dispatched
+		u32  pollIntervalMs   = 1000;         ///< Interval between scans for directories that are polled
+		u32  bufferSize       = u32(64_KiB);  ///< Size of the native change buffer per watched directory
+		bool recursive    : 1 = true;         ///< Whether to watch sub-directories
+		bool forcePolling : 1 = false;        ///< Always use polling instead of native change notifications
+	};
+
+	/**
+	 * Watches directories for changes
+	 *
+	 * Changes are collected on a background thread and coalesced per path, e.g. a create followed by multiple modifications is reported as a single create.
+	 * Renames carry the pending change of the old path along, e.g. a create followed by a rename is reported as a single create of the new path.
+	 * Changes are only delivered when calling Dispatch(), so the user decides on what thread changes are handled.
+	 * Directories that cannot be watched natively (or when polling is forced) are periodically scanned and compared against a snapshot of their content.
+	 */
+	class CORE_API FileWatcher
+	{
+	public:
+		DEFINE_OPAQUE_HANDLE(NativeHandle);
+		DEFINE_SIZED_OPAQUE_HANDLE(NativeDataHandle, 32);
+
+		using WatchId = u32;
+		constexpr static WatchId InvalidId = WatchId(-1);
+
+		DISABLE_COPY(FileWatcher);
+		DISABLE_MOVE(FileWatcher);
+
+		/**
+		 * Create a file watcher
+		 * \param[in] options Options
+		 */
+		explicit FileWatcher(const FileWatcherOptions& options = {}) noexcept;
+		~FileWatcher() noexcept;
+
+		/**
+		 * Start watching a directory
+		 * \param[in] dir Directory to watch
+		 * \return Result with the id of the watch or an error
+		 */
+		auto Watch(const Path& dir) noexcept -> Result<WatchId, SystemError>;
+		/**
+		 * Stop watching a directory
+		 * \param[in] id Id of the watch
+		 * \return Error
+		 */
+		auto Unwatch(WatchId id) noexcept -> SystemError;
+
+		/**
+		 * Start collecting changes on a background thread
+		 * \return Error
+		 */
+		auto Start() noexcept -> SystemError;
+		/**
+		 * Stop collecting changes, changes that were already collected can still be dispatched
+		 */
+		void Stop() noexcept;
+
+		/**
+		 * Dispatch all changes that have settled to the callback, as a single batch
+		 * \param[in] callback Callback
+		 * \return Number of dispatched changes
+		 * \note The callback is invoked on the calling thread and will not be called when there are no changes to dispatch
+		 */
+		auto Dispatch(FileChangeCallback callback) noexcept -> usize;
+
+		/**
+		 * Get the number of changes that still need to be dispatched
+		 * \return Number of pending changes
+		 */
+		auto GetPendingCount() noexcept -> usize;
+		/**
+		 * Check if the watcher is collecting changes
+		 * \return Whether the watcher is collecting changes
+		 */
+		auto IsRunning() const noexcept -> bool { return m_running.Load(MemOrder::Relaxed); }
+
+	private:
+		struct WatchData
+		{
+			WatchId                 id;          ///< Id
+			Path                    path;        ///< Watched directory
+			NativeHandle            handle;      ///< Native handle to the directory
+			NativeDataHandle        nData;       ///< Native I/O data
+			DynArray<u8>            buffer;      ///< Native change buffer
+			Path                    renameFrom;  ///< Old path of a rename that is in progress
+			HashMap<String, u64>    snapshot;    ///< Content snapshot used when polling (path -> last write timestamp ^ size)
+			bool                    polling : 1; ///< Whether the watch uses polling
+			bool                    active  : 1; ///< Whether the watch is still active
+			bool                    pending : 1; ///< Whether a native read is in flight
+		};
+
+		struct PendingChange
+		{
+			FileChangeKind kind;      ///< Coalesced change kind
+			Path           oldPath;   ///< Previous path of a rename
+			u64            lastEvent; ///< Time of the last event for this path (in ms)
+		};
+
+		/**
+		 * Queue a change, coalescing it with the pending change of the same path
+		 * \param[in] kind Kind of change
+		 * \param[in] path Path to the changed entry
+		 * \param[in] oldPath Previous path of a renamed entry
+		 */
+		void QueueChange(FileChangeKind kind, const Path& path, const Path& oldPath = Path{}) noexcept;
+		/**
+		 * Create a snapshot of a watched directory
+		 * \param[in] dir Directory
+		 * \return Snapshot
+		 */
+		auto TakeSnapshot(const Path& dir) noexcept -> HashMap<String, u64>;
+		/**
+		 * Rescan a polled directory and queue changes compared to its previous snapshot
+		 * \param[in] dir Directory to poll
+		 * \param[in,out] prevSnapshot Previous snapshot, replaced by the new snapshot
+		 * \note Does not touch the watches, so it can be called without holding the watch mutex
+		 */
+		void PollWatch(const Path& dir, HashMap<String, u64>& prevSnapshot) noexcept;
+		/**
+		 * Find a watch by id
+		 * \param[in] id Id
+		 * \return Index of the watch, or usize(-1) if not found
+		 */
+		auto FindWatch(WatchId id) const noexcept -> usize;
+
+		/**
+		 * Open the native handle of a watch
+		 * \param[in] watch Watch
+		 * \return Error
+		 */
+		auto OpenNative(WatchData& watch) noexcept -> SystemError;
+		/**
+		 * Issue a native read for changes
+		 * \param[in] watch Watch
+		 * \return Error
+		 */
+		auto IssueRead(WatchData& watch) noexcept -> SystemError;
+		/**
+		 * Cancel any outstanding I/O on a watch
+		 * \param[in] watch Watch
+		 */
+		void CancelNative(WatchData& watch) noexcept;
+		/**
+		 * Close the native handle of a watch
+		 * \param[in] watch Watch
+		 */
+		void CloseNative(WatchData& watch) noexcept;
+		/**
+		 * Wake up the background thread
+		 */
+		void WakeWorker() noexcept;
+		/**
+		 * Background thread loop
+		 */
+		void WorkerLoop() noexcept;
+		/**
+		 * Get a monotonic time in ms
+		 * \return Time in ms
+		 */
+		static auto GetTimeMs() noexcept -> u64;
+
+		FileWatcherOptions             m_options;      ///< Options
+		DynArray<Unique<WatchData>>    m_watches;      ///< Watches
+		Threading::Mutex               m_watchMutex;   ///< Mutex protecting the watches
+		WatchId                        m_nextId;       ///< Id of the next watch
+
+		HashMap<String, PendingChange> m_pending;      ///< Pending changes, mapped by path
+		Threading::Mutex               m_pendingMutex; ///< Mutex protecting the pending changes
+
+		NativeHandle                   m_port;         ///< Native completion port
+		Threading::Thread              m_thread;       ///< Background thread
+		Atomic<bool>                   m_running;      ///< Whether the background thread is running
+		Atomic<u32>                    m_pendingIO;    ///< Number of native reads in flight
+	};
+}
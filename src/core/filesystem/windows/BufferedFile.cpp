@@ -0,0 +1,165 @@
+#include "../BufferedFile.h"
+#if PLATFORM_WINDOWS
+
+#include "core/platform/Platform.h"
+
+namespace Onca::FileSystem
+{
+	namespace Windows
+	{
+		/**
+		 * Synchronously read or write at an offset, this works for both synchronous and asynchronous handles
+		 * \param[in] handle File handle
+		 * \param[in] offset Offset in the file
+		 * \param[in] pData Data
+		 * \param[in] size Size of the data
+		 * \param[in] write Whether to write instead of read
+		 * \return Error
+		 */
+		auto TransferAt(HANDLE handle, u64 offset, u8* pData, usize size, bool write) noexcept -> SystemError
+		{
+			HANDLE event = ::CreateEventW(nullptr, true, false, nullptr);
+			if (!event)
+				return TranslateSystemError();
+
+			SystemError err;
+			while (size)
+			{
+				OVERLAPPED overlapped = { .Pointer = reinterpret_cast<PVOID>(offset), .hEvent = event };
+				const u32 toTransfer = u32(Math::Min(size, usize(Math::Consts::MaxVal<u32>)));
+
+				const bool res = write ? ::WriteFile(handle, pData, toTransfer, nullptr, &overlapped)
+				                       : ::ReadFile(handle, pData, toTransfer, nullptr, &overlapped);
+				if (!res && ::GetLastError() != ERROR_IO_PENDING)
+				{
+					err = TranslateSystemError();
+					break;
+				}
+
+				DWORD transferred;
+				if (!::GetOverlappedResult(handle, &overlapped, &transferred, true))
+				{
+					err = TranslateSystemError();
+					break;
+				}
+				if (!transferred)
+				{
+					err = write ? SystemErrorCode::WriteFault : SystemErrorCode::ReadFault;
+					break;
+				}
+
+				offset += transferred;
+				pData += transferred;
+				size -= transferred;
+			}
+
+			::CloseHandle(event);
+			return err;
+		}
+
+		/**
+		 * Start an asynchronous read or write at an offset
+		 * \param[in] handle File handle
+		 * \param[in] pOverlapped Overlapped structure, needs to stay alive until the operation has finished
+		 * \param[in] offset Offset in the file
+		 * \param[in] pData Data
+		 * \param[in] size Size of the data
+		 * \param[in] write Whether to write instead of read
+		 * \return Error
+		 */
+		auto StartTransfer(HANDLE handle, OVERLAPPED* pOverlapped, u64 offset, u8* pData, usize size, bool write) noexcept -> SystemError
+		{
+			HANDLE event = ::CreateEventW(nullptr, true, false, nullptr);
+			if (!event)
+				return TranslateSystemError();
+
+			*pOverlapped = { .Pointer = reinterpret_cast<PVOID>(offset), .hEvent = event };
+			const bool res = write ? ::WriteFile(handle, pData, DWORD(size), nullptr, pOverlapped)
+			                       : ::ReadFile(handle, pData, DWORD(size), nullptr, pOverlapped);
+			if (!res && ::GetLastError() != ERROR_IO_PENDING)
+			{
+				SystemError err = TranslateSystemError();
+				::CloseHandle(event);
+				return err;
+			}
+			return SystemErrorCode::Success;
+		}
+
+		/**
+		 * Wait for an asynchronous read or write to finish
+		 * \param[in] handle File handle
+		 * \param[in] pOverlapped Overlapped structure of the operation
+		 * \return Error
+		 */
+		auto FinishTransfer(HANDLE handle, OVERLAPPED* pOverlapped) noexcept -> SystemError
+		{
+			DWORD transferred;
+			const bool res = ::GetOverlappedResult(handle, pOverlapped, &transferred, true);
+			SystemError err = res ? SystemError{} : TranslateSystemError();
+			::CloseHandle(pOverlapped->hEvent);
+			pOverlapped->hEvent = nullptr;
+			return err;
+		}
+	}
+
+	auto BufferedFileWriter::WriteDirect(const u8* pData, usize size) noexcept -> SystemError
+	{
+		SystemError err = Windows::TransferAt(m_file.GetNative(), m_fileOffset, const_cast<u8*>(pData), size, true);
+		if (err)
+			m_fileOffset += size;
+		return err;
+	}
+
+	auto BufferedFileWriter::WriteAsync(u8 idx, usize size) noexcept -> SystemError
+	{
+		SystemError err = Windows::StartTransfer(m_file.GetNative(), reinterpret_cast<OVERLAPPED*>(&m_nData[idx]), m_fileOffset, m_buffers[idx].Ptr(), size, true);
+		m_inFlight[idx] = err;
+		return err;
+	}
+
+	auto BufferedFileWriter::WaitForBuffer(u8 idx) noexcept -> SystemError
+	{
+		if (!m_inFlight[idx])
+			return SystemErrorCode::Success;
+
+		m_inFlight[idx] = false;
+		return Windows::FinishTransfer(m_file.GetNative(), reinterpret_cast<OVERLAPPED*>(&m_nData[idx]));
+	}
+
+	auto BufferedFileReader::ReadDirect(u64 offset, u8* pData, usize size) noexcept -> SystemError
+	{
+		return Windows::TransferAt(m_file.GetNative(), offset, pData, size, false);
+	}
+
+	auto BufferedFileReader::ReadAsync(u8 idx, u64 offset) noexcept -> SystemError
+	{
+		const usize size = usize(Math::Min(u64(m_options.bufferSize), m_fileSize - offset));
+		SystemError err = Windows::StartTransfer(m_file.GetNative(), reinterpret_cast<OVERLAPPED*>(&m_nData[idx]), offset, m_buffers[idx].Ptr(), size, false);
+		m_inFlight[idx] = err;
+		m_prefetchOffset = offset;
+		return err;
+	}
+
+	auto BufferedFileReader::WaitForBuffer(u8 idx) noexcept -> SystemError
+	{
+		if (!m_inFlight[idx])
+			return SystemErrorCode::Success;
+
+		m_inFlight[idx] = false;
+		return Windows::FinishTransfer(m_file.GetNative(), reinterpret_cast<OVERLAPPED*>(&m_nData[idx]));
+	}
+
+	void BufferedFileReader::CancelPrefetch() noexcept
+	{
+		for (u8 i = 0; i < 2; ++i)
+		{
+			if (!m_inFlight[i])
+				continue;
+
+			::CancelIoEx(m_file.GetNative(), reinterpret_cast<OVERLAPPED*>(&m_nData[i]));
+			UNUSED(WaitForBuffer(i));
+		}
+	}
+}
+
+#endif
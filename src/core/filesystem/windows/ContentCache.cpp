@@ -0,0 +1,159 @@
+#include "../ContentCache.h"
+#if PLATFORM_WINDOWS
+
+#include "core/platform/Platform.h"
+
+namespace Onca::FileSystem
+{
+	Detail::ContentPackMapping::~ContentPackMapping() noexcept
+	{
+		if (pData)
+			::UnmapViewOfFile(pData);
+		if (handle)
+			::CloseHandle(handle);
+	}
+
+	auto ContentCache::OpenNative(const Path& path, NativeHandle& handle) noexcept -> SystemError
+	{
+		const DynArray<char16_t> utf16 = ("\\\\?\\"_path + path.AsAbsolute()).ToNative().GetString().ToUtf16();
+		// Other processes may read the cache, and the files need to be deletable while open so old packs can be removed
+		handle = ::CreateFileW(reinterpret_cast<LPCWSTR>(utf16.Data()),
+		                       GENERIC_READ | GENERIC_WRITE,
+		                       FILE_SHARE_READ | FILE_SHARE_DELETE,
+		                       nullptr,
+		                       OPEN_ALWAYS,
+		                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+		                       nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			handle = nullptr;
+			return TranslateSystemError();
+		}
+		return SystemErrorCode::Success;
+	}
+
+	void ContentCache::CloseNative(NativeHandle& handle) noexcept
+	{
+		if (handle && handle != INVALID_HANDLE_VALUE)
+			::CloseHandle(handle);
+		handle = nullptr;
+	}
+
+	auto ContentCache::ReadNative(NativeHandle handle, u64 offset, u8* pData, u64 size) noexcept -> SystemError
+	{
+		// Reads are positional, so concurrent readers can share the same handle
+		while (size)
+		{
+			OVERLAPPED overlapped = { .Pointer = reinterpret_cast<PVOID>(offset) };
+			const u32 toRead = u32(Math::Min(size, u64(Math::Consts::MaxVal<u32>)));
+			DWORD bytesRead;
+			if (!::ReadFile(handle, pData, toRead, &bytesRead, &overlapped))
+				return TranslateSystemError();
+			if (!bytesRead)
+				return SystemErrorCode::ReadFault;
+
+			offset += bytesRead;
+			pData += bytesRead;
+			size -= bytesRead;
+		}
+		return SystemErrorCode::Success;
+	}
+
+	auto ContentCache::WriteNative(NativeHandle handle, u64 offset, const u8* pData, u64 size) noexcept -> SystemError
+	{
+		while (size)
+		{
+			OVERLAPPED overlapped = { .Pointer = reinterpret_cast<PVOID>(offset) };
+			const u32 toWrite = u32(Math::Min(size, u64(Math::Consts::MaxVal<u32>)));
+			DWORD bytesWritten;
+			if (!::WriteFile(handle, pData, toWrite, &bytesWritten, &overlapped))
+				return TranslateSystemError();
+			if (!bytesWritten)
+				return SystemErrorCode::WriteFault;
+
+			offset += bytesWritten;
+			pData += bytesWritten;
+			size -= bytesWritten;
+		}
+		return SystemErrorCode::Success;
+	}
+
+	auto ContentCache::FlushNative(NativeHandle handle) noexcept -> SystemError
+	{
+		return ::FlushFileBuffers(handle) ? SystemError{} : TranslateSystemError();
+	}
+
+	auto ContentCache::GetSizeNative(NativeHandle handle) noexcept -> u64
+	{
+		LARGE_INTEGER size;
+		return ::GetFileSizeEx(handle, &size) ? u64(size.QuadPart) : 0;
+	}
+
+	auto ContentCache::SetSizeNative(NativeHandle handle, u64 size) noexcept -> SystemError
+	{
+		FILE_END_OF_FILE_INFO info = { .EndOfFile = { .QuadPart = LONGLONG(size) } };
+		return ::SetFileInformationByHandle(handle, FileEndOfFileInfo, &info, sizeof(info)) ? SystemError{} : TranslateSystemError();
+	}
+
+	auto ContentCache::MapReadOnlyNative(NativeHandle handle, u64 size, Detail::ContentPackMapping& mapping) noexcept -> SystemError
+	{
+		// A read-only mapping cannot grow the file, and appends past the mapped size do not affect it
+		mapping.handle = ::CreateFileMappingW(handle, nullptr, PAGE_READONLY, DWORD(size >> 32), DWORD(size), nullptr);
+		if (!mapping.handle)
+			return TranslateSystemError();
+
+		const void* pView = ::MapViewOfFile(mapping.handle, FILE_MAP_READ, 0, 0, usize(size));
+		if (!pView)
+		{
+			SystemError err = TranslateSystemError();
+			::CloseHandle(mapping.handle);
+			mapping.handle = nullptr;
+			return err;
+		}
+
+		mapping.pData = static_cast<const u8*>(pView);
+		mapping.size = size;
+		return SystemErrorCode::Success;
+	}
+
+	auto ContentCache::MapIndex(u64 size) noexcept -> SystemError
+	{
+		m_mapping = ::CreateFileMappingW(m_indexFile, nullptr, PAGE_READWRITE, DWORD(size >> 32), DWORD(size), nullptr);
+		if (!m_mapping)
+			return TranslateSystemError();
+
+		void* pView = ::MapViewOfFile(m_mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, usize(size));
+		if (!pView)
+		{
+			SystemError err = TranslateSystemError();
+			::CloseHandle(m_mapping);
+			m_mapping = nullptr;
+			return err;
+		}
+
+		m_pHeader = static_cast<IndexHeader*>(pView);
+		m_pSlots = reinterpret_cast<IndexSlot*>(m_pHeader + 1);
+		return SystemErrorCode::Success;
+	}
+
+	void ContentCache::UnmapIndex() noexcept
+	{
+		if (m_pHeader)
+			::UnmapViewOfFile(m_pHeader);
+		if (m_mapping)
+			::CloseHandle(m_mapping);
+
+		m_pHeader = nullptr;
+		m_pSlots = nullptr;
+		m_mapping = nullptr;
+	}
+
+	auto ContentCache::FlushIndex() noexcept -> SystemError
+	{
+		if (!::FlushViewOfFile(m_pHeader, 0))
+			return TranslateSystemError();
+		return FlushNative(m_indexFile);
+	}
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "../DirectoryWalker.h"
+#if PLATFORM_WINDOWS
+
+#include "core/platform/Platform.h"
+#include "Utils.h"
+
+namespace Onca::FileSystem
+{
+	auto DirectoryWalker::OpenDir(ReadState& state, PendingDir&& dir) noexcept -> SystemError
+	{
+		const DynArray<char16_t> utf16 = ("\\\\?\\"_path + dir.path.AsAbsolute()).ToNative().GetString().ToUtf16();
+
+		// Open the directory itself, instead of using FindFirstFile, so we can read entries in large chunks
+		const HANDLE handle = ::CreateFileW(reinterpret_cast<LPCWSTR>(utf16.Data()),
+		                                    FILE_LIST_DIRECTORY,
+		                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		                                    nullptr,
+		                                    OPEN_EXISTING,
+		                                    FILE_FLAG_BACKUP_SEMANTICS,
+		                                    nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return TranslateSystemError();
+
+		// FILE_FULL_DIR_INFO needs to be 8-byte aligned, which DynArray storage always is
+		if (state.buffer.Size() < m_options.readBufferSize)
+			state.buffer.Resize(m_options.readBufferSize);
+
+		state.handle = handle;
+		state.offset = 0;
+		state.hasData = false;
+		state.dir = Onca::Move(dir);
+		return SystemErrorCode::Success;
+	}
+
+	auto DirectoryWalker::ReadBatch(ReadState& state, EntryBatch& batch, DynArray<PendingDir>& subDirs) noexcept -> bool
+	{
+		batch.m_dir = state.dir.path;
+		batch.m_depth = state.dir.depth;
+
+		u8* pBuffer = state.buffer.Data();
+		const bool canRecurse = m_options.recurseSubDirs && state.dir.depth < m_options.maxResursionDepth;
+
+		while (batch.Size() < m_options.batchSize)
+		{
+			if (!state.hasData)
+			{
+				// Fetch as many entries as fit into the buffer with a single call
+				const bool res = ::GetFileInformationByHandleEx(state.handle,
+				                                                FileFullDirectoryInfo,
+				                                                pBuffer,
+				                                                m_options.readBufferSize,
+				                                                nullptr);
+				if (!res)
+				{
+					if (::GetLastError() != ERROR_NO_MORE_FILES)
+						SetError(TranslateSystemError());
+					return false;
+				}
+
+				state.offset = 0;
+				state.hasData = true;
+			}
+
+			const FILE_FULL_DIR_INFO* pInfo = reinterpret_cast<const FILE_FULL_DIR_INFO*>(pBuffer + state.offset);
+			if (pInfo->NextEntryOffset)
+				state.offset += pInfo->NextEntryOffset;
+			else
+				state.hasData = false;
+
+			const char16_t* pName = reinterpret_cast<const char16_t*>(pInfo->FileName);
+			const u32 nameLen = pInfo->FileNameLength / sizeof(char16_t);
+
+			const FileAttributes attribs = Windows::TranslateToFileAttribs(pInfo->FileAttributes);
+			if (attribs & m_options.toSkip)
+				continue;
+
+			const bool isSpecialDir = pName[0] == u'.' && (nameLen == 1 || (nameLen == 2 && pName[1] == u'.'));
+			if (isSpecialDir && !m_options.returnSpecialDirs)
+				continue;
+
+			const bool isDirectory = attribs & FileAttribute::Directory;
+			if ((!m_options.onlyVisitDirs || isDirectory) &&
+				(!m_options.onlyVisitFiles || !isDirectory))
+			{
+				batch.Add(pName, nameLen,
+				{
+					.attribs = attribs,
+					.creationTimeStamp = u64(pInfo->CreationTime.QuadPart),
+					.lastAccessTimestamp = u64(pInfo->LastAccessTime.QuadPart),
+					.lastWriteTimestamp = u64(pInfo->LastWriteTime.QuadPart),
+					.size = u64(pInfo->EndOfFile.QuadPart)
+				});
+			}
+
+			// TODO: symbolic links, hardlink, and junctions
+			if (isDirectory && !isSpecialDir && canRecurse && !(attribs & FileAttribute::ReparsePoint))
+			{
+				const char16_t* pNameEnd = pName + nameLen;
+				subDirs.Add({ state.dir.path / Path{ String{ pName, pNameEnd } }, u16(state.dir.depth + 1) });
+			}
+		}
+		return true;
+	}
+
+	void DirectoryWalker::CloseDir(ReadState& state) noexcept
+	{
+		if (state.handle)
+			::CloseHandle(state.handle);
+		state.handle = nullptr;
+		state.hasData = false;
+	}
+}
+
+#endif
@@ -66,6 +66,117 @@ namespace Onca::FileSystem
 			pData->callback.TryInvoke(pData->error);
 			::SetEvent(pData->waitHandle);
 		}
+
+		constexpr u64 ReadChunkSize         = 8_MiB;             ///< Size of a single chunk when reading in parallel
+		constexpr u32 MaxReadsInFlight      = 8;                 ///< Maximum number of chunks being read at the same time
+		constexpr u64 ParallelReadThreshold = 2 * ReadChunkSize; ///< Minimum size of a whole file read to read it in parallel
+
+		/**
+		 * Read data at an offset using synchronous reads
+		 * \param[in] handle File handle (synchronous)
+		 * \param[out] pData Buffer to read into
+		 * \param[in] size Number of bytes to read
+		 * \param[in] offset Offset in the file
+		 * \return Result with the number of bytes read
+		 */
+		auto ReadSequential(HANDLE handle, u8* pData, u64 size, u64 offset) noexcept -> Result<u64, SystemError>
+		{
+			u64 totalRead = 0;
+			while (totalRead < size)
+			{
+				// A single read is limited to 4GiB, so bigger reads are split up
+				OVERLAPPED overlapped = { .Pointer = reinterpret_cast<PVOID>(offset + totalRead) };
+				const u32 toRead = u32(Math::Min(size - totalRead, 1_GiB));
+				DWORD bytesRead;
+				if (!::ReadFile(handle, pData + totalRead, toRead, &bytesRead, &overlapped))
+				{
+					if (::GetLastError() == ERROR_HANDLE_EOF)
+						break;
+					return TranslateSystemError();
+				}
+				if (!bytesRead)
+					break;
+
+				totalRead += bytesRead;
+			}
+			return totalRead;
+		}
+
+		/**
+		 * Read data at an offset by keeping multiple asynchronous reads of fixed size chunks in flight
+		 * \param[in] handle File handle (asynchronous)
+		 * \param[out] pData Buffer to read into
+		 * \param[in] size Number of bytes to read
+		 * \param[in] offset Offset in the file
+		 * \return Result with the number of bytes read
+		 */
+		auto ReadParallel(HANDLE handle, u8* pData, u64 size, u64 offset) noexcept -> Result<u64, SystemError>
+		{
+			const u64 numChunks = (size + ReadChunkSize - 1) / ReadChunkSize;
+			const u32 numSlots = u32(Math::Min(numChunks, u64(MaxReadsInFlight)));
+
+			OVERLAPPED overlapped[MaxReadsInFlight] = {};
+			SystemError err;
+			for (u32 i = 0; i < numSlots && err; ++i)
+			{
+				overlapped[i].hEvent = ::CreateEventW(nullptr, true, false, nullptr);
+				if (!overlapped[i].hEvent)
+					err = TranslateSystemError();
+			}
+
+			// Chunks are completed in the order they were issued, the end moves back when a chunk was cut short by the end of the file
+			u64 end = size;
+			u64 issued = 0;
+			u64 completed = 0;
+			for (;;)
+			{
+				while (err && issued < numChunks && issued - completed < numSlots && issued * ReadChunkSize < end)
+				{
+					OVERLAPPED& slot = overlapped[issued % numSlots];
+					const u64 chunkOffset = issued * ReadChunkSize;
+					const u32 toRead = u32(Math::Min(ReadChunkSize, size - chunkOffset));
+
+					slot.Pointer = reinterpret_cast<PVOID>(offset + chunkOffset);
+					if (!::ReadFile(handle, pData + chunkOffset, toRead, nullptr, &slot))
+					{
+						const u32 lastErr = ::GetLastError();
+						if (lastErr == ERROR_HANDLE_EOF)
+						{
+							end = chunkOffset;
+							break;
+						}
+						if (lastErr != ERROR_IO_PENDING)
+						{
+							err = TranslateSystemError();
+							break;
+						}
+					}
+					++issued;
+				}
+
+				if (completed == issued)
+					break;
+
+				OVERLAPPED& slot = overlapped[completed % numSlots];
+				const u64 chunkOffset = completed * ReadChunkSize;
+				DWORD bytesRead = 0;
+				if (!::GetOverlappedResult(handle, &slot, &bytesRead, true) && ::GetLastError() != ERROR_HANDLE_EOF && err)
+					err = TranslateSystemError();
+				if (bytesRead < Math::Min(ReadChunkSize, size - chunkOffset))
+					end = Math::Min(end, chunkOffset + bytesRead);
+				++completed;
+			}
+
+			for (u32 i = 0; i < numSlots; ++i)
+			{
+				if (overlapped[i].hEvent)
+					::CloseHandle(overlapped[i].hEvent);
+			}
+
+			if (!err)
+				return err;
+			return end;
+		}
 	}
 
 
@@ -239,7 +350,7 @@ namespace Onca::FileSystem
 		if (offset >= fileSize)
 			return SystemError{ SystemErrorCode::OffOutOfRange };
 
-		const usize maxSize = Math::Min(Math::Consts::MaxVal<u32>, GetFileSize()) - offset;
+		const usize maxSize = Math::Min(Math::Consts::MaxVal<u32>, fileSize) - offset;
 		const usize bytesToRead = Math::Min(region.size, maxSize);
 
 		ByteBuffer buffer;
@@ -295,6 +406,18 @@ namespace Onca::FileSystem
 		return String{ readRes.Value() };
 	}
 
+	auto File::ReadInto(u8* pData, u64 size, u64 offset) const noexcept -> Result<u64, SystemError>
+	{
+		if (m_handle == INVALID_HANDLE_VALUE)
+			return SystemError{ SystemErrorCode::InvalidHandle };
+		if (!(m_access & AccessMode::Read))
+			return SystemError{ SystemErrorCode::NoReadPerms };
+
+		if (m_flags & FileFlag::AllowAsync)
+			return Windows::ReadParallel(m_handle, pData, size, offset);
+		return Windows::ReadSequential(m_handle, pData, size, offset);
+	}
+
 	auto File::ReadAsync(AsyncReadCallback callback) const noexcept -> IOReadTask
 	{
 		return ReadAsync({ .offset = 0, .size = Math::Consts::MaxVal<u64> }, callback);
@@ -326,7 +449,7 @@ namespace Onca::FileSystem
 			return IOReadTask{};
 		}
 
-		const usize maxSize = Math::Min(Math::Consts::MaxVal<u32>, GetFileSize()) - offset;
+		const usize maxSize = Math::Min(Math::Consts::MaxVal<u32>, fileSize) - offset;
 		const usize bytesToRead = Math::Min(region.size, maxSize);
 
 		IOReadTask task{ m_handle, callback, bytesToRead };
@@ -577,6 +700,46 @@ namespace Onca::FileSystem
 		return attribs != INVALID_FILE_ATTRIBUTES && !(attribs & FILE_ATTRIBUTE_DIRECTORY);
 	}
 
+	auto ReadAll(const Path& path, Alloc::IAllocator& alloc) noexcept -> Result<ByteBuffer, SystemError>
+	{
+		const DynArray<char16_t> utf16 = ("\\\\?\\"_path + path.AsAbsolute()).ToNative().GetString().ToUtf16();
+		const LPCWSTR pPath = reinterpret_cast<LPCWSTR>(utf16.Data());
+
+		// Query the size before opening the file, so the file can be opened in the way that is best suited for its size
+		WIN32_FILE_ATTRIBUTE_DATA attribs;
+		if (!::GetFileAttributesExW(pPath, GetFileExInfoStandard, &attribs))
+			return TranslateSystemError();
+		if (attribs.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			return SystemError{ SystemErrorCode::ExpectedFile };
+
+		const u64 size = (u64(attribs.nFileSizeHigh) << 32) | attribs.nFileSizeLow;
+		const bool parallel = size >= Windows::ParallelReadThreshold;
+
+		// Allow other handles to keep writing to the file (e.g. a log file that is still open), a concurrent write can change the amount of data that is read
+		const HANDLE handle = ::CreateFileW(pPath,
+		                                    GENERIC_READ,
+		                                    FILE_SHARE_READ | FILE_SHARE_WRITE,
+		                                    nullptr,
+		                                    OPEN_EXISTING,
+		                                    FILE_FLAG_SEQUENTIAL_SCAN | (parallel ? FILE_FLAG_OVERLAPPED : 0),
+		                                    nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return TranslateSystemError();
+
+		ByteBuffer buffer{ alloc };
+		buffer.Resize(usize(size));
+
+		Result<u64, SystemError> res = parallel ? Windows::ReadParallel(handle, buffer.Data(), size, 0)
+		                                        : Windows::ReadSequential(handle, buffer.Data(), size, 0);
+		::CloseHandle(handle);
+		if (res.Failed())
+			return SystemError{ res.Error() };
+
+		// The file might have been truncated after its size was queried
+		buffer.Resize(usize(res.Value()));
+		return buffer;
+	}
+
 	auto DeleteFile(const Path& path) noexcept -> SystemError
 	{
 		const DynArray<char16_t> utf16 = ("\\\\?\\"_path + path.AsAbsolute()).ToNative().GetString().ToUtf16();
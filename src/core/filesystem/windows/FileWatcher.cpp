@@ -0,0 +1,349 @@
+#include "../FileWatcher.h"
+#if PLATFORM_WINDOWS
+
+#include "core/platform/Platform.h"
+
+namespace Onca::FileSystem
+{
+	FileWatcher::FileWatcher(const FileWatcherOptions& options) noexcept
+		: m_options(options)
+		, m_nextId(0)
+		, m_port(::CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1))
+		, m_running(false)
+		, m_pendingIO(0)
+	{
+		ASSERT(m_port, "Failed to create I/O completion port for FileWatcher");
+		// Entries in the change buffer are DWORD aligned
+		m_options.bufferSize = Math::Max(m_options.bufferSize, 1024u) & ~3u;
+	}
+
+	FileWatcher::~FileWatcher() noexcept
+	{
+		Stop();
+		for (Unique<WatchData>& watch : m_watches)
+			CloseNative(*watch);
+		if (m_port)
+			::CloseHandle(m_port);
+	}
+
+	auto FileWatcher::Watch(const Path& dir) noexcept -> Result<WatchId, SystemError>
+	{
+		Unique<WatchData> watch = Unique<WatchData>::Create();
+		watch->path = dir.AsAbsolute();
+		watch->handle = INVALID_HANDLE_VALUE;
+		watch->polling = m_options.forcePolling;
+		watch->active = true;
+		watch->pending = false;
+
+		if (!watch->polling)
+		{
+			SystemError err = OpenNative(*watch);
+			// Fall back to polling when the file system does not support change notifications
+			if (!err.Succeeded())
+			{
+				if (err.code == SystemErrorCode::InvalidPath)
+					return Move(err);
+				watch->polling = true;
+			}
+		}
+
+		if (watch->polling)
+			watch->snapshot = TakeSnapshot(watch->path);
+
+		Threading::Lock lock{ m_watchMutex };
+		WatchId id = m_nextId++;
+		watch->id = id;
+
+		if (m_running.Load() && !watch->polling)
+		{
+			SystemError err = IssueRead(*watch);
+			if (!err.Succeeded())
+			{
+				CloseNative(*watch);
+				return Move(err);
+			}
+		}
+
+		const bool polling = watch->polling;
+		m_watches.Add(Move(watch));
+
+		// The worker needs to update its wait timeout when a polled directory is added
+		if (polling)
+			WakeWorker();
+		return id;
+	}
+
+	auto FileWatcher::Unwatch(WatchId id) noexcept -> SystemError
+	{
+		Threading::Lock lock{ m_watchMutex };
+		const usize idx = FindWatch(id);
+		if (idx == usize(-1))
+			return SystemError{ SystemErrorCode::InvalidHandle, "Unknown watch id"_s };
+
+		WatchData& watch = *m_watches[idx];
+		// When a read is in flight, the worker releases the watch once the cancelled read completes
+		if (watch.pending)
+		{
+			watch.active = false;
+			CancelNative(watch);
+			return SystemErrorCode::Success;
+		}
+
+		CloseNative(watch);
+		m_watches.EraseAt(idx);
+		return SystemErrorCode::Success;
+	}
+
+	auto FileWatcher::Start() noexcept -> SystemError
+	{
+		if (m_running.Exchange(true))
+			return SystemErrorCode::Success;
+
+		{
+			Threading::Lock lock{ m_watchMutex };
+			for (Unique<WatchData>& watch : m_watches)
+			{
+				if (!watch->polling && watch->active)
+					IssueRead(*watch);
+			}
+		}
+
+		// Function pointer delegate, so the delegate does not reference a lambda that goes out of scope
+		Delegate<u32(FileWatcher*)> delegate{ +[](FileWatcher* pWatcher) -> u32
+		{
+			pWatcher->WorkerLoop();
+			return 0;
+		} };
+		Threading::ThreadAttribs attribs{ .desc = "FileWatcher"_s };
+		Result<Threading::Thread, SystemError> res = Threading::Thread::Create(attribs, delegate, this);
+		if (res.Failed())
+		{
+			m_running.Store(false);
+			return res.Error();
+		}
+		m_thread = res.MoveValue();
+		return SystemErrorCode::Success;
+	}
+
+	void FileWatcher::Stop() noexcept
+	{
+		if (!m_running.Exchange(false))
+			return;
+
+		{
+			Threading::Lock lock{ m_watchMutex };
+			for (Unique<WatchData>& watch : m_watches)
+				CancelNative(*watch);
+		}
+
+		WakeWorker();
+		m_thread.Join();
+		m_thread = Threading::Thread{};
+	}
+
+	auto FileWatcher::OpenNative(WatchData& watch) noexcept -> SystemError
+	{
+		const DynArray<char16_t> utf16 = ("\\\\?\\"_path + watch.path).ToNative().GetString().ToUtf16();
+		const HANDLE handle = ::CreateFileW(reinterpret_cast<LPCWSTR>(utf16.Data()),
+		                                    FILE_LIST_DIRECTORY,
+		                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		                                    nullptr,
+		                                    OPEN_EXISTING,
+		                                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		                                    nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return TranslateSystemError();
+
+		// A single recursive watch covers the whole sub-tree, so the number of handles does not scale with the number of directories
+		if (!::CreateIoCompletionPort(handle, m_port, ULONG_PTR(&watch), 0))
+		{
+			SystemError err = TranslateSystemError();
+			::CloseHandle(handle);
+			return err;
+		}
+
+		watch.handle = handle;
+		watch.buffer.Resize(m_options.bufferSize);
+		return SystemErrorCode::Success;
+	}
+
+	auto FileWatcher::IssueRead(WatchData& watch) noexcept -> SystemError
+	{
+		MemClearData(watch.nData);
+
+		constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME  |
+		                         FILE_NOTIFY_CHANGE_DIR_NAME   |
+		                         FILE_NOTIFY_CHANGE_SIZE       |
+		                         FILE_NOTIFY_CHANGE_LAST_WRITE |
+		                         FILE_NOTIFY_CHANGE_CREATION;
+
+		const bool res = ::ReadDirectoryChangesW(watch.handle,
+		                                         watch.buffer.Data(),
+		                                         DWORD(watch.buffer.Size()),
+		                                         m_options.recursive,
+		                                         filter,
+		                                         nullptr,
+		                                         reinterpret_cast<LPOVERLAPPED>(&watch.nData),
+		                                         nullptr);
+		if (!res)
+			return TranslateSystemError();
+
+		watch.pending = true;
+		m_pendingIO.FetchAdd(1);
+		return SystemErrorCode::Success;
+	}
+
+	void FileWatcher::CancelNative(WatchData& watch) noexcept
+	{
+		if (watch.handle != INVALID_HANDLE_VALUE && watch.pending)
+			::CancelIoEx(watch.handle, reinterpret_cast<LPOVERLAPPED>(&watch.nData));
+	}
+
+	void FileWatcher::CloseNative(WatchData& watch) noexcept
+	{
+		if (watch.handle != INVALID_HANDLE_VALUE)
+			::CloseHandle(watch.handle);
+		watch.handle = INVALID_HANDLE_VALUE;
+	}
+
+	void FileWatcher::WakeWorker() noexcept
+	{
+		::PostQueuedCompletionStatus(m_port, 0, 0, nullptr);
+	}
+
+	void FileWatcher::WorkerLoop() noexcept
+	{
+		// Directory scans can take a while, so they run on a copy of the watch, without holding the watch mutex
+		struct PollJob
+		{
+			WatchId              id;
+			Path                 path;
+			HashMap<String, u64> snapshot;
+		};
+
+		u64 nextPoll = GetTimeMs() + m_options.pollIntervalMs;
+
+		while (true)
+		{
+			bool hasPolling;
+			{
+				Threading::Lock lock{ m_watchMutex };
+				hasPolling = m_watches.ContainsIf([](const Unique<WatchData>& watch) { return watch->polling; });
+			}
+
+			DWORD timeout = INFINITE;
+			if (hasPolling)
+			{
+				const u64 now = GetTimeMs();
+				timeout = DWORD(nextPoll > now ? nextPoll - now : 0);
+			}
+
+			DWORD bytes = 0;
+			ULONG_PTR key = 0;
+			OVERLAPPED* pOverlapped = nullptr;
+			const bool res = ::GetQueuedCompletionStatus(m_port, &bytes, &key, &pOverlapped, timeout);
+
+			WatchId switchedId = InvalidId;
+			Path switchedPath;
+			if (pOverlapped)
+			{
+				Threading::Lock lock{ m_watchMutex };
+				WatchData& watch = *reinterpret_cast<WatchData*>(key);
+				watch.pending = false;
+				m_pendingIO.FetchSub(1);
+
+				if (!watch.active)
+				{
+					CloseNative(watch);
+					const usize idx = FindWatch(watch.id);
+					if (idx != usize(-1))
+						m_watches.EraseAt(idx);
+				}
+				else if (res && m_running.Load())
+				{
+					// 0 bytes means the buffer overflowed, so report the watched directory itself as modified, so the user can rescan it
+					if (bytes == 0)
+						QueueChange(FileChangeKind::Modified, watch.path);
+
+					usize offset = 0;
+					while (bytes)
+					{
+						const FILE_NOTIFY_INFORMATION* pInfo = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(watch.buffer.Data() + offset);
+						const char16_t* pName = reinterpret_cast<const char16_t*>(pInfo->FileName);
+						const Path path = watch.path / Path{ String{ pName, pName + pInfo->FileNameLength / sizeof(char16_t) } };
+
+						switch (pInfo->Action)
+						{
+						case FILE_ACTION_ADDED:            QueueChange(FileChangeKind::Created, path);                   break;
+						case FILE_ACTION_REMOVED:          QueueChange(FileChangeKind::Deleted, path);                   break;
+						case FILE_ACTION_MODIFIED:         QueueChange(FileChangeKind::Modified, path);                  break;
+						case FILE_ACTION_RENAMED_OLD_NAME: watch.renameFrom = path;                                      break;
+						case FILE_ACTION_RENAMED_NEW_NAME: QueueChange(FileChangeKind::Renamed, path, watch.renameFrom); break;
+						default: ;
+						}
+
+						if (!pInfo->NextEntryOffset)
+							break;
+						offset += pInfo->NextEntryOffset;
+					}
+
+					if (!IssueRead(watch).Succeeded())
+					{
+						// The directory can no longer be watched natively (e.g. it was deleted), so switch to polling
+						CloseNative(watch);
+						watch.polling = true;
+						switchedId = watch.id;
+						switchedPath = watch.path;
+					}
+				}
+			}
+
+			if (switchedId != InvalidId)
+			{
+				HashMap<String, u64> snapshot = TakeSnapshot(switchedPath);
+				Threading::Lock lock{ m_watchMutex };
+				const usize idx = FindWatch(switchedId);
+				if (idx != usize(-1))
+					m_watches[idx]->snapshot = Move(snapshot);
+			}
+
+			if (!m_running.Load() && m_pendingIO.Load() == 0)
+				break;
+
+			if (hasPolling && GetTimeMs() >= nextPoll)
+			{
+				DynArray<PollJob> jobs;
+				{
+					Threading::Lock lock{ m_watchMutex };
+					for (Unique<WatchData>& watch : m_watches)
+					{
+						if (watch->polling && watch->active)
+							jobs.Add(PollJob{ watch->id, watch->path, Move(watch->snapshot) });
+					}
+				}
+
+				for (PollJob& job : jobs)
+					PollWatch(job.path, job.snapshot);
+
+				{
+					// Watches that were removed in the meantime are skipped
+					Threading::Lock lock{ m_watchMutex };
+					for (PollJob& job : jobs)
+					{
+						const usize idx = FindWatch(job.id);
+						if (idx != usize(-1))
+							m_watches[idx]->snapshot = Move(job.snapshot);
+					}
+				}
+				nextPoll = GetTimeMs() + m_options.pollIntervalMs;
+			}
+		}
+	}
+
+	auto FileWatcher::GetTimeMs() noexcept -> u64
+	{
+		return ::GetTickCount64();
+	}
+}
+
+#endif
@@ -8,6 +8,7 @@ namespace Onca::Input
 	InputManager::InputManager(bool createKbM)
 		: m_pKeyboard(nullptr)
 		, m_pMouse(nullptr)
+		, m_frameAlloc(&g_GlobalAlloc, 16_KiB)
 		, m_allowMultiUser(false)
 		, m_addUsersDynamic(false)
 		, m_maxUsers(1)
@@ -26,6 +27,7 @@ namespace Onca::Input
 	{
 		m_devMapping.Clear(true);
 		m_devs.Clear(true);
+		m_usedDevs.Clear(true);
 		m_devInitMapping.Clear(true);
 
 		m_pKeyboard = nullptr;
@@ -63,6 +65,7 @@ namespace Onca::Input
 
 	void InputManager::Tick(Chrono::DeltaTime dt) noexcept
 	{
+		m_frameAlloc.NextFrame();
 		SystemTick();
 
 		for (Unique<Device>& device : m_devs)
@@ -81,11 +84,11 @@ namespace Onca::Input
 		
 		for (usize i = 0; i < m_users.Size(); ++i)
 		{
-			User& user = m_users[i];
+			User& user = m_users.GetValueAt(i);
 			if (!user.IsValid())
 				continue;
 		
-			user.RebuildMappings();
+			user.RebuildMappings(m_frameAlloc);
 			user.ResetTriggerInfoAndUpdatePrevState();
 		
 			for (InternalMapping& mapping : user.GetMappings())
@@ -119,8 +122,8 @@ namespace Onca::Input
 			if (m_users.IsEmpty())
 				return;
 
-			User& user = m_users[0];
-			const DynArray<u32>& controlSetIds = m_users[0].GetControlSetIds();
+			User& user = m_users.GetValueAt(0);
+			const DynArray<u32>& controlSetIds = user.GetControlSetIds();
 			if (controlSetIds.Size() == 1)
 				return;
 
@@ -133,30 +136,29 @@ namespace Onca::Input
 			if (m_users.Size() <= 1)
 				return;
 			
-			for (usize i = 1; i < m_users.Size(); ++i)
+			while (m_users.Size() > 1)
 			{
-				for (u32 controlSetId : m_users[i].GetControlSetIds())
+				const usize idx = m_users.Size() - 1;
+				for (u32 controlSetId : m_users.GetValueAt(idx).GetControlSetIds())
 				{
 					RemoveControlSet(controlSetId);
 				} 
+				m_users.Erase(m_users.GetHandleAt(idx));
 			}
-			m_users.Resize(1);
 		}
 	}
 
 	void InputManager::SetMaxUsers(u8 maxUsers) noexcept
 	{
 		m_maxUsers = maxUsers;
-		if (m_users.Size() > m_maxUsers)
+		while (m_users.Size() > m_maxUsers)
 		{
-			for (u8 i = m_maxUsers; i < m_users.Size(); ++i)
+			const usize idx = m_users.Size() - 1;
+			for (u32 controlSetId : m_users.GetValueAt(idx).GetControlSetIds())
 			{
-				for (u32 controlSetId : m_users[i].GetControlSetIds())
-				{
-					RemoveControlSet(controlSetId);
-				}
+				RemoveControlSet(controlSetId);
 			}
-			m_users.Resize(m_maxUsers);
+			m_users.Erase(m_users.GetHandleAt(idx));
 		}
 	}
 
@@ -186,9 +188,10 @@ namespace Onca::Input
 			Device* pFoundDev = nullptr;
 			for (u32 devId : devIt->second)
 			{
-				if (controlSet.ContainsDevice(devId))
+				const Unique<Device>* pDev = m_devs.Get(devId);
+				if (pDev && controlSet.ContainsDevice(devId))
 				{
-					pFoundDev = m_devs[devId].Get();
+					pFoundDev = pDev->Get();
 					break;
 				}
 			}
@@ -216,21 +219,16 @@ namespace Onca::Input
 			}
 		}
 
-		// Find empty device
-		u32 devId = 0;
-		for (; devId < m_devs.Size(); ++devId)
+		Device* pDev = device.Get();
+		const u32 devId = m_devs.Insert(Move(device));
+		if (devId == InvalidId)
 		{
-			if (!m_devs[devId])
-				break;
+			g_Logger.Warning(LogCategories::INPUT, "Too many input devices are registered");
+			return false;
 		}
-
-		device->m_deviceId = devId;
-		if (devId == m_devs.Size())
-			m_devs.Add(Move(device));
-		else
-			m_devs[devId] = Move(device);
+		pDev->m_deviceId = devId;
 		
-		for (const InternedString& iden : m_devs[devId]->GetDeviceNames())
+		for (const InternedString& iden : pDev->GetDeviceNames())
 		{
 			auto it = m_devMapping.Find(iden);
 			if (it == m_devMapping.End())
@@ -242,16 +240,16 @@ namespace Onca::Input
 
 		// The memory stored by a unique pointer cannot be relocated, so we can cache the actual pointer to it
 		if (type == DeviceType::Mouse)
-			m_pMouse = reinterpret_cast<Mouse*>(m_devs[devId].Get());
+			m_pMouse = reinterpret_cast<Mouse*>(pDev);
 		else if (type == DeviceType::Keyboard)
-			m_pKeyboard = reinterpret_cast<Keyboard*>(m_devs[devId].Get());
+			m_pKeyboard = reinterpret_cast<Keyboard*>(pDev);
 
-		m_devs[devId]->OnRegister(this);
-		OnDeviceAdded(devId, m_devs[devId].Get());
+		pDev->OnRegister(this);
+		OnDeviceAdded(devId, pDev);
 
 		for (User& user : m_users)
 		{
-			u32 schemeId = user.GetDisconnectedDeviceScheme(m_devs[devId]->GetDeviceInfo());
+			u32 schemeId = user.GetDisconnectedDeviceScheme(pDev->GetDeviceInfo());
 			if (schemeId == InvalidId)
 				continue;
 
@@ -264,15 +262,27 @@ namespace Onca::Input
 
 	void InputManager::UnregisterDevice(Unique<Device>& device) noexcept
 	{
-		auto it = m_devs.Find(device);
-		if (it == m_devs.end())
+		if (!device)
+			return;
+
+		const u32 devId = device->GetDeviceId();
+		if (!m_devs.Contains(devId))
 			return;
 
-		u32 idx = u32(it - m_devs.Begin());
 		for (Pair<const InternedString, DynArray<u32>>& pair : m_devMapping)
 		{
-			pair.second.Erase(idx);
+			pair.second.Erase(devId);
 		}
+
+		const DeviceType type = device->GetDeviceInfo().type;
+		if (type == DeviceType::Keyboard)
+			m_pKeyboard = nullptr;
+		else if (type == DeviceType::Mouse)
+			m_pMouse = nullptr;
+
+		// Control sets can still reference the device, but they will no longer find it, as the generation of the id is stale
+		m_usedDevs.Erase(u32(DeviceRegistry::GetIndex(devId)));
+		m_devs.Erase(devId);
 	}
 
 	auto InputManager::HasDeviceWithName(const String& name) const noexcept -> bool
@@ -282,22 +292,23 @@ namespace Onca::Input
 
 	auto InputManager::HasDeviceOfType(DeviceType type) const noexcept -> bool
 	{
-		return m_devs.ContainsIf([type](const Unique<Device>& dev) -> bool
+		for (const Unique<Device>& dev : m_devs)
 		{
-			return dev->GetDeviceInfo().type == type;
-		});
+			if (dev->GetDeviceInfo().type == type)
+				return true;
+		}
+		return false;
 	}
 
 	auto InputManager::GetDevice(u32 devId) const noexcept -> const Device*
 	{
-		if (devId >= m_devs.Size())
-			return nullptr;
-		return m_devs[devId].Get();
+		const Unique<Device>* pDev = m_devs.Get(devId);
+		return pDev ? pDev->Get() : nullptr;
 	}
 
 	auto InputManager::IsDeviceInUse(u32 devId) const noexcept -> bool
 	{
-		return GetDeviceControlSet(devId) != InvalidId;
+		return m_devs.Contains(devId) && m_usedDevs.Contains(u32(DeviceRegistry::GetIndex(devId)));
 	}
 
 	auto InputManager::GetDeviceControlSet(u32 devId) const noexcept -> u32
@@ -349,10 +360,10 @@ namespace Onca::Input
 	{
 		// Collect all unused devices
 		DynArray<Device*> unusedDevices;
-		for (u32 i = 0; i < m_devs.Size(); ++i)
+		for (usize i = 0; i < m_devs.Size(); ++i)
 		{
-			if (!IsDeviceInUse(i))
-				unusedDevices.Add(m_devs[i].Get());
+			if (!IsDeviceInUse(m_devs.GetHandleAt(i)))
+				unusedDevices.Add(m_devs.GetValueAt(i).Get());
 		}
 
 		while (!unusedDevices.IsEmpty())
@@ -421,7 +432,7 @@ namespace Onca::Input
 						break;
 					}
 				}
-				unusedDevices.Erase(m_devs[devIds.Back()].Get());
+				unusedDevices.Erase(m_devs.Get(devIds.Back())->Get());
 			}
 			u32 setId = AddControlSet(ControlSet{ schemeId, Move(devIds) });
 
@@ -442,12 +453,12 @@ namespace Onca::Input
 				{
 					u32 userId = AddUser(User{ schemeId, false });
 					if (userId != InvalidId)
-						m_users[userId].AddControlSet(setId);
+						m_users.Get(userId)->AddControlSet(setId);
 				}
 			}
 			else
 			{
-				m_users[0].AddControlSet(setId);
+				m_users.GetValueAt(0).AddControlSet(setId);
 			}
 		}
 	}
@@ -480,7 +491,7 @@ namespace Onca::Input
 		if (id == InvalidId)
 			return false;
 
-		m_users[id].AddMappingContext(mapping);
+		m_users.Get(id)->AddMappingContext(mapping);
 
 		if (scheme == InvalidId || !TryComposeControlSchemeForUser(id, scheme))
 			TryComposeControlSchemeForUser(id, InvalidId);
@@ -489,20 +500,23 @@ namespace Onca::Input
 
 	void InputManager::RemoveUser(u32 id) noexcept
 	{
-		if (id >= m_users.Size())
+		User* pUser = m_users.Get(id);
+		if (!pUser)
 			return;
 
-		OnUserRemoved(id, m_users[id]);
-		m_users[id].m_valid = false;
-		m_users.EraseAt(id);
+		OnUserRemoved(id, *pUser);
+		for (u32 controlSetId : pUser->GetControlSetIds())
+			RemoveControlSet(controlSetId);
+		m_users.Erase(id);
 	}
 
 	auto InputManager::GetUser(u32 id) noexcept -> User&
 	{
 		static User dummy;
-		if (id >= m_users.Size() || !m_users[id].IsValid())
+		User* pUser = m_users.Get(id);
+		if (!pUser || !pUser->IsValid())
 			return dummy;
-		return m_users[id];
+		return *pUser;
 	}
 	
 	void InputManager::ClearAllMappingContexts() noexcept
@@ -722,6 +736,9 @@ namespace Onca::Input
 	
 	auto InputManager::AddControlSet(ControlSet&& set) noexcept -> u32
 	{
+		for (u32 devId : set.m_devIds)
+			m_usedDevs.Insert(u32(DeviceRegistry::GetIndex(devId)));
+
 		for (u32 i = 0; i < m_controlSets.Size(); ++i)
 		{
 			if (m_controlSets[i].IsNullSet())
@@ -739,6 +756,12 @@ namespace Onca::Input
 	{
 		if (id >= m_controlSets.Size())
 			return;
+
+		for (u32 devId : m_controlSets[id].m_devIds)
+		{
+			if (m_devs.Contains(devId))
+				m_usedDevs.Erase(u32(DeviceRegistry::GetIndex(devId)));
+		}
 		m_controlSets[id].Invalidate();
 	}
 
@@ -747,33 +770,25 @@ namespace Onca::Input
 		if (!m_users.IsEmpty() && (!m_allowMultiUser || m_users.Size() >= m_maxUsers))
 			return InvalidId;
 
-		u32 id = 0;
-		for (; id < m_users.Size(); ++id)
-		{
-			if (user.IsValid())
-				break;
-		}
-
-		if (id >= m_maxUsers)
-			return InvalidId;
-
 		if (user.GetMappingContexts().IsEmpty() && m_defNewUserMappingContext && !m_defNewUserMappingContext->IsEmpty())
 			user.AddMappingContext(m_defNewUserMappingContext);
 
-		if (id == m_users.Size())
-			m_users.Add(Move(user));
-		else
-			m_users[id] = Move(user);
-		m_users[id].m_valid = true;
+		const u32 id = m_users.Insert(Move(user));
+		if (id == InvalidId)
+			return InvalidId;
+
+		User& addedUser = *m_users.Get(id);
+		addedUser.m_id = id;
+		addedUser.m_valid = true;
 
-		OnUserAdded(id, m_users.Back());
+		OnUserAdded(id, addedUser);
 		return id;
 	}
 
 	auto InputManager::TryComposeControlSchemeForUser(u32 userId, u32 scheme, u32 reconnectedDev) noexcept -> bool
 	{
-		if (userId >= m_users.Size() ||
-			!m_users[userId].IsValid())
+		const User* pUser = m_users.Get(userId);
+		if (!pUser || !pUser->IsValid())
 			return false;
 
 		u32 setId = CreateControlSetForScheme(scheme, reconnectedDev);
@@ -783,7 +798,7 @@ namespace Onca::Input
 		for (User& user : m_users)
 			user.RemoveDisconnectedDeviceForScheme(scheme);
 
-		m_users[userId].AddControlSet(setId);
+		m_users.Get(userId)->AddControlSet(setId);
 		return true;
 	}
 
@@ -792,13 +807,14 @@ namespace Onca::Input
 		// Collect all unused devices
 		DynArray<Device*> unusedDevices;
 
-		if (reconnectedDev != InvalidId)
-			unusedDevices.Add(m_devs[reconnectedDev].Get());
+		if (Unique<Device>* pReconnectedDev = m_devs.Get(reconnectedDev))
+			unusedDevices.Add(pReconnectedDev->Get());
 
-		for (u32 i = 0; i < m_devs.Size(); ++i)
+		for (usize i = 0; i < m_devs.Size(); ++i)
 		{
-			if (!IsDeviceInUse(i) && i != reconnectedDev)
-				unusedDevices.Add(m_devs[i].Get());
+			const u32 devId = m_devs.GetHandleAt(i);
+			if (!IsDeviceInUse(devId) && devId != reconnectedDev)
+				unusedDevices.Add(m_devs.GetValueAt(i).Get());
 		}
 
 		if (scheme != InvalidId)
@@ -824,7 +840,7 @@ namespace Onca::Input
 						break;
 					}
 				}
-				unusedDevices.Erase(m_devs[devIds.Back()].Get());
+				unusedDevices.Erase(m_devs.Get(devIds.Back())->Get());
 			}
 			return AddControlSet(ControlSet{ scheme, Move(devIds) });
 		}
@@ -896,7 +912,7 @@ namespace Onca::Input
 						break;
 					}
 				}
-				unusedDevices.Erase(m_devs[devIds.Back()].Get());
+				unusedDevices.Erase(m_devs.Get(devIds.Back())->Get());
 			}
 			return AddControlSet(ControlSet{ schemeId, Move(devIds) });
 		}
@@ -908,7 +924,7 @@ namespace Onca::Input
 	{
 		bool res = TryComposeControlSchemeForUser(user.GetId(), schemeId, devId);
 		if (res)
-			user.RemoveDisconnectedDevice(m_devs[devId]->GetDeviceInfo());
+			user.RemoveDisconnectedDevice((*m_devs.Get(devId))->GetDeviceInfo());
 	}
 
 	void InputManager::OnDeviceAdded(u32 id, const Device* pDev) noexcept
@@ -1,8 +1,11 @@
 #pragma once
 #include "Common.h"
 #include "ControlSet.h"
+#include "core/allocator/composable/FrameAllocator.h"
 #include "core/containers/DynArray.h"
 #include "core/containers/HashMap.h"
+#include "core/containers/SlotMap.h"
+#include "core/containers/SparseSet.h"
 #include "core/string/Include.h"
 #include "core/memory/RefCounted.h"
 #include "core/memory/Unique.h"
@@ -137,7 +140,7 @@ namespace Onca::Input
 		/**
 		 * Get a device from it's id
 		 * \param[in] devId Device id
-		 * \return Device
+		 * \return Device, nullptr if the id is invalid or the device was unregistered
 		 */
 		auto GetDevice(u32 devId) const noexcept -> const Device*;
 		/**
@@ -414,13 +417,14 @@ namespace Onca::Input
 		using DeviceMapping = HashMap<InternedString, DynArray<u32>>;
 		using DevInitMapping = HashMap<u32, DevInitDelegate>;
 
-		using DeviceRegistry = DynArray<Unique<Device>>;
+		using DeviceRegistry = SlotMap<Unique<Device>>;
 
 		using KeyRegistry = HashMap<Key, Rc<KeyDetails>>;
 		using KeyDevNativeRegistry = HashMap<Key, Pair<InternedString, u32>>;
 		
 		DeviceMapping           m_devMapping;               ///< Name to id mapping
-		DeviceRegistry          m_devs;                     ///< Input device
+		DeviceRegistry          m_devs;                     ///< Input devices, device ids are handles into the registry
+		SparseSet<u32>          m_usedDevs;                 ///< Slot indices of the devices used by a control set
 		DevInitMapping          m_devInitMapping;           ///< Device initializer mapping
 
 		Keyboard*               m_pKeyboard;                ///< Cached pointer to current keyboard
@@ -432,10 +436,12 @@ namespace Onca::Input
 		DynArray<ControlScheme> m_controlSchemes;           ///< Control schemes
 		DynArray<ControlSet>    m_controlSets;              ///< Control sets
 
-		DynArray<User>          m_users;                    ///< Users
+		SlotMap<User>           m_users;                    ///< Users, user ids are handles into the map
 
 		DynArray<DeviceInfo>    m_rawDevInfos;              ///< Device info for all devices currently connected to the system
 
+		Alloc::FrameAllocator   m_frameAlloc;               ///< Allocator for temporaries that don't outlive a tick
+
 		bool                    m_allowMultiUser;           ///< Whether we can have multiple users
 		bool                    m_addUsersDynamic;          ///< Can we dynamically add new users if a new control set can be created
 		u8                      m_maxUsers;                 ///< Maximum number of input users
@@ -7,19 +7,21 @@
 
 namespace Onca::Input
 {
-	InternalMapping::InternalMapping(const Rc<InputAction>& action, Unique<Binding>&& binding, const DynArray<u32>& validSchemes, DynArray<Unique<ITrigger>>&& triggers,
-	                                 DynArray<Unique<IModifier>>&& modifiers) noexcept
+	InternalMapping::InternalMapping(const Rc<InputAction>& action, Unique<Binding>&& binding, ValidSchemes&& validSchemes, Triggers&& triggers, Modifiers&& modifiers) noexcept
 		: m_action(action)
 		, m_binding(Move(binding))
-		, m_validSchemes(validSchemes)
+		, m_validSchemes(Move(validSchemes))
 		, m_triggers(Move(triggers))
-		, m_modifiers(Move(m_modifiers))
+		, m_modifiers(Move(modifiers))
 		, m_prevState(TriggerState::None)
 	{
 	}
 
 	InternalMapping::InternalMapping(const InternalMapping& other) noexcept
 		: m_action(other.m_action)
+		, m_binding(other.m_binding ? other.m_binding->Clone() : nullptr)
+		, m_key(other.m_key)
+		, m_validSchemes(other.m_validSchemes)
 		, m_prevState(TriggerState::None)
 	{
 		for (const Unique<ITrigger>& trigger : other.m_triggers)
@@ -100,7 +102,7 @@ namespace Onca::Input
 		return { state, val };
 	}
 
-	auto InternalMapping::CalcTriggerState(DynArray<Unique<ITrigger>>& triggers, User& user, const Value& val, Chrono::DeltaTime dt) noexcept -> TriggerState
+	auto InternalMapping::CalcTriggerState(Triggers& triggers, User& user, const Value& val, Chrono::DeltaTime dt) noexcept -> TriggerState
 	{
 		if (triggers.IsEmpty())
 			return val.value.IsNearlyZero() ? TriggerState::None : TriggerState::Triggered;
@@ -171,10 +173,10 @@ namespace Onca::Input
 	ControlBinding::ControlBinding(ControlBinding&& binding) noexcept
 		: m_binding(Move(binding.m_binding))
 		, m_modifierKeys(Move(binding.m_modifierKeys))
-		, m_validSchemes(Move(m_validSchemes))
+		, m_validSchemes(Move(binding.m_validSchemes))
 		, m_triggers(Move(binding.m_triggers))
-		, m_modifiers(Move(m_modifiers))
-		, m_mappingInfo(Move(m_mappingInfo))
+		, m_modifiers(Move(binding.m_modifiers))
+		, m_mappingInfo(Move(binding.m_mappingInfo))
 	{
 	}
 
@@ -185,6 +187,8 @@ namespace Onca::Input
 		m_validSchemes = binding.m_validSchemes;
 		m_mappingInfo = binding.m_mappingInfo;
 
+		m_triggers.Clear();
+		m_modifiers.Clear();
 		for (const Unique<ITrigger>& trigger : binding.m_triggers)
 			m_triggers.Add(trigger->Clone());
 		for (const Unique<IModifier>& modifier : binding.m_modifiers)
@@ -197,10 +201,10 @@ namespace Onca::Input
 	{
 		m_binding = Move(binding.m_binding);
 		m_modifierKeys = Move(binding.m_modifierKeys);
-		m_validSchemes = Move(m_validSchemes);
+		m_validSchemes = Move(binding.m_validSchemes);
 		m_triggers = Move(binding.m_triggers);
-		m_modifiers = Move(m_modifiers);
-		m_mappingInfo = Move(m_mappingInfo);
+		m_modifiers = Move(binding.m_modifiers);
+		m_mappingInfo = Move(binding.m_mappingInfo);
 		return *this;
 	}
 
@@ -244,7 +248,7 @@ namespace Onca::Input
 	void ControlBinding::RemoveModifier(usize idx) noexcept
 	{
 		if (idx < m_modifiers.Size())
-			m_triggers.EraseAt(idx);
+			m_modifiers.EraseAt(idx);
 	}
 
 	void ControlBinding::MoveModifier(usize from, usize to) noexcept
@@ -329,13 +333,15 @@ namespace Onca::Input
 		HashSet<Weak<InputAction>> allActions;
 
 		DynArray<InternalMapping> mapping = BuildInternalMapping(user);
+		otherMappings.Reserve(mapping.Size());
 
-		for (const InternalMapping& mapping : mapping)
+		// The built mappings are only temporary, so move them instead of cloning their bindings, triggers and modifiers
+		for (InternalMapping& internal : mapping)
 		{
-			DynArray<InternalMapping>& mappingArray = mapping.UsesChords() ? chordedMappings : otherMappings;
-			mappingArray.Add(mapping);
-			mapping.GetChordedActions(chordedActions);
-			allActions.Insert(mapping.GetInputAction());
+			internal.GetChordedActions(chordedActions);
+			allActions.Insert(internal.GetInputAction());
+			DynArray<InternalMapping>& mappingArray = internal.UsesChords() ? chordedMappings : otherMappings;
+			mappingArray.Add(Move(internal));
 		}
 
 		DynArray<InternalMapping> chordedChordingMappings;
@@ -412,13 +418,19 @@ namespace Onca::Input
 	{
 		DynArray<InternalMapping> mappings;
 
+		usize numBindings = 0;
+		for (const ActionMapping& mapping : m_mappings)
+			numBindings += mapping.GetControlBindings().Size();
+		mappings.Reserve(numBindings);
+
 		for (const ActionMapping& mapping : m_mappings)
 		{
 			Rc<InputAction> action = mapping.GetAction();
 			for (const ControlBinding& binding : mapping.GetControlBindings())
 			{
-				DynArray<Unique<ITrigger>> triggers;
-				DynArray<Unique<IModifier>> modifiers;
+				InternalMapping::ValidSchemes validSchemes{ binding.GetValidSchemes().Begin(), binding.GetValidSchemes().End() };
+				InternalMapping::Triggers triggers;
+				InternalMapping::Modifiers modifiers;
 
 				for (const Unique<ITrigger>& trigger : binding.GetTriggers())
 					triggers.Add(trigger->Clone());
@@ -431,7 +443,7 @@ namespace Onca::Input
 					triggers.Add(Unique<ChordedActionTrigger>::Create(action));
 				}
 
-				InternalMapping internal{ action, binding.GetBinding()->Clone(), binding.GetValidSchemes(), Move(triggers), Move(modifiers) };
+				InternalMapping internal{ action, binding.GetBinding()->Clone(), Move(validSchemes), Move(triggers), Move(modifiers) };
 
 				mappings.Add(Move(internal));
 			}
@@ -5,6 +5,7 @@
 #include "Key.h"
 #include "core/chrono/DeltaTime.h"
 #include "core/containers/HashSet.h"
+#include "core/containers/SmallDynArray.h"
 #include "core/memory/RefCounted.h"
 #include "core/memory/Unique.h"
 
@@ -21,13 +22,20 @@ namespace Onca::Input
 	};
 
 	// TODO: UI: visually split actions from keys: i.e. mapping sets action, different keys are visualized as bindings under that mapping
+	/**
+	 * Mapping as used by a user, built from the control bindings in a mapping context
+	 * \note Mappings are rebuilt whenever the mapping contexts change, the few schemes, triggers and modifiers of a mapping are stored inline to avoid allocations
+	 */
 	class InternalMapping
 	{
 	public:
+		using ValidSchemes = SmallDynArray<u32, 4>;
+		using Triggers     = SmallDynArray<Unique<ITrigger>, 2>;
+		using Modifiers    = SmallDynArray<Unique<IModifier>, 2>;
 
 		InternalMapping() noexcept = default;
 
-		InternalMapping(const Rc<InputAction>& action, Unique<Binding>&& binding, const DynArray<u32>& validSchemes, DynArray<Unique<ITrigger>>&& triggers, DynArray<Unique<IModifier>>&& modifiers) noexcept;
+		InternalMapping(const Rc<InputAction>& action, Unique<Binding>&& binding, ValidSchemes&& validSchemes, Triggers&& triggers, Modifiers&& modifiers) noexcept;
 
 		InternalMapping(const InternalMapping& other) noexcept;
 		InternalMapping(InternalMapping&& other) noexcept = default;
@@ -73,7 +81,7 @@ namespace Onca::Input
 		 * Get the control schemes for which the binding is valid
 		 * \return Controls schemes for which the binding is valid
 		 */
-		auto GetValidSchemes() const noexcept -> DynArray<u32> { return m_validSchemes; }
+		auto GetValidSchemes() const noexcept -> const ValidSchemes& { return m_validSchemes; }
 
 		/**
 		 * Set the trigger for the binding
@@ -84,23 +92,23 @@ namespace Onca::Input
 		 * Get the trigger for the binding
 		 * \return Trigger
 		 */
-		auto GetTriggers() noexcept -> DynArray<Unique<ITrigger>>& { return m_triggers; }
+		auto GetTriggers() noexcept -> Triggers& { return m_triggers; }
 		/**
 		 * Get the trigger for the binding
 		 * \return Trigger
 		 */
-		auto GetTriggers() const noexcept -> const DynArray<Unique<ITrigger>>& { return m_triggers; }
+		auto GetTriggers() const noexcept -> const Triggers& { return m_triggers; }
 		
 		/**
 		 * Get the binding specific modifiers
 		 * \return Modifiers
 		 */
-		auto GetModifiers() noexcept -> DynArray<Unique<IModifier>>& { return m_modifiers; }
+		auto GetModifiers() noexcept -> Modifiers& { return m_modifiers; }
 		/**
 		 * Get the binding specific modifiers
 		 * \return Modifiers
 		 */
-		auto GetModifiers() const noexcept -> const DynArray<Unique<IModifier>>& { return m_modifiers; }
+		auto GetModifiers() const noexcept -> const Modifiers& { return m_modifiers; }
 
 
 		/**
@@ -125,19 +133,19 @@ namespace Onca::Input
 
 	private:
 
-		auto CalcTriggerState(DynArray<Unique<ITrigger>>& triggers, User& user, const Value& val, Chrono::DeltaTime dt) noexcept -> TriggerState;
+		auto CalcTriggerState(Triggers& triggers, User& user, const Value& val, Chrono::DeltaTime dt) noexcept -> TriggerState;
 
 		friend class InputManager;
 
-		Rc<InputAction>             m_action;       ///< Associated input action
-		Unique<Binding>             m_binding;
-		Key                         m_key;          ///< Key
+		Rc<InputAction> m_action;       ///< Associated input action
+		Unique<Binding> m_binding;
+		Key             m_key;          ///< Key
 
-		DynArray<u32>               m_validSchemes; ///< Control schemes for which this binding is valid
-		DynArray<Unique<ITrigger>>  m_triggers;     ///< Triggers
-		DynArray<Unique<IModifier>> m_modifiers;    ///< Binding specific modifiers
+		ValidSchemes    m_validSchemes; ///< Control schemes for which this binding is valid
+		Triggers        m_triggers;     ///< Triggers
+		Modifiers       m_modifiers;    ///< Binding specific modifiers
 
-		TriggerState                m_prevState;    ///< Previous trigger state
+		TriggerState    m_prevState;    ///< Previous trigger state
 	};
 
 	class ControlBinding
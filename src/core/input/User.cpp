@@ -56,50 +56,46 @@ namespace Onca::Input
 		m_needMappingRebuild = needed;
 	}
 
-	void User::RebuildMappings()
+	void User::RebuildMappings(Alloc::IAllocator& tempAlloc)
 	{
 		if (!m_needMappingRebuild)
 			return;
 
 		m_mappings.Clear();
 
-		HashSet<Key> encounteredKeys;
+		HashSet<Key> encounteredKeys{ tempAlloc };
 		for (Pair<i32, Rc<MappingContext>>& pair : m_mappingContexts)
 		{
 			DynArray<InternalMapping> orderedMappings = pair.second->GetOrderedMappings(*this);
 
 			// Now add the mappings, but ignore ghosted input, i.e. inputs with keys that already occurred and that don't have chords
-			for (usize i = 0; i < orderedMappings.Size();)
+			// The ordered mappings are discarded afterwards, so move them out instead of extracting them, which would shift all remaining mappings
+			m_mappings.Reserve(m_mappings.Size() + orderedMappings.Size());
+			for (InternalMapping& mapping : orderedMappings)
 			{
-				if (orderedMappings[i].UsesChords())
+				if (!mapping.UsesChords())
 				{
-					m_mappings.Add(orderedMappings.Extract(i));
-				}
-				else
-				{
-					if (encounteredKeys.Contains(orderedMappings[i].GetKey()))
-					{
-						++i;
+					if (encounteredKeys.Contains(mapping.GetKey()))
 						continue;
-					}
 
-					if (orderedMappings[i].GetInputAction()->ConsumesInput())
-						encounteredKeys.Insert(orderedMappings[i].GetKey());
-
-					m_mappings.Add(orderedMappings.Extract(i));
+					if (mapping.GetInputAction()->ConsumesInput())
+						encounteredKeys.Insert(mapping.GetKey());
 				}
+
+				m_mappings.Add(Move(mapping));
 			}
 		}
 
 		// Prepend modifiers
 		for (Pair<const Key, Rc<InputAction>>& pair : m_modifierActions)
 		{
-			InternalMapping mapping{ pair.second, Unique<KeyBinding>::Create(pair.first), DynArray<u32>{},
-				DynArray<Unique<ITrigger>>{ Unique<DownTrigger>::Create() }, DynArray<Unique<IModifier>>{} };
+			InternalMapping::Triggers triggers;
+			triggers.Add(Unique<DownTrigger>::Create());
+			InternalMapping mapping{ pair.second, Unique<KeyBinding>::Create(pair.first), InternalMapping::ValidSchemes{}, Move(triggers), InternalMapping::Modifiers{} };
 			m_mappings.Insert(m_mappings.Begin(), Move(mapping));
 		}
 
-		InjectChordBlockers();
+		InjectChordBlockers(tempAlloc);
 
 		m_needMappingRebuild = false;
 	}
@@ -222,11 +218,11 @@ namespace Onca::Input
 		m_controlSetIds.Clear();
 	}
 
-	void User::InjectChordBlockers() noexcept
+	void User::InjectChordBlockers(Alloc::IAllocator& tempAlloc) noexcept
 	{
-		HashMap<Key, DynArray<Weak<InputAction>>> chordingActions;
+		HashMap<Key, DynArray<Weak<InputAction>>> chordingActions{ tempAlloc };
 
-		HashSet<Weak<InputAction>> chordedActions;
+		HashSet<Weak<InputAction>> chordedActions{ tempAlloc };
 		for (InternalMapping& mapping : m_mappings)
 		{
 			chordedActions.Clear();
@@ -250,7 +246,7 @@ namespace Onca::Input
 				continue;
 			
 			if (it == chordingActions.End())
-				it = chordingActions.Insert(key, DynArray<Weak<InputAction>>{}).first;
+				it = chordingActions.Insert(key, DynArray<Weak<InputAction>>{ tempAlloc }).first;
 
 			for (const Weak<InputAction>& action : chordedActions)
 				it->second.AddUnique(action);
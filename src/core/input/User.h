@@ -83,8 +83,9 @@ namespace Onca::Input
 		void SetNeedToRebuildMappings(bool needed) noexcept;
 		/**
 		 * Rebuild the current mappings based on the mapping contexts
+		 * \param[in] tempAlloc Allocator used for temporary data during the rebuild
 		 */
-		void RebuildMappings();
+		void RebuildMappings(Alloc::IAllocator& tempAlloc = g_GlobalAlloc);
 		/**
 		 * Get the current mappings
 		 * \return Mappings
@@ -195,8 +196,9 @@ namespace Onca::Input
 
 		/**
 		 * Inject blockers into the current mappings
+		 * \param[in] tempAlloc Allocator used for temporary data
 		 */
-		void InjectChordBlockers() noexcept;
+		void InjectChordBlockers(Alloc::IAllocator& tempAlloc) noexcept;
 
 		u32                                      m_id;                  ///< User id
 		u32                                      m_schemeId;            ///< Id of the current control scheme
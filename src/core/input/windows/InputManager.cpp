@@ -120,7 +120,7 @@ namespace Onca::Input
 
 		// To avoid random fails
 		++numDevs;
-		DynArray<RAWINPUTDEVICELIST> devs;
+		DynArray<RAWINPUTDEVICELIST> devs{ m_frameAlloc };
 		devs.Resize(numDevs);
 		res = ::GetRawInputDeviceList(devs.Data(), &numDevs, sizeof(RAWINPUTDEVICELIST));
 		if (res == UINT(-1))
@@ -134,7 +134,7 @@ namespace Onca::Input
 			i32 br = 0;
 
 
-		DynArray<DeviceInfo> infos;
+		DynArray<DeviceInfo> infos{ m_frameAlloc };
 		infos.Reserve(m_rawDevInfos.Size());
 		
 		for (RAWINPUTDEVICELIST& dev : devs)
@@ -176,7 +176,10 @@ namespace Onca::Input
 			OnDeviceDisconnected(info);
 		}
 		
-		m_rawDevInfos = Move(infos);
+		// Move the infos back instead of the array, as the array lives in frame memory, this also allows the registry to keep its capacity
+		m_rawDevInfos.Clear();
+		for (DeviceInfo& info : infos)
+			m_rawDevInfos.Add(Move(info));
 	}
 }
 
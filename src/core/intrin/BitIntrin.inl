@@ -26,9 +26,9 @@ namespace Onca::Intrin
 			}
 #elif COMPILER_CLANG || COMPILER_GCC
 			if constexpr (sizeof(T) == 8)
-				return u8(t == 0 ? 255 : __builtin_clzll(t);
+				return u8(t == 0 ? 255 : __builtin_ctzll(u64(t)));
 			else
-				return u8(t == 0 ? 255 : __builtin_clz(u32(t));
+				return u8(t == 0 ? 255 : __builtin_ctz(u32(t)));
 #endif
 		}
 			
@@ -60,7 +60,6 @@ namespace Onca::Intrin
 		return ZeroCountLSB(~t);
 	}
 
-	// TODO: non-MSVC intrinsics
 	template <Integral T>
 	constexpr auto BitScanMSB(T t) noexcept -> u8
 	{
@@ -79,11 +78,11 @@ namespace Onca::Intrin
 				u8 found = _BitScanReverse(&idx, u32(t));
 				return found && idx < (sizeof(T) * 8) ? u8(idx) : u8(-1);
 			}
-#elif COMPILER_GCC
+#elif COMPILER_CLANG || COMPILER_GCC
 			if constexpr (sizeof(T) == 8)
-				return u8(t == 0 ? 255 : (sizeof(T) * 8) - 1 - __builtin_ctzll(t));
+				return u8(t == 0 ? 255 : 63 - __builtin_clzll(u64(t)));
 			else
-				return u8(t == 0 ? 255 : (sizeof(T) * 8) - 1 - __builtin_ctz(u32(t)));
+				return u8(t == 0 ? 255 : 31 - __builtin_clz(u32(t)));
 #endif
 			
 		}
@@ -126,20 +125,19 @@ namespace Onca::Intrin
 				u8 found = _BitScanReverse(&idx, u32(t));
 				return found && idx < (sizeof(T) * 8) ? u8((sizeof(T) * 8) - 1 - idx) : u8(-1);
 			}
-#elif COMPILER_GCC
+#elif COMPILER_CLANG || COMPILER_GCC
 			if constexpr (sizeof(T) == 8)
-				return u8(t == 0 ? 255 : __builtin_ctzll(t);
+				return u8(t == 0 ? 255 : __builtin_clzll(u64(t)));
 			else
-				return u8(t == 0 ? 255 : __builtin_ctz(u32(t));
+				return u8(t == 0 ? 255 : __builtin_clz(u32(t)) - (32 - sizeof(T) * 8));
 #endif
 
 		}
 
-		u8 idx = 0;
 		constexpr u8 max = sizeof(T) * 8;
-		for (; idx < max; ++idx)
+		for (u8 idx = 0; idx < max; ++idx)
 		{
-			if ((t >> idx) & 1)
+			if ((t >> (max - 1 - idx)) & 1)
 				return idx;
 		}
 		return u8(-1);
@@ -31,7 +31,7 @@ namespace Onca
 		auto res = FileSystem::File::Create(filePath, FileSystem::FileCreateKind::CreateAlways);
 
 		if (res.Success())
-			m_file = Move(res.MoveValue());
+			m_writer.SetFile(res.MoveValue());
 		else
 			m_logToFile = false;
 
@@ -42,27 +42,24 @@ namespace Onca
 	{
 		Info(LogCategories::CORE, "Logger Shutdown"_s);
 
-		if (m_file)
-			m_file.~File();
+		Threading::Lock lock{ m_fileMutex };
+		m_writer.Close();
 	}
 
 	void Logger::SetLogFile(const FileSystem::Path& filePath) noexcept
 	{
-		if (m_file)
-			m_file.Close();
-
-		auto res = FileSystem::File::Create(filePath, FileSystem::FileCreateKind::CreateAlways);
-		if (res.Success())
 		{
-			m_file = Move(res.MoveValue());
-			m_logToFile = true;
+			Threading::Lock lock{ m_fileMutex };
+			m_writer.Close();
 
-			Info(LogCategories::CORE, "Logger file path set: {}"_s, filePath);
-		}
-		else
-		{
-			m_logToFile = false;
+			auto res = FileSystem::File::Create(filePath, FileSystem::FileCreateKind::CreateAlways);
+			if (res.Success())
+				m_writer.SetFile(res.MoveValue());
+			m_logToFile = m_writer.IsValid();
 		}
+
+		if (m_logToFile)
+			Info(LogCategories::CORE, "Logger file path set: {}"_s, filePath);
 	}
 
 	void Logger::SetMaxLogLevel(LogLevel level) noexcept
@@ -72,7 +69,8 @@ namespace Onca
 
 	void Logger::SetLogToFile(bool enable) noexcept
 	{
-		m_logToFile = enable && m_file;
+		Threading::Lock lock{ m_fileMutex };
+		m_logToFile = enable && m_writer;
 	}
 
 	void Logger::SetLogToSystemConsole(bool enable) noexcept
@@ -105,7 +103,13 @@ namespace Onca
 		String formatted = prefix + message + '\n';
 
 		if (m_logToFile && (validLevel || m_ignoreMaxLevelForFile))
+		{
+			Threading::Lock lock{ m_fileMutex };
 			LogToFile(formatted);
+			// Make sure errors end up in the file, even if the application crashes afterwards
+			if (level == LogLevel::Severe || level == LogLevel::Error)
+				m_writer.Flush();
+		}
 
 		if (!validLevel)
 			return;
@@ -118,11 +122,10 @@ namespace Onca
 
 	void Logger::LogToFile(const String& str) noexcept
 	{
-		if (!m_file)
+		if (!m_writer)
 			return;
 
-		ByteBuffer buffer{ str.Data(), str.DataSize() };
-		m_file.Write(buffer);
+		m_writer.Write(str);
 	}
 
 	void Logger::LogToSysConsole(const String& str, LogLevel level) noexcept
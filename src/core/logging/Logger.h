@@ -1,6 +1,7 @@
 #pragma once
 #include "LogCategory.h"
 #include "core/filesystem/FileSystem.h"
+#include "core/threading/Sync.h"
 
 namespace Onca
 {
@@ -18,6 +19,8 @@ namespace Onca
 
 	/**
 	 * Logger
+	 * \note Log files are written through a buffer, which is flushed on errors and when the logger is shut down
+	 * \note Writes to the log file are serialized, so messages can be logged from multiple threads
 	 */
 	// TODO: Allow log messages with colors + write them correctly to each output
 	class CORE_API Logger
@@ -148,6 +151,7 @@ namespace Onca
 		/**
 		 * Log a string to the logger's file
 		 * \param[in] str String to log
+		 * \note The file mutex needs to be held
 		 */
 		void LogToFile(const String& str) noexcept;
 		/**
@@ -173,7 +177,8 @@ namespace Onca
 			"INVALID LOG LEVEL"
 		};
 
-		FileSystem::File m_file;                      ///< File to log to
+		FileSystem::BufferedFileWriter m_writer;      ///< Buffered writer to the file to log to
+		Threading::Mutex m_fileMutex;                 ///< Mutex guarding the writer
 		LogLevel         m_maxLevel;                  ///< Maximum log level to output
 		bool             m_logToSysConsole : 1;       ///< Whether to log to the system console
 		bool             m_logToFile       : 1;       ///< Whether to log to a file
@@ -0,0 +1,102 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "MemRef.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Reference to an allocation, for when the allocator, size and alignment of the allocation are known from context
+	 * \tparam T Underlying type
+	 *
+	 * A compact MemRef only stores the address of the allocation, making it a third of the size of a MemRef.
+	 * It is meant to be used inside of containers, which store the allocator once and can derive the size and alignment of their allocations,
+	 * e.g. for the buckets of a hash map or the block table of a deque.
+	 * As the memory can't be released without the missing info, the owner is responsible to deallocate it via Dealloc(), or to convert it back into a MemRef.
+	 *
+	 * \note Destroying a compact MemRef does not release its memory
+	 * \note The allocator needs to be able to identify its allocations by their address, as the sub-allocator that was used for the allocation is lost
+	 */
+	template<typename T>
+	class CompactMemRef
+	{
+	public:
+		/**
+		 * Create an invalid compact MemRef
+		 */
+		CompactMemRef() noexcept;
+		/**
+		 * Create an invalid compact MemRef
+		 */
+		CompactMemRef(nullptr_t) noexcept;
+		/**
+		 * Take ownership of the memory of a MemRef
+		 * \param[in] mem MemRef
+		 * \note The allocator, size and alignment of the MemRef are discarded, so they need to be known by the owner
+		 */
+		explicit CompactMemRef(MemRef<T>&& mem) noexcept;
+		/**
+		 * Take ownership of an allocation
+		 * \param[in] pAddr Address of the allocation
+		 */
+		explicit CompactMemRef(T* pAddr) noexcept;
+		CompactMemRef(const CompactMemRef& other) noexcept;
+		CompactMemRef(CompactMemRef&& other) noexcept;
+
+		auto operator=(nullptr_t) noexcept -> CompactMemRef&;
+		auto operator=(const CompactMemRef& other) noexcept -> CompactMemRef&;
+		auto operator=(CompactMemRef&& other) noexcept -> CompactMemRef&;
+
+		/**
+		 * Get the actual pointer to memory
+		 * \return Pointer to underlying memory
+		 */
+		auto Ptr() const noexcept -> T* { return m_pAddr; }
+		/**
+		 * Checks whether the allocation is valid
+		 * \return Whether the allocation is valid
+		 */
+		auto IsValid() const noexcept -> bool { return m_pAddr; }
+
+		/**
+		 * Get a MemRef referencing the allocation
+		 * \param[in] pAlloc Allocator used for the allocation
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 * \return MemRef referencing the allocation
+		 */
+		auto ToMemRef(Alloc::IAllocator* pAlloc, usize size, u16 align) const noexcept -> MemRef<T>;
+		/**
+		 * Convert the allocation into a MemRef and invalidate this reference
+		 * \param[in] pAlloc Allocator used for the allocation
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 * \return MemRef referencing the allocation
+		 */
+		auto Release(Alloc::IAllocator* pAlloc, usize size, u16 align) noexcept -> MemRef<T>;
+		/**
+		 * Deallocate the allocation
+		 * \param[in] pAlloc Allocator used for the allocation
+		 * \param[in] size Size of the allocation
+		 * \param[in] align Alignment of the allocation
+		 */
+		void Dealloc(Alloc::IAllocator* pAlloc, usize size, u16 align) noexcept;
+
+		auto operator->() const noexcept -> T* { return m_pAddr; }
+		auto operator*() const noexcept -> T& { return *m_pAddr; }
+
+		explicit operator bool() const noexcept { return m_pAddr; }
+
+		auto operator==(const CompactMemRef& other) const noexcept -> bool { return m_pAddr == other.m_pAddr; }
+		auto operator!=(const CompactMemRef& other) const noexcept -> bool { return m_pAddr != other.m_pAddr; }
+
+	private:
+		T* m_pAddr; ///< Pointer
+	};
+
+	STATIC_ASSERT(sizeof(CompactMemRef<u8>) == sizeof(void*), "Invalid CompactMemRef<T> size");
+
+	template<typename T>
+	constexpr bool IsTriviallyRelocatable<CompactMemRef<T>> = true;
+}
+
+#include "CompactMemRef.inl"
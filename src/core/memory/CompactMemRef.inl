@@ -0,0 +1,92 @@
+#pragma once
+#if __RESHARPER__
+#include "CompactMemRef.h"
+#endif
+
+#include "core/allocator/IAllocator.h"
+
+namespace Onca
+{
+	template <typename T>
+	CompactMemRef<T>::CompactMemRef() noexcept
+		: m_pAddr(nullptr)
+	{
+	}
+
+	template <typename T>
+	CompactMemRef<T>::CompactMemRef(nullptr_t) noexcept
+		: m_pAddr(nullptr)
+	{
+	}
+
+	template <typename T>
+	CompactMemRef<T>::CompactMemRef(MemRef<T>&& mem) noexcept
+		: m_pAddr(mem.Ptr())
+	{
+		mem = nullptr;
+	}
+
+	template <typename T>
+	CompactMemRef<T>::CompactMemRef(T* pAddr) noexcept
+		: m_pAddr(pAddr)
+	{
+	}
+
+	template <typename T>
+	CompactMemRef<T>::CompactMemRef(const CompactMemRef& other) noexcept
+		: m_pAddr(other.m_pAddr)
+	{
+	}
+
+	template <typename T>
+	CompactMemRef<T>::CompactMemRef(CompactMemRef&& other) noexcept
+		: m_pAddr(other.m_pAddr)
+	{
+		other.m_pAddr = nullptr;
+	}
+
+	template <typename T>
+	auto CompactMemRef<T>::operator=(nullptr_t) noexcept -> CompactMemRef&
+	{
+		m_pAddr = nullptr;
+		return *this;
+	}
+
+	template <typename T>
+	auto CompactMemRef<T>::operator=(const CompactMemRef& other) noexcept -> CompactMemRef&
+	{
+		m_pAddr = other.m_pAddr;
+		return *this;
+	}
+
+	template <typename T>
+	auto CompactMemRef<T>::operator=(CompactMemRef&& other) noexcept -> CompactMemRef&
+	{
+		m_pAddr = other.m_pAddr;
+		other.m_pAddr = nullptr;
+		return *this;
+	}
+
+	template <typename T>
+	auto CompactMemRef<T>::ToMemRef(Alloc::IAllocator* pAlloc, usize size, u16 align) const noexcept -> MemRef<T>
+	{
+		if (!m_pAddr)
+			return MemRef<T>{ pAlloc };
+		return { m_pAddr, pAlloc, Math::Log2(align), size, false };
+	}
+
+	template <typename T>
+	auto CompactMemRef<T>::Release(Alloc::IAllocator* pAlloc, usize size, u16 align) noexcept -> MemRef<T>
+	{
+		MemRef<T> mem = ToMemRef(pAlloc, size, align);
+		m_pAddr = nullptr;
+		return mem;
+	}
+
+	template <typename T>
+	void CompactMemRef<T>::Dealloc(Alloc::IAllocator* pAlloc, usize size, u16 align) noexcept
+	{
+		if (m_pAddr)
+			pAlloc->Deallocate(Release(pAlloc, size, align));
+	}
+}
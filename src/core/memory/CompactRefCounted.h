@@ -0,0 +1,414 @@
+#pragma once
+#include "MemRef.h"
+#include "core/utils/Atomic.h"
+#include "core/utils/Utils.h"
+
+namespace Onca
+{
+	namespace Detail
+	{
+		/**
+		 * Non-atomic reference count
+		 */
+		struct RefCount
+		{
+			u32 count;
+
+			explicit RefCount(u32 init) noexcept;
+
+			/**
+			 * Increment the count
+			 */
+			void Inc() noexcept;
+			/**
+			 * Increment the count, only if the count is not 0
+			 * \return Whether the count was incremented
+			 */
+			auto TryInc() noexcept -> bool;
+			/**
+			 * Decrement the count
+			 * \return Whether the count reached 0
+			 */
+			auto Dec() noexcept -> bool;
+			/**
+			 * Get the current count
+			 * \return Current count
+			 */
+			auto Get() const noexcept -> u32;
+		};
+
+		/**
+		 * Atomic reference count
+		 */
+		struct AtomicRefCount
+		{
+			Atomic<u32> count;
+
+			explicit AtomicRefCount(u32 init) noexcept;
+
+			/**
+			 * Increment the count
+			 */
+			void Inc() noexcept;
+			/**
+			 * Increment the count, only if the count is not 0
+			 * \return Whether the count was incremented
+			 */
+			auto TryInc() noexcept -> bool;
+			/**
+			 * Decrement the count
+			 * \return Whether the count reached 0
+			 */
+			auto Dec() noexcept -> bool;
+			/**
+			 * Get the current count
+			 * \return Current count
+			 */
+			auto Get() const noexcept -> u32;
+		};
+
+		/**
+		 * Control block that is located directly in front of the object it manages, inside of the same allocation
+		 * \tparam Counter Reference count type
+		 */
+		template<typename Counter>
+		struct CompactControlBlock
+		{
+			Counter    strongCount;                ///< Number of strong references
+			Counter    weakCount;                  ///< Number of weak references, +1 while there are strong references
+			void       (*pDestroy)(void*) noexcept; ///< Destroy the object (as the type it was created with)
+			MemRef<u8> mem;                        ///< Allocation containing both the control block and the object
+
+			CompactControlBlock(void (*destroy)(void*) noexcept, MemRef<u8>&& memory) noexcept;
+
+			/**
+			 * Get the control block of an object
+			 * \param[in] pObj Pointer to the object
+			 * \return Control block
+			 */
+			static auto FromObject(const void* pObj) noexcept -> CompactControlBlock*;
+		};
+
+		template<typename T, typename Counter>
+		class CompactWeak;
+
+		/**
+		 * \brief Ref counted pointer that is only the size of a pointer
+		 *
+		 * The object and its control block live in a single allocation, the control block is located directly in front of the object.
+		 * The handle only stores a pointer to the object, the allocator and destructor are stored in the control block.
+		 *
+		 * \tparam T Underlying type
+		 * \tparam Counter Reference count type
+		 * \note Converting to a base type is only supported when the base is located at the start of the derived type
+		 */
+		template<typename T, typename Counter>
+		class CompactRefCounted
+		{
+		public:
+			using ControlBlock = CompactControlBlock<Counter>;
+
+			/**
+			 * Create a null ref counted pointer
+			 */
+			constexpr CompactRefCounted() noexcept;
+			/**
+			 * Create a null ref counted pointer
+			 */
+			constexpr CompactRefCounted(nullptr_t) noexcept;
+
+			template<typename U>
+				requires DerivesFrom<U, T>
+			CompactRefCounted(CompactRefCounted<U, Counter>&& rc) noexcept;
+			CompactRefCounted(const CompactRefCounted& rc) noexcept;
+			CompactRefCounted(CompactRefCounted&& rc) noexcept;
+
+			~CompactRefCounted() noexcept;
+
+			auto operator=(nullptr_t) noexcept -> CompactRefCounted&;
+			auto operator=(const CompactRefCounted& rc) noexcept -> CompactRefCounted&;
+			auto operator=(CompactRefCounted&& rc) noexcept -> CompactRefCounted&;
+
+			/**
+			 * \brief Swap the contents of this ref counted pointer with another
+			 * \param[in] other Ref counted pointer to swap contents with
+			 */
+			void Swap(CompactRefCounted& other) noexcept;
+
+			/**
+			 * \brief Get a pointer to the managed object
+			 * \return Pointer to managed object
+			 */
+			auto Get() const noexcept -> T*;
+			/**
+			 * Get the allocator used to allocate the object
+			 * \return Allocator, or nullptr when the ref counted pointer is null
+			 */
+			auto GetAlloc() const noexcept -> Alloc::IAllocator*;
+			/**
+			 * Get the number of ref counted pointer that reference the data
+			 * \return Use count
+			 */
+			auto UseCount() const noexcept -> u32;
+
+			explicit operator bool() const noexcept;
+
+			auto operator->() const noexcept -> T*;
+			auto operator*() const noexcept -> T&;
+
+			template<typename U>
+			auto operator==(const CompactRefCounted<U, Counter>& other) const noexcept -> bool;
+
+			/**
+			 * Create a ref counted pointer with a constructed type and the global allocator
+			 * \tparam Args Argument types
+			 * \param[in] args Arguments to construct type
+			 * \return Ref counted pointer with the constructed type
+			 */
+			template<typename ...Args>
+			static auto Create(Args&&... args) noexcept -> CompactRefCounted;
+			/**
+			 * Create a ref counted pointer with a constructed type, the object and control block are allocated with a single allocation
+			 * \tparam Args Argument types
+			 * \param[in] alloc Allocator to use
+			 * \param[in] args Arguments to construct type
+			 * \return Ref counted pointer with the constructed type
+			 */
+			template<typename ...Args>
+			static auto CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> CompactRefCounted;
+
+		private:
+			template<typename U, typename C>
+			friend class CompactRefCounted;
+			template<typename U, typename C>
+			friend class CompactWeak;
+
+			/**
+			 * Create a ref counted pointer from an object that already has a strong reference taken for it
+			 * \param[in] pObj Pointer to the object
+			 */
+			explicit CompactRefCounted(T* pObj) noexcept;
+
+			/**
+			 * Drop the strong reference, destroying the object and/or deallocating the memory when needed
+			 */
+			void DecRef() noexcept;
+
+			T* m_pObj; ///< Pointer to the object
+		};
+
+		/**
+		 * Weak reference to an object managed by a CompactRefCounted
+		 * \tparam T Underlying type
+		 * \tparam Counter Reference count type
+		 */
+		template<typename T, typename Counter>
+		class CompactWeak
+		{
+		public:
+			using ControlBlock = CompactControlBlock<Counter>;
+
+			/**
+			 * Create a null weak pointer
+			 */
+			constexpr CompactWeak() noexcept;
+			/**
+			 * Create a null weak pointer
+			 */
+			constexpr CompactWeak(nullptr_t) noexcept;
+			/**
+			 * Create a weak pointer from a ref counted pointer
+			 * \param[in] rc Ref counted pointer
+			 */
+			CompactWeak(const CompactRefCounted<T, Counter>& rc) noexcept;
+			CompactWeak(const CompactWeak& weak) noexcept;
+			CompactWeak(CompactWeak&& weak) noexcept;
+
+			~CompactWeak() noexcept;
+
+			auto operator=(const CompactWeak& weak) noexcept -> CompactWeak&;
+			auto operator=(CompactWeak&& weak) noexcept -> CompactWeak&;
+
+			/**
+			 * \brief Swap the contents of this weak pointer with another
+			 * \param[in] other Weak pointer to swap contents with
+			 */
+			void Swap(CompactWeak& other) noexcept;
+
+			/**
+			 * Try to get a strong reference to the object
+			 * \return Ref counted pointer, or a null ref counted pointer if the object was already destroyed
+			 */
+			auto Lock() const noexcept -> CompactRefCounted<T, Counter>;
+			/**
+			 * Get the number of ref counted pointer that reference the data
+			 * \return Use count
+			 */
+			auto UseCount() const noexcept -> u32;
+			/**
+			 * Check if the object is still alive
+			 * \return Whether the object is still alive
+			 */
+			auto IsValid() const noexcept -> bool;
+
+			explicit operator bool() const noexcept;
+
+			auto operator==(const CompactWeak& other) const noexcept -> bool;
+
+		private:
+			/**
+			 * Drop the weak reference, deallocating the memory when needed
+			 */
+			void DecRef() noexcept;
+
+			T* m_pObj; ///< Pointer to the object, only valid to dereference while there are strong references
+		};
+
+		template<typename T, typename Counter>
+		class IntrusiveRefCounted;
+
+		/**
+		 * Base class for types that embed their own reference count, to be used with IntrusiveRc and IntrusiveArc
+		 * \tparam Counter Reference count type
+		 */
+		template<typename Counter>
+		class IntrusiveRefCountBase
+		{
+		public:
+			IntrusiveRefCountBase() noexcept;
+			IntrusiveRefCountBase(const IntrusiveRefCountBase&) noexcept;
+
+			auto operator=(const IntrusiveRefCountBase&) noexcept -> IntrusiveRefCountBase&;
+
+			/**
+			 * Get the number of references to the object
+			 * \return Number of references
+			 */
+			auto GetRefCount() const noexcept -> u32;
+
+		protected:
+			~IntrusiveRefCountBase() noexcept = default;
+
+		private:
+			template<typename U, typename C>
+			friend class IntrusiveRefCounted;
+
+			Counter    m_refCount; ///< Number of references
+			MemRef<u8> m_mem;      ///< Allocation of the object, only valid when the object was created via IntrusiveRefCounted::Create
+		};
+
+		/**
+		 * \brief Ref counted pointer to an object that embeds its own reference count
+		 *
+		 * Since the reference count is part of the object, a new reference can be created from any pointer to the object (e.g. 'this').
+		 * Objects that were not created via Create() are not owned, they are never destroyed when the last reference is dropped.
+		 *
+		 * \tparam T Underlying type, needs to derive from IntrusiveRefCountBase
+		 * \tparam Counter Reference count type
+		 */
+		template<typename T, typename Counter>
+		class IntrusiveRefCounted
+		{
+		public:
+			/**
+			 * Create a null ref counted pointer
+			 */
+			constexpr IntrusiveRefCounted() noexcept;
+			/**
+			 * Create a null ref counted pointer
+			 */
+			constexpr IntrusiveRefCounted(nullptr_t) noexcept;
+			/**
+			 * Create a new reference to an object
+			 * \param[in] pObj Pointer to the object
+			 */
+			explicit IntrusiveRefCounted(T* pObj) noexcept;
+
+			template<typename U>
+				requires DerivesFrom<U, T>
+			IntrusiveRefCounted(IntrusiveRefCounted<U, Counter>&& rc) noexcept;
+			IntrusiveRefCounted(const IntrusiveRefCounted& rc) noexcept;
+			IntrusiveRefCounted(IntrusiveRefCounted&& rc) noexcept;
+
+			~IntrusiveRefCounted() noexcept;
+
+			auto operator=(nullptr_t) noexcept -> IntrusiveRefCounted&;
+			auto operator=(const IntrusiveRefCounted& rc) noexcept -> IntrusiveRefCounted&;
+			auto operator=(IntrusiveRefCounted&& rc) noexcept -> IntrusiveRefCounted&;
+
+			/**
+			 * \brief Swap the contents of this ref counted pointer with another
+			 * \param[in] other Ref counted pointer to swap contents with
+			 */
+			void Swap(IntrusiveRefCounted& other) noexcept;
+
+			/**
+			 * \brief Get a pointer to the managed object
+			 * \return Pointer to managed object
+			 */
+			auto Get() const noexcept -> T*;
+			/**
+			 * Get the number of ref counted pointer that reference the data
+			 * \return Use count
+			 */
+			auto UseCount() const noexcept -> u32;
+
+			explicit operator bool() const noexcept;
+
+			auto operator->() const noexcept -> T*;
+			auto operator*() const noexcept -> T&;
+
+			template<typename U>
+			auto operator==(const IntrusiveRefCounted<U, Counter>& other) const noexcept -> bool;
+
+			/**
+			 * Create a ref counted pointer with a constructed type and the global allocator
+			 * \tparam Args Argument types
+			 * \param[in] args Arguments to construct type
+			 * \return Ref counted pointer with the constructed type
+			 */
+			template<typename ...Args>
+			static auto Create(Args&&... args) noexcept -> IntrusiveRefCounted;
+			/**
+			 * Create a ref counted pointer with a constructed type
+			 * \tparam Args Argument types
+			 * \param[in] alloc Allocator to use
+			 * \param[in] args Arguments to construct type
+			 * \return Ref counted pointer with the constructed type
+			 */
+			template<typename ...Args>
+			static auto CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> IntrusiveRefCounted;
+
+		private:
+			template<typename U, typename C>
+			friend class IntrusiveRefCounted;
+
+			/**
+			 * Drop the reference, destroying and deallocating the object when it is owned and this was the last reference
+			 */
+			void DecRef() noexcept;
+
+			T* m_pObj; ///< Pointer to the object
+		};
+	}
+
+	template<typename T>
+	using CompactRc = Detail::CompactRefCounted<T, Detail::RefCount>;
+	template<typename T>
+	using CompactWeak = Detail::CompactWeak<T, Detail::RefCount>;
+
+	template<typename T>
+	using CompactArc = Detail::CompactRefCounted<T, Detail::AtomicRefCount>;
+	template<typename T>
+	using CompactAWeak = Detail::CompactWeak<T, Detail::AtomicRefCount>;
+
+	using RcObject = Detail::IntrusiveRefCountBase<Detail::RefCount>;
+	using ArcObject = Detail::IntrusiveRefCountBase<Detail::AtomicRefCount>;
+
+	template<typename T>
+	using IntrusiveRc = Detail::IntrusiveRefCounted<T, Detail::RefCount>;
+	template<typename T>
+	using IntrusiveArc = Detail::IntrusiveRefCounted<T, Detail::AtomicRefCount>;
+}
+
+#include "CompactRefCounted.inl"
@@ -0,0 +1,581 @@
+#pragma once
+#if __RESHARPER__
+#include "CompactRefCounted.h"
+#endif
+#include "core/utils/Algo.h"
+#include "core/allocator/GlobalAlloc.h"
+
+namespace Onca
+{
+	namespace Detail
+	{
+		inline RefCount::RefCount(u32 init) noexcept
+			: count(init)
+		{
+		}
+
+		inline void RefCount::Inc() noexcept
+		{
+			++count;
+		}
+
+		inline auto RefCount::TryInc() noexcept -> bool
+		{
+			if (!count)
+				return false;
+			++count;
+			return true;
+		}
+
+		inline auto RefCount::Dec() noexcept -> bool
+		{
+			ASSERT(count, "Reference count underflow");
+			return --count == 0;
+		}
+
+		inline auto RefCount::Get() const noexcept -> u32
+		{
+			return count;
+		}
+
+		inline AtomicRefCount::AtomicRefCount(u32 init) noexcept
+			: count(init)
+		{
+		}
+
+		inline void AtomicRefCount::Inc() noexcept
+		{
+			// A new reference can only be created from an existing one, so no ordering is needed
+			count.FetchAdd(1, MemOrder::Relaxed);
+		}
+
+		inline auto AtomicRefCount::TryInc() noexcept -> bool
+		{
+			u32 cur = count.Load(MemOrder::Relaxed);
+			do
+			{
+				if (!cur)
+					return false;
+			}
+			while (!count.CompareExchangeWeak(cur, cur + 1, MemOrder::AcqRel));
+			return true;
+		}
+
+		inline auto AtomicRefCount::Dec() noexcept -> bool
+		{
+			// Release makes all writes to the object visible to the thread dropping the last reference, acquire makes that thread see them
+			return count.FetchSub(1, MemOrder::AcqRel) == 1;
+		}
+
+		inline auto AtomicRefCount::Get() const noexcept -> u32
+		{
+			return count.Load(MemOrder::Relaxed);
+		}
+
+		template<typename T>
+		void DestroyCompactObject(void* pObj) noexcept
+		{
+			static_cast<T*>(pObj)->~T();
+		}
+
+		template <typename Counter>
+		CompactControlBlock<Counter>::CompactControlBlock(void (*destroy)(void*) noexcept, MemRef<u8>&& memory) noexcept
+			: strongCount(1)
+			, weakCount(1)
+			, pDestroy(destroy)
+			, mem(Move(memory))
+		{
+		}
+
+		template <typename Counter>
+		auto CompactControlBlock<Counter>::FromObject(const void* pObj) noexcept -> CompactControlBlock*
+		{
+			return reinterpret_cast<CompactControlBlock*>(const_cast<u8*>(static_cast<const u8*>(pObj)) - sizeof(CompactControlBlock));
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		template <typename T, typename Counter>
+		constexpr CompactRefCounted<T, Counter>::CompactRefCounted() noexcept
+			: m_pObj(nullptr)
+		{
+		}
+
+		template <typename T, typename Counter>
+		constexpr CompactRefCounted<T, Counter>::CompactRefCounted(nullptr_t) noexcept
+			: m_pObj(nullptr)
+		{
+		}
+
+		template <typename T, typename Counter>
+		CompactRefCounted<T, Counter>::CompactRefCounted(T* pObj) noexcept
+			: m_pObj(pObj)
+		{
+		}
+
+		template <typename T, typename Counter>
+		template <typename U>
+			requires DerivesFrom<U, T>
+		CompactRefCounted<T, Counter>::CompactRefCounted(CompactRefCounted<U, Counter>&& rc) noexcept
+			: m_pObj(rc.m_pObj)
+		{
+			ASSERT(static_cast<void*>(m_pObj) == static_cast<void*>(rc.m_pObj), "The base type needs to be located at the start of the derived type");
+			rc.m_pObj = nullptr;
+		}
+
+		template <typename T, typename Counter>
+		CompactRefCounted<T, Counter>::CompactRefCounted(const CompactRefCounted& rc) noexcept
+			: m_pObj(rc.m_pObj)
+		{
+			if (m_pObj)
+				ControlBlock::FromObject(m_pObj)->strongCount.Inc();
+		}
+
+		template <typename T, typename Counter>
+		CompactRefCounted<T, Counter>::CompactRefCounted(CompactRefCounted&& rc) noexcept
+			: m_pObj(rc.m_pObj)
+		{
+			rc.m_pObj = nullptr;
+		}
+
+		template <typename T, typename Counter>
+		CompactRefCounted<T, Counter>::~CompactRefCounted() noexcept
+		{
+			DecRef();
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::operator=(nullptr_t) noexcept -> CompactRefCounted&
+		{
+			DecRef();
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::operator=(const CompactRefCounted& rc) noexcept -> CompactRefCounted&
+		{
+			if (rc.m_pObj)
+				ControlBlock::FromObject(rc.m_pObj)->strongCount.Inc();
+			DecRef();
+			m_pObj = rc.m_pObj;
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::operator=(CompactRefCounted&& rc) noexcept -> CompactRefCounted&
+		{
+			if (this != &rc)
+			{
+				DecRef();
+				m_pObj = rc.m_pObj;
+				rc.m_pObj = nullptr;
+			}
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		void CompactRefCounted<T, Counter>::Swap(CompactRefCounted& other) noexcept
+		{
+			Algo::Swap(m_pObj, other.m_pObj);
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::Get() const noexcept -> T*
+		{
+			return m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::GetAlloc() const noexcept -> Alloc::IAllocator*
+		{
+			return m_pObj ? ControlBlock::FromObject(m_pObj)->mem.GetAlloc() : nullptr;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::UseCount() const noexcept -> u32
+		{
+			return m_pObj ? ControlBlock::FromObject(m_pObj)->strongCount.Get() : 0;
+		}
+
+		template <typename T, typename Counter>
+		CompactRefCounted<T, Counter>::operator bool() const noexcept
+		{
+			return m_pObj != nullptr;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::operator->() const noexcept -> T*
+		{
+			ASSERT(m_pObj, "Calling operator->() on a null CompactRefCounted");
+			return m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactRefCounted<T, Counter>::operator*() const noexcept -> T&
+		{
+			ASSERT(m_pObj, "Calling operator*() on a null CompactRefCounted");
+			return *m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		template <typename U>
+		auto CompactRefCounted<T, Counter>::operator==(const CompactRefCounted<U, Counter>& other) const noexcept -> bool
+		{
+			return static_cast<const void*>(m_pObj) == static_cast<const void*>(other.m_pObj);
+		}
+
+		template <typename T, typename Counter>
+		template <typename ... Args>
+		auto CompactRefCounted<T, Counter>::Create(Args&&... args) noexcept -> CompactRefCounted
+		{
+			return CreateWithAlloc(g_GlobalAlloc, Forward<Args>(args)...);
+		}
+
+		template <typename T, typename Counter>
+		template <typename ... Args>
+		auto CompactRefCounted<T, Counter>::CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> CompactRefCounted
+		{
+			// The object is placed at the first suitably aligned offset after the control block, the control block directly precedes it
+			constexpr usize align = alignof(T) > alignof(ControlBlock) ? alignof(T) : alignof(ControlBlock);
+			constexpr usize objOffset = (sizeof(ControlBlock) + alignof(T) - 1) & ~(alignof(T) - 1);
+
+			MemRef<u8> mem = alloc.Allocate<u8>(objOffset + sizeof(T), u16(align));
+			if (!mem.IsValid())
+				return CompactRefCounted{};
+
+			u8* pObjMem = mem.Ptr() + objOffset;
+			new (pObjMem - sizeof(ControlBlock)) ControlBlock{ &DestroyCompactObject<T>, Move(mem) };
+			T* pObj = new (pObjMem) T{ Forward<Args>(args)... };
+			return CompactRefCounted{ pObj };
+		}
+
+		template <typename T, typename Counter>
+		void CompactRefCounted<T, Counter>::DecRef() noexcept
+		{
+			if (!m_pObj)
+				return;
+
+			ControlBlock* pControl = ControlBlock::FromObject(m_pObj);
+			if (pControl->strongCount.Dec())
+			{
+				pControl->pDestroy(m_pObj);
+
+				// All strong references together hold a single weak reference, so the memory stays alive for weak references
+				if (pControl->weakCount.Dec())
+				{
+					MemRef<u8> mem = Move(pControl->mem);
+					pControl->~ControlBlock();
+					mem.Dealloc();
+				}
+			}
+			m_pObj = nullptr;
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		template <typename T, typename Counter>
+		constexpr CompactWeak<T, Counter>::CompactWeak() noexcept
+			: m_pObj(nullptr)
+		{
+		}
+
+		template <typename T, typename Counter>
+		constexpr CompactWeak<T, Counter>::CompactWeak(nullptr_t) noexcept
+			: m_pObj(nullptr)
+		{
+		}
+
+		template <typename T, typename Counter>
+		CompactWeak<T, Counter>::CompactWeak(const CompactRefCounted<T, Counter>& rc) noexcept
+			: m_pObj(rc.m_pObj)
+		{
+			if (m_pObj)
+				ControlBlock::FromObject(m_pObj)->weakCount.Inc();
+		}
+
+		template <typename T, typename Counter>
+		CompactWeak<T, Counter>::CompactWeak(const CompactWeak& weak) noexcept
+			: m_pObj(weak.m_pObj)
+		{
+			if (m_pObj)
+				ControlBlock::FromObject(m_pObj)->weakCount.Inc();
+		}
+
+		template <typename T, typename Counter>
+		CompactWeak<T, Counter>::CompactWeak(CompactWeak&& weak) noexcept
+			: m_pObj(weak.m_pObj)
+		{
+			weak.m_pObj = nullptr;
+		}
+
+		template <typename T, typename Counter>
+		CompactWeak<T, Counter>::~CompactWeak() noexcept
+		{
+			DecRef();
+		}
+
+		template <typename T, typename Counter>
+		auto CompactWeak<T, Counter>::operator=(const CompactWeak& weak) noexcept -> CompactWeak&
+		{
+			if (weak.m_pObj)
+				ControlBlock::FromObject(weak.m_pObj)->weakCount.Inc();
+			DecRef();
+			m_pObj = weak.m_pObj;
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactWeak<T, Counter>::operator=(CompactWeak&& weak) noexcept -> CompactWeak&
+		{
+			if (this != &weak)
+			{
+				DecRef();
+				m_pObj = weak.m_pObj;
+				weak.m_pObj = nullptr;
+			}
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		void CompactWeak<T, Counter>::Swap(CompactWeak& other) noexcept
+		{
+			Algo::Swap(m_pObj, other.m_pObj);
+		}
+
+		template <typename T, typename Counter>
+		auto CompactWeak<T, Counter>::Lock() const noexcept -> CompactRefCounted<T, Counter>
+		{
+			if (m_pObj && ControlBlock::FromObject(m_pObj)->strongCount.TryInc())
+				return CompactRefCounted<T, Counter>{ m_pObj };
+			return nullptr;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactWeak<T, Counter>::UseCount() const noexcept -> u32
+		{
+			return m_pObj ? ControlBlock::FromObject(m_pObj)->strongCount.Get() : 0;
+		}
+
+		template <typename T, typename Counter>
+		auto CompactWeak<T, Counter>::IsValid() const noexcept -> bool
+		{
+			return UseCount() != 0;
+		}
+
+		template <typename T, typename Counter>
+		CompactWeak<T, Counter>::operator bool() const noexcept
+		{
+			return IsValid();
+		}
+
+		template <typename T, typename Counter>
+		auto CompactWeak<T, Counter>::operator==(const CompactWeak& other) const noexcept -> bool
+		{
+			return m_pObj == other.m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		void CompactWeak<T, Counter>::DecRef() noexcept
+		{
+			if (!m_pObj)
+				return;
+
+			ControlBlock* pControl = ControlBlock::FromObject(m_pObj);
+			if (pControl->weakCount.Dec())
+			{
+				MemRef<u8> mem = Move(pControl->mem);
+				pControl->~ControlBlock();
+				mem.Dealloc();
+			}
+			m_pObj = nullptr;
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		template <typename Counter>
+		IntrusiveRefCountBase<Counter>::IntrusiveRefCountBase() noexcept
+			: m_refCount(0)
+		{
+		}
+
+		template <typename Counter>
+		IntrusiveRefCountBase<Counter>::IntrusiveRefCountBase(const IntrusiveRefCountBase&) noexcept
+			: m_refCount(0)
+		{
+		}
+
+		template <typename Counter>
+		auto IntrusiveRefCountBase<Counter>::operator=(const IntrusiveRefCountBase&) noexcept -> IntrusiveRefCountBase&
+		{
+			// The reference count and allocation belong to the object itself, not to its value
+			return *this;
+		}
+
+		template <typename Counter>
+		auto IntrusiveRefCountBase<Counter>::GetRefCount() const noexcept -> u32
+		{
+			return m_refCount.Get();
+		}
+
+		////////////////////////////////////////////////////////////////
+
+		template <typename T, typename Counter>
+		constexpr IntrusiveRefCounted<T, Counter>::IntrusiveRefCounted() noexcept
+			: m_pObj(nullptr)
+		{
+		}
+
+		template <typename T, typename Counter>
+		constexpr IntrusiveRefCounted<T, Counter>::IntrusiveRefCounted(nullptr_t) noexcept
+			: m_pObj(nullptr)
+		{
+		}
+
+		template <typename T, typename Counter>
+		IntrusiveRefCounted<T, Counter>::IntrusiveRefCounted(T* pObj) noexcept
+			: m_pObj(pObj)
+		{
+			static_assert(DerivesFrom<T, IntrusiveRefCountBase<Counter>>, "T needs to derive from IntrusiveRefCountBase with the same counter");
+			if (m_pObj)
+				static_cast<IntrusiveRefCountBase<Counter>*>(m_pObj)->m_refCount.Inc();
+		}
+
+		template <typename T, typename Counter>
+		template <typename U>
+			requires DerivesFrom<U, T>
+		IntrusiveRefCounted<T, Counter>::IntrusiveRefCounted(IntrusiveRefCounted<U, Counter>&& rc) noexcept
+			: m_pObj(rc.m_pObj)
+		{
+			rc.m_pObj = nullptr;
+		}
+
+		template <typename T, typename Counter>
+		IntrusiveRefCounted<T, Counter>::IntrusiveRefCounted(const IntrusiveRefCounted& rc) noexcept
+			: IntrusiveRefCounted(rc.m_pObj)
+		{
+		}
+
+		template <typename T, typename Counter>
+		IntrusiveRefCounted<T, Counter>::IntrusiveRefCounted(IntrusiveRefCounted&& rc) noexcept
+			: m_pObj(rc.m_pObj)
+		{
+			rc.m_pObj = nullptr;
+		}
+
+		template <typename T, typename Counter>
+		IntrusiveRefCounted<T, Counter>::~IntrusiveRefCounted() noexcept
+		{
+			DecRef();
+		}
+
+		template <typename T, typename Counter>
+		auto IntrusiveRefCounted<T, Counter>::operator=(nullptr_t) noexcept -> IntrusiveRefCounted&
+		{
+			DecRef();
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		auto IntrusiveRefCounted<T, Counter>::operator=(const IntrusiveRefCounted& rc) noexcept -> IntrusiveRefCounted&
+		{
+			if (rc.m_pObj)
+				static_cast<IntrusiveRefCountBase<Counter>*>(rc.m_pObj)->m_refCount.Inc();
+			DecRef();
+			m_pObj = rc.m_pObj;
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		auto IntrusiveRefCounted<T, Counter>::operator=(IntrusiveRefCounted&& rc) noexcept -> IntrusiveRefCounted&
+		{
+			if (this != &rc)
+			{
+				DecRef();
+				m_pObj = rc.m_pObj;
+				rc.m_pObj = nullptr;
+			}
+			return *this;
+		}
+
+		template <typename T, typename Counter>
+		void IntrusiveRefCounted<T, Counter>::Swap(IntrusiveRefCounted& other) noexcept
+		{
+			Algo::Swap(m_pObj, other.m_pObj);
+		}
+
+		template <typename T, typename Counter>
+		auto IntrusiveRefCounted<T, Counter>::Get() const noexcept -> T*
+		{
+			return m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		auto IntrusiveRefCounted<T, Counter>::UseCount() const noexcept -> u32
+		{
+			return m_pObj ? static_cast<const IntrusiveRefCountBase<Counter>*>(m_pObj)->GetRefCount() : 0;
+		}
+
+		template <typename T, typename Counter>
+		IntrusiveRefCounted<T, Counter>::operator bool() const noexcept
+		{
+			return m_pObj != nullptr;
+		}
+
+		template <typename T, typename Counter>
+		auto IntrusiveRefCounted<T, Counter>::operator->() const noexcept -> T*
+		{
+			ASSERT(m_pObj, "Calling operator->() on a null IntrusiveRefCounted");
+			return m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		auto IntrusiveRefCounted<T, Counter>::operator*() const noexcept -> T&
+		{
+			ASSERT(m_pObj, "Calling operator*() on a null IntrusiveRefCounted");
+			return *m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		template <typename U>
+		auto IntrusiveRefCounted<T, Counter>::operator==(const IntrusiveRefCounted<U, Counter>& other) const noexcept -> bool
+		{
+			return m_pObj == other.m_pObj;
+		}
+
+		template <typename T, typename Counter>
+		template <typename ... Args>
+		auto IntrusiveRefCounted<T, Counter>::Create(Args&&... args) noexcept -> IntrusiveRefCounted
+		{
+			return CreateWithAlloc(g_GlobalAlloc, Forward<Args>(args)...);
+		}
+
+		template <typename T, typename Counter>
+		template <typename ... Args>
+		auto IntrusiveRefCounted<T, Counter>::CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> IntrusiveRefCounted
+		{
+			MemRef<T> mem = alloc.Allocate<T>();
+			if (!mem.IsValid())
+				return IntrusiveRefCounted{};
+
+			T* pObj = new (mem.Ptr()) T{ Forward<Args>(args)... };
+			static_cast<IntrusiveRefCountBase<Counter>*>(pObj)->m_mem = mem.template As<u8>();
+			return IntrusiveRefCounted{ pObj };
+		}
+
+		template <typename T, typename Counter>
+		void IntrusiveRefCounted<T, Counter>::DecRef() noexcept
+		{
+			if (!m_pObj)
+				return;
+
+			IntrusiveRefCountBase<Counter>* pBase = m_pObj;
+			if (pBase->m_refCount.Dec() && pBase->m_mem.IsValid())
+			{
+				MemRef<u8> mem = Move(pBase->m_mem);
+				m_pObj->~T();
+				mem.Dealloc();
+			}
+			m_pObj = nullptr;
+		}
+	}
+}
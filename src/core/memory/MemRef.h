@@ -118,6 +118,9 @@ namespace Onca
 		usize              m_size         : (sizeof(usize) - sizeof(u8)) * 8; ///< Size of the allocation
 	};
 
+	template<typename T>
+	constexpr bool IsTriviallyRelocatable<MemRef<T>> = true;
+
 	
 	static_assert(sizeof(MemRef<u8>) == 24, "Invalid MemRef<T> size");
 
@@ -209,7 +209,7 @@ namespace Onca
 			 * \return Ref counted pointer with the constructed type
 			 */
 			template<typename ...Args>
-			static auto CreateWitAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> RefCounted;
+			static auto CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> RefCounted;
 		private:
 			template<typename U, typename C>
 			friend class Weak;
@@ -300,12 +300,12 @@ namespace Onca
 		template <typename ... Args>
 		auto RefCounted<T, ControlBlock>::Create(Args&&... args) noexcept -> RefCounted
 		{
-			return CreateWitAlloc(g_GlobalAlloc, Forward<Args>(args)...);
+			return CreateWithAlloc(g_GlobalAlloc, Forward<Args>(args)...);
 		}
 
 		template <typename T, typename ControlBlock>
 		template <typename ... Args>
-		auto RefCounted<T, ControlBlock>::CreateWitAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> RefCounted
+		auto RefCounted<T, ControlBlock>::CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> RefCounted
 		{
 			MemRef<T> memRef = alloc.Allocate<T>();
 			new (memRef.Ptr()) T{ Forward<Args>(args)... };
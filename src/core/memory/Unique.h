@@ -38,7 +38,7 @@ namespace Onca
 		template<typename U, MemRefDeleter<U> D2>
 		auto operator=(Unique<U, D2>&& unique) noexcept -> Unique<T, D>&;
 		
-		auto operator=(Unique&&) noexcept -> Unique<T, D>& = default;
+		auto operator=(Unique&& unique) noexcept -> Unique<T, D>&;
 
 		operator bool() const noexcept;
 
@@ -105,7 +105,7 @@ namespace Onca
 		 * \return Unique with the constructed type
 		 */
 		template<typename ...Args>
-		static auto CreateWitAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> Unique<T, D>;
+		static auto CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> Unique<T, D>;
 
 	private:
 		template<typename U, MemRefDeleter<U> D2>
@@ -115,6 +115,9 @@ namespace Onca
 		NO_UNIQUE_ADDRESS D m_deleter; ///< Deleter when memory is discarded
 	};
 
+	template<typename T, MemRefDeleter<T> D>
+	constexpr bool IsTriviallyRelocatable<Unique<T, D>> = TriviallyRelocatable<D>;
+
 }
 
 
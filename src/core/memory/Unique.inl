@@ -62,6 +62,18 @@ namespace Onca
 		return *this;
 	}
 
+	template <typename T, MemRefDeleter<T> D>
+	auto Unique<T, D>::operator=(Unique&& unique) noexcept -> Unique<T, D>&
+	{
+		if (this == &unique)
+			return *this;
+
+		m_deleter(Move(m_mem));
+		m_mem = Move(unique.m_mem);
+		m_deleter = Move(unique.m_deleter);
+		return *this;
+	}
+
 	template <typename T, MemRefDeleter<T> D>
 	Unique<T, D>::operator bool() const noexcept
 	{
@@ -141,7 +153,7 @@ namespace Onca
 	template <typename T, MemRefDeleter<T> D>
 	auto Unique<T, D>::operator*() noexcept -> T&
 	{
-		return m_mem.Ptr();
+		return *m_mem.Ptr();
 	}
 
 	template <typename T, MemRefDeleter<T> D>
@@ -154,12 +166,12 @@ namespace Onca
 	template <typename ... Args>
 	auto Unique<T, D>::Create(Args&&... args) noexcept -> Unique<T, D>
 	{
-		return CreateWitAlloc(g_GlobalAlloc, Forward<Args>(args)...);
+		return CreateWithAlloc(g_GlobalAlloc, Forward<Args>(args)...);
 	}
 
 	template <typename T, MemRefDeleter<T> D>
 	template <typename ... Args>
-	auto Unique<T, D>::CreateWitAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> Unique<T, D>
+	auto Unique<T, D>::CreateWithAlloc(Alloc::IAllocator& alloc, Args&&... args) noexcept -> Unique<T, D>
 	{
 		Unique<T, D> unique{ alloc.Allocate<T>() };
 		new (unique.m_mem.Ptr()) T{ Forward<Args>(args)... };
@@ -540,16 +540,16 @@ namespace Onca
 		if (path.GetExtension() != "toml")
 			g_Logger.Warning(TOML, "Parsing toml from file with other extension: {}", path.GetExtension());
 
-		Result<FileSystem::File, SystemError> fileRes = FileSystem::File::Open(path);
+		Result<FileSystem::File, SystemError> fileRes = FileSystem::File::Open(path, false, FileSystem::AccessMode::Read, FileSystem::ShareMode::Read, FileSystem::FileFlag::Sequential);
 		if (fileRes.Failed())
 		{
 			g_Logger.Error(TOML, "Failed to open toml file '{}': {}", path, fileRes.Error().info);
 			return Toml{};
 		}
 
-		FileSystem::File file = fileRes.MoveValue();
-		Result<String, SystemError> readRes = file.ReadString();
-		file.Close();
+		// The whole file is consumed sequentially, so let the reader issue large reads instead of going through File::ReadString()
+		FileSystem::BufferedFileReader reader{ fileRes.MoveValue(), { .bufferSize = u32(256_KiB) } };
+		Result<String, SystemError> readRes = reader.ReadStringToEnd();
 
 		if (readRes.Failed())
 		{
@@ -16,4 +16,15 @@ namespace Onca::Debugger
 	 */
 	CORE_API void OutputDebugString(const String& str) noexcept;
 
+	constexpr u32 MaxStackHashDepth = 62; ///< Maximum number of frames that can be hashed by CaptureStackHash
+
+	/**
+	 * Capture the call stack of the calling thread and hash its return addresses
+	 * \param[in] skip Number of frames to skip, not counting the frame of this function
+	 * \param[in] depth Number of frames to hash, clamped to MaxStackHashDepth
+	 * \return Hash of the call stack
+	 * \note The hash is only meaningful within the same process, as it is based on code addresses
+	 */
+	CORE_API auto CaptureStackHash(u32 skip, u32 depth) noexcept -> u32;
+
 }
@@ -0,0 +1,81 @@
+#include "NumaTopology.h"
+
+#include "SystemInfo.h"
+#include "VirtualMemory.h"
+
+namespace Onca
+{
+	NumaTopology::NumaTopology() noexcept
+		: m_isFake(false)
+	{
+	}
+
+	auto NumaTopology::FromSystem() noexcept -> NumaTopology
+	{
+		NumaTopology topology;
+
+		for (const SystemInfo::NUMANodeInfo& numaInfo : g_SystemInfo.GetNumaNodes())
+		{
+			Node node{ numaInfo.nodeId, {} };
+			for (usize proc = 0; proc < g_SystemInfo.GetProcessorCount(); ++proc)
+			{
+				for (const DynArray<SystemInfo::CPUSetInfo>& cpuSets : g_SystemInfo.GetCoresPerLastLevelCache(u32(proc)))
+				{
+					for (const SystemInfo::CPUSetInfo& cpuSet : cpuSets)
+					{
+						for (const Pair<usize, u64>& coreInfo : numaInfo.coreInfo)
+						{
+							if (coreInfo.first == cpuSet.group && (coreInfo.second & (u64(1) << cpuSet.core)))
+								node.cpuSetIds.Add(cpuSet.id);
+						}
+					}
+				}
+			}
+			topology.m_nodes.Add(Move(node));
+		}
+
+		if (topology.m_nodes.IsEmpty())
+			topology.m_nodes.Add(Node{ VirtualMemory::NoNumaNode, GetAllCpuSetIds() });
+		return topology;
+	}
+
+	auto NumaTopology::CreateFake(u32 numNodes) noexcept -> NumaTopology
+	{
+		ASSERT(numNodes > 0, "A topology needs at least 1 node");
+
+		NumaTopology topology;
+		topology.m_isFake = true;
+
+		const DynArray<SystemInfo::NUMANodeInfo>& sysNodes = g_SystemInfo.GetNumaNodes();
+		const DynArray<u32> cpuSetIds = GetAllCpuSetIds();
+		for (u32 i = 0; i < numNodes; ++i)
+		{
+			Node node{ sysNodes.IsEmpty() ? VirtualMemory::NoNumaNode : sysNodes[i % sysNodes.Size()].nodeId, {} };
+
+			// With more nodes than cores, nodes share a core, so every node can still run threads
+			const usize begin = cpuSetIds.Size() * i / numNodes;
+			const usize end = Math::Max(cpuSetIds.Size() * (i + 1) / numNodes, begin + 1);
+			for (usize j = begin; j < end && j < cpuSetIds.Size(); ++j)
+				node.cpuSetIds.Add(cpuSetIds[j]);
+			if (node.cpuSetIds.IsEmpty() && !cpuSetIds.IsEmpty())
+				node.cpuSetIds.Add(cpuSetIds[i % cpuSetIds.Size()]);
+
+			topology.m_nodes.Add(Move(node));
+		}
+		return topology;
+	}
+
+	auto NumaTopology::GetAllCpuSetIds() noexcept -> DynArray<u32>
+	{
+		DynArray<u32> ids;
+		for (usize proc = 0; proc < g_SystemInfo.GetProcessorCount(); ++proc)
+		{
+			for (const DynArray<SystemInfo::CPUSetInfo>& cpuSets : g_SystemInfo.GetCoresPerLastLevelCache(u32(proc)))
+			{
+				for (const SystemInfo::CPUSetInfo& cpuSet : cpuSets)
+					ids.Add(cpuSet.id);
+			}
+		}
+		return ids;
+	}
+}
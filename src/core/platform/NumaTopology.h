@@ -0,0 +1,68 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/containers/DynArray.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Layout of the NUMA nodes in the system, used to place threads and memory on the same node
+	 *
+	 * A topology can either be queried from the system, or be faked, which splits the cores of the system over an arbitrary number of nodes.
+	 * Faked topologies allow NUMA aware code to be exercised on machines with only a single node.
+	 */
+	class CORE_API NumaTopology
+	{
+	public:
+		/**
+		 * NUMA node
+		 */
+		struct Node
+		{
+			u32           memNode;   ///< NUMA node id memory is committed on, or VirtualMemory::NoNumaNode if memory is not bound to a node
+			DynArray<u32> cpuSetIds; ///< CPU set ids of the logical cores in the node
+		};
+
+		/**
+		 * Get the topology of the system
+		 * \return Topology of the system, with at least 1 node
+		 * \note If the system does not report any NUMA nodes, a single node containing all cores is returned
+		 */
+		static auto FromSystem() noexcept -> NumaTopology;
+		/**
+		 * Create a fake topology
+		 * \param[in] numNodes Number of nodes
+		 * \return Fake topology
+		 * \note The cores of the system are split into contiguous ranges, one per node, and memory is bound to the system's nodes in a round robin fashion
+		 */
+		static auto CreateFake(u32 numNodes) noexcept -> NumaTopology;
+
+		/**
+		 * Get the number of nodes
+		 * \return Number of nodes
+		 */
+		auto GetNumNodes() const noexcept -> u32 { return u32(m_nodes.Size()); }
+		/**
+		 * Get a node
+		 * \param[in] idx Index of the node
+		 * \return Node
+		 */
+		auto GetNode(u32 idx) const noexcept -> const Node& { return m_nodes[idx]; }
+		/**
+		 * Check if the topology is faked
+		 * \return Whether the topology is faked
+		 */
+		auto IsFake() const noexcept -> bool { return m_isFake; }
+
+	private:
+		NumaTopology() noexcept;
+
+		/**
+		 * Get the CPU set ids of all logical cores in the system
+		 * \return CPU set ids
+		 */
+		static auto GetAllCpuSetIds() noexcept -> DynArray<u32>;
+
+		DynArray<Node> m_nodes;  ///< Nodes
+		bool           m_isFake; ///< Whether the topology is faked
+	};
+}
@@ -34,6 +34,7 @@ namespace Onca
 		CannotCopy,      ///< Cannot copy file, reason might be unknown
 		DeletePending,   ///< File cannot be opened, because it is in the process of being deleted
 		NegativeSeek,    ///< An attempt was made to move the file pointer before the beginning of the file
+		NotFound,        ///< The requested item could not be found
 		
 		NotEnoughMemory, ///< Cannot create thread since not enough memory is available for the stack
 		CouldNotSetDesc, ///< Could not set the thread description
@@ -66,6 +67,8 @@ namespace Onca
 		"The drive is full"                                       , ///< DriveFull
 		"Could not copy the directory or file"                    , ///< CannotCopy
 		"A delete of the directory or file is pending"            , ///< DeletePending
+		"Cannot seek before the beginning of the file"            , ///< NegativeSeek
+		"The requested item could not be found"                   , ///< NotFound
 
 		"Not enough memory is available"                          , ///< NotEnoughMemory
 		"Could not set value"                                     , ///< CouldNotSetDesc
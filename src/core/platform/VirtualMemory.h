@@ -0,0 +1,45 @@
+#pragma once
+#include "core/MinInclude.h"
+
+namespace Onca::VirtualMemory
+{
+	constexpr u32 NoNumaNode = u32(-1); ///< Value to indicate memory is not bound to a NUMA node
+
+	/**
+	 * Reserve a range of virtual address space, without any physical memory backing it
+	 * \param[in] size Size of the range, needs to be a multiple of the virtual allocation granularity
+	 * \param[in] largePages Hint that the range should be backed by large pages when committed
+	 * \return Start of the range, or nullptr if the range could not be reserved
+	 * \note The large page hint is only used on platforms that support transparent large pages
+	 */
+	CORE_API auto Reserve(usize size, bool largePages) noexcept -> u8*;
+	/**
+	 * Commit memory in a reserved range, making it accessible
+	 * \param[in] ptr Start of the memory to commit, needs to be page aligned
+	 * \param[in] size Size of the memory to commit, needs to be a multiple of the page size
+	 * \return Whether the memory was committed
+	 */
+	CORE_API auto Commit(u8* ptr, usize size) noexcept -> bool;
+	/**
+	 * Commit memory in a reserved range, with its physical memory placed on a given NUMA node
+	 * \param[in] ptr Start of the memory to commit, needs to be page aligned
+	 * \param[in] size Size of the memory to commit, needs to be a multiple of the page size
+	 * \param[in] node NUMA node id, or NoNumaNode to commit the memory without binding it to a node
+	 * \return Whether the memory was committed
+	 * \note Pages are only placed on the node when they are first touched
+	 */
+	CORE_API auto CommitOnNode(u8* ptr, usize size, u32 node) noexcept -> bool;
+	/**
+	 * Decommit memory in a reserved range, returning the physical memory to the system, while keeping the address range reserved
+	 * \param[in] ptr Start of the memory to decommit, needs to be page aligned
+	 * \param[in] size Size of the memory to decommit, needs to be a multiple of the page size
+	 */
+	CORE_API void Decommit(u8* ptr, usize size) noexcept;
+	/**
+	 * Release a reserved range
+	 * \param[in] ptr Start of the range, as returned by Reserve
+	 * \param[in] size Size of the range, as passed to Reserve
+	 */
+	CORE_API void Release(u8* ptr, usize size) noexcept;
+
+}
@@ -0,0 +1,19 @@
+#include "../Debugger.h"
+#if PLATFORM_LINUX
+#include "core/hash/FNV.h"
+#include <execinfo.h>
+
+namespace Onca::Debugger
+{
+	auto CaptureStackHash(u32 skip, u32 depth) noexcept -> u32
+	{
+		void* frames[MaxStackHashDepth * 2];
+		const u32 toSkip = Math::Min(skip + 1, MaxStackHashDepth);
+		const int numFrames = ::backtrace(frames, int(Math::Min(depth, MaxStackHashDepth) + toSkip));
+		if (numFrames <= int(toSkip))
+			return 0;
+		return Hashing::FVN1A_32{}(reinterpret_cast<const u8*>(frames + toSkip), usize(numFrames - int(toSkip)) * sizeof(void*));
+	}
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include "../VirtualMemory.h"
+#if PLATFORM_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Onca::VirtualMemory
+{
+	auto Reserve(usize size, bool largePages) noexcept -> u8*
+	{
+		void* ptr = ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (ptr == MAP_FAILED)
+			return nullptr;
+
+		// MAP_HUGETLB would need pages to be set aside up front, so transparent huge pages are used instead
+		if (largePages)
+			::madvise(ptr, size, MADV_HUGEPAGE);
+		return static_cast<u8*>(ptr);
+	}
+
+	auto Commit(u8* ptr, usize size) noexcept -> bool
+	{
+		return ::mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+	}
+
+	auto CommitOnNode(u8* ptr, usize size, u32 node) noexcept -> bool
+	{
+		if (node != NoNumaNode)
+		{
+			// mbind is called directly, so libnuma is not needed, MPOL_BIND from <numaif.h>
+			constexpr int MpolBind = 2;
+			constexpr usize MaxNodes = 1024;
+			if (node >= MaxNodes)
+				return false;
+
+			u64 nodeMask[MaxNodes / 64] = {};
+			nodeMask[node / 64] = u64(1) << (node % 64);
+			// The kernel only reads 'maxnode - 1' bits of the mask
+			if (::syscall(SYS_mbind, ptr, size, MpolBind, nodeMask, (node / 64 + 1) * 64 + 1, 0) != 0)
+				return false;
+		}
+		return Commit(ptr, size);
+	}
+
+	void Decommit(u8* ptr, usize size) noexcept
+	{
+		::madvise(ptr, size, MADV_DONTNEED);
+		::mprotect(ptr, size, PROT_NONE);
+	}
+
+	void Release(u8* ptr, usize size) noexcept
+	{
+		::munmap(ptr, size);
+	}
+}
+
+#endif
@@ -14,6 +14,14 @@ namespace Onca::Debugger
 		DynArray<char16_t> utf16 = str.ToUtf16();
 		::OutputDebugStringW(reinterpret_cast<LPCWSTR>(utf16.Data()));
 	}
+
+	auto CaptureStackHash(u32 skip, u32 depth) noexcept -> u32
+	{
+		void* frames[MaxStackHashDepth];
+		ULONG hash = 0;
+		::RtlCaptureStackBackTrace(DWORD(skip + 1), DWORD(Math::Min(depth, MaxStackHashDepth)), frames, &hash);
+		return u32(hash);
+	}
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "../VirtualMemory.h"
+#if PLATFORM_WINDOWS
+#include "Win.h"
+
+namespace Onca::VirtualMemory
+{
+	auto Reserve(usize size, bool largePages) noexcept -> u8*
+	{
+		// Large pages need to be committed when they are reserved and require the 'lock pages in memory' privilege, so the hint is ignored
+		UNUSED(largePages);
+		return static_cast<u8*>(::VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS));
+	}
+
+	auto Commit(u8* ptr, usize size) noexcept -> bool
+	{
+		return ::VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+	}
+
+	auto CommitOnNode(u8* ptr, usize size, u32 node) noexcept -> bool
+	{
+		if (node == NoNumaNode)
+			return Commit(ptr, size);
+		return ::VirtualAllocExNuma(::GetCurrentProcess(), ptr, size, MEM_COMMIT, PAGE_READWRITE, node) != nullptr;
+	}
+
+	void Decommit(u8* ptr, usize size) noexcept
+	{
+		::VirtualFree(ptr, size, MEM_DECOMMIT);
+	}
+
+	void Release(u8* ptr, usize size) noexcept
+	{
+		UNUSED(size);
+		::VirtualFree(ptr, 0, MEM_RELEASE);
+	}
+}
+
+#endif
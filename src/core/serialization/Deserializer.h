@@ -0,0 +1,145 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/containers/ByteSpan.h"
+#include "core/containers/DynArray.h"
+#include "core/string/String.h"
+#include "Schema.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Binary deserializer
+	 *
+	 * Reads values written by a Serializer from a span of bytes, without copying the span.
+	 * Reading past the end of the span, or reading malformed data, marks the deserializer as failed, after which all reads return default values.
+	 *
+	 * \note The span needs to outlive the deserializer and any span returned by ReadBytes()
+	 */
+	class Deserializer
+	{
+	public:
+		/**
+		 * Create a deserializer reading from a span
+		 * \param[in] span Span to read from
+		 * \param[in] order Byte order the values were written in
+		 */
+		explicit Deserializer(ByteSpan span, ByteOrder order = ByteOrder::Little) noexcept;
+
+		/**
+		 * Read an arithmetic or enum value
+		 * \tparam T Type of the value
+		 * \return Value, a default value if the read failed
+		 */
+		template<typename T>
+			requires Integral<T> || FloatingPoint<T> || EnumType<T>
+		auto Read() noexcept -> T;
+		/**
+		 * Read an unsigned variable length integer
+		 * \return Value, 0 if the read failed
+		 */
+		auto ReadVarUInt() noexcept -> u64;
+		/**
+		 * Read a signed variable length integer, zigzag encoded
+		 * \return Value, 0 if the read failed
+		 */
+		auto ReadVarInt() noexcept -> i64;
+		/**
+		 * Read raw bytes
+		 * \param[in] count Number of bytes
+		 * \return Span of the bytes inside the source span, empty if the read failed
+		 */
+		auto ReadBytes(usize count) noexcept -> ByteSpan;
+		/**
+		 * Read an array of arithmetic or enum values, without a count
+		 * \tparam T Type of the values
+		 * \param[out] pData Pointer to the values
+		 * \param[in] count Number of values
+		 * \return Whether the values could be read
+		 * \note When the byte order matches the native byte order, the values are copied in a single MemCpy
+		 */
+		template<typename T>
+			requires Integral<T> || FloatingPoint<T> || EnumType<T>
+		auto ReadArray(T* pData, usize count) noexcept -> bool;
+		/**
+		 * Read a string
+		 * \param[in] alloc Allocator the string should use
+		 * \return String, empty if the read failed
+		 */
+		auto ReadString(Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept -> String;
+
+		/**
+		 * Deserialize a value
+		 * \tparam T Type of the value, an arithmetic type, enum, fixed size array or struct with a SerializeSchema
+		 * \param[out] val Value
+		 * \return Whether the value could be deserialized
+		 */
+		template<typename T>
+			requires (Detail::FixedSerializedSize<T>() != 0) || HasSerializeSchema<T>
+		auto Deserialize(T& val) noexcept -> bool;
+		/**
+		 * Deserialize a string, keeping the string's allocator
+		 * \param[out] str String
+		 * \return Whether the string could be deserialized, strings that are not valid utf8 fail the deserializer
+		 */
+		auto Deserialize(String& str) noexcept -> bool;
+		/**
+		 * Deserialize a DynArray, keeping the DynArray's allocator
+		 * \tparam T Type of the elements, needs to be default constructible when not an arithmetic or enum type
+		 * \param[out] arr DynArray
+		 * \return Whether the DynArray could be deserialized
+		 */
+		template<typename T>
+		auto Deserialize(DynArray<T>& arr) noexcept -> bool;
+
+		/**
+		 * Get a number of bytes and advance past them
+		 * \param[in] numBytes Number of bytes
+		 * \return Pointer to the bytes, nullptr if not enough bytes are left
+		 */
+		auto Consume(usize numBytes) noexcept -> const u8*;
+
+		/**
+		 * Check if a read failed
+		 * \return Whether a read failed
+		 */
+		auto HasFailed() const noexcept -> bool;
+		/**
+		 * Check if all bytes have been read
+		 * \return Whether all bytes have been read
+		 */
+		auto IsAtEnd() const noexcept -> bool;
+		/**
+		 * Get the number of bytes that are left to be read
+		 * \return Number of bytes left
+		 */
+		auto Remaining() const noexcept -> usize;
+		/**
+		 * Get the byte order values are read in
+		 * \return Byte order
+		 */
+		auto GetByteOrder() const noexcept -> ByteOrder;
+
+	private:
+		/**
+		 * Mark the deserializer as failed
+		 */
+		void Fail() noexcept;
+
+		/**
+		 * Read a field of a struct with a schema
+		 * \tparam T Struct type
+		 * \tparam F Field type
+		 * \param[out] val Struct
+		 * \param[in] field Field
+		 */
+		template<typename T, typename F>
+		void ReadField(T& val, const F& field) noexcept;
+
+		const u8* m_pCur;   ///< Pointer to the next byte to read
+		const u8* m_pEnd;   ///< Pointer to the end of the span
+		ByteOrder m_order;  ///< Byte order to read values in
+		bool      m_failed; ///< Whether a read failed
+	};
+}
+
+#include "Deserializer.inl"
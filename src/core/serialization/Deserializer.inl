@@ -0,0 +1,251 @@
+#pragma once
+#if __RESHARPER__
+#include "Deserializer.h"
+#endif
+
+namespace Onca
+{
+	inline Deserializer::Deserializer(ByteSpan span, ByteOrder order) noexcept
+		: m_pCur(span.begin())
+		, m_pEnd(span.end())
+		, m_order(order)
+		, m_failed(false)
+	{
+	}
+
+	template <typename T>
+		requires Integral<T> || FloatingPoint<T> || EnumType<T>
+	auto Deserializer::Read() noexcept -> T
+	{
+		const u8* pSrc = Consume(sizeof(T));
+		if (!pSrc) UNLIKELY
+			return T{};
+
+		T val;
+		MemCpy(&val, pSrc, sizeof(T));
+		return ConvertByteOrder(val, m_order);
+	}
+
+	inline auto Deserializer::ReadVarUInt() noexcept -> u64
+	{
+		// A 64-bit value takes at most 10 bytes, so when enough bytes are left, no bounds check is needed per byte
+		if (Remaining() >= 10) LIKELY
+		{
+			const u8* pSrc = m_pCur;
+			u64 val = 0;
+			for (u8 shift = 0; shift < 64; shift += 7)
+			{
+				const u8 byte = *pSrc++;
+				val |= u64(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+				{
+					m_pCur = pSrc;
+					return val;
+				}
+			}
+			Fail();
+			return 0;
+		}
+
+		u64 val = 0;
+		for (u8 shift = 0; shift < 64; shift += 7)
+		{
+			if (m_pCur == m_pEnd)
+				break;
+
+			const u8 byte = *m_pCur++;
+			val |= u64(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return val;
+		}
+		Fail();
+		return 0;
+	}
+
+	inline auto Deserializer::ReadVarInt() noexcept -> i64
+	{
+		const u64 val = ReadVarUInt();
+		return i64(val >> 1) ^ -i64(val & 1);
+	}
+
+	inline auto Deserializer::ReadBytes(usize count) noexcept -> ByteSpan
+	{
+		const u8* pSrc = Consume(count);
+		if (!pSrc) UNLIKELY
+			return {};
+		return { pSrc, count };
+	}
+
+	template <typename T>
+		requires Integral<T> || FloatingPoint<T> || EnumType<T>
+	auto Deserializer::ReadArray(T* pData, usize count) noexcept -> bool
+	{
+		if (count > Remaining() / sizeof(T)) UNLIKELY
+		{
+			Fail();
+			return false;
+		}
+		if (count == 0)
+			return true;
+
+		const u8* pSrc = Consume(count * sizeof(T));
+		if (sizeof(T) == 1 || m_order == ByteOrder::Native)
+		{
+			MemCpy(pData, pSrc, count * sizeof(T));
+		}
+		else
+		{
+			constexpr ByteOrder swappedOrder = ByteOrder::Native == ByteOrder::Little ? ByteOrder::Big : ByteOrder::Little;
+			for (usize i = 0; i < count; ++i)
+				pSrc = Detail::LoadFixedAs<swappedOrder>(pSrc, pData[i]);
+		}
+		return true;
+	}
+
+	inline auto Deserializer::ReadString(Alloc::IAllocator& alloc) noexcept -> String
+	{
+		String str{ alloc };
+		Deserialize(str);
+		return str;
+	}
+
+	template <typename T>
+		requires (Detail::FixedSerializedSize<T>() != 0) || HasSerializeSchema<T>
+	auto Deserializer::Deserialize(T& val) noexcept -> bool
+	{
+		constexpr usize fixedSize = Detail::FixedSerializedSize<T>();
+		if constexpr (fixedSize != 0)
+		{
+			const u8* pSrc = Consume(fixedSize);
+			if (!pSrc) UNLIKELY
+				return false;
+			Detail::LoadFixed(pSrc, val, m_order);
+		}
+		else
+		{
+			std::apply([this, &val](const auto&... fields) { (ReadField(val, fields), ...); }, SerializeSchema<T>::Fields);
+		}
+		return !m_failed;
+	}
+
+	inline auto Deserializer::Deserialize(String& str) noexcept -> bool
+	{
+		const u64 size = ReadVarUInt();
+		if (size > Remaining()) UNLIKELY
+		{
+			Fail();
+			return false;
+		}
+
+		const ByteSpan bytes = ReadBytes(usize(size));
+		if (!Unicode::IsValidUtf8(bytes.Data(), bytes.Size())) UNLIKELY
+		{
+			Fail();
+			return false;
+		}
+
+		str.AssignRaw(bytes);
+		return !m_failed;
+	}
+
+	template <typename T>
+	auto Deserializer::Deserialize(DynArray<T>& arr) noexcept -> bool
+	{
+		// Every element takes at least 1 byte, so a count larger than the remaining bytes is malformed and would otherwise cause a huge allocation
+		const u64 count = ReadVarUInt();
+		if (count > Remaining()) UNLIKELY
+		{
+			Fail();
+			return false;
+		}
+
+		arr.Clear();
+		if constexpr (Integral<T> || FloatingPoint<T> || EnumType<T>)
+		{
+			if (count > Remaining() / sizeof(T)) UNLIKELY
+			{
+				Fail();
+				return false;
+			}
+			arr.Resize(usize(count));
+			return ReadArray(arr.Data(), usize(count));
+		}
+		else if constexpr (Detail::FixedSerializedSize<T>() != 0)
+		{
+			if (count > Remaining() / Detail::FixedSerializedSize<T>()) UNLIKELY
+			{
+				Fail();
+				return false;
+			}
+
+			const u8* pSrc = Consume(usize(count) * Detail::FixedSerializedSize<T>());
+			arr.Resize(usize(count));
+			for (T& elem : arr)
+				pSrc = Detail::LoadFixed(pSrc, elem, m_order);
+			return true;
+		}
+		else
+		{
+			arr.Reserve(usize(count));
+			for (u64 i = 0; i < count && !m_failed; ++i)
+			{
+				arr.EmplaceBack();
+				Deserialize(arr.Back());
+			}
+			return !m_failed;
+		}
+	}
+
+	inline auto Deserializer::Consume(usize numBytes) noexcept -> const u8*
+	{
+		if (Remaining() < numBytes) UNLIKELY
+		{
+			Fail();
+			return nullptr;
+		}
+
+		const u8* pSrc = m_pCur;
+		m_pCur += numBytes;
+		return pSrc;
+	}
+
+	inline auto Deserializer::HasFailed() const noexcept -> bool
+	{
+		return m_failed;
+	}
+
+	inline auto Deserializer::IsAtEnd() const noexcept -> bool
+	{
+		return m_pCur == m_pEnd;
+	}
+
+	inline auto Deserializer::Remaining() const noexcept -> usize
+	{
+		return usize(m_pEnd - m_pCur);
+	}
+
+	inline auto Deserializer::GetByteOrder() const noexcept -> ByteOrder
+	{
+		return m_order;
+	}
+
+	inline void Deserializer::Fail() noexcept
+	{
+		// Make sure all later reads fail, so no partially valid data is returned
+		m_failed = true;
+		m_pCur = m_pEnd;
+	}
+
+	template <typename T, typename F>
+	void Deserializer::ReadField(T& val, const F& field) noexcept
+	{
+		using Traits = Detail::SchemaFieldTraits<F>;
+		auto& member = Detail::GetSchemaMember(val, field);
+		if constexpr (!Traits::IsVarInt)
+			Deserialize(member);
+		else if constexpr (SignedIntegral<typename Traits::Type>)
+			member = typename Traits::Type(ReadVarInt());
+		else
+			member = typename Traits::Type(ReadVarUInt());
+	}
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/utils/Tuple.h"
+#include "core/utils/Endianess.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Compile-time description of how a struct is serialized
+	 *
+	 * Specialize this for a struct to make it serializable with a Serializer and Deserializer.
+	 * The specialization needs a static constexpr Fields member containing the fields to serialize, in order, created with SchemaFields(), e.g.:
+	 * \code
+	 * template<>
+	 * struct SerializeSchema<Foo>
+	 * {
+	 *     static constexpr auto Fields = SchemaFields(&Foo::id, AsVarInt(&Foo::count), &Foo::name);
+	 * };
+	 * \endcode
+	 * Fields can be arithmetic types, enums, fixed size arrays of those, Strings, DynArrays of serializable types or structs with a schema.
+	 * When all fields of a struct have a fixed size, the struct is written and read with a single bounds check.
+	 *
+	 * \tparam T Struct type
+	 */
+	template<typename T>
+	struct SerializeSchema;
+
+	/**
+	 * Check if a type has a serialization schema
+	 */
+	template<typename T>
+	concept HasSerializeSchema = requires { SerializeSchema<T>::Fields; };
+
+	/**
+	 * Field that is serialized as a variable length integer
+	 * \tparam C Struct type
+	 * \tparam M Member type
+	 */
+	template<typename C, Integral M>
+	struct VarIntField
+	{
+		M C::* pMember; ///< Pointer to the member
+	};
+
+	/**
+	 * Mark a field to be serialized as a variable length integer, signed integers are zigzag encoded
+	 * \tparam C Struct type
+	 * \tparam M Member type
+	 * \param[in] pMember Pointer to the member
+	 * \return Field
+	 */
+	template<typename C, Integral M>
+	constexpr auto AsVarInt(M C::* pMember) noexcept -> VarIntField<C, M>;
+
+	/**
+	 * Create the fields of a schema
+	 * \tparam Fields Field types
+	 * \param[in] fields Pointers to members or wrapped fields, like VarIntField
+	 * \return Tuple with the fields
+	 */
+	template<typename... Fields>
+	constexpr auto SchemaFields(Fields... fields) noexcept -> Tuple<Fields...>;
+
+	namespace Detail
+	{
+		/**
+		 * Information about a field in a schema
+		 * \tparam F Field type
+		 */
+		template<typename F>
+		struct SchemaFieldTraits;
+
+		template<typename C, typename M>
+		struct SchemaFieldTraits<M C::*>
+		{
+			using Type = M;
+			static constexpr bool IsVarInt = false;
+		};
+
+		template<typename C, typename M>
+		struct SchemaFieldTraits<VarIntField<C, M>>
+		{
+			using Type = M;
+			static constexpr bool IsVarInt = true;
+		};
+
+		/**
+		 * Get the size of a type when serialized, if it always has the same size
+		 * \tparam T Type
+		 * \return Serialized size, 0 if the size is not fixed
+		 */
+		template<typename T>
+		consteval auto FixedSerializedSize() noexcept -> usize;
+
+		/**
+		 * Get the member a field refers to
+		 * \tparam T Struct type
+		 * \tparam F Field type
+		 * \param[in] val Struct
+		 * \param[in] field Field
+		 * \return Reference to the member
+		 */
+		template<typename T, typename F>
+		constexpr auto GetSchemaMember(T& val, const F& field) noexcept -> auto&;
+
+		/**
+		 * Store a value with a fixed serialized size in a byte order known at compile time
+		 * \tparam Order Byte order
+		 * \tparam T Type
+		 * \param[in] pDst Destination
+		 * \param[in] val Value
+		 * \return Pointer past the value
+		 */
+		template<ByteOrder Order, typename T>
+		auto StoreFixedAs(u8* pDst, const T& val) noexcept -> u8*;
+		/**
+		 * Load a value with a fixed serialized size in a byte order known at compile time
+		 * \tparam Order Byte order
+		 * \tparam T Type
+		 * \param[in] pSrc Source
+		 * \param[out] val Value
+		 * \return Pointer past the value
+		 */
+		template<ByteOrder Order, typename T>
+		auto LoadFixedAs(const u8* pSrc, T& val) noexcept -> const u8*;
+
+		/**
+		 * Store a value with a fixed serialized size
+		 * \tparam T Type
+		 * \param[in] pDst Destination
+		 * \param[in] val Value
+		 * \param[in] order Byte order
+		 * \return Pointer past the value
+		 * \note The byte order is only checked once, not for every field
+		 */
+		template<typename T>
+		auto StoreFixed(u8* pDst, const T& val, ByteOrder order) noexcept -> u8*;
+		/**
+		 * Load a value with a fixed serialized size
+		 * \tparam T Type
+		 * \param[in] pSrc Source
+		 * \param[out] val Value
+		 * \param[in] order Byte order
+		 * \return Pointer past the value
+		 * \note The byte order is only checked once, not for every field
+		 */
+		template<typename T>
+		auto LoadFixed(const u8* pSrc, T& val, ByteOrder order) noexcept -> const u8*;
+	}
+}
+
+#include "Schema.inl"
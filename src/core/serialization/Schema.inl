@@ -0,0 +1,132 @@
+#pragma once
+#if __RESHARPER__
+#include "Schema.h"
+#endif
+
+namespace Onca
+{
+	template<typename C, Integral M>
+	constexpr auto AsVarInt(M C::* pMember) noexcept -> VarIntField<C, M>
+	{
+		return VarIntField<C, M>{ pMember };
+	}
+
+	template<typename... Fields>
+	constexpr auto SchemaFields(Fields... fields) noexcept -> Tuple<Fields...>
+	{
+		return Tuple<Fields...>{ fields... };
+	}
+
+	namespace Detail
+	{
+		template<typename F>
+		consteval auto FixedFieldSize() noexcept -> usize
+		{
+			using Traits = SchemaFieldTraits<F>;
+			if constexpr (Traits::IsVarInt)
+				return 0;
+			else
+				return FixedSerializedSize<typename Traits::Type>();
+		}
+
+		template<typename T, usize... Ids>
+		consteval auto FixedSchemaSize(std::index_sequence<Ids...>) noexcept -> usize
+		{
+			using Fields = Decay<decltype(SerializeSchema<T>::Fields)>;
+			if constexpr (((FixedFieldSize<std::tuple_element_t<Ids, Fields>>() != 0) && ...))
+				return (FixedFieldSize<std::tuple_element_t<Ids, Fields>>() + ... + 0);
+			else
+				return 0;
+		}
+
+		template<typename T>
+		consteval auto FixedSerializedSize() noexcept -> usize
+		{
+			if constexpr (FloatingPoint<T> || Integral<T> || EnumType<T>)
+			{
+				return sizeof(T);
+			}
+			else if constexpr (std::is_bounded_array_v<T>)
+			{
+				return std::extent_v<T> * FixedSerializedSize<std::remove_extent_t<T>>();
+			}
+			else if constexpr (HasSerializeSchema<T>)
+			{
+				using Fields = Decay<decltype(SerializeSchema<T>::Fields)>;
+				return FixedSchemaSize<T>(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
+		template<typename T, typename F>
+		constexpr auto GetSchemaMember(T& val, const F& field) noexcept -> auto&
+		{
+			if constexpr (SchemaFieldTraits<F>::IsVarInt)
+				return val.*field.pMember;
+			else
+				return val.*field;
+		}
+
+		template<ByteOrder Order, typename T>
+		auto StoreFixedAs(u8* pDst, const T& val) noexcept -> u8*
+		{
+			if constexpr (HasSerializeSchema<T>)
+			{
+				std::apply([&](const auto&... fields) { ((pDst = StoreFixedAs<Order>(pDst, GetSchemaMember(val, fields))), ...); }, SerializeSchema<T>::Fields);
+			}
+			else if constexpr (std::is_bounded_array_v<T>)
+			{
+				for (const auto& elem : val)
+					pDst = StoreFixedAs<Order>(pDst, elem);
+			}
+			else
+			{
+				const T converted = ConvertByteOrder(val, Order);
+				MemCpy(pDst, &converted, sizeof(T));
+				pDst += sizeof(T);
+			}
+			return pDst;
+		}
+
+		template<ByteOrder Order, typename T>
+		auto LoadFixedAs(const u8* pSrc, T& val) noexcept -> const u8*
+		{
+			if constexpr (HasSerializeSchema<T>)
+			{
+				std::apply([&](const auto&... fields) { ((pSrc = LoadFixedAs<Order>(pSrc, GetSchemaMember(val, fields))), ...); }, SerializeSchema<T>::Fields);
+			}
+			else if constexpr (std::is_bounded_array_v<T>)
+			{
+				for (auto& elem : val)
+					pSrc = LoadFixedAs<Order>(pSrc, elem);
+			}
+			else
+			{
+				T loaded;
+				MemCpy(&loaded, pSrc, sizeof(T));
+				val = ConvertByteOrder(loaded, Order);
+				pSrc += sizeof(T);
+			}
+			return pSrc;
+		}
+
+		template<typename T>
+		auto StoreFixed(u8* pDst, const T& val, ByteOrder order) noexcept -> u8*
+		{
+			if (order == ByteOrder::Little)
+				return StoreFixedAs<ByteOrder::Little>(pDst, val);
+			return StoreFixedAs<ByteOrder::Big>(pDst, val);
+		}
+
+		template<typename T>
+		auto LoadFixed(const u8* pSrc, T& val, ByteOrder order) noexcept -> const u8*
+		{
+			if (order == ByteOrder::Little)
+				return LoadFixedAs<ByteOrder::Little>(pSrc, val);
+			return LoadFixedAs<ByteOrder::Big>(pSrc, val);
+		}
+	}
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "Schema.h"
+#include "Serializer.h"
+#include "Deserializer.h"
\ No newline at end of file
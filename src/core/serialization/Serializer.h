@@ -0,0 +1,164 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "core/containers/ByteBuffer.h"
+#include "core/containers/ByteSpan.h"
+#include "core/containers/DynArray.h"
+#include "core/string/String.h"
+#include "Schema.h"
+
+namespace Onca
+{
+	/**
+	 * \brief Binary serializer
+	 *
+	 * Writes values in a compact binary format, either appending to a growable DynArray or ByteBuffer, or into a fixed MutableByteSpan.
+	 * When writing into a fixed span, a write that does not fit marks the serializer as failed, and all later writes are ignored.
+	 *
+	 * Multi-byte values are stored in the byte order the serializer was created with, variable length integers use LEB128, with signed integers zigzag encoded.
+	 * Strings and DynArrays are stored as a variable length count, followed by their elements.
+	 *
+	 * \note When writing into a growable container, the container may have a larger size than the written data until Finish() is called or the serializer is destroyed
+	 */
+	class Serializer
+	{
+	public:
+		/**
+		 * Create a serializer appending to a DynArray
+		 * \param[in] buffer DynArray to append to
+		 * \param[in] order Byte order to write values in
+		 */
+		explicit Serializer(DynArray<u8>& buffer, ByteOrder order = ByteOrder::Little) noexcept;
+		/**
+		 * Create a serializer appending to a ByteBuffer
+		 * \param[in] buffer ByteBuffer to append to
+		 * \param[in] order Byte order to write values in
+		 */
+		explicit Serializer(ByteBuffer& buffer, ByteOrder order = ByteOrder::Little) noexcept;
+		/**
+		 * Create a serializer writing into a fixed span of memory
+		 * \param[in] span Span to write into
+		 * \param[in] order Byte order to write values in
+		 */
+		explicit Serializer(MutableByteSpan span, ByteOrder order = ByteOrder::Little) noexcept;
+		~Serializer() noexcept;
+
+		DISABLE_COPY(Serializer);
+		DISABLE_MOVE(Serializer);
+
+		/**
+		 * Write an arithmetic or enum value
+		 * \tparam T Type of the value
+		 * \param[in] val Value
+		 */
+		template<typename T>
+			requires Integral<T> || FloatingPoint<T> || EnumType<T>
+		void Write(T val) noexcept;
+		/**
+		 * Write an unsigned variable length integer
+		 * \param[in] val Value
+		 */
+		void WriteVarUInt(u64 val) noexcept;
+		/**
+		 * Write a signed variable length integer, zigzag encoded
+		 * \param[in] val Value
+		 */
+		void WriteVarInt(i64 val) noexcept;
+		/**
+		 * Write raw bytes, without a count
+		 * \param[in] bytes Bytes
+		 */
+		void WriteBytes(ByteSpan bytes) noexcept;
+		/**
+		 * Write an array of arithmetic or enum values, without a count
+		 * \tparam T Type of the values
+		 * \param[in] pData Pointer to the values
+		 * \param[in] count Number of values
+		 * \note When the byte order matches the native byte order, the values are copied in a single MemCpy
+		 */
+		template<typename T>
+			requires Integral<T> || FloatingPoint<T> || EnumType<T>
+		void WriteArray(const T* pData, usize count) noexcept;
+		/**
+		 * Write a string, as a variable length byte count followed by the utf8 data
+		 * \param[in] str String
+		 */
+		void WriteString(const String& str) noexcept;
+
+		/**
+		 * Serialize a value
+		 * \tparam T Type of the value, an arithmetic type, enum, fixed size array or struct with a SerializeSchema
+		 * \param[in] val Value
+		 */
+		template<typename T>
+			requires (Detail::FixedSerializedSize<T>() != 0) || HasSerializeSchema<T>
+		void Serialize(const T& val) noexcept;
+		/**
+		 * Serialize a string
+		 * \param[in] str String
+		 */
+		void Serialize(const String& str) noexcept;
+		/**
+		 * Serialize a DynArray, as a variable length count followed by the serialized elements
+		 * \tparam T Type of the elements
+		 * \param[in] arr DynArray
+		 */
+		template<typename T>
+		void Serialize(const DynArray<T>& arr) noexcept;
+
+		/**
+		 * Get space for a number of bytes and advance past it
+		 * \param[in] numBytes Number of bytes
+		 * \return Pointer to the bytes, nullptr if the bytes don't fit in a fixed span
+		 */
+		auto Reserve(usize numBytes) noexcept -> u8*;
+
+		/**
+		 * Finish writing, shrinks a growable container to the written data
+		 */
+		void Finish() noexcept;
+
+		/**
+		 * Check if a write did not fit in a fixed span
+		 * \return Whether a write failed
+		 */
+		auto HasFailed() const noexcept -> bool;
+		/**
+		 * Get the number of bytes written
+		 * \return Number of bytes written
+		 */
+		auto NumWritten() const noexcept -> usize;
+		/**
+		 * Get the byte order values are written in
+		 * \return Byte order
+		 */
+		auto GetByteOrder() const noexcept -> ByteOrder;
+
+	private:
+		/**
+		 * Grow the container to fit at least a number of additional bytes
+		 * \param[in] numBytes Number of bytes
+		 * \return Whether the container could grow
+		 */
+		auto Grow(usize numBytes) noexcept -> bool;
+
+		/**
+		 * Write a field of a struct with a schema
+		 * \tparam T Struct type
+		 * \tparam F Field type
+		 * \param[in] val Struct
+		 * \param[in] field Field
+		 */
+		template<typename T, typename F>
+		void WriteField(const T& val, const F& field) noexcept;
+
+		DynArray<u8>* m_pBuffer; ///< Growable container, nullptr when writing into a fixed span
+		usize         m_start;   ///< Offset in the container of the first written byte
+		u8*           m_pBegin;  ///< Pointer to the first written byte
+		u8*           m_pCur;    ///< Pointer to the next byte to write
+		u8*           m_pEnd;    ///< Pointer to the end of the available memory
+		ByteOrder     m_order;   ///< Byte order to write values in
+		bool          m_failed;  ///< Whether a write failed
+	};
+}
+
+#include "Serializer.inl"
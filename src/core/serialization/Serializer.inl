@@ -0,0 +1,227 @@
+#pragma once
+#if __RESHARPER__
+#include "Serializer.h"
+#endif
+
+namespace Onca
+{
+	inline Serializer::Serializer(DynArray<u8>& buffer, ByteOrder order) noexcept
+		: m_pBuffer(&buffer)
+		, m_start(buffer.Size())
+		, m_pBegin(buffer.Data() + buffer.Size())
+		, m_pCur(m_pBegin)
+		, m_pEnd(m_pBegin)
+		, m_order(order)
+		, m_failed(false)
+	{
+	}
+
+	inline Serializer::Serializer(ByteBuffer& buffer, ByteOrder order) noexcept
+		: Serializer(buffer.GetContainer(), order)
+	{
+	}
+
+	inline Serializer::Serializer(MutableByteSpan span, ByteOrder order) noexcept
+		: m_pBuffer(nullptr)
+		, m_start(0)
+		, m_pBegin(span.Data())
+		, m_pCur(span.Data())
+		, m_pEnd(span.end())
+		, m_order(order)
+		, m_failed(false)
+	{
+	}
+
+	inline Serializer::~Serializer() noexcept
+	{
+		Finish();
+	}
+
+	template <typename T>
+		requires Integral<T> || FloatingPoint<T> || EnumType<T>
+	void Serializer::Write(T val) noexcept
+	{
+		u8* pDst = Reserve(sizeof(T));
+		if (!pDst) UNLIKELY
+			return;
+
+		const T converted = ConvertByteOrder(val, m_order);
+		MemCpy(pDst, &converted, sizeof(T));
+	}
+
+	inline void Serializer::WriteVarUInt(u64 val) noexcept
+	{
+		const usize size = val ? Intrin::BitScanMSB(val) / 7 + 1 : 1;
+		u8* pDst = Reserve(size);
+		if (!pDst) UNLIKELY
+			return;
+
+		for (usize i = 1; i < size; ++i)
+		{
+			*pDst++ = u8(val | 0x80);
+			val >>= 7;
+		}
+		*pDst = u8(val);
+	}
+
+	inline void Serializer::WriteVarInt(i64 val) noexcept
+	{
+		WriteVarUInt((u64(val) << 1) ^ u64(val >> 63));
+	}
+
+	inline void Serializer::WriteBytes(ByteSpan bytes) noexcept
+	{
+		u8* pDst = Reserve(bytes.Size());
+		if (pDst && !bytes.IsEmpty()) LIKELY
+			MemCpy(pDst, bytes.Data(), bytes.Size());
+	}
+
+	template <typename T>
+		requires Integral<T> || FloatingPoint<T> || EnumType<T>
+	void Serializer::WriteArray(const T* pData, usize count) noexcept
+	{
+		if (count == 0)
+			return;
+
+		u8* pDst = Reserve(count * sizeof(T));
+		if (!pDst) UNLIKELY
+			return;
+
+		if (sizeof(T) == 1 || m_order == ByteOrder::Native)
+		{
+			MemCpy(pDst, pData, count * sizeof(T));
+		}
+		else
+		{
+			constexpr ByteOrder swappedOrder = ByteOrder::Native == ByteOrder::Little ? ByteOrder::Big : ByteOrder::Little;
+			for (usize i = 0; i < count; ++i)
+				pDst = Detail::StoreFixedAs<swappedOrder>(pDst, pData[i]);
+		}
+	}
+
+	inline void Serializer::WriteString(const String& str) noexcept
+	{
+		WriteVarUInt(str.DataSize());
+		WriteBytes(ByteSpan{ str.Data(), str.DataSize() });
+	}
+
+	template <typename T>
+		requires (Detail::FixedSerializedSize<T>() != 0) || HasSerializeSchema<T>
+	void Serializer::Serialize(const T& val) noexcept
+	{
+		// Values with a fixed size, including structs with only fixed size fields, only need a single bounds check
+		constexpr usize fixedSize = Detail::FixedSerializedSize<T>();
+		if constexpr (fixedSize != 0)
+		{
+			u8* pDst = Reserve(fixedSize);
+			if (pDst) LIKELY
+				Detail::StoreFixed(pDst, val, m_order);
+		}
+		else
+		{
+			std::apply([this, &val](const auto&... fields) { (WriteField(val, fields), ...); }, SerializeSchema<T>::Fields);
+		}
+	}
+
+	inline void Serializer::Serialize(const String& str) noexcept
+	{
+		WriteString(str);
+	}
+
+	template <typename T>
+	void Serializer::Serialize(const DynArray<T>& arr) noexcept
+	{
+		WriteVarUInt(arr.Size());
+		if constexpr (Integral<T> || FloatingPoint<T> || EnumType<T>)
+		{
+			WriteArray(arr.Data(), arr.Size());
+		}
+		else if constexpr (Detail::FixedSerializedSize<T>() != 0)
+		{
+			u8* pDst = Reserve(arr.Size() * Detail::FixedSerializedSize<T>());
+			if (!pDst) UNLIKELY
+				return;
+
+			for (const T& elem : arr)
+				pDst = Detail::StoreFixed(pDst, elem, m_order);
+		}
+		else
+		{
+			for (const T& elem : arr)
+				Serialize(elem);
+		}
+	}
+
+	inline auto Serializer::Reserve(usize numBytes) noexcept -> u8*
+	{
+		if (usize(m_pEnd - m_pCur) < numBytes) UNLIKELY
+		{
+			if (!Grow(numBytes))
+				return nullptr;
+		}
+
+		u8* pDst = m_pCur;
+		m_pCur += numBytes;
+		return pDst;
+	}
+
+	inline void Serializer::Finish() noexcept
+	{
+		if (!m_pBuffer)
+			return;
+
+		const usize written = NumWritten();
+		m_pBuffer->Resize(m_start + written);
+		m_pBegin = m_pBuffer->Data() + m_start;
+		m_pCur = m_pBegin + written;
+		m_pEnd = m_pCur;
+	}
+
+	inline auto Serializer::HasFailed() const noexcept -> bool
+	{
+		return m_failed;
+	}
+
+	inline auto Serializer::NumWritten() const noexcept -> usize
+	{
+		return usize(m_pCur - m_pBegin);
+	}
+
+	inline auto Serializer::GetByteOrder() const noexcept -> ByteOrder
+	{
+		return m_order;
+	}
+
+	inline auto Serializer::Grow(usize numBytes) noexcept -> bool
+	{
+		if (!m_pBuffer)
+		{
+			// Make sure no later write fits, so the written data stays consistent
+			m_failed = true;
+			m_pEnd = m_pCur;
+			return false;
+		}
+
+		const usize written = NumWritten();
+		const usize newSize = Math::Max(m_start + written + numBytes, m_pBuffer->Size() * 2, usize(64));
+		m_pBuffer->Resize(newSize);
+
+		m_pBegin = m_pBuffer->Data() + m_start;
+		m_pCur = m_pBegin + written;
+		m_pEnd = m_pBuffer->Data() + m_pBuffer->Size();
+		return true;
+	}
+
+	template <typename T, typename F>
+	void Serializer::WriteField(const T& val, const F& field) noexcept
+	{
+		using Traits = Detail::SchemaFieldTraits<F>;
+		const auto& member = Detail::GetSchemaMember(val, field);
+		if constexpr (!Traits::IsVarInt)
+			Serialize(member);
+		else if constexpr (SignedIntegral<typename Traits::Type>)
+			WriteVarInt(i64(member));
+		else
+			WriteVarUInt(u64(member));
+	}
+}
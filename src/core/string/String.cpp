@@ -1,6 +1,7 @@
 #include "String.h"
 
 #include "core/containers/ByteBuffer.h"
+#include "core/containers/ByteSpan.h"
 
 namespace Onca
 {
@@ -192,6 +193,13 @@ namespace Onca
 		AssignRaw(bytes);
 	}
 
+	String::String(ByteSpan bytes, Alloc::IAllocator& alloc) noexcept
+		: m_data(alloc)
+		, m_length(0)
+	{
+		AssignRaw(bytes);
+	}
+
 	String::String(const String& other) noexcept
 		: m_data(other.m_data)
 		, m_length(other.m_length)
@@ -296,11 +304,23 @@ namespace Onca
 		m_data = bytes.GetContainer();
 		for (usize i = 0; i < m_data.Size();)
 		{
-			// TODO: Validate chars
+			// The bytes are not validated, a stray continuation byte counts as a single character, so the loop always advances
+			++m_length;
+			i += Math::Max(Unicode::GetUtf8Size(m_data[i]), u8(1));
+		}
+	}
 
+	void String::AssignRaw(ByteSpan bytes) noexcept
+	{
+		m_data.Assign(bytes.begin(), bytes.end());
+		m_length = 0;
+		for (usize i = 0; i < m_data.Size();)
+		{
+			// The bytes are not validated, a stray continuation byte counts as a single character, so the loop always advances
 			++m_length;
-			i += Unicode::GetUtf8Size(m_data[i]);
+			i += Math::Max(Unicode::GetUtf8Size(m_data[i]), u8(1));
 		}
+		NullTerminate();
 	}
 
 	void String::Reserve(usize capacity) noexcept
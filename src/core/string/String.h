@@ -7,6 +7,7 @@
 namespace Onca
 {
 	class ByteBuffer;
+	class ByteSpan;
 	/**
 	 * Utf8 string
 	 */
@@ -150,6 +151,12 @@ namespace Onca
 		 * \param[in] alloc Allocator the string should use
 		 */
 		explicit String(const ByteBuffer& bytes, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
+		/**
+		 * Create a String with a raw bytes
+		 * \param[in] bytes Raw bytes
+		 * \param[in] alloc Allocator the string should use
+		 */
+		explicit String(ByteSpan bytes, Alloc::IAllocator& alloc = g_GlobalAlloc) noexcept;
 		/**
 		 * Create a String with the contents of another String
 		 * \param[in] other String to copy
@@ -243,6 +250,11 @@ namespace Onca
 		 * \param[in] bytes Bytes
 		 */
 		void AssignRaw(const ByteBuffer& bytes) noexcept;
+		/**
+		 * Assign a string from raw bytes
+		 * \param[in] bytes Bytes
+		 */
+		void AssignRaw(ByteSpan bytes) noexcept;
 
 		/**
 		 * Reserve capacity for the underlying utf8 data
@@ -821,6 +833,9 @@ namespace Onca
 		usize        m_length; ///< String length
 	};
 
+	template<>
+	constexpr bool IsTriviallyRelocatable<String> = true;
+
 	template<>
 	struct CORE_API Hash<String>
 	{
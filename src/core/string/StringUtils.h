@@ -114,6 +114,13 @@ namespace Onca
 		 * \return Size of an utf8 character
 		 */
 		constexpr auto GetUtf16Size(u16 firstWord) noexcept -> u8;
+		/**
+		 * Check if bytes contain valid utf8
+		 * \param pData Pointer to the bytes
+		 * \param size Number of bytes
+		 * \return Whether the bytes are valid utf8, i.e. contain no stray continuation bytes, truncated characters, overlong encodings, surrogates or codepoints past U+10FFFF
+		 */
+		constexpr auto IsValidUtf8(const u8* pData, usize size) noexcept -> bool;
 
 		/**
 		 * Get the size of the codepoint in its utf8 representation
@@ -210,6 +210,31 @@ namespace Onca::Unicode
 		return 1 + ((firstWord & 0xB800) == 0xB800);
 	}
 
+	constexpr auto IsValidUtf8(const u8* pData, usize size) noexcept -> bool
+	{
+		for (usize i = 0; i < size;)
+		{
+			const usize len = GetUtf8Size(pData[i]);
+			if (len == 0 || len > size - i || pData[i] >= 0xF8)
+				return false;
+
+			for (usize j = 1; j < len; ++j)
+			{
+				if ((pData[i + j] & 0b1100'0000) != 0b1000'0000)
+					return false;
+			}
+
+			if (len > 1)
+			{
+				const UCodepoint codepoint = GetCpFromUtf8(pData + i);
+				if (GetCodepointSizeInUtf8(codepoint) != len || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+					return false;
+			}
+			i += len;
+		}
+		return true;
+	}
+
 	constexpr auto GetCodepointSizeInUtf8(UCodepoint codepoint) noexcept -> u8
 	{
 		return 1 + 
@@ -0,0 +1,58 @@
+#include "NumaWorkerGroups.h"
+
+#include "core/allocator/GlobalAlloc.h"
+
+namespace Onca::Threading
+{
+	NumaWorkerGroups::NumaWorkerGroups(const NumaTopology& topology, Alloc::NumaAllocRegistry& registry, u32 workersPerNode, const WorkerFunc& func, const String& desc) noexcept
+		: m_registry(registry)
+		, m_func(func)
+	{
+		ASSERT(registry.GetNumNodes() == topology.GetNumNodes(), "The registry was not created for the topology");
+
+		// The worker data is referenced by the threads, so all of it needs to be created before any worker is started
+		for (u32 node = 0; node < topology.GetNumNodes(); ++node)
+		{
+			const usize numCores = topology.GetNode(node).cpuSetIds.Size();
+			const u32 numWorkers = workersPerNode ? workersPerNode : Math::Max(u32(numCores), 1u);
+			for (u32 i = 0; i < numWorkers; ++i)
+				m_data.Add(WorkerData{ this, node, i });
+		}
+
+		const Delegate<u32(WorkerData*)> runDelegate{ &NumaWorkerGroups::RunWorker };
+		m_threads.Reserve(m_data.Size());
+		for (WorkerData& data : m_data)
+		{
+			Result<Thread, SystemError> res = Thread::Create(ThreadAttribs{ .suspended = true, .desc = desc }, runDelegate, &data);
+			if (res.Failed())
+				continue;
+
+			Thread thread = res.MoveValue();
+			const DynArray<u32>& cpuSetIds = topology.GetNode(data.node).cpuSetIds;
+			if (!cpuSetIds.IsEmpty())
+				thread.SetCpuSetAffinity(cpuSetIds);
+			thread.Resume();
+			m_threads.Add(Move(thread));
+		}
+	}
+
+	NumaWorkerGroups::~NumaWorkerGroups() noexcept
+	{
+		Join();
+	}
+
+	void NumaWorkerGroups::Join() noexcept
+	{
+		for (Thread& thread : m_threads)
+			thread.Join();
+		m_threads.Clear();
+	}
+
+	auto NumaWorkerGroups::RunWorker(WorkerData* pData) noexcept -> u32
+	{
+		NumaWorkerGroups& groups = *pData->pGroups;
+		Alloc::NumaAllocRegistry::SetCurrentNode(pData->node);
+		ScopedGlobalAlloc scope{ groups.m_registry.GetNodeAlloc(pData->node) };
+		return groups.m_func(pData->node, pData->workerIdx);
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "core/MinInclude.h"
+#include "Thread.h"
+#include "core/allocator/composable/NumaAllocRegistry.h"
+#include "core/platform/NumaTopology.h"
+
+namespace Onca::Threading
+{
+	/**
+	 * \brief A group of worker threads for each node in a NUMA topology
+	 *
+	 * Each worker is pinned to the cores of its node, is marked to run on its node in the allocator registry
+	 * and has the general purpose allocator of its node set as its global allocator, so all memory it allocates is local to it.
+	 */
+	class CORE_API NumaWorkerGroups
+	{
+	public:
+		/**
+		 * Worker function, called with the index of the node of the worker and the index of the worker in its group
+		 */
+		using WorkerFunc = Delegate<u32(u32, u32)>;
+
+		/**
+		 * Create the worker groups, the workers start running immediately
+		 * \param[in] topology NUMA topology
+		 * \param[in] registry Allocator registry created for the topology
+		 * \param[in] workersPerNode Number of workers per node, 0 to create a worker for every core in the node
+		 * \param[in] func Worker function, needs to stay alive until the workers are joined
+		 * \param[in] desc Description of the worker threads
+		 */
+		NumaWorkerGroups(const NumaTopology& topology, Alloc::NumaAllocRegistry& registry, u32 workersPerNode, const WorkerFunc& func, const String& desc = "NUMA worker"_s) noexcept;
+		~NumaWorkerGroups() noexcept;
+
+		DISABLE_COPY(NumaWorkerGroups);
+		DISABLE_MOVE(NumaWorkerGroups);
+
+		/**
+		 * Wait for all workers to exit
+		 */
+		void Join() noexcept;
+
+		/**
+		 * Get the number of workers that were started
+		 * \return Number of workers
+		 */
+		auto GetNumWorkers() const noexcept -> u32 { return u32(m_threads.Size()); }
+
+	private:
+		/**
+		 * Data passed to a worker
+		 */
+		struct WorkerData
+		{
+			NumaWorkerGroups* pGroups;   ///< Worker groups
+			u32               node;      ///< Index of the node
+			u32               workerIdx; ///< Index of the worker in the group of its node
+		};
+
+		/**
+		 * Entry point of a worker
+		 * \param[in] pData Worker data
+		 * \return Exit code
+		 */
+		static auto RunWorker(WorkerData* pData) noexcept -> u32;
+
+		Alloc::NumaAllocRegistry& m_registry; ///< Allocator registry
+		WorkerFunc                m_func;     ///< Worker function
+		DynArray<WorkerData>      m_data;     ///< Data for each worker, never reallocated while the workers run
+		DynArray<Thread>          m_threads;  ///< Worker threads
+	};
+}
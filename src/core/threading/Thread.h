@@ -63,8 +63,9 @@ namespace Onca::Threading
 		template<typename... Args>
 		struct InvokeData
 		{
-			Delegate<u32(Args...)> delegate;
-			Tuple<Args...> arguments;
+			Delegate<u32(Args...)>    delegate;  ///< Delegate to invoke
+			Tuple<Args...>            arguments; ///< Arguments
+			MemRef<InvokeData>        self;      ///< Memory of the invoke data, released by the thread once the delegate returns
 		};
 
 	public:
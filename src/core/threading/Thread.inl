@@ -2,6 +2,7 @@
 
 #include "Thread.h"
 #include "core/utils/Meta.h"
+#include "core/memory/Unique.h"
 
 namespace Onca::Threading
 {
@@ -9,7 +10,9 @@ namespace Onca::Threading
 	auto Thread::Invoke(void* pData) noexcept -> u32
 	{
 		InvokeData<Args...>& data = *static_cast<InvokeData<Args...>*>(pData);
-		return data.delegate(data.arguments);
+		const u32 res = data.delegate(data.arguments);
+		Unique<InvokeData<Args...>> owned{ Move(data.self) };
+		return res;
 	}
 
 	inline auto Thread::GetDescription() const noexcept -> String
@@ -62,13 +65,18 @@ namespace Onca::Threading
 	{
 		Thread thread;
 		thread.m_attribs = attribs;
-		InvokeData<Args...> data;
-		data.delegate = delegate;
-		data.arguments = { Forward<Args>(args)... };
-		thread.Init(&Thread::Invoke<Args...>, &data);
+		// The invoke data needs to outlive this call, as the thread can start after Create() returns
+		Unique<InvokeData<Args...>> data = Unique<InvokeData<Args...>>::Create();
+		data->delegate = delegate;
+		data->arguments = { Forward<Args>(args)... };
+		InvokeData<Args...>* pData = data.Get();
+		pData->self = data.Release();
+		thread.Init(&Thread::Invoke<Args...>, pData);
 
 		if (thread.IsValid())
 			return thread;
+
+		Unique<InvokeData<Args...>> owned{ Move(pData->self) };
 		return TranslateSystemError();
 	}
 }
@@ -3,4 +3,5 @@
 #include "Common.h"
 #include "Sync.h"
 #include "Guarded.h"
-#include "Thread.h"
\ No newline at end of file
+#include "Thread.h"
+#include "NumaWorkerGroups.h"
\ No newline at end of file
@@ -84,6 +84,45 @@ namespace Onca::Algo
 	template<RandomAccessIterator It>
 	constexpr void Reverse(It first, It last) noexcept;
 
+	/**
+	 * Sort a range of values (unstable)
+	 * \tparam It Random access iterator
+	 * \tparam C Comparator type, returning a negative value when the first argument needs to be ordered before the second
+	 * \param[in] begin Iterator to the first element
+	 * \param[in] end Iterator to the end of the elements
+	 * \param[in] comp Comparator
+	 * \note Uses an introsort, so the worst case stays O(n log n)
+	 */
+	template<RandomAccessIterator It, typename C>
+	constexpr void Sort(It begin, It end, const C& comp) noexcept;
+
+	/**
+	 * Find the first element in a sorted range that is not ordered before a value
+	 * \tparam It Random access iterator
+	 * \tparam U Type of the value
+	 * \tparam C Comparator type, returning a negative value when the first argument needs to be ordered before the second
+	 * \param[in] begin Iterator to the first element
+	 * \param[in] end Iterator to the end of the elements
+	 * \param[in] val Value to look for
+	 * \param[in] comp Comparator, called with an element and the value
+	 * \return Iterator to the found element, or end if all elements are ordered before the value
+	 * \note The search is branchless, the only branch is the loop, whose trip count only depends on the size of the range
+	 */
+	template<RandomAccessIterator It, typename U, typename C>
+	constexpr auto LowerBound(It begin, It end, const U& val, const C& comp) noexcept -> It;
+
+	/**
+	 * Remove consecutive equal elements from a range, by moving unique elements to the front of the range
+	 * \tparam It Forward iterator
+	 * \tparam C Comparator type, returning 0 when both arguments are equal
+	 * \param[in] begin Iterator to the first element
+	 * \param[in] end Iterator to the end of the elements
+	 * \param[in] comp Comparator
+	 * \return Iterator to the new end of the range, elements after it are left in a moved-from state
+	 */
+	template<ForwardIterator It, typename C>
+	constexpr auto Unique(It begin, It end, const C& comp) noexcept -> It;
+
 }
 
 #include "Algo.inl"
\ No newline at end of file
@@ -103,4 +103,170 @@ namespace Onca::Algo
 		for (; first < last; ++first, --last)
 			SwapIter(first, last);
 	}
+
+	namespace Detail
+	{
+		// Ranges up to this size are insertion sorted, as the partitioning overhead outweighs its gains
+		constexpr usize InsertionSortThreshold = 16;
+
+		template<RandomAccessIterator It, typename C>
+		constexpr void InsertionSort(It begin, It end, const C& comp) noexcept
+		{
+			using UnderlyingType = Decay<decltype(*begin)>;
+
+			for (It it = begin + 1; it < end; ++it)
+			{
+				if (comp(*it, *(it - 1)) >= 0)
+					continue;
+
+				UnderlyingType tmp{ Onca::Move(*it) };
+				It hole = it;
+				do
+				{
+					*hole = Onca::Move(*(hole - 1));
+					--hole;
+				}
+				while (hole != begin && comp(tmp, *(hole - 1)) < 0);
+				*hole = Onca::Move(tmp);
+			}
+		}
+
+		template<RandomAccessIterator It, typename C>
+		constexpr void SiftDown(It begin, usize idx, usize size, const C& comp) noexcept
+		{
+			using UnderlyingType = Decay<decltype(*begin)>;
+
+			UnderlyingType tmp{ Onca::Move(begin[idx]) };
+			while (true)
+			{
+				usize child = idx * 2 + 1;
+				if (child >= size)
+					break;
+				if (child + 1 < size && comp(begin[child], begin[child + 1]) < 0)
+					++child;
+				if (comp(tmp, begin[child]) >= 0)
+					break;
+
+				begin[idx] = Onca::Move(begin[child]);
+				idx = child;
+			}
+			begin[idx] = Onca::Move(tmp);
+		}
+
+		template<RandomAccessIterator It, typename C>
+		constexpr void HeapSort(It begin, It end, const C& comp) noexcept
+		{
+			const usize size = usize(end - begin);
+			for (usize i = size / 2; i-- > 0;)
+				SiftDown(begin, i, size, comp);
+
+			for (usize i = size - 1; i > 0; --i)
+			{
+				Swap(begin[0], begin[i]);
+				SiftDown(begin, 0, i, comp);
+			}
+		}
+
+		template<RandomAccessIterator It, typename C>
+		constexpr void IntroSort(It begin, It end, usize depth, const C& comp) noexcept
+		{
+			while (usize(end - begin) > InsertionSortThreshold)
+			{
+				if (depth == 0)
+				{
+					HeapSort(begin, end, comp);
+					return;
+				}
+				--depth;
+
+				// Median of 3, which also puts values at the front and back that stop both partition scans without bounds checks
+				It mid = begin + usize(end - begin) / 2;
+				It last = end - 1;
+				if (comp(*mid, *begin) < 0)
+					Swap(*mid, *begin);
+				if (comp(*last, *mid) < 0)
+				{
+					Swap(*last, *mid);
+					if (comp(*mid, *begin) < 0)
+						Swap(*mid, *begin);
+				}
+
+				It pivot = begin + 1;
+				Swap(*mid, *pivot);
+
+				It lo = pivot;
+				It hi = last;
+				while (true)
+				{
+					do ++lo; while (comp(*lo, *pivot) < 0);
+					do --hi; while (comp(*pivot, *hi) < 0);
+					if (lo >= hi)
+						break;
+					Swap(*lo, *hi);
+				}
+				Swap(*pivot, *hi);
+
+				// Recurse into the smaller partition, so the stack depth stays logarithmic
+				if (hi - begin < end - hi)
+				{
+					IntroSort(begin, hi, depth, comp);
+					begin = hi + 1;
+				}
+				else
+				{
+					IntroSort(hi + 1, end, depth, comp);
+					end = hi;
+				}
+			}
+
+			if (usize(end - begin) > 1)
+				InsertionSort(begin, end, comp);
+		}
+	}
+
+	template<RandomAccessIterator It, typename C>
+	constexpr void Sort(It begin, It end, const C& comp) noexcept
+	{
+		usize depth = 0;
+		for (usize size = usize(end - begin); size > 1; size >>= 1)
+			depth += 2;
+		Detail::IntroSort(begin, end, depth, comp);
+	}
+
+	template<RandomAccessIterator It, typename U, typename C>
+	constexpr auto LowerBound(It begin, It end, const U& val, const C& comp) noexcept -> It
+	{
+		usize size = usize(end - begin);
+		if (size == 0)
+			return begin;
+
+		while (size > 1)
+		{
+			// Selecting instead of branching allows a conditional move, as the result of the comparison is unpredictable
+			const usize half = size / 2;
+			begin = comp(begin[half], val) < 0 ? begin + half : begin;
+			size -= half;
+		}
+		return comp(*begin, val) < 0 ? begin + 1 : begin;
+	}
+
+	template<ForwardIterator It, typename C>
+	constexpr auto Unique(It begin, It end, const C& comp) noexcept -> It
+	{
+		if (!(begin != end))
+			return end;
+
+		It dst = begin;
+		It it = begin;
+		for (++it; it != end; ++it)
+		{
+			if (comp(*dst, *it) == 0)
+				continue;
+
+			++dst;
+			if (dst != it)
+				*dst = Onca::Move(*it);
+		}
+		return ++dst;
+	}
 }
@@ -155,6 +155,55 @@ namespace Onca
 	private:
 		std::atomic<T> m_atomic; ///< Wrapped atomic
 	};
+
+	/**
+	 * Wrapper around std::atomic_ref, applying atomic operations to a value that is not stored as an atomic
+	 * \tparam T Underlying type
+	 * \note While any AtomicRef to a value exists, the value may only be accessed through an AtomicRef
+	 */
+	template<typename T>
+	class AtomicRef
+	{
+		STATIC_ASSERT(sizeof(T) <= sizeof(usize), "Cannot manage a type larger than usize");
+		STATIC_ASSERT(std::atomic_ref<T>::is_always_lock_free, "Underlying atomic implementation needs to be always lock free");
+	public:
+		/**
+		 * Create an atomic reference to a value
+		 * \param[in] val Referenced value
+		 */
+		explicit AtomicRef(T& val) noexcept;
+
+		/**
+		 * Atomically replace the current value with a new value
+		 * \param[in] val Value to store
+		 * \param[in] memOrder Memory order constraints to enforce
+		 * \note 'memOrder' must be one of the following: Relaxed, Release, or SeqCst
+		 */
+		void Store(T val, MemOrder memOrder = MemOrder::SeqCst) const noexcept;
+		/**
+		 * Atomically load and return the current value
+		 * \param[in] memOrder Memory order constraints to enforce
+		 * \return Current value
+		 * \note 'memOrder' must be one of the following: Relaxed, Consume, Acquire, or SeqCst
+		 */
+		auto Load(MemOrder memOrder = MemOrder::SeqCst) const noexcept -> T;
+		/**
+		 * Atomically replace the current value with a new value
+		 * \param[in] val Value to store
+		 * \param[in] memOrder Memory order constraints to enforce
+		 * \return Value before this call
+		 */
+		auto Exchange(T val, MemOrder memOrder = MemOrder::SeqCst) const noexcept -> T;
+
+	private:
+		std::atomic_ref<T> m_ref; ///< Wrapped atomic reference
+	};
+
+	/**
+	 * Insert a memory fence, to order memory accesses around it, without an associated atomic operation
+	 * \param[in] memOrder Memory order of the fence
+	 */
+	void AtomicThreadFence(MemOrder memOrder) noexcept;
 }
 
 #include "Atomic.inl"
\ No newline at end of file
@@ -160,4 +160,33 @@ namespace Onca
 	{
 		return FetchXor(val) ^ val;
 	}
+
+	template <typename T>
+	AtomicRef<T>::AtomicRef(T& val) noexcept
+		: m_ref(val)
+	{
+	}
+
+	template <typename T>
+	void AtomicRef<T>::Store(T val, MemOrder memOrder) const noexcept
+	{
+		m_ref.store(val, static_cast<std::memory_order>(memOrder));
+	}
+
+	template <typename T>
+	auto AtomicRef<T>::Load(MemOrder memOrder) const noexcept -> T
+	{
+		return m_ref.load(static_cast<std::memory_order>(memOrder));
+	}
+
+	template <typename T>
+	auto AtomicRef<T>::Exchange(T val, MemOrder memOrder) const noexcept -> T
+	{
+		return m_ref.exchange(val, static_cast<std::memory_order>(memOrder));
+	}
+
+	inline void AtomicThreadFence(MemOrder memOrder) noexcept
+	{
+		std::atomic_thread_fence(static_cast<std::memory_order>(memOrder));
+	}
 }
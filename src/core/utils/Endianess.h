@@ -1,9 +1,20 @@
 #pragma once
 #include "Defines.h"
 #include "Config.h"
+#include <bit>
 
 namespace Onca
 {
+	/**
+	 * Order in which the bytes of a value are stored
+	 */
+	enum class ByteOrder : u8
+	{
+		Little,                                   ///< Least significant byte first
+		Big,                                      ///< Most significant byte first
+		Native = IS_LITTLE_ENDIAN ? Little : Big, ///< Byte order of the platform
+	};
+
 	constexpr auto SwitchEndianess(u16 val) noexcept -> u16;
 	constexpr auto SwitchEndianess(u32 val) noexcept -> u32;
 	constexpr auto SwitchEndianess(u64 val) noexcept -> u64;
@@ -15,6 +26,18 @@ namespace Onca
 	constexpr auto ToBigEndian(u16 val) noexcept -> u16;
 	constexpr auto ToBigEndian(u32 val) noexcept -> u32;
 	constexpr auto ToBigEndian(u64 val) noexcept -> u64;
+
+	/**
+	 * Convert a value between the native byte order and another byte order
+	 * \tparam T Type of the value, needs to be trivially copyable and 1, 2, 4 or 8 bytes in size
+	 * \param[in] val Value
+	 * \param[in] order Byte order to convert from or to
+	 * \return Converted value
+	 * \note The conversion is symmetric, so the same function converts to and from the byte order
+	 */
+	template<typename T>
+		requires (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+	constexpr auto ConvertByteOrder(T val, ByteOrder order) noexcept -> T;
 }
 
 #include "Endianess.inl"
\ No newline at end of file
@@ -77,4 +77,26 @@ namespace Onca
 		else
 			return val;
 	}
+
+	template <typename T>
+		requires (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+	constexpr auto ConvertByteOrder(T val, ByteOrder order) noexcept -> T
+	{
+		if constexpr (sizeof(T) == 1)
+		{
+			return val;
+		}
+		else
+		{
+			if (order == ByteOrder::Native)
+				return val;
+
+			if constexpr (sizeof(T) == 2)
+				return std::bit_cast<T>(SwitchEndianess(std::bit_cast<u16>(val)));
+			else if constexpr (sizeof(T) == 4)
+				return std::bit_cast<T>(SwitchEndianess(std::bit_cast<u32>(val)));
+			else
+				return std::bit_cast<T>(SwitchEndianess(std::bit_cast<u64>(val)));
+		}
+	}
 }
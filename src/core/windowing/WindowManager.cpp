@@ -66,35 +66,36 @@ namespace Onca
 			return m_invalidWindow;
 		}
 
-		u32 id = 0;
-		for (; id < m_windows.Size(); ++id)
+		// Reserve the slot up front, so the window can be created with its final id and the parent can't be relocated while the window is created
+		const u32 id = m_windows.Emplace();
+		if (id == SlotMap<Window>::InvalidHandle)
 		{
-			if (!m_windows[id].IsValid())
-				break;
+			g_Logger.Error(LogCategories::WINDOWING, "Failed to create window, too many windows"_s);
+			return m_invalidWindow;
 		}
 
-		Window* pParent = nullptr;
-		if (info.parentId < m_windows.Size())
-		{
-			if (m_windows[info.parentId].IsValid())
-				pParent = &m_windows[info.parentId];
-		}
+		Window* pParent = m_windows.Get(info.parentId);
+		if (pParent && !pParent->IsValid())
+			pParent = nullptr;
 
 		Result<Window, SystemError> res = Window::Create(this, info, id, pParent);
 		if (res.Failed())
 		{
+			m_windows.Erase(id);
 			g_Logger.Error(LogCategories::WINDOWING, "Failed to create window, got error: {}"_s, res.Error().info);
 			return m_invalidWindow;
 		}
 
-		m_windows.Add(res.MoveValue());
-		return m_windows.Back();
+		Window& window = *m_windows.Get(id);
+		window = res.MoveValue();
+		return window;
 	}
 
 	auto WindowManager::GetWindow(u32 id) noexcept -> Window&
 	{
-		if (id < m_windows.Size() && m_windows[id].IsValid())
-			return m_windows[id];
+		Window* pWindow = m_windows.Get(id);
+		if (pWindow && pWindow->IsValid())
+			return *pWindow;
 		return m_invalidWindow;
 	}
 
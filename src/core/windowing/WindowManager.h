@@ -2,6 +2,7 @@
 #include "Monitor.h"
 #include "core/MinInclude.h"
 #include "Window.h"
+#include "core/containers/SlotMap.h"
 #include "core/threading/Threading.h"
 
 namespace LogCategories
@@ -71,7 +72,7 @@ namespace Onca
 		 */
 		auto CreateWindow(WindowCreationInfo& info) noexcept -> Window&;
 		/**
-		 * Get a window from an id, if the id is invalid, return a ref to an invalid window
+		 * Get a window from an id, if the id is invalid or stale, return a ref to an invalid window
 		 * \param[in] id Window id
 		 * \return Window with the given ID
 		 */
@@ -99,7 +100,7 @@ namespace Onca
 		DynArray<Monitor>    m_monitors;      ///< Available monitors
 
 		Window               m_invalidWindow; ///< Invalid dummy window
-		DynArray<Window>     m_windows;       ///< Windows
+		SlotMap<Window>      m_windows;       ///< Windows, window ids are handles into the map
 
 		Threading::ThreadID  m_threadId;      ///< Thread ID of thread that own the manager
 
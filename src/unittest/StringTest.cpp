@@ -1175,4 +1175,16 @@ TEST(StringTest, Index)
 	ASSERT_EQ(str[6], 'G');
 	ASSERT_EQ(str[7], 'H');
 	ASSERT_EQ(str[8], 'I');
+}
+
+TEST(StringTest, AssignRawInvalidUtf8)
+{
+	Core::Alloc::Mallocator alloc;
+	Core::String str{ alloc };
+
+	// Stray continuation bytes count as single characters
+	const u8 bytes[] = { 'a', 0x80, 0xBF, 'b' };
+	str.AssignRaw(Core::ByteSpan{ bytes, sizeof(bytes) });
+	ASSERT_EQ(str.DataSize(), 4);
+	ASSERT_EQ(str.Length(), 4);
 }
\ No newline at end of file
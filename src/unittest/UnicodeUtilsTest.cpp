@@ -85,6 +85,29 @@ TEST(UnicodeUtilsTest, Utf8Size)
 	ASSERT_EQ(Core::Unicode::GetUtf8Size(firstByte), 4);
 }
 
+TEST(UnicodeUtilsTest, IsValidUtf8)
+{
+	const u8 valid[] = { 'A', 0xC3, 0xA9, 0xE4, 0xB8, 0x96, 0xF0, 0x9F, 0x98, 0x80 };
+	ASSERT_TRUE(Core::Unicode::IsValidUtf8(valid, sizeof(valid)));
+	ASSERT_TRUE(Core::Unicode::IsValidUtf8(valid, 0));
+	// Truncated characters
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(valid, 2));
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(valid, 9));
+
+	const u8 continuation[] = { 'A', 0x80, 'B' };
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(continuation, sizeof(continuation)));
+	const u8 missingContinuation[] = { 0xE4, 'A', 0x96 };
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(missingContinuation, sizeof(missingContinuation)));
+	const u8 overlong[] = { 0xC0, 0xAF };
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(overlong, sizeof(overlong)));
+	const u8 surrogate[] = { 0xED, 0xA0, 0x80 };
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(surrogate, sizeof(surrogate)));
+	const u8 outOfRange[] = { 0xF4, 0x90, 0x80, 0x80 };
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(outOfRange, sizeof(outOfRange)));
+	const u8 invalidLead[] = { 0xF8, 0x88, 0x80, 0x80 };
+	ASSERT_FALSE(Core::Unicode::IsValidUtf8(invalidLead, sizeof(invalidLead)));
+}
+
 TEST(UnicodeUtilsTest, CodepointToUtf8)
 {
 	Utf8Char utf8 = Core::Unicode::GetUtf8FromCp('A');
@@ -0,0 +1,250 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+#if ENABLE_ALLOC_TRACKING
+
+namespace
+{
+	constexpr const char* TestTag = "AllocTrackerTest";
+	constexpr const char* TrackingTag = "AllocTrackerTest.TrackingAllocator";
+
+	auto FindTag(const DynArray<Alloc::AllocTagStats>& stats, const char* pTag) -> const Alloc::AllocTagStats*
+	{
+		for (const Alloc::AllocTagStats& tagStats : stats)
+		{
+			if (tagStats.pTag == pTag)
+				return &tagStats;
+		}
+		return nullptr;
+	}
+
+	auto FindLive(const DynArray<Alloc::AllocRecord>& live, const void* ptr) -> const Alloc::AllocRecord*
+	{
+		for (const Alloc::AllocRecord& record : live)
+		{
+			if (record.addr == usize(ptr))
+				return &record;
+		}
+		return nullptr;
+	}
+}
+
+TEST(AllocTrackerTest, Tags)
+{
+	Alloc::Mallocator mallocator;
+	g_AllocTracker.Start();
+
+	MemRef<u8> tagged;
+	{
+		ALLOC_TAG_SCOPE(TestTag);
+		EXPECT_EQ(Alloc::AllocTracker::GetCurrentTag(), TestTag);
+		tagged = mallocator.Allocate<u8>(128);
+		MemRef<u8> freed = mallocator.Allocate<u8>(64);
+		mallocator.Deallocate(Move(freed));
+	}
+	EXPECT_EQ(Alloc::AllocTracker::GetCurrentTag(), Alloc::AllocTracker::DefaultTag);
+
+	DynArray<Alloc::AllocTagStats> stats = g_AllocTracker.GetTagStats();
+	const Alloc::AllocTagStats* pStats = FindTag(stats, TestTag);
+	ASSERT_NE(pStats, nullptr);
+	EXPECT_EQ(pStats->liveBytes, 128);
+	EXPECT_EQ(pStats->liveAllocs, 1);
+	EXPECT_EQ(pStats->peakBytes, 192);
+	EXPECT_EQ(pStats->totalBytes, 192);
+	EXPECT_EQ(pStats->totalAllocs, 2);
+
+	mallocator.Deallocate(Move(tagged));
+	EXPECT_EQ(g_AllocTracker.Stop(), 0);
+}
+
+TEST(AllocTrackerTest, Leaks)
+{
+	Alloc::Mallocator mallocator;
+	g_AllocTracker.Start();
+
+	MemRef<u8> leaked;
+	{
+		ALLOC_TAG_SCOPE(TestTag);
+		leaked = mallocator.Allocate<u8>(32);
+	}
+
+	EXPECT_EQ(g_AllocTracker.Stop(), 1);
+	DynArray<Alloc::AllocRecord> live = g_AllocTracker.GetLiveAllocations();
+	ASSERT_EQ(live.Size(), 1);
+	EXPECT_EQ(live[0].addr, usize(leaked.Ptr()));
+	EXPECT_EQ(live[0].size, 32);
+	EXPECT_EQ(live[0].pTag, TestTag);
+
+	// Memory allocated before tracking started is ignored
+	g_AllocTracker.Start();
+	mallocator.Deallocate(Move(leaked));
+	EXPECT_EQ(g_AllocTracker.Stop(), 0);
+}
+
+TEST(AllocTrackerTest, TrackingAllocator)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::TrackingAllocator tracking{ &mallocator, TrackingTag };
+	g_AllocTracker.Start();
+
+	MemRef<u8> mem;
+	{
+		// The tag of a tracking allocator takes precedence over the tag of the thread
+		ALLOC_TAG_SCOPE(TestTag);
+		mem = tracking.Allocate<u8>(256);
+	}
+	EXPECT_EQ(mem.GetAlloc(), &tracking);
+	EXPECT_EQ(tracking.GetLiveBytes(), 256);
+	EXPECT_EQ(tracking.GetLiveAllocs(), 1);
+
+	DynArray<Alloc::AllocTagStats> stats = g_AllocTracker.GetTagStats();
+	const Alloc::AllocTagStats* pStats = FindTag(stats, TrackingTag);
+	ASSERT_NE(pStats, nullptr);
+	EXPECT_EQ(pStats->liveBytes, 256);
+	EXPECT_EQ(pStats->totalAllocs, 1);
+	EXPECT_EQ(FindTag(stats, TestTag), nullptr);
+
+	mem.Dealloc();
+	EXPECT_EQ(tracking.GetLiveBytes(), 0);
+	EXPECT_EQ(tracking.GetPeakBytes(), 256);
+	EXPECT_EQ(tracking.GetTotalAllocs(), 1);
+	EXPECT_EQ(g_AllocTracker.Stop(), 0);
+}
+
+TEST(AllocTrackerTest, CrossThread)
+{
+	constexpr usize NumAllocs = 10000;
+	Alloc::Mallocator mallocator;
+	g_AllocTracker.Start();
+
+	// More allocations than fit in a thread's buffer, so the buffer needs to be flushed while allocating
+	DynArray<MemRef<u8>> mems{ mallocator };
+	mems.Reserve(NumAllocs);
+	{
+		ALLOC_TAG_SCOPE(TestTag);
+		for (usize i = 0; i < NumAllocs; ++i)
+			mems.Add(mallocator.Allocate<u8>(16));
+	}
+
+	// Memory deallocated by another thread, whose events can be drained before the events of the allocating thread
+	auto workerFunc = [&]() -> u32
+	{
+		for (MemRef<u8>& mem : mems)
+			mallocator.Deallocate(Move(mem));
+		return 0;
+	};
+	const Delegate<u32()> workerDelegate{ workerFunc };
+
+	Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "AllocTracker dealloc"_s }, workerDelegate);
+	ASSERT_FALSE(res.Failed());
+	res.MoveValue().Join();
+
+	DynArray<Alloc::AllocTagStats> stats = g_AllocTracker.GetTagStats();
+	const Alloc::AllocTagStats* pStats = FindTag(stats, TestTag);
+	ASSERT_NE(pStats, nullptr);
+	EXPECT_EQ(pStats->liveAllocs, 0);
+	EXPECT_EQ(pStats->totalAllocs, NumAllocs);
+
+	mems.Clear(true);
+	EXPECT_EQ(g_AllocTracker.Stop(), 0);
+}
+
+TEST(AllocTrackerTest, Reallocate)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::LinearAllocator<256, 16> linear{ &mallocator };
+	g_AllocTracker.Start();
+
+	MemRef<u8> moved;
+	MemRef<u8> full;
+	{
+		ALLOC_TAG_SCOPE(TestTag);
+		moved = mallocator.Allocate<u8>(64);
+		full = linear.Allocate<u8>(128);
+	}
+
+	// Reallocated memory keeps the tag of the original allocation
+	ASSERT_TRUE(mallocator.Reallocate(moved, 4096));
+	DynArray<Alloc::AllocRecord> live = g_AllocTracker.GetLiveAllocations();
+	const Alloc::AllocRecord* pRecord = FindLive(live, moved.Ptr());
+	ASSERT_NE(pRecord, nullptr);
+	EXPECT_EQ(pRecord->size, 4096);
+	EXPECT_EQ(pRecord->pTag, TestTag);
+
+	// A failed reallocation is not recorded
+	EXPECT_FALSE(linear.Reallocate(full, 1024));
+	live = g_AllocTracker.GetLiveAllocations();
+	pRecord = FindLive(live, full.Ptr());
+	ASSERT_NE(pRecord, nullptr);
+	EXPECT_EQ(pRecord->size, 128);
+	EXPECT_EQ(pRecord->pTag, TestTag);
+
+	DynArray<Alloc::AllocTagStats> stats = g_AllocTracker.GetTagStats();
+	const Alloc::AllocTagStats* pStats = FindTag(stats, TestTag);
+	ASSERT_NE(pStats, nullptr);
+	EXPECT_EQ(pStats->liveBytes, 4096 + 128);
+	EXPECT_EQ(pStats->liveAllocs, 2);
+	EXPECT_EQ(FindTag(stats, Alloc::AllocTracker::DefaultTag), nullptr);
+
+	mallocator.Deallocate(Move(moved));
+	linear.Deallocate(Move(full));
+	EXPECT_EQ(g_AllocTracker.Stop(), 0);
+}
+
+TEST(AllocTrackerTest, DestroyWhileThreadOwnsBuffer)
+{
+	Alloc::Mallocator mallocator;
+	Atomic<u32> phase{ 0 };
+	auto workerFunc = [&]() -> u32
+	{
+		while (phase.Load() != 1)
+			;
+		MemRef<u8> mem = mallocator.Allocate<u8>(16);
+		mallocator.Deallocate(Move(mem));
+
+		// The thread releases the buffer of the destroyed tracker when it exits
+		phase.Store(2);
+		while (phase.Load() != 3)
+			;
+		return 0;
+	};
+	const Delegate<u32()> workerDelegate{ workerFunc };
+
+	Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "AllocTracker buffer owner"_s }, workerDelegate);
+	ASSERT_FALSE(res.Failed());
+	Threading::Thread worker = res.MoveValue();
+
+	{
+		Alloc::AllocTracker tracker;
+		tracker.Start();
+		phase.Store(1);
+		while (phase.Load() != 2)
+			;
+		EXPECT_EQ(tracker.Stop(), 0);
+	}
+	phase.Store(3);
+	worker.Join();
+
+	// A new tracker adopts the released buffer, and a buffer of the destroyed tracker is never used for the new one, even at the same address
+	for (u32 i = 0; i < 2; ++i)
+	{
+		Alloc::AllocTracker tracker;
+		tracker.Start();
+		{
+			ALLOC_TAG_SCOPE(TestTag);
+			MemRef<u8> mem = mallocator.Allocate<u8>(32);
+			mallocator.Deallocate(Move(mem));
+		}
+
+		DynArray<Alloc::AllocTagStats> stats = tracker.GetTagStats();
+		const Alloc::AllocTagStats* pStats = FindTag(stats, TestTag);
+		ASSERT_NE(pStats, nullptr);
+		EXPECT_EQ(pStats->totalBytes, 32);
+		EXPECT_EQ(pStats->totalAllocs, 1);
+		EXPECT_EQ(tracker.Stop(), 0);
+	}
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(BitmapAllocatorTest, AllocateAllSingle)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::BitmapAllocator<32, 1000> alloc{ &mallocator };
+
+	DynArray<MemRef<u8>> blocks;
+	for (usize i = 0; i < 1000; ++i)
+	{
+		blocks.Add(alloc.Allocate<u8>(32));
+		ASSERT_TRUE(blocks.Back().IsValid());
+	}
+	EXPECT_FALSE(alloc.Allocate<u8>(32).IsValid());
+
+	for (MemRef<u8>& mem : blocks)
+		alloc.Deallocate(Move(mem));
+
+	MemRef<u8> all = alloc.Allocate<u8>(32 * 1000);
+	EXPECT_TRUE(all.IsValid());
+	alloc.Deallocate(Move(all));
+}
+
+TEST(BitmapAllocatorTest, Fragmented)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::BitmapAllocator<32, 256> alloc{ &mallocator };
+
+	DynArray<MemRef<u8>> blocks;
+	for (usize i = 0; i < 256; ++i)
+		blocks.Add(alloc.Allocate<u8>(32));
+
+	// Free every other block, so no run of 2 blocks is available
+	for (usize i = 0; i < 256; i += 2)
+		alloc.Deallocate(Move(blocks[i]));
+	EXPECT_FALSE(alloc.Allocate<u8>(64).IsValid());
+
+	// Free a run crossing the boundary of the first and second bitmap word
+	for (usize i = 61; i < 70; i += 2)
+		alloc.Deallocate(Move(blocks[i]));
+
+	MemRef<u8> run = alloc.Allocate<u8>(32 * 10);
+	ASSERT_TRUE(run.IsValid());
+	EXPECT_EQ(run.Ptr(), blocks[59].Ptr() + 32);
+	alloc.Deallocate(Move(run));
+
+	for (MemRef<u8>& mem : blocks)
+	{
+		if (mem.IsValid())
+			alloc.Deallocate(Move(mem));
+	}
+}
+
+TEST(BitmapAllocatorTest, Stress)
+{
+	constexpr usize BlockSize = 64;
+	constexpr usize NumBlocks = 4096;
+
+	Alloc::Mallocator mallocator;
+	Alloc::BitmapAllocator<BlockSize, NumBlocks> alloc{ &mallocator };
+
+	Atomic<u32> nextId{ 0 };
+	Atomic<u32> numCorrupted{ 0 };
+
+	// Threads mix single and multi-block allocations, stamping every block of an allocation with their id
+	auto workerFunc = [&]() -> u32
+	{
+		const u64 id = nextId.FetchAdd(1) + 1;
+		u64 rng = id * 0x9E3779B97F4A7C15;
+
+		MemRef<u64> allocs[32];
+		for (u32 it = 0; it < 10'000; ++it)
+		{
+			for (MemRef<u64>& mem : allocs)
+			{
+				rng ^= rng << 13;
+				rng ^= rng >> 7;
+				rng ^= rng << 17;
+
+				const usize numBlocks = rng % 4 == 0 ? 1 + (rng >> 8) % 70 : 1;
+				mem = alloc.Allocate<u64>(numBlocks * BlockSize);
+				if (!mem.IsValid())
+					continue;
+				for (usize i = 0; i < numBlocks * BlockSize / sizeof(u64); ++i)
+					mem.Ptr()[i] = id;
+			}
+
+			for (MemRef<u64>& mem : allocs)
+			{
+				if (!mem.IsValid())
+					continue;
+				for (usize i = 0; i < mem.Size() / sizeof(u64); ++i)
+				{
+					if (mem.Ptr()[i] != id)
+					{
+						numCorrupted.FetchAdd(1);
+						break;
+					}
+				}
+				alloc.Deallocate(Move(mem));
+			}
+		}
+		return 0;
+	};
+	const Delegate<u32()> workerDelegate{ workerFunc };
+
+	DynArray<Threading::Thread> workers;
+	for (u32 i = 0; i < 8; ++i)
+	{
+		Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "BitmapAllocator stress"_s }, workerDelegate);
+		ASSERT_FALSE(res.Failed());
+		workers.Add(res.MoveValue());
+	}
+	for (Threading::Thread& worker : workers)
+		worker.Join();
+
+	EXPECT_EQ(numCorrupted.Load(), 0);
+
+	// Every block needs to be free again
+	MemRef<u8> all = alloc.Allocate<u8>(BlockSize * NumBlocks);
+	EXPECT_TRUE(all.IsValid());
+	alloc.Deallocate(Move(all));
+}
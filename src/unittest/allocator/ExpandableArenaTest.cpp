@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	using SubAlloc = Alloc::PoolAllocator<64, 16>;
+}
+
+TEST(ExpandableArenaTest, Expand)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::ExpandableArena<SubAlloc> arena{ &mallocator };
+	EXPECT_EQ(arena.GetNumSubAllocs(), 0);
+
+	DynArray<MemRef<u8>> allocs;
+	for (usize i = 0; i < 16 * 8; ++i)
+	{
+		allocs.Add(arena.Allocate<u8>(64));
+		ASSERT_TRUE(allocs.Back().IsValid());
+		EXPECT_EQ(allocs.Back().GetAlloc(), &arena);
+	}
+	EXPECT_EQ(arena.GetNumSubAllocs(), 8);
+
+	for (MemRef<u8>& mem : allocs)
+		EXPECT_TRUE(arena.Owns(mem));
+
+	MemRef<u8> other = mallocator.Allocate<u8>(64);
+	EXPECT_FALSE(arena.Owns(other));
+	mallocator.Deallocate(Move(other));
+
+	for (MemRef<u8>& mem : allocs)
+		arena.Deallocate(Move(mem));
+
+	// Only the sub-allocator currently used for allocations is kept around
+	EXPECT_EQ(arena.GetNumSubAllocs(), 1);
+}
+
+TEST(ExpandableArenaTest, Stress)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::ExpandableArena<SubAlloc> arena{ &mallocator };
+
+	Atomic<u32> nextId{ 0 };
+	Atomic<u32> numCorrupted{ 0 };
+
+	// Threads keep growing and shrinking their set of allocations, causing sub-allocators to be added and released
+	auto workerFunc = [&]() -> u32
+	{
+		const u64 id = nextId.FetchAdd(1) + 1;
+
+		MemRef<u64> allocs[64];
+		for (u32 it = 0; it < 2'000; ++it)
+		{
+			const usize count = 1 + (it * 7 + id) % 64;
+			for (usize i = 0; i < count; ++i)
+			{
+				allocs[i] = arena.Allocate<u64>(64);
+				allocs[i].Ptr()[0] = id;
+			}
+			for (usize i = 0; i < count; ++i)
+			{
+				if (allocs[i].Ptr()[0] != id)
+					numCorrupted.FetchAdd(1);
+				arena.Deallocate(Move(allocs[i]));
+			}
+		}
+		return 0;
+	};
+	const Delegate<u32()> workerDelegate{ workerFunc };
+
+	DynArray<Threading::Thread> workers;
+	for (u32 i = 0; i < 8; ++i)
+	{
+		Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "ExpandableArena stress"_s }, workerDelegate);
+		ASSERT_FALSE(res.Failed());
+		workers.Add(res.MoveValue());
+	}
+	for (Threading::Thread& worker : workers)
+		worker.Join();
+
+	EXPECT_EQ(numCorrupted.Load(), 0);
+}
@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	struct AllocCounts
+	{
+		u32 numAllocs = 0;
+		u32 numDeallocs = 0;
+	};
+
+	class CountingAlloc final : public Alloc::IAllocator
+	{
+	public:
+		explicit CountingAlloc(AllocCounts& counts) noexcept
+			: m_pCounts(&counts)
+		{
+		}
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override
+		{
+			++m_pCounts->numAllocs;
+			const MemRef<u8> mem = m_mallocator.Allocate<u8>(size, align, isBacking);
+			return { mem.Ptr(), this, Math::Log2(align), size, isBacking };
+		}
+
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override
+		{
+			++m_pCounts->numDeallocs;
+			m_mallocator.Deallocate(MemRef<u8>{ mem.Ptr(), &m_mallocator, Math::Log2(mem.Align()), mem.Size(), mem.IsBackingMem() });
+		}
+
+	private:
+		Alloc::Mallocator m_mallocator;
+		AllocCounts*      m_pCounts;
+	};
+
+	using MainAlloc = Alloc::LinearAllocator<256, 16>;
+
+	void ShrinkDynArray(Alloc::IAllocator& arena, const AllocCounts& fallbackCounts)
+	{
+		DynArray<u32> arr{ arena };
+		arr.Reserve(32);
+		for (u32 i = 0; i < 8; ++i)
+			arr.Add(i);
+
+		// Memory of the main allocator is never released through the fallback allocator
+		arr.ShrinkToFit();
+		EXPECT_EQ(arr.Capacity(), 8);
+		EXPECT_EQ(fallbackCounts.numAllocs, 0);
+		EXPECT_EQ(fallbackCounts.numDeallocs, 0);
+		for (u32 i = 0; i < 8; ++i)
+			EXPECT_EQ(arr[i], i);
+	}
+}
+
+TEST(FallbackArenaTest, ShrinkDynArray)
+{
+	Alloc::Mallocator mallocator;
+	AllocCounts fallbackCounts;
+	Alloc::FallbackArena<MainAlloc, CountingAlloc> arena{ MainAlloc{ &mallocator }, CountingAlloc{ fallbackCounts } };
+	ShrinkDynArray(arena, fallbackCounts);
+}
+
+TEST(FallbackArenaTest, ShrinkDynArrayFromFallback)
+{
+	Alloc::Mallocator mallocator;
+	AllocCounts fallbackCounts;
+	Alloc::FallbackArena<MainAlloc, CountingAlloc> arena{ MainAlloc{ &mallocator }, CountingAlloc{ fallbackCounts } };
+	{
+		DynArray<u32> arr{ arena };
+		for (u32 i = 0; i < 8; ++i)
+			arr.Add(i);
+
+		// Growing past the memory of the main allocator moves the elements to the fallback allocator
+		arr.Reserve(128);
+		EXPECT_EQ(fallbackCounts.numAllocs, 1);
+		EXPECT_EQ(fallbackCounts.numDeallocs, 0);
+
+		// Shrinking moves them back, releasing the memory of the fallback allocator
+		arr.ShrinkToFit();
+		EXPECT_EQ(arr.Capacity(), 8);
+		EXPECT_EQ(fallbackCounts.numAllocs, 1);
+		EXPECT_EQ(fallbackCounts.numDeallocs, 1);
+		for (u32 i = 0; i < 8; ++i)
+			EXPECT_EQ(arr[i], i);
+	}
+	EXPECT_EQ(fallbackCounts.numDeallocs, fallbackCounts.numAllocs);
+}
+
+TEST(FallbackArenaTest, ShrinkDynArrayNested)
+{
+	// The main allocator is an arena itself, which only recognizes its memory by address
+	using InnerArena = Alloc::FallbackArena<MainAlloc, MainAlloc>;
+	Alloc::Mallocator mallocator;
+	AllocCounts fallbackCounts;
+	Alloc::FallbackArena<InnerArena, CountingAlloc> arena{ InnerArena{ MainAlloc{ &mallocator }, MainAlloc{ &mallocator } }, CountingAlloc{ fallbackCounts } };
+	ShrinkDynArray(arena, fallbackCounts);
+}
@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(FrameAllocatorTest, Frames)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::FrameAllocator alloc{ &mallocator, 4_KiB, 2 };
+
+	MemRef<u64> first = alloc.Allocate<u64>(sizeof(u64) * 16);
+	ASSERT_TRUE(first.IsValid());
+	first.Ptr()[15] = 42;
+	EXPECT_TRUE(alloc.Owns(first));
+
+	// Memory stays valid while its frame is in flight
+	alloc.NextFrame();
+	MemRef<u64> second = alloc.Allocate<u64>(sizeof(u64) * 16);
+	ASSERT_TRUE(second.IsValid());
+	EXPECT_EQ(first.Ptr()[15], 42);
+	const usize numBlocks = alloc.GetNumBlocks();
+	EXPECT_EQ(numBlocks, 2);
+
+	// The buffer of the first frame is reused after the frame expired
+	alloc.NextFrame();
+	MemRef<u64> third = alloc.Allocate<u64>(sizeof(u64) * 16);
+	EXPECT_EQ(third.Ptr(), first.Ptr());
+	EXPECT_EQ(alloc.GetNumBlocks(), numBlocks);
+
+	alloc.Deallocate(Move(second));
+	alloc.Deallocate(Move(third));
+}
+
+TEST(FrameAllocatorTest, LargeAllocations)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::FrameAllocator alloc{ &mallocator, 4_KiB, 1 };
+
+	MemRef<u8> small = alloc.Allocate<u8>(64);
+	MemRef<u8> large = alloc.Allocate<u8>(64_KiB, 256);
+	ASSERT_TRUE(large.IsValid());
+	EXPECT_EQ(usize(large.Ptr()) % 256, 0);
+	large.Ptr()[64_KiB - 1] = 1;
+	EXPECT_EQ(alloc.GetNumBlocks(), 2);
+
+	// Dedicated blocks are released when the buffer is reset
+	alloc.NextFrame();
+	MemRef<u8> next = alloc.Allocate<u8>(64);
+	EXPECT_EQ(next.Ptr(), small.Ptr());
+	EXPECT_EQ(alloc.GetNumBlocks(), 1);
+}
+
+TEST(FrameAllocatorTest, Scope)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::FrameAllocator alloc{ &mallocator, 4_KiB, 2 };
+
+	MemRef<u8> outer = alloc.Allocate<u8>(64);
+	u8* pScopeMem;
+	{
+		Alloc::FrameAllocator::Scope scope{ alloc };
+		pScopeMem = alloc.Allocate<u8>(1_KiB).Ptr();
+		for (usize i = 0; i < 8; ++i)
+			EXPECT_TRUE(alloc.Allocate<u8>(1_KiB).IsValid());
+		MemRef<u8> large = alloc.Allocate<u8>(16_KiB);
+		EXPECT_TRUE(large.IsValid());
+	}
+
+	// Memory allocated during the scope is reused, only the dedicated block of the large allocation is released
+	MemRef<u8> after = alloc.Allocate<u8>(1_KiB);
+	EXPECT_EQ(after.Ptr(), pScopeMem);
+	EXPECT_EQ(alloc.GetNumBlocks(), 3);
+	alloc.Deallocate(Move(outer));
+}
+
+TEST(FrameAllocatorTest, GrowInPlace)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::FrameAllocator alloc{ &mallocator, 64_KiB, 2 };
+
+	DynArray<u32> arr{ alloc };
+	arr.Add(0);
+	const u32* pData = arr.Data();
+	for (u32 i = 1; i < 1024; ++i)
+		arr.Add(i);
+	EXPECT_EQ(arr.Data(), pData);
+}
+
+TEST(FrameAllocatorTest, ScopedGlobalAlloc)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::FrameAllocator alloc{ &mallocator, 4_KiB, 2 };
+
+	Alloc::IAllocator* pGlobal = &g_GlobalAlloc;
+	{
+		ScopedGlobalAlloc scope{ alloc };
+		EXPECT_EQ(&g_GlobalAlloc, &alloc);
+
+		DynArray<u32> arr;
+		arr.Add(1);
+		EXPECT_EQ(arr.GetAllocator(), &alloc);
+
+		{
+			ScopedGlobalAlloc nested{ mallocator };
+			EXPECT_EQ(&g_GlobalAlloc, &mallocator);
+		}
+		EXPECT_EQ(&g_GlobalAlloc, &alloc);
+	}
+	EXPECT_EQ(&g_GlobalAlloc, pGlobal);
+}
+
+TEST(FrameAllocatorTest, Threaded)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::FrameAllocator alloc{ &mallocator, 4_KiB, 2 };
+
+	Atomic<u32> nextId{ 0 };
+	Atomic<u32> numCorrupted{ 0 };
+
+	// Every thread fills its own frame memory, which should never be touched by other threads
+	auto workerFunc = [&]() -> u32
+	{
+		const u64 id = nextId.FetchAdd(1) + 1;
+		for (u32 it = 0; it < 1'000; ++it)
+		{
+			Alloc::FrameAllocator::Scope scope{ alloc };
+			MemRef<u64> allocs[16];
+			for (usize i = 0; i < 16; ++i)
+			{
+				allocs[i] = alloc.Allocate<u64>(sizeof(u64) * (1 + i * 8));
+				for (usize j = 0; j <= i * 8; ++j)
+					allocs[i].Ptr()[j] = id;
+			}
+			for (MemRef<u64>& mem : allocs)
+			{
+				for (usize j = 0; j < mem.Size() / sizeof(u64); ++j)
+				{
+					if (mem.Ptr()[j] != id)
+					{
+						numCorrupted.FetchAdd(1);
+						break;
+					}
+				}
+				alloc.Deallocate(Move(mem));
+			}
+		}
+		return 0;
+	};
+	const Delegate<u32()> workerDelegate{ workerFunc };
+
+	DynArray<Threading::Thread> workers;
+	for (u32 i = 0; i < 8; ++i)
+	{
+		Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "FrameAllocator threaded"_s }, workerDelegate);
+		ASSERT_FALSE(res.Failed());
+		workers.Add(res.MoveValue());
+	}
+	for (Threading::Thread& worker : workers)
+		worker.Join();
+
+	EXPECT_EQ(numCorrupted.Load(), 0);
+}
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(NumaAllocatorTest, FakeTopology)
+{
+	const NumaTopology system = NumaTopology::FromSystem();
+	ASSERT_GE(system.GetNumNodes(), 1);
+	EXPECT_FALSE(system.IsFake());
+
+	// Every fake node gets its own cores, as long as there are enough cores to go around
+	const NumaTopology topology = NumaTopology::CreateFake(2);
+	ASSERT_EQ(topology.GetNumNodes(), 2);
+	EXPECT_TRUE(topology.IsFake());
+
+	const NumaTopology::Node& node0 = topology.GetNode(0);
+	const NumaTopology::Node& node1 = topology.GetNode(1);
+	EXPECT_FALSE(node0.cpuSetIds.IsEmpty());
+	EXPECT_FALSE(node1.cpuSetIds.IsEmpty());
+	if (node0.cpuSetIds.Size() + node1.cpuSetIds.Size() > 2)
+	{
+		for (u32 id : node0.cpuSetIds)
+			EXPECT_FALSE(node1.cpuSetIds.Contains(id));
+	}
+}
+
+TEST(NumaAllocatorTest, Allocate)
+{
+	const NumaTopology topology = NumaTopology::FromSystem();
+	Alloc::NumaAllocator alloc{ topology.GetNode(0).memNode };
+
+	MemRef<u8> mem = alloc.Allocate<u8>(100_KiB, 64);
+	ASSERT_TRUE(mem.IsValid());
+	EXPECT_EQ(usize(mem.Ptr()) % 64, 0);
+	MemSet(mem.Ptr(), 0xAB, 100_KiB);
+	EXPECT_EQ(mem.Ptr()[100_KiB - 1], 0xAB);
+	alloc.Deallocate(Move(mem));
+
+	// An unbound allocator behaves like a plain page allocator
+	Alloc::NumaAllocator unbound{ VirtualMemory::NoNumaNode };
+	MemRef<u64> pages = unbound.Allocate<u64>(1_MiB);
+	ASSERT_TRUE(pages.IsValid());
+	pages.Ptr()[1_MiB / sizeof(u64) - 1] = 42;
+	unbound.Deallocate(Move(pages));
+}
+
+TEST(NumaAllocatorTest, Registry)
+{
+	const NumaTopology topology = NumaTopology::CreateFake(2);
+	Alloc::NumaAllocRegistry registry{ topology, 1_GiB };
+	ASSERT_EQ(registry.GetNumNodes(), 2);
+	EXPECT_NE(&registry.GetNodeAlloc(0), &registry.GetNodeAlloc(1));
+
+	MemRef<u32> small = registry.GetNodeAlloc(1).Allocate<u32>(64);
+	ASSERT_TRUE(small.IsValid());
+	EXPECT_TRUE(registry.GetNodeAlloc(1).Owns(small));
+	EXPECT_FALSE(registry.GetNodeAlloc(0).Owns(small));
+
+	// Large allocations are served by the page allocator of the same node
+	MemRef<u8> large = registry.GetNodeAlloc(1).Allocate<u8>(1_MiB);
+	ASSERT_TRUE(large.IsValid());
+	EXPECT_EQ(large.GetAlloc(), &registry.GetPageAlloc(1));
+
+	EXPECT_EQ(Alloc::NumaAllocRegistry::GetCurrentNode(), 0);
+	Alloc::NumaAllocRegistry::SetCurrentNode(1);
+	EXPECT_EQ(&registry.GetCurrentNodeAlloc(), &registry.GetNodeAlloc(1));
+	Alloc::NumaAllocRegistry::SetCurrentNode(0);
+
+	registry.GetNodeAlloc(1).Deallocate(Move(small));
+	registry.GetNodeAlloc(1).Deallocate(Move(large));
+}
+
+TEST(NumaAllocatorTest, WorkerGroups)
+{
+	const NumaTopology topology = NumaTopology::CreateFake(2);
+	Alloc::NumaAllocRegistry registry{ topology, 1_GiB };
+
+	Atomic<u32> numWorkers[2] = { 0, 0 };
+	Atomic<u32> numWrongAlloc{ 0 };
+
+	// Workers allocate from the allocator of their node without being aware of it
+	auto workerFunc = [&](u32 node, u32 workerIdx) -> u32
+	{
+		UNUSED(workerIdx);
+		numWorkers[node].FetchAdd(1);
+
+		DynArray<u64> arr;
+		arr.Resize(1024, u64(node));
+		if (arr.GetAllocator() != &registry.GetNodeAlloc(node) || Alloc::NumaAllocRegistry::GetCurrentNode() != node)
+			numWrongAlloc.FetchAdd(1);
+		return 0;
+	};
+	const Threading::NumaWorkerGroups::WorkerFunc workerDelegate{ workerFunc };
+
+	Threading::NumaWorkerGroups groups{ topology, registry, 3, workerDelegate };
+	EXPECT_EQ(groups.GetNumWorkers(), 6);
+	groups.Join();
+
+	EXPECT_EQ(numWorkers[0].Load(), 3);
+	EXPECT_EQ(numWorkers[1].Load(), 3);
+	EXPECT_EQ(numWrongAlloc.Load(), 0);
+}
@@ -0,0 +1,212 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	constexpr usize StressBlockSize = 64;
+	constexpr usize StressNumBlocks = 1024;
+	constexpr u32 StressNumThreads = 8;
+	constexpr u32 StressIterations = 20'000;
+	constexpr u32 StressBatchSize = 32;
+
+	// Each thread repeatedly takes a batch of blocks, stamps them and verifies the stamp before returning them.
+	// A block that is given out to 2 threads at the same time ends up with a stamp that does not match.
+	template<typename Allocator>
+	auto RunPoolStress(Allocator& alloc) -> u32
+	{
+		Atomic<u32> nextId{ 0 };
+		Atomic<u32> numCorrupted{ 0 };
+
+		auto workerFunc = [&]() -> u32
+		{
+			const u64 id = nextId.FetchAdd(1) + 1;
+			MemRef<u64> blocks[StressBatchSize];
+			for (u32 it = 0; it < StressIterations; ++it)
+			{
+				const u64 stamp = (id << 32) | it;
+
+				u32 count = 0;
+				for (; count < StressBatchSize; ++count)
+				{
+					blocks[count] = alloc.template Allocate<u64>(StressBlockSize);
+					if (!blocks[count].IsValid())
+						break;
+
+					u64* pBlock = blocks[count].Ptr();
+					pBlock[0] = stamp;
+					pBlock[StressBlockSize / sizeof(u64) - 1] = stamp;
+				}
+
+				for (u32 i = 0; i < count; ++i)
+				{
+					const u64* pBlock = blocks[i].Ptr();
+					if (pBlock[0] != stamp || pBlock[StressBlockSize / sizeof(u64) - 1] != stamp)
+						numCorrupted.FetchAdd(1);
+					alloc.Deallocate(Move(blocks[i]));
+				}
+			}
+
+			alloc.FlushThreadCache();
+			return 0;
+		};
+		const Delegate<u32()> workerDelegate{ workerFunc };
+
+		DynArray<Threading::Thread> workers;
+		workers.Reserve(StressNumThreads);
+		for (u32 i = 0; i < StressNumThreads; ++i)
+		{
+			Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "PoolAllocator stress"_s }, workerDelegate);
+			EXPECT_FALSE(res.Failed());
+			if (res.Failed())
+				break;
+			workers.Add(res.MoveValue());
+		}
+
+		for (Threading::Thread& worker : workers)
+			worker.Join();
+		return numCorrupted.Load();
+	}
+
+	// All blocks need to be returned to the pool after the stress test, each exactly once
+	template<typename Allocator>
+	auto AllocateAll(Allocator& alloc, usize blockSize, usize numBlocks) -> bool
+	{
+		DynArray<MemRef<u8>> blocks;
+		blocks.Reserve(numBlocks);
+		for (usize i = 0; i < numBlocks; ++i)
+		{
+			MemRef<u8> mem = alloc.template Allocate<u8>(blockSize);
+			if (!mem.IsValid())
+				return false;
+			blocks.Add(Move(mem));
+		}
+
+		if (alloc.template Allocate<u8>(blockSize).IsValid())
+			return false;
+
+		u8* pBase = blocks[0].Ptr();
+		for (MemRef<u8>& mem : blocks)
+			pBase = Math::Min(pBase, mem.Ptr());
+
+		DynArray<u8> seen;
+		seen.Resize(numBlocks);
+		for (MemRef<u8>& mem : blocks)
+		{
+			const usize idx = usize(mem.Ptr() - pBase) / blockSize;
+			if (idx >= numBlocks || seen[idx])
+				return false;
+			seen[idx] = 1;
+		}
+
+		for (MemRef<u8>& mem : blocks)
+			alloc.Deallocate(Move(mem));
+		return true;
+	}
+
+	// Each thread leaves blocks behind in its cache and stays alive, while the calling thread needs to be able to allocate the whole pool
+	template<typename Allocator>
+	auto AllocateAllWithCachedBlocks(Allocator& alloc, usize blockSize, usize numBlocks) -> bool
+	{
+		constexpr u32 numThreads = 4;
+		constexpr u32 numCached = 8;
+
+		Atomic<u32> numReady{ 0 };
+		Atomic<bool> done{ false };
+		auto workerFunc = [&]() -> u32
+		{
+			MemRef<u8> blocks[numCached];
+			for (MemRef<u8>& mem : blocks)
+				mem = alloc.template Allocate<u8>(blockSize);
+			for (MemRef<u8>& mem : blocks)
+				alloc.Deallocate(Move(mem));
+
+			numReady.FetchAdd(1);
+			while (!done.Load())
+				;
+			return 0;
+		};
+		const Delegate<u32()> workerDelegate{ workerFunc };
+
+		DynArray<Threading::Thread> workers;
+		for (u32 i = 0; i < numThreads; ++i)
+		{
+			Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "PoolAllocator cache holder"_s }, workerDelegate);
+			EXPECT_FALSE(res.Failed());
+			if (res.Failed())
+				break;
+			workers.Add(res.MoveValue());
+		}
+
+		while (numReady.Load() != workers.Size())
+			;
+		const bool res = AllocateAll(alloc, blockSize, numBlocks);
+
+		done.Store(true);
+		for (Threading::Thread& worker : workers)
+			worker.Join();
+		return res;
+	}
+}
+
+TEST(PoolAllocatorTest, AllocateAll)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::PoolAllocator<64, 256> alloc{ &mallocator };
+	EXPECT_TRUE(AllocateAll(alloc, 64, 256));
+	EXPECT_TRUE(AllocateAll(alloc, 64, 256));
+}
+
+TEST(PoolAllocatorTest, DynamicAllocateAll)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::DynamicPoolAllocator alloc{ &mallocator, 128, 100 };
+	EXPECT_EQ(alloc.GetBlockSize(), 128);
+	EXPECT_EQ(alloc.GetNumBlocks(), 100);
+	EXPECT_TRUE(AllocateAll(alloc, 128, 100));
+}
+
+TEST(PoolAllocatorTest, ThreadCacheAllocateAll)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::PoolAllocator<64, 256> alloc{ &mallocator, 16 };
+	EXPECT_TRUE(AllocateAll(alloc, 64, 256));
+	alloc.FlushThreadCache();
+	EXPECT_TRUE(AllocateAll(alloc, 64, 256));
+}
+
+TEST(PoolAllocatorTest, ThreadCacheAllocateAllWithOtherThreadsCaching)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::PoolAllocator<64, 256> alloc{ &mallocator, 16 };
+	EXPECT_TRUE(AllocateAllWithCachedBlocks(alloc, 64, 256));
+	EXPECT_TRUE(AllocateAll(alloc, 64, 256));
+
+	Alloc::DynamicPoolAllocator dynAlloc{ &mallocator, 64, 100, 16 };
+	EXPECT_TRUE(AllocateAllWithCachedBlocks(dynAlloc, 64, 100));
+}
+
+TEST(PoolAllocatorTest, StressShared)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::PoolAllocator<StressBlockSize, StressNumBlocks> alloc{ &mallocator };
+	EXPECT_EQ(RunPoolStress(alloc), 0);
+	EXPECT_TRUE(AllocateAll(alloc, StressBlockSize, StressNumBlocks));
+}
+
+TEST(PoolAllocatorTest, StressThreadCache)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::PoolAllocator<StressBlockSize, StressNumBlocks> alloc{ &mallocator, 64 };
+	EXPECT_EQ(RunPoolStress(alloc), 0);
+	EXPECT_TRUE(AllocateAll(alloc, StressBlockSize, StressNumBlocks));
+}
+
+TEST(PoolAllocatorTest, DynamicStressThreadCache)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::DynamicPoolAllocator alloc{ &mallocator, StressBlockSize, StressNumBlocks, 64 };
+	EXPECT_EQ(RunPoolStress(alloc), 0);
+	EXPECT_TRUE(AllocateAll(alloc, StressBlockSize, StressNumBlocks));
+}
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(ReallocateTest, Mallocator)
+{
+	Alloc::Mallocator mallocator;
+	for (u16 align : { 1, 8, 64, 256 })
+	{
+		MemRef<u8> mem = mallocator.Allocate<u8>(100, align);
+		for (u8 i = 0; i < 100; ++i)
+			mem.Ptr()[i] = i;
+
+		ASSERT_TRUE(mallocator.Reallocate(mem, 1_MiB));
+		EXPECT_EQ(mem.Size(), 1_MiB);
+		EXPECT_EQ(usize(mem.Ptr()) % align, 0);
+		for (u8 i = 0; i < 100; ++i)
+			ASSERT_EQ(mem.Ptr()[i], i);
+
+		ASSERT_TRUE(mallocator.Reallocate(mem, 50));
+		EXPECT_EQ(mem.Size(), 50);
+		EXPECT_EQ(usize(mem.Ptr()) % align, 0);
+		for (u8 i = 0; i < 50; ++i)
+			ASSERT_EQ(mem.Ptr()[i], i);
+
+		mallocator.Deallocate(Move(mem));
+	}
+}
+
+TEST(ReallocateTest, LinearAllocator)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::LinearAllocator<1024, 16> alloc{ &mallocator };
+
+	MemRef<u8> a = alloc.Allocate<u8>(3);
+	MemRef<u8> b = alloc.Allocate<u8>(16, 16);
+	ASSERT_TRUE(b.IsValid());
+	EXPECT_EQ(usize(b.Ptr()) % 16, 0);
+
+	// Only the last allocation can grow in place
+	EXPECT_FALSE(alloc.TryExpandInPlace(a, 8));
+	u8* pB = b.Ptr();
+	EXPECT_TRUE(alloc.TryExpandInPlace(b, 512));
+	EXPECT_EQ(b.Ptr(), pB);
+	EXPECT_EQ(b.Size(), 512);
+	EXPECT_FALSE(alloc.TryExpandInPlace(b, 2048));
+
+	// Memory that can't grow is moved
+	a.Ptr()[2] = 42;
+	ASSERT_TRUE(alloc.Reallocate(a, 64));
+	EXPECT_GT(a.Ptr(), pB);
+	EXPECT_EQ(a.Ptr()[2], 42);
+}
+
+TEST(ReallocateTest, StackAllocator)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::StackAllocator<1024, 16> alloc{ &mallocator };
+
+	MemRef<u8> a = alloc.Allocate<u8>(5);
+	MemRef<u64> b = alloc.Allocate<u64>(24, 16);
+	ASSERT_TRUE(b.IsValid());
+	EXPECT_EQ(usize(b.Ptr()) % 16, 0);
+
+	EXPECT_FALSE(alloc.TryExpandInPlace(a, 64));
+	EXPECT_TRUE(alloc.TryExpandInPlace(b, 100));
+	EXPECT_FALSE(alloc.TryExpandInPlace(b, 1024));
+
+	// Deallocating the grown allocation returns all its memory
+	alloc.Deallocate(Move(b));
+	MemRef<u8> c = alloc.Allocate<u8>(1008);
+	EXPECT_TRUE(c.IsValid());
+	alloc.Deallocate(Move(c));
+	alloc.Deallocate(Move(a));
+}
+
+TEST(ReallocateTest, DynArrayRelocatable)
+{
+	STATIC_ASSERT(TriviallyRelocatable<u32>, "u32 should be trivially relocatable");
+	STATIC_ASSERT(TriviallyRelocatable<DynArray<u32>>, "DynArray should be trivially relocatable");
+	STATIC_ASSERT(TriviallyRelocatable<String>, "String should be trivially relocatable");
+
+	Alloc::Mallocator mallocator;
+	DynArray<DynArray<u32>> arr{ mallocator };
+	for (u32 i = 0; i < 1000; ++i)
+		arr.Add(DynArray<u32>{ 3, i, mallocator });
+
+	arr.Insert(usize(0), DynArray<u32>{ 1, 42u, mallocator });
+	arr.ShrinkToFit();
+	EXPECT_EQ(arr.Capacity(), arr.Size());
+
+	ASSERT_EQ(arr.Size(), 1001);
+	EXPECT_EQ(arr[0][0], 42);
+	for (u32 i = 0; i < 1000; ++i)
+	{
+		ASSERT_EQ(arr[i + 1].Size(), 3);
+		ASSERT_EQ(arr[i + 1][2], i);
+	}
+}
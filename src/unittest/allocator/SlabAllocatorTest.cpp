@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(SlabAllocatorTest, SizeClasses)
+{
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(0), 8);
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(9), 16);
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(100), 112);
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(1025), 1280);
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(16_KiB), 16_KiB);
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(16_KiB + 1), 0);
+
+	// Larger alignments use power of 2 size classes
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(24, 16), 32);
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(100, 64), 128);
+	EXPECT_EQ(Alloc::SlabAllocator::GetSizeClassSize(64, 4096), 0);
+
+	for (usize size = 1; size <= 16_KiB; ++size)
+		ASSERT_GE(Alloc::SlabAllocator::GetSizeClassSize(size), size);
+}
+
+TEST(SlabAllocatorTest, Allocate)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::SlabAllocator alloc{ &mallocator, 1_GiB };
+
+	DynArray<MemRef<u8>> allocs{ mallocator };
+	for (usize i = 0; i < 4096; ++i)
+	{
+		const usize size = 1 + (i * 37) % 2048;
+		const u16 align = u16(1 << (i % 7));
+		MemRef<u8> mem = alloc.Allocate<u8>(size, align);
+		ASSERT_TRUE(mem.IsValid());
+		EXPECT_EQ(usize(mem.Ptr()) % align, 0);
+		EXPECT_TRUE(alloc.Owns(mem));
+		MemSet(mem.Ptr(), u8(i), size);
+		allocs.Add(Move(mem));
+	}
+
+	for (usize i = 0; i < allocs.Size(); ++i)
+	{
+		const u8* ptr = allocs[i].Ptr();
+		for (usize j = 0; j < allocs[i].Size(); ++j)
+			ASSERT_EQ(ptr[j], u8(i));
+	}
+
+	// Large allocations go to the fallback allocator, but are still owned and deallocated by the slab allocator
+	MemRef<u8> large = alloc.Allocate<u8>(1_MiB);
+	ASSERT_TRUE(large.IsValid());
+	EXPECT_EQ(large.GetAlloc(), &alloc);
+	EXPECT_TRUE(alloc.Owns(large));
+
+	// Memory allocated from the fallback allocator by anyone else is not owned
+	MemRef<u8> foreign = mallocator.Allocate<u8>(1_MiB);
+	ASSERT_TRUE(foreign.IsValid());
+	EXPECT_FALSE(alloc.Owns(foreign));
+	mallocator.Deallocate(Move(foreign));
+
+	alloc.Deallocate(Move(large));
+
+	for (MemRef<u8>& mem : allocs)
+		alloc.Deallocate(Move(mem));
+
+	// Only a single empty slab is kept per size class, the other empty slabs are pooled
+	EXPECT_LE(alloc.GetNumSlabs(), Alloc::SlabAllocator::NumSizeClasses);
+	EXPECT_GT(alloc.GetNumPooledSlabs(), 0);
+
+	// Trimmed slabs are committed again when they are reused
+	const usize numPooled = alloc.GetNumPooledSlabs();
+	alloc.Trim();
+	for (MemRef<u8>& mem : allocs)
+	{
+		mem = alloc.Allocate<u8>(16_KiB);
+		ASSERT_TRUE(mem.IsValid());
+		MemSet(mem.Ptr(), 0, 16_KiB);
+	}
+	EXPECT_LT(alloc.GetNumPooledSlabs(), numPooled);
+	for (MemRef<u8>& mem : allocs)
+		alloc.Deallocate(Move(mem));
+}
+
+TEST(SlabAllocatorTest, GlobalAlloc)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::SlabAllocator alloc{ &mallocator, 1_GiB };
+	ScopedGlobalAlloc scope{ alloc };
+
+	// Containers created while the slab allocator is the global allocator allocate from it
+	DynArray<String> strings;
+	for (u32 i = 0; i < 1000; ++i)
+		strings.Add(String{ "slab allocated string " } + UCodepoint('0' + i % 10));
+	EXPECT_EQ(strings.GetAllocator(), &alloc);
+	EXPECT_EQ(strings[999], String{ "slab allocated string 9" });
+}
+
+TEST(SlabAllocatorTest, Stress)
+{
+	Alloc::Mallocator mallocator;
+	Alloc::SlabAllocator alloc{ &mallocator, 1_GiB };
+
+	Atomic<u32> nextId{ 0 };
+	Atomic<u32> numCorrupted{ 0 };
+
+	// Threads allocate and free objects of many size classes, stamping all of them with their id
+	auto workerFunc = [&]() -> u32
+	{
+		const u64 id = nextId.FetchAdd(1) + 1;
+		u64 rng = id * 0x9E3779B97F4A7C15;
+
+		MemRef<u64> allocs[64];
+		for (u32 it = 0; it < 5'000; ++it)
+		{
+			for (MemRef<u64>& mem : allocs)
+			{
+				rng ^= rng << 13;
+				rng ^= rng >> 7;
+				rng ^= rng << 17;
+
+				const usize size = 8 + (rng >> 8) % 1024;
+				mem = alloc.Allocate<u64>(size);
+				for (usize i = 0; i < size / sizeof(u64); ++i)
+					mem.Ptr()[i] = id;
+			}
+
+			for (MemRef<u64>& mem : allocs)
+			{
+				for (usize i = 0; i < mem.Size() / sizeof(u64); ++i)
+				{
+					if (mem.Ptr()[i] != id)
+					{
+						numCorrupted.FetchAdd(1);
+						break;
+					}
+				}
+				alloc.Deallocate(Move(mem));
+			}
+		}
+		return 0;
+	};
+	const Delegate<u32()> workerDelegate{ workerFunc };
+
+	DynArray<Threading::Thread> workers{ mallocator };
+	for (u32 i = 0; i < 8; ++i)
+	{
+		Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "SlabAllocator stress"_s }, workerDelegate);
+		ASSERT_FALSE(res.Failed());
+		workers.Add(res.MoveValue());
+	}
+	for (Threading::Thread& worker : workers)
+		worker.Join();
+
+	EXPECT_EQ(numCorrupted.Load(), 0);
+}
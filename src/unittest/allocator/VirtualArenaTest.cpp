@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(VirtualArenaTest, Allocate)
+{
+	Alloc::VirtualArena arena{ 64_MiB };
+	ASSERT_TRUE(arena.IsValid());
+	EXPECT_GE(arena.GetReservedSize(), 64_MiB);
+	EXPECT_EQ(arena.GetCommittedSize(), 0);
+
+	MemRef<u8> a = arena.Allocate<u8>(3);
+	MemRef<u64> b = arena.Allocate<u64>(sizeof(u64) * 4, 64);
+	ASSERT_TRUE(a.IsValid());
+	ASSERT_TRUE(b.IsValid());
+	EXPECT_EQ(usize(b.Ptr()) % 64, 0);
+	EXPECT_GT(arena.GetCommittedSize(), 0);
+
+	b.Ptr()[3] = 42;
+	EXPECT_TRUE(arena.Owns(a));
+	EXPECT_TRUE(arena.Owns(b));
+
+	// The last allocation is returned to the arena
+	const usize used = arena.GetUsedSize();
+	u64* pB = b.Ptr();
+	arena.Deallocate(Move(b));
+	EXPECT_LT(arena.GetUsedSize(), used);
+	MemRef<u64> c = arena.Allocate<u64>(sizeof(u64) * 4, 64);
+	EXPECT_EQ(c.Ptr(), pB);
+
+	EXPECT_FALSE(arena.Allocate<u8>(128_MiB).IsValid());
+}
+
+TEST(VirtualArenaTest, DynArrayGrowsInPlace)
+{
+	Alloc::VirtualArena arena{ 1_GiB };
+	DynArray<u32> arr{ arena };
+	arr.Add(0);
+	const u32* pData = arr.Data();
+
+	for (u32 i = 1; i < 4 * 1024 * 1024; ++i)
+		arr.Add(i);
+
+	EXPECT_EQ(arr.Data(), pData);
+	for (u32 i = 0; i < arr.Size(); ++i)
+		ASSERT_EQ(arr[i], i);
+}
+
+TEST(VirtualArenaTest, DecommitOnReset)
+{
+	Alloc::VirtualArena arena{ 64_MiB, Alloc::VirtualArenaFlag::DecommitOnReset };
+	MemRef<u8> mem = arena.Allocate<u8>(1_MiB);
+	ASSERT_TRUE(mem.IsValid());
+	mem.Ptr()[1_MiB - 1] = 1;
+	EXPECT_GE(arena.GetCommittedSize(), 1_MiB);
+
+	arena.Reset();
+	EXPECT_EQ(arena.GetUsedSize(), 0);
+	EXPECT_EQ(arena.GetCommittedSize(), 0);
+
+	// Memory is committed again on demand, starting out zeroed
+	mem = arena.Allocate<u8>(1_MiB);
+	ASSERT_TRUE(mem.IsValid());
+	EXPECT_EQ(mem.Ptr()[1_MiB - 1], 0);
+}
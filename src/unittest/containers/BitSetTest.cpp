@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	auto MakeBitSet(usize numBits, std::initializer_list<usize> setBits, Alloc::IAllocator& alloc) -> BitSet
+	{
+		BitSet bits{ numBits, alloc };
+		for (usize idx : setBits)
+			bits.Set(idx);
+		return bits;
+	}
+}
+
+TEST(BitSetTest, SetAndCount)
+{
+	Alloc::Mallocator mallocator;
+	BitSet bits{ 200, mallocator };
+	ASSERT_EQ(bits.NumBits(), 200);
+	EXPECT_TRUE(bits.None());
+	EXPECT_FALSE(bits.Any());
+	EXPECT_EQ(bits.Count(), 0);
+
+	bits.Set(0);
+	bits.Set(63);
+	bits.Set(64);
+	bits.Set(199);
+	bits.Set(200); // out of range, ignored
+	EXPECT_TRUE(bits[0]);
+	EXPECT_TRUE(bits[63]);
+	EXPECT_TRUE(bits[64]);
+	EXPECT_TRUE(bits[199]);
+	EXPECT_FALSE(bits[1]);
+	EXPECT_FALSE(bits[200]);
+	EXPECT_EQ(bits.Count(), 4);
+	EXPECT_TRUE(bits.Any());
+
+	bits.Unset(63);
+	EXPECT_FALSE(bits[63]);
+	EXPECT_EQ(bits.Count(), 3);
+
+	bits.Clear();
+	EXPECT_TRUE(bits.None());
+}
+
+TEST(BitSetTest, FlipAndAll)
+{
+	Alloc::Mallocator mallocator;
+	BitSet bits{ 70, mallocator };
+	EXPECT_FALSE(bits.All());
+
+	bits.Flip();
+	EXPECT_TRUE(bits.All());
+	EXPECT_EQ(bits.Count(), 70);
+
+	BitSet inverted = ~bits;
+	EXPECT_TRUE(inverted.None());
+	EXPECT_EQ(inverted.NumBits(), 70);
+
+	bits.Unset(69);
+	EXPECT_FALSE(bits.All());
+
+	BitSet empty{ mallocator };
+	EXPECT_TRUE(empty.All());
+	EXPECT_FALSE(empty.Any());
+}
+
+TEST(BitSetTest, Resize)
+{
+	Alloc::Mallocator mallocator;
+	BitSet bits{ 100, mallocator };
+	bits.Flip();
+
+	bits.Resize(70);
+	EXPECT_EQ(bits.NumBits(), 70);
+	EXPECT_EQ(bits.Count(), 70);
+
+	bits.Resize(300);
+	EXPECT_EQ(bits.NumBits(), 300);
+	EXPECT_EQ(bits.Count(), 70);
+	EXPECT_FALSE(bits[70]);
+	EXPECT_FALSE(bits[299]);
+}
+
+TEST(BitSetTest, BinaryOperators)
+{
+	Alloc::Mallocator mallocator;
+	// Large enough to use the bulk path
+	const BitSet a = MakeBitSet(600, { 0, 5, 64, 300, 511, 599 }, mallocator);
+	const BitSet b = MakeBitSet(400, { 5, 64, 65, 399 }, mallocator);
+
+	const BitSet orRes = a | b;
+	EXPECT_EQ(orRes.NumBits(), 600);
+	EXPECT_EQ(orRes, MakeBitSet(600, { 0, 5, 64, 65, 300, 399, 511, 599 }, mallocator));
+
+	const BitSet andRes = a & b;
+	EXPECT_EQ(andRes.NumBits(), 600);
+	EXPECT_EQ(andRes, MakeBitSet(600, { 5, 64 }, mallocator));
+
+	const BitSet xorRes = a ^ b;
+	EXPECT_EQ(xorRes, MakeBitSet(600, { 0, 65, 300, 399, 511, 599 }, mallocator));
+
+	// Smaller bitset on the left grows to the size of the right
+	const BitSet andRes2 = b & a;
+	EXPECT_EQ(andRes2, andRes);
+
+	BitSet diff = a;
+	diff.AndNot(b);
+	EXPECT_EQ(diff.NumBits(), 600);
+	EXPECT_EQ(diff, MakeBitSet(600, { 0, 300, 511, 599 }, mallocator));
+}
+
+TEST(BitSetTest, FusedCounts)
+{
+	Alloc::Mallocator mallocator;
+	const BitSet a = MakeBitSet(600, { 0, 5, 64, 300, 511, 599 }, mallocator);
+	const BitSet b = MakeBitSet(400, { 5, 64, 65, 399 }, mallocator);
+
+	EXPECT_EQ(a.AndCount(b), (a & b).Count());
+	EXPECT_EQ(a.OrCount(b), (a | b).Count());
+	EXPECT_EQ(a.XorCount(b), (a ^ b).Count());
+	EXPECT_EQ(a.AndNotCount(b), 4);
+	EXPECT_EQ(b.AndNotCount(a), 2);
+	EXPECT_EQ(b.OrCount(a), a.OrCount(b));
+	EXPECT_TRUE(a.Intersects(b));
+
+	const BitSet c = MakeBitSet(600, { 1, 2, 3 }, mallocator);
+	EXPECT_FALSE(a.Intersects(c));
+	EXPECT_EQ(a.AndCount(c), 0);
+}
+
+TEST(BitSetTest, FindAndIterate)
+{
+	Alloc::Mallocator mallocator;
+	const BitSet bits = MakeBitSet(500, { 3, 63, 64, 200, 499 }, mallocator);
+
+	EXPECT_EQ(bits.FindFirst(), 3);
+	EXPECT_EQ(bits.FindNext(3), 63);
+	EXPECT_EQ(bits.FindNext(63), 64);
+	EXPECT_EQ(bits.FindNext(64), 200);
+	EXPECT_EQ(bits.FindNext(100), 200);
+	EXPECT_EQ(bits.FindNext(200), 499);
+	EXPECT_EQ(bits.FindNext(499), BitSet::NPos);
+
+	DynArray<usize> found{ mallocator };
+	bits.ForEachSetBit([&found](usize idx) { found.Add(idx); });
+	ASSERT_EQ(found.Size(), 5);
+	EXPECT_EQ(found[0], 3);
+	EXPECT_EQ(found[1], 63);
+	EXPECT_EQ(found[2], 64);
+	EXPECT_EQ(found[3], 200);
+	EXPECT_EQ(found[4], 499);
+
+	BitSet empty{ 100, mallocator };
+	EXPECT_EQ(empty.FindFirst(), BitSet::NPos);
+}
+
+TEST(BitSetTest, RankSelect)
+{
+	Alloc::Mallocator mallocator;
+	BitSet bits{ 3000, mallocator };
+	DynArray<usize> setBits{ mallocator };
+	for (usize i = 0; i < 3000; i += 7)
+	{
+		bits.Set(i);
+		setBits.Add(i);
+	}
+
+	RankSelectIndex index{ bits, mallocator };
+	ASSERT_EQ(index.Count(), setBits.Size());
+
+	for (usize i = 0; i < setBits.Size(); ++i)
+	{
+		EXPECT_EQ(index.Select(i), setBits[i]);
+		EXPECT_EQ(index.Rank(setBits[i]), i);
+		EXPECT_EQ(index.Rank(setBits[i] + 1), i + 1);
+	}
+	EXPECT_EQ(index.Select(setBits.Size()), RankSelectIndex::NPos);
+	EXPECT_EQ(index.Rank(0), 0);
+	EXPECT_EQ(index.Rank(3000), setBits.Size());
+}
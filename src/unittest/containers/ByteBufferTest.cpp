@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+TEST(ByteBufferTest, WriteCursor)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::ByteBuffer buffer{ mallocator };
+	ASSERT_EQ(buffer.GetCursor(), 0);
+	ASSERT_TRUE(buffer.IsEmpty());
+
+	buffer.Write(0x01234567u);
+	ASSERT_EQ(buffer.GetCursor(), 4);
+	ASSERT_EQ(buffer.Size(), 4);
+
+	buffer.Write(0x89ABCDEFu);
+	buffer.Write(u64(0x0123456789ABCDEF));
+	ASSERT_EQ(buffer.GetCursor(), 16);
+	ASSERT_EQ(buffer.Size(), 16);
+
+	// Writing before the end overwrites the existing data
+	buffer.Seek(0);
+	buffer.Write(0x76543210u);
+	ASSERT_EQ(buffer.GetCursor(), 4);
+	ASSERT_EQ(buffer.Size(), 16);
+	ASSERT_EQ(buffer.Peek<u32>(), 0x89ABCDEFu);
+}
+
+TEST(ByteBufferTest, ReadSequential)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::ByteBuffer buffer{ mallocator };
+	buffer.Write(0x01234567u);
+	buffer.Write(0x89ABCDEFu);
+	buffer.Write(u64(0xFEDCBA9876543210));
+	buffer.Write(1.5f);
+	buffer.Write(u16(0xBEEF));
+	buffer.Write(u8(0x12));
+	buffer.Write(u8(0x34));
+	ASSERT_EQ(buffer.Size(), 24);
+
+	// Each read continues right after the previous value
+	buffer.Seek(0);
+	ASSERT_EQ(buffer.Read<u32>(), 0x01234567u);
+	ASSERT_EQ(buffer.GetCursor(), 4);
+	ASSERT_EQ(buffer.Read<u32>(), 0x89ABCDEFu);
+	ASSERT_EQ(buffer.GetCursor(), 8);
+	ASSERT_EQ(buffer.Read<u64>(), 0xFEDCBA9876543210);
+	ASSERT_EQ(buffer.GetCursor(), 16);
+	ASSERT_EQ(buffer.Read<f32>(), 1.5f);
+	ASSERT_EQ(buffer.GetCursor(), 20);
+	ASSERT_EQ(buffer.Read<u16>(), 0xBEEF);
+	ASSERT_EQ(buffer.GetCursor(), 22);
+	ASSERT_EQ(buffer.Read<u8>(), 0x12);
+	ASSERT_EQ(buffer.Read<u8>(), 0x34);
+	ASSERT_EQ(buffer.GetCursor(), buffer.Size());
+}
+
+TEST(ByteBufferTest, ReadWithOffset)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::ByteBuffer buffer{ mallocator };
+	buffer.Write(0x01234567u);
+	buffer.Write(0x89ABCDEFu);
+	buffer.Write(0x76543210u);
+	buffer.Write(0xFEDCBA98u);
+
+	// The offset is skipped, the cursor ends up past the read value
+	buffer.Seek(0);
+	ASSERT_EQ(buffer.Read<u32>(4), 0x89ABCDEFu);
+	ASSERT_EQ(buffer.GetCursor(), 8);
+	ASSERT_EQ(buffer.Read<u32>(), 0x76543210u);
+	ASSERT_EQ(buffer.GetCursor(), 12);
+}
+
+TEST(ByteBufferTest, Peek)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::ByteBuffer buffer{ mallocator };
+	buffer.Write(0x01234567u);
+	buffer.Write(0x89ABCDEFu);
+	buffer.Write(0x76543210u);
+
+	buffer.Seek(4);
+	ASSERT_EQ(buffer.Peek<u32>(), 0x89ABCDEFu);
+	ASSERT_EQ(buffer.Peek<u32>(4), 0x76543210u);
+	ASSERT_EQ(buffer.GetCursor(), 4);
+
+	// Peeking and reading the same value agree, only reading advances the cursor
+	ASSERT_EQ(buffer.Read<u32>(), 0x89ABCDEFu);
+	ASSERT_EQ(buffer.Peek<u32>(), 0x76543210u);
+	ASSERT_EQ(buffer.GetCursor(), 8);
+}
+
+TEST(ByteBufferTest, Seek)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::ByteBuffer buffer{ mallocator };
+	buffer.Write(0x01234567u);
+	buffer.Write(0x89ABCDEFu);
+
+	buffer.Seek(4);
+	ASSERT_EQ(buffer.GetCursor(), 4);
+	ASSERT_EQ(buffer.Read<u32>(), 0x89ABCDEFu);
+
+	// Seeking past the end clamps to the end
+	buffer.Seek(100);
+	ASSERT_EQ(buffer.GetCursor(), buffer.Size());
+}
@@ -0,0 +1,390 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	/**
+	 * Run a number of worker threads until all of them finished
+	 * \param[in] numThreads Number of threads
+	 * \param[in] workerFunc Function ran by the threads, receives the index of the thread
+	 */
+	template<typename F>
+	void RunThreads(u32 numThreads, F workerFunc)
+	{
+		Atomic<u32> nextIdx{ 0 };
+		auto threadFunc = [&]() -> u32
+		{
+			workerFunc(nextIdx.FetchAdd(1));
+			return 0;
+		};
+		const Delegate<u32()> threadDelegate{ threadFunc };
+
+		DynArray<Threading::Thread> workers;
+		for (u32 i = 0; i < numThreads; ++i)
+		{
+			Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "Concurrent container test"_s }, threadDelegate);
+			ASSERT_FALSE(res.Failed());
+			workers.Add(res.MoveValue());
+		}
+		for (Threading::Thread& worker : workers)
+			worker.Join();
+	}
+
+	struct MpscElem
+	{
+		MpscElem(u32 producer, u32 idx) : node(offsetof(MpscElem, node)), producer(producer), idx(idx) {}
+
+		IntrusiveListNode<MpscElem> node;
+		u32                         producer;
+		u32                         idx;
+	};
+}
+
+TEST(SpscRingTest, PushPop)
+{
+	SpscRing<u32, 4> ring;
+	EXPECT_TRUE(ring.IsEmpty());
+	EXPECT_FALSE(ring.TryPop());
+
+	// Wrap around the ring a few times
+	for (u32 round = 0; round < 3; ++round)
+	{
+		for (u32 i = 0; i < 4; ++i)
+			EXPECT_TRUE(ring.TryPush(round * 4 + i));
+		EXPECT_FALSE(ring.TryPush(100u));
+		EXPECT_EQ(ring.SizeApprox(), 4);
+
+		for (u32 i = 0; i < 4; ++i)
+		{
+			Optional<u32> val = ring.TryPop();
+			ASSERT_TRUE(val);
+			EXPECT_EQ(*val, round * 4 + i);
+		}
+		EXPECT_TRUE(ring.IsEmpty());
+	}
+}
+
+TEST(SpscRingTest, NonTrivial)
+{
+	SpscRing<String, 8> ring;
+	EXPECT_TRUE(ring.TryEmplace("first"_s));
+	EXPECT_TRUE(ring.TryPush("second"_s));
+	EXPECT_TRUE(ring.TryPush("third"_s));
+
+	Optional<String> val = ring.TryPop();
+	ASSERT_TRUE(val);
+	EXPECT_EQ(*val, "first"_s);
+	// Remaining elements are destroyed with the ring
+}
+
+TEST(SpscRingTest, Threaded)
+{
+	constexpr u32 NumElems = 200'000;
+	SpscRing<u32, 256> ring;
+	Atomic<u32> numOutOfOrder{ 0 };
+
+	RunThreads(2, [&](u32 idx)
+	{
+		if (idx == 0)
+		{
+			for (u32 i = 0; i < NumElems;)
+			{
+				if (ring.TryPush(i))
+					++i;
+			}
+		}
+		else
+		{
+			for (u32 expected = 0; expected < NumElems;)
+			{
+				if (Optional<u32> val = ring.TryPop())
+				{
+					if (*val != expected)
+						numOutOfOrder.FetchAdd(1);
+					++expected;
+				}
+			}
+		}
+	});
+
+	EXPECT_EQ(numOutOfOrder.Load(), 0);
+	EXPECT_TRUE(ring.IsEmpty());
+}
+
+TEST(MpmcQueueTest, PushPop)
+{
+	MpmcQueue<u32> queue{ 5 };
+	EXPECT_EQ(queue.Capacity(), 8);
+	EXPECT_TRUE(queue.IsEmpty());
+	EXPECT_FALSE(queue.TryPop());
+
+	for (u32 round = 0; round < 3; ++round)
+	{
+		for (u32 i = 0; i < 8; ++i)
+			EXPECT_TRUE(queue.TryPush(round * 8 + i));
+		EXPECT_FALSE(queue.TryPush(100u));
+		EXPECT_EQ(queue.SizeApprox(), 8);
+
+		for (u32 i = 0; i < 8; ++i)
+		{
+			Optional<u32> val = queue.TryPop();
+			ASSERT_TRUE(val);
+			EXPECT_EQ(*val, round * 8 + i);
+		}
+		EXPECT_TRUE(queue.IsEmpty());
+	}
+
+	MpmcQueue<String> strings{ 4 };
+	EXPECT_TRUE(strings.TryEmplace("left behind"_s));
+}
+
+TEST(MpmcQueueTest, Threaded)
+{
+	constexpr u32 NumProducers = 4;
+	constexpr u32 NumConsumers = 4;
+	constexpr u32 NumElemsPerProducer = 50'000;
+	MpmcQueue<u64> queue{ 1024 };
+	Atomic<u64> sum{ 0 };
+	Atomic<u32> numPopped{ 0 };
+
+	RunThreads(NumProducers + NumConsumers, [&](u32 idx)
+	{
+		if (idx < NumProducers)
+		{
+			for (u32 i = 0; i < NumElemsPerProducer;)
+			{
+				if (queue.TryPush(u64(i) + 1))
+					++i;
+			}
+		}
+		else
+		{
+			u64 localSum = 0;
+			while (numPopped.Load(MemOrder::Relaxed) < NumProducers * NumElemsPerProducer)
+			{
+				if (Optional<u64> val = queue.TryPop())
+				{
+					localSum += *val;
+					numPopped.FetchAdd(1);
+				}
+			}
+			sum.FetchAdd(localSum);
+		}
+	});
+
+	constexpr u64 expectedSum = u64(NumElemsPerProducer) * (NumElemsPerProducer + 1) / 2 * NumProducers;
+	EXPECT_EQ(numPopped.Load(), NumProducers * NumElemsPerProducer);
+	EXPECT_EQ(sum.Load(), expectedSum);
+	EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(MpscQueueTest, PushPop)
+{
+	MpscQueue<MpscElem> queue;
+	EXPECT_TRUE(queue.IsEmpty());
+	EXPECT_EQ(queue.TryPop(), nullptr);
+
+	MpscElem elems[] = { { 0, 0 }, { 0, 1 }, { 0, 2 } };
+	for (MpscElem& elem : elems)
+		queue.Push(elem.node);
+	EXPECT_FALSE(queue.IsEmpty());
+
+	for (MpscElem& elem : elems)
+		EXPECT_EQ(queue.TryPop(), &elem);
+	EXPECT_EQ(queue.TryPop(), nullptr);
+	EXPECT_TRUE(queue.IsEmpty());
+
+	// Elements can be pushed again after they were popped
+	queue.Push(elems[1].node);
+	EXPECT_EQ(queue.TryPop(), &elems[1]);
+	EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(MpscQueueTest, Threaded)
+{
+	constexpr u32 NumProducers = 4;
+	constexpr u32 NumElemsPerProducer = 20'000;
+
+	DynArray<MpscElem> elems;
+	elems.Reserve(NumProducers * NumElemsPerProducer);
+	for (u32 producer = 0; producer < NumProducers; ++producer)
+	{
+		for (u32 i = 0; i < NumElemsPerProducer; ++i)
+			elems.EmplaceBack(producer, i);
+	}
+
+	MpscQueue<MpscElem> queue;
+	u32 nextIdx[NumProducers] = {};
+	u32 numOutOfOrder = 0;
+
+	RunThreads(NumProducers + 1, [&](u32 idx)
+	{
+		if (idx < NumProducers)
+		{
+			for (u32 i = 0; i < NumElemsPerProducer; ++i)
+				queue.Push(elems[idx * NumElemsPerProducer + i].node);
+		}
+		else
+		{
+			// Elements of a single producer are popped in the order they were pushed
+			for (u32 numPopped = 0; numPopped < NumProducers * NumElemsPerProducer;)
+			{
+				if (MpscElem* pElem = queue.TryPop())
+				{
+					if (pElem->idx != nextIdx[pElem->producer])
+						++numOutOfOrder;
+					nextIdx[pElem->producer] = pElem->idx + 1;
+					++numPopped;
+				}
+			}
+		}
+	});
+
+	EXPECT_EQ(numOutOfOrder, 0);
+	for (u32 producer = 0; producer < NumProducers; ++producer)
+		EXPECT_EQ(nextIdx[producer], NumElemsPerProducer);
+	EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(WorkStealingDequeTest, PushPopSteal)
+{
+	WorkStealingDeque<u32> deque{ 4 };
+	EXPECT_TRUE(deque.IsEmpty());
+	EXPECT_FALSE(deque.Pop());
+	EXPECT_FALSE(deque.Steal());
+
+	// Grow past the initial capacity
+	for (u32 i = 0; i < 10; ++i)
+		deque.Push(i);
+	EXPECT_EQ(deque.SizeApprox(), 10);
+	EXPECT_EQ(deque.Capacity(), 16);
+
+	// The owner pops the newest elements, thieves steal the oldest
+	EXPECT_EQ(deque.Pop(), 9u);
+	EXPECT_EQ(deque.Steal(), 0u);
+	EXPECT_EQ(deque.Steal(), 1u);
+	EXPECT_EQ(deque.Pop(), 8u);
+
+	for (u32 i = 2; i < 8; ++i)
+		EXPECT_EQ(deque.Steal(), i);
+	EXPECT_FALSE(deque.Steal());
+	EXPECT_FALSE(deque.Pop());
+	EXPECT_TRUE(deque.IsEmpty());
+
+	deque.Push(42);
+	EXPECT_EQ(deque.Pop(), 42u);
+	EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(WorkStealingDequeTest, Threaded)
+{
+	constexpr u32 NumThieves = 3;
+	constexpr u32 NumElems = 100'000;
+	WorkStealingDeque<u64> deque{ 64 };
+	Atomic<u64> sum{ 0 };
+	Atomic<u32> numTaken{ 0 };
+
+	RunThreads(NumThieves + 1, [&](u32 idx)
+	{
+		u64 localSum = 0;
+		u32 localTaken = 0;
+		if (idx == 0)
+		{
+			// The owner keeps pushing, and takes back some of its own work along the way
+			for (u32 i = 0; i < NumElems; ++i)
+			{
+				deque.Push(u64(i) + 1);
+				if (i % 4 == 0)
+				{
+					if (Optional<u64> val = deque.Pop())
+					{
+						localSum += *val;
+						++localTaken;
+					}
+				}
+			}
+			while (Optional<u64> val = deque.Pop())
+			{
+				localSum += *val;
+				++localTaken;
+			}
+			numTaken.FetchAdd(localTaken);
+		}
+		else
+		{
+			while (numTaken.Load(MemOrder::Relaxed) < NumElems)
+			{
+				if (Optional<u64> val = deque.Steal())
+				{
+					localSum += *val;
+					numTaken.FetchAdd(1);
+				}
+			}
+		}
+		sum.FetchAdd(localSum);
+	});
+
+	constexpr u64 expectedSum = u64(NumElems) * (NumElems + 1) / 2;
+	EXPECT_EQ(numTaken.Load(), NumElems);
+	EXPECT_EQ(sum.Load(), expectedSum);
+	EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(ConcurrentHashMapTest, InsertFindErase)
+{
+	ConcurrentHashMap<u32, String> map{ 6 };
+	EXPECT_EQ(map.GetShardCount(), 8);
+	EXPECT_TRUE(map.IsEmpty());
+
+	EXPECT_TRUE(map.Insert(1u, "one"_s));
+	EXPECT_TRUE(map.Insert(2u, "two"_s));
+	EXPECT_FALSE(map.Insert(2u, "TWO"_s));
+	EXPECT_FALSE(map.TryInsert(1u, "ONE"_s));
+	EXPECT_TRUE(map.TryInsert(3u, "three"_s));
+	EXPECT_EQ(map.Size(), 3);
+
+	EXPECT_EQ(map.At(1u), "one"_s);
+	EXPECT_EQ(map.At(2u), "TWO"_s);
+	EXPECT_FALSE(map.At(4u));
+	EXPECT_TRUE(map.Contains(3u));
+
+	EXPECT_TRUE(map.Update(3u, [](String& val) { val += "!"_s; }));
+	EXPECT_FALSE(map.Update(4u, [](String& val) { val += "!"_s; }));
+	EXPECT_EQ(map.At(3u), "three!"_s);
+
+	EXPECT_TRUE(map.Erase(1u));
+	EXPECT_FALSE(map.Erase(1u));
+	EXPECT_FALSE(map.Contains(1u));
+
+	u32 keySum = 0;
+	map.ForEach([&](const u32& key, const String&) { keySum += key; });
+	EXPECT_EQ(keySum, 5);
+
+	map.Clear();
+	EXPECT_TRUE(map.IsEmpty());
+}
+
+TEST(ConcurrentHashMapTest, Threaded)
+{
+	constexpr u32 NumThreads = 8;
+	constexpr u32 NumKeys = 4'096;
+	ConcurrentHashMap<u32, u32> map;
+
+	// Every thread inserts the same keys, and increments a counter per key
+	RunThreads(NumThreads, [&](u32 idx)
+	{
+		for (u32 i = 0; i < NumKeys; ++i)
+		{
+			const u32 key = (i + idx * 97) % NumKeys;
+			map.TryInsert(key, 0u);
+			map.Update(key, [](u32& val) { ++val; });
+		}
+	});
+
+	EXPECT_EQ(map.Size(), NumKeys);
+	u32 numWrong = 0;
+	map.ForEach([&](const u32&, const u32& val) { numWrong += val != NumThreads; });
+	EXPECT_EQ(numWrong, 0);
+}
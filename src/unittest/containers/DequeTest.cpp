@@ -1,6 +1,41 @@
 #include "gtest/gtest.h"
 #include "core/Core.h"
 
+namespace
+{
+	// Hands out memory as its own, so block deallocations can be counted as well
+	class DequeCountingAlloc final : public Core::Alloc::IAllocator
+	{
+	public:
+		u32 numAllocs = 0;
+		u32 numDeallocs = 0;
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> Core::MemRef<u8> override
+		{
+			++numAllocs;
+			const Core::MemRef<u8> mem = m_mallocator.Allocate<u8>(size, align, isBacking);
+			return { mem.Ptr(), this, Core::Math::Log2(align), size, isBacking };
+		}
+
+		void DeallocateRaw(Core::MemRef<u8>&& mem) noexcept override
+		{
+			++numDeallocs;
+			m_mallocator.Deallocate(Core::MemRef<u8>{ mem.Ptr(), &m_mallocator, Core::Math::Log2(mem.Align()), mem.Size(), mem.IsBackingMem() });
+		}
+
+	private:
+		Core::Alloc::Mallocator m_mallocator;
+	};
+
+	struct DequeTracked
+	{
+		i32* pNumDestructed;
+
+		~DequeTracked() noexcept { ++*pNumDestructed; }
+	};
+}
+
 TEST(DequeTest, DefaultInit)
 {
 	Core::Alloc::Mallocator mallocator;
@@ -604,6 +639,8 @@ TEST(DequeTest, Pop)
 
 	ASSERT_EQ(deque[0], 0);
 	ASSERT_EQ(deque[4], 4);
+	ASSERT_EQ(deque.Front(), 0);
+	ASSERT_EQ(deque.Back(), 4);
 }
 
 TEST(DequeTest, PopFront)
@@ -619,6 +656,8 @@ TEST(DequeTest, PopFront)
 
 	ASSERT_EQ(deque[0], 1);
 	ASSERT_EQ(deque[4], 5);
+	ASSERT_EQ(deque.Front(), 1);
+	ASSERT_EQ(deque.Back(), 5);
 }
 
 TEST(DequeTest, Erase)
@@ -686,4 +725,224 @@ TEST(DequeTest, AtOutOfBounds)
 	Core::Deque<u32> deque({ 0, 1, 2, 3, 4, 5, 6 }, mallocator);
 
 	ASSERT_EQ(deque.At(10), std::nullopt);
-}
\ No newline at end of file
+}
+
+TEST(DequeTest, BlockSize)
+{
+	struct Large { u8 data[1024]; };
+
+	ASSERT_EQ(Core::Deque<u64>::ElemsPerBlock, 512);
+	ASSERT_EQ(Core::Deque<u32>::ElemsPerBlock, 1024);
+	ASSERT_EQ(Core::Deque<Large>::ElemsPerBlock, 16);
+	ASSERT_EQ((Core::Deque<u64, 8>::ElemsPerBlock), 8);
+}
+
+TEST(DequeTest, BulkPushPopFront)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Deque<u32, 4> deque{ mallocator };
+
+	u32 src[11] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	deque.Push(3u);
+	deque.Push(src, 11);
+	ASSERT_EQ(deque.Size(), 12);
+	ASSERT_EQ(deque[0], 3);
+	ASSERT_EQ(deque[1], 0);
+	ASSERT_EQ(deque[11], 10);
+
+	deque.PopFront(6);
+	ASSERT_EQ(deque.Size(), 6);
+	ASSERT_EQ(deque.Front(), 5);
+	ASSERT_EQ(deque.Back(), 10);
+
+	deque.Pop(2);
+	ASSERT_EQ(deque.Size(), 4);
+	ASSERT_EQ(deque.Back(), 8);
+
+	deque.PopFront(4);
+	EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(DequeTest, QueueReusesBlocks)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Deque<u32, 4> deque{ mallocator };
+
+	// Use the deque as a FIFO queue, blocks that are freed at the front get reused at the back
+	u32 next = 0;
+	for (u32 i = 0; i < 100; ++i)
+	{
+		deque.Push(i * 2);
+		deque.Push(i * 2 + 1);
+		ASSERT_EQ(deque.Front(), next);
+		deque.PopFront();
+		++next;
+	}
+	ASSERT_EQ(deque.Size(), 100);
+	for (u32 i = 0; i < 100; ++i)
+		ASSERT_EQ(deque[i], 100 + i);
+
+	deque.Clear(false);
+	deque.PushFront(1u);
+	deque.PushFront(0u);
+	deque.Push(2u);
+	ASSERT_EQ(deque.Size(), 3);
+	ASSERT_EQ(deque[0], 0);
+	ASSERT_EQ(deque[2], 2);
+}
+
+TEST(DequeTest, PushFrontAcrossBlocks)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Deque<u32, 4> deque{ mallocator };
+	for (u32 i = 0; i < 10; ++i)
+		deque.Push(i);
+	deque.PopFront(5);
+	deque.Pop(3);
+
+	// Grows at the front into the spare blocks
+	for (u32 i = 0; i < 20; ++i)
+		deque.PushFront(100 + i);
+	ASSERT_EQ(deque.Size(), 22);
+	ASSERT_EQ(deque[0], 119);
+	ASSERT_EQ(deque[19], 100);
+	ASSERT_EQ(deque[20], 5);
+	ASSERT_EQ(deque[21], 6);
+}
+
+TEST(DequeTest, EraseAcrossBlocks)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Deque<u32, 4> deque{ mallocator };
+	for (u32 i = 0; i < 20; ++i)
+		deque.Push(i);
+
+	// Closer to the back
+	deque.Erase(deque.IteratorAt(12), 5);
+	ASSERT_EQ(deque.Size(), 15);
+	ASSERT_EQ(deque[11], 11);
+	ASSERT_EQ(deque[12], 17);
+	ASSERT_EQ(deque[14], 19);
+
+	// Closer to the front
+	deque.Erase(deque.IteratorAt(1), 6);
+	ASSERT_EQ(deque.Size(), 9);
+	ASSERT_EQ(deque[0], 0);
+	ASSERT_EQ(deque[1], 7);
+	ASSERT_EQ(deque[8], 19);
+}
+
+TEST(DequeTest, BulkNonTrivial)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Deque<Core::DynArray<u32>, 4> deque{ mallocator };
+
+	Core::DynArray<u32> src[6] = { Core::DynArray<u32>{ { 0u } }, Core::DynArray<u32>{ { 1u } }, Core::DynArray<u32>{ { 2u } },
+	                               Core::DynArray<u32>{ { 3u } }, Core::DynArray<u32>{ { 4u } }, Core::DynArray<u32>{ { 5u } } };
+	deque.Push(src, 6);
+	deque.Push(src, 6);
+	ASSERT_EQ(deque.Size(), 12);
+	ASSERT_EQ(deque[7][0], 1);
+
+	deque.Erase(deque.IteratorAt(2), 3);
+	ASSERT_EQ(deque.Size(), 9);
+	ASSERT_EQ(deque[2][0], 5);
+
+	deque.PopFront(5);
+	ASSERT_EQ(deque.Front()[0], 2);
+	deque.Pop(2);
+	ASSERT_EQ(deque.Back()[0], 3);
+}
+
+TEST(DequeTest, PopDestructsElements)
+{
+	Core::Alloc::Mallocator mallocator;
+	i32 numDestructed = 0;
+	{
+		Core::Deque<DequeTracked, 4> deque{ mallocator };
+		for (u32 i = 0; i < 10; ++i)
+			deque.Push(DequeTracked{ &numDestructed });
+		numDestructed = 0;
+
+		deque.Pop();
+		ASSERT_EQ(numDestructed, 1);
+		deque.PopFront();
+		ASSERT_EQ(numDestructed, 2);
+		for (u32 i = 0; i < 3; ++i)
+			deque.Pop();
+		ASSERT_EQ(numDestructed, 5);
+		for (u32 i = 0; i < 2; ++i)
+			deque.PopFront();
+		ASSERT_EQ(numDestructed, 7);
+
+		deque.Clear(false);
+		ASSERT_EQ(numDestructed, 10);
+		ASSERT_TRUE(deque.IsEmpty());
+	}
+	// Cleared elements are not destructed again
+	ASSERT_EQ(numDestructed, 10);
+}
+
+TEST(DequeTest, ClearDestructsElements)
+{
+	Core::Alloc::Mallocator mallocator;
+	i32 numDestructed = 0;
+	{
+		Core::Deque<DequeTracked, 4> deque{ mallocator };
+		for (u32 i = 0; i < 10; ++i)
+			deque.Push(DequeTracked{ &numDestructed });
+		for (u32 i = 0; i < 3; ++i)
+			deque.PopFront();
+		numDestructed = 0;
+
+		deque.Clear(true);
+		ASSERT_EQ(numDestructed, 7);
+	}
+	ASSERT_EQ(numDestructed, 7);
+}
+
+TEST(DequeTest, PopAcrossBlocksReleasesAllBlocks)
+{
+	DequeCountingAlloc alloc;
+	{
+		Core::Deque<u32, 4> deque{ alloc };
+		for (u32 i = 0; i < 16; ++i)
+			deque.Push(i);
+
+		// Popping back across block boundaries keeps the blocks around for reuse, they still need to be released on clear
+		for (u32 i = 0; i < 10; ++i)
+			deque.Pop();
+		ASSERT_EQ(deque.Size(), 6);
+		ASSERT_EQ(deque.Back(), 5);
+
+		for (u32 i = 0; i < 10; ++i)
+			deque.Push(100 + i);
+		ASSERT_EQ(deque.Size(), 16);
+		ASSERT_EQ(deque[5], 5);
+		ASSERT_EQ(deque[6], 100);
+		ASSERT_EQ(deque[15], 109);
+
+		deque.Clear(true);
+		ASSERT_EQ(alloc.numAllocs, alloc.numDeallocs);
+	}
+	ASSERT_EQ(alloc.numAllocs, alloc.numDeallocs);
+}
+
+TEST(DequeTest, DestructorReleasesAllBlocks)
+{
+	DequeCountingAlloc alloc;
+	{
+		Core::Deque<u32, 4> deque{ alloc };
+		for (u32 i = 0; i < 32; ++i)
+			deque.Push(i);
+		for (u32 i = 0; i < 10; ++i)
+			deque.PopFront();
+		for (u32 i = 0; i < 12; ++i)
+			deque.Pop();
+		ASSERT_EQ(deque.Size(), 10);
+		ASSERT_EQ(deque.Front(), 10);
+		ASSERT_EQ(deque.Back(), 19);
+	}
+	ASSERT_GT(alloc.numAllocs, 0);
+	ASSERT_EQ(alloc.numAllocs, alloc.numDeallocs);
+}
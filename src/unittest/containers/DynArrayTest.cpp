@@ -654,4 +654,49 @@ TEST(DynArrayTest, AtOutOfBounds)
 	Core::DynArray<u32> dynArr({ 0, 1, 2, 3, 4, 5, 6 }, mallocator);
 	
 	ASSERT_EQ(dynArr.At(10), std::nullopt);
-}
\ No newline at end of file
+}
+
+TEST(DynArrayTest, IteratorAssignCopiesAllBytes)
+{
+	Core::Alloc::Mallocator mallocator;
+	const u64 src[3] = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x0F1E2D3C4B5A6978 };
+	const u64* pSrc = src;
+	Core::DynArray<u64> dynArr{ mallocator };
+	dynArr.Assign(pSrc, pSrc + 3);
+
+	ASSERT_EQ(dynArr.Size(), 3);
+	ASSERT_EQ(dynArr[0], src[0]);
+	ASSERT_EQ(dynArr[1], src[1]);
+	ASSERT_EQ(dynArr[2], src[2]);
+}
+
+TEST(DynArrayTest, MovedFromOtherWithAllocCopiesAllBytes)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Alloc::Mallocator otherMallocator;
+	Core::DynArray<u64> src{ { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x0F1E2D3C4B5A6978 }, mallocator };
+	Core::DynArray<u64> dynArr{ Move(src), otherMallocator };
+
+	ASSERT_EQ(dynArr.GetAllocator(), &otherMallocator);
+	ASSERT_EQ(dynArr.Size(), 3);
+	ASSERT_EQ(dynArr[0], 0x0123456789ABCDEF);
+	ASSERT_EQ(dynArr[1], 0xFEDCBA9876543210);
+	ASSERT_EQ(dynArr[2], 0x0F1E2D3C4B5A6978);
+	EXPECT_TRUE(src.IsEmpty());
+}
+
+TEST(DynArrayTest, ShrinkToFitCopiesAllBytes)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::DynArray<u64> dynArr{ 16, mallocator };
+	dynArr.Add(0x0123456789ABCDEF);
+	dynArr.Add(0xFEDCBA9876543210);
+	dynArr.Add(0x0F1E2D3C4B5A6978);
+	dynArr.ShrinkToFit();
+
+	ASSERT_EQ(dynArr.Size(), 3);
+	ASSERT_EQ(dynArr.Capacity(), 3);
+	ASSERT_EQ(dynArr[0], 0x0123456789ABCDEF);
+	ASSERT_EQ(dynArr[1], 0xFEDCBA9876543210);
+	ASSERT_EQ(dynArr[2], 0x0F1E2D3C4B5A6978);
+}
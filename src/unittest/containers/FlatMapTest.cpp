@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(FlatMapTest, DefaultInit)
+{
+	FlatMap<u32, u32> map;
+	EXPECT_EQ(map.Size(), 0);
+	EXPECT_TRUE(map.IsEmpty());
+	EXPECT_EQ(map.Begin(), map.End());
+	EXPECT_FALSE(map.At(0));
+}
+
+TEST(FlatMapTest, Insert)
+{
+	FlatMap<u32, u32> map;
+	EXPECT_TRUE(map.Insert(3u, 30u).second);
+	EXPECT_TRUE(map.Insert(1u, 10u).second);
+	EXPECT_TRUE(map.TryInsert(2u, 20u).second);
+
+	auto [it, inserted] = map.Insert(1u, 11u);
+	EXPECT_FALSE(inserted);
+	EXPECT_EQ(it.Value(), 11);
+	EXPECT_FALSE(map.TryInsert(1u, 12u).second);
+	EXPECT_FALSE(map.TryEmplace(2u, 21u).second);
+	EXPECT_TRUE(map.TryEmplace(4u, 40u).second);
+
+	ASSERT_EQ(map.Size(), 4);
+	EXPECT_EQ(map[1], 11);
+	EXPECT_EQ(map[2], 20);
+	EXPECT_EQ(map[3], 30);
+	EXPECT_EQ(map.At(4), 40u);
+	EXPECT_FALSE(map.At(5));
+
+	u32 expected = 1;
+	for (auto [key, value] : map)
+	{
+		EXPECT_EQ(key, expected);
+		value = key * 100;
+		++expected;
+	}
+	EXPECT_EQ(map.ValueAt(2), 300);
+	EXPECT_EQ(map.KeyAt(2), 3);
+}
+
+TEST(FlatMapTest, BulkInit)
+{
+	FlatMap<u32, String> map{ { { 5u, String{ "five" } }, { 1u, String{ "one" } }, { 3u, String{ "three" } }, { 1u, String{ "one" } } } };
+	ASSERT_EQ(map.Size(), 3);
+	EXPECT_EQ(map.KeyAt(0), 1);
+	EXPECT_EQ(map.ValueAt(0), String{ "one" });
+	EXPECT_EQ(map.ValueAt(1), String{ "three" });
+	EXPECT_EQ(map.ValueAt(2), String{ "five" });
+
+	const u32* pKeys = map.Keys().Data();
+	EXPECT_EQ(pKeys[2], 5);
+	EXPECT_EQ(map.Values()[1], String{ "three" });
+}
+
+TEST(FlatMapTest, BulkInitLarge)
+{
+	DynArray<Pair<u32, u32>> pairs;
+	for (u32 i = 0; i < 1000; ++i)
+		pairs.Add(Pair<u32, u32>{ (i * 7919) % 1000, i });
+
+	FlatMap<u32, u32> map{ Move(pairs) };
+	ASSERT_EQ(map.Size(), 1000);
+	for (u32 i = 0; i < 1000; ++i)
+	{
+		EXPECT_EQ(map.KeyAt(i), i);
+		EXPECT_EQ((map.ValueAt(i) * 7919) % 1000, i);
+	}
+}
+
+TEST(FlatMapTest, BulkInitDuplicates)
+{
+	// Of all pairs with the same key, the last one is kept, like when inserting them in order
+	DynArray<Pair<u32, u32>> pairs;
+	for (u32 i = 0; i < 1000; ++i)
+		pairs.Add(Pair<u32, u32>{ i % 10, i });
+
+	FlatMap<u32, u32> map{ Move(pairs) };
+	ASSERT_EQ(map.Size(), 10);
+	for (u32 i = 0; i < 10; ++i)
+	{
+		EXPECT_EQ(map.KeyAt(i), i);
+		EXPECT_EQ(map.ValueAt(i), 990 + i);
+	}
+
+	const FlatMap<u32, String> strMap{ { { 2u, String{ "two" } }, { 1u, String{ "one" } }, { 2u, String{ "deux" } }, { 1u, String{ "un" } } } };
+	ASSERT_EQ(strMap.Size(), 2);
+	EXPECT_EQ(strMap.ValueAt(0), String{ "un" });
+	EXPECT_EQ(strMap.ValueAt(1), String{ "deux" });
+}
+
+TEST(FlatMapTest, Find)
+{
+	const FlatMap<u32, u32> map{ { { 10u, 1u }, { 20u, 2u }, { 30u, 3u } } };
+	EXPECT_EQ(map.Find(20).Value(), 2);
+	EXPECT_EQ(map.Find(25), map.End());
+	EXPECT_EQ(map.LowerBound(25).Key(), 30);
+	EXPECT_EQ(map.LowerBound(31), map.End());
+	EXPECT_TRUE(map.Contains(10));
+	EXPECT_FALSE(map.Contains(11));
+	EXPECT_EQ(map.End() - map.Begin(), 3);
+}
+
+TEST(FlatMapTest, Erase)
+{
+	FlatMap<u32, String> map{ { { 1u, String{ "a" } }, { 2u, String{ "b" } }, { 3u, String{ "c" } } } };
+	EXPECT_EQ(map.Erase(2), 1);
+	EXPECT_EQ(map.Erase(2), 0);
+
+	auto it = map.Erase(map.Find(1));
+	EXPECT_EQ(it.Key(), 3);
+	EXPECT_EQ(it.Value(), String{ "c" });
+	ASSERT_EQ(map.Size(), 1);
+
+	map.Clear();
+	EXPECT_TRUE(map.IsEmpty());
+}
+
+TEST(FlatMapTest, Inplace)
+{
+	InplaceFlatMap<u32, u32, 4> map{ { { 2u, 20u }, { 1u, 10u } } };
+	EXPECT_EQ(map.Capacity(), 4);
+	EXPECT_TRUE(map.Insert(4u, 40u).second);
+	EXPECT_TRUE(map.Insert(3u, 30u).second);
+	ASSERT_EQ(map.Size(), 4);
+	for (u32 i = 0; i < 4; ++i)
+	{
+		EXPECT_EQ(map.KeyAt(i), i + 1);
+		EXPECT_EQ(map.ValueAt(i), (i + 1) * 10);
+	}
+
+	EXPECT_EQ(map.Erase(4), 1);
+	EXPECT_EQ(map.Erase(1), 1);
+	ASSERT_EQ(map.Size(), 2);
+	EXPECT_EQ(map[2], 20);
+	EXPECT_EQ(map[3], 30);
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	struct ReverseComparator
+	{
+		auto operator()(const u32& a, const u32& b) const noexcept -> i8 { return a > b ? -1 : a < b ? 1 : 0; }
+	};
+
+	auto NextRandom(u32& state) noexcept -> u32
+	{
+		state = state * 1664525u + 1013904223u;
+		return state >> 8;
+	}
+}
+
+TEST(FlatSetTest, DefaultInit)
+{
+	FlatSet<u32> set;
+	EXPECT_EQ(set.Size(), 0);
+	EXPECT_TRUE(set.IsEmpty());
+	EXPECT_EQ(set.Begin(), set.End());
+	EXPECT_FALSE(set.Contains(0));
+}
+
+TEST(FlatSetTest, Insert)
+{
+	FlatSet<u32> set;
+	EXPECT_TRUE(set.Insert(5).second);
+	EXPECT_TRUE(set.Insert(1).second);
+	EXPECT_TRUE(set.Insert(3).second);
+	EXPECT_FALSE(set.Insert(3).second);
+	EXPECT_EQ(*set.Insert(1).first, 1);
+
+	ASSERT_EQ(set.Size(), 3);
+	EXPECT_EQ(set[0], 1);
+	EXPECT_EQ(set[1], 3);
+	EXPECT_EQ(set[2], 5);
+	EXPECT_TRUE(set.Contains(3));
+	EXPECT_FALSE(set.Contains(4));
+}
+
+TEST(FlatSetTest, BulkInit)
+{
+	FlatSet<u32> set{ { 9, 3, 7, 3, 1, 9, 9, 5 } };
+	ASSERT_EQ(set.Size(), 5);
+
+	u32 expected = 1;
+	for (u32 key : set)
+	{
+		EXPECT_EQ(key, expected);
+		expected += 2;
+	}
+
+	FlatSet<u32, ReverseComparator> reversed{ DynArray<u32>{ 2, 0, 1, 2 } };
+	ASSERT_EQ(reversed.Size(), 3);
+	EXPECT_EQ(reversed.Front(), 2);
+	EXPECT_EQ(reversed.Back(), 0);
+}
+
+TEST(FlatSetTest, BulkInitLarge)
+{
+	u32 state = 42;
+	DynArray<u32> keys;
+	for (u32 i = 0; i < 5000; ++i)
+		keys.Add(NextRandom(state) % 2000);
+
+	FlatSet<u32> set{ DynArray<u32>{ keys } };
+	for (usize i = 1; i < set.Size(); ++i)
+		EXPECT_LT(set[i - 1], set[i]);
+	for (u32 key : keys)
+		EXPECT_TRUE(set.Contains(key));
+
+	set.Insert(keys.Begin(), keys.End());
+	FlatSet<u32> inserted;
+	inserted.Insert(keys.Begin(), keys.End());
+	ASSERT_EQ(inserted.Size(), set.Size());
+	for (usize i = 0; i < set.Size(); ++i)
+		EXPECT_EQ(inserted[i], set[i]);
+}
+
+TEST(FlatSetTest, Bounds)
+{
+	FlatSet<u32> set{ { 10, 20, 30 } };
+	EXPECT_EQ(*set.LowerBound(20), 20);
+	EXPECT_EQ(*set.UpperBound(20), 30);
+	EXPECT_EQ(*set.LowerBound(15), 20);
+	EXPECT_EQ(*set.LowerBound(0), 10);
+	EXPECT_EQ(set.LowerBound(31), set.End());
+	EXPECT_EQ(set.UpperBound(30), set.End());
+	EXPECT_EQ(set.Find(15), set.End());
+}
+
+TEST(FlatSetTest, Erase)
+{
+	FlatSet<u32> set{ { 1, 2, 3, 4 } };
+	EXPECT_EQ(set.Erase(2), 1);
+	EXPECT_EQ(set.Erase(2), 0);
+	EXPECT_EQ(*set.Erase(set.Find(3)), 4);
+	ASSERT_EQ(set.Size(), 2);
+	EXPECT_EQ(set[0], 1);
+	EXPECT_EQ(set[1], 4);
+
+	set.Clear();
+	EXPECT_TRUE(set.IsEmpty());
+}
+
+TEST(FlatSetTest, Inplace)
+{
+	InplaceFlatSet<u32, 8> set{ { 4, 2, 4, 8 } };
+	EXPECT_EQ(set.Capacity(), 8);
+	ASSERT_EQ(set.Size(), 3);
+
+	set.Insert(6);
+	EXPECT_EQ(set[2], 6);
+	EXPECT_EQ(set.Erase(2), 1);
+	EXPECT_EQ(set.Erase(8), 1);
+	ASSERT_EQ(set.Size(), 2);
+	EXPECT_EQ(set[0], 4);
+	EXPECT_EQ(set[1], 6);
+}
+
+TEST(FlatSetTest, Strings)
+{
+	FlatSet<String> set{ { String{ "pear" }, String{ "apple" }, String{ "fig" }, String{ "apple" } } };
+	ASSERT_EQ(set.Size(), 3);
+	EXPECT_EQ(set[0], String{ "apple" });
+	EXPECT_EQ(set[2], String{ "pear" });
+	EXPECT_TRUE(set.Emplace("banana").second);
+	EXPECT_EQ(set[1], String{ "banana" });
+}
+
+TEST(FlatSetTest, EytzingerIndex)
+{
+	for (u32 count : { 0u, 1u, 2u, 7u, 8u, 100u, 1023u })
+	{
+		DynArray<u32> keys;
+		for (u32 i = 0; i < count; ++i)
+			keys.Add(i * 2 + 1);
+
+		EytzingerIndex<u32> index{ keys.Data(), keys.Size() };
+		EXPECT_EQ(index.Size(), count);
+		for (u32 i = 0; i <= count * 2 + 1; ++i)
+		{
+			EXPECT_EQ(index.LowerBound(i), usize(i / 2));
+			EXPECT_EQ(index.Find(i), i & 1 && i / 2 < count ? usize(i / 2) : EytzingerIndex<u32>::NPos);
+		}
+	}
+}
@@ -347,6 +347,36 @@ TEST(HashMapTest, TryInsertMoveKeyValue)
 	ASSERT_FALSE(hashmap.IsEmpty());
 }
 
+TEST(HashMapTest, InsertExistingInBucket)
+{
+	// Only uses the upper bits, so all keys end up in the same bucket
+	struct BucketCollidingHash
+	{
+		auto operator()(const u32& key) const noexcept -> u64 { return u64(key) << 32; }
+	};
+
+	Core::Alloc::Mallocator mallocator;
+	Core::HashMap<u32, u32, BucketCollidingHash> hashmap{ mallocator };
+	hashmap.Insert(1u, 10u);
+	hashmap.Insert(2u, 20u);
+	hashmap.Insert(3u, 30u);
+
+	auto it = hashmap.Insert(2u, 200u);
+	ASSERT_EQ(it.first->first, 2);
+	ASSERT_EQ(it.first->second, 200);
+	ASSERT_FALSE(it.second);
+
+	it = hashmap.TryInsert(3u, 300u);
+	ASSERT_EQ(it.first->first, 3);
+	ASSERT_EQ(it.first->second, 30);
+	ASSERT_FALSE(it.second);
+
+	ASSERT_EQ(hashmap.At(1), 10);
+	ASSERT_EQ(hashmap.At(2), 200);
+	ASSERT_EQ(hashmap.At(3), 30);
+	ASSERT_EQ(hashmap.Size(), 3);
+}
+
 TEST(HashMapTest, Clear)
 {
 	Core::Alloc::Mallocator mallocator;
@@ -367,6 +397,32 @@ TEST(HashMapTest, Clear)
 	ASSERT_TRUE(hashmap.IsEmpty());
 }
 
+TEST(HashMapTest, Erase)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::HashMap<u32, u32> hashmap{
+		{ Core::Pair{0u, 1u},
+		  Core::Pair{1u, 2u},
+		  Core::Pair{2u, 3u},
+		  Core::Pair{3u, 4u},
+		  Core::Pair{4u, 5u} },
+		mallocator };
+
+	ASSERT_EQ(hashmap.Erase(3), 1);
+	ASSERT_EQ(hashmap.Erase(3), 0);
+	ASSERT_EQ(hashmap.Size(), 4);
+	ASSERT_FALSE(hashmap.Contains(3));
+
+	auto it = hashmap.Find(1);
+	hashmap.Erase(it);
+	ASSERT_EQ(hashmap.Size(), 3);
+	ASSERT_FALSE(hashmap.Contains(1));
+
+	hashmap.EraseIf([](const u32& key, const u32&) { return key % 2 == 0; });
+	ASSERT_EQ(hashmap.Size(), 0);
+	ASSERT_TRUE(hashmap.IsEmpty());
+}
+
 TEST(HashMapTest, Find)
 {
 	Core::Alloc::Mallocator mallocator;
@@ -509,3 +565,62 @@ TEST(HashMapTest, FontLastBeginEnd)
 	ASSERT_EQ(hashmap.BucketCount(), 8);
 	ASSERT_FALSE(hashmap.IsEmpty());
 }
+
+TEST(HashMapTest, CopyWithAlloc)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Alloc::Mallocator otherMallocator;
+	Core::HashMap<u32, u32> src{
+		{ Core::Pair{0u, 1u},
+		  Core::Pair{1u, 2u},
+		  Core::Pair{2u, 3u},
+		  Core::Pair{3u, 4u},
+		  Core::Pair{4u, 5u} },
+		mallocator };
+
+	// The copy needs its own buckets, allocated with the new allocator
+	Core::HashMap<u32, u32> hashmap{ src, otherMallocator };
+	ASSERT_EQ(hashmap.GetAllocator(), &otherMallocator);
+	ASSERT_EQ(hashmap.Size(), 5);
+	ASSERT_EQ(hashmap.BucketCount(), 8);
+	for (u32 i = 0; i < 5; ++i)
+	{
+		auto it = hashmap.Find(i);
+		ASSERT_NE(it, hashmap.End());
+		ASSERT_EQ(it->second, i + 1);
+	}
+
+	hashmap.Insert(5u, 6u);
+	ASSERT_EQ(hashmap.Size(), 6);
+	ASSERT_TRUE(hashmap.Contains(5));
+	ASSERT_EQ(src.Size(), 5);
+	ASSERT_FALSE(src.Contains(5));
+}
+
+TEST(HashMapTest, MoveWithAlloc)
+{
+	Core::Alloc::Mallocator mallocator;
+	Core::Alloc::Mallocator otherMallocator;
+	Core::HashMap<u32, u32> src{
+		{ Core::Pair{0u, 1u},
+		  Core::Pair{1u, 2u},
+		  Core::Pair{2u, 3u},
+		  Core::Pair{3u, 4u},
+		  Core::Pair{4u, 5u} },
+		mallocator };
+
+	Core::HashMap<u32, u32> hashmap{ Move(src), otherMallocator };
+	ASSERT_EQ(hashmap.GetAllocator(), &otherMallocator);
+	ASSERT_EQ(hashmap.Size(), 5);
+	ASSERT_EQ(hashmap.BucketCount(), 8);
+	for (u32 i = 0; i < 5; ++i)
+	{
+		auto it = hashmap.Find(i);
+		ASSERT_NE(it, hashmap.End());
+		ASSERT_EQ(it->second, i + 1);
+	}
+
+	hashmap.Insert(5u, 6u);
+	ASSERT_EQ(hashmap.Size(), 6);
+	ASSERT_TRUE(hashmap.Contains(5));
+}
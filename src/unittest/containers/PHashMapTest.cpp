@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	// Only uses a few bits of the key, so many keys end up in collision nodes
+	struct PHashMapCollidingHash
+	{
+		auto operator()(u32 key) const noexcept -> u64 { return key & 0x3; }
+	};
+}
+
+TEST(PHashMapTest, DefaultInit)
+{
+	PHashMap<u32, u32> map;
+	EXPECT_EQ(map.Size(), 0);
+	EXPECT_TRUE(map.IsEmpty());
+	EXPECT_FALSE(map.Contains(0));
+	EXPECT_EQ(map.Find(0), nullptr);
+}
+
+TEST(PHashMapTest, InsertFind)
+{
+	PHashMap<u32, u32> map;
+	for (u32 i = 0; i < 10000; ++i)
+		map = map.Insert(i, i * 3);
+
+	EXPECT_EQ(map.Size(), 10000);
+	for (u32 i = 0; i < 10000; ++i)
+	{
+		const u32* pVal = map.Find(i);
+		ASSERT_NE(pVal, nullptr);
+		ASSERT_EQ(*pVal, i * 3);
+	}
+	EXPECT_FALSE(map.Contains(10000));
+
+	map = map.Insert(5, 0);
+	EXPECT_EQ(map.Size(), 10000);
+	EXPECT_EQ(*map.Find(5), 0);
+}
+
+TEST(PHashMapTest, Snapshots)
+{
+	PHashMap<u32, u32> map;
+	for (u32 i = 0; i < 1000; ++i)
+		map = map.Insert(i, i);
+
+	const PHashMap<u32, u32> snapshot = map;
+	EXPECT_TRUE(snapshot.IsSharedWith(map));
+
+	const PHashMap<u32, u32> modified = map.Insert(10, 0).Erase(20).Insert(2000, 1);
+	EXPECT_EQ(modified.Size(), 1000);
+	EXPECT_EQ(*modified.Find(10), 0);
+	EXPECT_FALSE(modified.Contains(20));
+	EXPECT_TRUE(modified.Contains(2000));
+
+	// The original map is unchanged
+	EXPECT_EQ(map.Size(), 1000);
+	for (u32 i = 0; i < 1000; ++i)
+		ASSERT_EQ(*map.Find(i), i);
+	EXPECT_TRUE(map.Erase(5000).IsSharedWith(map));
+}
+
+TEST(PHashMapTest, Erase)
+{
+	PHashMap<u32, u32> map;
+	for (u32 i = 0; i < 5000; ++i)
+		map = map.Insert(i, i);
+
+	PHashMap<u32, u32> erased = map;
+	for (u32 i = 0; i < 5000; i += 2)
+		erased = erased.Erase(i);
+	EXPECT_EQ(erased.Size(), 2500);
+	for (u32 i = 0; i < 5000; ++i)
+		ASSERT_EQ(erased.Contains(i), (i & 1) == 1);
+
+	for (u32 i = 1; i < 5000; i += 2)
+		erased = erased.Erase(i);
+	EXPECT_TRUE(erased.IsEmpty());
+	EXPECT_EQ(map.Size(), 5000);
+}
+
+TEST(PHashMapTest, Collisions)
+{
+	PHashMap<u32, u32, PHashMapCollidingHash> map;
+	for (u32 i = 0; i < 100; ++i)
+		map = map.Insert(i, i + 1);
+
+	EXPECT_EQ(map.Size(), 100);
+	for (u32 i = 0; i < 100; ++i)
+		ASSERT_EQ(*map.Find(i), i + 1);
+
+	const PHashMap<u32, u32, PHashMapCollidingHash> snapshot = map;
+	for (u32 i = 0; i < 100; i += 3)
+		map = map.Erase(i);
+	for (u32 i = 0; i < 100; ++i)
+		ASSERT_EQ(map.Contains(i), i % 3 != 0);
+
+	for (u32 i = 0; i < 100; ++i)
+		map = map.Erase(i);
+	EXPECT_TRUE(map.IsEmpty());
+	EXPECT_EQ(snapshot.Size(), 100);
+}
+
+TEST(PHashMapTest, Transient)
+{
+	PHashMap<u32, u32> map;
+	for (u32 i = 0; i < 3000; ++i)
+		map = map.Insert(i, i);
+
+	TransientPHashMap<u32, u32> transient = map.AsTransient();
+	for (u32 i = 0; i < 3000; ++i)
+		EXPECT_FALSE(transient.Insert(i, i * 2));
+	for (u32 i = 3000; i < 4000; ++i)
+		EXPECT_TRUE(transient.Insert(i, i * 2));
+	for (u32 i = 0; i < 4000; i += 4)
+		EXPECT_TRUE(transient.Erase(i));
+	EXPECT_FALSE(transient.Erase(0));
+
+	const PHashMap<u32, u32> result = transient.Persistent();
+	EXPECT_TRUE(transient.IsEmpty());
+	EXPECT_EQ(result.Size(), 3000);
+	for (u32 i = 0; i < 4000; ++i)
+	{
+		if (i % 4 == 0)
+			ASSERT_FALSE(result.Contains(i));
+		else
+			ASSERT_EQ(*result.Find(i), i * 2);
+	}
+
+	for (u32 i = 0; i < 3000; ++i)
+		ASSERT_EQ(*map.Find(i), i);
+}
+
+TEST(PHashMapTest, ForEach)
+{
+	PHashMap<u32, String> map;
+	for (u32 i = 0; i < 500; ++i)
+		map = map.Insert(i, String{ "value" });
+
+	usize count = 0;
+	u32 keySum = 0;
+	map.ForEach([&](const u32& key, const String& val)
+	{
+		++count;
+		keySum += key;
+		EXPECT_EQ(val, "value");
+	});
+	EXPECT_EQ(count, 500);
+	EXPECT_EQ(keySum, 499 * 500 / 2);
+}
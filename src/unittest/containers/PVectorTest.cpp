@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(PVectorTest, DefaultInit)
+{
+	PVector<u32> vec;
+	EXPECT_EQ(vec.Size(), 0);
+	EXPECT_TRUE(vec.IsEmpty());
+	EXPECT_EQ(vec.Begin(), vec.End());
+}
+
+TEST(PVectorTest, InitializerList)
+{
+	PVector<u32> vec{ { 1, 2, 3, 4 } };
+	EXPECT_EQ(vec.Size(), 4);
+	EXPECT_EQ(vec.Front(), 1);
+	EXPECT_EQ(vec.Back(), 4);
+
+	u32 sum = 0;
+	for (u32 val : vec)
+		sum += val;
+	EXPECT_EQ(sum, 10);
+}
+
+TEST(PVectorTest, PushBackDeep)
+{
+	// Enough elements for a trie with 3 levels
+	PVector<u32> vec;
+	for (u32 i = 0; i < 40000; ++i)
+		vec = vec.PushBack(i);
+
+	EXPECT_EQ(vec.Size(), 40000);
+	for (u32 i = 0; i < 40000; ++i)
+		ASSERT_EQ(vec[i], i);
+
+	u32 idx = 0;
+	for (u32 val : vec)
+		ASSERT_EQ(val, idx++);
+	EXPECT_EQ(idx, 40000);
+}
+
+TEST(PVectorTest, Snapshots)
+{
+	PVector<u32> vec;
+	for (u32 i = 0; i < 1000; ++i)
+		vec = vec.PushBack(i);
+
+	const PVector<u32> snapshot = vec;
+	EXPECT_TRUE(snapshot.IsSharedWith(vec));
+
+	const PVector<u32> modified = vec.Set(500, 0).Set(999, 0).PushBack(1000);
+	EXPECT_FALSE(modified.IsSharedWith(vec));
+	EXPECT_EQ(modified[500], 0);
+	EXPECT_EQ(modified[999], 0);
+	EXPECT_EQ(modified.Size(), 1001);
+
+	// The original vector is unchanged
+	EXPECT_EQ(vec.Size(), 1000);
+	for (u32 i = 0; i < 1000; ++i)
+		ASSERT_EQ(vec[i], i);
+}
+
+TEST(PVectorTest, PopBack)
+{
+	PVector<u32> vec;
+	for (u32 i = 0; i < 2000; ++i)
+		vec = vec.PushBack(i);
+
+	PVector<u32> popped = vec;
+	for (u32 i = 2000; i > 0; --i)
+	{
+		ASSERT_EQ(popped.Back(), i - 1);
+		popped = popped.PopBack();
+	}
+	EXPECT_TRUE(popped.IsEmpty());
+	EXPECT_EQ(vec.Size(), 2000);
+	EXPECT_EQ(vec.Back(), 1999);
+
+	// Push to a vector that shares a partially popped tail
+	const PVector<u32> a = vec.PopBack().PopBack();
+	const PVector<u32> b = a.PushBack(42);
+	EXPECT_EQ(b.Back(), 42);
+	EXPECT_EQ(vec[1998], 1998);
+}
+
+TEST(PVectorTest, Transient)
+{
+	PVector<u32> vec;
+	for (u32 i = 0; i < 5000; ++i)
+		vec = vec.PushBack(i);
+
+	TransientPVector<u32> transient = vec.AsTransient();
+	for (u32 i = 0; i < 5000; ++i)
+		transient.Set(i, i * 2);
+	for (u32 i = 0; i < 100; ++i)
+		transient.PopBack();
+	transient.PushBack(7);
+
+	const PVector<u32> result = transient.Persistent();
+	EXPECT_TRUE(transient.IsEmpty());
+	EXPECT_EQ(result.Size(), 4901);
+	for (u32 i = 0; i < 4900; ++i)
+		ASSERT_EQ(result[i], i * 2);
+	EXPECT_EQ(result.Back(), 7);
+
+	for (u32 i = 0; i < 5000; ++i)
+		ASSERT_EQ(vec[i], i);
+}
+
+TEST(PVectorTest, NonTrivialElements)
+{
+	PVector<String> vec;
+	for (u32 i = 0; i < 100; ++i)
+		vec = vec.PushBack(String{ "element" });
+
+	const PVector<String> modified = vec.Set(50, String{ "modified" }).PopBack();
+	EXPECT_EQ(modified.Size(), 99);
+	EXPECT_EQ(modified[50], "modified");
+	EXPECT_EQ(vec[50], "element");
+}
@@ -0,0 +1,235 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	struct PriorityQueueMaxComparator
+	{
+		auto operator()(u32 a, u32 b) const noexcept -> i8 { return a > b ? -1 : a < b ? 1 : 0; }
+	};
+
+	auto NextPriorityQueueRandom(u32& state) -> u32
+	{
+		state = state * 1664525u + 1013904223u;
+		return state >> 8;
+	}
+}
+
+TEST(PriorityQueueTest, DefaultInit)
+{
+	PriorityQueue<u32> queue;
+	EXPECT_EQ(queue.Size(), 0);
+	EXPECT_TRUE(queue.IsEmpty());
+	EXPECT_FALSE(queue.Contains(0));
+}
+
+TEST(PriorityQueueTest, PushPop)
+{
+	PriorityQueue<u32> queue;
+	const u32 vals[] = { 5, 3, 9, 1, 7, 3, 8 };
+	for (u32 val : vals)
+		queue.Push(val);
+
+	EXPECT_EQ(queue.Size(), 7);
+	EXPECT_EQ(queue.Top(), 1);
+
+	const u32 expected[] = { 1, 3, 3, 5, 7, 8, 9 };
+	for (u32 val : expected)
+		EXPECT_EQ(queue.Pop(), val);
+	EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(PriorityQueueTest, MaxHeap)
+{
+	PriorityQueue<u32, PriorityQueueMaxComparator, 2> queue;
+	for (u32 i = 0; i < 100; ++i)
+		queue.Push((i * 37) % 100);
+
+	for (u32 i = 100; i > 0; --i)
+		EXPECT_EQ(queue.Pop(), i - 1);
+}
+
+TEST(PriorityQueueTest, Update)
+{
+	PriorityQueue<u32> queue;
+	const PriorityQueue<u32>::Handle a = queue.Push(10);
+	const PriorityQueue<u32>::Handle b = queue.Push(20);
+	const PriorityQueue<u32>::Handle c = queue.Push(30);
+
+	queue.Update(c, 5);
+	EXPECT_EQ(queue.Top(), 5);
+	EXPECT_EQ(queue.TopHandle(), c);
+
+	queue.Update(c, 40);
+	EXPECT_EQ(queue.TopHandle(), a);
+	EXPECT_EQ(queue.Get(c), 40);
+
+	queue.Update(a, 25);
+	EXPECT_EQ(queue.TopHandle(), b);
+
+	EXPECT_EQ(queue.Pop(), 20);
+	EXPECT_EQ(queue.Pop(), 25);
+	EXPECT_EQ(queue.Pop(), 40);
+}
+
+TEST(PriorityQueueTest, Erase)
+{
+	PriorityQueue<u32> queue;
+	DynArray<PriorityQueue<u32>::Handle> handles;
+	for (u32 i = 0; i < 20; ++i)
+		handles.Add(queue.Push(i));
+
+	for (u32 i = 0; i < 20; i += 2)
+		EXPECT_TRUE(queue.Erase(handles[i]));
+	EXPECT_FALSE(queue.Erase(handles[0]));
+	EXPECT_FALSE(queue.Contains(handles[0]));
+	EXPECT_TRUE(queue.Contains(handles[1]));
+	EXPECT_EQ(queue.Size(), 10);
+
+	for (u32 i = 1; i < 20; i += 2)
+		EXPECT_EQ(queue.Pop(), i);
+}
+
+TEST(PriorityQueueTest, HandleReuse)
+{
+	PriorityQueue<u32> queue;
+	const PriorityQueue<u32>::Handle a = queue.Push(1);
+	queue.Push(2);
+	EXPECT_EQ(queue.Pop(), 1);
+	EXPECT_FALSE(queue.Contains(a));
+
+	const PriorityQueue<u32>::Handle c = queue.Push(3);
+	EXPECT_EQ(c, a);
+	EXPECT_EQ(queue.Get(c), 3);
+}
+
+TEST(PriorityQueueTest, Randomized)
+{
+	PriorityQueue<u32> queue;
+	DynArray<PriorityQueue<u32>::Handle> handles;
+	u32 state = 42;
+	for (u32 i = 0; i < 2000; ++i)
+		handles.Add(queue.Push(NextPriorityQueueRandom(state) % 10000));
+
+	for (u32 i = 0; i < 2000; i += 3)
+		queue.Update(handles[i], NextPriorityQueueRandom(state) % 10000);
+	for (u32 i = 1; i < 2000; i += 7)
+		queue.Erase(handles[i]);
+
+	u32 prev = 0;
+	while (!queue.IsEmpty())
+	{
+		const u32 val = queue.Pop();
+		EXPECT_LE(prev, val);
+		prev = val;
+	}
+}
+
+TEST(PriorityQueueTest, UniqueElements)
+{
+	struct UniqueComparator
+	{
+		auto operator()(const Unique<u32>& a, const Unique<u32>& b) const noexcept -> i8 { return *a < *b ? -1 : *a > *b ? 1 : 0; }
+	};
+
+	PriorityQueue<Unique<u32>, UniqueComparator> queue;
+	queue.Push(Unique<u32>::Create(3u));
+	queue.Push(Unique<u32>::Create(1u));
+	queue.Push(Unique<u32>::Create(2u));
+
+	EXPECT_EQ(*queue.Pop(), 1);
+	EXPECT_EQ(*queue.Pop(), 2);
+	EXPECT_EQ(*queue.Pop(), 3);
+}
+
+TEST(PairingHeapTest, PushPop)
+{
+	PairingHeap<u32> heap;
+	const u32 vals[] = { 5, 3, 9, 1, 7, 3, 8 };
+	for (u32 val : vals)
+		heap.Push(val);
+
+	EXPECT_EQ(heap.Size(), 7);
+	EXPECT_EQ(heap.Top(), 1);
+
+	const u32 expected[] = { 1, 3, 3, 5, 7, 8, 9 };
+	for (u32 val : expected)
+		EXPECT_EQ(heap.Pop(), val);
+	EXPECT_TRUE(heap.IsEmpty());
+	EXPECT_EQ(heap.TopHandle(), PairingHeap<u32>::InvalidHandle);
+}
+
+TEST(PairingHeapTest, DecreaseKey)
+{
+	PairingHeap<u32> heap;
+	DynArray<PairingHeap<u32>::Handle> handles;
+	for (u32 i = 0; i < 10; ++i)
+		handles.Add(heap.Push(100 + i));
+
+	// Make sure the heap has children before decreasing keys
+	EXPECT_EQ(heap.Pop(), 100);
+
+	heap.DecreaseKey(handles[7], 50);
+	EXPECT_EQ(heap.TopHandle(), handles[7]);
+	heap.DecreaseKey(handles[3], 60);
+	heap.DecreaseKey(handles[7], 40);
+	EXPECT_EQ(heap.Get(handles[7]), 40);
+
+	EXPECT_EQ(heap.Pop(), 40);
+	EXPECT_EQ(heap.Pop(), 60);
+	EXPECT_EQ(heap.Pop(), 101);
+	EXPECT_EQ(heap.Pop(), 102);
+	EXPECT_EQ(heap.Pop(), 104);
+}
+
+TEST(PairingHeapTest, Erase)
+{
+	PairingHeap<u32> heap;
+	DynArray<PairingHeap<u32>::Handle> handles;
+	for (u32 i = 0; i < 20; ++i)
+		handles.Add(heap.Push(i));
+	EXPECT_EQ(heap.Pop(), 0);
+
+	for (u32 i = 1; i < 20; i += 2)
+		EXPECT_TRUE(heap.Erase(handles[i]));
+	EXPECT_FALSE(heap.Erase(handles[1]));
+	EXPECT_FALSE(heap.Contains(handles[0]));
+	EXPECT_EQ(heap.Size(), 9);
+
+	for (u32 i = 2; i < 20; i += 2)
+		EXPECT_EQ(heap.Pop(), i);
+}
+
+TEST(PairingHeapTest, Randomized)
+{
+	PairingHeap<u32> heap;
+	DynArray<PairingHeap<u32>::Handle> handles;
+	DynArray<u32> values;
+	u32 state = 7;
+	for (u32 i = 0; i < 2000; ++i)
+	{
+		values.Add(NextPriorityQueueRandom(state) % 10000 + 10000);
+		handles.Add(heap.Push(values.Back()));
+	}
+
+	// Interleave pops with decreases, so decreases hit nodes at all depths
+	for (u32 i = 0; i < 100; ++i)
+		heap.Pop();
+	for (u32 i = 0; i < 2000; i += 3)
+	{
+		if (heap.Contains(handles[i]))
+			heap.DecreaseKey(handles[i], heap.Get(handles[i]) - NextPriorityQueueRandom(state) % 10000);
+	}
+	for (u32 i = 1; i < 2000; i += 7)
+		heap.Erase(handles[i]);
+
+	u32 prev = 0;
+	while (!heap.IsEmpty())
+	{
+		const u32 val = heap.Pop();
+		EXPECT_LE(prev, val);
+		prev = val;
+	}
+}
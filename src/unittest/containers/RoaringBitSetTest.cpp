@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(RoaringBitSetTest, AddRemove)
+{
+	Alloc::Mallocator mallocator;
+	RoaringBitSet set{ mallocator };
+	EXPECT_TRUE(set.IsEmpty());
+	EXPECT_EQ(set.GetAllocator(), &mallocator);
+
+	EXPECT_TRUE(set.Add(5));
+	EXPECT_TRUE(set.Add(70000));
+	EXPECT_TRUE(set.Add(0xFFFF'FFFF));
+	EXPECT_FALSE(set.Add(5));
+	EXPECT_EQ(set.Count(), 3);
+
+	EXPECT_TRUE(set.Contains(5));
+	EXPECT_TRUE(set.Contains(70000));
+	EXPECT_TRUE(set.Contains(0xFFFF'FFFF));
+	EXPECT_FALSE(set.Contains(6));
+	EXPECT_FALSE(set.Contains(70001));
+
+	EXPECT_TRUE(set.Remove(70000));
+	EXPECT_FALSE(set.Remove(70000));
+	EXPECT_FALSE(set.Contains(70000));
+	EXPECT_EQ(set.Count(), 2);
+
+	set.Clear();
+	EXPECT_TRUE(set.IsEmpty());
+	EXPECT_EQ(set.Count(), 0);
+}
+
+TEST(RoaringBitSetTest, BitmapContainer)
+{
+	Alloc::Mallocator mallocator;
+	RoaringBitSet set{ mallocator };
+
+	// Fill a chunk past the array limit, so it becomes a bitmap
+	for (u32 i = 0; i < 10000; ++i)
+		set.Add(i * 2);
+	EXPECT_EQ(set.Count(), 10000);
+	EXPECT_TRUE(set.Contains(19998));
+	EXPECT_FALSE(set.Contains(19999));
+
+	// Removing values converts the container back to an array
+	for (u32 i = 0; i < 6000; ++i)
+		set.Remove(i * 2);
+	EXPECT_EQ(set.Count(), 4000);
+	EXPECT_FALSE(set.Contains(0));
+	EXPECT_TRUE(set.Contains(12000));
+
+	u32 prev = 0;
+	usize count = 0;
+	set.ForEachSetBit([&](u32 val)
+	{
+		EXPECT_GT(val, prev);
+		EXPECT_EQ(val % 2, 0);
+		prev = val;
+		++count;
+	});
+	EXPECT_EQ(count, 4000);
+}
+
+TEST(RoaringBitSetTest, Or)
+{
+	Alloc::Mallocator mallocator;
+	RoaringBitSet a{ mallocator };
+	RoaringBitSet b{ mallocator };
+
+	for (u32 i = 0; i < 3000; ++i)
+	{
+		a.Add(i * 3);
+		b.Add(i * 3 + 1);
+	}
+	b.Add(1 << 20);
+
+	RoaringBitSet res = a;
+	res |= b;
+	EXPECT_EQ(res.Count(), 6001);
+	EXPECT_TRUE(res.Contains(0));
+	EXPECT_TRUE(res.Contains(1));
+	EXPECT_FALSE(res.Contains(2));
+	EXPECT_TRUE(res.Contains(1 << 20));
+
+	// Union with itself doesn't change the set
+	RoaringBitSet same = res;
+	same |= res;
+	EXPECT_EQ(same, res);
+}
+
+TEST(RoaringBitSetTest, And)
+{
+	Alloc::Mallocator mallocator;
+	RoaringBitSet a{ mallocator };
+	RoaringBitSet b{ mallocator };
+
+	// a: bitmap container, b: array container in chunk 0, and an extra chunk only in a
+	for (u32 i = 0; i < 20000; ++i)
+		a.Add(i);
+	for (u32 i = 0; i < 1000; ++i)
+		b.Add(i * 30);
+	a.Add(5 << 16);
+
+	EXPECT_EQ(a.AndCount(b), 667);
+	EXPECT_EQ(b.AndCount(a), 667);
+
+	RoaringBitSet res = a;
+	res &= b;
+	EXPECT_EQ(res.Count(), 667);
+	EXPECT_TRUE(res.Contains(0));
+	EXPECT_TRUE(res.Contains(19980));
+	EXPECT_FALSE(res.Contains(20010));
+	EXPECT_FALSE(res.Contains(5 << 16));
+
+	RoaringBitSet res2 = b;
+	res2 &= a;
+	EXPECT_EQ(res2, res);
+
+	// Bitmap and bitmap
+	RoaringBitSet c{ mallocator };
+	for (u32 i = 10000; i < 30000; ++i)
+		c.Add(i);
+	EXPECT_EQ(a.AndCount(c), 10000);
+	RoaringBitSet res3 = a;
+	res3 &= c;
+	EXPECT_EQ(res3.Count(), 10000);
+	EXPECT_TRUE(res3.Contains(10000));
+	EXPECT_FALSE(res3.Contains(9999));
+}
@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(SlotMapTest, DefaultInit)
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<u32> map{ mallocator };
+	ASSERT_EQ(map.Begin(), map.End());
+	ASSERT_EQ(map.GetAllocator(), &mallocator);
+	ASSERT_EQ(map.Size(), 0);
+	EXPECT_TRUE(map.IsEmpty());
+	EXPECT_FALSE(map.Contains(0));
+	EXPECT_EQ(map.Get(SlotMap<u32>::InvalidHandle), nullptr);
+}
+
+TEST(SlotMapTest, Insert)
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<u32> map{ mallocator };
+
+	const u32 h0 = map.Insert(10);
+	const u32 h1 = map.Insert(11);
+	const u32 h2 = map.Emplace(12u);
+	ASSERT_EQ(map.Size(), 3);
+	EXPECT_FALSE(map.IsEmpty());
+
+	ASSERT_NE(h0, h1);
+	ASSERT_NE(h1, h2);
+	ASSERT_NE(map.Get(h0), nullptr);
+	ASSERT_NE(map.Get(h1), nullptr);
+	ASSERT_NE(map.Get(h2), nullptr);
+	EXPECT_EQ(*map.Get(h0), 10);
+	EXPECT_EQ(*map.Get(h1), 11);
+	EXPECT_EQ(*map.Get(h2), 12);
+
+	for (usize i = 0; i < map.Size(); ++i)
+		EXPECT_EQ(*map.Get(map.GetHandleAt(i)), map.GetValueAt(i));
+}
+
+TEST(SlotMapTest, Erase)
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<u32> map{ mallocator };
+
+	const u32 h0 = map.Insert(10);
+	const u32 h1 = map.Insert(11);
+	const u32 h2 = map.Insert(12);
+
+	EXPECT_TRUE(map.Erase(h0));
+	ASSERT_EQ(map.Size(), 2);
+	EXPECT_FALSE(map.Contains(h0));
+	EXPECT_EQ(map.Get(h0), nullptr);
+	EXPECT_FALSE(map.Erase(h0));
+
+	// The last element was moved into the erased element's place
+	EXPECT_EQ(map.GetValueAt(0), 12);
+	EXPECT_EQ(map.GetHandleAt(0), h2);
+	EXPECT_EQ(*map.Get(h1), 11);
+	EXPECT_EQ(*map.Get(h2), 12);
+
+	EXPECT_TRUE(map.Erase(h2));
+	EXPECT_TRUE(map.Erase(h1));
+	EXPECT_TRUE(map.IsEmpty());
+	EXPECT_EQ(map.Begin(), map.End());
+}
+
+TEST(SlotMapTest, StaleHandle)
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<u32> map{ mallocator };
+
+	const u32 h0 = map.Insert(10);
+	map.Erase(h0);
+
+	// The slot is reused with a new generation, so the old handle stays invalid
+	const u32 h1 = map.Insert(20);
+	EXPECT_EQ(SlotMap<u32>::GetIndex(h0), SlotMap<u32>::GetIndex(h1));
+	EXPECT_NE(SlotMap<u32>::GetGeneration(h0), SlotMap<u32>::GetGeneration(h1));
+	EXPECT_FALSE(map.Contains(h0));
+	EXPECT_EQ(map.Get(h0), nullptr);
+	EXPECT_FALSE(map.Erase(h0));
+	ASSERT_TRUE(map.Contains(h1));
+	EXPECT_EQ(*map.Get(h1), 20);
+
+	// Handles with an index past the slots are invalid
+	EXPECT_FALSE(map.Contains(h1 + 1));
+}
+
+TEST(SlotMapTest, Clear)
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<u32> map{ mallocator };
+
+	DynArray<u32> handles{ mallocator };
+	for (u32 i = 0; i < 16; ++i)
+		handles.Add(map.Insert(i));
+
+	map.Clear();
+	EXPECT_TRUE(map.IsEmpty());
+	for (u32 handle : handles)
+		EXPECT_FALSE(map.Contains(handle));
+
+	// All slots are reused, none of the old handles become valid again
+	for (u32 i = 0; i < 16; ++i)
+	{
+		const u32 handle = map.Insert(i);
+		EXPECT_FALSE(handles.Contains(handle));
+	}
+	ASSERT_EQ(map.Size(), 16);
+
+	map.Clear(true);
+	EXPECT_TRUE(map.IsEmpty());
+}
+
+TEST(SlotMapTest, Iteration)
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<u32> map{ mallocator };
+
+	DynArray<u32> handles{ mallocator };
+	for (u32 i = 0; i < 32; ++i)
+		handles.Add(map.Insert(i));
+	for (u32 i = 0; i < 32; i += 2)
+		map.Erase(handles[i]);
+
+	u32 sum = 0;
+	usize count = 0;
+	for (u32 val : map)
+	{
+		EXPECT_EQ(val % 2, 1);
+		sum += val;
+		++count;
+	}
+	EXPECT_EQ(count, 16);
+	EXPECT_EQ(sum, 16 * 16);
+}
+
+TEST(SlotMapTest, NonTrivialType)
+{
+	Alloc::Mallocator mallocator;
+	SlotMap<Unique<u32>> map{ mallocator };
+
+	const u32 h0 = map.Insert(Unique<u32>::Create(10));
+	const u32 h1 = map.Insert(Unique<u32>::Create(11));
+	map.Erase(h0);
+	ASSERT_NE(map.Get(h1), nullptr);
+	EXPECT_EQ(**map.Get(h1), 11);
+
+	SlotMap<Unique<u32>> moved{ Move(map) };
+	EXPECT_TRUE(map.IsEmpty());
+	ASSERT_TRUE(moved.Contains(h1));
+	EXPECT_EQ(**moved.Get(h1), 11);
+}
+
+TEST(SlotMapTest, LargeHandles)
+{
+	Alloc::Mallocator mallocator;
+	using LargeSlotMap = SlotMap<u32, u64>;
+	LargeSlotMap map{ mallocator };
+
+	const u64 h0 = map.Insert(10);
+	EXPECT_EQ(LargeSlotMap::GetIndex(h0), 0);
+	map.Erase(h0);
+	const u64 h1 = map.Insert(20);
+	EXPECT_EQ(LargeSlotMap::GetIndex(h1), 0);
+	EXPECT_FALSE(map.Contains(h0));
+	ASSERT_TRUE(map.Contains(h1));
+	EXPECT_EQ(*map.Get(h1), 20);
+}
@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	struct SmallDynArrayCounter
+	{
+		static inline i32 alive = 0;
+
+		SmallDynArrayCounter(u32 val = 0) : val(val) { ++alive; }
+		SmallDynArrayCounter(const SmallDynArrayCounter& other) : val(other.val) { ++alive; }
+		SmallDynArrayCounter(SmallDynArrayCounter&& other) noexcept : val(other.val) { other.val = 0; ++alive; }
+		~SmallDynArrayCounter() { --alive; }
+
+		auto operator=(const SmallDynArrayCounter& other) -> SmallDynArrayCounter& { val = other.val; return *this; }
+		auto operator=(SmallDynArrayCounter&& other) noexcept -> SmallDynArrayCounter& { val = other.val; other.val = 0; return *this; }
+		auto operator==(const SmallDynArrayCounter& other) const noexcept -> bool { return val == other.val; }
+
+		u32 val;
+	};
+
+	class SmallDynArrayCountingAlloc final : public Alloc::IAllocator
+	{
+	public:
+		u32 numAllocs = 0;
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override
+		{
+			++numAllocs;
+			return m_mallocator.Allocate<u8>(size, align, isBacking);
+		}
+
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override
+		{
+			m_mallocator.Deallocate(Move(mem));
+		}
+
+	private:
+		Alloc::Mallocator m_mallocator;
+	};
+}
+
+TEST(SmallDynArrayTest, DefaultInit)
+{
+	SmallDynArray<u32, 4> arr;
+	EXPECT_EQ(arr.Size(), 0);
+	EXPECT_EQ(arr.Capacity(), 4);
+	EXPECT_TRUE(arr.IsEmpty());
+	EXPECT_TRUE(arr.IsInline());
+}
+
+TEST(SmallDynArrayTest, StaysInline)
+{
+	SmallDynArrayCountingAlloc alloc;
+	SmallDynArray<u32, 4> arr{ alloc };
+	for (u32 i = 0; i < 4; ++i)
+		arr.Add(i);
+
+	EXPECT_EQ(arr.Size(), 4);
+	EXPECT_TRUE(arr.IsInline());
+	EXPECT_EQ(alloc.numAllocs, 0);
+	for (u32 i = 0; i < 4; ++i)
+		EXPECT_EQ(arr[i], i);
+}
+
+TEST(SmallDynArrayTest, SpillsToHeap)
+{
+	SmallDynArrayCountingAlloc alloc;
+	SmallDynArray<u32, 4> arr{ alloc };
+	for (u32 i = 0; i < 20; ++i)
+		arr.Add(i);
+
+	EXPECT_EQ(arr.Size(), 20);
+	EXPECT_FALSE(arr.IsInline());
+	EXPECT_GE(arr.Capacity(), 20);
+	EXPECT_GT(alloc.numAllocs, 0);
+	for (u32 i = 0; i < 20; ++i)
+		EXPECT_EQ(arr[i], i);
+
+	arr.Resize(3);
+	arr.ShrinkToFit();
+	EXPECT_TRUE(arr.IsInline());
+	EXPECT_EQ(arr.Size(), 3);
+	EXPECT_EQ(arr[2], 2);
+}
+
+TEST(SmallDynArrayTest, Init)
+{
+	SmallDynArray<u32, 4> filled(6, 42);
+	EXPECT_EQ(filled.Size(), 6);
+	EXPECT_EQ(filled[5], 42);
+
+	SmallDynArray<u32, 4> il{ { 0, 1, 2 } };
+	EXPECT_EQ(il.Size(), 3);
+	EXPECT_TRUE(il.IsInline());
+	EXPECT_EQ(il[2], 2);
+
+	u32 src[7] = { 0, 1, 2, 3, 4, 5, 6 };
+	SmallDynArray<u32, 4> range{ (u32*)src, src + 7 };
+	EXPECT_EQ(range.Size(), 7);
+	EXPECT_EQ(range[6], 6);
+
+	SmallDynArray<u32, 4> copy{ range };
+	EXPECT_EQ(copy.Size(), 7);
+	EXPECT_EQ(copy[6], 6);
+	EXPECT_NE(copy.Data(), range.Data());
+}
+
+TEST(SmallDynArrayTest, MoveHeap)
+{
+	SmallDynArrayCountingAlloc alloc;
+	SmallDynArray<u32, 2> src{ alloc };
+	for (u32 i = 0; i < 10; ++i)
+		src.Add(i);
+
+	const u32* pData = src.Data();
+	const u32 numAllocs = alloc.numAllocs;
+
+	SmallDynArray<u32, 2> dst{ Move(src) };
+	EXPECT_EQ(dst.Data(), pData);
+	EXPECT_EQ(alloc.numAllocs, numAllocs);
+	EXPECT_EQ(dst.Size(), 10);
+	EXPECT_EQ(dst[9], 9);
+	EXPECT_TRUE(src.IsEmpty());
+	EXPECT_TRUE(src.IsInline());
+
+	SmallDynArray<u32, 2> assigned{ alloc };
+	assigned.Add(5);
+	assigned = Move(dst);
+	EXPECT_EQ(assigned.Data(), pData);
+	EXPECT_EQ(assigned.Size(), 10);
+	EXPECT_TRUE(dst.IsEmpty());
+}
+
+TEST(SmallDynArrayTest, MoveInline)
+{
+	SmallDynArrayCounter::alive = 0;
+	{
+		SmallDynArray<SmallDynArrayCounter, 4> src;
+		src.EmplaceBack(1u);
+		src.EmplaceBack(2u);
+
+		SmallDynArray<SmallDynArrayCounter, 4> dst{ Move(src) };
+		EXPECT_TRUE(dst.IsInline());
+		EXPECT_EQ(dst.Size(), 2);
+		EXPECT_EQ(dst[0].val, 1);
+		EXPECT_EQ(dst[1].val, 2);
+		EXPECT_TRUE(src.IsEmpty());
+		EXPECT_EQ(SmallDynArrayCounter::alive, 2);
+	}
+	EXPECT_EQ(SmallDynArrayCounter::alive, 0);
+}
+
+TEST(SmallDynArrayTest, InsertErase)
+{
+	SmallDynArrayCounter::alive = 0;
+	{
+		SmallDynArray<SmallDynArrayCounter, 3> arr;
+		arr.Add(SmallDynArrayCounter{ 0 });
+		arr.Add(SmallDynArrayCounter{ 3 });
+		arr.Insert(1, { SmallDynArrayCounter{ 1 }, SmallDynArrayCounter{ 2 } });
+		EXPECT_FALSE(arr.IsInline());
+		EXPECT_EQ(arr.Size(), 4);
+		for (u32 i = 0; i < 4; ++i)
+			EXPECT_EQ(arr[i].val, i);
+
+		SmallDynArrayCounter extracted = arr.Extract(1);
+		EXPECT_EQ(extracted.val, 1);
+		EXPECT_EQ(arr.Size(), 3);
+		EXPECT_EQ(arr[1].val, 2);
+
+		arr.EraseAt(0);
+		EXPECT_EQ(arr.Size(), 2);
+		EXPECT_EQ(arr[0].val, 2);
+		EXPECT_EQ(arr[1].val, 3);
+
+		arr.EraseIf([](const SmallDynArrayCounter& val) { return val.val == 3; });
+		EXPECT_EQ(arr.Size(), 1);
+		EXPECT_TRUE(arr.Contains(SmallDynArrayCounter{ 2 }));
+		EXPECT_FALSE(arr.Contains(SmallDynArrayCounter{ 3 }));
+
+		arr.Clear(true);
+		EXPECT_TRUE(arr.IsInline());
+		EXPECT_EQ(SmallDynArrayCounter::alive, 1);
+	}
+	EXPECT_EQ(SmallDynArrayCounter::alive, 0);
+}
+
+TEST(SmallDynArrayTest, UniqueElements)
+{
+	SmallDynArray<Unique<u32>, 2> arr;
+	arr.Add(Unique<u32>::Create(1u));
+	arr.Add(Unique<u32>::Create(2u));
+	arr.Add(Unique<u32>::Create(3u));
+	EXPECT_FALSE(arr.IsInline());
+
+	SmallDynArray<Unique<u32>, 2> moved{ Move(arr) };
+	EXPECT_EQ(moved.Size(), 3);
+	EXPECT_EQ(*moved[0], 1);
+	EXPECT_EQ(*moved[2], 3);
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(SparseSetTest, DefaultInit)
+{
+	Alloc::Mallocator mallocator;
+	SparseSet<u32> set{ mallocator };
+	ASSERT_EQ(set.Begin(), set.End());
+	ASSERT_EQ(set.Size(), 0);
+	EXPECT_TRUE(set.IsEmpty());
+	EXPECT_FALSE(set.Contains(0));
+	EXPECT_EQ(set.IndexOf(0), SparseSet<u32>::InvalidIndex);
+}
+
+TEST(SparseSetTest, Insert)
+{
+	Alloc::Mallocator mallocator;
+	SparseSet<u32> set{ mallocator };
+
+	EXPECT_TRUE(set.Insert(5));
+	EXPECT_TRUE(set.Insert(1));
+	EXPECT_TRUE(set.Insert(100));
+	EXPECT_FALSE(set.Insert(5));
+	ASSERT_EQ(set.Size(), 3);
+
+	EXPECT_TRUE(set.Contains(5));
+	EXPECT_TRUE(set.Contains(1));
+	EXPECT_TRUE(set.Contains(100));
+	EXPECT_FALSE(set.Contains(2));
+	EXPECT_FALSE(set.Contains(1000));
+
+	EXPECT_EQ(set.IndexOf(5), 0);
+	EXPECT_EQ(set.IndexOf(1), 1);
+	EXPECT_EQ(set.IndexOf(100), 2);
+	EXPECT_EQ(set.GetIdAt(2), 100);
+}
+
+TEST(SparseSetTest, Erase)
+{
+	Alloc::Mallocator mallocator;
+	SparseSet<u32> set{ mallocator };
+
+	set.Insert(5);
+	set.Insert(1);
+	set.Insert(100);
+
+	// The last id is moved into the index of the erased id
+	EXPECT_EQ(set.Erase(5), 0);
+	EXPECT_EQ(set.GetIdAt(0), 100);
+	EXPECT_EQ(set.IndexOf(100), 0);
+	EXPECT_FALSE(set.Contains(5));
+	ASSERT_EQ(set.Size(), 2);
+
+	EXPECT_EQ(set.Erase(5), SparseSet<u32>::InvalidIndex);
+	EXPECT_EQ(set.Erase(1000), SparseSet<u32>::InvalidIndex);
+
+	EXPECT_EQ(set.Erase(1), 1);
+	EXPECT_EQ(set.Erase(100), 0);
+	EXPECT_TRUE(set.IsEmpty());
+
+	EXPECT_TRUE(set.Insert(5));
+	EXPECT_EQ(set.IndexOf(5), 0);
+}
+
+TEST(SparseSetTest, Clear)
+{
+	Alloc::Mallocator mallocator;
+	SparseSet<u32> set{ mallocator };
+	set.Reserve(16, 64);
+
+	for (u32 i = 0; i < 64; i += 4)
+		set.Insert(i);
+	ASSERT_EQ(set.Size(), 16);
+
+	u32 sum = 0;
+	for (u32 id : set)
+		sum += id;
+	EXPECT_EQ(sum, 4 * (15 * 16 / 2));
+
+	set.Clear();
+	EXPECT_TRUE(set.IsEmpty());
+	for (u32 i = 0; i < 64; ++i)
+		EXPECT_FALSE(set.Contains(i));
+
+	set.Clear(true);
+	EXPECT_TRUE(set.IsEmpty());
+}
@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+TEST(TimerWheelTest, DefaultInit)
+{
+	TimerWheel<u32> wheel;
+	EXPECT_EQ(wheel.Size(), 0);
+	EXPECT_TRUE(wheel.IsEmpty());
+	EXPECT_EQ(wheel.GetCurrentTick(), 0);
+	EXPECT_FALSE(wheel.IsPending(0));
+}
+
+TEST(TimerWheelTest, FireInOrder)
+{
+	TimerWheel<u32> wheel{ 1.f };
+	wheel.ScheduleTicks(3, 3);
+	wheel.ScheduleTicks(1, 1);
+	wheel.ScheduleTicks(2, 2);
+	wheel.ScheduleTicks(0, 0);
+	EXPECT_EQ(wheel.Size(), 4);
+
+	DynArray<u32> fired;
+	EXPECT_EQ(wheel.AdvanceTicks(1, [&fired](u32& val) { fired.Add(val); }), 2);
+	EXPECT_EQ(wheel.AdvanceTicks(2, [&fired](u32& val) { fired.Add(val); }), 2);
+	EXPECT_TRUE(wheel.IsEmpty());
+
+	ASSERT_EQ(fired.Size(), 4);
+	EXPECT_EQ(fired[2], 2);
+	EXPECT_EQ(fired[3], 3);
+}
+
+TEST(TimerWheelTest, DeltaTime)
+{
+	TimerWheel<u32> wheel{ 0.01f };
+	const TimerWheel<u32>::Handle handle = wheel.Schedule(0.5f, 1);
+
+	u32 numFired = 0;
+	for (u32 i = 0; i < 49; ++i)
+		numFired += u32(wheel.Advance(Chrono::DeltaTime{ 0.01f }, [](u32&) {}));
+	EXPECT_EQ(numFired, 0);
+	EXPECT_TRUE(wheel.IsPending(handle));
+
+	// Dilation slows down time, so the remaining tick needs twice the time
+	numFired += u32(wheel.Advance(Chrono::DeltaTime{ 0.01f, 0.5f }, [](u32&) {}));
+	EXPECT_EQ(numFired, 0);
+	numFired += u32(wheel.Advance(Chrono::DeltaTime{ 0.01f, 0.5f }, [](u32&) {}));
+	EXPECT_EQ(numFired, 1);
+	EXPECT_FALSE(wheel.IsPending(handle));
+}
+
+TEST(TimerWheelTest, Cascade)
+{
+	TimerWheel<u64> wheel{ 1.f };
+	const u64 delays[] = { 255, 256, 257, 1000, 65535, 65536, 70000, 16777216, 20000000 };
+	for (u64 delay : delays)
+		wheel.ScheduleTicks(delay, u64(delay));
+
+	DynArray<u64> fired;
+	u64 numChecked = 0;
+	for (u64 delay : delays)
+	{
+		const u64 ticks = delay - wheel.GetCurrentTick();
+		wheel.AdvanceTicks(ticks - 1, [&fired](u64& val) { fired.Add(val); });
+		EXPECT_EQ(fired.Size(), numChecked);
+
+		wheel.AdvanceTicks(1, [&fired, &wheel](u64& val) { EXPECT_EQ(val, wheel.GetCurrentTick()); fired.Add(val); });
+		++numChecked;
+		EXPECT_EQ(fired.Size(), numChecked);
+	}
+	EXPECT_TRUE(wheel.IsEmpty());
+}
+
+TEST(TimerWheelTest, BeyondRange)
+{
+	TimerWheel<u64> wheel{ 1.f };
+	const u64 delay = TimerWheel<u64>::MaxTicks + 1000;
+	wheel.ScheduleTicks(delay, u64(delay));
+
+	u64 fireTick = 0;
+	wheel.AdvanceTicks(delay - 1, [&fireTick, &wheel](u64&) { fireTick = wheel.GetCurrentTick(); });
+	EXPECT_EQ(fireTick, 0);
+	wheel.AdvanceTicks(1, [&fireTick, &wheel](u64&) { fireTick = wheel.GetCurrentTick(); });
+	EXPECT_EQ(fireTick, delay);
+}
+
+TEST(TimerWheelTest, CancelReschedule)
+{
+	TimerWheel<u32> wheel{ 1.f };
+	const TimerWheel<u32>::Handle a = wheel.ScheduleTicks(10, 1);
+	const TimerWheel<u32>::Handle b = wheel.ScheduleTicks(10, 2);
+	const TimerWheel<u32>::Handle c = wheel.ScheduleTicks(10, 3);
+
+	EXPECT_TRUE(wheel.Cancel(b));
+	EXPECT_FALSE(wheel.Cancel(b));
+	EXPECT_TRUE(wheel.Reschedule(c, 300.f));
+	EXPECT_EQ(wheel.Size(), 2);
+
+	u32 sum = 0;
+	wheel.AdvanceTicks(10, [&sum](u32& val) { sum += val; });
+	EXPECT_EQ(sum, 1);
+	EXPECT_FALSE(wheel.IsPending(a));
+	EXPECT_FALSE(wheel.Reschedule(a, 1.f));
+
+	// A new timer reuses the node of a fired timer, the old handle needs to stay invalid
+	const TimerWheel<u32>::Handle d = wheel.ScheduleTicks(5, 4);
+	EXPECT_NE(d, a);
+	EXPECT_FALSE(wheel.Cancel(a));
+	EXPECT_TRUE(wheel.IsPending(d));
+
+	wheel.AdvanceTicks(300, [&sum](u32& val) { sum += val; });
+	EXPECT_EQ(sum, 8);
+	EXPECT_TRUE(wheel.IsEmpty());
+}
+
+TEST(TimerWheelTest, CallbackModifiesWheel)
+{
+	TimerWheel<u32> wheel{ 1.f };
+	DynArray<TimerWheel<u32>::Handle> handles;
+	for (u32 i = 0; i < 4; ++i)
+		handles.Add(wheel.ScheduleTicks(5, u32(i)));
+
+	// The first timer that fires cancels all others on the same tick and schedules a repeat
+	u32 numFired = 0;
+	auto callback = [&](u32& val)
+	{
+		++numFired;
+		for (TimerWheel<u32>::Handle handle : handles)
+			wheel.Cancel(handle);
+		if (val < 10)
+			handles.Add(wheel.ScheduleTicks(0, val + 10));
+	};
+
+	EXPECT_EQ(wheel.AdvanceTicks(5, callback), 1);
+	EXPECT_EQ(wheel.Size(), 1);
+	EXPECT_EQ(wheel.AdvanceTicks(1, callback), 1);
+	EXPECT_EQ(numFired, 2);
+	EXPECT_TRUE(wheel.IsEmpty());
+}
+
+TEST(TimerWheelTest, ManyTimers)
+{
+	TimerWheel<u64> wheel{ 1.f };
+	wheel.Reserve(10000);
+	u32 state = 1;
+	for (u32 i = 0; i < 10000; ++i)
+	{
+		state = state * 1664525u + 1013904223u;
+		const u64 ticks = (state >> 8) % 100000 + 1;
+		wheel.ScheduleTicks(ticks, u64(ticks));
+	}
+
+	usize numFired = 0;
+	usize numLate = 0;
+	while (!wheel.IsEmpty())
+		numFired += wheel.AdvanceTicks(997, [&](u64& val) { numLate += val != wheel.GetCurrentTick(); });
+	EXPECT_EQ(numFired, 10000);
+	EXPECT_EQ(numLate, 0);
+}
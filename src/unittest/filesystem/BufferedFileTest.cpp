@@ -0,0 +1,278 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+#include "FileSystemTestUtils.h"
+
+using namespace Onca;
+using namespace Onca::FileSystem;
+using namespace TestUtils;
+
+namespace
+{
+	auto CreateWriteFile(const Path& path, bool async) -> File
+	{
+		Result<File, SystemError> res = File::Create(path, FileCreateKind::CreateAlways, AccessMode::ReadWrite, ShareMode::Read,
+		                                             FileAttribute::None, async ? FileFlag::AllowAsync : FileFlag::None);
+		EXPECT_FALSE(res.Failed());
+		return res.MoveValue();
+	}
+
+	auto OpenReadFile(const Path& path, bool async) -> File
+	{
+		Result<File, SystemError> res = File::Open(path, false, AccessMode::Read, ShareMode::Read, async ? FileFlag::AllowAsync : FileFlag::None);
+		EXPECT_FALSE(res.Failed());
+		return res.MoveValue();
+	}
+}
+
+TEST(BufferedFileTest, WriterChunkBoundaries)
+{
+	const Path path = GetTestPath("unittest_buffered_writer_chunks.bin");
+	const DynArray<u8> data = MakeTestData(1000);
+	{
+		BufferedFileWriter writer{ CreateWriteFile(path, false), { .bufferSize = 64 } };
+		ASSERT_TRUE(writer.IsValid());
+
+		// Chunks that don't divide the buffer size, so writes straddle buffer boundaries
+		usize offset = 0;
+		while (offset < data.Size())
+		{
+			const usize size = Math::Min<usize>(10, data.Size() - offset);
+			EXPECT_TRUE(writer.Write(data.Data() + offset, size).Succeeded());
+			offset += size;
+
+			EXPECT_EQ(writer.GetOffset(), offset);
+			EXPECT_LE(writer.GetBufferedSize(), 64);
+			EXPECT_GT(writer.GetBufferedSize(), 0);
+		}
+
+		// Nothing past the last full buffer has been written yet
+		EXPECT_EQ(writer.GetFile().GetFileSize(), offset - writer.GetBufferedSize());
+
+		EXPECT_TRUE(writer.Flush().Succeeded());
+		EXPECT_EQ(writer.GetBufferedSize(), 0);
+		EXPECT_EQ(writer.GetFile().GetFileSize(), data.Size());
+	}
+	EXPECT_TRUE(FileContentEquals(path, data));
+	UNUSED(DeleteFile(path));
+}
+
+TEST(BufferedFileTest, WriterLargeWritesGoDirect)
+{
+	const Path path = GetTestPath("unittest_buffered_writer_direct.bin");
+	const DynArray<u8> data = MakeTestData(10 + 64 + 200 + 5);
+	{
+		BufferedFileWriter writer{ CreateWriteFile(path, false), { .bufferSize = 64 } };
+
+		EXPECT_TRUE(writer.Write(data.Data(), 10).Succeeded());
+		EXPECT_EQ(writer.GetBufferedSize(), 10);
+		EXPECT_EQ(writer.GetFile().GetFileSize(), 0);
+
+		// A write of exactly a full buffer flushes the buffered data first, then bypasses the buffer
+		EXPECT_TRUE(writer.Write(data.Data() + 10, 64).Succeeded());
+		EXPECT_EQ(writer.GetBufferedSize(), 0);
+		EXPECT_EQ(writer.GetFile().GetFileSize(), 74);
+
+		EXPECT_TRUE(writer.Write(data.Data() + 74, 200).Succeeded());
+		EXPECT_EQ(writer.GetBufferedSize(), 0);
+		EXPECT_EQ(writer.GetFile().GetFileSize(), 274);
+
+		const WriteRegion regions[] = { { data.Data() + 274, 2 }, { data.Data() + 276, 3 } };
+		EXPECT_TRUE(writer.WriteV(regions, 2).Succeeded());
+		EXPECT_EQ(writer.GetBufferedSize(), 5);
+		EXPECT_EQ(writer.GetOffset(), data.Size());
+
+		EXPECT_TRUE(writer.Close().Succeeded());
+		EXPECT_FALSE(writer.IsValid());
+		EXPECT_EQ(writer.Write(data.Data(), 1).code, SystemErrorCode::InvalidHandle);
+	}
+	EXPECT_TRUE(FileContentEquals(path, data));
+	UNUSED(DeleteFile(path));
+}
+
+TEST(BufferedFileTest, WriterDoubleBufferOrdering)
+{
+	const Path path = GetTestPath("unittest_buffered_writer_double.bin");
+	const DynArray<u8> data = MakeTestData(256_KiB + 123);
+	{
+		BufferedFileWriter writer{ CreateWriteFile(path, true), { .bufferSize = 4096, .doubleBuffer = true } };
+
+		// Mix buffered and direct writes, so asynchronous buffer writes and direct writes need to land in order
+		usize offset = 0;
+		for (usize i = 0; offset < data.Size(); ++i)
+		{
+			const usize chunk = i % 16 == 15 ? 5000 : 100 + i % 7 * 300;
+			const usize size = Math::Min(chunk, data.Size() - offset);
+			EXPECT_TRUE(writer.Write(data.Data() + offset, size).Succeeded());
+			offset += size;
+			EXPECT_EQ(writer.GetOffset(), offset);
+		}
+		EXPECT_TRUE(writer.Flush().Succeeded());
+		EXPECT_EQ(writer.GetFile().GetFileSize(), data.Size());
+	}
+	EXPECT_TRUE(FileContentEquals(path, data));
+	UNUSED(DeleteFile(path));
+}
+
+TEST(BufferedFileTest, WriterSetFile)
+{
+	const Path path0 = GetTestPath("unittest_buffered_writer_set0.bin");
+	const Path path1 = GetTestPath("unittest_buffered_writer_set1.bin");
+	const DynArray<u8> data = MakeTestData(100);
+	{
+		BufferedFileWriter writer{ { .bufferSize = 64 } };
+		EXPECT_FALSE(writer.IsValid());
+
+		EXPECT_TRUE(writer.SetFile(CreateWriteFile(path0, false)).Succeeded());
+		EXPECT_TRUE(writer.Write(data.Data(), 50).Succeeded());
+
+		// Switching files flushes the data buffered for the previous file
+		EXPECT_TRUE(writer.SetFile(CreateWriteFile(path1, false)).Succeeded());
+		EXPECT_EQ(writer.GetOffset(), 0);
+		EXPECT_TRUE(writer.Write(data.Data() + 50, 50).Succeeded());
+	}
+	EXPECT_TRUE(FileContentEquals(path0, DynArray<u8>{ data.Data(), data.Data() + 50 }));
+	EXPECT_TRUE(FileContentEquals(path1, DynArray<u8>{ data.Data() + 50, data.Data() + 100 }));
+	UNUSED(DeleteFile(path0));
+	UNUSED(DeleteFile(path1));
+}
+
+TEST(BufferedFileTest, ReaderChunkBoundaries)
+{
+	const Path path = GetTestPath("unittest_buffered_reader_chunks.bin");
+	const DynArray<u8> data = MakeTestData(1000);
+	WriteTestFile(path, data);
+	{
+		BufferedFileReader reader{ OpenReadFile(path, false), { .bufferSize = 64 } };
+		ASSERT_TRUE(reader.IsValid());
+
+		DynArray<u8> read;
+		read.Resize(data.Size());
+		usize offset = 0;
+		while (!reader.IsEof())
+		{
+			Result<usize, SystemError> res = reader.Read(read.Data() + offset, Math::Min<usize>(10, read.Size() - offset));
+			ASSERT_FALSE(res.Failed());
+			ASSERT_GT(res.Value(), 0);
+			offset += res.Value();
+			EXPECT_EQ(reader.GetOffset(), offset);
+		}
+		EXPECT_EQ(offset, data.Size());
+		EXPECT_EQ(MemCmp(read.Data(), data.Data(), data.Size()), 0);
+
+		// Reading at the end of the file returns 0 bytes
+		u8 byte;
+		Result<usize, SystemError> res = reader.Read(&byte, 1);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), 0);
+	}
+	UNUSED(DeleteFile(path));
+}
+
+TEST(BufferedFileTest, ReaderLargeReadsAndSkip)
+{
+	const Path path = GetTestPath("unittest_buffered_reader_direct.bin");
+	const DynArray<u8> data = MakeTestData(1000);
+	WriteTestFile(path, data);
+	{
+		BufferedFileReader reader{ OpenReadFile(path, false), { .bufferSize = 64 } };
+
+		u8 buffer[300];
+		Result<usize, SystemError> res = reader.Read(buffer, 10);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), 10);
+
+		// The rest of the buffer is consumed first, the remainder is read directly
+		res = reader.Read(buffer + 10, 200);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), 200);
+		EXPECT_EQ(MemCmp(buffer, data.Data(), 210), 0);
+		EXPECT_EQ(reader.GetOffset(), 210);
+
+		// Skip past the buffer, then within the refilled buffer
+		reader.Skip(5);
+		res = reader.Read(buffer, 5);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(MemCmp(buffer, data.Data() + 215, 5), 0);
+
+		reader.Skip(10);
+		res = reader.Read(buffer, 5);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(MemCmp(buffer, data.Data() + 230, 5), 0);
+
+		reader.Skip(485);
+		EXPECT_EQ(reader.GetOffset(), 720);
+		res = reader.Read(buffer, 64);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(MemCmp(buffer, data.Data() + 720, 64), 0);
+
+		// A read past the end of the file only returns the remaining data
+		res = reader.Read(buffer, 300);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), 1000 - 784);
+		EXPECT_EQ(MemCmp(buffer, data.Data() + 784, 1000 - 784), 0);
+		EXPECT_TRUE(reader.IsEof());
+
+		reader.Skip(10);
+		EXPECT_EQ(reader.GetOffset(), 1000);
+	}
+	UNUSED(DeleteFile(path));
+}
+
+TEST(BufferedFileTest, ReaderDoubleBuffer)
+{
+	const Path path = GetTestPath("unittest_buffered_reader_double.bin");
+	const DynArray<u8> data = MakeTestData(256_KiB + 123);
+	WriteTestFile(path, data);
+	{
+		BufferedFileReader reader{ OpenReadFile(path, true), { .bufferSize = 4096, .doubleBuffer = true } };
+
+		// Mix buffered reads, which switch to prefetched buffers, with direct reads, which cancel the prefetch
+		DynArray<u8> read;
+		read.Resize(data.Size());
+		usize offset = 0;
+		for (usize i = 0; !reader.IsEof(); ++i)
+		{
+			const usize chunk = i % 16 == 15 ? 5000 : 100 + i % 7 * 300;
+			Result<usize, SystemError> res = reader.Read(read.Data() + offset, Math::Min(chunk, read.Size() - offset));
+			ASSERT_FALSE(res.Failed());
+			offset += res.Value();
+		}
+		EXPECT_EQ(offset, data.Size());
+		EXPECT_EQ(MemCmp(read.Data(), data.Data(), data.Size()), 0);
+	}
+	UNUSED(DeleteFile(path));
+}
+
+TEST(BufferedFileTest, ReadToEnd)
+{
+	const Path path = GetTestPath("unittest_buffered_reader_to_end.txt");
+	const String str{ "Buffered readers can read the rest of a file as a string" };
+	WriteTestFile(path, DynArray<u8>{ str.Data(), str.Data() + str.DataSize() });
+	{
+		BufferedFileReader reader{ OpenReadFile(path, false), { .bufferSize = 16 } };
+
+		u8 buffer[9];
+		Result<usize, SystemError> readRes = reader.Read(buffer, 9);
+		ASSERT_FALSE(readRes.Failed());
+		EXPECT_EQ(readRes.Value(), 9);
+
+		const String rest{ str, 9 };
+		Result<String, SystemError> res = reader.ReadStringToEnd();
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), rest);
+		EXPECT_TRUE(reader.IsEof());
+
+		res = reader.ReadStringToEnd();
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(res.Value().IsEmpty());
+	}
+	{
+		BufferedFileReader reader{ OpenReadFile(path, false), { .bufferSize = 16 } };
+		Result<ByteBuffer, SystemError> res = reader.ReadToEnd();
+		ASSERT_FALSE(res.Failed());
+		const ByteBuffer content = res.MoveValue();
+		EXPECT_EQ(content.Size(), str.DataSize());
+		EXPECT_EQ(MemCmp(content.Data(), str.Data(), str.DataSize()), 0);
+	}
+	UNUSED(DeleteFile(path));
+}
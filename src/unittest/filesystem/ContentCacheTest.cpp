@@ -0,0 +1,304 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+#include "FileSystemTestUtils.h"
+
+using namespace Onca;
+using namespace Onca::FileSystem;
+using namespace TestUtils;
+
+namespace
+{
+	auto ViewEquals(const ContentView& view, const ByteBuffer& data) -> bool
+	{
+		return view.Size() == data.Size() && MemCmp(view.Data(), data.Data(), data.Size()) == 0;
+	}
+
+	// Overwrite a file with part of its current content, followed by optional garbage
+	void RewriteFile(const Path& path, usize keepSize, usize garbageSize = 0)
+	{
+		Result<ByteBuffer, SystemError> res = ReadAll(path);
+		ASSERT_FALSE(res.Failed());
+		ByteBuffer content = res.MoveValue();
+		ASSERT_LE(keepSize, content.Size());
+
+		DynArray<u8> data{ content.Data(), content.Data() + keepSize };
+		for (usize i = 0; i < garbageSize; ++i)
+			data.Add(0xCD);
+
+		WriteTestFile(path, data);
+	}
+}
+
+TEST(ContentCacheTest, PutGet)
+{
+	const Path dir = CreateTestDir("unittest_content_cache_put_get");
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_TRUE(cache.IsOpen());
+		EXPECT_EQ(cache.GetCount(), 0);
+
+		const ByteBuffer data0{ MakeTestData(1000, 0) };
+		const ByteBuffer data1{ MakeTestData(3000, 1) };
+		const ContentKey key0 = ContentKey::FromData(data0.Data(), data0.Size());
+		const ContentKey key1 = ContentKey::FromData(data1.Data(), data1.Size());
+		EXPECT_NE(key0, key1);
+
+		EXPECT_TRUE(cache.Put(key0, data0).Succeeded());
+		EXPECT_TRUE(cache.Put(key1, data1).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 2);
+		EXPECT_EQ(cache.GetPackSize(), 4000);
+		EXPECT_TRUE(cache.Contains(key0));
+		EXPECT_TRUE(cache.Contains(key1));
+
+		Result<ContentView, SystemError> res = cache.Get(key0);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(ViewEquals(res.MoveValue(), data0));
+
+		res = cache.Get(key1);
+		ASSERT_FALSE(res.Failed());
+		const ContentView view = res.MoveValue();
+		EXPECT_TRUE(ViewEquals(view, data1));
+		const ByteBuffer copy = view.ToBuffer();
+		EXPECT_EQ(copy.Size(), data1.Size());
+		EXPECT_EQ(MemCmp(copy.Data(), data1.Data(), data1.Size()), 0);
+
+		// A missing key is not an error of the file system
+		res = cache.Get(ContentKey{ 1, 2 });
+		ASSERT_TRUE(res.Failed());
+		EXPECT_EQ(res.Error().code, SystemErrorCode::NotFound);
+		EXPECT_FALSE(cache.Contains(ContentKey{ 1, 2 }));
+
+		// Empty entries don't need to touch the pack
+		EXPECT_TRUE(cache.Put(ContentKey{ 3, 4 }, nullptr, 0).Succeeded());
+		res = cache.Get(ContentKey{ 3, 4 });
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(res.MoveValue().IsEmpty());
+
+		cache.Close();
+		EXPECT_FALSE(cache.IsOpen());
+		EXPECT_EQ(cache.Get(key0).Error().code, SystemErrorCode::InvalidHandle);
+	}
+	DeleteDirectory(dir, true);
+}
+
+TEST(ContentCacheTest, Overwrite)
+{
+	const Path dir = CreateTestDir("unittest_content_cache_overwrite");
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+
+		const ContentKey key{ "overwritten"_sid };
+		const ByteBuffer data0{ MakeTestData(500, 0) };
+		const ByteBuffer data1{ MakeTestData(700, 1) };
+
+		EXPECT_TRUE(cache.Put(key, data0).Succeeded());
+		Result<ContentView, SystemError> res = cache.Get(key);
+		ASSERT_FALSE(res.Failed());
+		const ContentView oldView = res.MoveValue();
+
+		EXPECT_TRUE(cache.Put(key, data1).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 1);
+		res = cache.Get(key);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(ViewEquals(res.MoveValue(), data1));
+
+		// The old data is only dropped when compacting, views into the old pack stay valid
+		EXPECT_EQ(cache.GetPackSize(), 1200);
+		EXPECT_TRUE(cache.Compact().Succeeded());
+		EXPECT_EQ(cache.GetPackSize(), 700);
+		EXPECT_TRUE(ViewEquals(oldView, data0));
+
+		res = cache.Get(key);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(ViewEquals(res.MoveValue(), data1));
+	}
+	DeleteDirectory(dir, true);
+}
+
+TEST(ContentCacheTest, Remove)
+{
+	const Path dir = CreateTestDir("unittest_content_cache_remove");
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+
+		const ByteBuffer data{ MakeTestData(256, 0) };
+		for (u64 i = 0; i < 10; ++i)
+			EXPECT_TRUE(cache.Put(ContentKey{ i, 0 }, data).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 10);
+
+		for (u64 i = 0; i < 10; i += 2)
+			EXPECT_TRUE(cache.Remove(ContentKey{ i, 0 }));
+		EXPECT_FALSE(cache.Remove(ContentKey{ 0, 0 }));
+		EXPECT_FALSE(cache.Remove(ContentKey{ 1, 1 }));
+		EXPECT_EQ(cache.GetCount(), 5);
+
+		for (u64 i = 0; i < 10; ++i)
+		{
+			EXPECT_EQ(cache.Contains(ContentKey{ i, 0 }), (i & 1) == 1);
+			EXPECT_EQ(cache.Get(ContentKey{ i, 0 }).Failed(), (i & 1) == 0);
+		}
+
+		EXPECT_TRUE(cache.Compact().Succeeded());
+		EXPECT_EQ(cache.GetCount(), 5);
+		EXPECT_EQ(cache.GetPackSize(), 5 * 256);
+	}
+	DeleteDirectory(dir, true);
+}
+
+TEST(ContentCacheTest, Reopen)
+{
+	const Path dir = CreateTestDir("unittest_content_cache_reopen");
+	const ByteBuffer data{ MakeTestData(4096, 0) };
+	const ContentKey key = ContentKey::FromData(data.Data(), data.Size());
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_TRUE(cache.Put(key, data).Succeeded());
+		EXPECT_TRUE(cache.Put(ContentKey{ 1, 0 }, data).Succeeded());
+		EXPECT_TRUE(cache.Remove(ContentKey{ 1, 0 }));
+		EXPECT_TRUE(cache.Flush().Succeeded());
+	}
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 1);
+		EXPECT_FALSE(cache.Contains(ContentKey{ 1, 0 }));
+
+		Result<ContentView, SystemError> res = cache.Get(key);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(ViewEquals(res.MoveValue(), data));
+	}
+	DeleteDirectory(dir, true);
+}
+
+TEST(ContentCacheTest, Eviction)
+{
+	const Path dir = CreateTestDir("unittest_content_cache_eviction");
+	{
+		ContentCache cache{ { .maxPackSize = 64_KiB, .evictPercentage = 50, .initialCapacity = 16 } };
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+
+		// Keep accessing the first entry, so it is the most recently used entry when evicting
+		const ByteBuffer data{ MakeTestData(4_KiB, 0) };
+		for (u64 i = 0; i < 32; ++i)
+		{
+			EXPECT_TRUE(cache.Put(ContentKey{ i, 0 }, data).Succeeded());
+			EXPECT_TRUE(cache.Contains(ContentKey{ 0, 0 }));
+			EXPECT_FALSE(cache.Get(ContentKey{ 0, 0 }).Failed());
+			EXPECT_LE(cache.GetPackSize(), 64_KiB);
+		}
+
+		EXPECT_LT(cache.GetCount(), 32);
+		EXPECT_TRUE(cache.Contains(ContentKey{ 0, 0 }));
+		EXPECT_TRUE(cache.Contains(ContentKey{ 31, 0 }));
+		EXPECT_FALSE(cache.Contains(ContentKey{ 1, 0 }));
+
+		// Compacting to a target size keeps the most recently used entries
+		EXPECT_TRUE(cache.Compact(8_KiB).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 2);
+		EXPECT_EQ(cache.GetPackSize(), 8_KiB);
+		EXPECT_TRUE(cache.Contains(ContentKey{ 0, 0 }));
+		EXPECT_TRUE(cache.Contains(ContentKey{ 31, 0 }));
+	}
+	DeleteDirectory(dir, true);
+}
+
+TEST(ContentCacheTest, CorruptIndex)
+{
+	const Path dir = CreateTestDir("unittest_content_cache_corrupt_index");
+	const Path indexPath = dir / "index.bin"_path;
+	const ByteBuffer data{ MakeTestData(1000, 0) };
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_TRUE(cache.Put(ContentKey{ 1, 0 }, data).Succeeded());
+		EXPECT_TRUE(cache.Flush().Succeeded());
+	}
+
+	// A truncated index results in an empty cache
+	RewriteFile(indexPath, 100);
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 0);
+		EXPECT_EQ(cache.GetPackSize(), 0);
+		EXPECT_FALSE(cache.Contains(ContentKey{ 1, 0 }));
+
+		EXPECT_TRUE(cache.Put(ContentKey{ 2, 0 }, data).Succeeded());
+		EXPECT_TRUE(cache.Flush().Succeeded());
+	}
+
+	// So does an index with a corrupted header
+	RewriteFile(indexPath, 0, 4096);
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 0);
+		EXPECT_FALSE(cache.Contains(ContentKey{ 2, 0 }));
+	}
+	DeleteDirectory(dir, true);
+}
+
+TEST(ContentCacheTest, TornTail)
+{
+	const Path dir = CreateTestDir("unittest_content_cache_torn_tail");
+	const Path packPath = dir / "pack0.bin"_path;
+	const ByteBuffer flushed{ MakeTestData(1000, 0) };
+	const ByteBuffer unflushed0{ MakeTestData(500, 1) };
+	const ByteBuffer unflushed1{ MakeTestData(500, 2) };
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_TRUE(cache.Put(ContentKey{ 0, 0 }, flushed).Succeeded());
+		EXPECT_TRUE(cache.Flush().Succeeded());
+		EXPECT_TRUE(cache.Put(ContentKey{ 1, 0 }, unflushed0).Succeeded());
+		EXPECT_TRUE(cache.Put(ContentKey{ 2, 0 }, unflushed1).Succeeded());
+	}
+
+	// Entries after the last flush with intact data are kept
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 3);
+		EXPECT_EQ(cache.GetPackSize(), 2000);
+	}
+
+	// Simulate a crash where the last entry only partially reached the disk
+	RewriteFile(packPath, 1700);
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 2);
+		EXPECT_EQ(cache.GetPackSize(), 1500);
+		EXPECT_FALSE(cache.Contains(ContentKey{ 2, 0 }));
+
+		Result<ContentView, SystemError> res = cache.Get(ContentKey{ 1, 0 });
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(ViewEquals(res.MoveValue(), unflushed0));
+	}
+
+	// Simulate a crash where the pack was extended, but its data was never written, the torn tail is truncated
+	RewriteFile(packPath, 1000, 500);
+	{
+		ContentCache cache;
+		ASSERT_TRUE(cache.Open(dir).Succeeded());
+		EXPECT_EQ(cache.GetCount(), 1);
+		EXPECT_EQ(cache.GetPackSize(), 1000);
+		EXPECT_FALSE(cache.Contains(ContentKey{ 1, 0 }));
+
+		// New entries are appended directly after the last valid entry
+		EXPECT_TRUE(cache.Put(ContentKey{ 3, 0 }, unflushed1).Succeeded());
+		EXPECT_EQ(cache.GetPackSize(), 1500);
+
+		Result<ContentView, SystemError> res = cache.Get(ContentKey{ 0, 0 });
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(ViewEquals(res.MoveValue(), flushed));
+		res = cache.Get(ContentKey{ 3, 0 });
+		ASSERT_FALSE(res.Failed());
+		EXPECT_TRUE(ViewEquals(res.MoveValue(), unflushed1));
+	}
+	DeleteDirectory(dir, true);
+}
@@ -0,0 +1,189 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+#include "FileSystemTestUtils.h"
+
+using namespace Onca;
+using namespace Onca::FileSystem;
+using namespace TestUtils;
+
+namespace
+{
+	// root
+	// +- a.txt
+	// +- b.bin
+	// +- sub1
+	//    +- c.txt
+	//    +- sub2
+	//       +- d.txt
+	//       +- sub3
+	//          +- e.txt
+	constexpr usize TreeNumFiles = 5;
+	constexpr usize TreeNumDirs = 3;
+
+	auto CreateWalkerTestTree() -> Path
+	{
+		Path root = CreateTestDir("unittest_directory_walker");
+
+		const Path sub1 = root / "sub1"_path;
+		const Path sub2 = sub1 / "sub2"_path;
+		const Path sub3 = sub2 / "sub3"_path;
+		CreateDirectory(sub1);
+		CreateDirectory(sub2);
+		CreateDirectory(sub3);
+
+		WriteTestFile(root / "a.txt"_path, "");
+		WriteTestFile(root / "b.bin"_path, "");
+		WriteTestFile(sub1 / "c.txt"_path, "");
+		WriteTestFile(sub2 / "d.txt"_path, "");
+		WriteTestFile(sub3 / "e.txt"_path, "");
+		return root;
+	}
+
+	struct WalkCounts
+	{
+		usize numFiles = 0;
+		usize numDirs = 0;
+		u16   maxDepth = 0;
+	};
+
+	auto CountWithNext(const Path& root, const DirectoryWalkOptions& options) -> WalkCounts
+	{
+		WalkCounts counts;
+		DirectoryWalker walker{ root, options };
+		EntryBatch batch;
+		while (walker.Next(batch))
+		{
+			counts.maxDepth = Math::Max(counts.maxDepth, batch.GetDepth());
+			for (usize i = 0; i < batch.Size(); ++i)
+			{
+				if (batch.IsDirectory(i))
+					++counts.numDirs;
+				else
+					++counts.numFiles;
+			}
+		}
+		return counts;
+	}
+}
+
+TEST(DirectoryWalkerTest, WalkWholeTree)
+{
+	const Path root = CreateWalkerTestTree();
+	const WalkCounts counts = CountWithNext(root, {});
+	EXPECT_EQ(counts.numFiles, TreeNumFiles);
+	EXPECT_EQ(counts.numDirs, TreeNumDirs);
+	EXPECT_EQ(counts.maxDepth, 3);
+	DeleteDirectory(root, true);
+}
+
+TEST(DirectoryWalkerTest, RecursionDepth)
+{
+	const Path root = CreateWalkerTestTree();
+
+	WalkCounts counts = CountWithNext(root, { .maxResursionDepth = 1 });
+	EXPECT_EQ(counts.numFiles, 3);
+	EXPECT_EQ(counts.numDirs, 2);
+	EXPECT_EQ(counts.maxDepth, 1);
+
+	counts = CountWithNext(root, { .recurseSubDirs = false });
+	EXPECT_EQ(counts.numFiles, 2);
+	EXPECT_EQ(counts.numDirs, 1);
+	EXPECT_EQ(counts.maxDepth, 0);
+
+	DeleteDirectory(root, true);
+}
+
+TEST(DirectoryWalkerTest, Filters)
+{
+	const Path root = CreateWalkerTestTree();
+
+	// Directories are still walked when only files are visited
+	WalkCounts counts = CountWithNext(root, { .onlyVisitFiles = true });
+	EXPECT_EQ(counts.numFiles, TreeNumFiles);
+	EXPECT_EQ(counts.numDirs, 0);
+
+	counts = CountWithNext(root, { .onlyVisitDirs = true });
+	EXPECT_EQ(counts.numFiles, 0);
+	EXPECT_EQ(counts.numDirs, TreeNumDirs);
+
+	// Skipped directories are not walked
+	counts = CountWithNext(root, { .toSkip = FileAttribute::Directory });
+	EXPECT_EQ(counts.numFiles, 2);
+	EXPECT_EQ(counts.numDirs, 0);
+
+	counts = CountWithNext(root, { .returnSpecialDirs = true });
+	EXPECT_EQ(counts.numFiles, TreeNumFiles);
+	EXPECT_EQ(counts.numDirs, TreeNumDirs + 4 * 2);
+
+	DeleteDirectory(root, true);
+}
+
+TEST(DirectoryWalkerTest, BatchCallback)
+{
+	const Path root = CreateWalkerTestTree();
+
+	usize numEntries = 0;
+	usize numBatches = 0;
+	bool namesMatchDir = true;
+	const SystemError err = WalkDirectory([&](const EntryBatch& batch)
+	{
+		EXPECT_LE(batch.Size(), 2);
+		++numBatches;
+		numEntries += batch.Size();
+		for (usize i = 0; i < batch.Size(); ++i)
+			namesMatchDir &= batch.GetPath(i) == batch.GetDirectory() / Path{ batch.GetName(i) };
+	}, root, { .batchSize = 2 });
+
+	EXPECT_TRUE(err.Succeeded());
+	EXPECT_EQ(numEntries, TreeNumFiles + TreeNumDirs);
+	// The root contains 3 entries, so it needs at least 2 batches
+	EXPECT_GE(numBatches, 5);
+	EXPECT_TRUE(namesMatchDir);
+
+	DeleteDirectory(root, true);
+}
+
+TEST(DirectoryWalkerTest, MultiThreaded)
+{
+	const Path root = CreateWalkerTestTree();
+
+	Atomic<usize> numEntries{ 0 };
+	DirectoryWalker walker{ root, { .numThreads = 4, .maxQueuedDirs = 1, .batchSize = 1 } };
+	const SystemError err = walker.Walk([&numEntries](const EntryBatch& batch) { numEntries.FetchAdd(batch.Size(), MemOrder::Relaxed); });
+
+	EXPECT_TRUE(err.Succeeded());
+	EXPECT_EQ(numEntries.Load(), TreeNumFiles + TreeNumDirs);
+
+	DeleteDirectory(root, true);
+}
+
+TEST(DirectoryWalkerTest, EmptyRoot)
+{
+	const Path root = CreateTestDir("unittest_directory_walker_empty");
+
+	DirectoryWalker walker{ root };
+	EntryBatch batch;
+	EXPECT_FALSE(walker.Next(batch));
+	EXPECT_TRUE(batch.IsEmpty());
+	EXPECT_TRUE(walker.GetError().Succeeded());
+
+	usize numBatches = 0;
+	EXPECT_TRUE(WalkDirectory([&numBatches](const EntryBatch&) { ++numBatches; }, root, { .numThreads = 2 }).Succeeded());
+	EXPECT_EQ(numBatches, 0);
+
+	DeleteDirectory(root, true);
+}
+
+TEST(DirectoryWalkerTest, MissingRoot)
+{
+	const Path root = GetTestPath("unittest_directory_walker_missing");
+
+	DirectoryWalker walker{ root };
+	EntryBatch batch;
+	EXPECT_FALSE(walker.Next(batch));
+	EXPECT_FALSE(walker.GetError().Succeeded());
+
+	usize numBatches = 0;
+	EXPECT_FALSE(WalkDirectory([&numBatches](const EntryBatch&) { ++numBatches; }, root).Succeeded());
+	EXPECT_EQ(numBatches, 0);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+/**
+ * Helpers shared by the filesystem tests, all test files and directories are created in the working directory
+ */
+namespace TestUtils
+{
+	using namespace Onca;
+	using namespace Onca::FileSystem;
+
+	/**
+	 * Get the path of a test file or directory, removing anything a previous run left behind at it
+	 * \param[in] name Name of the file or directory
+	 * \return Absolute path
+	 */
+	inline auto GetTestPath(const char* name) -> Path
+	{
+		Path path = (GetCurrentWorkingDirectory() / Path{ String{ name } }).AsAbsolute();
+		UNUSED(DeleteFile(path));
+		DeleteDirectory(path, true);
+		return path;
+	}
+
+	/**
+	 * Create an empty test directory
+	 * \param[in] name Name of the directory
+	 * \return Absolute path
+	 */
+	inline auto CreateTestDir(const char* name) -> Path
+	{
+		Path path = GetTestPath(name);
+		CreateDirectory(path);
+		return path;
+	}
+
+	/**
+	 * Generate test data, every byte is a hash of its index, so the data does not repeat with a power of 2 period, like a chunk or buffer size
+	 * \param[in] size Size of the data
+	 * \param[in] seed Seed to create different data of the same size
+	 * \return Test data
+	 */
+	inline auto MakeTestData(usize size, u8 seed = 0) -> DynArray<u8>
+	{
+		DynArray<u8> data;
+		data.Resize(size);
+		for (usize i = 0; i < size; ++i)
+			data[i] = u8((u64(i) * 0x9E3779B97F4A7C15) >> 56) ^ seed;
+		return data;
+	}
+
+	/**
+	 * Create or overwrite a test file
+	 * \param[in] path Path to the file
+	 * \param[in] data Content of the file
+	 */
+	inline void WriteTestFile(const Path& path, const DynArray<u8>& data)
+	{
+		Result<File, SystemError> res = File::Create(path, FileCreateKind::CreateAlways);
+		ASSERT_FALSE(res.Failed());
+		File file = res.MoveValue();
+		if (!data.IsEmpty())
+			EXPECT_TRUE(file.Write(ByteBuffer{ data }, 0).Succeeded());
+	}
+
+	/**
+	 * Create or overwrite a test file
+	 * \param[in] path Path to the file
+	 * \param[in] content Text content of the file
+	 */
+	inline void WriteTestFile(const Path& path, const char* content)
+	{
+		const String str{ content };
+		WriteTestFile(path, DynArray<u8>{ str.Data(), str.Data() + str.DataSize() });
+	}
+
+	/**
+	 * Check if the content of a file matches the expected data
+	 * \param[in] path Path to the file
+	 * \param[in] expected Expected data
+	 * \return Whether the file could be read and its content matches
+	 */
+	inline auto FileContentEquals(const Path& path, const DynArray<u8>& expected) -> bool
+	{
+		Result<ByteBuffer, SystemError> res = ReadAll(path);
+		if (res.Failed())
+			return false;
+		const ByteBuffer content = res.MoveValue();
+		return content.Size() == expected.Size() && MemCmp(content.Data(), expected.Data(), expected.Size()) == 0;
+	}
+}
@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+#include "FileSystemTestUtils.h"
+
+using namespace Onca;
+using namespace Onca::FileSystem;
+using namespace TestUtils;
+
+namespace
+{
+	// Whole file reads of at least 16MiB are read in parallel chunks of 8MiB
+	constexpr u64 ParallelReadSize = 3 * 8_MiB + 12345;
+
+	auto CreateTestFile(const char* name, const DynArray<u8>& data) -> Path
+	{
+		const Path path = GetTestPath(name);
+		WriteTestFile(path, data);
+		return path;
+	}
+
+	void CheckReadInto(const Path& path, const DynArray<u8>& data, FileFlags flags)
+	{
+		Result<File, SystemError> openRes = File::Open(path, false, AccessMode::Read, ShareMode::Read, flags);
+		ASSERT_FALSE(openRes.Failed());
+		const File file = openRes.MoveValue();
+
+		DynArray<u8> buffer;
+		buffer.Resize(data.Size());
+
+		// Non-zero offset, with a size that does not line up with any chunk size
+		const u64 offset = data.Size() / 3 + 7;
+		const u64 size = data.Size() / 2 + 3;
+		Result<u64, SystemError> res = file.ReadInto(buffer.Data(), size, offset);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), size);
+		EXPECT_EQ(MemCmp(buffer.Data(), data.Data() + offset, size), 0);
+
+		// A read that crosses the end of the file only returns the remaining data
+		const u64 tailOffset = data.Size() - 100;
+		res = file.ReadInto(buffer.Data(), data.Size(), tailOffset);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), 100);
+		EXPECT_EQ(MemCmp(buffer.Data(), data.Data() + tailOffset, 100), 0);
+
+		// Reads at or past the end of the file don't return any data
+		res = file.ReadInto(buffer.Data(), 10, data.Size());
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), 0);
+		res = file.ReadInto(buffer.Data(), 10, data.Size() + 1000);
+		ASSERT_FALSE(res.Failed());
+		EXPECT_EQ(res.Value(), 0);
+	}
+}
+
+TEST(FileTest, ReadAllSmall)
+{
+	const DynArray<u8> data = MakeTestData(1000);
+	const Path path = CreateTestFile("unittest_file_read_small.bin", data);
+	EXPECT_TRUE(FileContentEquals(path, data));
+	UNUSED(DeleteFile(path));
+
+	const Path emptyPath = CreateTestFile("unittest_file_read_empty.bin", DynArray<u8>{});
+	Result<ByteBuffer, SystemError> res = ReadAll(emptyPath);
+	ASSERT_FALSE(res.Failed());
+	EXPECT_EQ(res.Value().Size(), 0);
+	UNUSED(DeleteFile(emptyPath));
+}
+
+TEST(FileTest, ReadAllParallel)
+{
+	const DynArray<u8> data = MakeTestData(usize(ParallelReadSize));
+	const Path path = CreateTestFile("unittest_file_read_parallel.bin", data);
+	EXPECT_TRUE(FileContentEquals(path, data));
+	UNUSED(DeleteFile(path));
+}
+
+TEST(FileTest, ReadAllWhileOpenForWrite)
+{
+	const DynArray<u8> data = MakeTestData(1000);
+	const Path path = GetTestPath("unittest_file_read_shared.bin");
+
+	Result<File, SystemError> res = File::Create(path, FileCreateKind::CreateAlways, AccessMode::ReadWrite, ShareMode::Read | ShareMode::Write);
+	ASSERT_FALSE(res.Failed());
+	File writer = res.MoveValue();
+	EXPECT_TRUE(writer.Write(ByteBuffer{ data }, 0).Succeeded());
+
+	// A file that is still being written to, like a log file, can be read
+	EXPECT_TRUE(FileContentEquals(path, data));
+
+	EXPECT_TRUE(writer.Close().Succeeded());
+	UNUSED(DeleteFile(path));
+}
+
+TEST(FileTest, ReadAllErrors)
+{
+	const Path dir = CreateTestDir("unittest_file_read_dir");
+
+	Result<ByteBuffer, SystemError> res = ReadAll(dir);
+	ASSERT_TRUE(res.Failed());
+	EXPECT_EQ(res.Error().code, SystemErrorCode::ExpectedFile);
+
+	res = ReadAll(dir / "missing.bin"_path);
+	EXPECT_TRUE(res.Failed());
+
+	DeleteDirectory(dir, true);
+}
+
+TEST(FileTest, ReadIntoSequential)
+{
+	const DynArray<u8> data = MakeTestData(100000);
+	const Path path = CreateTestFile("unittest_file_read_into.bin", data);
+	CheckReadInto(path, data, FileFlag::None);
+	CheckReadInto(path, data, FileFlag::AllowAsync);
+	UNUSED(DeleteFile(path));
+}
+
+TEST(FileTest, ReadIntoParallel)
+{
+	const DynArray<u8> data = MakeTestData(usize(ParallelReadSize));
+	const Path path = CreateTestFile("unittest_file_read_into_parallel.bin", data);
+	CheckReadInto(path, data, FileFlag::None);
+	CheckReadInto(path, data, FileFlag::AllowAsync);
+	UNUSED(DeleteFile(path));
+}
+
+TEST(FileTest, ReadIntoErrors)
+{
+	const DynArray<u8> data = MakeTestData(100);
+	const Path path = CreateTestFile("unittest_file_read_into_errors.bin", data);
+
+	u8 buffer[100];
+	Result<File, SystemError> openRes = File::Open(path, false, AccessMode::Write);
+	ASSERT_FALSE(openRes.Failed());
+	File writeOnly = openRes.MoveValue();
+	Result<u64, SystemError> res = writeOnly.ReadInto(buffer, 100);
+	ASSERT_TRUE(res.Failed());
+	EXPECT_EQ(res.Error().code, SystemErrorCode::NoReadPerms);
+	EXPECT_TRUE(writeOnly.Close().Succeeded());
+
+	const File invalid;
+	res = invalid.ReadInto(buffer, 100);
+	ASSERT_TRUE(res.Failed());
+	EXPECT_EQ(res.Error().code, SystemErrorCode::InvalidHandle);
+
+	UNUSED(DeleteFile(path));
+}
@@ -0,0 +1,224 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+#include "FileSystemTestUtils.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace Onca;
+using namespace Onca::FileSystem;
+using namespace TestUtils;
+
+namespace
+{
+	constexpr u32 TestDebounceMs = 50;
+	constexpr u32 TestTimeoutMs = 5000;
+
+	void SleepMs(u32 ms)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+	}
+
+	// Dispatch until at least the expected number of changes arrived, then wait a few more debounce periods, so any extra changes are caught as well
+	auto CollectChanges(FileWatcher& watcher, usize expected) -> DynArray<FileChange>
+	{
+		DynArray<FileChange> collected;
+		auto collect = [&collected](const DynArray<FileChange>& changes)
+		{
+			for (const FileChange& change : changes)
+				collected.Add(change);
+		};
+
+		for (u32 waited = 0; collected.Size() < expected && waited < TestTimeoutMs; waited += 10)
+		{
+			watcher.Dispatch(collect);
+			SleepMs(10);
+		}
+
+		SleepMs(TestDebounceMs * 3);
+		watcher.Dispatch(collect);
+		return collected;
+	}
+
+	auto CountChangesFor(const DynArray<FileChange>& changes, const Path& path) -> usize
+	{
+		usize count = 0;
+		for (const FileChange& change : changes)
+			count += change.path == path || change.oldPath == path;
+		return count;
+	}
+}
+
+TEST(FileWatcherTest, Create)
+{
+	const Path root = CreateTestDir("unittest_file_watcher_create");
+	{
+		FileWatcher watcher{ { .debounceMs = TestDebounceMs } };
+		ASSERT_FALSE(watcher.Watch(root).Failed());
+		ASSERT_TRUE(watcher.Start().Succeeded());
+
+		const Path path = root / "created.txt"_path;
+		WriteTestFile(path, "created");
+
+		const DynArray<FileChange> changes = CollectChanges(watcher, 1);
+		ASSERT_EQ(changes.Size(), 1);
+		EXPECT_EQ(changes[0].kind, FileChangeKind::Created);
+		EXPECT_EQ(changes[0].path, path);
+
+		watcher.Stop();
+	}
+	DeleteDirectory(root, true);
+}
+
+TEST(FileWatcherTest, Modify)
+{
+	const Path root = CreateTestDir("unittest_file_watcher_modify");
+	const Path path = root / "modified.txt"_path;
+	WriteTestFile(path, "original");
+	{
+		FileWatcher watcher{ { .debounceMs = TestDebounceMs } };
+		ASSERT_FALSE(watcher.Watch(root).Failed());
+		ASSERT_TRUE(watcher.Start().Succeeded());
+
+		// Multiple writes are coalesced into a single modification
+		WriteTestFile(path, "modified");
+		WriteTestFile(path, "modified again");
+
+		const DynArray<FileChange> changes = CollectChanges(watcher, 1);
+		ASSERT_EQ(changes.Size(), 1);
+		EXPECT_EQ(changes[0].kind, FileChangeKind::Modified);
+		EXPECT_EQ(changes[0].path, path);
+
+		watcher.Stop();
+	}
+	DeleteDirectory(root, true);
+}
+
+TEST(FileWatcherTest, Delete)
+{
+	const Path root = CreateTestDir("unittest_file_watcher_delete");
+	const Path path = root / "deleted.txt"_path;
+	WriteTestFile(path, "deleted");
+	{
+		FileWatcher watcher{ { .debounceMs = TestDebounceMs } };
+		ASSERT_FALSE(watcher.Watch(root).Failed());
+		ASSERT_TRUE(watcher.Start().Succeeded());
+
+		EXPECT_TRUE(DeleteFile(path).Succeeded());
+
+		const DynArray<FileChange> changes = CollectChanges(watcher, 1);
+		ASSERT_EQ(changes.Size(), 1);
+		EXPECT_EQ(changes[0].kind, FileChangeKind::Deleted);
+		EXPECT_EQ(changes[0].path, path);
+
+		watcher.Stop();
+	}
+	DeleteDirectory(root, true);
+}
+
+TEST(FileWatcherTest, RenameCoalescing)
+{
+	const Path root = CreateTestDir("unittest_file_watcher_rename");
+	const Path existing = root / "existing.txt"_path;
+	WriteTestFile(existing, "existing");
+	{
+		FileWatcher watcher{ { .debounceMs = TestDebounceMs } };
+		ASSERT_FALSE(watcher.Watch(root).Failed());
+		ASSERT_TRUE(watcher.Start().Succeeded());
+
+		// Save via a temporary file: only the final file is reported as created
+		const Path temp = root / "save.tmp"_path;
+		const Path saved = root / "saved.txt"_path;
+		WriteTestFile(temp, "saved");
+		EXPECT_TRUE(FileSystem::Move(temp, saved, MoveFlag::Wait).Succeeded());
+
+		// Chained renames are reported as a single rename from the original path
+		const Path renamed0 = root / "renamed0.txt"_path;
+		const Path renamed1 = root / "renamed1.txt"_path;
+		EXPECT_TRUE(FileSystem::Move(existing, renamed0, MoveFlag::Wait).Succeeded());
+		EXPECT_TRUE(FileSystem::Move(renamed0, renamed1, MoveFlag::Wait).Succeeded());
+
+		const DynArray<FileChange> changes = CollectChanges(watcher, 2);
+		ASSERT_EQ(changes.Size(), 2);
+		EXPECT_EQ(CountChangesFor(changes, temp), 0);
+		EXPECT_EQ(CountChangesFor(changes, renamed0), 0);
+
+		for (const FileChange& change : changes)
+		{
+			if (change.path == saved)
+			{
+				EXPECT_EQ(change.kind, FileChangeKind::Created);
+				EXPECT_TRUE(change.oldPath.IsEmpty());
+			}
+			else
+			{
+				EXPECT_EQ(change.path, renamed1);
+				EXPECT_EQ(change.kind, FileChangeKind::Renamed);
+				EXPECT_EQ(change.oldPath, existing);
+			}
+		}
+
+		watcher.Stop();
+	}
+	DeleteDirectory(root, true);
+}
+
+TEST(FileWatcherTest, Debounce)
+{
+	const Path root = CreateTestDir("unittest_file_watcher_debounce");
+	{
+		constexpr u32 debounceMs = 500;
+		FileWatcher watcher{ { .debounceMs = debounceMs } };
+		ASSERT_FALSE(watcher.Watch(root).Failed());
+		ASSERT_TRUE(watcher.Start().Succeeded());
+
+		WriteTestFile(root / "debounced.txt"_path, "debounced");
+
+		// Wait for the change to be picked up by the worker, it should not be dispatched yet
+		for (u32 waited = 0; watcher.GetPendingCount() == 0 && waited < TestTimeoutMs; waited += 10)
+			SleepMs(10);
+		EXPECT_EQ(watcher.GetPendingCount(), 1);
+
+		usize numDispatched = 0;
+		auto count = [&numDispatched](const DynArray<FileChange>& changes) { numDispatched += changes.Size(); };
+		EXPECT_EQ(watcher.Dispatch(count), 0);
+		EXPECT_EQ(numDispatched, 0);
+
+		SleepMs(debounceMs * 2);
+		EXPECT_EQ(watcher.Dispatch(count), 1);
+		EXPECT_EQ(numDispatched, 1);
+		EXPECT_EQ(watcher.GetPendingCount(), 0);
+
+		watcher.Stop();
+	}
+	DeleteDirectory(root, true);
+}
+
+TEST(FileWatcherTest, Polling)
+{
+	const Path root = CreateTestDir("unittest_file_watcher_polling");
+	const Path deleted = root / "deleted.txt"_path;
+	WriteTestFile(deleted, "deleted");
+	{
+		FileWatcher watcher{ { .debounceMs = TestDebounceMs, .pollIntervalMs = 50, .forcePolling = true } };
+		ASSERT_FALSE(watcher.Watch(root).Failed());
+		ASSERT_TRUE(watcher.Start().Succeeded());
+
+		const Path created = root / "created.txt"_path;
+		WriteTestFile(created, "created");
+		EXPECT_TRUE(DeleteFile(deleted).Succeeded());
+
+		const DynArray<FileChange> changes = CollectChanges(watcher, 2);
+		ASSERT_EQ(changes.Size(), 2);
+		for (const FileChange& change : changes)
+		{
+			if (change.path == created)
+				EXPECT_EQ(change.kind, FileChangeKind::Created);
+			else
+				EXPECT_EQ(change.kind, FileChangeKind::Deleted);
+		}
+
+		watcher.Stop();
+	}
+	DeleteDirectory(root, true);
+}
@@ -0,0 +1,337 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	class CompactRcCountingAlloc final : public Alloc::IAllocator
+	{
+	public:
+		u32   numAllocs = 0;
+		u32   numDeallocs = 0;
+		usize lastAllocSize = 0;
+
+	protected:
+		auto AllocateRaw(usize size, u16 align, bool isBacking) noexcept -> MemRef<u8> override
+		{
+			++numAllocs;
+			lastAllocSize = size;
+
+			// Hand out memory owned by this allocator, so deallocations come back through here
+			const MemRef<u8> mem = m_mallocator.Allocate<u8>(size, align, isBacking);
+			return { mem.Ptr(), this, Math::Log2(align), size, isBacking };
+		}
+
+		void DeallocateRaw(MemRef<u8>&& mem) noexcept override
+		{
+			++numDeallocs;
+			m_mallocator.Deallocate(MemRef<u8>{ mem.Ptr(), &m_mallocator, Math::Log2(mem.Align()), mem.Size(), mem.IsBackingMem() });
+		}
+
+	private:
+		Alloc::Mallocator m_mallocator;
+	};
+
+	struct CompactRcTracked
+	{
+		static inline i32 numDestructed = 0;
+
+		u64 value;
+
+		CompactRcTracked(u64 value) noexcept
+			: value(value)
+		{
+		}
+
+		~CompactRcTracked() noexcept
+		{
+			++numDestructed;
+		}
+	};
+
+	struct CompactRcDerived : CompactRcTracked
+	{
+		static inline i32 numDerivedDestructed = 0;
+
+		u64 extra;
+
+		CompactRcDerived(u64 value, u64 extra) noexcept
+			: CompactRcTracked(value)
+			, extra(extra)
+		{
+		}
+
+		~CompactRcDerived() noexcept
+		{
+			++numDerivedDestructed;
+		}
+	};
+
+	struct IntrusiveRcTracked : RcObject
+	{
+		static inline i32 numDestructed = 0;
+
+		u64 value;
+
+		IntrusiveRcTracked(u64 value) noexcept
+			: value(value)
+		{
+		}
+
+		~IntrusiveRcTracked() noexcept
+		{
+			++numDestructed;
+		}
+	};
+
+	template<typename F>
+	void RunThreads(u32 numThreads, F workerFunc)
+	{
+		Atomic<u32> nextIdx{ 0 };
+		auto threadFunc = [&]() -> u32
+		{
+			workerFunc(nextIdx.FetchAdd(1));
+			return 0;
+		};
+		const Delegate<u32()> threadDelegate{ threadFunc };
+
+		DynArray<Threading::Thread> workers;
+		for (u32 i = 0; i < numThreads; ++i)
+		{
+			Result<Threading::Thread, SystemError> res = Threading::Thread::Create(Threading::ThreadAttribs{ .desc = "CompactRefCountedTest worker"_s }, threadDelegate);
+			ASSERT_FALSE(res.Failed());
+			workers.Add(res.MoveValue());
+		}
+		for (Threading::Thread& worker : workers)
+			worker.Join();
+	}
+}
+
+TEST(CompactRefCountedTest, StrongAndWeakCounts)
+{
+	CompactRcCountingAlloc alloc;
+	CompactRcTracked::numDestructed = 0;
+	{
+		CompactRc<CompactRcTracked> rc = CompactRc<CompactRcTracked>::CreateWithAlloc(alloc, 42);
+		ASSERT_TRUE(rc);
+		EXPECT_EQ(rc->value, 42);
+		EXPECT_EQ(rc.UseCount(), 1);
+		EXPECT_EQ(rc.GetAlloc(), &alloc);
+
+		CompactRc<CompactRcTracked> copy = rc;
+		EXPECT_EQ(rc.UseCount(), 2);
+		EXPECT_TRUE(copy == rc);
+
+		// Weak references don't add a strong reference
+		CompactWeak<CompactRcTracked> weak{ rc };
+		CompactWeak<CompactRcTracked> weakCopy = weak;
+		EXPECT_EQ(weak.UseCount(), 2);
+		EXPECT_EQ(rc.UseCount(), 2);
+
+		CompactRc<CompactRcTracked> moved = Move(copy);
+		EXPECT_FALSE(copy);
+		EXPECT_EQ(rc.UseCount(), 2);
+
+		moved = nullptr;
+		EXPECT_EQ(rc.UseCount(), 1);
+		EXPECT_EQ(weakCopy.UseCount(), 1);
+
+		CompactRc<CompactRcTracked> locked = weak.Lock();
+		EXPECT_TRUE(locked == rc);
+		EXPECT_EQ(rc.UseCount(), 2);
+	}
+	EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+	EXPECT_EQ(alloc.numDeallocs, 1);
+
+	const CompactRc<CompactRcTracked> null;
+	EXPECT_FALSE(null);
+	EXPECT_EQ(null.UseCount(), 0);
+	EXPECT_FALSE(CompactWeak<CompactRcTracked>{ null }.IsValid());
+}
+
+TEST(CompactRefCountedTest, SingleAllocation)
+{
+	CompactRcCountingAlloc alloc;
+	CompactRc<CompactRcTracked> rc = CompactRc<CompactRcTracked>::CreateWithAlloc(alloc, 1);
+	ASSERT_TRUE(rc);
+
+	// The control block and the object share one allocation, and the pointer itself is a single pointer
+	EXPECT_EQ(alloc.numAllocs, 1);
+	EXPECT_GE(alloc.lastAllocSize, sizeof(CompactRcTracked));
+	EXPECT_LT(alloc.lastAllocSize, sizeof(CompactRcTracked) + 2 * sizeof(Detail::CompactControlBlock<Detail::RefCount>));
+	EXPECT_EQ(sizeof(CompactRc<CompactRcTracked>), sizeof(void*));
+	EXPECT_EQ(sizeof(CompactWeak<CompactRcTracked>), sizeof(void*));
+
+	// Copies and weak references don't allocate
+	CompactRc<CompactRcTracked> copy = rc;
+	CompactWeak<CompactRcTracked> weak{ rc };
+	EXPECT_EQ(alloc.numAllocs, 1);
+}
+
+TEST(CompactRefCountedTest, WeakLockAfterLastStrong)
+{
+	CompactRcCountingAlloc alloc;
+	CompactRcTracked::numDestructed = 0;
+
+	CompactRc<CompactRcTracked> rc = CompactRc<CompactRcTracked>::CreateWithAlloc(alloc, 7);
+	CompactWeak<CompactRcTracked> weak{ rc };
+	EXPECT_TRUE(weak.IsValid());
+
+	rc = nullptr;
+	EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+	EXPECT_FALSE(weak.IsValid());
+	EXPECT_EQ(weak.UseCount(), 0);
+
+	const CompactRc<CompactRcTracked> locked = weak.Lock();
+	EXPECT_FALSE(locked);
+	EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+}
+
+TEST(CompactRefCountedTest, DestructorRunsOnce)
+{
+	CompactRcCountingAlloc alloc;
+	CompactRcTracked::numDestructed = 0;
+	{
+		CompactRc<CompactRcTracked> rc = CompactRc<CompactRcTracked>::CreateWithAlloc(alloc, 3);
+		CompactRc<CompactRcTracked> copy0 = rc;
+		CompactRc<CompactRcTracked> copy1 = rc;
+		CompactWeak<CompactRcTracked> weak0{ rc };
+		CompactWeak<CompactRcTracked> weak1{ copy0 };
+
+		rc = nullptr;
+		copy0 = nullptr;
+		EXPECT_EQ(CompactRcTracked::numDestructed, 0);
+		copy1 = nullptr;
+		EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+
+		// Dropping the remaining weak references only releases the memory
+		weak0 = nullptr;
+		weak1 = nullptr;
+		EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+	}
+	EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+
+	// Converting to a base type still destroys the created type
+	CompactRcDerived::numDerivedDestructed = 0;
+	CompactRcTracked::numDestructed = 0;
+	{
+		CompactRc<CompactRcTracked> base = CompactRc<CompactRcDerived>::CreateWithAlloc(alloc, 1, 2);
+		EXPECT_EQ(base->value, 1);
+	}
+	EXPECT_EQ(CompactRcDerived::numDerivedDestructed, 1);
+	EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+}
+
+TEST(CompactRefCountedTest, StorageFreedAfterLastWeak)
+{
+	CompactRcCountingAlloc alloc;
+	CompactRcTracked::numDestructed = 0;
+
+	CompactRc<CompactRcTracked> rc = CompactRc<CompactRcTracked>::CreateWithAlloc(alloc, 5);
+	CompactWeak<CompactRcTracked> weak0{ rc };
+	CompactWeak<CompactRcTracked> weak1{ rc };
+
+	// The object is destroyed with the last strong reference, but the control block needs to outlive all weak references
+	rc = nullptr;
+	EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+	EXPECT_EQ(alloc.numDeallocs, 0);
+
+	weak0 = nullptr;
+	EXPECT_EQ(alloc.numDeallocs, 0);
+	EXPECT_FALSE(weak1.Lock());
+
+	weak1 = nullptr;
+	EXPECT_EQ(alloc.numDeallocs, 1);
+
+	// Without weak references, the memory is released with the last strong reference
+	rc = CompactRc<CompactRcTracked>::CreateWithAlloc(alloc, 6);
+	rc = nullptr;
+	EXPECT_EQ(alloc.numDeallocs, 2);
+	EXPECT_EQ(alloc.numAllocs, 2);
+}
+
+TEST(CompactRefCountedTest, ArcThreads)
+{
+	constexpr u32 numThreads = 8;
+	constexpr u32 numIterations = 10000;
+
+	CompactRcCountingAlloc alloc;
+	CompactRcTracked::numDestructed = 0;
+
+	CompactArc<CompactRcTracked> arc = CompactArc<CompactRcTracked>::CreateWithAlloc(alloc, 99);
+	const CompactAWeak<CompactRcTracked> weak{ arc };
+
+	// Copies and locks from multiple threads need to leave the count balanced
+	Atomic<u32> numMismatches{ 0 };
+	RunThreads(numThreads, [&](u32)
+	{
+		for (u32 i = 0; i < numIterations; ++i)
+		{
+			CompactArc<CompactRcTracked> copy = arc;
+			CompactArc<CompactRcTracked> locked = weak.Lock();
+			if (!locked || locked->value != 99)
+				numMismatches.FetchAdd(1);
+		}
+	});
+	EXPECT_EQ(numMismatches.Load(), 0);
+	EXPECT_EQ(arc.UseCount(), 1);
+	EXPECT_EQ(CompactRcTracked::numDestructed, 0);
+
+	// Each thread owns a reference and drops it concurrently with locks from the other threads, only the last one may destroy the object
+	DynArray<CompactArc<CompactRcTracked>> refs;
+	for (u32 i = 0; i < numThreads; ++i)
+		refs.Add(arc);
+	arc = nullptr;
+
+	RunThreads(numThreads, [&](u32 idx)
+	{
+		for (u32 i = 0; i < numIterations; ++i)
+		{
+			CompactArc<CompactRcTracked> locked = weak.Lock();
+			if (locked && locked->value != 99)
+				numMismatches.FetchAdd(1);
+		}
+		refs[idx] = nullptr;
+	});
+	EXPECT_EQ(numMismatches.Load(), 0);
+	EXPECT_EQ(CompactRcTracked::numDestructed, 1);
+	EXPECT_FALSE(weak.Lock());
+	EXPECT_EQ(alloc.numDeallocs, 0);
+}
+
+TEST(CompactRefCountedTest, Intrusive)
+{
+	CompactRcCountingAlloc alloc;
+	IntrusiveRcTracked::numDestructed = 0;
+	{
+		IntrusiveRc<IntrusiveRcTracked> rc = IntrusiveRc<IntrusiveRcTracked>::CreateWithAlloc(alloc, 11);
+		ASSERT_TRUE(rc);
+		EXPECT_EQ(alloc.numAllocs, 1);
+		EXPECT_EQ(rc.UseCount(), 1);
+
+		// A new reference can be created from the raw pointer, as the count lives in the object
+		IntrusiveRc<IntrusiveRcTracked> fromRaw{ rc.Get() };
+		EXPECT_EQ(rc->GetRefCount(), 2);
+		EXPECT_TRUE(fromRaw == rc);
+
+		rc = nullptr;
+		EXPECT_EQ(IntrusiveRcTracked::numDestructed, 0);
+		EXPECT_EQ(fromRaw.UseCount(), 1);
+	}
+	EXPECT_EQ(IntrusiveRcTracked::numDestructed, 1);
+	EXPECT_EQ(alloc.numDeallocs, 1);
+
+	// Objects that were not created via Create are not owned
+	IntrusiveRcTracked::numDestructed = 0;
+	{
+		IntrusiveRcTracked local{ 12 };
+		{
+			IntrusiveRc<IntrusiveRcTracked> rc{ &local };
+			EXPECT_EQ(local.GetRefCount(), 1);
+		}
+		EXPECT_EQ(local.GetRefCount(), 0);
+		EXPECT_EQ(IntrusiveRcTracked::numDestructed, 0);
+	}
+	EXPECT_EQ(IntrusiveRcTracked::numDestructed, 1);
+}
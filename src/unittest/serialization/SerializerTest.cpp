@@ -0,0 +1,346 @@
+#include "gtest/gtest.h"
+#include "core/Core.h"
+
+using namespace Onca;
+
+namespace
+{
+	enum class Color : u16
+	{
+		Red = 1,
+		Green = 0x0203,
+	};
+
+	struct Vec3
+	{
+		f32 x, y, z;
+	};
+
+	struct Quad
+	{
+		u16  indices[4];
+		Vec3 corners[2];
+	};
+
+	struct Entity
+	{
+		u32            id;
+		i64            delta;
+		u64            count;
+		Vec3           pos;
+		Color          color;
+		String         name;
+		DynArray<u16>  values;
+		DynArray<Vec3> points;
+	};
+}
+
+template<>
+struct Onca::SerializeSchema<Vec3>
+{
+	static constexpr auto Fields = SchemaFields(&Vec3::x, &Vec3::y, &Vec3::z);
+};
+
+template<>
+struct Onca::SerializeSchema<Quad>
+{
+	static constexpr auto Fields = SchemaFields(&Quad::indices, &Quad::corners);
+};
+
+template<>
+struct Onca::SerializeSchema<Entity>
+{
+	static constexpr auto Fields = SchemaFields(&Entity::id, AsVarInt(&Entity::delta), AsVarInt(&Entity::count), &Entity::pos, &Entity::color, &Entity::name, &Entity::values, &Entity::points);
+};
+
+TEST(ByteSpanTest, Views)
+{
+	Alloc::Mallocator mallocator;
+	ByteBuffer buffer{ mallocator };
+	for (u8 i = 0; i < 8; ++i)
+		buffer.Write(i);
+
+	ByteSpan span = buffer;
+	EXPECT_EQ(span.Data(), buffer.Data());
+	EXPECT_EQ(span.Size(), 8);
+	EXPECT_EQ(span[3], 3);
+
+	ByteSpan sub = span.SubSpan(2, 3);
+	EXPECT_EQ(sub.Size(), 3);
+	EXPECT_EQ(sub[0], 2);
+	EXPECT_EQ(span.SubSpan(6, 10).Size(), 2);
+	EXPECT_EQ(span.First(2)[1], 1);
+	EXPECT_EQ(span.Last(2)[0], 6);
+
+	MutableByteSpan mutSpan = buffer;
+	mutSpan[0] = 42;
+	EXPECT_EQ(buffer.Data()[0], 42);
+
+	DynArray<u8> copy{ buffer.Data(), buffer.Data() + buffer.Size(), mallocator };
+	EXPECT_TRUE(ByteSpan{ copy } == ByteSpan{ mutSpan });
+	copy[7] = 0;
+	EXPECT_FALSE(ByteSpan{ copy } == span);
+	EXPECT_TRUE(ByteSpan{}.IsEmpty());
+}
+
+TEST(SerializerTest, Primitives)
+{
+	Alloc::Mallocator mallocator;
+	DynArray<u8> data{ mallocator };
+	{
+		Serializer serializer{ data };
+		serializer.Write<u8>(0xAB);
+		serializer.Write<u32>(0x01020304);
+		serializer.Write<f64>(1.5);
+		serializer.Write(Color::Green);
+		EXPECT_EQ(serializer.NumWritten(), 15);
+	}
+	ASSERT_EQ(data.Size(), 15);
+	EXPECT_EQ(data[1], 0x04);
+	EXPECT_EQ(data[4], 0x01);
+
+	Deserializer deserializer{ data };
+	EXPECT_EQ(deserializer.Read<u8>(), 0xAB);
+	EXPECT_EQ(deserializer.Read<u32>(), 0x01020304u);
+	EXPECT_EQ(deserializer.Read<f64>(), 1.5);
+	EXPECT_EQ(deserializer.Read<Color>(), Color::Green);
+	EXPECT_TRUE(deserializer.IsAtEnd());
+	EXPECT_FALSE(deserializer.HasFailed());
+
+	EXPECT_EQ(deserializer.Read<u32>(), 0u);
+	EXPECT_TRUE(deserializer.HasFailed());
+}
+
+TEST(SerializerTest, BigEndian)
+{
+	Alloc::Mallocator mallocator;
+	ByteBuffer buffer{ mallocator };
+	{
+		Serializer serializer{ buffer, ByteOrder::Big };
+		serializer.Write<u32>(0x01020304);
+		serializer.Write<i16>(-2);
+		serializer.Write<f32>(-3.25f);
+		const u32 arr[3] = { 1, 0x10203040, 0xFFFF'0000 };
+		serializer.WriteArray(arr, 3);
+	}
+	ASSERT_EQ(buffer.Size(), 22);
+	EXPECT_EQ(buffer.Data()[0], 0x01);
+	EXPECT_EQ(buffer.Data()[3], 0x04);
+	EXPECT_EQ(buffer.Data()[17], 0x40);
+
+	Deserializer deserializer{ buffer, ByteOrder::Big };
+	EXPECT_EQ(deserializer.Read<u32>(), 0x01020304u);
+	EXPECT_EQ(deserializer.Read<i16>(), -2);
+	EXPECT_EQ(deserializer.Read<f32>(), -3.25f);
+	u32 arr[3];
+	EXPECT_TRUE(deserializer.ReadArray(arr, 3));
+	EXPECT_EQ(arr[0], 1u);
+	EXPECT_EQ(arr[1], 0x10203040u);
+	EXPECT_EQ(arr[2], 0xFFFF'0000u);
+	EXPECT_TRUE(deserializer.IsAtEnd());
+}
+
+TEST(SerializerTest, VarInt)
+{
+	Alloc::Mallocator mallocator;
+	const u64 unsignedVals[] = { 0, 1, 127, 128, 300, 16383, 16384, 0xFFFF'FFFF, 0x7FFF'FFFF'FFFF'FFFF, 0xFFFF'FFFF'FFFF'FFFF };
+	const i64 signedVals[] = { 0, -1, 1, -64, 64, -65, 0x7FFF'FFFF'FFFF'FFFF, i64(0x8000'0000'0000'0000) };
+
+	DynArray<u8> data{ mallocator };
+	{
+		Serializer serializer{ data };
+		for (u64 val : unsignedVals)
+			serializer.WriteVarUInt(val);
+		for (i64 val : signedVals)
+			serializer.WriteVarInt(val);
+	}
+
+	// Check the encoded sizes of the first values
+	EXPECT_EQ(data[0], 0x00);
+	EXPECT_EQ(data[1], 0x01);
+	EXPECT_EQ(data[2], 0x7F);
+	EXPECT_EQ(data[3], 0x80);
+	EXPECT_EQ(data[4], 0x01);
+
+	Deserializer deserializer{ data };
+	for (u64 val : unsignedVals)
+		EXPECT_EQ(deserializer.ReadVarUInt(), val);
+	for (i64 val : signedVals)
+		EXPECT_EQ(deserializer.ReadVarInt(), val);
+	EXPECT_TRUE(deserializer.IsAtEnd());
+	EXPECT_FALSE(deserializer.HasFailed());
+
+	// Zigzag keeps small negative values small
+	DynArray<u8> small{ mallocator };
+	{
+		Serializer serializer{ small };
+		serializer.WriteVarInt(-1);
+		serializer.WriteVarInt(-64);
+	}
+	EXPECT_EQ(small.Size(), 2);
+}
+
+TEST(SerializerTest, TruncatedVarInt)
+{
+	const u8 data[3] = { 0x80, 0x80, 0x80 };
+	Deserializer deserializer{ ByteSpan{ data, 3 } };
+	EXPECT_EQ(deserializer.ReadVarUInt(), 0u);
+	EXPECT_TRUE(deserializer.HasFailed());
+
+	u8 overlong[12];
+	MemSet(overlong, 0xFF, 12);
+	Deserializer overlongDeserializer{ ByteSpan{ overlong, 12 } };
+	EXPECT_EQ(overlongDeserializer.ReadVarUInt(), 0u);
+	EXPECT_TRUE(overlongDeserializer.HasFailed());
+}
+
+TEST(SerializerTest, FixedSpan)
+{
+	u8 data[6];
+	Serializer serializer{ MutableByteSpan{ data, 6 } };
+	serializer.Write<u32>(0xDEADBEEF);
+	EXPECT_FALSE(serializer.HasFailed());
+	serializer.Write<u32>(0x12345678);
+	EXPECT_TRUE(serializer.HasFailed());
+
+	// Writes after a failure are ignored, even if they would fit
+	serializer.Write<u8>(1);
+	EXPECT_EQ(serializer.NumWritten(), 4);
+
+	Deserializer deserializer{ ByteSpan{ data, 4 } };
+	EXPECT_EQ(deserializer.Read<u32>(), 0xDEADBEEFu);
+}
+
+TEST(SerializerTest, Strings)
+{
+	Alloc::Mallocator mallocator;
+	String str{ u8"Hello é世", mallocator };
+
+	DynArray<u8> data{ mallocator };
+	{
+		Serializer serializer{ data };
+		serializer.WriteString(str);
+		serializer.WriteString(String{ mallocator });
+		serializer.WriteBytes(ByteSpan{ str.Data(), 5 });
+	}
+
+	Deserializer deserializer{ data };
+	String read = deserializer.ReadString(mallocator);
+	EXPECT_EQ(read, str);
+	EXPECT_EQ(read.Length(), 8);
+	EXPECT_TRUE(deserializer.ReadString(mallocator).IsEmpty());
+
+	ByteSpan bytes = deserializer.ReadBytes(5);
+	EXPECT_EQ(bytes.Size(), 5);
+	EXPECT_GE(bytes.Data(), data.Data());
+	EXPECT_LT(bytes.Data(), data.Data() + data.Size());
+	EXPECT_EQ(MemCmp(bytes.Data(), str.Data(), 5), 0);
+	EXPECT_TRUE(deserializer.IsAtEnd());
+}
+
+TEST(SerializerTest, MalformedStrings)
+{
+	Alloc::Mallocator mallocator;
+	const u8 malformed[] = { 'a', 0x80, 0xBF, 'b' };
+	const u8 truncated[] = { 'a', 0xE4, 0xB8 };
+	const u8 valid[] = { 'a', 0xE4, 0xB8, 0x96 };
+
+	for (ByteSpan invalid : { ByteSpan{ malformed, sizeof(malformed) }, ByteSpan{ truncated, sizeof(truncated) } })
+	{
+		DynArray<u8> data{ mallocator };
+		{
+			Serializer serializer{ data };
+			serializer.WriteVarUInt(invalid.Size());
+			serializer.WriteBytes(invalid);
+			serializer.WriteVarUInt(sizeof(valid));
+			serializer.WriteBytes(ByteSpan{ valid, sizeof(valid) });
+		}
+
+		// The string is rejected, and the deserializer stays failed
+		Deserializer deserializer{ data };
+		String str{ "unchanged", mallocator };
+		EXPECT_FALSE(deserializer.Deserialize(str));
+		EXPECT_TRUE(deserializer.HasFailed());
+		EXPECT_EQ(str, String("unchanged", mallocator));
+		EXPECT_TRUE(deserializer.ReadString(mallocator).IsEmpty());
+	}
+}
+
+TEST(SerializerTest, Schema)
+{
+	STATIC_ASSERT(Detail::FixedSerializedSize<Vec3>() == 12, "Vec3 should have a fixed size");
+	STATIC_ASSERT(Detail::FixedSerializedSize<Entity>() == 0, "Entity should not have a fixed size");
+
+	Alloc::Mallocator mallocator;
+	Entity entity{ 7, -3, 300, { 1.f, 2.f, 3.f }, Color::Red, String{ "entity", mallocator }, DynArray<u16>{ mallocator }, DynArray<Vec3>{ mallocator } };
+	for (u16 i = 0; i < 10; ++i)
+		entity.values.Add(u16(i * 1000));
+	entity.points.Add(Vec3{ 4.f, 5.f, 6.f });
+	entity.points.Add(Vec3{ -1.f, -2.f, -3.f });
+
+	for (ByteOrder order : { ByteOrder::Little, ByteOrder::Big })
+	{
+		DynArray<u8> data{ mallocator };
+		{
+			Serializer serializer{ data, order };
+			serializer.Serialize(entity);
+		}
+		// id + delta + count + pos + color + name + values + points
+		EXPECT_EQ(data.Size(), 4 + 1 + 2 + 12 + 2 + 7 + 21 + 25);
+
+		Entity read{ 0, 0, 0, {}, Color::Green, String{ mallocator }, DynArray<u16>{ mallocator }, DynArray<Vec3>{ mallocator } };
+		Deserializer deserializer{ data, order };
+		EXPECT_TRUE(deserializer.Deserialize(read));
+		EXPECT_TRUE(deserializer.IsAtEnd());
+
+		EXPECT_EQ(read.id, entity.id);
+		EXPECT_EQ(read.delta, entity.delta);
+		EXPECT_EQ(read.count, entity.count);
+		EXPECT_EQ(read.pos.y, entity.pos.y);
+		EXPECT_EQ(read.color, entity.color);
+		EXPECT_EQ(read.name, entity.name);
+		ASSERT_EQ(read.values.Size(), entity.values.Size());
+		EXPECT_EQ(MemCmp(read.values.Data(), entity.values.Data(), entity.values.Size() * sizeof(u16)), 0);
+		ASSERT_EQ(read.points.Size(), 2);
+		EXPECT_EQ(read.points[1].z, -3.f);
+	}
+}
+
+TEST(SerializerTest, FixedArrayFields)
+{
+	STATIC_ASSERT(Detail::FixedSerializedSize<Quad>() == 32, "Quad should have a fixed size");
+
+	Alloc::Mallocator mallocator;
+	Quad quad{ { 1, 2, 3, 0x0405 }, { { 1.f, 2.f, 3.f }, { 4.f, 5.f, 6.f } } };
+
+	DynArray<u8> data{ mallocator };
+	{
+		Serializer serializer{ data, ByteOrder::Big };
+		serializer.Serialize(quad);
+	}
+	ASSERT_EQ(data.Size(), 32);
+	EXPECT_EQ(data[6], 0x04);
+
+	Quad read{};
+	Deserializer deserializer{ data, ByteOrder::Big };
+	EXPECT_TRUE(deserializer.Deserialize(read));
+	EXPECT_EQ(read.indices[3], 0x0405);
+	EXPECT_EQ(read.corners[1].y, 5.f);
+}
+
+TEST(SerializerTest, MalformedCount)
+{
+	Alloc::Mallocator mallocator;
+	DynArray<u8> data{ mallocator };
+	{
+		Serializer serializer{ data };
+		serializer.WriteVarUInt(0xFFFF'FFFF'FFFF);
+		serializer.Write<u32>(0);
+	}
+
+	DynArray<u32> arr{ mallocator };
+	Deserializer deserializer{ data };
+	EXPECT_FALSE(deserializer.Deserialize(arr));
+	EXPECT_TRUE(deserializer.HasFailed());
+	EXPECT_TRUE(arr.IsEmpty());
+}